@@ -2,6 +2,10 @@
 //!
 //! Run with: cargo bench --bench lexer
 //! Profile with: cargo flamegraph --bench lexer -- --bench
+//!
+//! The `lexer/corpus` group concatenates every `.ts`/`.js` file under
+//! `examples/`, or under `$LEXER_CORPUS_DIR` if set (e.g. a test262 checkout's
+//! `test/` directory), to measure throughput on realistic code.
 
 use criterion::{BenchmarkId, Criterion, Throughput, black_box, criterion_group, criterion_main};
 use tsrun::lexer::{Lexer, TokenKind};
@@ -413,10 +417,64 @@ fn bench_lexer_token_types(c: &mut Criterion) {
     group.finish();
 }
 
+/// Append every TypeScript/JavaScript file below `dir` to `out`
+fn collect_sources(dir: &std::path::Path, out: &mut String) {
+    let Ok(entries) = std::fs::read_dir(dir) else {
+        return;
+    };
+    let mut paths: Vec<_> = entries.flatten().map(|e| e.path()).collect();
+    paths.sort();
+    for path in paths {
+        if path.is_dir() {
+            collect_sources(&path, out);
+        } else if path
+            .extension()
+            .is_some_and(|ext| ext == "ts" || ext == "js")
+            && let Ok(text) = std::fs::read_to_string(&path)
+        {
+            out.push_str(&text);
+            out.push('\n');
+        }
+    }
+}
+
+fn bench_lexer_corpus(c: &mut Criterion) {
+    let dir = std::env::var("LEXER_CORPUS_DIR").unwrap_or_else(|_| "examples".to_string());
+    let mut corpus = String::new();
+    collect_sources(std::path::Path::new(&dir), &mut corpus);
+    if corpus.is_empty() {
+        return;
+    }
+    // Repeat small corpora up to a few MB, the size of a large config bundle
+    let base = corpus.clone();
+    while corpus.len() < 4_000_000 {
+        corpus.push_str(&base);
+    }
+
+    let mut group = c.benchmark_group("lexer/corpus");
+    group.throughput(Throughput::Bytes(corpus.len() as u64));
+    group.sample_size(20);
+    group.bench_function(format!("{}MB", corpus.len() / 1_000_000), |b| {
+        let mut dict = StringDict::new();
+        b.iter(|| {
+            let mut lexer = Lexer::new(black_box(&corpus), &mut dict);
+            loop {
+                let token = lexer.next_token();
+                if token.kind == TokenKind::Eof {
+                    break;
+                }
+                black_box(&token);
+            }
+        });
+    });
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_lexer_individual,
     bench_lexer_throughput,
     bench_lexer_token_types,
+    bench_lexer_corpus,
 );
 criterion_main!(benches);
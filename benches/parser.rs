@@ -2,11 +2,43 @@
 //!
 //! Run with: cargo bench --bench parser
 //! Profile with: cargo flamegraph --bench parser -- --bench
+//!
+//! `parser/allocations` also prints heap allocations and bytes per KB of
+//! source, counted by the global allocator below.
 
 use criterion::{BenchmarkId, Criterion, Throughput, black_box, criterion_group, criterion_main};
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::sync::atomic::{AtomicUsize, Ordering};
 use tsrun::parser::Parser;
 use tsrun::string_dict::StringDict;
 
+/// System allocator that counts allocations, for the allocation report
+struct CountingAlloc;
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+static ALLOCATED_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAlloc {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        unsafe { System.alloc(layout) }
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        unsafe { System.dealloc(ptr, layout) }
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        ALLOCATED_BYTES.fetch_add(new_size, Ordering::Relaxed);
+        unsafe { System.realloc(ptr, layout, new_size) }
+    }
+}
+
+#[global_allocator]
+static GLOBAL: CountingAlloc = CountingAlloc;
+
 /// Simple expressions
 const SIMPLE_EXPR: &str = "1 + 2 * 3 - 4 / 5";
 
@@ -492,6 +524,45 @@ fn bench_parser_string_interning(c: &mut Criterion) {
     group.finish();
 }
 
+fn bench_parser_allocations(c: &mut Criterion) {
+    let mut group = c.benchmark_group("parser/allocations");
+
+    for size in [10_000, 500_000] {
+        let source = generate_large_source(size);
+        let kb = source.len() as f64 / 1024.0;
+
+        // One counted parse for the report, then the usual timing run
+        let mut dict = StringDict::new();
+        let allocs_before = ALLOCATIONS.load(Ordering::Relaxed);
+        let bytes_before = ALLOCATED_BYTES.load(Ordering::Relaxed);
+        let program = Parser::new(&source, &mut dict).parse_program();
+        let allocs = ALLOCATIONS.load(Ordering::Relaxed) - allocs_before;
+        let bytes = ALLOCATED_BYTES.load(Ordering::Relaxed) - bytes_before;
+        drop(program);
+        println!(
+            "parser/allocations/{:.0}KB: {:.1} allocations/KB, {:.0} bytes/KB",
+            kb,
+            allocs as f64 / kb,
+            bytes as f64 / kb
+        );
+
+        group.throughput(Throughput::Bytes(source.len() as u64));
+        group.bench_with_input(
+            BenchmarkId::new("large_source", format!("{}KB", source.len() / 1024)),
+            &source,
+            |b, s| {
+                b.iter(|| {
+                    let mut dict = StringDict::new();
+                    let mut parser = Parser::new(black_box(s), &mut dict);
+                    black_box(parser.parse_program())
+                });
+            },
+        );
+    }
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_parser_individual,
@@ -499,5 +570,6 @@ criterion_group!(
     bench_parser_expression_depth,
     bench_parser_statements,
     bench_parser_string_interning,
+    bench_parser_allocations,
 );
 criterion_main!(benches);
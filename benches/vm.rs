@@ -0,0 +1,291 @@
+//! VM execution benchmarks
+//!
+//! Run with: cargo bench --bench vm
+//! Profile with: cargo flamegraph --bench vm -- --bench vm/profiling
+//!
+//! Each workload reports throughput in operations per second (criterion's
+//! elements/s), where an operation is the unit listed in its table entry.
+//! Before timing, one run per workload prints the heap's GC statistics.
+//!
+//! The FFI round-trip cost (`tsrun_get`/`tsrun_call` from C) is measured by
+//! `examples/c-embedding/bench_ffi.c` instead, since it needs the C library.
+
+use criterion::{
+    BatchSize, BenchmarkId, Criterion, Throughput, black_box, criterion_group, criterion_main,
+};
+use tsrun::platform::NoOpConsoleProvider;
+use tsrun::{Interpreter, StepResult};
+
+/// A script to benchmark and the number of operations one run performs
+struct Workload {
+    name: &'static str,
+    source: &'static str,
+    ops: u64,
+}
+
+/// The hand-run scripts from `examples/profiling` (see profiling.md)
+const PROFILING_WORKLOADS: &[Workload] = &[
+    Workload {
+        name: "call0",
+        source: include_str!("../examples/profiling/bench-call0.ts"),
+        ops: 200_000,
+    },
+    Workload {
+        name: "call4",
+        source: include_str!("../examples/profiling/bench-call4.ts"),
+        ops: 200_000,
+    },
+    Workload {
+        name: "call8",
+        source: include_str!("../examples/profiling/bench-call8.ts"),
+        ops: 200_000,
+    },
+    Workload {
+        name: "method4",
+        source: include_str!("../examples/profiling/bench-method4.ts"),
+        ops: 200_000,
+    },
+    Workload {
+        name: "fib25",
+        source: include_str!("../examples/profiling/bench-fib25.ts"),
+        ops: 242_785,
+    },
+    Workload {
+        name: "loop_closures",
+        source: include_str!("../examples/loop_closures.ts"),
+        ops: 10_000,
+    },
+    Workload {
+        name: "compute_intensive",
+        source: include_str!("../examples/profiling/compute-intensive.ts"),
+        ops: 1,
+    },
+];
+
+/// JSON.stringify + JSON.parse round trips of a 200-record payload
+const JSON_WORKLOAD: &str = r#"
+const records = [];
+for (let i = 0; i < 200; i++) {
+    records.push({ id: i, name: "item" + i, price: i * 1.5, tags: ["a", "b"], active: i % 2 === 0 });
+}
+let total = 0;
+for (let round = 0; round < 50; round++) {
+    const text = JSON.stringify(records);
+    const back = JSON.parse(text);
+    total += back.length;
+}
+total
+"#;
+
+/// String building and the common String.prototype methods
+const STRING_WORKLOAD: &str = r#"
+let total = 0;
+for (let i = 0; i < 2000; i++) {
+    const line = `order-${i}, customer ${i % 37}, amount ${i * 3}`;
+    const parts = line.split(", ");
+    const upper = parts[0].toUpperCase().padStart(16, "_");
+    total += upper.length + line.indexOf("amount") + line.replace("order", "o").length;
+    total += parts.join("|").slice(2, 10).trim().length;
+}
+total
+"#;
+
+/// Array builtins with callbacks over a 2000-element array
+///
+/// Comparator sort is quadratic in comparator calls, so it gets a 200-element
+/// slice to keep a sample in the millisecond range.
+const ARRAY_WORKLOAD: &str = r#"
+const xs = [];
+for (let i = 0; i < 2000; i++) xs.push((i * 7919) % 2000);
+let total = 0;
+for (let round = 0; round < 10; round++) {
+    const doubled = xs.map(x => x * 2);
+    const evens = doubled.filter(x => x % 4 === 0);
+    total += evens.reduce((a, b) => a + b, 0);
+    total += xs.slice(0, 200).sort((a, b) => a - b)[0];
+    total += xs.indexOf(1999) + (xs.some(x => x > 1998) ? 1 : 0);
+}
+total
+"#;
+
+/// Map and Set insertion, lookup and iteration
+const MAP_SET_WORKLOAD: &str = r#"
+const m = new Map();
+const s = new Set();
+for (let i = 0; i < 10000; i++) {
+    m.set("k" + (i % 1000), i);
+    s.add(i % 500);
+}
+let total = 0;
+for (let i = 0; i < 10000; i++) {
+    total += m.get("k" + (i % 1000)) ?? 0;
+    if (s.has(i)) total++;
+}
+for (const [k, v] of m) total += v;
+for (const v of s) total += v;
+total
+"#;
+
+/// Promise chains, await and Promise.all, all resolved by microtasks
+const PROMISE_WORKLOAD: &str = r#"
+async function step(x: number): Promise<number> {
+    return x + 1;
+}
+async function main(): Promise<number> {
+    let total = 0;
+    for (let i = 0; i < 2000; i++) {
+        total += await step(i);
+    }
+    const all = [];
+    for (let i = 0; i < 2000; i++) {
+        all.push(Promise.resolve(i).then(v => v * 2));
+    }
+    const values = await Promise.all(all);
+    return total + values.length;
+}
+let result = 0;
+main().then(v => { result = v; });
+"#;
+
+/// `await` on async calls, a cached settled promise and plain values, the
+/// cases that resume without suspending
+const AWAIT_WORKLOAD: &str = r#"
+async function lookup(key: number): Promise<number> {
+    return key * 2;
+}
+const cached = Promise.resolve(3);
+async function main(): Promise<number> {
+    let total = 0;
+    for (let i = 0; i < 5000; i++) {
+        total += await lookup(i);
+        total += await cached;
+        total += await i;
+    }
+    return total;
+}
+let result = 0;
+main().then(v => { result = v; });
+"#;
+
+const BUILTIN_WORKLOADS: &[Workload] = &[
+    Workload {
+        name: "json_roundtrip",
+        source: JSON_WORKLOAD,
+        ops: 50,
+    },
+    Workload {
+        name: "string_methods",
+        source: STRING_WORKLOAD,
+        ops: 2_000,
+    },
+    Workload {
+        name: "array_builtins",
+        source: ARRAY_WORKLOAD,
+        ops: 10,
+    },
+    Workload {
+        name: "map_set",
+        source: MAP_SET_WORKLOAD,
+        ops: 20_000,
+    },
+    Workload {
+        name: "promises",
+        source: PROMISE_WORKLOAD,
+        ops: 4_000,
+    },
+    Workload {
+        name: "await_settled",
+        source: AWAIT_WORKLOAD,
+        ops: 15_000,
+    },
+];
+
+/// Fresh interpreter with console output discarded
+fn new_interpreter() -> Interpreter {
+    let mut interp = Interpreter::new();
+    interp.set_console(Box::new(NoOpConsoleProvider));
+    interp
+}
+
+/// Prepare and run a script to completion, returning the final step result
+#[allow(clippy::panic)]
+fn run_script(interp: &mut Interpreter, source: &str) -> StepResult {
+    if let Err(e) = interp.prepare(source, None) {
+        panic!("prepare failed: {:?}", e);
+    }
+    loop {
+        match interp.step() {
+            Ok(StepResult::Continue) => continue,
+            Ok(result) => return result,
+            Err(e) => panic!("script failed: {:?}", e),
+        }
+    }
+}
+
+/// Run a workload once outside the timer and print its GC statistics
+fn report_gc_stats(group: &str, workload: &Workload) {
+    let mut interp = new_interpreter();
+    let result = run_script(&mut interp, workload.source);
+    let stats = interp.gc_stats();
+    println!(
+        "{}/{}: {} live, {} pooled, {} total GC objects",
+        group, workload.name, stats.live_objects, stats.pooled_objects, stats.total_objects
+    );
+    drop(result);
+}
+
+fn bench_workloads(c: &mut Criterion, group_name: &str, workloads: &[Workload]) {
+    let mut group = c.benchmark_group(group_name);
+
+    for workload in workloads {
+        report_gc_stats(group_name, workload);
+
+        // Interpreter setup and teardown stay outside the measurement
+        group.throughput(Throughput::Elements(workload.ops));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(workload.name),
+            workload.source,
+            |b, source| {
+                b.iter_batched(
+                    new_interpreter,
+                    |mut interp| {
+                        let result = run_script(&mut interp, black_box(source));
+                        (interp, result)
+                    },
+                    BatchSize::SmallInput,
+                );
+            },
+        );
+    }
+
+    group.finish();
+}
+
+fn bench_vm_profiling(c: &mut Criterion) {
+    bench_workloads(c, "vm/profiling", PROFILING_WORKLOADS);
+}
+
+fn bench_vm_builtins(c: &mut Criterion) {
+    bench_workloads(c, "vm/builtins", BUILTIN_WORKLOADS);
+}
+
+/// Cost of a fresh interpreter plus an empty script, paid by every embedder
+fn bench_vm_startup(c: &mut Criterion) {
+    let mut group = c.benchmark_group("vm/startup");
+    group.throughput(Throughput::Elements(1));
+    group.bench_function("new_and_run_empty", |b| {
+        b.iter(|| {
+            let mut interp = new_interpreter();
+            black_box(run_script(&mut interp, black_box("")))
+        });
+    });
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_vm_profiling,
+    bench_vm_builtins,
+    bench_vm_startup,
+);
+criterion_main!(benches);
@@ -6,6 +6,7 @@
 // - Processing orders from JavaScript
 // - Fulfilling orders with responses
 // - Error handling in async operations
+// - Exchanging payloads and responses as JSON text
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -204,33 +205,53 @@ static TsRunValue* native_error_test(
 // Simulated async operations
 // ============================================================================
 
-static TsRunValue* simulate_db_query(TsRunContext* ctx, const char* table, int id) {
+// Simulated results are written as JSON into the response's body buffer and
+// handed to tsrun_fulfill_orders as raw bytes, so no value handles are
+// created for them.
+#define RESPONSE_BODY_SIZE 512
+
+static size_t simulate_db_query(char* body, const char* table, int id) {
     printf("    [C] Simulating DB query: SELECT * FROM %s WHERE id = %d\n", table, id);
 
-    char json[256];
-    snprintf(json, sizeof(json),
+    int len = snprintf(body, RESPONSE_BODY_SIZE,
         "{\"id\": %d, \"table\": \"%s\", \"data\": \"mock_data_%d\"}",
         id, table, id);
-
-    TsRunValueResult result = tsrun_json_parse(ctx, json);
-    return result.value;
+    return len > 0 && len < RESPONSE_BODY_SIZE ? (size_t)len : 0;
 }
 
-static TsRunValue* simulate_http_fetch(TsRunContext* ctx, const char* url) {
+static size_t simulate_http_fetch(char* body, const char* url) {
     printf("    [C] Simulating HTTP fetch: %s\n", url);
 
-    char json[512];
-    snprintf(json, sizeof(json),
+    int len = snprintf(body, RESPONSE_BODY_SIZE,
         "{\"status\": 200, \"url\": \"%s\", \"body\": \"Response from %s\"}",
         url, url);
-
-    TsRunValueResult result = tsrun_json_parse(ctx, json);
-    return result.value;
+    return len > 0 && len < RESPONSE_BODY_SIZE ? (size_t)len : 0;
 }
 
-static TsRunValue* simulate_timeout(TsRunContext* ctx, double ms) {
+static void simulate_timeout(double ms) {
     printf("    [C] Simulating timeout: %.0f ms\n", ms);
-    return tsrun_undefined(ctx);
+}
+
+// Set a response's JSON body, or an error if it did not fit
+static void set_json_response(TsRunOrderResponse* response, const char* body, size_t len) {
+    if (len == 0) {
+        response->error = "Response body too large";
+        return;
+    }
+    response->json = body;
+    response->json_len = len;
+}
+
+// Answer an order whose payload arrived as JSON (tsrun_set_order_payload_json):
+// the payload text is echoed back inside the response without touching a
+// single value handle.
+static void process_json_order(const TsRunOrder* order, TsRunOrderResponse* response, char* body) {
+    printf("  Order #%llu payload: %.*s\n", (unsigned long long)order->id,
+           (int)order->payload_json_len, order->payload_json);
+    int len = snprintf(body, RESPONSE_BODY_SIZE, "{\"order\": %llu, \"echo\": %s}",
+                       (unsigned long long)order->id, order->payload_json);
+    set_json_response(response, body,
+                      len > 0 && len < RESPONSE_BODY_SIZE ? (size_t)len : 0);
 }
 
 // ============================================================================
@@ -255,22 +276,25 @@ static TsRunStepResult process_orders(TsRunContext* ctx, TsRunStepResult result)
                    (unsigned long long)result.cancelled_orders[i]);
         }
 
-        // Prepare responses for pending orders
-        TsRunOrderResponse* responses = malloc(
-            result.pending_count * sizeof(TsRunOrderResponse)
-        );
+        // Prepare responses for pending orders (zeroed: no value, error or JSON)
+        TsRunOrderResponse* responses = calloc(result.pending_count, sizeof(TsRunOrderResponse));
+        char* bodies = malloc(result.pending_count * RESPONSE_BODY_SIZE);
 
         for (size_t i = 0; i < result.pending_count; i++) {
             TsRunOrder* order = &result.pending_orders[i];
+            char* body = bodies + i * RESPONSE_BODY_SIZE;
             responses[i].id = order->id;
-            responses[i].error = NULL;
+
+            if (order->payload_json) {
+                process_json_order(order, &responses[i], body);
+                continue;
+            }
 
             printf("\n  Processing order #%llu:\n", (unsigned long long)order->id);
 
             // Get order type
             TsRunValueResult type_r = tsrun_get(ctx, order->payload, "type");
             if (!type_r.value || !tsrun_is_string(type_r.value)) {
-                responses[i].value = NULL;
                 responses[i].error = "Order missing 'type' field";
                 if (type_r.value) tsrun_value_free(type_r.value);
                 continue;
@@ -293,7 +317,7 @@ static TsRunStepResult process_orders(TsRunContext* ctx, TsRunStepResult result)
                     id = (int)tsrun_get_number(id_r.value);
                 }
 
-                responses[i].value = simulate_db_query(ctx, table, id);
+                set_json_response(&responses[i], body, simulate_db_query(body, table, id));
 
                 if (table_r.value) tsrun_value_free(table_r.value);
                 if (id_r.value) tsrun_value_free(id_r.value);
@@ -306,7 +330,7 @@ static TsRunStepResult process_orders(TsRunContext* ctx, TsRunStepResult result)
                     url = tsrun_get_string(url_r.value);
                 }
 
-                responses[i].value = simulate_http_fetch(ctx, url);
+                set_json_response(&responses[i], body, simulate_http_fetch(body, url));
 
                 if (url_r.value) tsrun_value_free(url_r.value);
 
@@ -318,17 +342,16 @@ static TsRunStepResult process_orders(TsRunContext* ctx, TsRunStepResult result)
                     ms = tsrun_get_number(ms_r.value);
                 }
 
-                responses[i].value = simulate_timeout(ctx, ms);
+                // No value and no JSON: the order resolves to undefined
+                simulate_timeout(ms);
 
                 if (ms_r.value) tsrun_value_free(ms_r.value);
 
             } else if (strcmp(type, "error_test") == 0) {
-                responses[i].value = NULL;
                 responses[i].error = "Simulated error for testing";
                 printf("    [C] Returning error\n");
 
             } else {
-                responses[i].value = NULL;
                 responses[i].error = "Unknown order type";
                 printf("    [C] Unknown type: %s\n", type);
             }
@@ -336,18 +359,14 @@ static TsRunStepResult process_orders(TsRunContext* ctx, TsRunStepResult result)
             tsrun_value_free(type_r.value);
         }
 
-        // Fulfill all orders
+        // Fulfill all orders (JSON bodies are parsed here, so the buffers
+        // can be released right after)
         TsRunResult fulfill = tsrun_fulfill_orders(ctx, responses, result.pending_count);
         if (!fulfill.ok) {
             printf("Failed to fulfill orders: %s\n", fulfill.error);
         }
 
-        // Free response values
-        for (size_t i = 0; i < result.pending_count; i++) {
-            if (responses[i].value) {
-                tsrun_value_free(responses[i].value);
-            }
-        }
+        free(bodies);
         free(responses);
 
         // Continue execution
@@ -391,7 +410,7 @@ static void setup_async_functions(TsRunContext* ctx) {
 // Helper to run async code
 // ============================================================================
 
-static void run_async_code(const char* title, const char* code) {
+static void run_async_code(const char* title, const char* code, bool json_payloads) {
     printf("\n========================================\n");
     printf("%s\n", title);
     printf("========================================\n");
@@ -399,6 +418,7 @@ static void run_async_code(const char* title, const char* code) {
 
     TsRunContext* ctx = tsrun_new();
     tsrun_set_console(ctx, tsrun_console_stdio, NULL);
+    tsrun_set_order_payload_json(ctx, json_payloads);
 
     // Set up native async functions
     setup_async_functions(ctx);
@@ -462,7 +482,8 @@ static void example_basic_async(void) {
         "const user: DbResult = dbQuery('users', 42);\n"
         "console.log('Got user:', JSON.stringify(user));\n"
         "\n"
-        "user;\n"
+        "user;\n",
+        false
     );
 }
 
@@ -495,7 +516,8 @@ static void example_multiple_calls(void) {
         "const config: HttpResponse = httpFetch('https://api.example.com/config');\n"
         "console.log('Config:', JSON.stringify(config));\n"
         "\n"
-        "({ user, posts, config });\n"
+        "({ user, posts, config });\n",
+        false
     );
 }
 
@@ -514,7 +536,8 @@ static void example_error_handling(void) {
         "    console.log('Caught error:', error.message);\n"
         "}\n"
         "\n"
-        "'Error was handled';\n"
+        "'Error was handled';\n",
+        false
     );
 }
 
@@ -538,7 +561,29 @@ static void example_loop(void) {
         "}\n"
         "\n"
         "console.log('All items fetched!');\n"
-        "results;\n"
+        "results;\n",
+        false
+    );
+}
+
+static void example_json_payloads(void) {
+    run_async_code(
+        "Example 5: Orders exchanged as JSON (no value handles)",
+        "import { order } from 'tsrun:host';\n"
+        "\n"
+        "interface Echo {\n"
+        "    order: number;\n"
+        "    echo: { sku: string; qty: number };\n"
+        "}\n"
+        "\n"
+        "let total: number = 0;\n"
+        "for (let i: number = 1; i <= 5; i++) {\n"
+        "    const reply = order({ sku: `item-${i}`, qty: i }) as Echo;\n"
+        "    total += reply.echo.qty;\n"
+        "}\n"
+        "console.log('Echoed quantities:', total);\n"
+        "total;\n",
+        true
     );
 }
 
@@ -560,6 +605,7 @@ int main(void) {
     example_multiple_calls();
     example_error_handling();
     example_loop();
+    example_json_payloads();
 
     printf("\nDone!\n");
     return 0;
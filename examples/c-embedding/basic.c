@@ -5,9 +5,13 @@
 // - Evaluating simple expressions
 // - Inspecting return values
 // - Working with objects and arrays
+// - Interned property keys for hot-path access
+// - Bulk extraction of properties and numeric array data
+// - Instruction/time budgets and an object limit for untrusted scripts
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "tsrun.h"
 #include "tsrun_console.h"
 
@@ -181,6 +185,156 @@ static void array_demo(TsRunContext* ctx) {
     tsrun_value_free(arr);
 }
 
+// Demonstrate interned keys for repeated property access
+static void interned_keys_demo(TsRunContext* ctx) {
+    printf("\n=== Interned Keys Demo ===\n");
+
+    TsRunValueResult rows_r = tsrun_json_parse(ctx,
+        "[{\"id\": 1, \"score\": 9.5}, {\"id\": 2, \"score\": 7.25}, {\"id\": 3}]");
+    if (!rows_r.value) {
+        printf("JSON parse error: %s\n", rows_r.error);
+        return;
+    }
+    TsRunValue* rows = rows_r.value;
+
+    // Intern once, reuse for every row
+    TsRunKey* id_key = tsrun_key_intern(ctx, "id");
+    TsRunKey* score_key = tsrun_key_intern(ctx, "score");
+
+    for (size_t i = 0; i < tsrun_array_len(rows); i++) {
+        TsRunValueResult row_r = tsrun_array_get(ctx, rows, i);
+        if (!row_r.value) continue;
+
+        TsRunValueResult id_r = tsrun_get_k(ctx, row_r.value, id_key);
+        if (id_r.value) {
+            if (tsrun_has_k(ctx, row_r.value, score_key)) {
+                TsRunValueResult score_r = tsrun_get_k(ctx, row_r.value, score_key);
+                printf("row %g: score = %g\n", tsrun_get_number(id_r.value),
+                       tsrun_get_number(score_r.value));
+                tsrun_value_free(score_r.value);
+            } else {
+                printf("row %g: no score, defaulting to 0\n", tsrun_get_number(id_r.value));
+                TsRunValue* zero = tsrun_number(ctx, 0);
+                tsrun_set_k(ctx, row_r.value, score_key, zero);
+                tsrun_value_free(zero);
+            }
+            tsrun_value_free(id_r.value);
+        }
+        tsrun_value_free(row_r.value);
+    }
+
+    char* json = tsrun_json_stringify(ctx, rows);
+    printf("JSON: %s\n", json);
+    tsrun_free_string(json);
+
+    tsrun_key_free(id_key);
+    tsrun_key_free(score_key);
+    tsrun_value_free(rows);
+}
+
+// Demonstrate bulk extraction without per-element handles
+static void bulk_read_demo(TsRunContext* ctx) {
+    printf("\n=== Bulk Read Demo ===\n");
+
+    TsRunValueResult nums_r = tsrun_json_parse(ctx, "[1.5, 2.5, \"x\", 4]");
+    if (!nums_r.value) {
+        printf("JSON parse error: %s\n", nums_r.error);
+        return;
+    }
+    double nums[8];
+    size_t n = tsrun_array_read_numbers(ctx, nums_r.value, nums, 8);
+    printf("numbers (%zu):", n);
+    for (size_t i = 0; i < n; i++) printf(" %g", nums[i]);
+    printf("\n");
+
+    // Mixed arrays have no packed view; all-number arrays can be read in place
+    size_t packed_len = 0;
+    printf("mixed packed: %s\n",
+           tsrun_array_as_f64_slice(ctx, nums_r.value, &packed_len) ? "yes" : "no");
+    TsRunValueResult packed_r = tsrun_json_parse(ctx, "[1.5, 2.5, 4]");
+    if (packed_r.value) {
+        const double* packed = tsrun_array_as_f64_slice(ctx, packed_r.value, &packed_len);
+        double sum = 0;
+        for (size_t i = 0; packed && i < packed_len; i++) sum += packed[i];
+        printf("packed sum (%zu): %g\n", packed_len, sum);
+        tsrun_value_free(packed_r.value);
+    }
+    tsrun_value_free(nums_r.value);
+
+    TsRunValueResult points_r = tsrun_json_parse(ctx,
+        "[{\"x\": 1, \"y\": 10}, {\"x\": 2, \"y\": 20}, {\"x\": 3, \"y\": 30}]");
+    if (!points_r.value) {
+        printf("JSON parse error: %s\n", points_r.error);
+        return;
+    }
+    double ys[3];
+    n = tsrun_array_read_f64_field(ctx, points_r.value, "y", ys, 3);
+    printf("y field (%zu): %g %g %g\n", n, ys[0], ys[1], ys[2]);
+
+    // Read several fields of one row in a single call
+    TsRunKey* keys[] = { tsrun_key_intern(ctx, "x"), tsrun_key_intern(ctx, "y") };
+    TsRunValueResult row_r = tsrun_array_get(ctx, points_r.value, 1);
+    TsRunValue* fields[2];
+    TsRunResult many = tsrun_get_many(ctx, row_r.value, (const TsRunKey* const*)keys, 2, fields);
+    if (many.ok) {
+        printf("row 1: x = %g, y = %g\n", tsrun_get_number(fields[0]),
+               tsrun_get_number(fields[1]));
+        tsrun_value_free(fields[0]);
+        tsrun_value_free(fields[1]);
+    }
+    tsrun_value_free(row_r.value);
+    tsrun_key_free(keys[0]);
+    tsrun_key_free(keys[1]);
+    tsrun_value_free(points_r.value);
+}
+
+static void release_samples(void* data, size_t len, void* userdata) {
+    (void)data;
+    printf("%s released (%zu bytes)\n", (const char*)userdata, len);
+}
+
+// Share host memory with scripts without copying
+static void binary_demo(void) {
+    printf("\n=== Binary Data Demo ===\n");
+    TsRunContext* ctx = tsrun_new();
+
+    static double samples[4] = { 1.0, 2.0, 3.0, 4.0 };
+    TsRunValueResult buf_r = tsrun_arraybuffer_external(ctx, samples, sizeof(samples),
+                                                        release_samples, "samples");
+    if (!buf_r.value) {
+        printf("Error: %s\n", buf_r.error);
+        tsrun_free(ctx);
+        return;
+    }
+    tsrun_set_global(ctx, "samples", buf_r.value);
+    tsrun_value_free(buf_r.value);
+
+    static const char label[] = "gain";
+    TsRunValueResult label_r = tsrun_string_external(ctx, label, sizeof(label) - 1, NULL, NULL);
+    if (label_r.value) {
+        tsrun_set_global(ctx, "label", label_r.value);
+        tsrun_value_free(label_r.value);
+    }
+
+    // The script scales the samples in place
+    eval_and_print(ctx,
+        "const s = new Float64Array(samples); s.forEach((v, i) => { s[i] = v * 10; }); "
+        "globalThis.scaled = s; label + ' x10: ' + s.join(', ')");
+    printf("host sees: %g %g %g %g\n", samples[0], samples[1], samples[2], samples[3]);
+
+    // Views can be read in place too
+    TsRunValueResult view_r = tsrun_get_global(ctx, "scaled");
+    if (view_r.value) {
+        size_t len = 0;
+        uint8_t* bytes = tsrun_arraybuffer_data(view_r.value, &len);
+        printf("view bytes: %zu, same memory: %s\n", len,
+               bytes == (uint8_t*)samples ? "yes" : "no");
+        tsrun_value_free(view_r.value);
+    }
+
+    tsrun_free(ctx);
+}
+
 // Demonstrate globals
 static void globals_demo(TsRunContext* ctx) {
     printf("\n=== Globals Demo ===\n");
@@ -214,6 +368,156 @@ static void globals_demo(TsRunContext* ctx) {
     }
 }
 
+static void snapshot_demo(TsRunContext* ctx) {
+    printf("\n=== Snapshot Demo ===\n");
+
+    // Run setup code once, then capture the context
+    eval_and_print(ctx, "const config = { scale: 3 }; function scaled(x: number): number { return x * config.scale; }");
+
+    TsRunSnapshotResult snap_r = tsrun_context_snapshot(ctx);
+    if (!snap_r.snapshot) {
+        printf("Snapshot error: %s\n", snap_r.error);
+        return;
+    }
+
+    // Each context created from the snapshot starts with the setup state
+    for (int i = 0; i < 2; i++) {
+        TsRunContext* fork = tsrun_new_from_snapshot(snap_r.snapshot);
+        if (!fork) {
+            printf("Failed to create context from snapshot\n");
+            break;
+        }
+        char code[64];
+        snprintf(code, sizeof(code), "config.scale += %d; scaled(10)", i + 1);
+        eval_and_print(fork, code);
+        tsrun_free(fork);
+    }
+
+    // The original context is unaffected by changes made in the copies
+    eval_and_print(ctx, "config.scale");
+
+    tsrun_snapshot_free(snap_r.snapshot);
+}
+
+// Write callback for tsrun_json_stringify_to: count bytes and echo them
+static bool write_json_chunk(const char* data, size_t len, void* userdata) {
+    *(size_t*)userdata += len;
+    fwrite(data, 1, len, stdout);
+    return true;
+}
+
+// Demonstrate JSON streaming to and from host buffers
+static void json_stream_demo(TsRunContext* ctx) {
+    printf("\n=== JSON Streaming Demo ===\n");
+
+    // Input split at arbitrary points, e.g. as it arrives from a socket
+    const char* chunks[] = { "{\"items\": [1, 2", ", 3], \"na", "me\": \"caf\xc3", "\xa9\"}" };
+    TsRunJsonParser* parser = tsrun_json_parser_new(ctx);
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        TsRunResult fed = tsrun_json_parser_feed(ctx, parser, chunks[i], strlen(chunks[i]));
+        if (!fed.ok) {
+            printf("JSON feed error: %s\n", fed.error);
+            tsrun_json_parser_free(parser);
+            return;
+        }
+    }
+    TsRunValueResult parsed = tsrun_json_parser_finish(ctx, parser);
+    if (!parsed.value) {
+        printf("JSON parse error: %s\n", parsed.error);
+        return;
+    }
+
+    size_t written = 0;
+    TsRunResult out = tsrun_json_stringify_to(ctx, parsed.value, write_json_chunk, &written);
+    if (out.ok) {
+        printf("\n(%zu bytes written)\n", written);
+    } else {
+        printf("JSON stringify error: %s\n", out.error);
+    }
+    tsrun_value_free(parsed.value);
+}
+
+// Run a script under a budget, resuming it a few times before giving up
+static void run_budgeted(TsRunContext* ctx, const char* code, uint64_t max_instructions,
+                         uint64_t timeout_ns, int max_slices) {
+    printf("%s\n", code);
+    TsRunResult prep = tsrun_prepare(ctx, code, NULL);
+    if (!prep.ok) {
+        printf("  Prepare error: %s\n", prep.error);
+        return;
+    }
+    for (int slice = 1; slice <= max_slices; slice++) {
+        TsRunStepResult r = tsrun_run_budget(ctx, max_instructions, timeout_ns);
+        if (r.status == TSRUN_STEP_BUDGET_EXHAUSTED) {
+            tsrun_step_result_free(&r);
+            continue;
+        }
+        if (r.status == TSRUN_STEP_COMPLETE && r.value) {
+            printf("  Completed after %d slice(s): %g\n", slice, tsrun_get_number(r.value));
+            tsrun_value_free(r.value);
+        } else if (r.status == TSRUN_STEP_ERROR) {
+            printf("  Stopped: %s\n", r.error);
+        }
+        tsrun_step_result_free(&r);
+        return;
+    }
+    printf("  Still running after %d slices, abandoned\n", max_slices);
+}
+
+// Demonstrate preemptible execution and an object limit
+static void budget_demo(void) {
+    printf("\n=== Budget Demo ===\n");
+    TsRunContext* ctx = tsrun_new();
+    tsrun_set_object_limit(ctx, 50000);
+
+    // Slices of 100k instructions; the host regains control between them
+    run_budgeted(ctx, "let t = 0; for (let i = 0; i < 50000; i++) t += i; t", 100000, 0, 100);
+    // Slices of 5ms wall-clock time; the host gives up after 3
+    run_budgeted(ctx, "while (true) {}", 0, 5000000, 3);
+    // Unlimited time, but the object limit stops it
+    run_budgeted(ctx, "(() => { const a = []; while (true) a.push({}); })()", 0, 0, 1);
+
+    tsrun_free(ctx);
+}
+
+// Print the hottest functions and opcodes of a profile
+static void print_profile(const TsRunProfile* profile, void* userdata) {
+    (void)userdata;
+    printf("%llu samples\n", (unsigned long long)profile->sample_count);
+    for (size_t i = 0; i < profile->function_count && i < 3; i++) {
+        const TsRunProfileFunction* f = &profile->functions[i];
+        printf("  %-12s line %-3u self %llu, total %llu\n", f->name, f->line,
+               (unsigned long long)f->self_samples, (unsigned long long)f->total_samples);
+    }
+    for (size_t i = 0; i < profile->opcode_count && i < 3; i++) {
+        printf("  %-20s %llu\n", profile->opcodes[i].name,
+               (unsigned long long)profile->opcodes[i].count);
+    }
+    // profile->folded is ready for flamegraph.pl
+}
+
+// Sample a script's call stack and count its opcodes
+static void profiler_demo(void) {
+    printf("\n=== Profiler Demo ===\n");
+    TsRunContext* ctx = tsrun_new();
+
+    // Sample every 100us of execution
+    tsrun_profiler_start(ctx, 100000, true);
+    tsrun_prepare(ctx,
+                  "function fib(n: number): number { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+                  "function main(): number { return fib(18); }\n"
+                  "main();",
+                  "/fib.ts");
+    TsRunStepResult r = tsrun_run(ctx);
+    tsrun_step_result_free(&r);
+
+    TsRunResult stopped = tsrun_profiler_stop(ctx, print_profile, NULL);
+    if (!stopped.ok) {
+        printf("Profiler error: %s\n", stopped.error);
+    }
+    tsrun_free(ctx);
+}
+
 int main(void) {
     printf("tsrun C API - Basic Example\n");
     printf("Version: %s\n", tsrun_version());
@@ -240,15 +544,49 @@ int main(void) {
     // Array manipulation
     array_demo(ctx);
 
+    // Interned keys
+    interned_keys_demo(ctx);
+
+    // Bulk extraction
+    bulk_read_demo(ctx);
+
+    // Zero-copy binary data
+    binary_demo();
+
     // Globals
     globals_demo(ctx);
 
+    // Snapshots
+    snapshot_demo(ctx);
+
+    // JSON streaming
+    json_stream_demo(ctx);
+
+    // Budgets and limits
+    budget_demo();
+
+    // Sampling profiler
+    profiler_demo();
+
     // GC stats
     TsRunGcStats stats = tsrun_gc_stats(ctx);
     printf("\n=== GC Stats ===\n");
     printf("Total objects: %zu\n", stats.total_objects);
     printf("Pooled objects: %zu\n", stats.pooled_objects);
     printf("Live objects: %zu\n", stats.live_objects);
+    printf("Reserved bytes: %zu (in use: %zu)\n", stats.reserved_bytes, stats.used_bytes);
+
+    // Return empty GC chunks to the allocator
+    tsrun_gc_shrink(ctx);
+    stats = tsrun_gc_stats(ctx);
+    printf("Reserved after shrink: %zu bytes\n", stats.reserved_bytes);
+
+    // Inline cache stats
+    TsRunIcStats ic = tsrun_ic_stats(ctx);
+    printf("\n=== Inline Cache Stats ===\n");
+    printf("Hits: %llu\n", (unsigned long long)ic.hits);
+    printf("Misses: %llu\n", (unsigned long long)ic.misses);
+    printf("Megamorphic sites: %llu\n", (unsigned long long)ic.megamorphic_sites);
 
     // Cleanup
     tsrun_free(ctx);
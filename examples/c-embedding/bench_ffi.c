@@ -0,0 +1,192 @@
+// bench_ffi.c - FFI round-trip microbenchmark
+//
+// Measures the host-side cost of crossing the C API boundary:
+// - tsrun_get with a C string key vs tsrun_get_k with an interned key
+// - tsrun_call of a small JS function (argument handles created per call)
+// - tsrun_call_method on an object
+// - JS calling a C function: tsrun_native_function (value handles per call)
+//   vs tsrun_native_function_typed (C scalars)
+//
+// Usage: bench_ffi [iterations]   (default 200000)
+// Build with the release library for meaningful numbers.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "tsrun.h"
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void report(const char* name, long iterations, double elapsed_ns, double checksum) {
+    double ns_per_op = elapsed_ns / (double)iterations;
+    printf("%-24s %8.1f ns/op  %12.0f ops/sec  (checksum %g)\n",
+           name, ns_per_op, 1e9 / ns_per_op, checksum);
+}
+
+// Read and free a numeric result, aborting the run on error
+static double take_number(TsRunValueResult r) {
+    if (!r.value) {
+        fprintf(stderr, "call failed: %s\n", r.error);
+        exit(1);
+    }
+    double n = tsrun_get_number(r.value);
+    tsrun_value_free(r.value);
+    return n;
+}
+
+// Generic native callback: reads both arguments through value handles
+static TsRunValue* generic_mul_add(TsRunContext* ctx, TsRunValue* this_arg, TsRunValue** args,
+                                   size_t argc, void* userdata, const char** error_out) {
+    (void)this_arg;
+    (void)userdata;
+    (void)error_out;
+    if (argc < 2) return tsrun_number(ctx, 0);
+    return tsrun_number(ctx, tsrun_get_number(args[0]) * 2 + tsrun_get_number(args[1]));
+}
+
+// The same function with a typed signature
+static double typed_mul_add(double a, double b, void* userdata) {
+    (void)userdata;
+    return a * 2 + b;
+}
+
+// Run a script that calls `fn_name` `iterations` times and return its result
+static double run_calls(TsRunContext* ctx, const char* fn_name, long iterations) {
+    char code[256];
+    snprintf(code, sizeof code, "let t = 0; for (let i = 0; i < %ld; i++) t = %s(i, t) %% 997; t",
+             iterations, fn_name);
+    TsRunResult prep = tsrun_prepare(ctx, code, NULL);
+    if (!prep.ok) {
+        fprintf(stderr, "prepare error: %s\n", prep.error);
+        exit(1);
+    }
+    TsRunStepResult r = tsrun_run(ctx);
+    if (r.status != TSRUN_STEP_COMPLETE || !r.value) {
+        fprintf(stderr, "%s loop failed: %s\n", fn_name, r.error ? r.error : "(not complete)");
+        exit(1);
+    }
+    double n = tsrun_get_number(r.value);
+    tsrun_value_free(r.value);
+    tsrun_step_result_free(&r);
+    return n;
+}
+
+static TsRunValue* get_global(TsRunContext* ctx, const char* name) {
+    TsRunValueResult r = tsrun_get_global(ctx, name);
+    if (!r.value) {
+        fprintf(stderr, "missing global %s: %s\n", name, r.error);
+        exit(1);
+    }
+    return r.value;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 200000;
+    if (iterations <= 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    TsRunContext* ctx = tsrun_new();
+
+    TsRunResult prep = tsrun_prepare(ctx,
+        "globalThis.point = { x: 1.5, y: 2.5, label: 'p' };\n"
+        "globalThis.add = (a: number, b: number): number => a + b;\n"
+        "globalThis.calc = { scale(v: number): number { return v * 2; } };\n",
+        NULL);
+    if (!prep.ok) {
+        fprintf(stderr, "prepare error: %s\n", prep.error);
+        tsrun_free(ctx);
+        return 1;
+    }
+    TsRunStepResult run = tsrun_run(ctx);
+    if (run.status != TSRUN_STEP_COMPLETE) {
+        fprintf(stderr, "setup failed: %s\n", run.error ? run.error : "(not complete)");
+        tsrun_step_result_free(&run);
+        tsrun_free(ctx);
+        return 1;
+    }
+    if (run.value) tsrun_value_free(run.value);
+    tsrun_step_result_free(&run);
+
+    TsRunValue* point = get_global(ctx, "point");
+    TsRunValue* add = get_global(ctx, "add");
+    TsRunValue* calc = get_global(ctx, "calc");
+
+    printf("tsrun FFI round trips, %ld iterations each\n\n", iterations);
+
+    // tsrun_get: key string is converted on every call
+    double checksum = 0;
+    double start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        TsRunValueResult r = tsrun_get(ctx, point, "x");
+        checksum += take_number(r);
+    }
+    report("tsrun_get", iterations, now_ns() - start, checksum);
+
+    // tsrun_get_k: key interned once up front
+    TsRunKey* x_key = tsrun_key_intern(ctx, "x");
+    checksum = 0;
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        TsRunValueResult r = tsrun_get_k(ctx, point, x_key);
+        checksum += take_number(r);
+    }
+    report("tsrun_get_k", iterations, now_ns() - start, checksum);
+    tsrun_key_free(x_key);
+
+    // tsrun_call: two argument handles in, one result handle out
+    checksum = 0;
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        TsRunValue* a = tsrun_number(ctx, (double)i);
+        TsRunValue* b = tsrun_number(ctx, 1.0);
+        TsRunValue* args[] = { a, b };
+        TsRunValueResult r = tsrun_call(ctx, add, NULL, args, 2);
+        checksum += take_number(r);
+        tsrun_value_free(a);
+        tsrun_value_free(b);
+    }
+    report("tsrun_call (2 args)", iterations, now_ns() - start, checksum);
+
+    // tsrun_call_method: method lookup by name plus the call
+    checksum = 0;
+    start = now_ns();
+    for (long i = 0; i < iterations; i++) {
+        TsRunValue* v = tsrun_number(ctx, (double)i);
+        TsRunValue* args[] = { v };
+        TsRunValueResult r = tsrun_call_method(ctx, calc, "scale", args, 1);
+        checksum += take_number(r);
+        tsrun_value_free(v);
+    }
+    report("tsrun_call_method", iterations, now_ns() - start, checksum);
+
+    // JS -> C calls; each includes one loop iteration of interpreter work
+    TsRunValueResult generic = tsrun_native_function(ctx, "mulAdd", generic_mul_add, 2, NULL);
+    tsrun_set_global(ctx, "mulAddGeneric", generic.value);
+    tsrun_value_free(generic.value);
+    TsRunValueResult typed = tsrun_native_function_typed(ctx, "mulAdd", TSRUN_SIG_F64_F64_F64,
+                                                         (const void*)typed_mul_add, NULL);
+    tsrun_set_global(ctx, "mulAddTyped", typed.value);
+    tsrun_value_free(typed.value);
+
+    start = now_ns();
+    checksum = run_calls(ctx, "mulAddGeneric", iterations);
+    report("JS->C generic", iterations, now_ns() - start, checksum);
+
+    start = now_ns();
+    checksum = run_calls(ctx, "mulAddTyped", iterations);
+    report("JS->C typed", iterations, now_ns() - start, checksum);
+
+    tsrun_value_free(point);
+    tsrun_value_free(add);
+    tsrun_value_free(calc);
+    tsrun_free(ctx);
+    return 0;
+}
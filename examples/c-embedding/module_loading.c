@@ -5,7 +5,12 @@
 // - Step-based execution with TSRUN_STEP_NEED_IMPORTS
 // - Providing module source code
 // - Accessing module exports
+// - Loading precompiled bytecode (tsrun_compile_to_bytecode)
+// - Compiling a batch of imports on worker threads (tsrun_compile_module)
+// - Running exported functions on a thread pool (tsrun_pool_*)
 
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -391,6 +396,243 @@ static void example_access_exports(void) {
 // Main
 // ============================================================================
 
+// ============================================================================
+// Example 5: Precompiled bytecode
+// ============================================================================
+
+// Compile a source file to bytecode. In real code this runs at deploy time and
+// the blobs are written to disk (or mmap'd) instead of being compiled on demand.
+static TsRunBytecodeResult precompile(TsRunContext* build_ctx, const char* code, const char* path) {
+    TsRunBytecodeResult blob = tsrun_compile_to_bytecode(build_ctx, code, path);
+    if (blob.error) {
+        printf("  Compile error (%s): %s\n", path, blob.error);
+    } else {
+        printf("  Compiled %s: %zu bytes of bytecode\n", path, blob.len);
+    }
+    return blob;
+}
+
+static void example_precompiled_bytecode(void) {
+    printf("\n========================================\n");
+    printf("Example 5: Precompiled bytecode\n");
+    printf("========================================\n");
+
+    const char* code =
+        "import { square, cube } from './math.ts';\n"
+        "[square(7), cube(3)];\n";
+
+    // Build step: compile once, without running anything
+    TsRunContext* build_ctx = tsrun_new();
+    TsRunBytecodeResult main_blob = precompile(build_ctx, code, "/main.ts");
+    if (main_blob.error) {
+        tsrun_free(build_ctx);
+        return;
+    }
+
+    // Worker: load the blob, skipping lexing, parsing and compilation
+    TsRunContext* ctx = tsrun_new();
+    tsrun_set_console(ctx, tsrun_console_stdio, NULL);
+
+    TsRunResult prep = tsrun_prepare_bytecode(ctx, main_blob.data, main_blob.len, "/main.ts");
+    tsrun_bytecode_free(main_blob.data, main_blob.len);
+    if (!prep.ok) {
+        printf("Prepare error: %s\n", prep.error);
+        tsrun_free(ctx);
+        tsrun_free(build_ctx);
+        return;
+    }
+
+    TsRunStepResult result = tsrun_run(ctx);
+    while (result.status == TSRUN_STEP_NEED_IMPORTS) {
+        for (size_t i = 0; i < result.import_count; i++) {
+            const char* path = result.imports[i].resolved_path;
+            const char* source = load_virtual_file(path);
+            if (!source) {
+                printf("  ERROR: Module not found: %s\n", path);
+                continue;
+            }
+
+            TsRunBytecodeResult blob = precompile(build_ctx, source, path);
+            if (blob.error) {
+                continue;
+            }
+            TsRunResult provide = tsrun_provide_module_bytecode(ctx, path, blob.data, blob.len);
+            tsrun_bytecode_free(blob.data, blob.len);
+            if (!provide.ok) {
+                printf("  ERROR: Failed to provide module: %s\n", provide.error);
+            }
+        }
+        tsrun_step_result_free(&result);
+        result = tsrun_run(ctx);
+    }
+
+    if (result.status == TSRUN_STEP_COMPLETE && result.value) {
+        char* json = tsrun_json_stringify(ctx, result.value);
+        if (json) {
+            printf("Result: %s\n", json);
+            tsrun_free_string(json);
+        }
+        tsrun_value_free(result.value);
+    } else if (result.status == TSRUN_STEP_ERROR) {
+        printf("Error: %s\n", result.error);
+    }
+
+    tsrun_step_result_free(&result);
+    tsrun_free(ctx);
+    tsrun_free(build_ctx);
+}
+
+// ============================================================================
+// Example 6: Compiling imports on worker threads
+// ============================================================================
+
+// One import to compile: input path/source, output compiled module
+typedef struct {
+    const char* path;
+    const char* source;
+    TsRunCompiledModule* compiled;
+} CompileJob;
+
+// tsrun_compile_module needs no context, so any thread may call it
+static void* compile_worker(void* arg) {
+    CompileJob* job = (CompileJob*)arg;
+    job->compiled = tsrun_compile_module(job->source, job->path);
+    return NULL;
+}
+
+static void example_parallel_compile(void) {
+    printf("\n========================================\n");
+    printf("Example 6: Compiling imports on worker threads\n");
+    printf("========================================\n");
+
+    TsRunContext* ctx = tsrun_new();
+    tsrun_set_console(ctx, tsrun_console_stdio, NULL);
+
+    const char* code =
+        "import { square } from './math.ts';\n"
+        "import { sum, range } from './utils.ts';\n"
+        "import config from './config.ts';\n"
+        "`${config.appName}: ${sum(range(1, 4).map(square))}`;\n";
+
+    TsRunResult prep = tsrun_prepare(ctx, code, "/main.ts");
+    if (!prep.ok) {
+        printf("Prepare error: %s\n", prep.error);
+        tsrun_free(ctx);
+        return;
+    }
+
+    TsRunStepResult result = tsrun_run(ctx);
+    while (result.status == TSRUN_STEP_NEED_IMPORTS) {
+        size_t count = result.import_count;
+        CompileJob* jobs = calloc(count, sizeof(CompileJob));
+        pthread_t* threads = calloc(count, sizeof(pthread_t));
+        if (!jobs || !threads) {
+            free(jobs);
+            free(threads);
+            break;
+        }
+
+        // Lex, parse and compile the whole batch in parallel
+        for (size_t i = 0; i < count; i++) {
+            jobs[i].path = result.imports[i].resolved_path;
+            jobs[i].source = load_virtual_file(jobs[i].path);
+            if (jobs[i].source) {
+                pthread_create(&threads[i], NULL, compile_worker, &jobs[i]);
+            }
+        }
+
+        // Attach the results on the context's thread (decoding only)
+        for (size_t i = 0; i < count; i++) {
+            if (!jobs[i].source) {
+                printf("  ERROR: Module not found: %s\n", jobs[i].path);
+                continue;
+            }
+            pthread_join(threads[i], NULL);
+
+            const char* error = tsrun_compiled_module_error(jobs[i].compiled);
+            if (error) {
+                printf("  Compile error (%s): %s\n", jobs[i].path, error);
+            } else {
+                printf("  Compiled on worker thread: %s\n", jobs[i].path);
+            }
+            TsRunResult provide = tsrun_provide_compiled_module(ctx, jobs[i].path, jobs[i].compiled);
+            if (!provide.ok && !error) {
+                printf("  ERROR: Failed to provide module: %s\n", provide.error);
+            }
+        }
+
+        free(jobs);
+        free(threads);
+        tsrun_step_result_free(&result);
+        result = tsrun_run(ctx);
+    }
+
+    if (result.status == TSRUN_STEP_COMPLETE && result.value) {
+        printf("Result: %s\n", tsrun_get_string(result.value));
+        tsrun_value_free(result.value);
+    } else if (result.status == TSRUN_STEP_ERROR) {
+        printf("Error: %s\n", result.error);
+    }
+
+    tsrun_step_result_free(&result);
+    tsrun_free(ctx);
+}
+
+// ============================================================================
+// Example 7: Running exported functions on a thread pool
+// ============================================================================
+
+// Called on a pool worker thread; the strings are only valid during the call
+static void on_pool_job(const char* result_json, const char* error, void* userdata) {
+    int n = (int)(intptr_t)userdata;
+    if (error) {
+        printf("  sumOfSquares(%d) failed: %s\n", n, error);
+    } else {
+        printf("  sumOfSquares(%d) = %s\n", n, result_json ? result_json : "undefined");
+    }
+}
+
+static void example_thread_pool(void) {
+    printf("\n========================================\n");
+    printf("Example 7: Running exported functions on a thread pool\n");
+    printf("========================================\n");
+
+    TsRunPool* pool = tsrun_pool_new(4);
+    if (!pool) {
+        printf("  ERROR: could not start the pool threads\n");
+        return;
+    }
+    printf("Pool threads: %zu\n", tsrun_pool_threads(pool));
+
+    // Each module is compiled once; every worker decodes the bytes on first use
+    const char* paths[] = { "math.ts", "utils.ts" };
+    for (size_t i = 0; i < 2; i++) {
+        TsRunCompiledModule* module = tsrun_compile_module(load_virtual_file(paths[i]), paths[i]);
+        TsRunResult added = tsrun_pool_add_module(pool, module);
+        if (!added.ok) {
+            printf("  ERROR: %s: %s\n", paths[i], added.error);
+        }
+    }
+    const char* stats =
+        "import { square } from './math.ts';\n"
+        "import { sum, range } from './utils.ts';\n"
+        "export function sumOfSquares(n: number) { return sum(range(1, n + 1).map(square)); }\n";
+    tsrun_pool_add_module(pool, tsrun_compile_module(stats, "stats.ts"));
+
+    char args[32];
+    for (int n = 1; n <= 8; n++) {
+        snprintf(args, sizeof(args), "[%d]", n);
+        TsRunResult submitted = tsrun_pool_submit(pool, "stats.ts", "sumOfSquares", args,
+                                                  on_pool_job, (void*)(intptr_t)n);
+        if (!submitted.ok) {
+            printf("  ERROR: %s\n", submitted.error);
+        }
+    }
+
+    tsrun_pool_wait(pool);
+    tsrun_pool_free(pool);
+}
+
 int main(void) {
     printf("tsrun C API - Module Loading Example\n");
 
@@ -398,6 +640,9 @@ int main(void) {
     example_multiple_imports();
     example_default_export();
     example_access_exports();
+    example_precompiled_bytecode();
+    example_parallel_compile();
+    example_thread_pool();
 
     printf("\nDone!\n");
     return 0;
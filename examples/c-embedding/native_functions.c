@@ -6,6 +6,7 @@
 // - Handling arguments and return values
 // - Error handling in native functions
 // - Using userdata for state
+// - Typed native functions that take and return C scalars directly
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -217,6 +218,47 @@ static TsRunValue* native_map_array(
     return result_r.value;
 }
 
+// ============================================================================
+// Typed native functions: plain C signatures, no value handles per call
+// ============================================================================
+
+static double typed_hypot(double x, double y, void* userdata) {
+    (void)userdata;
+    return sqrt(x * x + y * y);
+}
+
+static int64_t typed_gcd(int64_t a, int64_t b, void* userdata) {
+    (void)userdata;
+    while (b != 0) {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a < 0 ? -a : a;
+}
+
+// The string is UTF-8 bytes plus length, not NUL-terminated
+static bool typed_is_palindrome(const char* s, size_t len, void* userdata) {
+    (void)userdata;
+    for (size_t i = 0; i < len / 2; i++) {
+        if (s[i] != s[len - 1 - i]) return false;
+    }
+    return true;
+}
+
+// Register a typed function as a global
+static void register_typed(TsRunContext* ctx, const char* name, TsRunTypedSig sig,
+                           const void* func) {
+    TsRunValueResult fn = tsrun_native_function_typed(ctx, name, sig, func, NULL);
+    if (!fn.value) {
+        printf("Failed to register %s: %s\n", name, fn.error);
+        return;
+    }
+    tsrun_set_global(ctx, name, fn.value);
+    tsrun_value_free(fn.value);
+    printf("Registered: %s [typed]\n", name);
+}
+
 // ============================================================================
 // Helper to run code and print result
 // ============================================================================
@@ -309,6 +351,11 @@ int main(void) {
         printf("Registered: mapArray(arr, fn)\n");
     }
 
+    // Typed functions
+    register_typed(ctx, "hypot", TSRUN_SIG_F64_F64_F64, (const void*)typed_hypot);
+    register_typed(ctx, "gcd", TSRUN_SIG_I64_I64_I64, (const void*)typed_gcd);
+    register_typed(ctx, "isPalindrome", TSRUN_SIG_BOOL_STR, (const void*)typed_is_palindrome);
+
     // Test the native functions
     printf("\n=== Testing native functions ===\n");
 
@@ -331,9 +378,17 @@ int main(void) {
     eval_and_print(ctx, "mapArray([1, 2, 3], (x: number): number => x * x)");
     eval_and_print(ctx, "mapArray(['a', 'b', 'c'], (s: string, i: number): string => s + i)");
 
+    printf("\n=== Testing typed functions ===\n");
+    eval_and_print(ctx, "hypot(3, 4)");
+    eval_and_print(ctx, "gcd(84, 36)");
+    eval_and_print(ctx, "isPalindrome('racecar') && !isPalindrome('tsrun')");
+    eval_and_print(ctx, "hypot('6', { valueOf: () => 8 })");  // Converted like Number(x)
+    eval_and_print(ctx, "let s = 0; for (let i = 0; i < 1000; i++) s += gcd(i, 12); s");
+
     printf("\n=== Error handling ===\n");
     eval_and_print(ctx, "nativeAdd(1)");  // Too few args
     eval_and_print(ctx, "nativeAdd('a', 'b')");  // Wrong types
+    eval_and_print(ctx, "gcd(2 ** 60, 0)");  // int64_t result past 2^53
 
     tsrun_free(ctx);
     printf("\nDone!\n");
@@ -283,6 +283,244 @@ static int pcre2_find_fn(
     return 1;  // Match found
 }
 
+// ============================================================================
+// Bulk Callbacks
+// ============================================================================
+
+// Byte offset one character past pos (used to step over empty matches)
+static size_t next_char_pos(const char* input, size_t input_len, size_t pos) {
+    pos++;
+    while (pos < input_len && ((unsigned char)input[pos] & 0xC0) == 0x80) {
+        pos++;
+    }
+    return pos;
+}
+
+// Match once from start_pos into match_data (1=found, 0=not found, -1=error)
+static int match_from(
+    CompiledRegex* re,
+    pcre2_match_data* match_data,
+    const char* input,
+    size_t input_len,
+    size_t start_pos,
+    const char** error_out
+) {
+    int rc = pcre2_match(
+        re->code,
+        (PCRE2_SPTR)input,
+        input_len,
+        start_pos,
+        0,              // options
+        match_data,
+        re->match_ctx
+    );
+
+    if (rc >= 0) {
+        return 1;
+    } else if (rc == PCRE2_ERROR_NOMATCH) {
+        return 0;
+    } else if (rc == PCRE2_ERROR_MATCHLIMIT) {
+        snprintf(g_error_buffer, sizeof(g_error_buffer),
+                 "regex match limit exceeded (possible catastrophic backtracking)");
+        *error_out = g_error_buffer;
+    } else {
+        *error_out = format_pcre2_error(rc);
+    }
+    return -1;
+}
+
+// Where to search next after a match ending at end (JS empty-match rule)
+static size_t resume_after(const char* input, size_t input_len,
+                           PCRE2_SIZE start, PCRE2_SIZE end) {
+    return end > start ? end : next_char_pos(input, input_len, end);
+}
+
+// Copy n bytes to out if they fit; *len always advances so the full
+// result size is known even when out is too small
+static void append_bytes(char* out, size_t out_capacity, size_t* len,
+                         const char* src, size_t n) {
+    if (*len + n <= out_capacity) {
+        memcpy(out + *len, src, n);
+    }
+    *len += n;
+}
+
+// Find all matches from a position, filling tsrun's buffer
+static int pcre2_find_all_fn(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    size_t start_pos,
+    TsRunRegexMatchBuffer* buffer,
+    const char** error_out
+) {
+    (void)userdata;
+
+    CompiledRegex* re = (CompiledRegex*)handle;
+
+    // One match_data for the whole scan instead of one per match
+    pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re->code, NULL);
+    if (!match_data) {
+        *error_out = "out of memory";
+        return -1;
+    }
+
+    uint32_t groups = pcre2_get_ovector_count(match_data);
+    size_t captures_used = 0;
+    size_t pos = start_pos;
+    int status = 0;
+
+    buffer->match_count = 0;
+    while (pos <= input_len) {
+        if (buffer->match_count == buffer->match_capacity ||
+            captures_used + groups > buffer->capture_capacity) {
+            status = 1;  // Buffer full, tsrun resumes at pos
+            break;
+        }
+
+        int found = match_from(re, match_data, input, input_len, pos, error_out);
+        if (found < 0) {
+            status = -1;
+            break;
+        }
+        if (found == 0) {
+            break;
+        }
+
+        PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(match_data);
+        TsRunRegexMatch* m = &buffer->matches[buffer->match_count++];
+        m->start = ovector[0];
+        m->end = ovector[1];
+        m->captures = &buffer->captures[captures_used];
+        m->capture_count = groups;
+
+        for (uint32_t i = 0; i < groups; i++) {
+            PCRE2_SIZE start = ovector[2 * i];
+            PCRE2_SIZE end = ovector[2 * i + 1];
+            if (start == PCRE2_UNSET) {
+                m->captures[i].start = -1;
+                m->captures[i].end = -1;
+            } else {
+                m->captures[i].start = (intptr_t)start;
+                m->captures[i].end = (intptr_t)end;
+            }
+        }
+        captures_used += groups;
+
+        pos = resume_after(input, input_len, ovector[0], ovector[1]);
+    }
+
+    buffer->resume_pos = pos;
+    pcre2_match_data_free(match_data);
+    return status;
+}
+
+// Replace every match with literal text
+static int pcre2_replace_all_fn(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    const char* replacement,
+    size_t replacement_len,
+    char* out,
+    size_t out_capacity,
+    size_t* out_len,
+    const char** error_out
+) {
+    (void)userdata;
+
+    CompiledRegex* re = (CompiledRegex*)handle;
+
+    pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re->code, NULL);
+    if (!match_data) {
+        *error_out = "out of memory";
+        return -1;
+    }
+
+    size_t len = 0;
+    size_t last_end = 0;
+    size_t pos = 0;
+
+    while (pos <= input_len) {
+        int found = match_from(re, match_data, input, input_len, pos, error_out);
+        if (found < 0) {
+            pcre2_match_data_free(match_data);
+            return -1;
+        }
+        if (found == 0) {
+            break;
+        }
+
+        PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(match_data);
+        append_bytes(out, out_capacity, &len, input + last_end, ovector[0] - last_end);
+        append_bytes(out, out_capacity, &len, replacement, replacement_len);
+        last_end = ovector[1];
+        pos = resume_after(input, input_len, ovector[0], ovector[1]);
+    }
+    append_bytes(out, out_capacity, &len, input + last_end, input_len - last_end);
+
+    pcre2_match_data_free(match_data);
+    *out_len = len;
+    return len <= out_capacity ? 1 : 0;
+}
+
+// Split the input around every match
+static int pcre2_split_fn(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    TsRunRegexCapture* pieces,
+    size_t capacity,
+    size_t* count_out,
+    const char** error_out
+) {
+    (void)userdata;
+
+    CompiledRegex* re = (CompiledRegex*)handle;
+
+    pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re->code, NULL);
+    if (!match_data) {
+        *error_out = "out of memory";
+        return -1;
+    }
+
+    size_t count = 0;
+    size_t last_end = 0;
+    size_t pos = 0;
+
+    while (pos <= input_len) {
+        int found = match_from(re, match_data, input, input_len, pos, error_out);
+        if (found < 0) {
+            pcre2_match_data_free(match_data);
+            return -1;
+        }
+        if (found == 0) {
+            break;
+        }
+
+        PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(match_data);
+        if (count < capacity) {
+            pieces[count].start = (intptr_t)last_end;
+            pieces[count].end = (intptr_t)ovector[0];
+        }
+        count++;
+        last_end = ovector[1];
+        pos = resume_after(input, input_len, ovector[0], ovector[1]);
+    }
+    if (count < capacity) {
+        pieces[count].start = (intptr_t)last_end;
+        pieces[count].end = (intptr_t)input_len;
+    }
+    count++;
+
+    pcre2_match_data_free(match_data);
+    *count_out = count;
+    return count <= capacity ? 1 : 0;
+}
+
 // Free a compiled regex
 static void pcre2_free_fn(void* userdata, void* handle) {
     (void)userdata;
@@ -320,12 +558,16 @@ TsRunRegexCallbacks tsrun_pcre2_provider(const TsRunPcre2Config* config) {
     }
 
     TsRunRegexCallbacks callbacks = {
+        .size = sizeof(TsRunRegexCallbacks),
         .compile = pcre2_compile_fn,
         .is_match = pcre2_is_match_fn,
         .find = pcre2_find_fn,
         .free = pcre2_free_fn,
         .free_captures = pcre2_free_captures_fn,
-        .userdata = NULL
+        .userdata = NULL,
+        .find_all = pcre2_find_all_fn,
+        .replace_all = pcre2_replace_all_fn,
+        .split = pcre2_split_fn
     };
 
     return callbacks;
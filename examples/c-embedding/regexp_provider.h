@@ -8,6 +8,7 @@
 // - UTF-8 support enabled by default
 // - Capture groups with proper indexing
 // - Configurable match limits for backtracking protection
+// - Bulk find_all/replace_all/split callbacks (one call per global operation)
 // - Support for flags: i (ignoreCase), m (multiline), s (dotAll), g (global)
 //
 // Limitations:
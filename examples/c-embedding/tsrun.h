@@ -1,5 +1,6 @@
 // tsrun.h - C API for TypeScript interpreter
-// Thread safety: NOT thread-safe. Use one context per thread.
+// Thread safety: NOT thread-safe. Use one context per thread, or a TsRunPool
+// (whose functions may be called from any thread).
 
 #ifndef TSRUN_H
 #define TSRUN_H
@@ -28,6 +29,11 @@ const char* tsrun_version(void);
 
 typedef struct TsRunContext TsRunContext;
 typedef struct TsRunValue TsRunValue;
+typedef struct TsRunKey TsRunKey;
+typedef struct TsRunSnapshot TsRunSnapshot;
+typedef struct TsRunCompiledModule TsRunCompiledModule;
+typedef struct TsRunJsonParser TsRunJsonParser;
+typedef struct TsRunPool TsRunPool;
 typedef uint64_t TsRunOrderId;
 
 // ============================================================================
@@ -46,6 +52,26 @@ typedef struct {
     const char* error;    // NULL on success
 } TsRunResult;
 
+// Result for operations returning a bytecode blob
+typedef struct {
+    uint8_t* data;        // NULL on error, free with tsrun_bytecode_free
+    size_t len;
+    const char* error;    // NULL on success, valid until next tsrun_* call
+} TsRunBytecodeResult;
+
+// Result for operations returning an encoded value buffer
+typedef struct {
+    uint8_t* data;        // NULL on error, free with tsrun_buffer_free
+    size_t len;
+    const char* error;    // NULL on success, valid until next tsrun_* call
+} TsRunBufferResult;
+
+// Result for operations returning a snapshot
+typedef struct {
+    TsRunSnapshot* snapshot;  // NULL on error, free with tsrun_snapshot_free
+    const char* error;        // NULL on success, valid until next tsrun_* call
+} TsRunSnapshotResult;
+
 // ============================================================================
 // Console Levels
 // ============================================================================
@@ -94,6 +120,7 @@ typedef enum {
     TSRUN_STEP_SUSPENDED,       // Waiting for order fulfillment
     TSRUN_STEP_DONE,            // No active execution
     TSRUN_STEP_ERROR,           // Execution error
+    TSRUN_STEP_BUDGET_EXHAUSTED,// tsrun_run_budget ran out; call again to resume
 } TsRunStepStatus;
 
 // Import request
@@ -104,9 +131,23 @@ typedef struct {
 } TsRunImportRequest;
 
 // Order from JS to host
+//
+// payload_json is written by tsrun's own JSON serializer, not by calling
+// JSON.stringify: toJSON methods are not called; undefined-valued properties
+// are left out; undefined, symbols, functions, Maps, Sets and non-finite
+// numbers become null. An undefined payload leaves both payload and
+// payload_json NULL. A payload with a circular reference is delivered as a
+// handle in payload instead. Adding payload_json and payload_json_len
+// changed the size of this struct: hosts built against a header without them
+// must be recompiled.
 typedef struct {
     TsRunOrderId id;
-    TsRunValue* payload;        // The order payload (owned by context)
+    TsRunValue* payload;        // The order payload (owned by context);
+                                // NULL when delivered as payload_json
+    const char* payload_json;   // Payload as NUL-terminated JSON (owned by the
+                                // step result), or NULL - see
+                                // tsrun_set_order_payload_json
+    size_t payload_json_len;    // Length of payload_json, excluding the NUL
 } TsRunOrder;
 
 // Step result with all possible data
@@ -146,6 +187,18 @@ void tsrun_free(TsRunContext* ctx);
 // For a default stdout/stderr implementation, see tsrun_console.h.
 TsRunResult tsrun_set_console(TsRunContext* ctx, TsRunConsoleFn func, void* userdata);
 
+// Capture an idle context (globals, modules, native functions, console callback)
+// so that new contexts can be created without re-running setup code.
+// Fails if the context is mid-execution or holds generator objects.
+TsRunSnapshotResult tsrun_context_snapshot(TsRunContext* ctx);
+
+// Create a new context from a snapshot. Returns NULL on failure.
+// Each context gets its own copy of the heap; changes are not shared.
+TsRunContext* tsrun_new_from_snapshot(const TsRunSnapshot* snapshot);
+
+// Free a snapshot (contexts created from it remain valid)
+void tsrun_snapshot_free(TsRunSnapshot* snapshot);
+
 // ============================================================================
 // Execution - Step-based API
 // ============================================================================
@@ -154,6 +207,18 @@ TsRunResult tsrun_set_console(TsRunContext* ctx, TsRunConsoleFn func, void* user
 // path is optional (NULL for anonymous scripts, or "/path/to/module.ts" for modules)
 TsRunResult tsrun_prepare(TsRunContext* ctx, const char* code, const char* path);
 
+// Compile code to a bytecode blob without running it (e.g. at deploy time)
+// path is recorded for stack traces and should match the path used when loading.
+// Blobs are only loadable by the same tsrun version.
+TsRunBytecodeResult tsrun_compile_to_bytecode(TsRunContext* ctx, const char* code, const char* path);
+
+// Free a blob returned by tsrun_compile_to_bytecode
+void tsrun_bytecode_free(uint8_t* data, size_t len);
+
+// Prepare a bytecode blob for execution, skipping lex/parse/compile
+// The blob is decoded immediately and may be freed or unmapped afterwards.
+TsRunResult tsrun_prepare_bytecode(TsRunContext* ctx, const uint8_t* data, size_t len, const char* path);
+
 // Execute one step
 // Returns step result - caller must call tsrun_step_result_free when done
 TsRunStepResult tsrun_step(TsRunContext* ctx);
@@ -162,6 +227,23 @@ TsRunStepResult tsrun_step(TsRunContext* ctx);
 // Equivalent to calling step() in a loop until non-Continue result
 TsRunStepResult tsrun_run(TsRunContext* ctx);
 
+// Run like tsrun_run, but stop after max_instructions bytecode instructions
+// or timeout_ns nanoseconds of wall-clock time (0 = no limit for either).
+// Returns TSRUN_STEP_BUDGET_EXHAUSTED when the budget runs out first; call
+// again to resume. The clock is read every 1024 instructions. Callbacks run by
+// builtins (map/sort callbacks, getters) and imported module bodies cannot be
+// suspended: if the deadline passes inside one, the script stops with
+// "RangeError: Time limit exceeded", which JS code cannot catch.
+TsRunStepResult tsrun_run_budget(TsRunContext* ctx, uint64_t max_instructions,
+                                 uint64_t timeout_ns);
+
+// Cap the heap at max_objects live GC objects (0 = unlimited, the default).
+// This counts objects, not bytes: ArrayBuffer backing stores and string
+// contents are not counted, so one large buffer or string passes it. A script
+// that needs more objects stops with "RangeError: Object limit exceeded",
+// which JS code cannot catch.
+void tsrun_set_object_limit(TsRunContext* ctx, size_t max_objects);
+
 // Free a step result (frees internal arrays, NOT the value)
 void tsrun_step_result_free(TsRunStepResult* result);
 
@@ -172,22 +254,55 @@ void tsrun_step_result_free(TsRunStepResult* result);
 // Provide module source code in response to TSRUN_STEP_NEED_IMPORTS
 TsRunResult tsrun_provide_module(TsRunContext* ctx, const char* path, const char* code);
 
+// Provide a precompiled module (from tsrun_compile_to_bytecode with the same path)
+TsRunResult tsrun_provide_module_bytecode(TsRunContext* ctx, const char* path, const uint8_t* data, size_t len);
+
+// Compile a module without a context. Thread-safe: call it from worker threads
+// while the context keeps running, then provide the result on the context's thread.
+// Always returns a module; check tsrun_compiled_module_error.
+TsRunCompiledModule* tsrun_compile_module(const char* code, const char* path);
+
+// Compile error message, or NULL on success (valid until the module is provided or freed)
+const char* tsrun_compiled_module_error(const TsRunCompiledModule* module);
+
+// Provide a module from tsrun_compile_module for a pending import.
+// Takes ownership of module, even on error.
+TsRunResult tsrun_provide_compiled_module(TsRunContext* ctx, const char* path, TsRunCompiledModule* module);
+
+// Free a compiled module that was never provided
+void tsrun_compiled_module_free(TsRunCompiledModule* module);
+
 // ============================================================================
 // Order System (for async operations)
 // ============================================================================
 
 // Order response from host to JS
+//
+// Zero-initialize responses (calloc, = {0} or designated initializers): a
+// non-NULL json is used in place of value, so a field left uninitialized is
+// read as JSON text. Adding json and json_len changed the size of this
+// struct, so hosts built against a header without them must be recompiled.
 typedef struct {
     TsRunOrderId id;
     TsRunValue* value;      // Result value (NULL if error)
     const char* error;      // Error message (NULL if success)
+    const char* json;       // Result as JSON text, used instead of value when
+                            // non-NULL (need not be NUL-terminated)
+    size_t json_len;        // Length of json in bytes
 } TsRunOrderResponse;
 
-// Fulfill one or more orders
+// Fulfill one or more orders.
+// JSON responses are parsed straight into the heap, all before any order is
+// fulfilled: if one fails to parse, an error is returned and none are.
 TsRunResult tsrun_fulfill_orders(TsRunContext* ctx,
                                   const TsRunOrderResponse* responses,
                                   size_t count);
 
+// Deliver order payloads as JSON (TsRunOrder.payload_json) instead of value
+// handles. Undefined payloads give NULL; a payload that cannot be serialized
+// (circular reference) falls back to a handle. Off by default.
+void tsrun_set_order_payload_json(TsRunContext* ctx, bool enabled);
+
 // Create a pending order that will suspend the interpreter.
 // Use in native callbacks to perform async operations.
 // The payload is accessible via order.payload in the step result.
@@ -242,10 +357,47 @@ TsRunValue* tsrun_string_len(TsRunContext* ctx, const char* s, size_t len);
 // Create object/array from JSON string
 TsRunValueResult tsrun_json_parse(TsRunContext* ctx, const char* json);
 
+// Incremental JSON parsing from arbitrary chunks (no contiguous copy needed).
+// Chunks may split the input anywhere, even inside a UTF-8 character.
+// The parser must be finished or freed before its context is freed.
+TsRunJsonParser* tsrun_json_parser_new(TsRunContext* ctx);
+TsRunResult tsrun_json_parser_feed(TsRunContext* ctx, TsRunJsonParser* parser,
+                                   const char* data, size_t len);
+// Consumes the parser, whether or not parsing succeeded
+TsRunValueResult tsrun_json_parser_finish(TsRunContext* ctx, TsRunJsonParser* parser);
+// Abandon a parser without finishing it
+void tsrun_json_parser_free(TsRunJsonParser* parser);
+
 // Create empty object/array
 TsRunValueResult tsrun_object_new(TsRunContext* ctx);
 TsRunValueResult tsrun_array_new(TsRunContext* ctx);
 
+// ============================================================================
+// Binary Data and External Memory
+// ============================================================================
+
+// Called once with the original pointer and length when the last value using
+// host memory has been garbage collected (or the context is freed)
+typedef void (*TsRunExternalFreeFn)(void* data, size_t len, void* userdata);
+
+// ArrayBuffer holding a copy of len bytes at data (zero-filled if data is NULL;
+// a zero-filled buffer over 2 GiB - 1 bytes, or one that cannot be allocated,
+// is an error)
+TsRunValueResult tsrun_arraybuffer_new(TsRunContext* ctx, const void* data, size_t len);
+// ArrayBuffer over host memory without copying. Scripts and views read and
+// write it directly; it must stay valid until free_cb runs (forever if NULL)
+// and may only be touched by the host while no script is running.
+TsRunValueResult tsrun_arraybuffer_external(TsRunContext* ctx, void* data, size_t len,
+                                            TsRunExternalFreeFn free_cb, void* userdata);
+// Borrow the bytes of an ArrayBuffer, typed array (e.g. Float64Array) or DataView
+// in place; for views, starts at the view's first byte. NULL for other values.
+// Valid while val is alive.
+uint8_t* tsrun_arraybuffer_data(const TsRunValue* val, size_t* len_out);
+// String over host-owned UTF-8 without copying; the bytes must not change until
+// free_cb runs. Fails on invalid UTF-8 without taking ownership (free_cb not called).
+TsRunValueResult tsrun_string_external(TsRunContext* ctx, const char* data, size_t len,
+                                       TsRunExternalFreeFn free_cb, void* userdata);
+
 // ============================================================================
 // Value Memory Management
 // ============================================================================
@@ -271,12 +423,37 @@ TsRunResult tsrun_delete(TsRunContext* ctx, TsRunValue* obj, const char* key);
 char** tsrun_keys(TsRunContext* ctx, TsRunValue* obj, size_t* count_out);
 void tsrun_free_strings(char** strings, size_t count);
 
+// Interned property keys
+// Intern a key once and reuse it for many lookups; _k variants perform no
+// allocation. Keys belong to the context that created them (NULL on invalid key).
+TsRunKey* tsrun_key_intern(TsRunContext* ctx, const char* key);
+void tsrun_key_free(TsRunKey* key);
+TsRunValueResult tsrun_get_k(TsRunContext* ctx, TsRunValue* obj, const TsRunKey* key);
+TsRunResult tsrun_set_k(TsRunContext* ctx, TsRunValue* obj, const TsRunKey* key, TsRunValue* val);
+bool tsrun_has_k(TsRunContext* ctx, TsRunValue* obj, const TsRunKey* key);
+
 // Array operations
 size_t tsrun_array_len(const TsRunValue* arr);
 TsRunValueResult tsrun_array_get(TsRunContext* ctx, TsRunValue* arr, size_t index);
 TsRunResult tsrun_array_set(TsRunContext* ctx, TsRunValue* arr, size_t index, TsRunValue* val);
 TsRunResult tsrun_array_push(TsRunContext* ctx, TsRunValue* arr, TsRunValue* val);
 
+// Bulk extraction
+// Read n properties in one call; out_values receives n handles (free each one).
+TsRunResult tsrun_get_many(TsRunContext* ctx, TsRunValue* obj,
+                           const TsRunKey* const* keys, size_t n,
+                           TsRunValue** out_values);
+// Copy up to n array elements into out without creating handles (non-numbers -> NaN).
+// Returns the number of elements written.
+size_t tsrun_array_read_numbers(TsRunContext* ctx, TsRunValue* arr, double* out, size_t n);
+// Borrow the elements of an all-number array without copying; NULL if the array
+// holds anything else. Valid until the array is modified or freed.
+const double* tsrun_array_as_f64_slice(TsRunContext* ctx, TsRunValue* arr, size_t* out_len);
+// Copy field `key` of up to n object elements into out (missing/non-number -> NaN).
+// Returns the number of elements written.
+size_t tsrun_array_read_f64_field(TsRunContext* ctx, TsRunValue* arr, const char* key,
+                                  double* out, size_t n);
+
 // ============================================================================
 // Function Calls
 // ============================================================================
@@ -336,6 +513,37 @@ TsRunValueResult tsrun_native_function(
     void* userdata
 );
 
+// Signatures for tsrun_native_function_typed. Every function takes the
+// registration's userdata as its last parameter. Strings arrive as UTF-8
+// bytes plus length (not NUL-terminated), valid only during the call.
+typedef enum {
+    TSRUN_SIG_F64 = 0,          // double f(void* ud)
+    TSRUN_SIG_F64_F64,          // double f(double, void* ud)
+    TSRUN_SIG_F64_F64_F64,      // double f(double, double, void* ud)
+    TSRUN_SIG_F64_F64_F64_F64,  // double f(double, double, double, void* ud)
+    TSRUN_SIG_I64_I64,          // int64_t f(int64_t, void* ud)
+    TSRUN_SIG_I64_I64_I64,      // int64_t f(int64_t, int64_t, void* ud)
+    TSRUN_SIG_BOOL_F64,         // bool f(double, void* ud)
+    TSRUN_SIG_BOOL_STR,         // bool f(const char*, size_t, void* ud)
+    TSRUN_SIG_F64_STR,          // double f(const char*, size_t, void* ud)
+} TsRunTypedSig;
+
+// Create a native function from a plain C function of signature sig.
+// No value handles are created per call: arguments are passed as C scalars
+// (converted like Number(x)/String(x) when JS passes another type; int64_t
+// arguments are truncated and saturated) and the result becomes a JS
+// number or boolean. An int64_t result beyond +/-(2^53 - 1) cannot be a
+// JS number exactly, so the call throws a RangeError rather than rounding.
+// func must match sig exactly. Typed functions cannot throw themselves; use
+// tsrun_native_function when a call needs to fail.
+TsRunValueResult tsrun_native_function_typed(
+    TsRunContext* ctx,
+    const char* name,
+    TsRunTypedSig sig,
+    const void* func,
+    void* userdata
+);
+
 // ============================================================================
 // JSON Serialization
 // ============================================================================
@@ -344,6 +552,30 @@ TsRunValueResult tsrun_native_function(
 char* tsrun_json_stringify(TsRunContext* ctx, TsRunValue* val);
 void tsrun_free_string(char* s);
 
+// Output callback: receives the next len bytes of JSON (not NUL-terminated).
+// Return false to abort serialization.
+typedef bool (*TsRunWriteFn)(const char* data, size_t len, void* userdata);
+
+// Serialize value to JSON in chunks without building the whole string.
+// Chunks already written are not retracted if serialization fails later.
+TsRunResult tsrun_json_stringify_to(TsRunContext* ctx, TsRunValue* val,
+                                    TsRunWriteFn write, void* userdata);
+
+// ============================================================================
+// Binary Value Transfer
+// ============================================================================
+
+// Serialize a value graph into one buffer (free with tsrun_buffer_free).
+// Unlike JSON, keeps undefined, NaN/Infinity, -0, binary data (as bytes),
+// shared sub-objects and cycles; repeated strings are written once.
+// Lets hosts that pay per call (e.g. WASM) read a whole payload at once.
+TsRunBufferResult tsrun_encode_value(TsRunContext* ctx, TsRunValue* val);
+
+// Rebuild a value from tsrun_encode_value output; data is only read during the call
+TsRunValueResult tsrun_decode_value(TsRunContext* ctx, const uint8_t* data, size_t len);
+
+void tsrun_buffer_free(uint8_t* data, size_t len);
+
 // ============================================================================
 // Internal Modules (for extending the interpreter)
 // ============================================================================
@@ -429,14 +661,83 @@ typedef void (*TsRunRegexFreeCapturesFn)(
     size_t count
 );
 
+// Caller-allocated buffer filled by find_all. Each match's captures point
+// into the shared captures pool (owned by tsrun, never passed to free_captures).
+typedef struct {
+    TsRunRegexMatch* matches;       // Match slots
+    size_t match_capacity;          // Number of match slots
+    TsRunRegexCapture* captures;    // Capture slots shared by all matches
+    size_t capture_capacity;        // Number of capture slots
+    size_t match_count;             // Out: matches written
+    size_t resume_pos;              // Out: start_pos for the next call
+} TsRunRegexMatchBuffer;
+
+// Callback (optional): Write all matches from start_pos into buffer, in order.
+// Stops when either pool is full; set resume_pos past the last written match
+// (one character further after an empty match). Writing no matches and
+// returning 1 asks for a larger capture pool.
+// Returns 1 if more matches may follow, 0 if all were written, -1 on error.
+typedef int (*TsRunRegexFindAllFn)(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    size_t start_pos,
+    TsRunRegexMatchBuffer* buffer,
+    const char** error_out
+);
+
+// Callback (optional): Replace every match with literal text.
+// Only called for global regexes and replacements without '$' patterns.
+// Writes the result (not null-terminated) to out and its length to *out_len.
+// Returns 1 on success, 0 if out_capacity is too small (set *out_len to the
+// required size and tsrun retries), -1 on error.
+typedef int (*TsRunRegexReplaceAllFn)(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    const char* replacement,
+    size_t replacement_len,
+    char* out,
+    size_t out_capacity,
+    size_t* out_len,
+    const char** error_out
+);
+
+// Callback (optional): Write the spans of the pieces between all matches,
+// including the pieces before the first and after the last match.
+// Returns 1 on success (*count_out pieces), 0 if capacity is too small (set
+// *count_out to the required count and tsrun retries), -1 on error.
+typedef int (*TsRunRegexSplitFn)(
+    void* userdata,
+    void* handle,
+    const char* input,
+    size_t input_len,
+    TsRunRegexCapture* pieces,
+    size_t capacity,
+    size_t* count_out,
+    const char** error_out
+);
+
 // Bundle of regex callbacks
+//
+// Set size to sizeof(TsRunRegexCallbacks). Callbacks may be appended in later
+// versions; tsrun treats fields past size as NULL, so callers built against
+// an older header keep working. The size field itself was added together
+// with find_all, replace_all and split: callers built before then must be
+// recompiled.
 typedef struct {
+    size_t size;  // sizeof(TsRunRegexCallbacks)
     TsRunRegexCompileFn compile;
     TsRunRegexIsMatchFn is_match;
     TsRunRegexFindFn find;
     TsRunRegexFreeFn free;
     TsRunRegexFreeCapturesFn free_captures;  // May be NULL
     void* userdata;
+    TsRunRegexFindAllFn find_all;        // May be NULL (find is called per match)
+    TsRunRegexReplaceAllFn replace_all;  // May be NULL
+    TsRunRegexSplitFn split;             // May be NULL
 } TsRunRegexCallbacks;
 
 // Set a custom RegExp provider
@@ -452,10 +753,123 @@ typedef struct {
     size_t total_objects;   // Total GcBox slots (including pooled)
     size_t pooled_objects;  // Objects in pool (available for reuse)
     size_t live_objects;    // Number of live objects
+    size_t reserved_bytes;  // Slot storage held by the heap (pooled included)
+    size_t used_bytes;      // Slot storage occupied by live objects
 } TsRunGcStats;
 
 TsRunGcStats tsrun_gc_stats(TsRunContext* ctx);
 
+// Collect, then return fully empty chunks of GC slots to the allocator.
+// Collections already release empty chunks once the pool outgrows the
+// live set; call this after a peak (e.g. a large discarded document).
+void tsrun_gc_shrink(TsRunContext* ctx);
+
+// Collect incrementally: each GC slice pauses at most `microseconds`
+// (0 = stop-the-world collection, the default)
+void tsrun_gc_set_budget(TsRunContext* ctx, uint64_t microseconds);
+
+typedef struct {
+    uint64_t hits;               // Property accesses answered from an inline cache
+    uint64_t misses;             // Property accesses that took the generic lookup
+    uint64_t megamorphic_sites;  // Sites that saw too many shapes and stopped caching
+} TsRunIcStats;
+
+TsRunIcStats tsrun_ic_stats(TsRunContext* ctx);
+
+typedef struct {
+    uint64_t hits;      // Regex compiles answered from the shared cache
+    uint64_t misses;    // Regex compiles that went to the RegExp provider
+    size_t entries;     // Patterns currently cached
+    size_t capacity;    // Maximum cached patterns (0 = caching disabled)
+} TsRunRegexCacheStats;
+
+TsRunRegexCacheStats tsrun_regexp_cache_stats(TsRunContext* ctx);
+
+// Set how many compiled regexes the context caches (default 64, 0 = off).
+// The cache is keyed by (pattern, flags) and shared by all RegExp objects,
+// in front of the built-in or custom RegExp provider.
+void tsrun_regexp_cache_set_capacity(TsRunContext* ctx, size_t capacity);
+
+// ============================================================================
+// Profiler
+// ============================================================================
+
+typedef struct {
+    const char* name;        // Function name ("<anonymous>" / "<top-level>")
+    const char* file;        // Source file, or NULL
+    uint32_t line;           // Line of the function's first instruction
+    uint64_t self_samples;   // Samples where this function was running
+    uint64_t total_samples;  // Samples where it was anywhere on the stack
+} TsRunProfileFunction;
+
+typedef struct {
+    const char* name;        // Opcode name, e.g. "GetPropertyConst"
+    uint64_t count;          // Times it executed
+} TsRunOpcodeCount;
+
+// Passed to the tsrun_profiler_stop callback; valid only during the callback
+typedef struct {
+    uint64_t sample_count;
+    const char* folded;                        // "outer;inner;leaf count\n" per stack
+    size_t folded_len;                         // (flamegraph.pl input)
+    const TsRunProfileFunction* functions;     // Most self samples first
+    size_t function_count;
+    const TsRunOpcodeCount* opcodes;           // Most frequent first; empty
+    size_t opcode_count;                       // unless count_opcodes was set
+} TsRunProfile;
+
+typedef void (*TsRunProfileFn)(const TsRunProfile* profile, void* userdata);
+
+// Sample the JS call stack every interval_ns of execution. The clock is read
+// every 256 instructions and each read records the stack once per elapsed
+// interval; 0 records one sample per read. count_opcodes also counts every
+// instruction by opcode, at a noticeable cost. Replaces any running session.
+TsRunResult tsrun_profiler_start(TsRunContext* ctx, uint64_t interval_ns, bool count_opcodes);
+
+// Stop profiling and pass the profile to callback. Fails if not running.
+TsRunResult tsrun_profiler_stop(TsRunContext* ctx, TsRunProfileFn callback, void* userdata);
+
+// ============================================================================
+// Thread Pool
+// ============================================================================
+
+// Each worker thread owns one context. Modules are compiled once and the
+// serialized bytecode is shared; each worker decodes it into its own context
+// the first time one of its jobs needs it, so decoded code takes memory once
+// per worker that runs it. Module state then persists between that worker's
+// jobs (it is not shared across workers); a failed load resets the worker's
+// context. Orders are not fulfilled, so entries must settle synchronously.
+//
+// Pool functions may be called from any thread. Their error strings are valid
+// until the next failing tsrun_pool_* call on the same thread.
+
+// Called on a worker thread. error is non-NULL if the job failed; otherwise
+// result_json is the return value as JSON (NULL for undefined). Both strings
+// are valid only during the callback.
+typedef void (*TsRunPoolJobFn)(const char* result_json, const char* error, void* userdata);
+
+// Start nthreads workers (0 = one per available CPU). NULL if a worker thread
+// could not be started.
+TsRunPool* tsrun_pool_new(size_t nthreads);
+
+// Number of worker threads
+size_t tsrun_pool_threads(const TsRunPool* pool);
+
+// Add a module from tsrun_compile_module; jobs and imports name it by the path
+// it was compiled with. Takes ownership of module, even on error.
+TsRunResult tsrun_pool_add_module(TsRunPool* pool, TsRunCompiledModule* module);
+
+// Queue a call to the exported function entry of module. args_json is a JSON
+// array of arguments, or NULL for none. A settled returned promise is unwrapped.
+TsRunResult tsrun_pool_submit(TsRunPool* pool, const char* module, const char* entry,
+                              const char* args_json, TsRunPoolJobFn callback, void* userdata);
+
+// Block until every submitted job has finished and its callback returned
+void tsrun_pool_wait(TsRunPool* pool);
+
+// Run the jobs still queued, stop the workers and free the pool
+void tsrun_pool_free(TsRunPool* pool);
+
 #ifdef __cplusplus
 }
 #endif
@@ -139,7 +139,7 @@ func main() {
 					}
 
 					// Extract order info (WASM calls on main goroutine)
-					info := extractOrderInfo(ctx, order.Payload)
+					info := extractOrderInfo(ctx, interp, order.Payload)
 
 					// Log promise creation (similar to wasm-playground)
 					fmt.Printf("[Order %d] Creating Promise for %s, will resolve in %dms...\n", order.ID, info.orderType, info.delayMs)
@@ -259,32 +259,26 @@ type orderInfo struct {
 }
 
 // extractOrderInfo extracts order info from payload and calculates actual delay.
-func extractOrderInfo(ctx context.Context, payload *tsrun.Value) orderInfo {
+func extractOrderInfo(ctx context.Context, interp *tsrun.Context, payload *tsrun.Value) orderInfo {
 	info := orderInfo{}
 	if payload == nil {
 		return info
 	}
 
-	orderType, _ := payload.Get(ctx, "type")
-	if orderType != nil {
-		info.orderType, _ = orderType.AsString(ctx)
-		orderType.Free(ctx)
+	// One call decodes the whole payload, instead of one call per property
+	data, err := interp.ToGo(ctx, payload)
+	if err != nil {
+		return info
 	}
+	fields, _ := data.(map[string]any)
 
+	info.orderType, _ = fields["type"].(string)
 	switch info.orderType {
 	case "delay":
-		msVal, _ := payload.Get(ctx, "ms")
-		if msVal != nil {
-			ms, _ := msVal.AsNumber(ctx)
-			info.delayMs = int(ms)
-			msVal.Free(ctx)
-		}
+		ms, _ := fields["ms"].(float64)
+		info.delayMs = int(ms)
 	case "fetch":
-		urlVal, _ := payload.Get(ctx, "url")
-		if urlVal != nil {
-			info.url, _ = urlVal.AsString(ctx)
-			urlVal.Free(ctx)
-		}
+		info.url, _ = fields["url"].(string)
 		// Calculate actual random delay upfront (50-200ms)
 		info.delayMs = 50 + rand.Intn(150)
 	}
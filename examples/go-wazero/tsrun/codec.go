@@ -0,0 +1,434 @@
+package tsrun
+
+import (
+	"context"
+	"encoding/binary"
+	"fmt"
+	"math"
+	"reflect"
+	"sort"
+	"unicode/utf8"
+)
+
+// Binary value transfer.
+//
+// ToGo and FromGo move a whole value graph across the WASM boundary in one
+// call each, using the format written by tsrun_encode_value (see
+// src/interpreter/builtins/value_codec.rs). Calling Get/AsNumber/... per
+// property costs one boundary crossing each, which dominates for large
+// payloads.
+//
+// Decoded JavaScript values map to Go as:
+//
+//	undefined        -> Undefined
+//	null             -> nil
+//	boolean          -> bool
+//	number           -> float64
+//	string           -> string
+//	array            -> []any
+//	object           -> map[string]any
+//	binary data      -> []byte (ArrayBuffer, typed arrays and DataViews)
+//
+// Shared sub-objects decode to the same Go map or slice.
+
+const valueCodecVersion = 1
+
+const (
+	tagUndefined = iota
+	tagNull
+	tagFalse
+	tagTrue
+	tagInt
+	tagFloat
+	tagString
+	tagStringRef
+	tagArray
+	tagObject
+	tagBytes
+	tagObjectRef
+)
+
+// maxDepth bounds encoder recursion, which also stops cyclic Go data.
+const maxDepth = 10000
+
+// maxInt is 2^53, the largest integer written with tagInt.
+const maxInt = 1 << 53
+
+// UndefinedValue is the type of Undefined.
+type UndefinedValue struct{}
+
+// Undefined is the Go form of JavaScript undefined.
+var Undefined = UndefinedValue{}
+
+// ToGo converts a value and everything reachable from it into Go values
+// with a single call into the guest.
+func (c *Context) ToGo(ctx context.Context, value *Value) (any, error) {
+	if c.rt.fnEncodeValue == nil || c.rt.fnBufferFree == nil {
+		return nil, fmt.Errorf("encode_value function not available")
+	}
+
+	// TsRunBufferResult: { data: *u8, len: usize, error: *c_char } = 12 bytes
+	const resultSize = 12
+	resultPtr, err := c.rt.allocResult(ctx, resultSize)
+	if err != nil {
+		return nil, fmt.Errorf("failed to allocate result: %w", err)
+	}
+	defer c.rt.deallocResult(ctx, resultPtr, resultSize)
+
+	// Call with sret convention: (sret, ctx, value)
+	_, err = c.rt.fnEncodeValue.Call(ctx, uint64(resultPtr), uint64(c.handle), uint64(value.handle))
+	if err != nil {
+		return nil, err
+	}
+
+	dataPtr, _ := c.rt.memory.ReadUint32Le(resultPtr)
+	dataLen, _ := c.rt.memory.ReadUint32Le(resultPtr + 4)
+	errorPtr, _ := c.rt.memory.ReadUint32Le(resultPtr + 8)
+	if errorPtr != 0 {
+		return nil, fmt.Errorf("encode_value error: %s", c.rt.readString(errorPtr))
+	}
+	defer c.rt.fnBufferFree.Call(ctx, uint64(dataPtr), uint64(dataLen))
+
+	// Read views guest memory directly; decoding copies what it keeps
+	data, ok := c.rt.memory.Read(dataPtr, dataLen)
+	if !ok {
+		return nil, fmt.Errorf("encode_value returned an out-of-range buffer")
+	}
+	return DecodeValue(data)
+}
+
+// FromGo builds a guest value from Go data with a single call into the guest.
+// See EncodeValue for the accepted Go types.
+func (c *Context) FromGo(ctx context.Context, data any) (*Value, error) {
+	if c.rt.fnDecodeValue == nil {
+		return nil, fmt.Errorf("decode_value function not available")
+	}
+
+	buf, err := EncodeValue(data)
+	if err != nil {
+		return nil, err
+	}
+
+	bufPtr, err := c.rt.allocResult(ctx, uint32(len(buf)))
+	if err != nil {
+		return nil, err
+	}
+	defer c.rt.deallocResult(ctx, bufPtr, uint32(len(buf)))
+	if !c.rt.memory.Write(bufPtr, buf) {
+		return nil, fmt.Errorf("failed to write value buffer")
+	}
+
+	// TsRunValueResult: { value: *TsRunValue (4 bytes), error: *c_char (4 bytes) } = 8 bytes
+	const resultSize = 8
+	resultPtr, err := c.rt.allocResult(ctx, resultSize)
+	if err != nil {
+		return nil, fmt.Errorf("failed to allocate result: %w", err)
+	}
+	defer c.rt.deallocResult(ctx, resultPtr, resultSize)
+
+	// Call with sret convention: (sret, ctx, data, len)
+	_, err = c.rt.fnDecodeValue.Call(ctx, uint64(resultPtr), uint64(c.handle), uint64(bufPtr), uint64(len(buf)))
+	if err != nil {
+		return nil, err
+	}
+
+	valuePtr, _ := c.rt.memory.ReadUint32Le(resultPtr)
+	errorPtr, _ := c.rt.memory.ReadUint32Le(resultPtr + 4)
+	if errorPtr != 0 {
+		return nil, fmt.Errorf("decode_value error: %s", c.rt.readString(errorPtr))
+	}
+	if valuePtr == 0 {
+		return nil, fmt.Errorf("decode_value returned null")
+	}
+	return &Value{ctx: c, handle: valuePtr}, nil
+}
+
+// EncodeValue serializes Go data in the tsrun value format.
+//
+// Accepted types: nil (null), UndefinedValue, bool, integer and float
+// types, string, []byte, and slices, arrays and string-keyed maps of
+// accepted types. Map keys are written in sorted order.
+func EncodeValue(data any) ([]byte, error) {
+	e := &encoder{out: []byte{valueCodecVersion}, strings: map[string]uint64{}}
+	if err := e.writeValue(reflect.ValueOf(data), 0); err != nil {
+		return nil, err
+	}
+	return e.out, nil
+}
+
+type encoder struct {
+	out     []byte
+	strings map[string]uint64
+}
+
+func (e *encoder) writeLen(tag byte, n int) {
+	e.out = append(e.out, tag)
+	e.out = binary.AppendUvarint(e.out, uint64(n))
+}
+
+func (e *encoder) writeNumber(f float64) {
+	if f == math.Trunc(f) && math.Abs(f) <= maxInt && !(f == 0 && math.Signbit(f)) {
+		i := int64(f)
+		e.out = append(e.out, tagInt)
+		e.out = binary.AppendUvarint(e.out, uint64((i<<1)^(i>>63)))
+		return
+	}
+	e.out = append(e.out, tagFloat)
+	e.out = binary.LittleEndian.AppendUint64(e.out, math.Float64bits(f))
+}
+
+func (e *encoder) writeString(s string) error {
+	if !utf8.ValidString(s) {
+		return fmt.Errorf("string is not valid UTF-8")
+	}
+	if index, ok := e.strings[s]; ok {
+		e.writeLen(tagStringRef, int(index))
+		return nil
+	}
+	e.strings[s] = uint64(len(e.strings))
+	e.writeLen(tagString, len(s))
+	e.out = append(e.out, s...)
+	return nil
+}
+
+func (e *encoder) writeValue(v reflect.Value, depth int) error {
+	if depth > maxDepth {
+		return fmt.Errorf("value nesting too deep to encode")
+	}
+	if !v.IsValid() {
+		e.out = append(e.out, tagNull)
+		return nil
+	}
+	if v.Type() == reflect.TypeOf(Undefined) {
+		e.out = append(e.out, tagUndefined)
+		return nil
+	}
+
+	switch v.Kind() {
+	case reflect.Interface, reflect.Pointer:
+		if v.IsNil() {
+			e.out = append(e.out, tagNull)
+			return nil
+		}
+		return e.writeValue(v.Elem(), depth)
+	case reflect.Bool:
+		if v.Bool() {
+			e.out = append(e.out, tagTrue)
+		} else {
+			e.out = append(e.out, tagFalse)
+		}
+	case reflect.Int, reflect.Int8, reflect.Int16, reflect.Int32, reflect.Int64:
+		e.writeNumber(float64(v.Int()))
+	case reflect.Uint, reflect.Uint8, reflect.Uint16, reflect.Uint32, reflect.Uint64, reflect.Uintptr:
+		e.writeNumber(float64(v.Uint()))
+	case reflect.Float32, reflect.Float64:
+		e.writeNumber(v.Float())
+	case reflect.String:
+		return e.writeString(v.String())
+	case reflect.Slice, reflect.Array:
+		if v.Type().Elem().Kind() == reflect.Uint8 {
+			e.writeLen(tagBytes, v.Len())
+			for i := 0; i < v.Len(); i++ {
+				e.out = append(e.out, byte(v.Index(i).Uint()))
+			}
+			return nil
+		}
+		e.writeLen(tagArray, v.Len())
+		for i := 0; i < v.Len(); i++ {
+			if err := e.writeValue(v.Index(i), depth+1); err != nil {
+				return err
+			}
+		}
+	case reflect.Map:
+		if v.Type().Key().Kind() != reflect.String {
+			return fmt.Errorf("cannot encode map with %s keys", v.Type().Key())
+		}
+		keys := v.MapKeys()
+		sort.Slice(keys, func(i, j int) bool { return keys[i].String() < keys[j].String() })
+		e.writeLen(tagObject, len(keys))
+		for _, key := range keys {
+			if err := e.writeString(key.String()); err != nil {
+				return err
+			}
+			if err := e.writeValue(v.MapIndex(key), depth+1); err != nil {
+				return err
+			}
+		}
+	default:
+		return fmt.Errorf("cannot encode Go value of type %s", v.Type())
+	}
+	return nil
+}
+
+// DecodeValue parses a buffer in the tsrun value format into Go values.
+func DecodeValue(data []byte) (any, error) {
+	d := &decoder{data: data}
+	version, err := d.readByte()
+	if err != nil {
+		return nil, err
+	}
+	if version != valueCodecVersion {
+		return nil, fmt.Errorf("unsupported value buffer version %d", version)
+	}
+	value, err := d.readValue()
+	if err != nil {
+		return nil, err
+	}
+	if d.pos != len(d.data) {
+		return nil, d.errorf("trailing bytes")
+	}
+	return value, nil
+}
+
+type decoder struct {
+	data    []byte
+	pos     int
+	strings []string
+	objects []any
+}
+
+func (d *decoder) errorf(format string, args ...any) error {
+	return fmt.Errorf("invalid value buffer at byte %d: %s", d.pos, fmt.Sprintf(format, args...))
+}
+
+func (d *decoder) readByte() (byte, error) {
+	if d.pos >= len(d.data) {
+		return 0, d.errorf("unexpected end")
+	}
+	b := d.data[d.pos]
+	d.pos++
+	return b, nil
+}
+
+func (d *decoder) readVarint() (uint64, error) {
+	n, size := binary.Uvarint(d.data[d.pos:])
+	if size <= 0 {
+		return 0, d.errorf("bad varint")
+	}
+	d.pos += size
+	return n, nil
+}
+
+// readLen reads a length that must fit in the remaining input.
+func (d *decoder) readLen() (int, error) {
+	n, err := d.readVarint()
+	if err != nil {
+		return 0, err
+	}
+	if n > uint64(len(d.data)-d.pos) {
+		return 0, d.errorf("length exceeds input")
+	}
+	return int(n), nil
+}
+
+func (d *decoder) readString(tag byte) (string, error) {
+	switch tag {
+	case tagString:
+		n, err := d.readLen()
+		if err != nil {
+			return "", err
+		}
+		s := string(d.data[d.pos : d.pos+n])
+		d.pos += n
+		d.strings = append(d.strings, s)
+		return s, nil
+	case tagStringRef:
+		index, err := d.readVarint()
+		if err != nil {
+			return "", err
+		}
+		if index >= uint64(len(d.strings)) {
+			return "", d.errorf("reference to an unknown string")
+		}
+		return d.strings[index], nil
+	default:
+		return "", d.errorf("expected a string")
+	}
+}
+
+func (d *decoder) readValue() (any, error) {
+	tag, err := d.readByte()
+	if err != nil {
+		return nil, err
+	}
+	switch tag {
+	case tagUndefined:
+		return Undefined, nil
+	case tagNull:
+		return nil, nil
+	case tagFalse:
+		return false, nil
+	case tagTrue:
+		return true, nil
+	case tagInt:
+		zigzag, err := d.readVarint()
+		if err != nil {
+			return nil, err
+		}
+		return float64(int64(zigzag>>1) ^ -int64(zigzag&1)), nil
+	case tagFloat:
+		if len(d.data)-d.pos < 8 {
+			return nil, d.errorf("unexpected end")
+		}
+		bits := binary.LittleEndian.Uint64(d.data[d.pos:])
+		d.pos += 8
+		return math.Float64frombits(bits), nil
+	case tagString, tagStringRef:
+		return d.readString(tag)
+	case tagArray:
+		n, err := d.readLen()
+		if err != nil {
+			return nil, err
+		}
+		// Registered before its elements so they can refer back to it
+		items := make([]any, n)
+		d.objects = append(d.objects, items)
+		for i := range items {
+			if items[i], err = d.readValue(); err != nil {
+				return nil, err
+			}
+		}
+		return items, nil
+	case tagObject:
+		n, err := d.readLen()
+		if err != nil {
+			return nil, err
+		}
+		obj := make(map[string]any, n)
+		d.objects = append(d.objects, obj)
+		for i := 0; i < n; i++ {
+			keyTag, err := d.readByte()
+			if err != nil {
+				return nil, err
+			}
+			key, err := d.readString(keyTag)
+			if err != nil {
+				return nil, err
+			}
+			if obj[key], err = d.readValue(); err != nil {
+				return nil, err
+			}
+		}
+		return obj, nil
+	case tagBytes:
+		n, err := d.readLen()
+		if err != nil {
+			return nil, err
+		}
+		b := append([]byte(nil), d.data[d.pos:d.pos+n]...)
+		d.pos += n
+		d.objects = append(d.objects, b)
+		return b, nil
+	case tagObjectRef:
+		index, err := d.readVarint()
+		if err != nil {
+			return nil, err
+		}
+		if index >= uint64(len(d.objects)) {
+			return nil, d.errorf("reference to an unknown object")
+		}
+		return d.objects[index], nil
+	default:
+		return nil, d.errorf("unknown tag %d", tag)
+	}
+}
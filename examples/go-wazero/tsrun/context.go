@@ -230,7 +230,10 @@ func (c *Context) parsePendingOrders(ptr uint32, count uint32) []Order {
 	// TsRunOrder layout (wasm32):
 	// offset 0: id (u64)
 	// offset 8: payload (i32 pointer to TsRunValue)
-	const structSize = 12 // 8 + 4 on wasm32
+	// offset 12: payload_json (i32, NULL unless JSON payload delivery is on)
+	// offset 16: payload_json_len (u32)
+	// Total: 24 bytes (padded to the u64 alignment)
+	const structSize = 24
 
 	orders := make([]Order, count)
 	for i := uint32(0); i < count; i++ {
@@ -320,8 +323,10 @@ func (c *Context) FulfillOrders(ctx context.Context, responses []OrderResponse)
 	// offset 0: id (u64, 8 bytes)
 	// offset 8: value (*mut TsRunValue, 4 bytes)
 	// offset 12: error (*const c_char, 4 bytes)
-	// Total: 16 bytes per response
-	const responseSize = 16
+	// offset 16: json (*const c_char, 4 bytes)
+	// offset 20: json_len (usize, 4 bytes)
+	// Total: 24 bytes per response
+	const responseSize = 24
 
 	// Allocate array for all responses
 	arraySize := uint32(len(responses) * responseSize)
@@ -331,6 +336,25 @@ func (c *Context) FulfillOrders(ctx context.Context, responses []OrderResponse)
 	}
 	defer c.rt.deallocResult(ctx, arrayPtr, arraySize)
 
+	// Convert Data responses up front; fulfill_orders copies the handles,
+	// so ours are freed once it returns
+	dataValues := make([]*Value, len(responses))
+	defer func() {
+		for _, v := range dataValues {
+			if v != nil {
+				v.Free(ctx)
+			}
+		}
+	}()
+	for i, resp := range responses {
+		if resp.Data == nil {
+			continue
+		}
+		if dataValues[i], err = c.FromGo(ctx, resp.Data); err != nil {
+			return fmt.Errorf("failed to convert response data: %w", err)
+		}
+	}
+
 	// Track error strings we allocate so we can free them
 	var errorPtrs []uint32
 
@@ -343,7 +367,9 @@ func (c *Context) FulfillOrders(ctx context.Context, responses []OrderResponse)
 
 		// Write value pointer (i32 at offset 8)
 		var valueHandle uint32
-		if resp.Value != nil {
+		if dataValues[i] != nil {
+			valueHandle = dataValues[i].handle
+		} else if resp.Value != nil {
 			valueHandle = resp.Value.handle
 		}
 		c.rt.memory.WriteUint32Le(offset+8, valueHandle)
@@ -362,6 +388,10 @@ func (c *Context) FulfillOrders(ctx context.Context, responses []OrderResponse)
 			errorPtrs = append(errorPtrs, errorPtr)
 		}
 		c.rt.memory.WriteUint32Le(offset+12, errorPtr)
+
+		// No JSON body (json = NULL, json_len = 0)
+		c.rt.memory.WriteUint32Le(offset+16, 0)
+		c.rt.memory.WriteUint32Le(offset+20, 0)
 	}
 
 	// Allocate space for TsRunResult (sret convention)
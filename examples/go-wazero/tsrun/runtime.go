@@ -61,6 +61,11 @@ type Runtime struct {
 	fnFreeString    api.Function
 	fnFreeStrings   api.Function
 
+	// Binary value transfer
+	fnEncodeValue api.Function
+	fnDecodeValue api.Function
+	fnBufferFree  api.Function
+
 	// Module functions
 	fnProvideModule api.Function
 	fnGetImports    api.Function
@@ -288,6 +293,11 @@ func (r *Runtime) getExportedFunctions() error {
 	r.fnFreeString = r.module.ExportedFunction("tsrun_free_string")
 	r.fnFreeStrings = r.module.ExportedFunction("tsrun_free_strings")
 
+	// Binary value transfer
+	r.fnEncodeValue = r.module.ExportedFunction("tsrun_encode_value")
+	r.fnDecodeValue = r.module.ExportedFunction("tsrun_decode_value")
+	r.fnBufferFree = r.module.ExportedFunction("tsrun_buffer_free")
+
 	// Module functions
 	r.fnProvideModule = r.module.ExportedFunction("tsrun_provide_module")
 	r.fnGetImports = r.module.ExportedFunction("tsrun_get_imports")
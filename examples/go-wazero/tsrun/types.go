@@ -98,6 +98,8 @@ type OrderResponse struct {
 	ID uint64
 	// Value is the result value (nil if error).
 	Value *Value
+	// Data, if non-nil, is converted with FromGo and used instead of Value.
+	Data any
 	// Error is the error message (empty if success).
 	Error string
 }
@@ -377,10 +377,11 @@ export async function init(wasmPath = 'tsrun.wasm') {
         _parsePendingOrders(ptr, count) {
             if (ptr === 0 || count === 0) return [];
 
-            // TsRunOrder: { id: u64, payload: i32 } = 12 bytes (8 + 4 on wasm32)
+            // TsRunOrder: { id: u64, payload: i32, payload_json: i32, payload_json_len: u32 }
+            // = 24 bytes on wasm32 (20 padded to the u64 alignment)
             const orders = [];
             for (let i = 0; i < count; i++) {
-                const view = getDataView(ptr + i * 12, 12);
+                const view = getDataView(ptr + i * 24, 24);
                 const id = view.getBigUint64(0, true);
                 const payloadPtr = view.getUint32(8, true);
 
@@ -428,11 +429,11 @@ export async function init(wasmPath = 'tsrun.wasm') {
          */
         fulfill_orders(responses) {
             // Build array of TsRunOrderResponse structs
-            // TsRunOrderResponse: { id: u64, value: i32, error: i32 } = 16 bytes
+            // TsRunOrderResponse: { id: u64, value: i32, error: i32, json: i32, json_len: u32 } = 24 bytes
             const count = responses.length;
             if (count === 0) return;
 
-            const arrayPtr = this[_wasm].exports.tsrun_alloc(count * 16);
+            const arrayPtr = this[_wasm].exports.tsrun_alloc(count * 24);
             if (arrayPtr === 0) throw new Error('Failed to allocate order responses');
 
             const allocatedErrors = [];
@@ -440,7 +441,7 @@ export async function init(wasmPath = 'tsrun.wasm') {
             try {
                 for (let i = 0; i < count; i++) {
                     const resp = responses[i];
-                    const offset = arrayPtr + i * 16;
+                    const offset = arrayPtr + i * 24;
 
                     // Get fresh DataView after any potential memory growth
                     const memory = new DataView(this[_wasm].exports.memory.buffer);
@@ -459,7 +460,12 @@ export async function init(wasmPath = 'tsrun.wasm') {
                         allocatedErrors.push(alloc);
                     }
                     // Get fresh DataView after potential memory growth from allocString
-                    new DataView(this[_wasm].exports.memory.buffer).setUint32(offset + 12, errorPtr, true);
+                    const view = new DataView(this[_wasm].exports.memory.buffer);
+                    view.setUint32(offset + 12, errorPtr, true);
+
+                    // No JSON body
+                    view.setUint32(offset + 16, 0, true);
+                    view.setUint32(offset + 20, 0, true);
                 }
 
                 // Allocate result struct for sret
@@ -480,7 +486,7 @@ export async function init(wasmPath = 'tsrun.wasm') {
                     this[_wasm].exports.tsrun_dealloc(resultPtr, 8);
                 }
             } finally {
-                this[_wasm].exports.tsrun_dealloc(arrayPtr, count * 16);
+                this[_wasm].exports.tsrun_dealloc(arrayPtr, count * 24);
                 for (const alloc of allocatedErrors) {
                     deallocString(alloc.ptr, alloc.len + 1);
                 }
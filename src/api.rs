@@ -215,8 +215,8 @@ pub fn get_index(arr: &JsValue, index: usize) -> Result<JsValue, JsError> {
     let value = {
         let borrowed = object.borrow();
         borrowed
-            .array_elements()
-            .and_then(|elements| elements.get(index).cloned())
+            .array_storage()
+            .and_then(|elements| elements.get(index))
     };
 
     Ok(value.unwrap_or(JsValue::Undefined))
@@ -244,7 +244,7 @@ pub fn get_elements(arr: &JsValue) -> Result<Vec<JsValue>, JsError> {
     let elements = {
         let borrowed = object.borrow();
         borrowed
-            .array_elements()
+            .array_storage()
             .map(|e| e.to_vec())
             .unwrap_or_default()
     };
@@ -305,13 +305,8 @@ pub fn set_index(arr: &JsValue, index: usize, value: JsValue) -> Result<(), JsEr
 
     match &mut borrowed.exotic {
         value::ExoticObject::Array { elements } => {
-            // Extend array if needed
-            while elements.len() <= index {
-                elements.push(JsValue::Undefined);
-            }
-            if let Some(elem) = elements.get_mut(index) {
-                *elem = value;
-            }
+            // Extends the array if needed
+            elements.set(index, value);
             let new_len = elements.len();
             drop(borrowed);
             object.borrow_mut().set_property(
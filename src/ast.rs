@@ -101,11 +101,22 @@ pub struct FunctionDeclaration {
     pub return_type: Option<Box<TypeAnnotation>>,
     pub type_parameters: Option<TypeParameters>,
     pub body: Rc<BlockStatement>,
+    /// Set when the parser skipped the body; `body` is then empty
+    pub skipped_body: Option<SkippedBody>,
     pub generator: bool,
     pub async_: bool,
     pub span: Span,
 }
 
+/// A function body left unparsed by lazy parsing, parsed on first call
+#[derive(Debug, Clone)]
+pub struct SkippedBody {
+    /// Full source text of the program the body came from
+    pub source: Rc<str>,
+    /// Span of the body, braces included
+    pub span: Span,
+}
+
 #[derive(Debug, Clone)]
 pub struct FunctionParam {
     pub pattern: Pattern,
@@ -576,6 +587,8 @@ pub struct FunctionExpression {
     pub return_type: Option<Box<TypeAnnotation>>,
     pub type_parameters: Option<TypeParameters>,
     pub body: Rc<BlockStatement>,
+    /// Set when the parser skipped the body; `body` is then empty
+    pub skipped_body: Option<SkippedBody>,
     pub generator: bool,
     pub async_: bool,
     pub span: Span,
@@ -587,6 +600,8 @@ pub struct ArrowFunctionExpression {
     pub return_type: Option<Box<TypeAnnotation>>,
     pub type_parameters: Option<TypeParameters>,
     pub body: Box<ArrowFunctionBody>,
+    /// Set when the parser skipped a block body; `body` is then empty
+    pub skipped_body: Option<SkippedBody>,
     pub async_: bool,
     pub span: Span,
 }
@@ -147,6 +147,12 @@ fn run() -> Result<(), Box<dyn std::error::Error>> {
     } else {
         interp.set_gc_threshold(100);
     }
+    // Incremental collection slice budget in microseconds
+    if let Ok(budget) = std::env::var("GC_BUDGET")
+        && let Ok(budget) = budget.parse::<u64>()
+    {
+        interp.set_gc_budget(budget);
+    }
 
     // Track provided modules by resolved path to avoid reloading
     let mut provided: FxHashMap<ModulePath, PathBuf> = FxHashMap::default();
@@ -302,7 +308,7 @@ fn run() -> Result<(), Box<dyn std::error::Error>> {
             .map_err(|e| format_error(&e.to_string(), &entry_file, &[]))?;
 
         loop {
-            match interp.step().map_err(|e| format!("{}", e))? {
+            match interp.run_steps(usize::MAX).map_err(|e| format!("{}", e))? {
                 StepResult::Continue => continue,
                 StepResult::Complete(runtime_value) => {
                     print_value(runtime_value.value());
@@ -585,10 +591,10 @@ fn value_to_json(value: &JsValue) -> Result<serde_json::Value, &'static str> {
                 }
 
                 // Check if it's an array
-                if let Some(elements) = borrowed.array_elements() {
+                if let Some(elements) = borrowed.array_storage() {
                     let mut arr = Vec::with_capacity(elements.len());
                     for elem in elements {
-                        arr.push(to_json_inner(elem, visited)?);
+                        arr.push(to_json_inner(&elem, visited)?);
                     }
                     visited.remove(obj);
                     return Ok(serde_json::Value::Array(arr));
@@ -4,9 +4,12 @@
 //! register allocation and jump patching support.
 
 use super::bytecode::{
-    BytecodeChunk, Constant, ConstantIndex, FunctionInfo, JumpTarget, Op, Register, SourceMapEntry,
+    BytecodeChunk, CacheIndex, Constant, ConstantIndex, FunctionInfo, JumpTarget, Op, Register,
+    SourceMapEntry,
 };
+use super::peephole;
 use crate::error::JsError;
+use crate::interpreter::inline_cache::InlineCaches;
 use crate::lexer::Span;
 use crate::prelude::*;
 use crate::value::JsString;
@@ -150,6 +153,9 @@ pub struct BytecodeBuilder {
 
     /// Source file path (for stack traces)
     source_file: Option<String>,
+
+    /// Number of inline cache slots handed out
+    cache_count: usize,
 }
 
 impl BytecodeBuilder {
@@ -165,6 +171,7 @@ impl BytecodeBuilder {
             current_span: None,
             function_info: None,
             source_file: None,
+            cache_count: 0,
         }
     }
 
@@ -298,6 +305,14 @@ impl BytecodeBuilder {
                 Op::PushTry { .. } => {}
                 // PushIterTry is patched via patch_iter_try_target()
                 Op::PushIterTry { .. } => {}
+                // Superinstructions are only formed by the peephole pass in
+                // finish(), after all jumps have been patched
+                Op::LtJumpIfFalse { .. }
+                | Op::LtEqJumpIfFalse { .. }
+                | Op::GtJumpIfFalse { .. }
+                | Op::GtEqJumpIfFalse { .. }
+                | Op::StrictEqJumpIfFalse { .. }
+                | Op::StrictNotEqJumpIfFalse { .. } => {}
 
                 // All other opcodes - explicitly listed to catch new jump ops at compile time
                 Op::LoadConst { .. }
@@ -337,6 +352,8 @@ impl BytecodeBuilder {
                 | Op::GetVar { .. }
                 | Op::TryGetVar { .. }
                 | Op::SetVar { .. }
+                | Op::ThrowConstAssignment { .. }
+                | Op::ThrowSyntaxError { .. }
                 | Op::DeclareVar { .. }
                 | Op::DeclareVarHoisted { .. }
                 | Op::GetGlobal { .. }
@@ -424,7 +441,10 @@ impl BytecodeBuilder {
                 | Op::ReExport { .. }
                 | Op::SetFunctionName { .. }
                 | Op::PopIterTry
-                | Op::IteratorClose { .. } => {}
+                | Op::IteratorClose { .. }
+                | Op::LoadIntAdd { .. }
+                | Op::LoadIntSub { .. }
+                | Op::GetPropertyConstCall { .. } => {}
             }
         }
     }
@@ -532,7 +552,8 @@ impl BytecodeBuilder {
     }
 
     /// Finish building and return the bytecode chunk
-    pub fn finish(self) -> BytecodeChunk {
+    pub fn finish(mut self) -> BytecodeChunk {
+        peephole::fuse_superinstructions(&mut self.code);
         BytecodeChunk {
             code: self.code,
             constants: self.constants,
@@ -540,9 +561,20 @@ impl BytecodeBuilder {
             register_count: self.registers.max_used(),
             function_info: self.function_info,
             source_file: self.source_file,
+            inline_caches: InlineCaches::new(self.cache_count),
+            lazy: None,
         }
     }
 
+    /// Allocate an inline cache slot for a property access site.
+    /// Sites past the `CacheIndex` range share the last slot, which only
+    /// costs them cache hits.
+    pub fn alloc_cache(&mut self) -> CacheIndex {
+        let index = self.cache_count.min(CacheIndex::MAX as usize) as CacheIndex;
+        self.cache_count = (self.cache_count + 1).min(CacheIndex::MAX as usize + 1);
+        index
+    }
+
     /// Allocate a register
     pub fn alloc_register(&mut self) -> Result<Register, JsError> {
         self.registers.alloc()
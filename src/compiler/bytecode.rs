@@ -3,9 +3,13 @@
 //! This module defines the bytecode format used by the VM.
 //! We use a register-based design with up to 256 virtual registers.
 
+use super::lazy::LazyFunction;
+use crate::error::JsError;
+use crate::interpreter::inline_cache::InlineCaches;
 use crate::lexer::Span;
 use crate::prelude::*;
-use crate::value::JsString;
+use crate::string_dict::StringDict;
+use crate::value::{CheapClone, JsString};
 
 /// Virtual register index (0-255)
 pub type Register = u8;
@@ -16,6 +20,9 @@ pub type ConstantIndex = u16;
 /// Jump target (instruction offset)
 pub type JumpTarget = u32;
 
+/// Inline cache slot of a property access site, local to its chunk
+pub type CacheIndex = u16;
+
 /// Bytecode instruction
 ///
 /// Each instruction operates on virtual registers. The register-based design
@@ -23,7 +30,10 @@ pub type JumpTarget = u32;
 ///
 /// Op is Copy because all variants contain only primitive types (u8, u16, u32, bool).
 /// This allows efficient pass-by-value without heap allocation or reference counting.
-#[derive(Debug, Clone, Copy)]
+///
+/// The serde derive is used by the bytecode serializer (`compiler::serialize`);
+/// variant order is part of the serialized format.
+#[derive(Debug, Clone, Copy, serde::Serialize, serde::Deserialize)]
 pub enum Op {
     // ═══════════════════════════════════════════════════════════════════════════════
     // Constants & Register Operations
@@ -271,6 +281,17 @@ pub enum Op {
     /// Store variable: env[name] = r[src]
     SetVar { name: ConstantIndex, src: Register },
 
+    /// Assignment to a const local held in a register: throws a TypeError
+    ThrowConstAssignment { name: ConstantIndex },
+
+    /// Body of a function compiled on first call whose source failed to
+    /// parse, as written to a bytecode blob: throws the deferred SyntaxError
+    ThrowSyntaxError {
+        message: ConstantIndex,
+        line: u32,
+        column: u32,
+    },
+
     /// Declare variable with let/const: env.define(name, r[init], mutable)
     DeclareVar {
         name: ConstantIndex,
@@ -308,10 +329,12 @@ pub enum Op {
     },
 
     /// Get property with constant key: r[dst] = r[obj].name
+    /// `cache` selects the site's inline cache in the chunk
     GetPropertyConst {
         dst: Register,
         obj: Register,
         key: ConstantIndex,
+        cache: CacheIndex,
     },
 
     /// Set property with computed key: r[obj][r[key]] = r[value]
@@ -322,10 +345,12 @@ pub enum Op {
     },
 
     /// Set property with constant key: r[obj].name = r[value]
+    /// `cache` selects the site's inline cache in the chunk
     SetPropertyConst {
         obj: Register,
         key: ConstantIndex,
         value: Register,
+        cache: CacheIndex,
     },
 
     /// Delete property: r[dst] = delete r[obj][r[key]]
@@ -842,6 +867,89 @@ pub enum Op {
         source_module: ConstantIndex,
         source_key: ConstantIndex,
     },
+
+    // ═══════════════════════════════════════════════════════════════════════════════
+    // Superinstructions
+    // ═══════════════════════════════════════════════════════════════════════════════
+    // Fused forms of common instruction pairs, written over the first instruction
+    // of the pair by `compiler::peephole`. The second instruction stays in place,
+    // so jump targets and source map offsets are unchanged; the fused op executes
+    // both and continues after the pair.
+    /// Lt + JumpIfFalse: r[dst] = r[left] < r[right]; jump to target if false
+    LtJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// LtEq + JumpIfFalse: r[dst] = r[left] <= r[right]; jump to target if false
+    LtEqJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// Gt + JumpIfFalse: r[dst] = r[left] > r[right]; jump to target if false
+    GtJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// GtEq + JumpIfFalse: r[dst] = r[left] >= r[right]; jump to target if false
+    GtEqJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// StrictEq + JumpIfFalse: r[dst] = r[left] === r[right]; jump to target if false
+    StrictEqJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// StrictNotEq + JumpIfFalse: r[dst] = r[left] !== r[right]; jump to target if false
+    StrictNotEqJumpIfFalse {
+        dst: Register,
+        left: Register,
+        right: Register,
+        target: JumpTarget,
+    },
+
+    /// LoadInt + Add: r[tmp] = value; r[dst] = r[left] + r[tmp]
+    LoadIntAdd {
+        dst: Register,
+        left: Register,
+        tmp: Register,
+        value: i32,
+    },
+
+    /// LoadInt + Sub: r[tmp] = value; r[dst] = r[left] - r[tmp]
+    LoadIntSub {
+        dst: Register,
+        left: Register,
+        tmp: Register,
+        value: i32,
+    },
+
+    /// GetPropertyConst + Call with the property as callee and its object as `this`:
+    /// r[callee] = r[obj].name; r[dst] = r[callee].call(r[obj], args...)
+    GetPropertyConstCall {
+        dst: Register,
+        obj: Register,
+        key: ConstantIndex,
+        cache: CacheIndex,
+        callee: Register,
+        args_start: Register,
+        argc: u8,
+    },
 }
 
 /// A compiled chunk of bytecode
@@ -864,6 +972,13 @@ pub struct BytecodeChunk {
 
     /// Source file path (for stack traces)
     pub source_file: Option<String>,
+
+    /// Inline caches for the constant-key property sites in `code`
+    pub(crate) inline_caches: InlineCaches,
+
+    /// Set on the stub of a function compiled on first call; the stub holds
+    /// only `function_info`
+    pub lazy: Option<Rc<LazyFunction>>,
 }
 
 /// Source map entry for debugging
@@ -945,9 +1060,36 @@ impl BytecodeChunk {
             register_count: 0,
             function_info: None,
             source_file: None,
+            inline_caches: InlineCaches::default(),
+            lazy: None,
+        }
+    }
+
+    /// The chunk to run: this one, or for a lazy stub its compiled body,
+    /// compiled on first use
+    pub fn compiled(
+        self: &Rc<Self>,
+        string_dict: &mut StringDict,
+    ) -> Result<Rc<BytecodeChunk>, JsError> {
+        match &self.lazy {
+            Some(lazy) => lazy.compile(string_dict),
+            None => Ok(self.cheap_clone()),
         }
     }
 
+    /// Number of inline cache slots referenced by `code`
+    pub fn cache_site_count(code: &[Op]) -> usize {
+        code.iter()
+            .filter_map(|op| match op {
+                Op::GetPropertyConst { cache, .. }
+                | Op::SetPropertyConst { cache, .. }
+                | Op::GetPropertyConstCall { cache, .. } => Some(*cache as usize + 1),
+                _ => None,
+            })
+            .max()
+            .unwrap_or(0)
+    }
+
     /// Get the instruction at the given offset
     pub fn get(&self, offset: usize) -> Option<&Op> {
         self.code.get(offset)
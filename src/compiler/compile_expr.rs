@@ -4,6 +4,7 @@
 
 use super::Compiler;
 use super::bytecode::{ConstantIndex, Op, Register};
+use super::lazy::LazyBody;
 use crate::ast::{
     Argument, ArrayElement, AssignmentOp, AssignmentTarget, BinaryOp, Expression, LiteralValue,
     LogicalOp, MemberProperty, ObjectProperty, ObjectPropertyKey, PropertyKind, UnaryOp, UpdateOp,
@@ -38,12 +39,7 @@ impl Compiler {
                     return Ok(());
                 }
 
-                let name_idx = self.builder.add_string(id.name.cheap_clone())?;
-                self.builder.emit(Op::GetVar {
-                    dst,
-                    name: name_idx,
-                });
-                Ok(())
+                self.emit_load_var(&id.name, dst)
             }
 
             Expression::This(_) => {
@@ -347,18 +343,22 @@ impl Compiler {
         match &prop.key {
             ObjectPropertyKey::Identifier(id) => {
                 let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::SetPropertyConst {
                     obj,
                     key: key_idx,
                     value: value_reg,
+                    cache,
                 });
             }
             ObjectPropertyKey::String(s) => {
                 let key_idx = self.builder.add_string(s.value.cheap_clone())?;
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::SetPropertyConst {
                     obj,
                     key: key_idx,
                     value: value_reg,
+                    cache,
                 });
             }
             ObjectPropertyKey::Number(lit) => {
@@ -521,7 +521,12 @@ impl Compiler {
                 // typeof needs special handling for identifiers:
                 // typeof undeclaredVar should return "undefined", not throw ReferenceError
                 let src = self.builder.alloc_register()?;
-                if let Expression::Identifier(id) = &*unary.argument {
+                if let Expression::Identifier(id) = &*unary.argument
+                    && self.resolve_local(&id.name).is_some()
+                {
+                    // Locals are always declared
+                    self.emit_load_var(&id.name, src)?;
+                } else if let Expression::Identifier(id) = &*unary.argument {
                     // Use TryGetVar to get undefined for undeclared variables
                     let name_idx = self.builder.add_string(id.name.cheap_clone())?;
                     self.builder.emit(Op::TryGetVar {
@@ -771,35 +776,13 @@ impl Compiler {
         right: &Expression,
         dst: Register,
     ) -> Result<(), JsError> {
-        let name_idx = self.builder.add_string(id.name.cheap_clone())?;
-
-        // Check if this variable is redirected to a register (for for-loop updates)
-        let redirect_reg = self.get_loop_var_redirect(&id.name);
-
         if *op == AssignmentOp::Assign {
             // Simple assignment
             self.compile_expression(right, dst)?;
-
-            if let Some(reg) = redirect_reg {
-                // Redirect: write to register instead of environment
-                self.builder.emit(Op::Move { dst: reg, src: dst });
-            } else {
-                self.builder.emit(Op::SetVar {
-                    name: name_idx,
-                    src: dst,
-                });
-            }
         } else {
             // Compound assignment
-            // Load current value (from environment or redirect register)
-            if let Some(reg) = redirect_reg {
-                self.builder.emit(Op::Move { dst, src: reg });
-            } else {
-                self.builder.emit(Op::GetVar {
-                    dst,
-                    name: name_idx,
-                });
-            }
+            // Load current value (from a register-backed local or the environment)
+            self.emit_load_var(&id.name, dst)?;
 
             // Handle short-circuit operators specially
             match op {
@@ -834,19 +817,9 @@ impl Compiler {
                     self.builder.free_register(right_reg);
                 }
             }
-
-            if let Some(reg) = redirect_reg {
-                // Redirect: write to register instead of environment
-                self.builder.emit(Op::Move { dst: reg, src: dst });
-            } else {
-                self.builder.emit(Op::SetVar {
-                    name: name_idx,
-                    src: dst,
-                });
-            }
         }
 
-        Ok(())
+        self.emit_store_var(&id.name, dst)
     }
 
     /// Compile assignment to a member expression
@@ -1062,20 +1035,8 @@ impl Compiler {
     ) -> Result<(), JsError> {
         match update.argument.as_ref() {
             Expression::Identifier(id) => {
-                let name_idx = self.builder.add_string(id.name.cheap_clone())?;
-
-                // Check if this variable is redirected to a register (for for-loop updates)
-                let redirect_reg = self.get_loop_var_redirect(&id.name);
-
-                // Load current value (from environment or redirect register)
-                if let Some(reg) = redirect_reg {
-                    self.builder.emit(Op::Move { dst, src: reg });
-                } else {
-                    self.builder.emit(Op::GetVar {
-                        dst,
-                        name: name_idx,
-                    });
-                }
+                // Load current value (from a register-backed local or the environment)
+                self.emit_load_var(&id.name, dst)?;
 
                 if !update.prefix {
                     // Postfix: save original value
@@ -1104,14 +1065,7 @@ impl Compiler {
                     }
 
                     // Store updated value (to register or environment)
-                    if let Some(reg) = redirect_reg {
-                        self.builder.emit(Op::Move { dst: reg, src: dst });
-                    } else {
-                        self.builder.emit(Op::SetVar {
-                            name: name_idx,
-                            src: dst,
-                        });
-                    }
+                    self.emit_store_var(&id.name, dst)?;
 
                     // Return original value
                     self.builder.emit(Op::Move { dst, src: original });
@@ -1138,14 +1092,7 @@ impl Compiler {
                     }
 
                     // Store and return updated value (to register or environment)
-                    if let Some(reg) = redirect_reg {
-                        self.builder.emit(Op::Move { dst: reg, src: dst });
-                    } else {
-                        self.builder.emit(Op::SetVar {
-                            name: name_idx,
-                            src: dst,
-                        });
-                    }
+                    self.emit_store_var(&id.name, dst)?;
 
                     self.builder.free_register(one);
                 }
@@ -1281,10 +1228,12 @@ impl Compiler {
         match &member.property {
             MemberProperty::Identifier(id) => {
                 let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::GetPropertyConst {
                     dst,
                     obj: obj_reg,
                     key: key_idx,
+                    cache,
                 });
             }
             MemberProperty::Expression(expr) => {
@@ -1425,10 +1374,12 @@ impl Compiler {
         match &member.property {
             MemberProperty::Identifier(id) => {
                 let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::GetPropertyConst {
                     dst,
                     obj: obj_reg,
                     key: key_idx,
+                    cache,
                 });
             }
             MemberProperty::Expression(expr) => {
@@ -1507,10 +1458,12 @@ impl Compiler {
             match &member.property {
                 MemberProperty::Identifier(id) => {
                     let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::GetPropertyConst {
                         dst: method_reg,
                         obj: obj_reg,
                         key: key_idx,
+                        cache,
                     });
                 }
                 MemberProperty::Expression(expr) => {
@@ -1593,10 +1546,12 @@ impl Compiler {
             match &member.property {
                 MemberProperty::Identifier(id) => {
                     let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::GetPropertyConst {
                         dst: method_reg,
                         obj: obj_reg,
                         key: key_idx,
+                        cache,
                     });
                 }
                 MemberProperty::Expression(expr) => {
@@ -1810,10 +1765,12 @@ impl Compiler {
                     // Get method from object (may throw if obj is undefined/null)
                     let method_key = self.builder.add_string(method_name.name.cheap_clone())?;
                     let method_reg = self.builder.alloc_register()?;
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::GetPropertyConst {
                         dst: method_reg,
                         obj: obj_reg,
                         key: method_key,
+                        cache,
                     });
 
                     // Now compile arguments (only after callee is evaluated)
@@ -1943,10 +1900,12 @@ impl Compiler {
                 match &member.property {
                     MemberProperty::Identifier(id) => {
                         let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                        let cache = self.builder.alloc_cache();
                         self.builder.emit(Op::GetPropertyConst {
                             dst: method_reg,
                             obj: obj_reg,
                             key: key_idx,
+                            cache,
                         });
                     }
                     MemberProperty::Expression(expr) => {
@@ -1996,10 +1955,12 @@ impl Compiler {
                 match &member.property {
                     MemberProperty::Identifier(id) => {
                         let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                        let cache = self.builder.alloc_cache();
                         self.builder.emit(Op::GetPropertyConst {
                             dst: method_reg,
                             obj: obj_reg,
                             key: key_idx,
+                            cache,
                         });
                     }
                     MemberProperty::Expression(expr) => {
@@ -2344,10 +2305,12 @@ impl Compiler {
             match &member.property {
                 MemberProperty::Identifier(id) => {
                     let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::GetPropertyConst {
                         dst: tag_reg,
                         obj: obj_reg,
                         key: key_idx,
+                        cache,
                     });
                 }
                 MemberProperty::Expression(expr) => {
@@ -2446,10 +2409,9 @@ impl Compiler {
         // Use provided name, or extract from function id
         let func_name = name.or_else(|| func.id.as_ref().map(|id| id.name.cheap_clone()));
 
-        // Use the existing compile_function_body from compile_stmt
-        let chunk = self.compile_function_body(
+        let chunk = self.function_chunk(
             &func.params,
-            &func.body.body,
+            LazyBody::block(&func.body, func.skipped_body.as_ref()),
             func_name,
             func.generator,
             func.async_,
@@ -2493,18 +2455,22 @@ impl Compiler {
         name: Option<JsString>,
     ) -> Result<(), JsError> {
         // Compile the arrow function body
-        let chunk = match arrow.body.as_ref() {
-            crate::ast::ArrowFunctionBody::Block(block) => self.compile_function_body(
-                &arrow.params,
-                &block.body,
-                name.clone(),
-                false,
-                arrow.async_,
-                true, // is_arrow = true
-            )?,
-            crate::ast::ArrowFunctionBody::Expression(expr) => self
-                .compile_arrow_expression_body_with_name(&arrow.params, expr, arrow.async_, name)?,
+        let body = match arrow.body.as_ref() {
+            crate::ast::ArrowFunctionBody::Block(block) => {
+                LazyBody::block(block, arrow.skipped_body.as_ref())
+            }
+            crate::ast::ArrowFunctionBody::Expression(expr) => {
+                LazyBody::Expression(expr.cheap_clone())
+            }
         };
+        let chunk = self.function_chunk(
+            &arrow.params,
+            body,
+            name,
+            false,
+            arrow.async_,
+            true, // is_arrow = true
+        )?;
 
         // Add chunk to constants
         let chunk_idx = self
@@ -2528,6 +2494,7 @@ impl Compiler {
 
         // Create a new compiler for the function body
         let mut func_compiler = super::Compiler::new();
+        func_compiler.lazy_functions = self.lazy_functions;
 
         // Reserve registers for parameters - they are passed in registers 0, 1, 2...
         // We must reserve these before any other register allocation
@@ -2537,6 +2504,21 @@ impl Compiler {
                 .reserve_registers(params.len() as u8)?;
         }
 
+        // Resolve bindings that can live in registers
+        let mut destructured = Vec::new();
+        for param in params {
+            if matches!(
+                param.pattern,
+                crate::ast::Pattern::Object(_) | crate::ast::Pattern::Array(_)
+            ) {
+                Self::collect_pattern_names(&param.pattern, &mut destructured);
+            }
+        }
+        func_compiler.begin_function_locals(
+            super::scope::LocalAnalysis::for_expression_body(params, expr),
+            &destructured,
+        )?;
+
         // Compile parameter declarations
         let mut param_names = Vec::with_capacity(params.len());
         let mut rest_param = None;
@@ -2545,28 +2527,13 @@ impl Compiler {
             match &param.pattern {
                 crate::ast::Pattern::Identifier(id) => {
                     param_names.push(id.name.cheap_clone());
-
-                    // Load argument from register and declare variable
-                    let arg_reg = idx as u8;
-                    let name_idx = func_compiler.builder.add_string(id.name.cheap_clone())?;
-                    func_compiler.builder.emit(Op::DeclareVar {
-                        name: name_idx,
-                        init: arg_reg,
-                        mutable: true,
-                    });
+                    func_compiler.bind_parameter(&id.name, idx as u8)?;
                 }
                 crate::ast::Pattern::Rest(rest) => {
                     rest_param = Some(idx);
                     if let crate::ast::Pattern::Identifier(id) = &*rest.argument {
                         param_names.push(id.name.cheap_clone());
-
-                        let arg_reg = idx as u8;
-                        let name_idx = func_compiler.builder.add_string(id.name.cheap_clone())?;
-                        func_compiler.builder.emit(Op::DeclareVar {
-                            name: name_idx,
-                            init: arg_reg,
-                            mutable: true,
-                        });
+                        func_compiler.bind_parameter(&id.name, idx as u8)?;
                     }
                 }
                 crate::ast::Pattern::Object(_) | crate::ast::Pattern::Array(_) => {
@@ -2591,7 +2558,8 @@ impl Compiler {
 
         // Count bindings for environment pre-sizing
         // Expression-bodied arrows have no statement body, just params
-        let binding_count = super::hoist::count_function_bindings(params, &[], true);
+        let binding_count = super::hoist::count_function_bindings(params, &[], true)
+            .saturating_sub(func_compiler.function_local_count());
 
         // Build the chunk with function info
         let mut chunk = func_compiler.builder.finish();
@@ -2612,7 +2580,7 @@ impl Compiler {
     }
 
     /// Compile an expression-bodied arrow function with an optional inferred name
-    fn compile_arrow_expression_body_with_name(
+    pub(super) fn compile_arrow_expression_body_with_name(
         &mut self,
         params: &[crate::ast::FunctionParam],
         expr: &crate::ast::Expression,
@@ -2714,10 +2682,12 @@ impl Compiler {
     ) -> Result<(), JsError> {
         match key_info {
             MemberKeyInfo::Const(idx) => {
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::GetPropertyConst {
                     dst,
                     obj,
                     key: *idx,
+                    cache,
                 });
             }
             MemberKeyInfo::Computed(reg) => {
@@ -2751,10 +2721,12 @@ impl Compiler {
     ) -> Result<(), JsError> {
         match key_info {
             MemberKeyInfo::Const(idx) => {
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::SetPropertyConst {
                     obj,
                     key: *idx,
                     value,
+                    cache,
                 });
             }
             MemberKeyInfo::Computed(reg) => {
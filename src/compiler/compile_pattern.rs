@@ -21,27 +21,19 @@ impl Compiler {
     ) -> Result<(), JsError> {
         match pattern {
             Pattern::Identifier(id) => {
-                let name_idx = self.builder.add_string(id.name.cheap_clone())?;
-                if is_var {
-                    // For var declarations, check if already hoisted
-                    if self.is_hoisted(&id.name) {
-                        // Already hoisted - just assign
-                        self.builder.emit(Op::SetVar {
-                            name: name_idx,
-                            src: value_reg,
-                        });
-                    } else {
-                        // Not hoisted yet (e.g., inside eval or dynamic scope)
-                        self.builder.emit(Op::DeclareVarHoisted {
-                            name: name_idx,
-                            init: value_reg,
-                        });
-                    }
+                if !is_var {
+                    return self.declare_lexical(&id.name, value_reg, mutable);
+                }
+                // For var declarations, check if already hoisted (or kept in a register)
+                if self.is_hoisted(&id.name) || self.resolve_local(&id.name).is_some() {
+                    // Already hoisted - just assign
+                    self.emit_store_var(&id.name, value_reg)?;
                 } else {
-                    self.builder.emit(Op::DeclareVar {
+                    // Not hoisted yet (e.g., inside eval or dynamic scope)
+                    let name_idx = self.builder.add_string(id.name.cheap_clone())?;
+                    self.builder.emit(Op::DeclareVarHoisted {
                         name: name_idx,
                         init: value_reg,
-                        mutable,
                     });
                 }
                 Ok(())
@@ -163,18 +155,22 @@ impl Compiler {
                     match key {
                         ObjectPropertyKey::Identifier(id) => {
                             let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                            let cache = self.builder.alloc_cache();
                             self.builder.emit(Op::GetPropertyConst {
                                 dst: prop_value,
                                 obj: value_reg,
                                 key: key_idx,
+                                cache,
                             });
                         }
                         ObjectPropertyKey::String(s) => {
                             let key_idx = self.builder.add_string(s.value.cheap_clone())?;
+                            let cache = self.builder.alloc_cache();
                             self.builder.emit(Op::GetPropertyConst {
                                 dst: prop_value,
                                 obj: value_reg,
                                 key: key_idx,
+                                cache,
                             });
                         }
                         ObjectPropertyKey::Computed(expr) => {
@@ -323,14 +319,7 @@ impl Compiler {
         value_reg: Register,
     ) -> Result<(), JsError> {
         match pattern {
-            Pattern::Identifier(id) => {
-                let name_idx = self.builder.add_string(id.name.cheap_clone())?;
-                self.builder.emit(Op::SetVar {
-                    name: name_idx,
-                    src: value_reg,
-                });
-                Ok(())
-            }
+            Pattern::Identifier(id) => self.emit_store_var(&id.name, value_reg),
 
             Pattern::Object(obj_pat) => self.compile_object_pattern_assignment(obj_pat, value_reg),
 
@@ -429,18 +418,22 @@ impl Compiler {
                     match key {
                         ObjectPropertyKey::Identifier(id) => {
                             let key_idx = self.builder.add_string(id.name.cheap_clone())?;
+                            let cache = self.builder.alloc_cache();
                             self.builder.emit(Op::GetPropertyConst {
                                 dst: prop_value,
                                 obj: value_reg,
                                 key: key_idx,
+                                cache,
                             });
                         }
                         ObjectPropertyKey::String(s) => {
                             let key_idx = self.builder.add_string(s.value.cheap_clone())?;
+                            let cache = self.builder.alloc_cache();
                             self.builder.emit(Op::GetPropertyConst {
                                 dst: prop_value,
                                 obj: value_reg,
                                 key: key_idx,
+                                cache,
                             });
                         }
                         ObjectPropertyKey::Computed(expr) => {
@@ -4,6 +4,7 @@
 
 use super::Compiler;
 use super::bytecode::{ConstantIndex, Op, Register};
+use super::lazy::LazyBody;
 use crate::ast::{
     BlockStatement, BreakStatement, ClassConstructor, ClassDeclaration, ClassMember, ClassMethod,
     ClassProperty, ContinueStatement, DoWhileStatement, ExportDeclaration, ForInOfLeft,
@@ -138,8 +139,9 @@ impl Compiler {
     fn compile_block(&mut self, block: &BlockStatement) -> Result<(), JsError> {
         self.builder.set_span(block.span);
 
-        // Push a new scope
-        self.builder.emit(Op::PushScope);
+        // Push a new scope (no runtime environment if every binding is a local)
+        let (lexical, has_env_declarations) = super::scope::lexical_declarations(&block.body);
+        self.enter_scope(&lexical, has_env_declarations)?;
 
         if block.body.is_empty() && self.track_completion {
             // Empty block has completion value undefined
@@ -152,7 +154,7 @@ impl Compiler {
         }
 
         // Pop scope
-        self.builder.emit(Op::PopScope);
+        self.exit_scope();
 
         Ok(())
     }
@@ -267,12 +269,19 @@ impl Compiler {
         // Check if this is a for loop with let/const declaration (needs per-iteration binding)
         let per_iteration_vars = self.get_per_iteration_vars(&for_stmt.init);
 
-        if per_iteration_vars.is_empty() {
-            // No let/const vars: use simple compilation
-            self.compile_for_simple(for_stmt)
+        if per_iteration_vars
+            .iter()
+            .all(|name| self.is_local_name(name))
+        {
+            // No let/const vars, or only locals that no closure can observe:
+            // use simple compilation
+            self.compile_for_simple(for_stmt, &per_iteration_vars)
         } else {
             // Has let/const vars: use per-iteration binding semantics
-            self.compile_for_per_iteration(for_stmt, &per_iteration_vars)
+            self.enter_env_shadow(&per_iteration_vars);
+            let result = self.compile_for_per_iteration(for_stmt, &per_iteration_vars);
+            self.exit_scope();
+            result
         }
     }
 
@@ -292,7 +301,7 @@ impl Compiler {
     }
 
     /// Collect variable names from a pattern
-    fn collect_pattern_names(pattern: &Pattern, names: &mut Vec<JsString>) {
+    pub(super) fn collect_pattern_names(pattern: &Pattern, names: &mut Vec<JsString>) {
         match pattern {
             Pattern::Identifier(id) => names.push(id.name.cheap_clone()),
             Pattern::Object(obj) => {
@@ -321,10 +330,15 @@ impl Compiler {
         }
     }
 
-    /// Compile for loop without per-iteration bindings (var or expression init)
-    fn compile_for_simple(&mut self, for_stmt: &ForStatement) -> Result<(), JsError> {
+    /// Compile for loop without per-iteration bindings (var or expression init,
+    /// or let/const locals declared in `lexical`)
+    fn compile_for_simple(
+        &mut self,
+        for_stmt: &ForStatement,
+        lexical: &[JsString],
+    ) -> Result<(), JsError> {
         // Push scope for loop variable
-        self.builder.emit(Op::PushScope);
+        self.enter_scope(lexical, false)?;
 
         // Compile init
         if let Some(init) = &for_stmt.init {
@@ -383,7 +397,7 @@ impl Compiler {
         self.pop_loop();
 
         // Pop scope
-        self.builder.emit(Op::PopScope);
+        self.exit_scope();
 
         Ok(())
     }
@@ -520,7 +534,8 @@ impl Compiler {
         self.builder.set_span(for_in.span);
 
         // Push scope
-        self.builder.emit(Op::PushScope);
+        let lexical = Self::for_in_of_lexical(&for_in.left);
+        self.enter_scope(&lexical, false)?;
 
         // Compile the right side (object to iterate)
         let obj_reg = self.builder.alloc_register()?;
@@ -585,7 +600,7 @@ impl Compiler {
         self.builder.free_register(obj_reg);
 
         // Pop scope
-        self.builder.emit(Op::PopScope);
+        self.exit_scope();
 
         Ok(())
     }
@@ -595,7 +610,8 @@ impl Compiler {
         self.builder.set_span(for_of.span);
 
         // Push scope
-        self.builder.emit(Op::PushScope);
+        let lexical = Self::for_in_of_lexical(&for_of.left);
+        self.enter_scope(&lexical, false)?;
 
         // Compile the right side (iterable)
         let obj_reg = self.builder.alloc_register()?;
@@ -707,11 +723,20 @@ impl Compiler {
         self.builder.free_register(obj_reg);
 
         // Pop scope
-        self.builder.emit(Op::PopScope);
+        self.exit_scope();
 
         Ok(())
     }
 
+    /// Let/const names declared by the left side of a for-in/for-of
+    fn for_in_of_lexical(left: &ForInOfLeft) -> Vec<JsString> {
+        let mut names = Vec::new();
+        if let ForInOfLeft::Variable(decl) = left {
+            super::scope::lexical_names(decl, &mut names);
+        }
+        names
+    }
+
     /// Compile the left side of a for-in/for-of
     fn compile_for_in_of_left(
         &mut self,
@@ -746,6 +771,13 @@ impl Compiler {
         // Push loop context for break (switch uses the same break mechanism)
         self.push_loop(None);
 
+        // Case clauses share one scope for their let/const declarations
+        let mut lexical = Vec::new();
+        for case in switch_stmt.cases.iter() {
+            lexical.extend(super::scope::lexical_declarations(&case.consequent).0);
+        }
+        self.enter_local_scope(&lexical)?;
+
         // Collect case targets
         let mut case_jumps: Vec<super::JumpPlaceholder> = Vec::new();
         let mut default_jump: Option<super::JumpPlaceholder> = None;
@@ -809,6 +841,8 @@ impl Compiler {
             self.builder.patch_jump(jump);
         }
 
+        self.exit_scope();
+
         // Pop loop context (patches break jumps)
         self.pop_loop();
 
@@ -910,7 +944,12 @@ impl Compiler {
             self.builder.set_span(handler.span);
 
             // Push scope for catch variable
-            self.builder.emit(Op::PushScope);
+            let (mut lexical, has_env_declarations) =
+                super::scope::lexical_declarations(&handler.body.body);
+            if let Some(param) = &handler.param {
+                Self::collect_pattern_names(param, &mut lexical);
+            }
+            self.enter_scope(&lexical, has_env_declarations)?;
 
             // Bind exception to parameter
             if let Some(param) = &handler.param {
@@ -931,7 +970,7 @@ impl Compiler {
             }
 
             // Pop scope
-            self.builder.emit(Op::PopScope);
+            self.exit_scope();
         }
 
         // Jump to finally (if exists) or end
@@ -943,9 +982,11 @@ impl Compiler {
             self.builder.set_span(finalizer.span);
 
             // Compile finally block
+            self.enter_local_scope(&super::scope::lexical_declarations(&finalizer.body).0)?;
             for stmt in finalizer.body.iter() {
                 self.compile_statement_impl(stmt)?;
             }
+            self.exit_scope();
 
             // FinallyEnd completes any pending return/throw
             self.builder.emit(Op::FinallyEnd);
@@ -1016,9 +1057,9 @@ impl Compiler {
         let name = func.id.as_ref().map(|id| id.name.cheap_clone());
 
         // Compile the function body to a nested chunk
-        let chunk = self.compile_function_body(
+        let chunk = self.function_chunk(
             &func.params,
-            &func.body.body,
+            LazyBody::block(&func.body, func.skipped_body.as_ref()),
             name.clone(),
             func.generator,
             func.async_,
@@ -1080,6 +1121,7 @@ impl Compiler {
 
         // Copy class context so private members can be accessed inside nested functions
         func_compiler.class_context_stack = self.class_context_stack.clone();
+        func_compiler.lazy_functions = self.lazy_functions;
 
         // Reserve registers for parameters - they are passed in registers 0, 1, 2...
         // We must reserve these before any other register allocation
@@ -1089,8 +1131,18 @@ impl Compiler {
                 .reserve_registers(params.len() as u8)?;
         }
 
+        // Resolve bindings that can live in registers. Simple parameters stay in
+        // their argument registers; let/const and destructured parameters get
+        // registers reserved up front.
+        let (mut lexical, _) = super::scope::lexical_declarations(body);
+        collect_destructured_param_names(params, &mut lexical);
+        func_compiler.begin_function_locals(
+            super::scope::LocalAnalysis::for_function(params, body),
+            &lexical,
+        )?;
+
         // Compile parameter declarations
-        // Parameters will be passed via registers and need to be bound to the environment
+        // Parameters are passed via registers and bound as locals or in the environment
         let mut param_names = Vec::with_capacity(params.len());
         let mut rest_param = None;
 
@@ -1100,27 +1152,13 @@ impl Compiler {
             match &param.pattern {
                 crate::ast::Pattern::Identifier(id) => {
                     param_names.push(id.name.cheap_clone());
-
-                    // Load argument from register and declare variable
-                    let name_idx = func_compiler.builder.add_string(id.name.cheap_clone())?;
-                    func_compiler.builder.emit(Op::DeclareVar {
-                        name: name_idx,
-                        init: arg_reg,
-                        mutable: true,
-                    });
+                    func_compiler.bind_parameter(&id.name, arg_reg)?;
                 }
                 crate::ast::Pattern::Rest(rest) => {
                     rest_param = Some(idx);
                     if let crate::ast::Pattern::Identifier(id) = &*rest.argument {
                         param_names.push(id.name.cheap_clone());
-
-                        // For rest params, we'll need special handling (not fully implemented)
-                        let name_idx = func_compiler.builder.add_string(id.name.cheap_clone())?;
-                        func_compiler.builder.emit(Op::DeclareVar {
-                            name: name_idx,
-                            init: arg_reg,
-                            mutable: true,
-                        });
+                        func_compiler.bind_parameter(&id.name, arg_reg)?;
                     }
                 }
                 crate::ast::Pattern::Object(_) | crate::ast::Pattern::Array(_) => {
@@ -1198,8 +1236,9 @@ impl Compiler {
             value: undefined_reg,
         });
 
-        // Count bindings for environment pre-sizing
-        let binding_count = super::hoist::count_function_bindings(params, body, is_arrow);
+        // Count bindings for environment pre-sizing (locals never reach the environment)
+        let binding_count = super::hoist::count_function_bindings(params, body, is_arrow)
+            .saturating_sub(func_compiler.function_local_count());
 
         // Build the chunk with function info
         let mut chunk = func_compiler.builder.finish();
@@ -1649,9 +1688,9 @@ impl Compiler {
 
         // Compile method body
         let func = &method.value;
-        let method_chunk = self.compile_function_body(
+        let method_chunk = self.function_chunk(
             &func.params,
-            &func.body.body,
+            LazyBody::block(&func.body, func.skipped_body.as_ref()),
             method_name,
             func.generator,
             func.async_,
@@ -2014,6 +2053,7 @@ impl Compiler {
 
         // Copy the class context so private field access works inside the constructor
         func_compiler.class_context_stack = self.class_context_stack.clone();
+        func_compiler.lazy_functions = self.lazy_functions;
 
         // Reserve registers for parameters
         if !ctor.params.is_empty() {
@@ -2119,10 +2159,12 @@ impl Compiler {
             let this_reg = func_compiler.builder.alloc_register()?;
             func_compiler.builder.emit(Op::LoadThis { dst: this_reg });
             let prop_idx = func_compiler.builder.add_string(prop_name.cheap_clone())?;
+            let cache = func_compiler.builder.alloc_cache();
             func_compiler.builder.emit(Op::SetPropertyConst {
                 obj: this_reg,
                 key: prop_idx,
                 value: *value_reg,
+                cache,
             });
             func_compiler.builder.free_register(this_reg);
             // Free registers allocated for default values after they've been used
@@ -2198,6 +2240,7 @@ impl Compiler {
 
         // Copy the class context so private field access works inside the constructor
         func_compiler.class_context_stack = self.class_context_stack.clone();
+        func_compiler.lazy_functions = self.lazy_functions;
 
         // For derived classes, call super(...args) first to forward all arguments
         if has_super {
@@ -2302,10 +2345,12 @@ impl Compiler {
         }
 
         // Set property on this
+        let cache = self.builder.alloc_cache();
         self.builder.emit(Op::SetPropertyConst {
             obj: this_reg,
             key: name_idx,
             value: value_reg,
+            cache,
         });
 
         self.builder.free_register(value_reg);
@@ -2354,10 +2399,12 @@ impl Compiler {
         }
 
         // Set property on class constructor
+        let cache = self.builder.alloc_cache();
         self.builder.emit(Op::SetPropertyConst {
             obj: class_reg,
             key: name_idx,
             value: value_reg,
+            cache,
         });
 
         self.builder.free_register(value_reg);
@@ -2504,9 +2551,9 @@ impl Compiler {
 
         // Compile method body
         let func = &method.value;
-        let method_chunk = self.compile_function_body(
+        let method_chunk = self.function_chunk(
             &func.params,
-            &func.body.body,
+            LazyBody::block(&func.body, func.skipped_body.as_ref()),
             Some(method_name),
             func.generator,
             func.async_,
@@ -2689,10 +2736,12 @@ impl Compiler {
             prior_members.push(member_name.cheap_clone());
 
             // Set forward mapping: EnumName.MemberName = value
+            let cache = self.builder.alloc_cache();
             self.builder.emit(Op::SetPropertyConst {
                 obj: enum_obj,
                 key: name_idx,
                 value: value_reg,
+                cache,
             });
 
             // Set reverse mapping for numeric values: EnumName[value] = MemberName
@@ -2821,10 +2870,12 @@ impl Compiler {
                             dst: value_reg,
                             name: name_idx,
                         });
+                        let cache = self.builder.alloc_cache();
                         self.builder.emit(Op::SetPropertyConst {
                             obj: ns_obj,
                             key: name_idx,
                             value: value_reg,
+                            cache,
                         });
                         self.builder.free_register(value_reg);
                     }
@@ -2838,10 +2889,12 @@ impl Compiler {
                         dst: value_reg,
                         name: name_idx,
                     });
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::SetPropertyConst {
                         obj: ns_obj,
                         key: name_idx,
                         value: value_reg,
+                        cache,
                     });
                     self.builder.free_register(value_reg);
                 }
@@ -2854,10 +2907,12 @@ impl Compiler {
                         dst: value_reg,
                         name: name_idx,
                     });
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::SetPropertyConst {
                         obj: ns_obj,
                         key: name_idx,
                         value: value_reg,
+                        cache,
                     });
                     self.builder.free_register(value_reg);
                 }
@@ -2869,10 +2924,12 @@ impl Compiler {
                     dst: value_reg,
                     name: name_idx,
                 });
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::SetPropertyConst {
                     obj: ns_obj,
                     key: name_idx,
                     value: value_reg,
+                    cache,
                 });
                 self.builder.free_register(value_reg);
             }
@@ -2884,10 +2941,12 @@ impl Compiler {
                     dst: value_reg,
                     name: name_idx,
                 });
+                let cache = self.builder.alloc_cache();
                 self.builder.emit(Op::SetPropertyConst {
                     obj: ns_obj,
                     key: name_idx,
                     value: value_reg,
+                    cache,
                 });
                 self.builder.free_register(value_reg);
             }
@@ -2913,10 +2972,12 @@ impl Compiler {
                 if prior_members.iter().any(|m| m.as_str() == id.name.as_str()) {
                     // This is a reference to a prior member - load from enum object
                     let name_idx = self.builder.add_string(id.name.cheap_clone())?;
+                    let cache = self.builder.alloc_cache();
                     self.builder.emit(Op::GetPropertyConst {
                         dst,
                         obj: enum_obj,
                         key: name_idx,
+                        cache,
                     });
                     Ok(())
                 } else {
@@ -3259,6 +3320,7 @@ impl Compiler {
             id: func.id.clone(),
             params: func.params.clone(),
             body: func.body.clone(),
+            skipped_body: func.skipped_body.clone(),
             generator: func.generator,
             async_: func.async_,
             span: func.span,
@@ -3293,3 +3355,16 @@ impl Compiler {
         Ok(())
     }
 }
+
+/// Collect the names bound by destructuring and defaulted parameters
+fn collect_destructured_param_names(
+    params: &[crate::ast::FunctionParam],
+    names: &mut Vec<JsString>,
+) {
+    for param in params {
+        match &param.pattern {
+            Pattern::Identifier(_) | Pattern::Rest(_) => {}
+            pattern => Compiler::collect_pattern_names(pattern, names),
+        }
+    }
+}
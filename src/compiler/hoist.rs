@@ -25,8 +25,8 @@ impl Compiler {
 
         for name in var_names {
             // Track that this var has been hoisted
-            if self.hoisted_vars.insert(name.cheap_clone()) {
-                // Only emit declaration if not already hoisted
+            if self.hoisted_vars.insert(name.cheap_clone()) && !self.declare_hoisted_local(&name)? {
+                // Only emit declaration if not already hoisted or kept in a register
                 let name_idx = self.builder.add_string(name)?;
                 self.builder.emit(Op::DeclareVarHoisted {
                     name: name_idx,
@@ -0,0 +1,204 @@
+//! Deferred compilation of function bodies
+//!
+//! In lazy mode the code creating a function holds a stub chunk instead of
+//! the compiled body. The stub's `FunctionInfo` carries what is needed before
+//! the first call (name, length and kind); the body is compiled when the
+//! function is first called and shared by every closure created from the
+//! stub. Bodies the parser skipped are parsed at that point too.
+
+use core::cell::OnceCell;
+use core::fmt;
+
+use super::{BytecodeChunk, ClassContext, Compiler, Constant, FunctionInfo, Op};
+use crate::ast::{BlockStatement, Expression, FunctionParam, SkippedBody, Statement};
+use crate::error::JsError;
+use crate::parser::Parser;
+use crate::prelude::*;
+use crate::string_dict::StringDict;
+use crate::value::{CheapClone, JsString};
+
+/// Body of a function whose compilation is deferred
+pub(crate) enum LazyBody {
+    /// A statement body
+    Block(Rc<[Statement]>),
+    /// An arrow function's expression body
+    Expression(Rc<Expression>),
+    /// A body the parser skipped
+    Skipped(SkippedBody),
+}
+
+impl LazyBody {
+    /// The body of a function with a block body
+    pub(crate) fn block(body: &BlockStatement, skipped: Option<&SkippedBody>) -> Self {
+        match skipped {
+            Some(skipped) => Self::Skipped(skipped.clone()),
+            None => Self::Block(body.body.cheap_clone()),
+        }
+    }
+}
+
+/// A function compiled on its first call
+pub struct LazyFunction {
+    params: Rc<[FunctionParam]>,
+    body: LazyBody,
+    name: Option<JsString>,
+    is_generator: bool,
+    is_async: bool,
+    is_arrow: bool,
+    /// State of the enclosing compiler the body is compiled with
+    source_file: Option<String>,
+    class_context_stack: Vec<ClassContext>,
+    compiled: OnceCell<Rc<BytecodeChunk>>,
+}
+
+impl fmt::Debug for LazyFunction {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("LazyFunction")
+            .field("name", &self.name)
+            .field("compiled", &self.compiled.get().is_some())
+            .finish()
+    }
+}
+
+impl LazyFunction {
+    /// The compiled body, compiling it on the first call
+    ///
+    /// `string_dict` interns identifiers of a body the parser skipped.
+    pub fn compile(&self, string_dict: &mut StringDict) -> Result<Rc<BytecodeChunk>, JsError> {
+        if let Some(chunk) = self.compiled.get() {
+            return Ok(chunk.cheap_clone());
+        }
+        let chunk = self.compile_body(string_dict)?;
+        Ok(self.compiled.get_or_init(|| Rc::new(chunk)).cheap_clone())
+    }
+
+    /// The compiled body of `stub` for writing to a bytecode blob, without
+    /// caching it in the stub
+    ///
+    /// A skipped body is parsed with a private `StringDict`: blobs store
+    /// strings by value and intern them again on load. A body that fails to
+    /// parse becomes a chunk throwing the SyntaxError, so the error still
+    /// waits for the body to run.
+    pub(crate) fn compile_detached(
+        &self,
+        stub: &BytecodeChunk,
+    ) -> Result<Cow<'_, BytecodeChunk>, JsError> {
+        if let Some(chunk) = self.compiled.get() {
+            return Ok(Cow::Borrowed(&**chunk));
+        }
+        match self.compile_body(&mut StringDict::new()) {
+            Ok(chunk) => Ok(Cow::Owned(chunk)),
+            Err(JsError::SyntaxError { message, location }) => {
+                let mut chunk = BytecodeChunk::new();
+                chunk.source_file = stub.source_file.clone();
+                chunk.function_info = stub.function_info.clone();
+                // Arguments are still stored into the parameter registers
+                chunk.register_count = u8::try_from(self.params.len()).unwrap_or(u8::MAX);
+                chunk
+                    .constants
+                    .push(Constant::String(JsString::from(message)));
+                chunk.code.push(Op::ThrowSyntaxError {
+                    message: 0,
+                    line: location.line,
+                    column: location.column,
+                });
+                Ok(Cow::Owned(chunk))
+            }
+            Err(err) => Err(err),
+        }
+    }
+
+    fn compile_body(&self, string_dict: &mut StringDict) -> Result<BytecodeChunk, JsError> {
+        let mut compiler = Compiler::new();
+        compiler.lazy_functions = true;
+        compiler.source_file = self.source_file.clone();
+        compiler.class_context_stack = self.class_context_stack.clone();
+
+        let name = self.name.cheap_clone();
+        let chunk = match &self.body {
+            LazyBody::Block(body) => compiler.compile_function_body(
+                &self.params,
+                body,
+                name,
+                self.is_generator,
+                self.is_async,
+                self.is_arrow,
+            )?,
+            LazyBody::Expression(expr) => compiler.compile_arrow_expression_body_with_name(
+                &self.params,
+                expr,
+                self.is_async,
+                name,
+            )?,
+            LazyBody::Skipped(skipped) => {
+                let block = Parser::parse_skipped_body(skipped, string_dict)?;
+                compiler.compile_function_body(
+                    &self.params,
+                    &block.body,
+                    name,
+                    self.is_generator,
+                    self.is_async,
+                    self.is_arrow,
+                )?
+            }
+        };
+        Ok(chunk)
+    }
+}
+
+impl Compiler {
+    /// Compile a function body to a nested chunk, or return a stub that
+    /// compiles it on first call in lazy mode and for bodies the parser
+    /// skipped
+    pub(crate) fn function_chunk(
+        &mut self,
+        params: &Rc<[FunctionParam]>,
+        body: LazyBody,
+        name: Option<JsString>,
+        is_generator: bool,
+        is_async: bool,
+        is_arrow: bool,
+    ) -> Result<BytecodeChunk, JsError> {
+        match &body {
+            LazyBody::Block(statements) if !self.lazy_functions => self.compile_function_body(
+                params,
+                statements,
+                name,
+                is_generator,
+                is_async,
+                is_arrow,
+            ),
+            LazyBody::Expression(expr) if !self.lazy_functions => {
+                self.compile_arrow_expression_body_with_name(params, expr, is_async, name)
+            }
+            _ => {
+                let mut stub = BytecodeChunk::new();
+                stub.source_file = self.source_file.clone();
+                stub.function_info = Some(FunctionInfo {
+                    name: name.cheap_clone(),
+                    param_count: params.len(),
+                    is_generator,
+                    is_async,
+                    is_arrow,
+                    uses_arguments: false,
+                    uses_this: !is_arrow,
+                    param_names: Vec::new(),
+                    rest_param: None,
+                    binding_count: 0,
+                });
+                stub.lazy = Some(Rc::new(LazyFunction {
+                    params: params.cheap_clone(),
+                    body,
+                    name,
+                    is_generator,
+                    is_async,
+                    is_arrow,
+                    source_file: self.source_file.clone(),
+                    class_context_stack: self.class_context_stack.clone(),
+                    compiled: OnceCell::new(),
+                }));
+                Ok(stub)
+            }
+        }
+    }
+}
@@ -9,9 +9,17 @@ mod compile_expr;
 mod compile_pattern;
 mod compile_stmt;
 mod hoist;
+mod lazy;
+mod peephole;
+mod program;
+mod scope;
+mod serialize;
 
 pub use builder::{BytecodeBuilder, JumpPlaceholder};
-pub use bytecode::{BytecodeChunk, Constant, FunctionInfo, JumpTarget, Op, Register};
+pub use bytecode::{BytecodeChunk, CacheIndex, Constant, FunctionInfo, JumpTarget, Op, Register};
+pub use lazy::LazyFunction;
+pub use program::{CompiledModule, CompiledProgram, ImportBindingDecl, ImportDecl};
+pub use serialize::BYTECODE_FORMAT_VERSION;
 
 use crate::prelude::*;
 
@@ -19,6 +27,7 @@ use crate::ast::Program;
 use crate::error::JsError;
 use crate::value::JsString;
 use builder::RegisterAllocator;
+use scope::{CompileScope, LocalAnalysis};
 
 /// Compiler state for converting AST to bytecode
 pub struct Compiler {
@@ -56,6 +65,16 @@ pub struct Compiler {
 
     /// Source file path for stack traces (propagated to all nested chunks)
     source_file: Option<String>,
+
+    /// Which bindings may live in registers (only set while compiling a function body)
+    locals: Option<LocalAnalysis>,
+
+    /// Compile-time scopes mirroring the runtime scope chain of the current chunk
+    scopes: Vec<CompileScope>,
+
+    /// Whether nested functions are compiled on first call (propagated to
+    /// nested compilers)
+    lazy_functions: bool,
 }
 
 /// Context for a class being compiled (for private field handling)
@@ -108,6 +127,9 @@ impl Compiler {
             next_class_brand: 0,
             track_completion: false,
             source_file: None,
+            locals: None,
+            scopes: Vec::new(),
+            lazy_functions: false,
         }
     }
 
@@ -183,6 +205,26 @@ impl Compiler {
         Ok(Rc::new(compiler.builder.finish()))
     }
 
+    /// Compile a program whose functions are compiled on first call
+    pub fn compile_program_lazy(
+        program: &Program,
+        source_file: Option<String>,
+    ) -> Result<Rc<BytecodeChunk>, JsError> {
+        let mut compiler = match source_file {
+            Some(path) => Compiler::with_source_file(path),
+            None => Compiler::new(),
+        };
+        compiler.lazy_functions = true;
+
+        // First, hoist all var declarations and function declarations to the top
+        compiler.emit_hoisted_declarations(&program.body)?;
+
+        // Then compile the statements
+        compiler.compile_statements(&program.body)?;
+        compiler.builder.emit_halt();
+        Ok(Rc::new(compiler.builder.finish()))
+    }
+
     /// Compile a program for eval with completion value tracking
     /// Register 0 will contain the completion value when Halt is reached.
     pub fn compile_program_for_eval(program: &Program) -> Result<Rc<BytecodeChunk>, JsError> {
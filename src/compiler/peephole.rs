@@ -0,0 +1,126 @@
+//! Peephole fusion of common instruction pairs into superinstructions
+//!
+//! A fused op replaces the first instruction of a pair and the second one is
+//! left in place. Nothing moves, so jump targets, try handlers and source map
+//! offsets stay valid, and a jump that lands on the second instruction still
+//! runs it on its own. The VM executes a fused op as both instructions and
+//! then continues after the pair.
+
+use super::bytecode::Op;
+
+/// Rewrite fusable instruction pairs in `code` into superinstructions
+pub fn fuse_superinstructions(code: &mut [Op]) {
+    let mut i = 0;
+    while let (Some(&first), Some(&second)) = (code.get(i), code.get(i + 1)) {
+        match fuse(first, second) {
+            Some(fused) => {
+                if let Some(slot) = code.get_mut(i) {
+                    *slot = fused;
+                }
+                // The second instruction is covered by the fused op
+                i += 2;
+            }
+            None => i += 1,
+        }
+    }
+}
+
+/// The superinstruction for `first` followed by `second`, if there is one
+fn fuse(first: Op, second: Op) -> Option<Op> {
+    match (first, second) {
+        // Comparison feeding a conditional jump (loop and if conditions)
+        (Op::Lt { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::LtJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+        (Op::LtEq { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::LtEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+        (Op::Gt { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::GtJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+        (Op::GtEq { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::GtEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+        (Op::StrictEq { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::StrictEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+        (Op::StrictNotEq { dst, left, right }, Op::JumpIfFalse { cond, target }) if cond == dst => {
+            Some(Op::StrictNotEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            })
+        }
+
+        // Small integer as the right operand (`i + 1`, `n - 2`)
+        (Op::LoadInt { dst: tmp, value }, Op::Add { dst, left, right }) if right == tmp => {
+            Some(Op::LoadIntAdd {
+                dst,
+                left,
+                tmp,
+                value,
+            })
+        }
+        (Op::LoadInt { dst: tmp, value }, Op::Sub { dst, left, right }) if right == tmp => {
+            Some(Op::LoadIntSub {
+                dst,
+                left,
+                tmp,
+                value,
+            })
+        }
+
+        // Method call whose arguments need no evaluation (`it.next()`)
+        (
+            Op::GetPropertyConst {
+                dst: method,
+                obj,
+                key,
+                cache,
+            },
+            Op::Call {
+                dst,
+                callee,
+                this,
+                args_start,
+                argc,
+            },
+        ) if callee == method && this == obj && method != obj => Some(Op::GetPropertyConstCall {
+            dst,
+            obj,
+            key,
+            cache,
+            callee,
+            args_start,
+            argc,
+        }),
+
+        _ => None,
+    }
+}
@@ -0,0 +1,185 @@
+//! Compiled programs and their import declarations
+//!
+//! A `CompiledProgram` is everything the interpreter needs to link and run a
+//! script or module without the AST: the top-level bytecode chunk plus the
+//! import declarations used to request dependencies and create bindings.
+//!
+//! A `CompiledModule` is the same program as a self-contained bytecode blob,
+//! compiled without an interpreter so it can be built on another thread.
+
+use crate::prelude::*;
+
+use crate::ModulePath;
+use crate::ast::{ImportSpecifier, Program, Statement};
+use crate::error::JsError;
+use crate::parser::Parser;
+use crate::string_dict::StringDict;
+use crate::value::{CheapClone, JsString};
+
+use super::{BytecodeChunk, Compiler};
+
+/// A program compiled to bytecode together with its module imports
+#[derive(Debug, Clone)]
+pub struct CompiledProgram {
+    /// Top-level bytecode chunk
+    pub chunk: Rc<BytecodeChunk>,
+
+    /// Import declarations in source order
+    pub imports: Vec<ImportDecl>,
+}
+
+/// A module dependency declared by `import ... from` or `export ... from`
+#[derive(Debug, Clone)]
+pub struct ImportDecl {
+    /// Module specifier as written in the source
+    pub specifier: JsString,
+
+    /// Whether the module is resolved before execution
+    /// (false for re-exports and type-only imports)
+    pub resolve: bool,
+
+    /// Bindings to create before execution
+    pub bindings: Vec<ImportBindingDecl>,
+}
+
+/// A single local binding created by an import declaration
+#[derive(Debug, Clone)]
+pub enum ImportBindingDecl {
+    /// `import { imported as local } from "mod"`
+    Named { local: JsString, imported: JsString },
+
+    /// `import local from "mod"`
+    Default { local: JsString },
+
+    /// `import * as local from "mod"`
+    Namespace { local: JsString },
+}
+
+impl ImportDecl {
+    /// Collect the import declarations of a program in source order
+    pub fn collect(program: &Program) -> Vec<ImportDecl> {
+        let mut imports = Vec::new();
+
+        for stmt in program.body.iter() {
+            match stmt {
+                Statement::Import(import) => {
+                    let bindings = if import.type_only {
+                        Vec::new()
+                    } else {
+                        import
+                            .specifiers
+                            .iter()
+                            .map(|spec| match spec {
+                                ImportSpecifier::Named {
+                                    local, imported, ..
+                                } => ImportBindingDecl::Named {
+                                    local: local.name.cheap_clone(),
+                                    imported: imported.name.cheap_clone(),
+                                },
+                                ImportSpecifier::Default { local, .. } => {
+                                    ImportBindingDecl::Default {
+                                        local: local.name.cheap_clone(),
+                                    }
+                                }
+                                ImportSpecifier::Namespace { local, .. } => {
+                                    ImportBindingDecl::Namespace {
+                                        local: local.name.cheap_clone(),
+                                    }
+                                }
+                            })
+                            .collect()
+                    };
+                    imports.push(ImportDecl {
+                        specifier: import.source.value.cheap_clone(),
+                        resolve: !import.type_only,
+                        bindings,
+                    });
+                }
+                Statement::Export(export) => {
+                    // Re-export from another module: export { foo } from "./bar"
+                    if let Some(source) = &export.source {
+                        imports.push(ImportDecl {
+                            specifier: source.value.cheap_clone(),
+                            resolve: false,
+                            bindings: Vec::new(),
+                        });
+                    }
+                }
+                _ => {}
+            }
+        }
+
+        imports
+    }
+}
+
+impl CompiledProgram {
+    /// Compile a program, recording `source_file` in every chunk for stack traces
+    pub fn compile(program: &Program, source_file: Option<String>) -> Result<Self, JsError> {
+        let chunk = match source_file {
+            Some(path) => Compiler::compile_program_with_source(program, path)?,
+            None => Compiler::compile_program(program)?,
+        };
+        Ok(Self {
+            chunk,
+            imports: ImportDecl::collect(program),
+        })
+    }
+
+    /// Compile a program whose functions are compiled on first call
+    pub fn compile_lazy(program: &Program, source_file: Option<String>) -> Result<Self, JsError> {
+        Ok(Self {
+            chunk: Compiler::compile_program_lazy(program, source_file)?,
+            imports: ImportDecl::collect(program),
+        })
+    }
+}
+
+/// A module compiled without an interpreter, held as a bytecode blob
+///
+/// Compiling interns identifiers into a private `StringDict` and keeps only
+/// the serialized bytes, so the result shares nothing with any interpreter and
+/// is `Send`: hosts can lex, parse and compile imports on worker threads, then
+/// hand each one to the interpreter's thread with
+/// `Interpreter::provide_module_bytecode(module.path().clone(), module.as_bytes())`.
+/// Only decoding and string interning happen on that thread.
+#[derive(Debug, Clone)]
+pub struct CompiledModule {
+    path: ModulePath,
+    bytes: Vec<u8>,
+}
+
+impl CompiledModule {
+    /// Parse and compile `source`, recording `path` as its source file
+    ///
+    /// `JsError` may hold JavaScript values and is not `Send`; a worker thread
+    /// should pass back `error.to_string()` instead.
+    pub fn compile(source: &str, path: ModulePath) -> Result<Self, JsError> {
+        let mut dict = StringDict::new();
+        let program = Parser::new(source, &mut dict).parse_program()?;
+        let bytes =
+            CompiledProgram::compile(&program, Some(path.as_str().to_string()))?.to_bytes()?;
+        Ok(Self { path, bytes })
+    }
+
+    /// Path the module was compiled for
+    pub fn path(&self) -> &ModulePath {
+        &self.path
+    }
+
+    /// The serialized program, as accepted by `provide_module_bytecode`
+    pub fn as_bytes(&self) -> &[u8] {
+        &self.bytes
+    }
+
+    /// Take the serialized program
+    pub fn into_bytes(self) -> Vec<u8> {
+        self.bytes
+    }
+}
+
+// Compiled modules cross threads; keep them free of Rc and interpreter state
+const _: () = {
+    const fn assert_send<T: Send>() {}
+    assert_send::<CompiledModule>();
+};
@@ -0,0 +1,724 @@
+//! Static resolution of function-local bindings
+//!
+//! Inside a function body most bindings are only ever touched by the function
+//! itself. Those bindings are kept in registers instead of the environment, so
+//! reading a local is a register move rather than a hash lookup up the scope
+//! chain, and blocks that declare nothing else need no environment at all.
+//!
+//! A binding stays in the environment when its name is referenced from nested
+//! code (functions, class bodies, enum initializers), when it is declared by a
+//! construct the VM binds by name (function, class and enum declarations), or
+//! when the function resolves names dynamically (direct `eval`, namespaces).
+//! The decision is made per name, so every binding of a name in a function
+//! uses the same storage and shadowing resolves the same way as at runtime.
+
+use super::Compiler;
+use super::bytecode::{Op, Register};
+use crate::ast::{
+    Argument, ArrayElement, ArrowFunctionBody, AssignmentTarget, ClassBody, ClassMember, Decorator,
+    Expression, ForInOfLeft, ForInit, FunctionParam, MemberProperty, ObjectPatternProperty,
+    ObjectProperty, ObjectPropertyKey, Pattern, SkippedBody, Statement, VariableDeclaration,
+    VariableKind,
+};
+use crate::error::JsError;
+use crate::prelude::*;
+use crate::value::{CheapClone, JsString};
+
+/// Highest register index handed out to locals; the rest is left for temporaries
+const MAX_LOCAL_REGISTER: Register = 191;
+
+/// Which bindings of a function may live in registers
+#[derive(Debug, Default)]
+pub struct LocalAnalysis {
+    /// Names that must stay in the environment
+    env_names: FxHashSet<JsString>,
+
+    /// Whether names are resolved dynamically (direct eval, namespaces)
+    dynamic: bool,
+}
+
+impl LocalAnalysis {
+    /// Analyze a function with a statement body
+    pub fn for_function(params: &[FunctionParam], body: &[Statement]) -> Self {
+        let mut analysis = Self::default();
+        for param in params {
+            analysis.pattern(&param.pattern, false);
+        }
+        analysis.statements(body, false);
+        analysis
+    }
+
+    /// Analyze an arrow function with an expression body
+    pub fn for_expression_body(params: &[FunctionParam], body: &Expression) -> Self {
+        let mut analysis = Self::default();
+        for param in params {
+            analysis.pattern(&param.pattern, false);
+        }
+        analysis.expression(body, false);
+        analysis
+    }
+
+    /// Whether bindings named `name` can be kept in registers
+    pub fn is_local(&self, name: &JsString) -> bool {
+        !self.dynamic && !self.env_names.contains(name)
+    }
+
+    fn reference(&mut self, name: &JsString, nested: bool) {
+        if nested || name.as_str() == "arguments" {
+            self.env_names.insert(name.cheap_clone());
+        }
+    }
+
+    fn statements(&mut self, statements: &[Statement], nested: bool) {
+        for stmt in statements {
+            self.statement(stmt, nested);
+        }
+    }
+
+    fn statement(&mut self, stmt: &Statement, nested: bool) {
+        match stmt {
+            Statement::VariableDeclaration(decl) => self.variable_declaration(decl, nested),
+            Statement::FunctionDeclaration(func) => {
+                if let Some(id) = &func.id {
+                    self.env_names.insert(id.name.cheap_clone());
+                }
+                self.skipped(func.skipped_body.as_ref());
+                self.function(&func.params, &func.body.body);
+            }
+            Statement::ClassDeclaration(class) => {
+                if let Some(id) = &class.id {
+                    self.env_names.insert(id.name.cheap_clone());
+                }
+                self.class(class.super_class.as_deref(), &class.body, &class.decorators);
+            }
+            Statement::EnumDeclaration(decl) => {
+                self.env_names.insert(decl.id.name.cheap_clone());
+                for member in &decl.members {
+                    if let Some(init) = &member.initializer {
+                        self.expression(init, true);
+                    }
+                }
+            }
+            Statement::NamespaceDeclaration(decl) => {
+                self.dynamic = true;
+                self.env_names.insert(decl.id.name.cheap_clone());
+                self.statements(&decl.body, true);
+            }
+            Statement::TypeAlias(_) | Statement::InterfaceDeclaration(_) => {}
+            Statement::Block(block) => self.statements(&block.body, nested),
+            Statement::If(if_stmt) => {
+                self.expression(&if_stmt.test, nested);
+                self.statement(&if_stmt.consequent, nested);
+                if let Some(alt) = &if_stmt.alternate {
+                    self.statement(alt, nested);
+                }
+            }
+            Statement::Switch(switch_stmt) => {
+                self.expression(&switch_stmt.discriminant, nested);
+                for case in switch_stmt.cases.iter() {
+                    if let Some(test) = &case.test {
+                        self.expression(test, nested);
+                    }
+                    self.statements(&case.consequent, nested);
+                }
+            }
+            Statement::For(for_stmt) => {
+                match &for_stmt.init {
+                    Some(ForInit::Variable(decl)) => self.variable_declaration(decl, nested),
+                    Some(ForInit::Expression(expr)) => self.expression(expr, nested),
+                    None => {}
+                }
+                if let Some(test) = &for_stmt.test {
+                    self.expression(test, nested);
+                }
+                if let Some(update) = &for_stmt.update {
+                    self.expression(update, nested);
+                }
+                self.statement(&for_stmt.body, nested);
+            }
+            Statement::ForIn(for_in) => {
+                self.for_in_of_left(&for_in.left, nested);
+                self.expression(&for_in.right, nested);
+                self.statement(&for_in.body, nested);
+            }
+            Statement::ForOf(for_of) => {
+                self.for_in_of_left(&for_of.left, nested);
+                self.expression(&for_of.right, nested);
+                self.statement(&for_of.body, nested);
+            }
+            Statement::While(while_stmt) => {
+                self.expression(&while_stmt.test, nested);
+                self.statement(&while_stmt.body, nested);
+            }
+            Statement::DoWhile(do_while) => {
+                self.statement(&do_while.body, nested);
+                self.expression(&do_while.test, nested);
+            }
+            Statement::Try(try_stmt) => {
+                self.statements(&try_stmt.block.body, nested);
+                if let Some(handler) = &try_stmt.handler {
+                    if let Some(param) = &handler.param {
+                        self.pattern(param, nested);
+                    }
+                    self.statements(&handler.body.body, nested);
+                }
+                if let Some(finalizer) = &try_stmt.finalizer {
+                    self.statements(&finalizer.body, nested);
+                }
+            }
+            Statement::Return(ret) => {
+                if let Some(arg) = &ret.argument {
+                    self.expression(arg, nested);
+                }
+            }
+            Statement::Throw(throw_stmt) => self.expression(&throw_stmt.argument, nested),
+            Statement::Expression(expr_stmt) => self.expression(&expr_stmt.expression, nested),
+            Statement::Labeled(labeled) => self.statement(&labeled.body, nested),
+            Statement::Import(_) | Statement::Export(_) => self.dynamic = true,
+            Statement::Break(_)
+            | Statement::Continue(_)
+            | Statement::Empty
+            | Statement::Debugger => {}
+        }
+    }
+
+    fn variable_declaration(&mut self, decl: &VariableDeclaration, nested: bool) {
+        for declarator in decl.declarations.iter() {
+            self.pattern(&declarator.id, nested);
+            if let Some(init) = &declarator.init {
+                self.expression(init, nested);
+            }
+        }
+    }
+
+    fn for_in_of_left(&mut self, left: &ForInOfLeft, nested: bool) {
+        match left {
+            ForInOfLeft::Variable(decl) => self.variable_declaration(decl, nested),
+            ForInOfLeft::Pattern(pattern) => self.pattern(pattern, nested),
+        }
+    }
+
+    /// Everything inside a nested function is seen through its closure
+    fn function(&mut self, params: &[FunctionParam], body: &[Statement]) {
+        for param in params {
+            self.pattern(&param.pattern, true);
+            self.decorators(&param.decorators);
+        }
+        self.statements(body, true);
+    }
+
+    /// A nested body skipped by lazy parsing may reference any binding
+    fn skipped(&mut self, body: Option<&SkippedBody>) {
+        if body.is_some() {
+            self.dynamic = true;
+        }
+    }
+
+    /// Class bodies run as separate functions, so treat them as nested code
+    fn class(
+        &mut self,
+        super_class: Option<&Expression>,
+        body: &ClassBody,
+        decorators: &[Decorator],
+    ) {
+        self.decorators(decorators);
+        if let Some(super_class) = super_class {
+            self.expression(super_class, true);
+        }
+        for member in &body.members {
+            match member {
+                ClassMember::Method(method) => {
+                    self.property_key(&method.key, true);
+                    self.decorators(&method.decorators);
+                    self.function(&method.value.params, &method.value.body.body);
+                }
+                ClassMember::Property(prop) => {
+                    self.property_key(&prop.key, true);
+                    self.decorators(&prop.decorators);
+                    if let Some(value) = &prop.value {
+                        self.expression(value, true);
+                    }
+                }
+                ClassMember::Constructor(ctor) => self.function(&ctor.params, &ctor.body.body),
+                ClassMember::StaticBlock(block) => self.statements(&block.body, true),
+            }
+        }
+    }
+
+    fn decorators(&mut self, decorators: &[Decorator]) {
+        for decorator in decorators {
+            self.expression(&decorator.expression, true);
+        }
+    }
+
+    fn property_key(&mut self, key: &ObjectPropertyKey, nested: bool) {
+        if let ObjectPropertyKey::Computed(expr) = key {
+            self.expression(expr, nested);
+        }
+    }
+
+    fn pattern(&mut self, pattern: &Pattern, nested: bool) {
+        match pattern {
+            Pattern::Identifier(id) => self.reference(&id.name, nested),
+            Pattern::Object(obj) => {
+                for prop in &obj.properties {
+                    match prop {
+                        ObjectPatternProperty::KeyValue { key, value, .. } => {
+                            self.property_key(key, nested);
+                            self.pattern(value, nested);
+                        }
+                        ObjectPatternProperty::Rest(rest) => self.pattern(&rest.argument, nested),
+                    }
+                }
+            }
+            Pattern::Array(arr) => {
+                for elem in arr.elements.iter().flatten() {
+                    self.pattern(elem, nested);
+                }
+            }
+            Pattern::Rest(rest) => self.pattern(&rest.argument, nested),
+            Pattern::Assignment(assign) => {
+                self.pattern(&assign.left, nested);
+                self.expression(&assign.right, nested);
+            }
+        }
+    }
+
+    fn arguments(&mut self, args: &[Argument], nested: bool) {
+        for arg in args {
+            match arg {
+                Argument::Expression(expr) => self.expression(expr, nested),
+                Argument::Spread(spread) => self.expression(&spread.argument, nested),
+            }
+        }
+    }
+
+    fn expression(&mut self, expr: &Expression, nested: bool) {
+        match expr {
+            Expression::Literal(_) | Expression::This(_) | Expression::Super(_) => {}
+            Expression::Identifier(id) => self.reference(&id.name, nested),
+            Expression::Array(arr) => {
+                for elem in arr.elements.iter().flatten() {
+                    match elem {
+                        ArrayElement::Expression(expr) => self.expression(expr, nested),
+                        ArrayElement::Spread(spread) => self.expression(&spread.argument, nested),
+                    }
+                }
+            }
+            Expression::Object(obj) => {
+                for prop in &obj.properties {
+                    match prop {
+                        ObjectProperty::Property(prop) => {
+                            self.property_key(&prop.key, nested);
+                            self.expression(&prop.value, nested);
+                        }
+                        ObjectProperty::Spread(spread) => self.expression(&spread.argument, nested),
+                    }
+                }
+            }
+            Expression::Function(func) => {
+                self.skipped(func.skipped_body.as_ref());
+                self.function(&func.params, &func.body.body);
+            }
+            Expression::ArrowFunction(arrow) => {
+                self.skipped(arrow.skipped_body.as_ref());
+                for param in arrow.params.iter() {
+                    self.pattern(&param.pattern, true);
+                }
+                match arrow.body.as_ref() {
+                    ArrowFunctionBody::Expression(body) => self.expression(body, true),
+                    ArrowFunctionBody::Block(block) => self.statements(&block.body, true),
+                }
+            }
+            Expression::Class(class) => {
+                if let Some(id) = &class.id {
+                    self.env_names.insert(id.name.cheap_clone());
+                }
+                self.class(class.super_class.as_deref(), &class.body, &class.decorators);
+            }
+            Expression::Template(template) => {
+                for expr in &template.expressions {
+                    self.expression(expr, nested);
+                }
+            }
+            Expression::TaggedTemplate(tagged) => {
+                self.expression(&tagged.tag, nested);
+                for expr in &tagged.quasi.expressions {
+                    self.expression(expr, nested);
+                }
+            }
+            Expression::Unary(unary) => self.expression(&unary.argument, nested),
+            Expression::Binary(binary) => {
+                self.expression(&binary.left, nested);
+                self.expression(&binary.right, nested);
+            }
+            Expression::Logical(logical) => {
+                self.expression(&logical.left, nested);
+                self.expression(&logical.right, nested);
+            }
+            Expression::Conditional(cond) => {
+                self.expression(&cond.test, nested);
+                self.expression(&cond.consequent, nested);
+                self.expression(&cond.alternate, nested);
+            }
+            Expression::Assignment(assign) => {
+                match &assign.left {
+                    AssignmentTarget::Identifier(id) => self.reference(&id.name, nested),
+                    AssignmentTarget::Member(member) => {
+                        self.expression(&member.object, nested);
+                        if let MemberProperty::Expression(prop) = &member.property {
+                            self.expression(prop, nested);
+                        }
+                    }
+                    AssignmentTarget::Pattern(pattern) => self.pattern(pattern, nested),
+                }
+                self.expression(&assign.right, nested);
+            }
+            Expression::Update(update) => self.expression(&update.argument, nested),
+            Expression::Sequence(seq) => {
+                for expr in &seq.expressions {
+                    self.expression(expr, nested);
+                }
+            }
+            Expression::Member(member) => {
+                self.expression(&member.object, nested);
+                if let MemberProperty::Expression(prop) = &member.property {
+                    self.expression(prop, nested);
+                }
+            }
+            Expression::OptionalChain(chain) => self.expression(&chain.base, nested),
+            Expression::Call(call) => {
+                // Direct eval can read and declare any binding in scope
+                if let Expression::Identifier(id) = call.callee.as_ref()
+                    && id.name.as_str() == "eval"
+                {
+                    self.dynamic = true;
+                }
+                self.expression(&call.callee, nested);
+                self.arguments(&call.arguments, nested);
+            }
+            Expression::New(new_expr) => {
+                self.expression(&new_expr.callee, nested);
+                self.arguments(&new_expr.arguments, nested);
+            }
+            Expression::TypeAssertion(assertion) => self.expression(&assertion.expression, nested),
+            Expression::NonNull(non_null) => self.expression(&non_null.expression, nested),
+            Expression::Spread(spread) => self.expression(&spread.argument, nested),
+            Expression::Yield(yield_expr) => {
+                if let Some(arg) = &yield_expr.argument {
+                    self.expression(arg, nested);
+                }
+            }
+            Expression::Await(await_expr) => self.expression(&await_expr.argument, nested),
+            Expression::Parenthesized(inner, _) => self.expression(inner, nested),
+        }
+    }
+}
+
+/// Storage of a register-backed binding
+#[derive(Debug, Clone, Copy)]
+pub struct LocalSlot {
+    pub reg: Register,
+    pub mutable: bool,
+}
+
+/// A binding declared in a compile-time scope
+#[derive(Debug)]
+struct ScopeBinding {
+    name: JsString,
+    /// Register holding the binding, or None if it lives in the environment
+    slot: Option<LocalSlot>,
+}
+
+/// Compile-time counterpart of a runtime scope
+#[derive(Debug, Default)]
+pub struct CompileScope {
+    /// Bindings visible in this scope, in declaration order
+    bindings: Vec<ScopeBinding>,
+
+    /// Registers reserved for lexical declarations not reached yet
+    reserved: Vec<(JsString, Register)>,
+
+    /// Registers released when the scope ends
+    owned: Vec<Register>,
+
+    /// Whether a runtime environment was pushed for this scope
+    env: bool,
+}
+
+impl Compiler {
+    /// Start resolving locals for a function body.
+    /// `lexical` are the let/const names declared directly in the body.
+    pub(crate) fn begin_function_locals(
+        &mut self,
+        analysis: LocalAnalysis,
+        lexical: &[JsString],
+    ) -> Result<(), JsError> {
+        self.locals = Some(analysis);
+        self.scopes.push(CompileScope::default());
+        self.reserve_lexical(lexical)?;
+        Ok(())
+    }
+
+    /// Bind a simple parameter that arrives in `reg`
+    pub(crate) fn bind_parameter(&mut self, name: &JsString, reg: Register) -> Result<(), JsError> {
+        if self.is_local_name(name) {
+            self.push_binding(name, Some(LocalSlot { reg, mutable: true }));
+        } else {
+            let name_idx = self.builder.add_string(name.cheap_clone())?;
+            self.builder.emit(Op::DeclareVar {
+                name: name_idx,
+                init: reg,
+                mutable: true,
+            });
+            self.push_binding(name, None);
+        }
+        Ok(())
+    }
+
+    /// Number of function-scope bindings kept in registers
+    pub(crate) fn function_local_count(&self) -> usize {
+        self.scopes.first().map_or(0, |scope| {
+            scope.bindings.iter().filter(|b| b.slot.is_some()).count()
+        })
+    }
+
+    /// Whether bindings named `name` are kept in registers in this function
+    pub(crate) fn is_local_name(&self, name: &JsString) -> bool {
+        self.locals
+            .as_ref()
+            .is_some_and(|analysis| analysis.is_local(name))
+    }
+
+    /// Enter a block scope declaring the let/const names in `lexical`.
+    /// `has_env_declarations` is set when the scope also declares functions,
+    /// classes or enums, which always live in the environment.
+    pub(crate) fn enter_scope(
+        &mut self,
+        lexical: &[JsString],
+        has_env_declarations: bool,
+    ) -> Result<(), JsError> {
+        self.scopes.push(CompileScope::default());
+        let all_reserved = self.reserve_lexical(lexical)?;
+        let env = self.locals.is_none() || has_env_declarations || !all_reserved;
+        if env {
+            self.builder.emit(Op::PushScope);
+        }
+        if let Some(scope) = self.scopes.last_mut() {
+            scope.env = env;
+        }
+        Ok(())
+    }
+
+    /// Enter a scope that has no runtime environment of its own (switch cases,
+    /// finally blocks); environment-bound declarations go to the enclosing one.
+    pub(crate) fn enter_local_scope(&mut self, lexical: &[JsString]) -> Result<(), JsError> {
+        self.scopes.push(CompileScope::default());
+        self.reserve_lexical(lexical)?;
+        Ok(())
+    }
+
+    /// Shadow `names` with environment bindings managed by the caller
+    pub(crate) fn enter_env_shadow(&mut self, names: &[JsString]) {
+        let mut scope = CompileScope::default();
+        for name in names {
+            scope.bindings.push(ScopeBinding {
+                name: name.cheap_clone(),
+                slot: None,
+            });
+        }
+        self.scopes.push(scope);
+    }
+
+    /// Leave the innermost scope, releasing its registers
+    pub(crate) fn exit_scope(&mut self) {
+        let Some(scope) = self.scopes.pop() else {
+            return;
+        };
+        for (_, reg) in scope.reserved.iter().rev() {
+            self.builder.free_register(*reg);
+        }
+        for reg in scope.owned.iter().rev() {
+            self.builder.free_register(*reg);
+        }
+        if scope.env {
+            self.builder.emit(Op::PopScope);
+        }
+    }
+
+    /// Reserve registers for the lexical names that can be locals.
+    /// Returns false if any of them must live in the environment.
+    fn reserve_lexical(&mut self, lexical: &[JsString]) -> Result<bool, JsError> {
+        let mut all_reserved = true;
+        for name in lexical {
+            if !self.is_local_name(name) || self.builder.registers().current() >= MAX_LOCAL_REGISTER
+            {
+                all_reserved = false;
+                continue;
+            }
+            let reg = self.builder.alloc_register()?;
+            if let Some(scope) = self.scopes.last_mut() {
+                scope.reserved.push((name.cheap_clone(), reg));
+            }
+        }
+        Ok(all_reserved)
+    }
+
+    fn push_binding(&mut self, name: &JsString, slot: Option<LocalSlot>) {
+        if let Some(scope) = self.scopes.last_mut() {
+            scope.bindings.push(ScopeBinding {
+                name: name.cheap_clone(),
+                slot,
+            });
+        }
+    }
+
+    /// Resolve a name to its register, if it is a register-backed local
+    pub(crate) fn resolve_local(&self, name: &JsString) -> Option<LocalSlot> {
+        if let Some(reg) = self.get_loop_var_redirect(name) {
+            return Some(LocalSlot { reg, mutable: true });
+        }
+        self.locals.as_ref()?;
+        for scope in self.scopes.iter().rev() {
+            if let Some(binding) = scope.bindings.iter().rev().find(|b| b.name == *name) {
+                return binding.slot;
+            }
+        }
+        None
+    }
+
+    /// Declare a let/const binding (or a catch/parameter binding) initialized from `init`
+    pub(crate) fn declare_lexical(
+        &mut self,
+        name: &JsString,
+        init: Register,
+        mutable: bool,
+    ) -> Result<(), JsError> {
+        let reserved = self.scopes.last_mut().and_then(|scope| {
+            let pos = scope.reserved.iter().position(|(n, _)| n == name)?;
+            let (_, reg) = scope.reserved.swap_remove(pos);
+            scope.owned.push(reg);
+            Some(reg)
+        });
+        if let Some(reg) = reserved {
+            self.builder.emit(Op::Move {
+                dst: reg,
+                src: init,
+            });
+            self.push_binding(name, Some(LocalSlot { reg, mutable }));
+        } else {
+            let name_idx = self.builder.add_string(name.cheap_clone())?;
+            self.builder.emit(Op::DeclareVar {
+                name: name_idx,
+                init,
+                mutable,
+            });
+            if self.locals.is_some() {
+                self.push_binding(name, None);
+            }
+        }
+        Ok(())
+    }
+
+    /// Declare a hoisted var binding in the function scope, initialized to undefined.
+    /// Returns false if the name must be declared in the environment instead.
+    pub(crate) fn declare_hoisted_local(&mut self, name: &JsString) -> Result<bool, JsError> {
+        if self.locals.is_none() {
+            return Ok(false);
+        }
+        // Parameters already provide the binding: `function f(x) { var x; }`
+        let already_bound = self
+            .scopes
+            .first()
+            .is_some_and(|scope| scope.bindings.iter().any(|b| b.name == *name));
+        if already_bound {
+            return Ok(true);
+        }
+        if !self.is_local_name(name) || self.builder.registers().current() >= MAX_LOCAL_REGISTER {
+            self.push_binding(name, None);
+            return Ok(false);
+        }
+        let reg = self.builder.alloc_register()?;
+        self.builder.emit(Op::LoadUndefined { dst: reg });
+        if let Some(scope) = self.scopes.first_mut() {
+            scope.owned.push(reg);
+            scope.bindings.push(ScopeBinding {
+                name: name.cheap_clone(),
+                slot: Some(LocalSlot { reg, mutable: true }),
+            });
+        }
+        Ok(true)
+    }
+
+    /// Load a variable into `dst`
+    pub(crate) fn emit_load_var(&mut self, name: &JsString, dst: Register) -> Result<(), JsError> {
+        if let Some(slot) = self.resolve_local(name) {
+            if slot.reg != dst {
+                self.builder.emit(Op::Move { dst, src: slot.reg });
+            }
+        } else {
+            let name_idx = self.builder.add_string(name.cheap_clone())?;
+            self.builder.emit(Op::GetVar {
+                dst,
+                name: name_idx,
+            });
+        }
+        Ok(())
+    }
+
+    /// Store `src` into an existing variable
+    pub(crate) fn emit_store_var(&mut self, name: &JsString, src: Register) -> Result<(), JsError> {
+        match self.resolve_local(name) {
+            Some(slot) if slot.mutable => {
+                if slot.reg != src {
+                    self.builder.emit(Op::Move { dst: slot.reg, src });
+                }
+            }
+            Some(_) => {
+                let name_idx = self.builder.add_string(name.cheap_clone())?;
+                self.builder
+                    .emit(Op::ThrowConstAssignment { name: name_idx });
+            }
+            None => {
+                let name_idx = self.builder.add_string(name.cheap_clone())?;
+                self.builder.emit(Op::SetVar {
+                    name: name_idx,
+                    src,
+                });
+            }
+        }
+        Ok(())
+    }
+}
+
+/// Collect the let/const names declared directly in a statement list, and
+/// whether it also declares bindings that always live in the environment
+pub(crate) fn lexical_declarations(statements: &[Statement]) -> (Vec<JsString>, bool) {
+    let mut names = Vec::new();
+    let mut has_env_declarations = false;
+    for stmt in statements {
+        collect_lexical_stmt(stmt, &mut names, &mut has_env_declarations);
+    }
+    (names, has_env_declarations)
+}
+
+fn collect_lexical_stmt(stmt: &Statement, names: &mut Vec<JsString>, has_env: &mut bool) {
+    match stmt {
+        Statement::VariableDeclaration(decl) => lexical_names(decl, names),
+        Statement::FunctionDeclaration(_)
+        | Statement::ClassDeclaration(_)
+        | Statement::EnumDeclaration(_)
+        | Statement::NamespaceDeclaration(_) => *has_env = true,
+        Statement::Labeled(labeled) => collect_lexical_stmt(&labeled.body, names, has_env),
+        _ => {}
+    }
+}
+
+/// Collect the names declared by a let/const declaration (nothing for var)
+pub(crate) fn lexical_names(decl: &VariableDeclaration, names: &mut Vec<JsString>) {
+    if decl.kind != VariableKind::Var {
+        for declarator in decl.declarations.iter() {
+            Compiler::collect_pattern_names(&declarator.id, names);
+        }
+    }
+}
@@ -0,0 +1,1043 @@
+//! Binary serialization of compiled programs
+//!
+//! Lets hosts compile once (e.g. at deploy time) and load bytecode later
+//! without lexing, parsing or compiling again.
+//!
+//! # Format
+//!
+//! All integers are little-endian. A blob is laid out as:
+//!
+//! ```text
+//! magic "TSRB" | format version (u16) | crate version (str)
+//! string table: count (u32), then each string as len (u32) + UTF-8 bytes
+//! imports:      count (u32), then each import declaration
+//! chunk:        the top-level BytecodeChunk, nested chunks inline
+//! ```
+//!
+//! Every string after the table is a u32 index into it, so identifiers shared
+//! by many chunks are stored once. Instructions are encoded through the serde
+//! derive on `Op` as a variant index followed by its fields.
+//!
+//! Decoding never trusts the blob: besides lengths and string indices, every
+//! register, constant and jump operand is checked against the chunk it belongs
+//! to, and nested function chunks may only go `MAX_CHUNK_DEPTH` levels deep.
+//! Operands are classified by field name in `operand_kind`, so new `Op`
+//! fields that are neither registers, constant indices nor jump targets must
+//! be listed there.
+//!
+//! Blobs are only accepted by the same `BYTECODE_FORMAT_VERSION` and crate
+//! version that produced them. Bump the format version whenever `Op`,
+//! `Constant`, `FunctionInfo` or the layout below changes.
+
+use crate::prelude::*;
+
+use serde::de::{self, DeserializeSeed, IntoDeserializer, SeqAccess, Visitor};
+use serde::ser::{self, Impossible, Serialize};
+
+use crate::error::JsError;
+use crate::interpreter::inline_cache::InlineCaches;
+use crate::lexer::Span;
+use crate::string_dict::StringDict;
+use crate::value::{CheapClone, JsString};
+
+use super::bytecode::SourceMapEntry;
+use super::program::{CompiledProgram, ImportBindingDecl, ImportDecl};
+use super::{BytecodeChunk, Constant, FunctionInfo, Op};
+
+/// Magic bytes at the start of every bytecode blob
+const MAGIC: &[u8; 4] = b"TSRB";
+
+/// Version of the blob layout
+pub const BYTECODE_FORMAT_VERSION: u16 = 5;
+
+/// Deepest function nesting a blob may encode
+///
+/// Chunks are decoded recursively, so this bounds the decoder's stack use.
+const MAX_CHUNK_DEPTH: usize = 128;
+
+/// Crate version that must match between encoder and decoder
+const CRATE_VERSION: &str = env!("CARGO_PKG_VERSION");
+
+// Constant tags
+const CONST_STRING: u8 = 0;
+const CONST_NUMBER: u8 = 1;
+const CONST_CHUNK: u8 = 2;
+const CONST_REGEXP: u8 = 3;
+const CONST_TEMPLATE: u8 = 4;
+const CONST_EXCLUDED_KEYS: u8 = 5;
+
+// Import binding tags
+const BINDING_NAMED: u8 = 0;
+const BINDING_DEFAULT: u8 = 1;
+const BINDING_NAMESPACE: u8 = 2;
+
+// FunctionInfo flag bits
+const FLAG_GENERATOR: u8 = 1 << 0;
+const FLAG_ASYNC: u8 = 1 << 1;
+const FLAG_ARROW: u8 = 1 << 2;
+const FLAG_USES_ARGUMENTS: u8 = 1 << 3;
+const FLAG_USES_THIS: u8 = 1 << 4;
+
+fn invalid(message: &str) -> JsError {
+    JsError::module_error(format!("Invalid bytecode: {}", message))
+}
+
+impl CompiledProgram {
+    /// Serialize to a self-contained binary blob
+    pub fn to_bytes(&self) -> Result<Vec<u8>, JsError> {
+        let mut body = Writer::new();
+        body.write_len(self.imports.len())?;
+        for import in &self.imports {
+            body.write_import(import)?;
+        }
+        body.write_chunk(&self.chunk)?;
+
+        let mut out = Vec::with_capacity(body.buf.len() + 64);
+        out.extend_from_slice(MAGIC);
+        out.extend_from_slice(&BYTECODE_FORMAT_VERSION.to_le_bytes());
+        write_raw_str(&mut out, CRATE_VERSION)?;
+        write_len_raw(&mut out, body.strings.len())?;
+        for s in &body.strings {
+            write_raw_str(&mut out, s.as_str())?;
+        }
+        out.extend_from_slice(&body.buf);
+        Ok(out)
+    }
+
+    /// Deserialize a blob produced by `to_bytes`, interning strings in `dict`
+    pub fn from_bytes(bytes: &[u8], dict: &mut StringDict) -> Result<Self, JsError> {
+        let mut reader = Reader::new(bytes);
+        if reader.take(MAGIC.len())? != MAGIC {
+            return Err(invalid("bad magic"));
+        }
+        let version = u16::from_le_bytes(reader.array()?);
+        if version != BYTECODE_FORMAT_VERSION {
+            return Err(invalid(&format!(
+                "format version {} (expected {})",
+                version, BYTECODE_FORMAT_VERSION
+            )));
+        }
+        let crate_version = reader.read_raw_str()?;
+        if crate_version != CRATE_VERSION {
+            return Err(invalid(&format!(
+                "compiled by tsrun {} (this is {})",
+                crate_version, CRATE_VERSION
+            )));
+        }
+
+        let string_count = reader.read_len()?;
+        let mut strings = Vec::with_capacity(string_count.min(reader.remaining()));
+        for _ in 0..string_count {
+            let s = reader.read_raw_str()?;
+            strings.push(dict.get_or_insert(s));
+        }
+        reader.strings = strings;
+
+        let import_count = reader.read_len()?;
+        let mut imports = Vec::with_capacity(import_count.min(reader.remaining()));
+        for _ in 0..import_count {
+            imports.push(reader.read_import()?);
+        }
+        let chunk = reader.read_chunk()?;
+
+        if reader.remaining() != 0 {
+            return Err(invalid("trailing bytes"));
+        }
+
+        Ok(CompiledProgram {
+            chunk: Rc::new(chunk),
+            imports,
+        })
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Writer
+// ═══════════════════════════════════════════════════════════════════════════════
+
+fn write_len_raw(buf: &mut Vec<u8>, len: usize) -> Result<(), JsError> {
+    let len = u32::try_from(len).map_err(|_| invalid("length exceeds u32"))?;
+    buf.extend_from_slice(&len.to_le_bytes());
+    Ok(())
+}
+
+fn write_raw_str(buf: &mut Vec<u8>, s: &str) -> Result<(), JsError> {
+    write_len_raw(buf, s.len())?;
+    buf.extend_from_slice(s.as_bytes());
+    Ok(())
+}
+
+struct Writer {
+    buf: Vec<u8>,
+    strings: Vec<JsString>,
+    string_ids: FxHashMap<JsString, u32>,
+}
+
+impl Writer {
+    fn new() -> Self {
+        Self {
+            buf: Vec::new(),
+            strings: Vec::new(),
+            string_ids: FxHashMap::default(),
+        }
+    }
+
+    fn write_u8(&mut self, v: u8) {
+        self.buf.push(v);
+    }
+
+    fn write_u32(&mut self, v: u32) {
+        self.buf.extend_from_slice(&v.to_le_bytes());
+    }
+
+    fn write_len(&mut self, len: usize) -> Result<(), JsError> {
+        write_len_raw(&mut self.buf, len)
+    }
+
+    fn write_usize(&mut self, v: usize) -> Result<(), JsError> {
+        self.write_len(v)
+    }
+
+    fn write_str(&mut self, s: &JsString) -> Result<(), JsError> {
+        let id = match self.string_ids.get(s) {
+            Some(id) => *id,
+            None => {
+                let id =
+                    u32::try_from(self.strings.len()).map_err(|_| invalid("too many strings"))?;
+                self.strings.push(s.cheap_clone());
+                self.string_ids.insert(s.cheap_clone(), id);
+                id
+            }
+        };
+        self.write_u32(id);
+        Ok(())
+    }
+
+    fn write_opt_str(&mut self, s: Option<&JsString>) -> Result<(), JsError> {
+        match s {
+            Some(s) => {
+                self.write_u8(1);
+                self.write_str(s)
+            }
+            None => {
+                self.write_u8(0);
+                Ok(())
+            }
+        }
+    }
+
+    fn write_strs(&mut self, strs: &[JsString]) -> Result<(), JsError> {
+        self.write_len(strs.len())?;
+        for s in strs {
+            self.write_str(s)?;
+        }
+        Ok(())
+    }
+
+    fn write_import(&mut self, import: &ImportDecl) -> Result<(), JsError> {
+        self.write_str(&import.specifier)?;
+        self.write_u8(import.resolve as u8);
+        self.write_len(import.bindings.len())?;
+        for binding in &import.bindings {
+            match binding {
+                ImportBindingDecl::Named { local, imported } => {
+                    self.write_u8(BINDING_NAMED);
+                    self.write_str(local)?;
+                    self.write_str(imported)?;
+                }
+                ImportBindingDecl::Default { local } => {
+                    self.write_u8(BINDING_DEFAULT);
+                    self.write_str(local)?;
+                }
+                ImportBindingDecl::Namespace { local } => {
+                    self.write_u8(BINDING_NAMESPACE);
+                    self.write_str(local)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
+    fn write_chunk(&mut self, chunk: &BytecodeChunk) -> Result<(), JsError> {
+        self.write_u8(chunk.register_count);
+        match &chunk.source_file {
+            Some(path) => {
+                self.write_u8(1);
+                let path = JsString::from(path.as_str());
+                self.write_str(&path)?;
+            }
+            None => self.write_u8(0),
+        }
+
+        match &chunk.function_info {
+            Some(info) => {
+                self.write_u8(1);
+                self.write_function_info(info)?;
+            }
+            None => self.write_u8(0),
+        }
+
+        self.write_len(chunk.code.len())?;
+        for op in &chunk.code {
+            op.serialize(&mut OpSerializer { out: &mut self.buf })
+                .map_err(|e| invalid(&e.0))?;
+        }
+
+        self.write_len(chunk.constants.len())?;
+        for constant in &chunk.constants {
+            self.write_constant(constant)?;
+        }
+
+        self.write_len(chunk.source_map.len())?;
+        for entry in &chunk.source_map {
+            self.write_usize(entry.bytecode_offset)?;
+            self.write_usize(entry.span.start)?;
+            self.write_usize(entry.span.end)?;
+            self.write_u32(entry.span.line);
+            self.write_u32(entry.span.column);
+        }
+        Ok(())
+    }
+
+    fn write_function_info(&mut self, info: &FunctionInfo) -> Result<(), JsError> {
+        self.write_opt_str(info.name.as_ref())?;
+        self.write_usize(info.param_count)?;
+        let mut flags = 0u8;
+        if info.is_generator {
+            flags |= FLAG_GENERATOR;
+        }
+        if info.is_async {
+            flags |= FLAG_ASYNC;
+        }
+        if info.is_arrow {
+            flags |= FLAG_ARROW;
+        }
+        if info.uses_arguments {
+            flags |= FLAG_USES_ARGUMENTS;
+        }
+        if info.uses_this {
+            flags |= FLAG_USES_THIS;
+        }
+        self.write_u8(flags);
+        self.write_strs(&info.param_names)?;
+        match info.rest_param {
+            Some(idx) => {
+                self.write_u8(1);
+                self.write_usize(idx)?;
+            }
+            None => self.write_u8(0),
+        }
+        self.write_usize(info.binding_count)
+    }
+
+    fn write_constant(&mut self, constant: &Constant) -> Result<(), JsError> {
+        match constant {
+            Constant::String(s) => {
+                self.write_u8(CONST_STRING);
+                self.write_str(s)
+            }
+            Constant::Number(n) => {
+                self.write_u8(CONST_NUMBER);
+                self.buf.extend_from_slice(&n.to_bits().to_le_bytes());
+                Ok(())
+            }
+            Constant::Chunk(chunk) => {
+                self.write_u8(CONST_CHUNK);
+                match &chunk.lazy {
+                    // Written compiled, leaving the stub itself uncompiled
+                    Some(lazy) => self.write_chunk(&*lazy.compile_detached(chunk)?),
+                    None => self.write_chunk(chunk),
+                }
+            }
+            Constant::RegExp { pattern, flags } => {
+                self.write_u8(CONST_REGEXP);
+                self.write_str(pattern)?;
+                self.write_str(flags)
+            }
+            Constant::TemplateStrings { cooked, raw } => {
+                self.write_u8(CONST_TEMPLATE);
+                self.write_strs(cooked)?;
+                self.write_strs(raw)
+            }
+            Constant::ExcludedKeys(keys) => {
+                self.write_u8(CONST_EXCLUDED_KEYS);
+                self.write_strs(keys)
+            }
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Reader
+// ═══════════════════════════════════════════════════════════════════════════════
+
+struct Reader<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+    strings: Vec<JsString>,
+    depth: usize,
+}
+
+impl<'a> Reader<'a> {
+    fn new(bytes: &'a [u8]) -> Self {
+        Self {
+            bytes,
+            pos: 0,
+            strings: Vec::new(),
+            depth: 0,
+        }
+    }
+
+    fn remaining(&self) -> usize {
+        self.bytes.len().saturating_sub(self.pos)
+    }
+
+    fn take(&mut self, n: usize) -> Result<&'a [u8], JsError> {
+        let end = self
+            .pos
+            .checked_add(n)
+            .ok_or_else(|| invalid("unexpected end of data"))?;
+        let slice = self
+            .bytes
+            .get(self.pos..end)
+            .ok_or_else(|| invalid("unexpected end of data"))?;
+        self.pos = end;
+        Ok(slice)
+    }
+
+    fn array<const N: usize>(&mut self) -> Result<[u8; N], JsError> {
+        let mut arr = [0u8; N];
+        arr.copy_from_slice(self.take(N)?);
+        Ok(arr)
+    }
+
+    fn read_u8(&mut self) -> Result<u8, JsError> {
+        Ok(self.array::<1>()?[0])
+    }
+
+    fn read_u32(&mut self) -> Result<u32, JsError> {
+        Ok(u32::from_le_bytes(self.array()?))
+    }
+
+    fn read_len(&mut self) -> Result<usize, JsError> {
+        Ok(self.read_u32()? as usize)
+    }
+
+    fn read_bool_tag(&mut self) -> Result<bool, JsError> {
+        match self.read_u8()? {
+            0 => Ok(false),
+            1 => Ok(true),
+            _ => Err(invalid("bad flag byte")),
+        }
+    }
+
+    fn read_raw_str(&mut self) -> Result<&'a str, JsError> {
+        let len = self.read_len()?;
+        core::str::from_utf8(self.take(len)?).map_err(|_| invalid("string is not UTF-8"))
+    }
+
+    fn read_str(&mut self) -> Result<JsString, JsError> {
+        let id = self.read_len()?;
+        self.strings
+            .get(id)
+            .map(|s| s.cheap_clone())
+            .ok_or_else(|| invalid("string index out of range"))
+    }
+
+    fn read_opt_str(&mut self) -> Result<Option<JsString>, JsError> {
+        if self.read_bool_tag()? {
+            Ok(Some(self.read_str()?))
+        } else {
+            Ok(None)
+        }
+    }
+
+    fn read_strs(&mut self) -> Result<Vec<JsString>, JsError> {
+        let count = self.read_len()?;
+        let mut strs = Vec::with_capacity(count.min(self.remaining()));
+        for _ in 0..count {
+            strs.push(self.read_str()?);
+        }
+        Ok(strs)
+    }
+
+    fn read_import(&mut self) -> Result<ImportDecl, JsError> {
+        let specifier = self.read_str()?;
+        let resolve = self.read_bool_tag()?;
+        let count = self.read_len()?;
+        let mut bindings = Vec::with_capacity(count.min(self.remaining()));
+        for _ in 0..count {
+            let binding = match self.read_u8()? {
+                BINDING_NAMED => ImportBindingDecl::Named {
+                    local: self.read_str()?,
+                    imported: self.read_str()?,
+                },
+                BINDING_DEFAULT => ImportBindingDecl::Default {
+                    local: self.read_str()?,
+                },
+                BINDING_NAMESPACE => ImportBindingDecl::Namespace {
+                    local: self.read_str()?,
+                },
+                _ => return Err(invalid("bad import binding tag")),
+            };
+            bindings.push(binding);
+        }
+        Ok(ImportDecl {
+            specifier,
+            resolve,
+            bindings,
+        })
+    }
+
+    fn read_chunk(&mut self) -> Result<BytecodeChunk, JsError> {
+        if self.depth >= MAX_CHUNK_DEPTH {
+            return Err(invalid("functions nested too deeply"));
+        }
+        self.depth += 1;
+        let chunk = self.read_chunk_body();
+        self.depth -= 1;
+        chunk
+    }
+
+    fn read_chunk_body(&mut self) -> Result<BytecodeChunk, JsError> {
+        let register_count = self.read_u8()?;
+        let source_file = if self.read_bool_tag()? {
+            Some(self.read_str()?.to_string())
+        } else {
+            None
+        };
+        let function_info = if self.read_bool_tag()? {
+            Some(self.read_function_info()?)
+        } else {
+            None
+        };
+
+        let op_count = self.read_len()?;
+        let mut code = Vec::with_capacity(op_count.min(self.remaining()));
+        let mut operands = Vec::new();
+        for _ in 0..op_count {
+            let mut de = OpDeserializer {
+                reader: self,
+                operands: &mut operands,
+                field: "",
+            };
+            let op = <Op as serde::Deserialize>::deserialize(&mut de).map_err(|e| invalid(&e.0))?;
+            code.push(op);
+        }
+
+        let const_count = self.read_len()?;
+        let mut constants = Vec::with_capacity(const_count.min(self.remaining()));
+        for _ in 0..const_count {
+            constants.push(self.read_constant()?);
+        }
+        check_operands(&operands, register_count, code.len(), constants.len())?;
+
+        let map_count = self.read_len()?;
+        let mut source_map = Vec::with_capacity(map_count.min(self.remaining()));
+        for _ in 0..map_count {
+            let bytecode_offset = self.read_len()?;
+            let start = self.read_len()?;
+            let end = self.read_len()?;
+            let line = self.read_u32()?;
+            let column = self.read_u32()?;
+            source_map.push(SourceMapEntry {
+                bytecode_offset,
+                span: Span::new(start, end, line, column),
+            });
+        }
+
+        Ok(BytecodeChunk {
+            inline_caches: InlineCaches::new(BytecodeChunk::cache_site_count(&code)),
+            code,
+            constants,
+            source_map,
+            register_count,
+            function_info,
+            source_file,
+            lazy: None,
+        })
+    }
+
+    fn read_function_info(&mut self) -> Result<FunctionInfo, JsError> {
+        let name = self.read_opt_str()?;
+        let param_count = self.read_len()?;
+        let flags = self.read_u8()?;
+        let param_names = self.read_strs()?;
+        let rest_param = if self.read_bool_tag()? {
+            Some(self.read_len()?)
+        } else {
+            None
+        };
+        let binding_count = self.read_len()?;
+        Ok(FunctionInfo {
+            name,
+            param_count,
+            is_generator: flags & FLAG_GENERATOR != 0,
+            is_async: flags & FLAG_ASYNC != 0,
+            is_arrow: flags & FLAG_ARROW != 0,
+            uses_arguments: flags & FLAG_USES_ARGUMENTS != 0,
+            uses_this: flags & FLAG_USES_THIS != 0,
+            param_names,
+            rest_param,
+            binding_count,
+        })
+    }
+
+    fn read_constant(&mut self) -> Result<Constant, JsError> {
+        match self.read_u8()? {
+            CONST_STRING => Ok(Constant::String(self.read_str()?)),
+            CONST_NUMBER => Ok(Constant::Number(f64::from_bits(u64::from_le_bytes(
+                self.array()?,
+            )))),
+            CONST_CHUNK => Ok(Constant::Chunk(Rc::new(self.read_chunk()?))),
+            CONST_REGEXP => Ok(Constant::RegExp {
+                pattern: self.read_str()?,
+                flags: self.read_str()?,
+            }),
+            CONST_TEMPLATE => Ok(Constant::TemplateStrings {
+                cooked: self.read_strs()?,
+                raw: self.read_strs()?,
+            }),
+            CONST_EXCLUDED_KEYS => Ok(Constant::ExcludedKeys(self.read_strs()?)),
+            _ => Err(invalid("bad constant tag")),
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Operand validation
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// An instruction operand that must be checked against its chunk
+#[derive(Clone, Copy)]
+enum Operand {
+    Register(u8),
+    /// `count` consecutive registers from `start` (call arguments, array elements)
+    Registers {
+        start: u8,
+        count: u16,
+    },
+    Constant(u16),
+    Jump(u32),
+}
+
+/// What an integer `Op` field refers to, by field name
+#[derive(Clone, Copy, PartialEq)]
+enum OperandKind {
+    Register,
+    RangeStart,
+    RangeCount,
+    Constant,
+    Jump,
+    Plain,
+}
+
+fn operand_kind(field: &str, width: u8) -> OperandKind {
+    match (width, field) {
+        (1, "args_start" | "exprs_start" | "start") => OperandKind::RangeStart,
+        (1 | 2, "argc" | "exprs_count" | "count") => OperandKind::RangeCount,
+        (1, "flags" | "kind" | "param_index" | "start_index" | "try_depth") => OperandKind::Plain,
+        (1, _) => OperandKind::Register,
+        (2, "cache") => OperandKind::Plain,
+        (2, _) => OperandKind::Constant,
+        (4, "class_brand" | "line" | "column") => OperandKind::Plain,
+        (4, _) => OperandKind::Jump,
+        _ => OperandKind::Plain,
+    }
+}
+
+fn check_operands(
+    operands: &[Operand],
+    register_count: u8,
+    code_len: usize,
+    const_count: usize,
+) -> Result<(), JsError> {
+    // The VM always allocates at least one register
+    let registers = usize::from(register_count).max(1);
+    for operand in operands {
+        let ok = match *operand {
+            Operand::Register(r) => usize::from(r) < registers,
+            Operand::Registers { start, count } => {
+                count == 0 || usize::from(start) + usize::from(count) <= registers
+            }
+            Operand::Constant(idx) => usize::from(idx) < const_count,
+            // Jumping to the end finishes the chunk
+            Operand::Jump(target) => target as usize <= code_len,
+        };
+        if !ok {
+            return Err(invalid(match operand {
+                Operand::Register(_) | Operand::Registers { .. } => "register out of range",
+                Operand::Constant(_) => "constant index out of range",
+                Operand::Jump(_) => "jump target out of range",
+            }));
+        }
+    }
+    Ok(())
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Op codec (serde)
+// ═══════════════════════════════════════════════════════════════════════════════
+//
+// A minimal non-self-describing format covering exactly what `Op` needs:
+// unit and struct variants whose fields are bool, u8, u16, u32 or i32.
+
+#[derive(Debug)]
+struct CodecError(String);
+
+impl fmt::Display for CodecError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(&self.0)
+    }
+}
+
+impl ser::StdError for CodecError {}
+
+impl ser::Error for CodecError {
+    fn custom<T: fmt::Display>(msg: T) -> Self {
+        CodecError(msg.to_string())
+    }
+}
+
+impl de::Error for CodecError {
+    fn custom<T: fmt::Display>(msg: T) -> Self {
+        CodecError(msg.to_string())
+    }
+}
+
+fn unsupported<T>(what: &str) -> Result<T, CodecError> {
+    Err(CodecError(format!("unsupported {} in instruction", what)))
+}
+
+struct OpSerializer<'a> {
+    out: &'a mut Vec<u8>,
+}
+
+impl OpSerializer<'_> {
+    fn variant(&mut self, index: u32) -> Result<(), CodecError> {
+        let index = u8::try_from(index).map_err(|_| CodecError("too many variants".into()))?;
+        self.out.push(index);
+        Ok(())
+    }
+}
+
+impl<'a, 'b> ser::Serializer for &'a mut OpSerializer<'b> {
+    type Ok = ();
+    type Error = CodecError;
+    type SerializeSeq = Impossible<(), CodecError>;
+    type SerializeTuple = Impossible<(), CodecError>;
+    type SerializeTupleStruct = Impossible<(), CodecError>;
+    type SerializeTupleVariant = Impossible<(), CodecError>;
+    type SerializeMap = Impossible<(), CodecError>;
+    type SerializeStruct = Impossible<(), CodecError>;
+    type SerializeStructVariant = Self;
+
+    fn serialize_bool(self, v: bool) -> Result<(), CodecError> {
+        self.out.push(v as u8);
+        Ok(())
+    }
+    fn serialize_u8(self, v: u8) -> Result<(), CodecError> {
+        self.out.push(v);
+        Ok(())
+    }
+    fn serialize_u16(self, v: u16) -> Result<(), CodecError> {
+        self.out.extend_from_slice(&v.to_le_bytes());
+        Ok(())
+    }
+    fn serialize_u32(self, v: u32) -> Result<(), CodecError> {
+        self.out.extend_from_slice(&v.to_le_bytes());
+        Ok(())
+    }
+    fn serialize_i32(self, v: i32) -> Result<(), CodecError> {
+        self.out.extend_from_slice(&v.to_le_bytes());
+        Ok(())
+    }
+    fn serialize_unit_variant(
+        self,
+        _name: &'static str,
+        variant_index: u32,
+        _variant: &'static str,
+    ) -> Result<(), CodecError> {
+        self.variant(variant_index)
+    }
+    fn serialize_struct_variant(
+        self,
+        _name: &'static str,
+        variant_index: u32,
+        _variant: &'static str,
+        _len: usize,
+    ) -> Result<Self, CodecError> {
+        self.variant(variant_index)?;
+        Ok(self)
+    }
+
+    fn serialize_i8(self, _v: i8) -> Result<(), CodecError> {
+        unsupported("i8")
+    }
+    fn serialize_i16(self, _v: i16) -> Result<(), CodecError> {
+        unsupported("i16")
+    }
+    fn serialize_i64(self, _v: i64) -> Result<(), CodecError> {
+        unsupported("i64")
+    }
+    fn serialize_u64(self, _v: u64) -> Result<(), CodecError> {
+        unsupported("u64")
+    }
+    fn serialize_f32(self, _v: f32) -> Result<(), CodecError> {
+        unsupported("f32")
+    }
+    fn serialize_f64(self, _v: f64) -> Result<(), CodecError> {
+        unsupported("f64")
+    }
+    fn serialize_char(self, _v: char) -> Result<(), CodecError> {
+        unsupported("char")
+    }
+    fn serialize_str(self, _v: &str) -> Result<(), CodecError> {
+        unsupported("str")
+    }
+    fn serialize_bytes(self, _v: &[u8]) -> Result<(), CodecError> {
+        unsupported("bytes")
+    }
+    fn serialize_none(self) -> Result<(), CodecError> {
+        unsupported("option")
+    }
+    fn serialize_some<T: ?Sized + Serialize>(self, _value: &T) -> Result<(), CodecError> {
+        unsupported("option")
+    }
+    fn serialize_unit(self) -> Result<(), CodecError> {
+        unsupported("unit")
+    }
+    fn serialize_unit_struct(self, _name: &'static str) -> Result<(), CodecError> {
+        unsupported("unit struct")
+    }
+    fn serialize_newtype_struct<T: ?Sized + Serialize>(
+        self,
+        _name: &'static str,
+        _value: &T,
+    ) -> Result<(), CodecError> {
+        unsupported("newtype struct")
+    }
+    fn serialize_newtype_variant<T: ?Sized + Serialize>(
+        self,
+        _name: &'static str,
+        _variant_index: u32,
+        _variant: &'static str,
+        _value: &T,
+    ) -> Result<(), CodecError> {
+        unsupported("newtype variant")
+    }
+    fn serialize_seq(self, _len: Option<usize>) -> Result<Self::SerializeSeq, CodecError> {
+        unsupported("sequence")
+    }
+    fn serialize_tuple(self, _len: usize) -> Result<Self::SerializeTuple, CodecError> {
+        unsupported("tuple")
+    }
+    fn serialize_tuple_struct(
+        self,
+        _name: &'static str,
+        _len: usize,
+    ) -> Result<Self::SerializeTupleStruct, CodecError> {
+        unsupported("tuple struct")
+    }
+    fn serialize_tuple_variant(
+        self,
+        _name: &'static str,
+        _variant_index: u32,
+        _variant: &'static str,
+        _len: usize,
+    ) -> Result<Self::SerializeTupleVariant, CodecError> {
+        unsupported("tuple variant")
+    }
+    fn serialize_map(self, _len: Option<usize>) -> Result<Self::SerializeMap, CodecError> {
+        unsupported("map")
+    }
+    fn serialize_struct(
+        self,
+        _name: &'static str,
+        _len: usize,
+    ) -> Result<Self::SerializeStruct, CodecError> {
+        unsupported("struct")
+    }
+    fn collect_str<T: ?Sized + fmt::Display>(self, _value: &T) -> Result<(), CodecError> {
+        unsupported("str")
+    }
+}
+
+impl<'a, 'b> ser::SerializeStructVariant for &'a mut OpSerializer<'b> {
+    type Ok = ();
+    type Error = CodecError;
+
+    fn serialize_field<T: ?Sized + Serialize>(
+        &mut self,
+        _key: &'static str,
+        value: &T,
+    ) -> Result<(), CodecError> {
+        value.serialize(&mut **self)
+    }
+
+    fn end(self) -> Result<(), CodecError> {
+        Ok(())
+    }
+}
+
+struct OpDeserializer<'r, 'a> {
+    reader: &'r mut Reader<'a>,
+    operands: &'r mut Vec<Operand>,
+    /// Name of the struct variant field being decoded
+    field: &'static str,
+}
+
+impl OpDeserializer<'_, '_> {
+    fn bytes<const N: usize>(&mut self) -> Result<[u8; N], CodecError> {
+        self.reader
+            .array::<N>()
+            .map_err(|_| CodecError("unexpected end of instruction".into()))
+    }
+
+    fn record(&mut self, value: u32, width: u8) {
+        let operand = match operand_kind(self.field, width) {
+            OperandKind::Register => Operand::Register(value as u8),
+            OperandKind::RangeStart => Operand::Registers {
+                start: value as u8,
+                count: 0,
+            },
+            OperandKind::RangeCount => {
+                // Counts follow their start register in every `Op` variant
+                if let Some(Operand::Registers { count, .. }) = self.operands.last_mut() {
+                    *count = value as u16;
+                }
+                return;
+            }
+            OperandKind::Constant => Operand::Constant(value as u16),
+            OperandKind::Jump => Operand::Jump(value),
+            OperandKind::Plain => return,
+        };
+        self.operands.push(operand);
+    }
+}
+
+impl<'de> de::Deserializer<'de> for &mut OpDeserializer<'_, '_> {
+    type Error = CodecError;
+
+    fn deserialize_any<V: Visitor<'de>>(self, _visitor: V) -> Result<V::Value, CodecError> {
+        unsupported("self-describing value")
+    }
+
+    fn deserialize_bool<V: Visitor<'de>>(self, visitor: V) -> Result<V::Value, CodecError> {
+        match self.bytes::<1>()? {
+            [0] => visitor.visit_bool(false),
+            [1] => visitor.visit_bool(true),
+            _ => Err(CodecError("bad boolean".into())),
+        }
+    }
+
+    fn deserialize_u8<V: Visitor<'de>>(self, visitor: V) -> Result<V::Value, CodecError> {
+        let [v] = self.bytes::<1>()?;
+        self.record(u32::from(v), 1);
+        visitor.visit_u8(v)
+    }
+
+    fn deserialize_u16<V: Visitor<'de>>(self, visitor: V) -> Result<V::Value, CodecError> {
+        let v = u16::from_le_bytes(self.bytes()?);
+        self.record(u32::from(v), 2);
+        visitor.visit_u16(v)
+    }
+
+    fn deserialize_u32<V: Visitor<'de>>(self, visitor: V) -> Result<V::Value, CodecError> {
+        let v = u32::from_le_bytes(self.bytes()?);
+        self.record(v, 4);
+        visitor.visit_u32(v)
+    }
+
+    fn deserialize_i32<V: Visitor<'de>>(self, visitor: V) -> Result<V::Value, CodecError> {
+        visitor.visit_i32(i32::from_le_bytes(self.bytes()?))
+    }
+
+    fn deserialize_enum<V: Visitor<'de>>(
+        self,
+        _name: &'static str,
+        _variants: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, CodecError> {
+        visitor.visit_enum(self)
+    }
+
+    serde::forward_to_deserialize_any! {
+        i8 i16 i64 i128 u64 u128 f32 f64 char str string bytes byte_buf option unit
+        unit_struct newtype_struct seq tuple tuple_struct map struct identifier
+        ignored_any
+    }
+}
+
+impl<'de> de::EnumAccess<'de> for &mut OpDeserializer<'_, '_> {
+    type Error = CodecError;
+    type Variant = Self;
+
+    fn variant_seed<V: DeserializeSeed<'de>>(
+        self,
+        seed: V,
+    ) -> Result<(V::Value, Self), CodecError> {
+        let [index] = self.bytes::<1>()?;
+        let value = seed.deserialize(IntoDeserializer::<CodecError>::into_deserializer(
+            index as u32,
+        ))?;
+        Ok((value, self))
+    }
+}
+
+impl<'de> de::VariantAccess<'de> for &mut OpDeserializer<'_, '_> {
+    type Error = CodecError;
+
+    fn unit_variant(self) -> Result<(), CodecError> {
+        Ok(())
+    }
+
+    fn newtype_variant_seed<T: DeserializeSeed<'de>>(
+        self,
+        _seed: T,
+    ) -> Result<T::Value, CodecError> {
+        unsupported("newtype variant")
+    }
+
+    fn tuple_variant<V: Visitor<'de>>(
+        self,
+        _len: usize,
+        _visitor: V,
+    ) -> Result<V::Value, CodecError> {
+        unsupported("tuple variant")
+    }
+
+    fn struct_variant<V: Visitor<'de>>(
+        self,
+        fields: &'static [&'static str],
+        visitor: V,
+    ) -> Result<V::Value, CodecError> {
+        visitor.visit_seq(FieldAccess { de: self, fields })
+    }
+}
+
+struct FieldAccess<'d, 'r, 'a> {
+    de: &'d mut OpDeserializer<'r, 'a>,
+    /// Fields not yet decoded
+    fields: &'static [&'static str],
+}
+
+impl<'de> SeqAccess<'de> for FieldAccess<'_, '_, '_> {
+    type Error = CodecError;
+
+    fn next_element_seed<T: DeserializeSeed<'de>>(
+        &mut self,
+        seed: T,
+    ) -> Result<Option<T::Value>, CodecError> {
+        let Some((field, rest)) = self.fields.split_first() else {
+            return Ok(None);
+        };
+        self.fields = rest;
+        self.de.field = field;
+        seed.deserialize(&mut *self.de).map(Some)
+    }
+
+    fn size_hint(&self) -> Option<usize> {
+        Some(self.fields.len())
+    }
+}
@@ -9,11 +9,12 @@ use alloc::vec::Vec;
 use core::ffi::{c_char, c_void};
 use core::ptr;
 
-use crate::{ModulePath, StepResult};
+use crate::{JsValue, ModulePath, StepResult};
 
 use super::{
-    TsRunContext, TsRunImportRequest, TsRunOrder, TsRunResult, TsRunStepResult, TsRunStepStatus,
-    TsRunValue, c_str_to_str, console::FfiConsoleProvider, str_to_c_string,
+    TsRunBytecodeResult, TsRunContext, TsRunImportRequest, TsRunOrder, TsRunResult, TsRunSnapshot,
+    TsRunSnapshotResult, TsRunStepResult, TsRunStepStatus, TsRunValue, c_str_to_str,
+    console::FfiConsoleProvider, str_to_c_string,
 };
 
 // ============================================================================
@@ -50,6 +51,88 @@ pub extern "C" fn tsrun_free(ctx: *mut TsRunContext) {
     }
 }
 
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+/// Capture an idle context for fast creation of new contexts.
+///
+/// The context must not be mid-execution (no active VM, pending imports or
+/// orders). Free the snapshot with tsrun_snapshot_free.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_context_snapshot(ctx: *mut TsRunContext) -> TsRunSnapshotResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunSnapshotResult {
+                snapshot: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    ctx.clear_error();
+
+    match ctx.interp.snapshot() {
+        Ok(snapshot) => TsRunSnapshotResult {
+            snapshot: Box::into_raw(Box::new(TsRunSnapshot {
+                snapshot,
+                native_callbacks: ctx.native_callbacks.clone(),
+                typed_callbacks: ctx.typed_callbacks.clone(),
+                next_ffi_id: ctx.next_ffi_id,
+                console_callback: ctx.console_callback,
+            })),
+            error: ptr::null(),
+        },
+        Err(e) => TsRunSnapshotResult {
+            snapshot: ptr::null_mut(),
+            error: ctx.set_error(e.to_string()),
+        },
+    }
+}
+
+/// Create a new context from a snapshot.
+///
+/// The new context starts with the snapshot's globals, internal modules,
+/// loaded modules, native callbacks and console callback. Returns NULL on failure.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_new_from_snapshot(snapshot: *const TsRunSnapshot) -> *mut TsRunContext {
+    let snapshot = match unsafe { snapshot.as_ref() } {
+        Some(s) => s,
+        None => return ptr::null_mut(),
+    };
+
+    let Ok(interp) = snapshot.snapshot.instantiate() else {
+        return ptr::null_mut();
+    };
+
+    let mut ctx = Box::new(TsRunContext::new_with_interpreter(interp));
+    ctx.native_callbacks = snapshot.native_callbacks.clone();
+    ctx.typed_callbacks = snapshot.typed_callbacks.clone();
+    ctx.next_ffi_id = snapshot.next_ffi_id;
+    ctx.console_callback = snapshot.console_callback;
+    let ctx_ptr = Box::into_raw(ctx);
+
+    // Console output goes through the context, as in tsrun_new
+    let ctx_ref = unsafe { &mut *ctx_ptr };
+    let provider = FfiConsoleProvider::new(ctx_ptr as *mut c_void);
+    ctx_ref.interp.set_console(Box::new(provider));
+
+    ctx_ptr
+}
+
+/// Free a snapshot.
+///
+/// Contexts created from the snapshot remain valid.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_snapshot_free(snapshot: *mut TsRunSnapshot) {
+    if !snapshot.is_null() {
+        unsafe {
+            drop(Box::from_raw(snapshot));
+        }
+    }
+}
+
 // ============================================================================
 // Execution
 // ============================================================================
@@ -88,6 +171,97 @@ pub extern "C" fn tsrun_prepare(
     }
 }
 
+/// Prepare precompiled bytecode for execution.
+///
+/// `data`/`len` must hold a blob from tsrun_compile_to_bytecode produced by the
+/// same tsrun version. The blob is decoded immediately and may be freed or
+/// unmapped once this returns. `path` is used as with tsrun_prepare.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_prepare_bytecode(
+    ctx: *mut TsRunContext,
+    data: *const u8,
+    len: usize,
+    path: *const c_char,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    ctx.clear_error();
+
+    if data.is_null() {
+        return TsRunResult::err(ctx, "NULL bytecode".to_string());
+    }
+    // SAFETY: Caller guarantees data points to len readable bytes
+    let bytes = unsafe { core::slice::from_raw_parts(data, len) };
+
+    let module_path = unsafe { c_str_to_str(path) }.map(|p| ModulePath::new(p.to_string()));
+
+    match ctx.interp.prepare_bytecode(bytes, module_path) {
+        Ok(_) => TsRunResult::success(),
+        Err(e) => TsRunResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Compile code to a serialized bytecode blob without running it.
+///
+/// `path` is recorded for stack traces and should match the path later passed to
+/// tsrun_prepare_bytecode or tsrun_provide_module_bytecode. Free the returned
+/// data with tsrun_bytecode_free.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_compile_to_bytecode(
+    ctx: *mut TsRunContext,
+    code: *const c_char,
+    path: *const c_char,
+) -> TsRunBytecodeResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunBytecodeResult {
+                data: ptr::null_mut(),
+                len: 0,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    ctx.clear_error();
+
+    let code_str = match unsafe { c_str_to_str(code) } {
+        Some(s) => s,
+        None => return TsRunBytecodeResult::err(ctx, "Invalid or NULL code string".to_string()),
+    };
+
+    let module_path = unsafe { c_str_to_str(path) }.map(|p| ModulePath::new(p.to_string()));
+
+    match ctx
+        .interp
+        .compile_to_bytecode(code_str, module_path.as_ref())
+    {
+        Ok(bytes) => TsRunBytecodeResult::ok(bytes),
+        Err(e) => TsRunBytecodeResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Free a bytecode blob returned by tsrun_compile_to_bytecode.
+///
+/// # Safety
+/// `data` must be a pointer returned by tsrun_compile_to_bytecode (or NULL), and
+/// `len` must match the length returned with it.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn tsrun_bytecode_free(data: *mut u8, len: usize) {
+    if !data.is_null() {
+        // SAFETY: data/len came from a boxed slice in TsRunBytecodeResult::ok
+        unsafe { drop(Box::from_raw(ptr::slice_from_raw_parts_mut(data, len))) };
+    }
+}
+
 /// Execute one step.
 ///
 /// The result is written to `out` which must point to valid memory for TsRunStepResult.
@@ -167,7 +341,7 @@ pub extern "C" fn tsrun_run(out: *mut TsRunStepResult, ctx: *mut TsRunContext) {
     ctx_ref.interp.ffi_context = ctx as *mut c_void;
 
     let result = loop {
-        match ctx_ref.interp.step() {
+        match ctx_ref.interp.run_steps(usize::MAX) {
             Ok(StepResult::Continue) => continue,
             Ok(step_result) => {
                 break convert_step_result(ctx_ref, step_result);
@@ -226,12 +400,18 @@ pub extern "C" fn tsrun_step_result_free(result: *mut TsRunStepResult) {
         result.imports = ptr::null_mut();
         result.import_count = 0;
 
-        // Free pending orders array (but NOT the payload values - they're owned by context)
+        // Free pending orders array and their JSON payloads (but NOT the payload
+        // values - they're owned by context)
         // Use Box::from_raw with slice to match how we allocated (via into_boxed_slice)
         if !result.pending_orders.is_null() && result.pending_count > 0 {
             let slice_ptr =
                 core::ptr::slice_from_raw_parts_mut(result.pending_orders, result.pending_count);
-            drop(Box::from_raw(slice_ptr));
+            let orders = Box::from_raw(slice_ptr);
+            for order in orders.iter() {
+                if !order.payload_json.is_null() {
+                    drop(CString::from_raw(order.payload_json as *mut c_char));
+                }
+            }
         }
         result.pending_orders = ptr::null_mut();
         result.pending_count = 0;
@@ -250,11 +430,85 @@ pub extern "C" fn tsrun_step_result_free(result: *mut TsRunStepResult) {
     }
 }
 
+/// Run like tsrun_run, but stop after `max_instructions` bytecode instructions
+/// or `timeout_ns` nanoseconds of wall-clock time (0 = no limit for either).
+///
+/// Returns TSRUN_STEP_BUDGET_EXHAUSTED when the budget runs out first; call
+/// again (or tsrun_run) to resume. The clock is read every 1024 instructions.
+/// Callbacks run by builtins (map/sort callbacks, getters) and imported module
+/// bodies cannot be suspended: if the deadline passes inside one, the script
+/// stops with "RangeError: Time limit exceeded", which JS code cannot catch.
+/// The result is written to `out` which must point to valid memory for TsRunStepResult.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_run_budget(
+    out: *mut TsRunStepResult,
+    ctx: *mut TsRunContext,
+    max_instructions: u64,
+    timeout_ns: u64,
+) {
+    if out.is_null() {
+        return;
+    }
+
+    if ctx.is_null() {
+        unsafe {
+            ptr::write(
+                out,
+                TsRunStepResult {
+                    status: TsRunStepStatus::Error,
+                    error: c"NULL context".as_ptr(),
+                    ..Default::default()
+                },
+            );
+        }
+        return;
+    }
+
+    let ctx_ref = unsafe { &mut *ctx };
+    ctx_ref.clear_error();
+
+    // Set FFI context pointer in interpreter for native callbacks
+    ctx_ref.interp.ffi_context = ctx as *mut c_void;
+
+    let result = match ctx_ref.interp.run_budget(max_instructions, timeout_ns) {
+        Ok(StepResult::Continue) => TsRunStepResult {
+            status: TsRunStepStatus::BudgetExhausted,
+            ..Default::default()
+        },
+        Ok(step_result) => convert_step_result(ctx_ref, step_result),
+        Err(e) => TsRunStepResult {
+            status: TsRunStepStatus::Error,
+            error: ctx_ref.set_error(e.to_string()),
+            ..Default::default()
+        },
+    };
+
+    // Clear FFI context after stepping
+    ctx_ref.interp.ffi_context = ptr::null_mut();
+
+    // Write result to output pointer
+    unsafe {
+        ptr::write(out, result);
+    }
+}
+
+/// Cap the heap at `max_objects` live GC objects (0 = unlimited, the default).
+///
+/// This is an object count, not a byte limit: ArrayBuffer backing stores and
+/// string contents are not counted. A script that needs more objects stops
+/// with "RangeError: Object limit exceeded", which JS code cannot catch.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_set_object_limit(ctx: *mut TsRunContext, max_objects: usize) {
+    if let Some(ctx) = unsafe { ctx.as_mut() } {
+        ctx.interp.set_object_limit(max_objects);
+    }
+}
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
 
-fn convert_step_result(_ctx: &mut TsRunContext, result: StepResult) -> TsRunStepResult {
+fn convert_step_result(ctx: &mut TsRunContext, result: StepResult) -> TsRunStepResult {
     match result {
         StepResult::Continue => TsRunStepResult {
             status: TsRunStepStatus::Continue,
@@ -307,10 +561,7 @@ fn convert_step_result(_ctx: &mut TsRunContext, result: StepResult) -> TsRunStep
             } else {
                 let c_orders: Vec<TsRunOrder> = pending
                     .into_iter()
-                    .map(|order| TsRunOrder {
-                        id: order.id.0,
-                        payload: Box::into_raw(TsRunValue::from_runtime_value(order.payload)),
-                    })
+                    .map(|order| convert_order(ctx.order_payload_json, order))
                     .collect();
                 let count = c_orders.len();
                 let boxed = c_orders.into_boxed_slice();
@@ -341,3 +592,45 @@ fn convert_step_result(_ctx: &mut TsRunContext, result: StepResult) -> TsRunStep
         }
     }
 }
+
+/// Convert a pending order, serializing its payload when JSON delivery is on.
+///
+/// Falls back to a value handle if the payload cannot be serialized (e.g. it
+/// contains a circular reference).
+fn convert_order(payload_json: bool, order: crate::Order) -> TsRunOrder {
+    let id = order.id.0;
+    if payload_json {
+        if matches!(order.payload.value(), JsValue::Undefined) {
+            return TsRunOrder {
+                id,
+                payload: ptr::null_mut(),
+                payload_json: ptr::null(),
+                payload_json_len: 0,
+            };
+        }
+        let mut json = Vec::new();
+        let written = crate::json_stringify_to(order.payload.value(), |chunk| {
+            json.extend_from_slice(chunk.as_bytes());
+            Ok(())
+        });
+        let json_len = json.len();
+        // JSON output escapes NUL inside strings, so CString::new cannot fail
+        // on a successful serialization
+        if written.is_ok()
+            && let Ok(c_json) = CString::new(json)
+        {
+            return TsRunOrder {
+                id,
+                payload: ptr::null_mut(),
+                payload_json: c_json.into_raw(),
+                payload_json_len: json_len,
+            };
+        }
+    }
+    TsRunOrder {
+        id,
+        payload: Box::into_raw(TsRunValue::from_runtime_value(order.payload)),
+        payload_json: ptr::null(),
+        payload_json_len: 0,
+    }
+}
@@ -6,13 +6,25 @@
 //! # Thread Safety
 //!
 //! This library is NOT thread-safe. Use one `TsRunContext` per thread.
+//! The exception is `tsrun_compile_module()`, which uses no context and may be
+//! called from any thread; its `TsRunCompiledModule` may be moved between threads.
+//! `TsRunPool` (std builds) owns one context per worker thread; its functions
+//! may be called from any thread.
 //!
 //! # Memory Management
 //!
 //! - `TsRunContext`: Created by `tsrun_new()`, freed by `tsrun_free()`
 //! - `TsRunValue`: Created by various functions, freed by `tsrun_value_free()`
+//! - `TsRunKey`: Created by `tsrun_key_intern()`, freed by `tsrun_key_free()`
+//! - `TsRunSnapshot`: Created by `tsrun_context_snapshot()`, freed by `tsrun_snapshot_free()`
+//! - `TsRunJsonParser`: Created by `tsrun_json_parser_new()`, freed by `tsrun_json_parser_finish()`
+//!   or `tsrun_json_parser_free()`
+//! - `TsRunCompiledModule`: Created by `tsrun_compile_module()`, consumed by
+//!   `tsrun_provide_compiled_module()` or freed by `tsrun_compiled_module_free()`
+//! - `TsRunPool`: Created by `tsrun_pool_new()`, freed by `tsrun_pool_free()`
 //! - Error strings: Valid until the next tsrun_* call on the same context
 //! - Allocated strings (from `tsrun_json_stringify`): Freed by `tsrun_free_string()`
+//! - Encoded value buffers (from `tsrun_encode_value`): Freed by `tsrun_buffer_free()`
 
 extern crate alloc;
 
@@ -21,6 +33,9 @@ mod context;
 mod module;
 mod native;
 mod order;
+#[cfg(feature = "std")]
+mod pool;
+mod profiler;
 mod regexp;
 mod value;
 
@@ -33,8 +48,8 @@ use core::ptr;
 
 use crate::prelude::FxHashMap;
 
-use crate::value::CheapClone;
-use crate::{Interpreter, JsValue, RuntimeValue};
+use crate::value::{CheapClone, PropertyKey};
+use crate::{Interpreter, InterpreterSnapshot, JsValue, RuntimeValue};
 
 // ============================================================================
 // Version
@@ -62,20 +77,30 @@ pub struct TsRunContext {
     pub(crate) interp: Interpreter,
     pub(crate) last_error: Option<CString>,
     pub(crate) native_callbacks: FxHashMap<usize, NativeCallbackWrapper>,
+    /// Typed native functions, keyed by the same FFI IDs
+    pub(crate) typed_callbacks: FxHashMap<usize, TypedCallbackWrapper>,
     /// Counter for generating unique FFI callback IDs
     pub(crate) next_ffi_id: usize,
     /// Console callback (None = no-op)
     pub(crate) console_callback: Option<ConsoleCallbackWrapper>,
+    /// Deliver order payloads as JSON text instead of value handles
+    pub(crate) order_payload_json: bool,
 }
 
 impl TsRunContext {
     pub(crate) fn new() -> Self {
+        Self::new_with_interpreter(Interpreter::new())
+    }
+
+    pub(crate) fn new_with_interpreter(interp: Interpreter) -> Self {
         Self {
-            interp: Interpreter::new(),
+            interp,
             last_error: None,
             native_callbacks: FxHashMap::default(),
+            typed_callbacks: FxHashMap::default(),
             next_ffi_id: 1, // Start at 1 so 0 means "not an FFI callback"
             console_callback: None,
+            order_payload_json: false,
         }
     }
 
@@ -136,12 +161,58 @@ impl TsRunValue {
     }
 }
 
+/// Opaque interned property key.
+///
+/// Holds a `PropertyKey` built from a string interned in the context's
+/// `StringDict`, so repeated property access with the same key performs
+/// no allocation or UTF-8 validation.
+pub struct TsRunKey {
+    pub(crate) key: PropertyKey,
+}
+
+/// Opaque snapshot of an idle context.
+///
+/// Holds a copy of the context's heap plus its native callback registry and
+/// console callback, so contexts created from it behave like the original.
+pub struct TsRunSnapshot {
+    pub(crate) snapshot: InterpreterSnapshot,
+    pub(crate) native_callbacks: FxHashMap<usize, NativeCallbackWrapper>,
+    pub(crate) typed_callbacks: FxHashMap<usize, TypedCallbackWrapper>,
+    pub(crate) next_ffi_id: usize,
+    pub(crate) console_callback: Option<ConsoleCallbackWrapper>,
+}
+
+/// Opaque incremental JSON parser.
+///
+/// Values built so far are guarded by the parser itself, so it must be
+/// finished or freed before its context is freed.
+pub struct TsRunJsonParser {
+    pub(crate) parser: crate::JsonStreamParser,
+}
+
+/// Opaque module compiled by tsrun_compile_module.
+///
+/// Created without a context, so a failed compile keeps its error message
+/// here instead of in a context's error slot.
+pub struct TsRunCompiledModule {
+    pub(crate) result: Result<crate::compiler::CompiledModule, CString>,
+}
+
 /// Native callback wrapper storing C function pointer and userdata.
+#[derive(Clone, Copy)]
 pub(crate) struct NativeCallbackWrapper {
     pub callback: TsRunNativeFn,
     pub userdata: *mut c_void,
 }
 
+/// Typed native function: a C function pointer of the shape given by `sig`.
+#[derive(Clone, Copy)]
+pub(crate) struct TypedCallbackWrapper {
+    pub sig: TsRunTypedSig,
+    pub func: *const c_void,
+    pub userdata: *mut c_void,
+}
+
 // ============================================================================
 // Result Types
 // ============================================================================
@@ -196,6 +267,77 @@ impl TsRunResult {
     }
 }
 
+/// Result for tsrun_context_snapshot.
+#[repr(C)]
+pub struct TsRunSnapshotResult {
+    /// The snapshot, or NULL on error.
+    pub snapshot: *mut TsRunSnapshot,
+    /// Error message, or NULL on success. Valid until next tsrun_* call.
+    pub error: *const c_char,
+}
+
+/// Result for operations returning a serialized bytecode blob.
+#[repr(C)]
+pub struct TsRunBytecodeResult {
+    /// Blob bytes, or NULL on error. Free with tsrun_bytecode_free.
+    pub data: *mut u8,
+    /// Blob length in bytes.
+    pub len: usize,
+    /// Error message, or NULL on success. Valid until next tsrun_* call.
+    pub error: *const c_char,
+}
+
+impl TsRunBytecodeResult {
+    pub(crate) fn ok(bytes: Vec<u8>) -> Self {
+        let boxed = bytes.into_boxed_slice();
+        let len = boxed.len();
+        Self {
+            data: Box::into_raw(boxed) as *mut u8,
+            len,
+            error: ptr::null(),
+        }
+    }
+
+    pub(crate) fn err(ctx: &mut TsRunContext, error: String) -> Self {
+        Self {
+            data: ptr::null_mut(),
+            len: 0,
+            error: ctx.set_error(error),
+        }
+    }
+}
+
+/// Result for operations returning an encoded value buffer.
+#[repr(C)]
+pub struct TsRunBufferResult {
+    /// Buffer bytes, or NULL on error. Free with tsrun_buffer_free.
+    pub data: *mut u8,
+    /// Buffer length in bytes.
+    pub len: usize,
+    /// Error message, or NULL on success. Valid until next tsrun_* call.
+    pub error: *const c_char,
+}
+
+impl TsRunBufferResult {
+    pub(crate) fn ok(bytes: Vec<u8>) -> Self {
+        let boxed = bytes.into_boxed_slice();
+        let len = boxed.len();
+        Self {
+            data: Box::into_raw(boxed) as *mut u8,
+            len,
+            error: ptr::null(),
+        }
+    }
+
+    pub(crate) fn err(ctx: &mut TsRunContext, error: String) -> Self {
+        Self {
+            data: ptr::null_mut(),
+            len: 0,
+            error: ctx.set_error(error),
+        }
+    }
+}
+
 // ============================================================================
 // Value Types
 // ============================================================================
@@ -233,6 +375,8 @@ pub enum TsRunStepStatus {
     Done = 4,
     /// Execution error.
     Error = 5,
+    /// tsrun_run_budget ran out of instructions or time; call again to resume.
+    BudgetExhausted = 6,
 }
 
 // ============================================================================
@@ -251,12 +395,28 @@ pub struct TsRunImportRequest {
 }
 
 /// Order from JS to host.
+///
+/// `payload_json` comes from tsrun's own serializer rather than
+/// `JSON.stringify`. It does not call `toJSON` and leaves out
+/// undefined-valued properties. It writes `null` for undefined, symbols,
+/// functions, Maps, Sets and non-finite numbers. Adding the JSON fields
+/// changed the struct's size, so C hosts built against an older header must
+/// be recompiled.
 #[repr(C)]
 pub struct TsRunOrder {
     /// Unique order ID.
     pub id: u64,
     /// Order payload value (owned by context).
+    ///
+    /// NULL when the payload is delivered as JSON instead (see
+    /// tsrun_set_order_payload_json).
     pub payload: *mut TsRunValue,
+    /// Payload serialized as NUL-terminated JSON, or NULL when JSON delivery
+    /// is off, the payload is undefined, or it could not be serialized (then
+    /// `payload` is set instead). Owned by the step result.
+    pub payload_json: *const c_char,
+    /// Length of `payload_json` in bytes, excluding the NUL.
+    pub payload_json_len: usize,
 }
 
 /// Step result with all possible data.
@@ -308,6 +468,10 @@ impl Default for TsRunStepResult {
 // ============================================================================
 
 /// Order response from host to JS.
+///
+/// Callers must zero-initialize responses: a non-NULL `json` takes
+/// precedence over `value`. Adding `json`/`json_len` changed the struct's
+/// size, so C hosts built against an older header must be recompiled.
 #[repr(C)]
 pub struct TsRunOrderResponse {
     /// The order ID this response is for.
@@ -316,6 +480,11 @@ pub struct TsRunOrderResponse {
     pub value: *mut TsRunValue,
     /// Error message (NULL if success).
     pub error: *const c_char,
+    /// Result as JSON text, parsed straight into the heap (used instead of
+    /// `value` when non-NULL and `error` is NULL).
+    pub json: *const c_char,
+    /// Length of `json` in bytes.
+    pub json_len: usize,
 }
 
 // ============================================================================
@@ -346,11 +515,34 @@ pub type TsRunConsoleFn = extern "C" fn(
 );
 
 /// Console callback wrapper storing C function pointer and userdata.
+#[derive(Clone, Copy)]
 pub(crate) struct ConsoleCallbackWrapper {
     pub callback: TsRunConsoleFn,
     pub userdata: *mut c_void,
 }
 
+// ============================================================================
+// JSON Output Callback
+// ============================================================================
+
+/// Output callback for `tsrun_json_stringify_to`.
+///
+/// Receives the next `len` bytes of UTF-8 JSON (not NUL-terminated).
+/// Return false to abort serialization.
+pub type TsRunWriteFn =
+    extern "C" fn(data: *const c_char, len: usize, userdata: *mut c_void) -> bool;
+
+// ============================================================================
+// External Memory
+// ============================================================================
+
+/// Release callback for host memory handed to `tsrun_arraybuffer_external`
+/// or `tsrun_string_external`.
+///
+/// Called once with the original pointer and length when the last value using
+/// the memory has been garbage collected (or the context is freed).
+pub type TsRunExternalFreeFn = extern "C" fn(data: *mut c_void, len: usize, userdata: *mut c_void);
+
 // ============================================================================
 // Native Function Callback
 // ============================================================================
@@ -367,6 +559,63 @@ pub type TsRunNativeFn = extern "C" fn(
     error_out: *mut *const c_char,
 ) -> *mut TsRunValue;
 
+/// Signature of a typed native function (see `tsrun_native_function_typed`).
+///
+/// Every signature takes the registration's userdata as its last parameter.
+/// Strings are passed as a pointer and byte length into the interpreter's
+/// UTF-8 storage, valid only for the duration of the call and not
+/// NUL-terminated.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TsRunTypedSig {
+    /// `double f(void* userdata)`
+    F64 = 0,
+    /// `double f(double, void* userdata)`
+    F64F64 = 1,
+    /// `double f(double, double, void* userdata)`
+    F64F64F64 = 2,
+    /// `double f(double, double, double, void* userdata)`
+    F64F64F64F64 = 3,
+    /// `int64_t f(int64_t, void* userdata)`
+    I64I64 = 4,
+    /// `int64_t f(int64_t, int64_t, void* userdata)`
+    I64I64I64 = 5,
+    /// `bool f(double, void* userdata)`
+    BoolF64 = 6,
+    /// `bool f(const char*, size_t, void* userdata)`
+    BoolStr = 7,
+    /// `double f(const char*, size_t, void* userdata)`
+    F64Str = 8,
+}
+
+impl TsRunTypedSig {
+    /// The signature with the given C enum value
+    pub(crate) fn from_raw(raw: u32) -> Option<Self> {
+        Some(match raw {
+            0 => Self::F64,
+            1 => Self::F64F64,
+            2 => Self::F64F64F64,
+            3 => Self::F64F64F64F64,
+            4 => Self::I64I64,
+            5 => Self::I64I64I64,
+            6 => Self::BoolF64,
+            7 => Self::BoolStr,
+            8 => Self::F64Str,
+            _ => return None,
+        })
+    }
+
+    /// Number of JS arguments the signature takes
+    pub(crate) fn arity(self) -> usize {
+        match self {
+            Self::F64 => 0,
+            Self::F64F64 | Self::I64I64 | Self::BoolF64 | Self::BoolStr | Self::F64Str => 1,
+            Self::F64F64F64 | Self::I64I64I64 => 2,
+            Self::F64F64F64F64 => 3,
+        }
+    }
+}
+
 // ============================================================================
 // GC Statistics
 // ============================================================================
@@ -380,8 +629,85 @@ pub struct TsRunGcStats {
     pub pooled_objects: usize,
     /// Number of live objects.
     pub live_objects: usize,
+    /// Bytes of slot storage held by the heap, pooled slots included.
+    pub reserved_bytes: usize,
+    /// Bytes of slot storage occupied by live objects.
+    pub used_bytes: usize,
+}
+
+/// Inline cache statistics for constant-key property access.
+#[repr(C)]
+pub struct TsRunIcStats {
+    /// Property accesses answered from an inline cache.
+    pub hits: u64,
+    /// Property accesses that took the generic lookup.
+    pub misses: u64,
+    /// Access sites that saw too many object shapes and stopped caching.
+    pub megamorphic_sites: u64,
+}
+
+/// Compiled-regex cache statistics.
+#[repr(C)]
+pub struct TsRunRegexCacheStats {
+    /// Regex compiles answered from the cache.
+    pub hits: u64,
+    /// Regex compiles that went to the RegExp provider.
+    pub misses: u64,
+    /// Patterns currently cached.
+    pub entries: usize,
+    /// Maximum number of cached patterns (0 = caching disabled).
+    pub capacity: usize,
+}
+
+/// One function in a profile.
+#[repr(C)]
+pub struct TsRunProfileFunction {
+    /// Function name (`<anonymous>` / `<top-level>` for unnamed chunks).
+    pub name: *const c_char,
+    /// Source file, or NULL if unknown.
+    pub file: *const c_char,
+    /// Line of the function's first instruction (0 if unknown).
+    pub line: u32,
+    /// Samples taken while this function was running.
+    pub self_samples: u64,
+    /// Samples taken while this function was anywhere on the stack.
+    pub total_samples: u64,
+}
+
+/// Instructions executed for one opcode.
+#[repr(C)]
+pub struct TsRunOpcodeCount {
+    /// Opcode name (e.g. "GetPropertyConst").
+    pub name: *const c_char,
+    /// Number of times it executed.
+    pub count: u64,
+}
+
+/// Profile passed to the tsrun_profiler_stop callback.
+///
+/// All pointers are valid only during the callback.
+#[repr(C)]
+pub struct TsRunProfile {
+    /// Total number of samples taken.
+    pub sample_count: u64,
+    /// Folded stacks, one "outer;inner;leaf count" line per stack
+    /// (NUL-terminated).
+    pub folded: *const c_char,
+    /// Length of `folded` in bytes, excluding the NUL.
+    pub folded_len: usize,
+    /// Functions seen, most self samples first.
+    pub functions: *const TsRunProfileFunction,
+    /// Number of entries in `functions`.
+    pub function_count: usize,
+    /// Per-opcode counts, most frequent first (empty unless enabled).
+    pub opcodes: *const TsRunOpcodeCount,
+    /// Number of entries in `opcodes`.
+    pub opcode_count: usize,
 }
 
+/// Callback receiving the result of tsrun_profiler_stop.
+pub type TsRunProfileFn = extern "C" fn(profile: *const TsRunProfile, userdata: *mut c_void);
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
@@ -2,14 +2,19 @@
 
 extern crate alloc;
 
-use alloc::string::ToString;
+use alloc::boxed::Box;
+use alloc::ffi::CString;
+use alloc::string::{String, ToString};
 use alloc::vec::Vec;
 use core::ffi::c_char;
 use core::ptr;
 
 use crate::ModulePath;
+use crate::compiler::CompiledModule;
 
-use super::{TsRunContext, TsRunResult, TsRunValueResult, c_str_to_str, str_to_c_string};
+use super::{
+    TsRunCompiledModule, TsRunContext, TsRunResult, TsRunValueResult, c_str_to_str, str_to_c_string,
+};
 
 // ============================================================================
 // Module Loading
@@ -49,6 +54,141 @@ pub extern "C" fn tsrun_provide_module(
     }
 }
 
+/// Provide precompiled bytecode for a pending import.
+///
+/// `data`/`len` must hold a blob from tsrun_compile_to_bytecode, compiled with
+/// `path` as its path. The blob is decoded immediately.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_provide_module_bytecode(
+    ctx: *mut TsRunContext,
+    path: *const c_char,
+    data: *const u8,
+    len: usize,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let path_str = match unsafe { c_str_to_str(path) } {
+        Some(s) => s,
+        None => return TsRunResult::err(ctx, "Invalid or NULL path".to_string()),
+    };
+
+    if data.is_null() {
+        return TsRunResult::err(ctx, "NULL bytecode".to_string());
+    }
+    // SAFETY: Caller guarantees data points to len readable bytes
+    let bytes = unsafe { core::slice::from_raw_parts(data, len) };
+
+    let module_path = ModulePath::new(path_str.to_string());
+    match ctx.interp.provide_module_bytecode(module_path, bytes) {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => TsRunResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Compile a module without a context, e.g. on a worker thread.
+///
+/// Thread-safe: the compiled module shares nothing with any context and may be
+/// passed to another thread. Always returns a module; check
+/// tsrun_compiled_module_error for compile errors. `path` is recorded for stack
+/// traces and should match the path later passed to tsrun_provide_compiled_module.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_compile_module(
+    code: *const c_char,
+    path: *const c_char,
+) -> *mut TsRunCompiledModule {
+    let result = match unsafe { (c_str_to_str(code), c_str_to_str(path)) } {
+        (Some(code_str), Some(path_str)) => {
+            CompiledModule::compile(code_str, ModulePath::new(path_str.to_string()))
+                .map_err(|e| compile_error_string(e.to_string()))
+        }
+        (None, _) => Err(compile_error_string(String::from("Invalid or NULL code"))),
+        (_, None) => Err(compile_error_string(String::from("Invalid or NULL path"))),
+    };
+    Box::into_raw(Box::new(TsRunCompiledModule { result }))
+}
+
+/// Error message if compiling failed, or NULL.
+///
+/// The message is valid until the module is provided or freed.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_compiled_module_error(module: *const TsRunCompiledModule) -> *const c_char {
+    match unsafe { module.as_ref() } {
+        Some(module) => match &module.result {
+            Ok(_) => ptr::null(),
+            Err(message) => message.as_ptr(),
+        },
+        None => c"NULL module".as_ptr(),
+    }
+}
+
+/// Provide a module from tsrun_compile_module for a pending import.
+///
+/// Takes ownership of `module` whether or not it succeeds. Only decoding happens
+/// on the context's thread; lexing, parsing and compiling were done up front.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_provide_compiled_module(
+    ctx: *mut TsRunContext,
+    path: *const c_char,
+    module: *mut TsRunCompiledModule,
+) -> TsRunResult {
+    // SAFETY: Caller passes a module from tsrun_compile_module (or NULL) and gives up ownership
+    let module = (!module.is_null()).then(|| unsafe { Box::from_raw(module) });
+
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let path_str = match unsafe { c_str_to_str(path) } {
+        Some(s) => s,
+        None => return TsRunResult::err(ctx, "Invalid or NULL path".to_string()),
+    };
+
+    let compiled = match module.map(|m| m.result) {
+        Some(Ok(compiled)) => compiled,
+        Some(Err(message)) => {
+            return TsRunResult::err(ctx, message.to_string_lossy().into_owned());
+        }
+        None => return TsRunResult::err(ctx, "NULL module".to_string()),
+    };
+
+    let module_path = ModulePath::new(path_str.to_string());
+    match ctx
+        .interp
+        .provide_module_bytecode(module_path, compiled.as_bytes())
+    {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => TsRunResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Free a compiled module that was not provided to a context.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_compiled_module_free(module: *mut TsRunCompiledModule) {
+    if !module.is_null() {
+        // SAFETY: module came from Box::into_raw in tsrun_compile_module
+        unsafe { drop(Box::from_raw(module)) };
+    }
+}
+
+/// Compile error as a C string, replacing interior NULs
+fn compile_error_string(message: String) -> CString {
+    CString::new(message.replace('\0', " ")).unwrap_or_default()
+}
+
 // ============================================================================
 // Module Exports
 // ============================================================================
@@ -3,6 +3,7 @@
 extern crate alloc;
 
 use alloc::boxed::Box;
+use alloc::format;
 use alloc::string::{String, ToString};
 use alloc::vec::Vec;
 use core::ffi::{CStr, c_char, c_void};
@@ -13,7 +14,8 @@ use crate::error::JsError;
 use crate::value::{CheapClone, Guarded, JsValue, PropertyKey};
 
 use super::{
-    NativeCallbackWrapper, TsRunContext, TsRunNativeFn, TsRunResult, TsRunValue, TsRunValueResult,
+    NativeCallbackWrapper, TsRunContext, TsRunNativeFn, TsRunResult, TsRunTypedSig, TsRunValue,
+    TsRunValueResult, TypedCallbackWrapper,
 };
 
 // ============================================================================
@@ -182,6 +184,214 @@ fn native_callback_trampoline(
     }
 }
 
+// ============================================================================
+// Typed Native Functions
+// ============================================================================
+
+type F64Fn = extern "C" fn(*mut c_void) -> f64;
+type F64F64Fn = extern "C" fn(f64, *mut c_void) -> f64;
+type F64F64F64Fn = extern "C" fn(f64, f64, *mut c_void) -> f64;
+type F64F64F64F64Fn = extern "C" fn(f64, f64, f64, *mut c_void) -> f64;
+type I64I64Fn = extern "C" fn(i64, *mut c_void) -> i64;
+type I64I64I64Fn = extern "C" fn(i64, i64, *mut c_void) -> i64;
+type BoolF64Fn = extern "C" fn(f64, *mut c_void) -> bool;
+type BoolStrFn = extern "C" fn(*const c_char, usize, *mut c_void) -> bool;
+type F64StrFn = extern "C" fn(*const c_char, usize, *mut c_void) -> f64;
+
+/// Create a native function backed by a plain C function of signature `sig`.
+///
+/// Arguments are read straight from the call and passed as C scalars, and
+/// the return value becomes a JS number or boolean, so no value handles are
+/// created per call. Arguments of another type are converted the way JS
+/// would (`Number(x)` / `String(x)`, which may call `valueOf`/`toString`);
+/// missing ones are `undefined`. `int64_t` parameters receive the number
+/// truncated toward zero, saturating at the type's range (NaN becomes 0).
+/// An `int64_t` result beyond `Number.MAX_SAFE_INTEGER` in magnitude has no
+/// exact JS number, so the call throws a `RangeError` instead of rounding.
+///
+/// `func` must point to a function of exactly the shape `sig` describes.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_native_function_typed(
+    ctx: *mut TsRunContext,
+    name: *const c_char,
+    sig: u32,
+    func: *const c_void,
+    userdata: *mut c_void,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let Some(sig) = TsRunTypedSig::from_raw(sig) else {
+        return TsRunValueResult::err(ctx, format!("Unknown typed signature {}", sig));
+    };
+    if func.is_null() {
+        return TsRunValueResult::err(ctx, "NULL function pointer".to_string());
+    }
+
+    let name_str = if name.is_null() {
+        "anonymous"
+    } else {
+        match unsafe { CStr::from_ptr(name) }.to_str() {
+            Ok(s) => s,
+            Err(_) => {
+                return TsRunValueResult::err(ctx, "Invalid function name encoding".to_string());
+            }
+        }
+    };
+
+    let ffi_id = ctx.next_ffi_id;
+    ctx.next_ffi_id += 1;
+    ctx.typed_callbacks.insert(
+        ffi_id,
+        TypedCallbackWrapper {
+            sig,
+            func,
+            userdata,
+        },
+    );
+
+    let guard = ctx.interp.heap.create_guard();
+    let fn_obj = ctx.interp.create_ffi_native_fn(
+        &guard,
+        name_str,
+        typed_callback_trampoline,
+        sig.arity(),
+        ffi_id,
+    );
+
+    TsRunValueResult::ok(Box::new(TsRunValue {
+        inner: crate::RuntimeValue::with_guard(JsValue::Object(fn_obj), guard),
+    }))
+}
+
+/// Trampoline for typed native functions: converts the JS arguments to the
+/// C types of the callback's signature and calls it directly.
+fn typed_callback_trampoline(
+    interp: &mut crate::Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let ctx_ptr = interp.ffi_context as *const TsRunContext;
+    if ctx_ptr.is_null() {
+        return Err(JsError::internal_error(
+            "Native callback called without context",
+        ));
+    }
+    let wrapper = unsafe { &*ctx_ptr }
+        .typed_callbacks
+        .get(&interp.current_ffi_id)
+        .copied()
+        .ok_or_else(|| JsError::internal_error("Native callback not found"))?;
+    let f = wrapper.func;
+    let ud = wrapper.userdata;
+
+    // SAFETY for the transmutes: tsrun_native_function_typed's contract is
+    // that `func` has the signature named by `sig`.
+    let result = match wrapper.sig {
+        TsRunTypedSig::F64 => {
+            let f = unsafe { core::mem::transmute::<*const c_void, F64Fn>(f) };
+            JsValue::Number(f(ud))
+        }
+        TsRunTypedSig::F64F64 => {
+            let a = number_arg(interp, args, 0)?;
+            let f = unsafe { core::mem::transmute::<*const c_void, F64F64Fn>(f) };
+            JsValue::Number(f(a, ud))
+        }
+        TsRunTypedSig::F64F64F64 => {
+            let a = number_arg(interp, args, 0)?;
+            let b = number_arg(interp, args, 1)?;
+            let f = unsafe { core::mem::transmute::<*const c_void, F64F64F64Fn>(f) };
+            JsValue::Number(f(a, b, ud))
+        }
+        TsRunTypedSig::F64F64F64F64 => {
+            let a = number_arg(interp, args, 0)?;
+            let b = number_arg(interp, args, 1)?;
+            let c = number_arg(interp, args, 2)?;
+            let f = unsafe { core::mem::transmute::<*const c_void, F64F64F64F64Fn>(f) };
+            JsValue::Number(f(a, b, c, ud))
+        }
+        TsRunTypedSig::I64I64 => {
+            let a = number_arg(interp, args, 0)? as i64;
+            let f = unsafe { core::mem::transmute::<*const c_void, I64I64Fn>(f) };
+            int_result(f(a, ud))?
+        }
+        TsRunTypedSig::I64I64I64 => {
+            let a = number_arg(interp, args, 0)? as i64;
+            let b = number_arg(interp, args, 1)? as i64;
+            let f = unsafe { core::mem::transmute::<*const c_void, I64I64I64Fn>(f) };
+            int_result(f(a, b, ud))?
+        }
+        TsRunTypedSig::BoolF64 => {
+            let a = number_arg(interp, args, 0)?;
+            let f = unsafe { core::mem::transmute::<*const c_void, BoolF64Fn>(f) };
+            JsValue::Boolean(f(a, ud))
+        }
+        TsRunTypedSig::BoolStr => {
+            let s = string_arg(interp, args, 0)?;
+            let s = s.as_str();
+            let f = unsafe { core::mem::transmute::<*const c_void, BoolStrFn>(f) };
+            JsValue::Boolean(f(s.as_ptr() as *const c_char, s.len(), ud))
+        }
+        TsRunTypedSig::F64Str => {
+            let s = string_arg(interp, args, 0)?;
+            let s = s.as_str();
+            let f = unsafe { core::mem::transmute::<*const c_void, F64StrFn>(f) };
+            JsValue::Number(f(s.as_ptr() as *const c_char, s.len(), ud))
+        }
+    };
+    Ok(Guarded::unguarded(result))
+}
+
+/// Largest integer magnitude a JS number holds exactly (2^53 - 1)
+const MAX_SAFE_INTEGER: i64 = (1 << 53) - 1;
+
+/// An `int64_t` callback result as a JS number, if it converts exactly
+#[inline]
+fn int_result(n: i64) -> Result<JsValue, JsError> {
+    if !(-MAX_SAFE_INTEGER..=MAX_SAFE_INTEGER).contains(&n) {
+        return Err(JsError::range_error(format!(
+            "Native function returned {}, outside the safe integer range",
+            n
+        )));
+    }
+    Ok(JsValue::Number(n as f64))
+}
+
+/// Argument `index` as a number, converting non-numbers with ToNumber
+#[inline]
+fn number_arg(
+    interp: &mut crate::Interpreter,
+    args: &[JsValue],
+    index: usize,
+) -> Result<f64, JsError> {
+    match args.get(index) {
+        Some(JsValue::Number(n)) => Ok(*n),
+        Some(value) => interp.coerce_to_number(value),
+        None => Ok(f64::NAN),
+    }
+}
+
+/// Argument `index` as a string, converting non-strings with ToString
+#[inline]
+fn string_arg(
+    interp: &mut crate::Interpreter,
+    args: &[JsValue],
+    index: usize,
+) -> Result<JsString, JsError> {
+    match args.get(index) {
+        Some(JsValue::String(s)) => Ok(s.cheap_clone()),
+        Some(value) => interp.coerce_to_string(value),
+        None => interp.coerce_to_string(&JsValue::Undefined),
+    }
+}
+
 // ============================================================================
 // Internal Module Builder
 // ============================================================================
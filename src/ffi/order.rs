@@ -3,13 +3,16 @@
 extern crate alloc;
 
 use alloc::boxed::Box;
+use alloc::format;
 use alloc::string::ToString;
 use alloc::vec::Vec;
 use core::ffi::c_char;
 use core::ptr;
 
 use crate::value::{CheapClone, PropertyKey};
-use crate::{JsError, JsString, JsValue, OrderId, OrderResponse, RuntimeValue};
+use crate::{
+    Interpreter, JsError, JsString, JsValue, JsonStreamParser, OrderId, OrderResponse, RuntimeValue,
+};
 
 use super::{
     TsRunContext, TsRunOrderResponse, TsRunResult, TsRunValue, TsRunValueResult, c_str_to_str,
@@ -20,6 +23,10 @@ use super::{
 // ============================================================================
 
 /// Fulfill one or more orders.
+///
+/// A response with a non-NULL `json` is parsed straight into the heap. All
+/// JSON responses are parsed before any order is fulfilled, so if one fails
+/// to parse an error is returned and no order in the batch is fulfilled.
 #[unsafe(no_mangle)]
 pub extern "C" fn tsrun_fulfill_orders(
     ctx: *mut TsRunContext,
@@ -41,33 +48,61 @@ pub extern "C" fn tsrun_fulfill_orders(
     }
 
     // Convert C responses to Rust
-    let rust_responses: Vec<OrderResponse> = (0..count)
-        .map(|i| unsafe {
-            let resp = &*responses.add(i);
-            let result = if resp.error.is_null() {
-                // Success case
-                if let Some(val) = resp.value.as_ref() {
-                    Ok(RuntimeValue::unguarded(val.value().clone()))
-                } else {
-                    Ok(RuntimeValue::unguarded(JsValue::Undefined))
+    let mut rust_responses: Vec<OrderResponse> = Vec::with_capacity(count);
+    for i in 0..count {
+        let resp = unsafe { &*responses.add(i) };
+        let result = if !resp.error.is_null() {
+            // Error case
+            let error_str = unsafe { c_str_to_str(resp.error) }.unwrap_or("Unknown error");
+            Err(JsError::type_error(error_str))
+        } else if !resp.json.is_null() {
+            // SAFETY: caller guarantees json points to json_len readable bytes
+            let bytes =
+                unsafe { core::slice::from_raw_parts(resp.json as *const u8, resp.json_len) };
+            match parse_json_response(&mut ctx.interp, bytes) {
+                Ok(value) => Ok(value),
+                Err(e) => {
+                    return TsRunResult::err(ctx, format!("order {}: {}", resp.id, e));
                 }
-            } else {
-                // Error case
-                let error_str = c_str_to_str(resp.error).unwrap_or("Unknown error");
-                Err(JsError::type_error(error_str))
-            };
-
-            OrderResponse {
-                id: OrderId(resp.id),
-                result,
             }
-        })
-        .collect();
+        } else if let Some(val) = unsafe { resp.value.as_ref() } {
+            Ok(RuntimeValue::unguarded(val.value().clone()))
+        } else {
+            Ok(RuntimeValue::unguarded(JsValue::Undefined))
+        };
+
+        rust_responses.push(OrderResponse {
+            id: OrderId(resp.id),
+            result,
+        });
+    }
 
     ctx.interp.fulfill_orders(rust_responses);
     TsRunResult::success()
 }
 
+/// Parse one JSON response body into a guarded heap value
+fn parse_json_response(interp: &mut Interpreter, bytes: &[u8]) -> Result<RuntimeValue, JsError> {
+    let mut parser = JsonStreamParser::new(interp);
+    parser.feed(interp, bytes)?;
+    Ok(RuntimeValue::from_guarded(parser.finish()?))
+}
+
+/// Choose how order payloads are delivered in TSRUN_STEP_SUSPENDED results.
+///
+/// When enabled, each TsRunOrder carries its payload serialized as JSON in
+/// `payload_json` and `payload` is NULL, so the host reads a payload without
+/// creating or freeing handles. The serializer does not call `toJSON` and
+/// turns values JSON cannot hold into `null` or leaves them out (see
+/// `TsRunOrder`). Undefined payloads give NULL, and circular payloads are
+/// still delivered as handles. Off by default.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_set_order_payload_json(ctx: *mut TsRunContext, enabled: bool) {
+    if let Some(ctx) = unsafe { ctx.as_mut() } {
+        ctx.order_payload_json = enabled;
+    }
+}
+
 // ============================================================================
 // Pending Order Creation
 // ============================================================================
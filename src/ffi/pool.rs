@@ -0,0 +1,183 @@
+//! Multi-threaded interpreter pool.
+
+extern crate alloc;
+
+use alloc::boxed::Box;
+use alloc::ffi::CString;
+use alloc::string::{String, ToString};
+use core::cell::RefCell;
+use core::ffi::{c_char, c_void};
+use core::ptr;
+
+use crate::pool::InterpreterPool;
+
+use super::{TsRunCompiledModule, TsRunResult, c_str_to_str};
+
+/// Opaque pool of worker threads, each with its own context.
+pub struct TsRunPool {
+    pool: InterpreterPool,
+}
+
+/// Job completion callback, called on a worker thread.
+///
+/// `error` is non-NULL if the job failed; otherwise `result_json` holds the
+/// return value as JSON (NULL for undefined). Both are valid only during the call.
+pub type TsRunPoolJobFn =
+    extern "C" fn(result_json: *const c_char, error: *const c_char, userdata: *mut c_void);
+
+std::thread_local! {
+    /// Error from the last failed pool call on this thread; pool functions
+    /// may be called from any thread, so errors are not kept on the pool
+    static POOL_ERROR: RefCell<Option<CString>> = const { RefCell::new(None) };
+}
+
+/// Failed result whose message is valid until the next failing tsrun_pool_*
+/// call on the same thread
+fn pool_error(message: String) -> TsRunResult {
+    let message = CString::new(message.replace('\0', " ")).unwrap_or_default();
+    let error = POOL_ERROR.with(|slot| {
+        let mut slot = slot.borrow_mut();
+        slot.insert(message).as_ptr()
+    });
+    TsRunResult { ok: false, error }
+}
+
+/// Userdata handed to a worker thread with its job.
+struct JobUserdata(*mut c_void);
+
+// SAFETY: the embedder promises, by submitting, that the callback may be
+// called with this pointer from a worker thread
+unsafe impl Send for JobUserdata {}
+
+/// Start a pool with `nthreads` workers (0 = one per available CPU).
+///
+/// Returns NULL if a worker thread could not be started.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_new(nthreads: usize) -> *mut TsRunPool {
+    match InterpreterPool::new(nthreads) {
+        Ok(pool) => Box::into_raw(Box::new(TsRunPool { pool })),
+        Err(_) => ptr::null_mut(),
+    }
+}
+
+/// Number of worker threads in the pool.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_threads(pool: *const TsRunPool) -> usize {
+    unsafe { pool.as_ref() }.map_or(0, |p| p.pool.threads())
+}
+
+/// Add a module from tsrun_compile_module to the pool.
+///
+/// Takes ownership of module, even on error. Jobs and imports refer to the
+/// module by the path it was compiled with.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_add_module(
+    pool: *mut TsRunPool,
+    module: *mut TsRunCompiledModule,
+) -> TsRunResult {
+    if module.is_null() {
+        return TsRunResult {
+            ok: false,
+            error: c"NULL module".as_ptr(),
+        };
+    }
+    // SAFETY: module came from tsrun_compile_module and is consumed here
+    let module = unsafe { Box::from_raw(module) };
+    let pool = match unsafe { pool.as_ref() } {
+        Some(p) => p,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL pool".as_ptr(),
+            };
+        }
+    };
+    let compiled = match module.result {
+        Ok(compiled) => compiled,
+        Err(message) => return pool_error(message.to_string_lossy().into_owned()),
+    };
+    match pool.pool.add_module(compiled) {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => pool_error(e.to_string()),
+    }
+}
+
+/// Queue a call to the exported function `entry` of `module`.
+///
+/// `args_json` is a JSON array of arguments, or NULL for none. A returned
+/// promise is unwrapped if it has settled by the time the call returns.
+/// `callback` runs on a worker thread once the job finishes.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_submit(
+    pool: *mut TsRunPool,
+    module: *const c_char,
+    entry: *const c_char,
+    args_json: *const c_char,
+    callback: TsRunPoolJobFn,
+    userdata: *mut c_void,
+) -> TsRunResult {
+    let pool = match unsafe { pool.as_ref() } {
+        Some(p) => p,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL pool".as_ptr(),
+            };
+        }
+    };
+    let (Some(module), Some(entry)) = (unsafe { c_str_to_str(module) }, unsafe {
+        c_str_to_str(entry)
+    }) else {
+        return TsRunResult {
+            ok: false,
+            error: c"Invalid or NULL module or entry".as_ptr(),
+        };
+    };
+    let args_json = if args_json.is_null() {
+        ""
+    } else {
+        match unsafe { c_str_to_str(args_json) } {
+            Some(s) => s,
+            None => {
+                return TsRunResult {
+                    ok: false,
+                    error: c"Invalid args_json".as_ptr(),
+                };
+            }
+        }
+    };
+
+    let userdata = JobUserdata(userdata);
+    let submitted = pool.pool.submit(module, entry, args_json, move |result| {
+        // Move the whole wrapper in; capturing just the raw field is not Send
+        let userdata = userdata;
+        // JSON output escapes NUL, so only error messages need sanitizing
+        let (json, error) = match result {
+            Ok(json) => (json.and_then(|j| CString::new(j).ok()), None),
+            Err(message) => (None, CString::new(message.replace('\0', " ")).ok()),
+        };
+        let as_ptr = |s: &Option<CString>| s.as_ref().map_or(ptr::null(), |s| s.as_ptr());
+        callback(as_ptr(&json), as_ptr(&error), userdata.0);
+    });
+    match submitted {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => pool_error(e.to_string()),
+    }
+}
+
+/// Block until every submitted job has finished and its callback returned.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_wait(pool: *mut TsRunPool) {
+    if let Some(pool) = unsafe { pool.as_ref() } {
+        pool.pool.wait_idle();
+    }
+}
+
+/// Run the jobs still queued, then stop the workers and free the pool.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_pool_free(pool: *mut TsRunPool) {
+    if !pool.is_null() {
+        // SAFETY: pool came from tsrun_pool_new
+        drop(unsafe { Box::from_raw(pool) });
+    }
+}
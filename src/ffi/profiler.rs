@@ -0,0 +1,125 @@
+//! Sampling profiler functions.
+
+extern crate alloc;
+
+use alloc::ffi::CString;
+use alloc::string::{String, ToString};
+use alloc::vec::Vec;
+use core::ffi::c_void;
+use core::ptr;
+
+use super::{
+    TsRunContext, TsRunOpcodeCount, TsRunProfile, TsRunProfileFn, TsRunProfileFunction, TsRunResult,
+};
+
+/// Start sampling the JS call stack every `interval_ns` nanoseconds of
+/// execution, replacing any running session.
+///
+/// The clock is read every 256 instructions, and each read records the stack
+/// once per whole interval that has elapsed. An interval of 0 records one
+/// sample per read. With `count_opcodes`, every
+/// executed instruction is also counted by opcode, which slows execution
+/// noticeably.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_profiler_start(
+    ctx: *mut TsRunContext,
+    interval_ns: u64,
+    count_opcodes: bool,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    ctx.interp.start_profiler(interval_ns, count_opcodes);
+    TsRunResult::success()
+}
+
+/// Stop the running profiling session and pass its profile to `callback`.
+///
+/// The profile and everything it points to are valid only during the
+/// callback. Fails if no session is running.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_profiler_stop(
+    ctx: *mut TsRunContext,
+    callback: Option<TsRunProfileFn>,
+    userdata: *mut c_void,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let Some(callback) = callback else {
+        return TsRunResult::err(ctx, "NULL profile callback".to_string());
+    };
+    let Some(profile) = ctx.interp.stop_profiler() else {
+        return TsRunResult::err(ctx, "profiler is not running".to_string());
+    };
+
+    let folded = c_string_lossy(profile.folded());
+    let names: Vec<CString> = profile
+        .functions
+        .iter()
+        .map(|f| c_string_lossy(f.name.clone()))
+        .collect();
+    let files: Vec<Option<CString>> = profile
+        .functions
+        .iter()
+        .map(|f| f.file.clone().map(c_string_lossy))
+        .collect();
+    let functions: Vec<TsRunProfileFunction> = profile
+        .functions
+        .iter()
+        .zip(names.iter().zip(files.iter()))
+        .map(|(f, (name, file))| TsRunProfileFunction {
+            name: name.as_ptr(),
+            file: file.as_ref().map_or(ptr::null(), |file| file.as_ptr()),
+            line: f.line,
+            self_samples: f.self_samples,
+            total_samples: f.total_samples,
+        })
+        .collect();
+    let opcode_names: Vec<CString> = profile
+        .opcode_counts
+        .iter()
+        .map(|(name, _)| c_string_lossy(name.clone()))
+        .collect();
+    let opcodes: Vec<TsRunOpcodeCount> = profile
+        .opcode_counts
+        .iter()
+        .zip(opcode_names.iter())
+        .map(|((_, count), name)| TsRunOpcodeCount {
+            name: name.as_ptr(),
+            count: *count,
+        })
+        .collect();
+
+    let c_profile = TsRunProfile {
+        sample_count: profile.samples,
+        folded: folded.as_ptr(),
+        folded_len: folded.as_bytes().len(),
+        functions: functions.as_ptr(),
+        function_count: functions.len(),
+        opcodes: opcodes.as_ptr(),
+        opcode_count: opcodes.len(),
+    };
+    callback(&c_profile, userdata);
+
+    TsRunResult::success()
+}
+
+/// C string of `s`, dropping any interior NUL bytes
+fn c_string_lossy(s: String) -> CString {
+    CString::new(s.replace('\0', "")).unwrap_or_default()
+}
@@ -26,6 +26,7 @@
 //!
 //! // Register provider
 //! TsRunRegexCallbacks callbacks = {
+//!     .size = sizeof(TsRunRegexCallbacks),
 //!     .compile = my_compile,
 //!     .is_match = my_is_match,
 //!     .find = my_find,
@@ -34,6 +35,14 @@
 //! };
 //! tsrun_set_regexp_provider(ctx, &callbacks);
 //! ```
+//!
+//! The optional `find_all`, `replace_all` and `split` callbacks handle a whole
+//! global search in one call, filling buffers owned by tsrun. When they are
+//! NULL, tsrun calls `find` once per match instead.
+//!
+//! `TsRunRegexCallbacks` starts with its own size so callbacks can be
+//! appended later: tsrun treats fields past `size` as NULL. Callers built
+//! before the size field existed must be recompiled.
 
 extern crate alloc;
 
@@ -158,6 +167,124 @@ pub type TsRunRegexFreeFn = extern "C" fn(userdata: *mut c_void, handle: *mut c_
 pub type TsRunRegexFreeCapturesFn =
     extern "C" fn(userdata: *mut c_void, captures: *mut TsRunRegexCapture, count: usize);
 
+/// Caller-allocated buffer filled by a bulk `find_all` call.
+///
+/// Each written match's `captures` points into the shared `captures` pool,
+/// which is owned by the caller; `free_captures` is not called for them.
+#[repr(C)]
+#[derive(Debug)]
+pub struct TsRunRegexMatchBuffer {
+    /// Match slots (`match_capacity` entries)
+    pub matches: *mut TsRunRegexMatch,
+    /// Number of match slots
+    pub match_capacity: usize,
+    /// Capture slots shared by all matches (`capture_capacity` entries)
+    pub captures: *mut TsRunRegexCapture,
+    /// Number of capture slots
+    pub capture_capacity: usize,
+    /// Out: number of matches written
+    pub match_count: usize,
+    /// Out: byte offset to pass as `start_pos` on the next call
+    pub resume_pos: usize,
+}
+
+/// Find every match from a position in one call (optional).
+///
+/// Matches are written in order until the input is exhausted or either pool
+/// in `buffer` is full. The callback handles zero-width matches and sets
+/// `resume_pos` past the last written match, advancing by one character after
+/// an empty match. If a single match needs more capture slots than are free,
+/// stop before it; returning 1 with no matches written asks the caller for a
+/// larger capture pool.
+///
+/// # Parameters
+/// - `userdata`: User-provided context pointer
+/// - `handle`: Compiled regex handle
+/// - `input`: The input string (UTF-8, not null-terminated)
+/// - `input_len`: Length of input in bytes
+/// - `start_pos`: Byte offset to start searching from
+/// - `buffer`: Output buffer (caller-allocated)
+/// - `error_out`: On error, set to a static error message
+///
+/// # Returns
+/// - 1: Buffer full, more matches may follow from `resume_pos`
+/// - 0: All remaining matches written
+/// - -1: Error
+pub type TsRunRegexFindAllFn = extern "C" fn(
+    userdata: *mut c_void,
+    handle: *mut c_void,
+    input: *const c_char,
+    input_len: usize,
+    start_pos: usize,
+    buffer: *mut TsRunRegexMatchBuffer,
+    error_out: *mut *const c_char,
+) -> i32;
+
+/// Replace every match with literal text (optional).
+///
+/// Only called for global replacements whose replacement string contains no
+/// `$` patterns, so `replacement` is inserted verbatim.
+///
+/// # Parameters
+/// - `userdata`: User-provided context pointer
+/// - `handle`: Compiled regex handle
+/// - `input`: The input string (UTF-8, not null-terminated)
+/// - `input_len`: Length of input in bytes
+/// - `replacement`: Replacement text (UTF-8, not null-terminated)
+/// - `replacement_len`: Length of replacement in bytes
+/// - `out`: Output buffer (caller-allocated, not null-terminated)
+/// - `out_capacity`: Size of `out` in bytes
+/// - `out_len`: Set to the length of the result in bytes
+/// - `error_out`: On error, set to a static error message
+///
+/// # Returns
+/// - 1: Result written to `out`
+/// - 0: `out` too small; `*out_len` is the required size and the caller retries
+/// - -1: Error
+pub type TsRunRegexReplaceAllFn = extern "C" fn(
+    userdata: *mut c_void,
+    handle: *mut c_void,
+    input: *const c_char,
+    input_len: usize,
+    replacement: *const c_char,
+    replacement_len: usize,
+    out: *mut c_char,
+    out_capacity: usize,
+    out_len: *mut usize,
+    error_out: *mut *const c_char,
+) -> i32;
+
+/// Split the input around every match (optional).
+///
+/// Writes the byte spans of the pieces between matches, including the piece
+/// before the first match and after the last one. Capture groups are not part
+/// of the result.
+///
+/// # Parameters
+/// - `userdata`: User-provided context pointer
+/// - `handle`: Compiled regex handle
+/// - `input`: The input string (UTF-8, not null-terminated)
+/// - `input_len`: Length of input in bytes
+/// - `pieces`: Output spans (caller-allocated, `capacity` entries)
+/// - `capacity`: Number of entries in `pieces`
+/// - `count_out`: Set to the number of pieces
+/// - `error_out`: On error, set to a static error message
+///
+/// # Returns
+/// - 1: `*count_out` pieces written
+/// - 0: `pieces` too small; `*count_out` is the required count and the caller retries
+/// - -1: Error
+pub type TsRunRegexSplitFn = extern "C" fn(
+    userdata: *mut c_void,
+    handle: *mut c_void,
+    input: *const c_char,
+    input_len: usize,
+    pieces: *mut TsRunRegexCapture,
+    capacity: usize,
+    count_out: *mut usize,
+    error_out: *mut *const c_char,
+) -> i32;
+
 // ============================================================================
 // C Callback Bundle
 // ============================================================================
@@ -166,6 +293,9 @@ pub type TsRunRegexFreeCapturesFn =
 #[repr(C)]
 #[derive(Clone, Copy)]
 pub struct TsRunRegexCallbacks {
+    /// `sizeof(TsRunRegexCallbacks)` as the caller compiled it; optional
+    /// callbacks past this size are treated as NULL
+    pub size: usize,
     /// Compile a regex pattern
     pub compile: TsRunRegexCompileFn,
     /// Test if regex matches
@@ -178,6 +308,12 @@ pub struct TsRunRegexCallbacks {
     pub free_captures: Option<TsRunRegexFreeCapturesFn>,
     /// User-provided context pointer passed to all callbacks
     pub userdata: *mut c_void,
+    /// Bulk match search (may be NULL; `find` is called per match instead)
+    pub find_all: Option<TsRunRegexFindAllFn>,
+    /// Literal global replacement (may be NULL)
+    pub replace_all: Option<TsRunRegexReplaceAllFn>,
+    /// Split around matches (may be NULL)
+    pub split: Option<TsRunRegexSplitFn>,
 }
 
 // ============================================================================
@@ -221,14 +357,7 @@ impl RegExpProvider for CRegExpProvider {
         );
 
         if handle.is_null() {
-            let error_msg = if error_out.is_null() {
-                String::from("Regex compilation failed")
-            } else {
-                unsafe { c_str_to_str(error_out) }
-                    .map(String::from)
-                    .unwrap_or_else(|| String::from("Regex compilation failed"))
-            };
-            return Err(error_msg);
+            return Err(callback_error(error_out, "Regex compilation failed"));
         }
 
         Ok(Rc::new(CCompiledRegex {
@@ -238,6 +367,9 @@ impl RegExpProvider for CRegExpProvider {
                 find: self.callbacks.find,
                 free: self.callbacks.free,
                 free_captures: self.callbacks.free_captures,
+                find_all: self.callbacks.find_all,
+                replace_all: self.callbacks.replace_all,
+                split: self.callbacks.split,
                 userdata: self.callbacks.userdata,
             },
             flags: String::from(flags),
@@ -252,6 +384,9 @@ struct CRegexCallbacksRef {
     find: TsRunRegexFindFn,
     free: TsRunRegexFreeFn,
     free_captures: Option<TsRunRegexFreeCapturesFn>,
+    find_all: Option<TsRunRegexFindAllFn>,
+    replace_all: Option<TsRunRegexReplaceAllFn>,
+    split: Option<TsRunRegexSplitFn>,
     userdata: *mut c_void,
 }
 
@@ -295,16 +430,7 @@ impl CompiledRegex for CCompiledRegex {
         match result {
             1 => Ok(true),
             0 => Ok(false),
-            _ => {
-                let error_msg = if error_out.is_null() {
-                    String::from("Regex match failed")
-                } else {
-                    unsafe { c_str_to_str(error_out) }
-                        .map(String::from)
-                        .unwrap_or_else(|| String::from("Regex match failed"))
-                };
-                Err(error_msg)
-            }
+            _ => Err(callback_error(error_out, "Regex match failed")),
         }
     }
 
@@ -351,16 +477,7 @@ impl CompiledRegex for CCompiledRegex {
                 }))
             }
             0 => Ok(None),
-            _ => {
-                let error_msg = if error_out.is_null() {
-                    String::from("Regex find failed")
-                } else {
-                    unsafe { c_str_to_str(error_out) }
-                        .map(String::from)
-                        .unwrap_or_else(|| String::from("Regex find failed"))
-                };
-                Err(error_msg)
-            }
+            _ => Err(callback_error(error_out, "Regex find failed")),
         }
     }
 
@@ -377,32 +494,28 @@ impl CompiledRegex for CCompiledRegex {
         }
 
         // Global: find all matches
-        let mut pos = 0;
-        while pos <= input.len() {
-            match self.find(input, pos)? {
-                Some(m) => {
-                    let next_pos = if m.start == m.end {
-                        m.end + 1 // Prevent infinite loop on zero-width matches
-                    } else {
-                        m.end
-                    };
-                    matches.push(m);
-                    pos = next_pos;
-                }
-                None => break,
-            }
-        }
-
-        Ok(matches)
+        self.find_all_matches(input)
     }
 
     fn split(&self, input: &str) -> Result<Vec<String>, String> {
+        if let Some(split_fn) = self.callbacks.split {
+            return self.split_bulk(split_fn, input);
+        }
+
         // split() always iterates all matches, regardless of global flag
         let matches = self.find_all_matches(input)?;
         let mut result = Vec::new();
         let mut last_end = 0;
 
         for m in matches {
+            // A byte-oriented engine may report a match inside a multibyte
+            // character; splitting there would lose the character
+            if m.start < last_end
+                || !input.is_char_boundary(m.start)
+                || !input.is_char_boundary(m.end)
+            {
+                continue;
+            }
             if let Some(before) = input.get(last_end..m.start) {
                 result.push(String::from(before));
             }
@@ -431,6 +544,13 @@ impl CompiledRegex for CCompiledRegex {
     }
 
     fn replace_all(&self, input: &str, replacement: &str) -> Result<String, String> {
+        if let Some(replace_all_fn) = self.callbacks.replace_all
+            && self.flags.contains('g')
+            && !replacement.contains('$')
+        {
+            return self.replace_all_bulk(replace_all_fn, input, replacement);
+        }
+
         let matches = self.find_iter(input)?;
 
         if matches.is_empty() {
@@ -461,6 +581,10 @@ impl CCompiledRegex {
     /// Find all matches regardless of global flag.
     /// Used by split() which always needs all matches.
     fn find_all_matches(&self, input: &str) -> Result<Vec<RegexMatch>, String> {
+        if let Some(find_all_fn) = self.callbacks.find_all {
+            return self.find_all_bulk(find_all_fn, input);
+        }
+
         let mut matches = Vec::new();
         let mut pos = 0;
 
@@ -468,7 +592,9 @@ impl CCompiledRegex {
             match self.find(input, pos)? {
                 Some(m) => {
                     let next_pos = if m.start == m.end {
-                        m.end + 1 // Prevent infinite loop on zero-width matches
+                        // Step over one character so zero-width matches
+                        // neither loop nor resume inside a multibyte character
+                        next_char_boundary(input, m.end)
                     } else {
                         m.end
                     };
@@ -482,6 +608,157 @@ impl CCompiledRegex {
         Ok(matches)
     }
 
+    /// Find all matches through the bulk callback, one buffer per call.
+    fn find_all_bulk(
+        &self,
+        find_all_fn: TsRunRegexFindAllFn,
+        input: &str,
+    ) -> Result<Vec<RegexMatch>, String> {
+        let handle = *self.handle.borrow();
+        let mut matches = Vec::new();
+        let mut match_slots = alloc::vec![EMPTY_MATCH; FIND_ALL_MATCH_SLOTS];
+        let mut capture_slots = alloc::vec![EMPTY_CAPTURE; FIND_ALL_CAPTURE_SLOTS];
+        let mut pos = 0;
+
+        while pos <= input.len() {
+            let mut buffer = TsRunRegexMatchBuffer {
+                matches: match_slots.as_mut_ptr(),
+                match_capacity: match_slots.len(),
+                captures: capture_slots.as_mut_ptr(),
+                capture_capacity: capture_slots.len(),
+                match_count: 0,
+                resume_pos: input.len() + 1,
+            };
+            let mut error_out: *const c_char = ptr::null();
+
+            let result = find_all_fn(
+                self.callbacks.userdata,
+                handle,
+                input.as_ptr() as *const c_char,
+                input.len(),
+                pos,
+                &mut buffer,
+                &mut error_out,
+            );
+            if result < 0 {
+                return Err(callback_error(error_out, "Regex find_all failed"));
+            }
+
+            let written = match_slots
+                .get(..buffer.match_count)
+                .unwrap_or(&match_slots);
+            for m in written {
+                matches.push(RegexMatch {
+                    start: m.start,
+                    end: m.end,
+                    captures: self.convert_captures(m),
+                });
+            }
+
+            if result == 0 {
+                break;
+            }
+            if written.is_empty() {
+                // One match needs more capture slots than the pool has
+                if capture_slots.len() >= MAX_CAPTURE_SLOTS {
+                    return Err(String::from("Regex find_all made no progress"));
+                }
+                capture_slots.resize(capture_slots.len() * 2, EMPTY_CAPTURE);
+                continue;
+            }
+            if buffer.resume_pos <= pos {
+                return Err(String::from("Regex find_all made no progress"));
+            }
+            pos = buffer.resume_pos;
+        }
+
+        Ok(matches)
+    }
+
+    /// Split through the split callback, retrying once if the buffer is short.
+    fn split_bulk(&self, split_fn: TsRunRegexSplitFn, input: &str) -> Result<Vec<String>, String> {
+        let handle = *self.handle.borrow();
+        // Sized for ~32-byte pieces so line splits rarely need the second pass
+        let slots = (input.len() / 32).clamp(SPLIT_PIECE_SLOTS, MAX_SPLIT_PIECE_GUESS);
+        let mut pieces = alloc::vec![EMPTY_CAPTURE; slots];
+
+        loop {
+            let mut count = 0;
+            let mut error_out: *const c_char = ptr::null();
+
+            let result = split_fn(
+                self.callbacks.userdata,
+                handle,
+                input.as_ptr() as *const c_char,
+                input.len(),
+                pieces.as_mut_ptr(),
+                pieces.len(),
+                &mut count,
+                &mut error_out,
+            );
+
+            match result {
+                1 => {
+                    let written = pieces.get(..count).unwrap_or(&pieces);
+                    return written
+                        .iter()
+                        .map(|span| {
+                            usize::try_from(span.start)
+                                .ok()
+                                .zip(usize::try_from(span.end).ok())
+                                .and_then(|(start, end)| input.get(start..end))
+                                .map(String::from)
+                                .ok_or_else(|| String::from("Regex split returned an invalid span"))
+                        })
+                        .collect();
+                }
+                0 if count > pieces.len() => pieces.resize(count, EMPTY_CAPTURE),
+                0 => return Err(String::from("Regex split made no progress")),
+                _ => return Err(callback_error(error_out, "Regex split failed")),
+            }
+        }
+    }
+
+    /// Literal global replacement through the replace_all callback.
+    fn replace_all_bulk(
+        &self,
+        replace_all_fn: TsRunRegexReplaceAllFn,
+        input: &str,
+        replacement: &str,
+    ) -> Result<String, String> {
+        let handle = *self.handle.borrow();
+        let mut out: Vec<u8> = alloc::vec![0; input.len() + input.len() / 4 + 16];
+
+        loop {
+            let mut out_len = 0;
+            let mut error_out: *const c_char = ptr::null();
+
+            let result = replace_all_fn(
+                self.callbacks.userdata,
+                handle,
+                input.as_ptr() as *const c_char,
+                input.len(),
+                replacement.as_ptr() as *const c_char,
+                replacement.len(),
+                out.as_mut_ptr() as *mut c_char,
+                out.len(),
+                &mut out_len,
+                &mut error_out,
+            );
+
+            match result {
+                1 => {
+                    out.truncate(out_len);
+                    return String::from_utf8(out)
+                        .map_err(|_| String::from("Regex replace_all produced invalid UTF-8"));
+                }
+                0 if out_len > out.len() => out.resize(out_len, 0),
+                0 => return Err(String::from("Regex replace_all made no progress")),
+                _ => return Err(callback_error(error_out, "Regex replace_all failed")),
+            }
+        }
+    }
+
     /// Convert C captures to Rust format.
     fn convert_captures(&self, match_out: &TsRunRegexMatch) -> Vec<Option<(usize, usize)>> {
         let mut captures = Vec::new();
@@ -565,15 +842,81 @@ impl CCompiledRegex {
     }
 }
 
+/// Match slots per `find_all` call
+const FIND_ALL_MATCH_SLOTS: usize = 64;
+
+/// Initial capture slots per `find_all` call, grown for patterns with many groups
+const FIND_ALL_CAPTURE_SLOTS: usize = 256;
+
+/// Upper bound on the capture pool before `find_all` gives up
+const MAX_CAPTURE_SLOTS: usize = 1 << 16;
+
+/// Minimum piece slots for the first `split` call
+const SPLIT_PIECE_SLOTS: usize = 64;
+
+/// Largest first `split` buffer guessed from the input length
+const MAX_SPLIT_PIECE_GUESS: usize = 1 << 16;
+
+const EMPTY_MATCH: TsRunRegexMatch = TsRunRegexMatch {
+    start: 0,
+    end: 0,
+    captures: ptr::null_mut(),
+    capture_count: 0,
+};
+
+const EMPTY_CAPTURE: TsRunRegexCapture = TsRunRegexCapture { start: -1, end: -1 };
+
+/// Error message from a callback's `error_out`, or `default` if it set none.
+/// Byte offset just past the character starting at `pos`
+fn next_char_boundary(input: &str, pos: usize) -> usize {
+    let width = input
+        .get(pos..)
+        .and_then(|rest| rest.chars().next())
+        .map_or(1, char::len_utf8);
+    pos + width
+}
+
+fn callback_error(error_out: *const c_char, default: &str) -> String {
+    if error_out.is_null() {
+        return String::from(default);
+    }
+    unsafe { c_str_to_str(error_out) }
+        .map(String::from)
+        .unwrap_or_else(|| String::from(default))
+}
+
 // ============================================================================
 // FFI Functions
 // ============================================================================
 
+/// Copy a caller's callback bundle, leaving fields past its `size` NULL.
+///
+/// Returns `None` if `size` does not cover the required callbacks and
+/// `userdata`.
+///
+/// # Safety
+/// `callbacks` must point to at least `(*callbacks).size` readable bytes.
+unsafe fn read_callbacks(callbacks: *const TsRunRegexCallbacks) -> Option<TsRunRegexCallbacks> {
+    let size = unsafe { (*callbacks).size };
+    if size < core::mem::offset_of!(TsRunRegexCallbacks, find_all) {
+        return None;
+    }
+    let len = size.min(core::mem::size_of::<TsRunRegexCallbacks>());
+    let mut out = core::mem::MaybeUninit::<TsRunRegexCallbacks>::zeroed();
+    // Every field past `size` is an `Option` of a function pointer, for which
+    // all-zero bytes are `None`
+    unsafe {
+        ptr::copy_nonoverlapping(callbacks.cast::<u8>(), out.as_mut_ptr().cast::<u8>(), len);
+        Some(out.assume_init())
+    }
+}
+
 /// Set a custom RegExp provider using C callbacks.
 ///
 /// # Safety
 /// - `ctx` must be a valid `TsRunContext` pointer
 /// - `callbacks` must be a valid pointer to a `TsRunRegexCallbacks` struct
+///   whose `size` is set to the size of the struct the caller compiled
 /// - The callbacks must remain valid for as long as the context is used
 ///
 /// # Returns
@@ -596,7 +939,12 @@ pub extern "C" fn tsrun_set_regexp_provider(
     }
 
     let ctx = unsafe { &mut *ctx };
-    let callbacks = unsafe { *callbacks };
+    let Some(callbacks) = (unsafe { read_callbacks(callbacks) }) else {
+        return TsRunResult::err(
+            ctx,
+            String::from("callbacks.size must be sizeof(TsRunRegexCallbacks)"),
+        );
+    };
 
     // Create provider
     let provider = unsafe { CRegExpProvider::new(callbacks) };
@@ -606,3 +954,121 @@ pub extern "C" fn tsrun_set_regexp_provider(
 
     TsRunResult::success()
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // A byte-oriented engine compiled from an empty pattern: it matches the
+    // empty string at whatever offset it is asked to search from
+    extern "C" fn empty_is_match(
+        _userdata: *mut c_void,
+        _handle: *mut c_void,
+        _input: *const c_char,
+        _input_len: usize,
+        _error_out: *mut *const c_char,
+    ) -> i32 {
+        1
+    }
+
+    extern "C" fn empty_find(
+        _userdata: *mut c_void,
+        _handle: *mut c_void,
+        _input: *const c_char,
+        input_len: usize,
+        start_pos: usize,
+        match_out: *mut TsRunRegexMatch,
+        _error_out: *mut *const c_char,
+    ) -> i32 {
+        if start_pos > input_len {
+            return 0;
+        }
+        if let Some(m) = unsafe { match_out.as_mut() } {
+            m.start = start_pos;
+            m.end = start_pos;
+        }
+        1
+    }
+
+    extern "C" fn no_free(_userdata: *mut c_void, _handle: *mut c_void) {}
+
+    fn empty_regex() -> CCompiledRegex {
+        CCompiledRegex {
+            handle: RefCell::new(ptr::null_mut()),
+            callbacks: CRegexCallbacksRef {
+                is_match: empty_is_match,
+                find: empty_find,
+                free: no_free,
+                free_captures: None,
+                find_all: None,
+                replace_all: None,
+                split: None,
+                userdata: ptr::null_mut(),
+            },
+            flags: String::new(),
+        }
+    }
+
+    extern "C" fn no_compile(
+        _userdata: *mut c_void,
+        _pattern: *const c_char,
+        _flags: *const c_char,
+        _error_out: *mut *const c_char,
+    ) -> *mut c_void {
+        ptr::null_mut()
+    }
+
+    extern "C" fn no_split(
+        _userdata: *mut c_void,
+        _handle: *mut c_void,
+        _input: *const c_char,
+        _input_len: usize,
+        _pieces: *mut TsRunRegexCapture,
+        _capacity: usize,
+        _count_out: *mut usize,
+        _error_out: *mut *const c_char,
+    ) -> i32 {
+        -1
+    }
+
+    #[test]
+    fn test_callbacks_past_size_are_null() {
+        let mut callbacks = TsRunRegexCallbacks {
+            size: core::mem::size_of::<TsRunRegexCallbacks>(),
+            compile: no_compile,
+            is_match: empty_is_match,
+            find: empty_find,
+            free: no_free,
+            free_captures: None,
+            userdata: ptr::null_mut(),
+            find_all: None,
+            replace_all: None,
+            split: Some(no_split),
+        };
+        let full = unsafe { read_callbacks(&callbacks) };
+        assert!(full.is_some_and(|c| c.split.is_some()));
+
+        // A caller compiled before `split` existed
+        callbacks.size = core::mem::offset_of!(TsRunRegexCallbacks, split);
+        let older = unsafe { read_callbacks(&callbacks) };
+        assert!(older.is_some_and(|c| c.split.is_none()));
+
+        // Too small to hold the required callbacks
+        callbacks.size = 0;
+        assert!(unsafe { read_callbacks(&callbacks) }.is_none());
+    }
+
+    #[test]
+    fn test_split_on_empty_pattern_keeps_multibyte_chars() {
+        let pieces = empty_regex().split("héllo→").unwrap_or_default();
+        assert_eq!(pieces, ["", "h", "é", "l", "l", "o", "→", ""]);
+    }
+
+    #[test]
+    fn test_zero_width_matches_land_on_char_boundaries() {
+        let input = "aé→";
+        let matches = empty_regex().find_all_matches(input).unwrap_or_default();
+        let starts: Vec<usize> = matches.iter().map(|m| m.start).collect();
+        assert_eq!(starts, [0, 1, 3, 6]);
+    }
+}
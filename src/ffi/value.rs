@@ -7,15 +7,15 @@ use alloc::format;
 use alloc::string::ToString;
 use alloc::vec;
 use alloc::vec::Vec;
-use core::ffi::c_char;
+use core::ffi::{c_char, c_void};
 use core::ptr;
 
-use crate::value::{CheapClone, ExoticObject, PropertyKey};
-use crate::{JsString, JsValue};
+use crate::value::{ByteStore, CheapClone, ExoticObject, PropertyKey};
+use crate::{JsError, JsString, JsValue};
 
 use super::{
-    TsRunContext, TsRunResult, TsRunType, TsRunValue, TsRunValueResult, c_str_to_str,
-    str_to_c_string,
+    TsRunBufferResult, TsRunContext, TsRunExternalFreeFn, TsRunJsonParser, TsRunKey, TsRunResult,
+    TsRunType, TsRunValue, TsRunValueResult, TsRunWriteFn, c_str_to_str, str_to_c_string,
 };
 
 // ============================================================================
@@ -546,6 +546,155 @@ pub extern "C" fn tsrun_keys(
     ptr
 }
 
+// ============================================================================
+// Interned Property Keys
+// ============================================================================
+
+/// Intern a property key for repeated use with tsrun_get_k/tsrun_set_k/tsrun_has_k.
+///
+/// The key string is shared with the context's string dictionary, so lookups
+/// through the returned handle allocate nothing. Returns NULL if `key` is NULL
+/// or not valid UTF-8. The handle must be freed with tsrun_key_free and must
+/// only be used with the context that created it.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_key_intern(ctx: *mut TsRunContext, key: *const c_char) -> *mut TsRunKey {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => return ptr::null_mut(),
+    };
+
+    let key_str = match unsafe { c_str_to_str(key) } {
+        Some(s) => s,
+        None => return ptr::null_mut(),
+    };
+
+    let interned = ctx.interp.string_dict.get_or_insert(key_str);
+    Box::into_raw(Box::new(TsRunKey {
+        key: PropertyKey::String(interned),
+    }))
+}
+
+/// Free an interned key handle.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_key_free(key: *mut TsRunKey) {
+    if !key.is_null() {
+        unsafe {
+            drop(Box::from_raw(key));
+        }
+    }
+}
+
+/// Get a property from an object using an interned key.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_get_k(
+    ctx: *mut TsRunContext,
+    obj: *mut TsRunValue,
+    key: *const TsRunKey,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let obj_val = match unsafe { obj.as_ref() } {
+        Some(v) => v,
+        None => return TsRunValueResult::err(ctx, "NULL object".to_string()),
+    };
+
+    let key = match unsafe { key.as_ref() } {
+        Some(k) => k,
+        None => return TsRunValueResult::err(ctx, "NULL key".to_string()),
+    };
+
+    let JsValue::Object(obj_ref) = obj_val.value() else {
+        return TsRunValueResult::err(ctx, "Value is not an object".to_string());
+    };
+
+    let value = obj_ref
+        .borrow()
+        .get_property(&key.key)
+        .unwrap_or(JsValue::Undefined);
+
+    TsRunValueResult::ok(TsRunValue::from_js_value(&mut ctx.interp, value))
+}
+
+/// Set a property on an object using an interned key.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_set_k(
+    ctx: *mut TsRunContext,
+    obj: *mut TsRunValue,
+    key: *const TsRunKey,
+    val: *mut TsRunValue,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let obj_val = match unsafe { obj.as_ref() } {
+        Some(v) => v,
+        None => return TsRunResult::err(ctx, "NULL object".to_string()),
+    };
+
+    let key = match unsafe { key.as_ref() } {
+        Some(k) => k,
+        None => return TsRunResult::err(ctx, "NULL key".to_string()),
+    };
+
+    let val_ref = match unsafe { val.as_ref() } {
+        Some(v) => v,
+        None => return TsRunResult::err(ctx, "NULL value".to_string()),
+    };
+
+    let JsValue::Object(obj_ref) = obj_val.value() else {
+        return TsRunResult::err(ctx, "Value is not an object".to_string());
+    };
+
+    obj_ref
+        .borrow_mut()
+        .set_property(key.key.clone(), val_ref.value().clone());
+
+    TsRunResult::success()
+}
+
+/// Check if an object has a property using an interned key.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_has_k(
+    ctx: *mut TsRunContext,
+    obj: *mut TsRunValue,
+    key: *const TsRunKey,
+) -> bool {
+    if ctx.is_null() {
+        return false;
+    }
+
+    let obj_val = match unsafe { obj.as_ref() } {
+        Some(v) => v,
+        None => return false,
+    };
+
+    let key = match unsafe { key.as_ref() } {
+        Some(k) => k,
+        None => return false,
+    };
+
+    let JsValue::Object(obj_ref) = obj_val.value() else {
+        return false;
+    };
+
+    obj_ref.borrow().get_property(&key.key).is_some()
+}
+
 // ============================================================================
 // Array Operations
 // ============================================================================
@@ -597,7 +746,7 @@ pub extern "C" fn tsrun_array_get(
         return TsRunValueResult::err(ctx, "Value is not an array".to_string());
     };
 
-    let value = elements.get(index).cloned().unwrap_or(JsValue::Undefined);
+    let value = elements.get(index).unwrap_or(JsValue::Undefined);
     drop(borrowed);
 
     TsRunValueResult::ok(TsRunValue::from_js_value(&mut ctx.interp, value))
@@ -640,14 +789,8 @@ pub extern "C" fn tsrun_array_set(
         return TsRunResult::err(ctx, "Value is not an array".to_string());
     };
 
-    // Extend array if needed
-    while elements.len() <= index {
-        elements.push(JsValue::Undefined);
-    }
-
-    if let Some(elem) = elements.get_mut(index) {
-        *elem = val_ref.value().clone();
-    }
+    // Extends the array if needed
+    elements.set(index, val_ref.value().clone());
 
     // Update length property
     let new_len = elements.len();
@@ -708,6 +851,201 @@ pub extern "C" fn tsrun_array_push(
     TsRunResult::success()
 }
 
+// ============================================================================
+// Bulk Extraction
+// ============================================================================
+
+/// Get several properties from an object in one call.
+///
+/// Writes one value handle per key into `out_values[0..n]`; each must be freed
+/// with tsrun_value_free. Missing properties yield undefined. On error nothing
+/// is written to `out_values`.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_get_many(
+    ctx: *mut TsRunContext,
+    obj: *mut TsRunValue,
+    keys: *const *const TsRunKey,
+    n: usize,
+    out_values: *mut *mut TsRunValue,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let obj_val = match unsafe { obj.as_ref() } {
+        Some(v) => v,
+        None => return TsRunResult::err(ctx, "NULL object".to_string()),
+    };
+
+    if n == 0 {
+        return TsRunResult::success();
+    }
+    if keys.is_null() || out_values.is_null() {
+        return TsRunResult::err(ctx, "NULL keys or output array".to_string());
+    }
+
+    let JsValue::Object(obj_ref) = obj_val.value() else {
+        return TsRunResult::err(ctx, "Value is not an object".to_string());
+    };
+
+    // SAFETY: caller guarantees keys points to n key handles
+    let keys = unsafe { core::slice::from_raw_parts(keys, n) };
+    let mut values: Vec<JsValue> = Vec::with_capacity(n);
+    {
+        let borrowed = obj_ref.borrow();
+        for key_ptr in keys {
+            let Some(key) = (unsafe { key_ptr.as_ref() }) else {
+                drop(borrowed);
+                return TsRunResult::err(ctx, "NULL key".to_string());
+            };
+            values.push(
+                borrowed
+                    .get_property(&key.key)
+                    .unwrap_or(JsValue::Undefined),
+            );
+        }
+    }
+
+    for (i, value) in values.into_iter().enumerate() {
+        let handle = Box::into_raw(TsRunValue::from_js_value(&mut ctx.interp, value));
+        // SAFETY: caller guarantees out_values has room for n handles
+        unsafe { *out_values.add(i) = handle };
+    }
+
+    TsRunResult::success()
+}
+
+/// Copy numeric array elements into a caller buffer without creating handles.
+///
+/// Copies at most `n` elements into `out`; non-number elements are written as
+/// NaN. Returns the number of elements written (0 if `arr` is not an array).
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_array_read_numbers(
+    ctx: *mut TsRunContext,
+    arr: *mut TsRunValue,
+    out: *mut f64,
+    n: usize,
+) -> usize {
+    if ctx.is_null() || out.is_null() {
+        return 0;
+    }
+
+    let Some(JsValue::Object(obj_ref)) = (unsafe { arr.as_ref() }).map(|v| v.value()) else {
+        return 0;
+    };
+
+    let borrowed = obj_ref.borrow();
+    let ExoticObject::Array { elements } = &borrowed.exotic else {
+        return 0;
+    };
+
+    let count = elements.len().min(n);
+    // SAFETY: caller guarantees out has room for n doubles, count <= n
+    let out = unsafe { core::slice::from_raw_parts_mut(out, count) };
+    if let Some(numbers) = elements.as_f64_slice() {
+        out.copy_from_slice(numbers.get(..count).unwrap_or_default());
+        return count;
+    }
+    for (slot, elem) in out.iter_mut().zip(elements.iter()) {
+        *slot = match elem {
+            JsValue::Number(num) => num,
+            _ => f64::NAN,
+        };
+    }
+    count
+}
+
+/// Borrow the packed number storage of an array without copying.
+///
+/// Returns NULL if `arr` is not an array or its elements are not all numbers.
+/// On success writes the element count to `out_len` (if non-NULL). The pointer
+/// stays valid while `arr` is alive and until the array is next modified.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_array_as_f64_slice(
+    ctx: *mut TsRunContext,
+    arr: *mut TsRunValue,
+    out_len: *mut usize,
+) -> *const f64 {
+    if ctx.is_null() {
+        return ptr::null();
+    }
+
+    let Some(JsValue::Object(obj_ref)) = (unsafe { arr.as_ref() }).map(|v| v.value()) else {
+        return ptr::null();
+    };
+
+    let borrowed = obj_ref.borrow();
+    let Some(numbers) = borrowed
+        .array_storage()
+        .and_then(|elements| elements.as_f64_slice())
+    else {
+        return ptr::null();
+    };
+
+    if !out_len.is_null() {
+        // SAFETY: out_len checked non-NULL above
+        unsafe { *out_len = numbers.len() };
+    }
+    numbers.as_ptr()
+}
+
+/// Copy one numeric field of every object element of an array into a caller buffer.
+///
+/// For `arr = [{x: 1}, {x: 2}]` and `key = "x"`, writes `[1, 2]`. Elements that
+/// are not objects, or whose field is missing or not a number, are written as
+/// NaN. Copies at most `n` elements and returns the number written.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_array_read_f64_field(
+    ctx: *mut TsRunContext,
+    arr: *mut TsRunValue,
+    key: *const c_char,
+    out: *mut f64,
+    n: usize,
+) -> usize {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => return 0,
+    };
+    if out.is_null() {
+        return 0;
+    }
+
+    let Some(JsValue::Object(obj_ref)) = (unsafe { arr.as_ref() }).map(|v| v.value()) else {
+        return 0;
+    };
+
+    let key_str = match unsafe { c_str_to_str(key) } {
+        Some(s) => s,
+        None => return 0,
+    };
+    let prop_key = PropertyKey::String(ctx.interp.string_dict.get_or_insert(key_str));
+
+    let borrowed = obj_ref.borrow();
+    let ExoticObject::Array { elements } = &borrowed.exotic else {
+        return 0;
+    };
+
+    let count = elements.len().min(n);
+    // SAFETY: caller guarantees out has room for n doubles, count <= n
+    let out = unsafe { core::slice::from_raw_parts_mut(out, count) };
+    for (slot, elem) in out.iter_mut().zip(elements.iter()) {
+        *slot = match elem {
+            JsValue::Object(row) => match row.borrow().get_property(&prop_key) {
+                Some(JsValue::Number(num)) => num,
+                _ => f64::NAN,
+            },
+            _ => f64::NAN,
+        };
+    }
+    count
+}
+
 // ============================================================================
 // JSON Operations
 // ============================================================================
@@ -771,14 +1109,13 @@ pub extern "C" fn tsrun_json_stringify(
         None => return ptr::null_mut(),
     };
 
-    match crate::js_value_to_json(val_ref.value()) {
-        Ok(json_value) => match serde_json::to_string(&json_value) {
-            Ok(s) => str_to_c_string(&s),
-            Err(_) => {
-                ctx.set_error("JSON stringify error".to_string());
-                ptr::null_mut()
-            }
-        },
+    let mut output = alloc::string::String::new();
+    let written = crate::json_stringify_to(val_ref.value(), |chunk| {
+        output.push_str(chunk);
+        Ok(())
+    });
+    match written {
+        Ok(()) => str_to_c_string(&output),
         Err(e) => {
             ctx.set_error(e.to_string());
             ptr::null_mut()
@@ -786,6 +1123,237 @@ pub extern "C" fn tsrun_json_stringify(
     }
 }
 
+/// Serialize a value to JSON, passing the output to `write` in chunks.
+///
+/// No complete copy of the output is held in memory. Chunks already passed
+/// to `write` are not retracted if serialization fails later (e.g. on a
+/// circular reference) or `write` returns false.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_json_stringify_to(
+    ctx: *mut TsRunContext,
+    val: *mut TsRunValue,
+    write: Option<TsRunWriteFn>,
+    userdata: *mut c_void,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let val_ref = match unsafe { val.as_ref() } {
+        Some(v) => v,
+        None => return TsRunResult::err(ctx, "NULL value".to_string()),
+    };
+
+    let Some(write) = write else {
+        return TsRunResult::err(ctx, "NULL write callback".to_string());
+    };
+
+    let written = crate::json_stringify_to(val_ref.value(), |chunk| {
+        if write(chunk.as_ptr() as *const c_char, chunk.len(), userdata) {
+            Ok(())
+        } else {
+            Err(JsError::internal_error("JSON write callback aborted"))
+        }
+    });
+    match written {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => TsRunResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Create an incremental JSON parser for the context.
+///
+/// Feed input with tsrun_json_parser_feed, then call tsrun_json_parser_finish
+/// (or tsrun_json_parser_free to abandon it). Returns NULL if ctx is NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_json_parser_new(ctx: *mut TsRunContext) -> *mut TsRunJsonParser {
+    let ctx = match unsafe { ctx.as_ref() } {
+        Some(c) => c,
+        None => return ptr::null_mut(),
+    };
+
+    Box::into_raw(Box::new(TsRunJsonParser {
+        parser: crate::JsonStreamParser::new(&ctx.interp),
+    }))
+}
+
+/// Feed the next `len` bytes of JSON text to a parser.
+///
+/// Chunks may split the input anywhere, including inside strings and
+/// multi-byte characters. After an error the parser stays failed.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_json_parser_feed(
+    ctx: *mut TsRunContext,
+    parser: *mut TsRunJsonParser,
+    data: *const c_char,
+    len: usize,
+) -> TsRunResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunResult {
+                ok: false,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let parser = match unsafe { parser.as_mut() } {
+        Some(p) => p,
+        None => return TsRunResult::err(ctx, "NULL parser".to_string()),
+    };
+
+    let bytes: &[u8] = if len == 0 {
+        &[]
+    } else if data.is_null() {
+        return TsRunResult::err(ctx, "NULL data".to_string());
+    } else {
+        // SAFETY: caller guarantees data points to len readable bytes
+        unsafe { core::slice::from_raw_parts(data as *const u8, len) }
+    };
+
+    match parser.parser.feed(&mut ctx.interp, bytes) {
+        Ok(()) => TsRunResult::success(),
+        Err(e) => TsRunResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Finish parsing and return the parsed value.
+///
+/// Consumes the parser: it must not be used or freed afterwards, whether
+/// or not parsing succeeded.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_json_parser_finish(
+    ctx: *mut TsRunContext,
+    parser: *mut TsRunJsonParser,
+) -> TsRunValueResult {
+    if parser.is_null() {
+        return match unsafe { ctx.as_mut() } {
+            Some(ctx) => TsRunValueResult::err(ctx, "NULL parser".to_string()),
+            None => TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            },
+        };
+    }
+    // SAFETY: parser came from tsrun_json_parser_new and is not used again
+    let parser = unsafe { Box::from_raw(parser) };
+
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    match parser.parser.finish() {
+        Ok(guarded) => TsRunValueResult::ok(Box::new(TsRunValue {
+            inner: crate::RuntimeValue::from_guarded(guarded),
+        })),
+        Err(e) => TsRunValueResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Free a parser without finishing it.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_json_parser_free(parser: *mut TsRunJsonParser) {
+    if !parser.is_null() {
+        // SAFETY: parser came from tsrun_json_parser_new
+        drop(unsafe { Box::from_raw(parser) });
+    }
+}
+
+// ============================================================================
+// Binary Value Transfer
+// ============================================================================
+
+/// Serialize a value and everything reachable from it into one buffer.
+///
+/// The format (see `value_codec`) keeps undefined, non-finite numbers, -0,
+/// binary data, shared sub-objects and cycles, and writes repeated strings
+/// once. Free the buffer with tsrun_buffer_free.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_encode_value(
+    ctx: *mut TsRunContext,
+    val: *const TsRunValue,
+) -> TsRunBufferResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunBufferResult {
+                data: ptr::null_mut(),
+                len: 0,
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let val_ref = match unsafe { val.as_ref() } {
+        Some(v) => v,
+        None => return TsRunBufferResult::err(ctx, "NULL value".to_string()),
+    };
+
+    match crate::encode_value(val_ref.value()) {
+        Ok(bytes) => TsRunBufferResult::ok(bytes),
+        Err(e) => TsRunBufferResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Rebuild a value from a buffer in the tsrun_encode_value format.
+///
+/// The buffer is only read during the call.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_decode_value(
+    ctx: *mut TsRunContext,
+    data: *const u8,
+    len: usize,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    if data.is_null() {
+        return TsRunValueResult::err(ctx, "NULL buffer".to_string());
+    }
+    // SAFETY: Caller guarantees data points to len readable bytes
+    let bytes = unsafe { core::slice::from_raw_parts(data, len) };
+
+    match crate::decode_value(&mut ctx.interp, bytes) {
+        Ok(guarded) => TsRunValueResult::ok(Box::new(TsRunValue {
+            inner: crate::RuntimeValue::from_guarded(guarded),
+        })),
+        Err(e) => TsRunValueResult::err(ctx, e.to_string()),
+    }
+}
+
+/// Free a buffer returned by tsrun_encode_value.
+///
+/// # Safety
+/// `data` must be a pointer returned by tsrun_encode_value (or NULL), and
+/// `len` must match the length returned with it.
+#[unsafe(no_mangle)]
+pub unsafe extern "C" fn tsrun_buffer_free(data: *mut u8, len: usize) {
+    if !data.is_null() {
+        // SAFETY: data/len came from a boxed slice in TsRunBufferResult::ok
+        unsafe { drop(Box::from_raw(ptr::slice_from_raw_parts_mut(data, len))) };
+    }
+}
+
 // ============================================================================
 // Object/Array Creation
 // ============================================================================
@@ -830,6 +1398,168 @@ pub extern "C" fn tsrun_array_new(ctx: *mut TsRunContext) -> TsRunValueResult {
     }))
 }
 
+// ============================================================================
+// Binary Data and External Memory
+// ============================================================================
+
+/// Release closure calling a host's free callback, if it gave one
+fn external_release(
+    data: *mut c_void,
+    len: usize,
+    free_cb: Option<TsRunExternalFreeFn>,
+    userdata: *mut c_void,
+) -> Option<Box<dyn FnOnce()>> {
+    free_cb.map(|free_cb| Box::new(move || free_cb(data, len, userdata)) as Box<dyn FnOnce()>)
+}
+
+/// Create an ArrayBuffer holding a copy of `len` bytes at `data`
+/// (zero-filled if `data` is NULL, which fails past `ByteStore::MAX_ZEROED_LEN`
+/// or when the memory cannot be allocated).
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_arraybuffer_new(
+    ctx: *mut TsRunContext,
+    data: *const c_void,
+    len: usize,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    let store = if data.is_null() || len == 0 {
+        match ByteStore::zeroed(len) {
+            Ok(store) => store,
+            Err(e) => return TsRunValueResult::err(ctx, e.to_string()),
+        }
+    } else {
+        // SAFETY: caller guarantees `len` readable bytes at `data`
+        ByteStore::new(unsafe { core::slice::from_raw_parts(data as *const u8, len) }.to_vec())
+    };
+
+    let guard = ctx.interp.heap.create_guard();
+    let buffer = ctx.interp.create_array_buffer(&guard, store);
+    TsRunValueResult::ok(Box::new(TsRunValue {
+        inner: crate::RuntimeValue::with_guard(JsValue::Object(buffer), guard),
+    }))
+}
+
+/// Create an ArrayBuffer over `len` bytes of host memory at `data`, without
+/// copying.
+///
+/// Scripts and views read and write the memory directly. It must stay valid
+/// until `free_cb` is called (forever if `free_cb` is NULL), and the host may
+/// only touch it while no script is running. `structuredClone` and snapshots
+/// copy the bytes instead of sharing them.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_arraybuffer_external(
+    ctx: *mut TsRunContext,
+    data: *mut c_void,
+    len: usize,
+    free_cb: Option<TsRunExternalFreeFn>,
+    userdata: *mut c_void,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    if data.is_null() && len > 0 {
+        return TsRunValueResult::err(ctx, "NULL data".to_string());
+    }
+
+    let release = external_release(data, len, free_cb, userdata);
+    // SAFETY: the caller guarantees the memory contract documented above
+    let store = unsafe { ByteStore::external(data as *mut u8, len, release) };
+    let guard = ctx.interp.heap.create_guard();
+    let buffer = ctx.interp.create_array_buffer(&guard, store);
+    TsRunValueResult::ok(Box::new(TsRunValue {
+        inner: crate::RuntimeValue::with_guard(JsValue::Object(buffer), guard),
+    }))
+}
+
+/// Borrow the bytes of an ArrayBuffer, typed array or DataView in place.
+///
+/// For a view, points at its first byte and reports its byte length. Returns
+/// NULL if `val` is none of these. Writes the length to `len_out` (if
+/// non-NULL). The pointer stays valid while `val` is alive.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_arraybuffer_data(val: *const TsRunValue, len_out: *mut usize) -> *mut u8 {
+    let Some(JsValue::Object(obj)) = (unsafe { val.as_ref() }).map(|v| v.value()) else {
+        return ptr::null_mut();
+    };
+
+    let (store, offset, len) = match &obj.borrow().exotic {
+        ExoticObject::ArrayBuffer(store) => (store.cheap_clone(), 0, store.len()),
+        ExoticObject::TypedArray(data) => (
+            data.store.cheap_clone(),
+            data.byte_offset,
+            data.byte_length(),
+        ),
+        ExoticObject::DataView(data) => {
+            (data.store.cheap_clone(), data.byte_offset, data.byte_length)
+        }
+        _ => return ptr::null_mut(),
+    };
+
+    if !len_out.is_null() {
+        // SAFETY: len_out checked non-NULL above
+        unsafe { *len_out = len };
+    }
+    // Views are always within their store, so the offset stays in bounds
+    store.as_mut_ptr().wrapping_add(offset)
+}
+
+/// Create a string over `len` bytes of host-owned UTF-8 at `data`, without
+/// copying.
+///
+/// The memory must stay valid and unchanged until `free_cb` is called (forever
+/// if `free_cb` is NULL). Fails on invalid UTF-8, in which case the memory
+/// stays the caller's and `free_cb` is not called.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_string_external(
+    ctx: *mut TsRunContext,
+    data: *const c_char,
+    len: usize,
+    free_cb: Option<TsRunExternalFreeFn>,
+    userdata: *mut c_void,
+) -> TsRunValueResult {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return TsRunValueResult {
+                value: ptr::null_mut(),
+                error: c"NULL context".as_ptr(),
+            };
+        }
+    };
+
+    if data.is_null() && len > 0 {
+        return TsRunValueResult::err(ctx, "NULL data".to_string());
+    }
+
+    let release = external_release(data as *mut c_void, len, free_cb, userdata);
+    // SAFETY: the caller guarantees the memory contract documented above
+    let string = match unsafe { JsString::from_external(data as *const u8, len, release) } {
+        Ok(s) => s,
+        Err(e) => return TsRunValueResult::err(ctx, format!("invalid UTF-8: {}", e)),
+    };
+
+    TsRunValueResult::ok(TsRunValue::from_js_value(
+        &mut ctx.interp,
+        JsValue::String(string),
+    ))
+}
+
 // ============================================================================
 // Function Calls
 // ============================================================================
@@ -1038,6 +1768,8 @@ pub extern "C" fn tsrun_gc_stats(ctx: *mut TsRunContext) -> super::TsRunGcStats
                 total_objects: 0,
                 pooled_objects: 0,
                 live_objects: 0,
+                reserved_bytes: 0,
+                used_bytes: 0,
             };
         }
     };
@@ -1047,5 +1779,83 @@ pub extern "C" fn tsrun_gc_stats(ctx: *mut TsRunContext) -> super::TsRunGcStats
         total_objects: stats.total_objects,
         pooled_objects: stats.pooled_objects,
         live_objects: stats.live_objects,
+        reserved_bytes: stats.reserved_bytes,
+        used_bytes: stats.used_bytes,
+    }
+}
+
+/// Collect garbage and return every fully empty chunk of GC slots to the
+/// allocator.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_gc_shrink(ctx: *mut TsRunContext) {
+    if let Some(ctx) = unsafe { ctx.as_mut() } {
+        ctx.interp.shrink_heap();
+    }
+}
+
+/// Collect incrementally with at most `microseconds` per collection slice.
+///
+/// 0 (the default) collects the whole heap in one pause.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_gc_set_budget(ctx: *mut TsRunContext, microseconds: u64) {
+    if let Some(ctx) = unsafe { ctx.as_mut() } {
+        ctx.interp.set_gc_budget(microseconds);
+    }
+}
+
+/// Get inline cache statistics.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_ic_stats(ctx: *mut TsRunContext) -> super::TsRunIcStats {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return super::TsRunIcStats {
+                hits: 0,
+                misses: 0,
+                megamorphic_sites: 0,
+            };
+        }
+    };
+
+    let stats = ctx.interp.inline_cache_stats();
+    super::TsRunIcStats {
+        hits: stats.hits,
+        misses: stats.misses,
+        megamorphic_sites: stats.megamorphic_sites,
+    }
+}
+
+/// Get compiled-regex cache statistics.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_regexp_cache_stats(ctx: *mut TsRunContext) -> super::TsRunRegexCacheStats {
+    let ctx = match unsafe { ctx.as_mut() } {
+        Some(c) => c,
+        None => {
+            return super::TsRunRegexCacheStats {
+                hits: 0,
+                misses: 0,
+                entries: 0,
+                capacity: 0,
+            };
+        }
+    };
+
+    let stats = ctx.interp.regexp_cache_stats();
+    super::TsRunRegexCacheStats {
+        hits: stats.hits,
+        misses: stats.misses,
+        entries: stats.entries,
+        capacity: stats.capacity,
+    }
+}
+
+/// Set how many compiled regexes the context caches (0 = no caching).
+///
+/// The cache is shared by all RegExp objects and sits in front of the RegExp
+/// provider, including one set with `tsrun_set_regexp_provider`.
+#[unsafe(no_mangle)]
+pub extern "C" fn tsrun_regexp_cache_set_capacity(ctx: *mut TsRunContext, capacity: usize) {
+    if let Some(ctx) = unsafe { ctx.as_mut() } {
+        ctx.interp.set_regexp_cache_capacity(capacity);
     }
 }
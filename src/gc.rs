@@ -35,6 +35,35 @@
 //! Collection runs automatically when `net_allocs >= gc_threshold`.
 //! Set threshold to 0 to disable automatic collection.
 //!
+//! # Object Limit
+//!
+//! `Heap::set_object_limit` caps the number of live objects. When an
+//! allocation needs a fresh slot at the limit, a full collection runs first;
+//! if nothing is reclaimed the allocation still succeeds but
+//! `Heap::limit_exceeded` turns true, and stays true until a collection
+//! brings the heap back under the limit. Allocation never fails, so the
+//! flag is what callers (the VM run loop) check to stop the program.
+//!
+//! # Incremental Collection
+//!
+//! By default a collection marks and sweeps the whole heap in one pause.
+//! With a slice budget (`Heap::set_gc_budget`) a collection instead runs in
+//! slices of at most that many microseconds, one slice every `gc_threshold`
+//! allocations, interleaved with the program:
+//!
+//! - Objects allocated while a collection runs are born marked.
+//! - [`Gc::borrow_mut`] is the write barrier: borrowing an object that was
+//!   already marked queues it to be traced again, so references stored into
+//!   it are not missed.
+//! - When marking runs out of work, a short final step rescans the guard
+//!   roots and re-traces objects whose references change without
+//!   `borrow_mut` (see [`Traceable::needs_final_trace`]), then sweeping runs
+//!   chunk by chunk.
+//!
+//! The final step is proportional to the root set rather than the heap. If
+//! the program allocates more objects during a collection than were live
+//! when it started, the collection finishes without a budget to bound memory.
+//!
 //! ```
 //! use tsrun::Interpreter;
 //!
@@ -200,9 +229,35 @@ impl<T: Default + Reset + Traceable> Gc<T> {
         unsafe { self.ptr.as_ref().data.borrow() }
     }
 
-    /// Borrow the inner data mutably
+    /// Borrow the inner data mutably.
+    ///
+    /// This is the incremental collector's write barrier: an object already
+    /// marked by a running collection is queued to be traced again.
+    #[inline]
     pub fn borrow_mut(&self) -> RefMut<'_, T> {
-        unsafe { self.ptr.as_ref().data.borrow_mut() }
+        let gc_box = unsafe { self.ptr.as_ref() };
+        if gc_box.barrier.get() {
+            self.write_barrier(gc_box);
+        }
+        gc_box.data.borrow_mut()
+    }
+
+    #[cold]
+    #[inline(never)]
+    fn write_barrier(&self, gc_box: &GcBox<T>) {
+        // The space is never borrowed while mutator code runs, so this only
+        // fails during teardown, when there is no collection to inform
+        if let Some(space) = self.space.upgrade()
+            && let Ok(mut space) = space.try_borrow_mut()
+        {
+            gc_box.barrier.set(false);
+            space.record_write(self.ptr);
+        }
+    }
+
+    /// Number of handles and guard roots referring to the object
+    pub(crate) fn ref_count(&self) -> usize {
+        unsafe { self.ptr.as_ref() }.ref_count.get()
     }
 
     /// Get the object's unique ID (pointer address)
@@ -247,9 +302,11 @@ impl<T: Default + Reset + Traceable> Clone for GcPtr<T> {
 
 impl<T: Default + Reset + Traceable> Clone for Gc<T> {
     fn clone(&self) -> Self {
-        // Increment ref_count (only if space is still alive)
-        if let Some(_space) = self.space.upgrade() {
+        // Increment ref_count (only if space is still alive). Checking the
+        // strong count rather than upgrading avoids touching it twice.
+        if self.space.strong_count() > 0 {
             let gc_box = unsafe { self.ptr.as_ref() };
+            gc_box.handles.set(gc_box.handles.get() + 1);
             // Only increment if not pooled
             if !gc_box.pooled.get() {
                 gc_box.ref_count.set(gc_box.ref_count.get() + 1);
@@ -267,12 +324,13 @@ impl<T: Default + Reset + Traceable> Drop for Gc<T> {
         // SAFETY: Check if space is still alive BEFORE accessing ptr.
         // If space is dropped, the GcBox memory is freed and ptr is dangling.
         // This happens during interpreter shutdown when Gc fields outlive the heap.
-        let Some(space_rc) = self.space.upgrade() else {
+        if self.space.strong_count() == 0 {
             return; // Space is gone, ptr is dangling - do nothing
-        };
+        }
 
         // Now safe to access the GcBox
         let gc_box = unsafe { self.ptr.as_ref() };
+        gc_box.handles.set(gc_box.handles.get().saturating_sub(1));
 
         // Check if this Gc is from a different generation (object was reused)
         // In that case, don't affect ref_count - this Gc is stale
@@ -289,7 +347,9 @@ impl<T: Default + Reset + Traceable> Drop for Gc<T> {
             gc_box.ref_count.set(count - 1);
         }
         // If ref_count is 0, reset and pool the object immediately
-        if gc_box.ref_count.get() == 0 {
+        if gc_box.ref_count.get() == 0
+            && let Some(space_rc) = self.space.upgrade()
+        {
             // Try to borrow - if already borrowed (e.g., during GC), skip pooling
             if let Ok(mut space) = space_rc.try_borrow_mut() {
                 // Reset to clear references before pooling
@@ -320,6 +380,13 @@ pub trait Traceable: Sized + Default + Reset {
     /// The implementation should call `visitor` for each `Gc<T>` stored in fields,
     /// using `gc.copy_ref()` to get a `GcPtr` (which has no Drop to avoid ref_count changes).
     fn trace<F: FnMut(GcPtr<Self>)>(&self, visitor: F);
+
+    /// Whether this object's references can change without [`Gc::borrow_mut`],
+    /// e.g. through state shared behind an `Rc<RefCell<_>>`. Incremental
+    /// collection traces such objects again before sweeping.
+    fn needs_final_trace(&self) -> bool {
+        false
+    }
 }
 
 // ============================================================================
@@ -352,6 +419,15 @@ pub struct GcBox<T: Default + Reset + Traceable> {
 
     /// Whether this object is in the pool (dead)
     pooled: Cell<bool>,
+
+    /// Live `Gc` handles pointing at this slot, stale ones included. Unlike
+    /// `ref_count` this is exact, so a chunk whose slots are all pooled with
+    /// no handles can be released without leaving dangling pointers.
+    handles: Cell<usize>,
+
+    /// Set when a running incremental collection has marked this object;
+    /// the next `borrow_mut` queues it to be traced again
+    barrier: Cell<bool>,
     // Generation counter - incremented each time slot is reused from pool.
     // Old Gc pointers with different generations don't affect ref_count.
     // generation: Cell<u32>,
@@ -364,6 +440,8 @@ impl<T: Default + Reset + Traceable> GcBox<T> {
             data: RefCell::new(data),
             ref_count: Cell::new(0),
             pooled: Cell::new(false),
+            handles: Cell::new(0),
+            barrier: Cell::new(false),
             // generation: Cell::new(0),
         }
     }
@@ -383,6 +461,11 @@ struct Space<T: Default + Reset + Traceable> {
     /// Free list of pooled object pointers
     free_list: Vec<NonNull<GcBox<T>>>,
 
+    /// Chunks whose memory was released by `shrink`. Their slots in `chunks`
+    /// stay as empty vecs so the index encoding of other boxes is unchanged,
+    /// and they are refilled before the heap grows.
+    released_chunks: Vec<usize>,
+
     /// Per-chunk bitmasks for mark-and-sweep collection.
     /// Each bitmask has 256 bits (4 × u64) for marking objects within a chunk.
     /// Better cache locality than HashSet during marking and sweeping.
@@ -396,8 +479,9 @@ struct Space<T: Default + Reset + Traceable> {
     /// Persistent sweep buffer - reused between GC cycles to avoid allocations.
     sweep_buffer: Vec<NonNull<GcBox<T>>>,
 
-    /// Pool of reusable guard storage (Vec capacity is preserved for reuse)
-    guard_pool: Vec<Vec<NonNull<GcBox<T>>>>,
+    /// Pool of dropped guards, kept registered in `active_guards` with empty
+    /// roots so creating a guard needs no allocation
+    guard_pool: Vec<Rc<GuardInner<T>>>,
 
     /// Active guards - their root lists are used as GC roots.
     /// Space keeps Weak refs so guards can be dropped independently.
@@ -411,6 +495,31 @@ struct Space<T: Default + Reset + Traceable> {
     /// Threshold for triggering collection (0 = never auto-collect)
     gc_threshold: isize,
 
+    /// Longest incremental slice in microseconds (0 = stop-the-world collection)
+    gc_budget_micros: u64,
+
+    /// Progress of the running incremental collection
+    phase: Phase,
+
+    /// Marked objects written through `Gc::borrow_mut` since they were traced
+    rescan_stack: Vec<NonNull<GcBox<T>>>,
+
+    /// Marked objects to trace again before sweeping (`Traceable::needs_final_trace`)
+    final_trace: Vec<NonNull<GcBox<T>>>,
+
+    /// Allocations since the running incremental collection started
+    cycle_allocs: usize,
+
+    /// Allocations after which the running collection finishes without a budget
+    cycle_alloc_limit: usize,
+
+    /// Maximum live objects (0 = unlimited)
+    object_limit: usize,
+
+    /// Set when an allocation went past `object_limit`; shared with `Heap`
+    /// so it can be read without borrowing the space
+    limit_exceeded: Rc<Cell<bool>>,
+
     /// Weak self-reference for Gc pointers
     self_weak: Weak<RefCell<Space<T>>>,
 }
@@ -423,11 +532,75 @@ const DEFAULT_GC_THRESHOLD: usize = 100;
 /// 256 = 4 × 64 bits, matching ChunkBitmask size
 const CHUNK_CAPACITY: usize = 256;
 
+/// Pooled slots always kept after a collection; beyond this the pool is
+/// capped at the number of live objects and empty chunks are released
+const MIN_RETAINED_POOL: usize = 4 * CHUNK_CAPACITY;
+
+/// Progress of an incremental collection
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Phase {
+    /// No collection running
+    Idle,
+    /// Tracing from the roots captured when the collection started
+    Marking,
+    /// Releasing unmarked objects, starting at this chunk
+    Sweeping { next_chunk: usize },
+}
+
+/// Units of work (objects traced or swept) between clock reads
+const BUDGET_CHECK_INTERVAL: u32 = 64;
+
+/// Without a clock, slices are sized by this estimate of work per microsecond
+#[cfg(not(feature = "std"))]
+const WORK_PER_MICROSECOND: u64 = 16;
+
+/// Time left in one incremental slice
+struct SliceBudget {
+    #[cfg(feature = "std")]
+    deadline: std::time::Instant,
+    #[cfg(not(feature = "std"))]
+    remaining: u64,
+    /// Work done since the last check
+    work: u32,
+}
+
+impl SliceBudget {
+    fn new(micros: u64) -> Self {
+        Self {
+            #[cfg(feature = "std")]
+            deadline: std::time::Instant::now() + core::time::Duration::from_micros(micros),
+            #[cfg(not(feature = "std"))]
+            remaining: micros.saturating_mul(WORK_PER_MICROSECOND),
+            work: 0,
+        }
+    }
+
+    /// Account for `units` of work. Returns true once the slice is used up.
+    fn spend(&mut self, units: u32) -> bool {
+        self.work = self.work.saturating_add(units);
+        if self.work < BUDGET_CHECK_INTERVAL {
+            return false;
+        }
+        #[cfg(feature = "std")]
+        {
+            self.work = 0;
+            std::time::Instant::now() >= self.deadline
+        }
+        #[cfg(not(feature = "std"))]
+        {
+            self.remaining = self.remaining.saturating_sub(u64::from(self.work));
+            self.work = 0;
+            self.remaining == 0
+        }
+    }
+}
+
 impl<T: Default + Reset + Traceable> Space<T> {
     fn new() -> Self {
         Self {
             chunks: Vec::new(),
             free_list: Vec::new(),
+            released_chunks: Vec::new(),
             marked_chunks: Vec::new(),
             mark_stack: Vec::new(),
             sweep_buffer: Vec::new(),
@@ -435,6 +608,14 @@ impl<T: Default + Reset + Traceable> Space<T> {
             active_guards: Vec::new(),
             net_allocs: 0,
             gc_threshold: DEFAULT_GC_THRESHOLD as isize,
+            gc_budget_micros: 0,
+            phase: Phase::Idle,
+            rescan_stack: Vec::new(),
+            final_trace: Vec::new(),
+            cycle_allocs: 0,
+            cycle_alloc_limit: 0,
+            object_limit: 0,
+            limit_exceeded: Rc::new(Cell::new(false)),
             self_weak: Weak::new(),
         }
     }
@@ -445,25 +626,26 @@ impl<T: Default + Reset + Traceable> Space<T> {
     }
 
     /// Create a new guard for allocating objects.
-    /// Reuses pooled guard storage when available to avoid allocation.
-    /// The guard is registered with Space for GC root tracking.
+    /// Reuses a pooled guard when available to avoid allocation; pooled guards
+    /// are already registered with Space for GC root tracking.
     fn create_guard(&mut self) -> Guard<T> {
-        let inner = if let Some(storage) = self.guard_pool.pop() {
-            Rc::new(GuardInner::with_storage(storage))
-        } else {
-            Rc::new(GuardInner::new())
+        let inner = match self.guard_pool.pop() {
+            Some(inner) => inner,
+            None => {
+                let inner = Rc::new(GuardInner::new());
+                // Register this guard for root tracking
+                self.active_guards.push(Rc::downgrade(&inner));
+                inner
+            }
         };
-        // Register this guard for root tracking
-        self.active_guards.push(Rc::downgrade(&inner));
         Guard::new(self.self_weak.clone(), inner)
     }
 
-    /// Return guard storage to the pool for reuse
-    fn return_guard_to_pool(&mut self, mut guarded: Vec<NonNull<GcBox<T>>>) {
+    /// Return a dropped guard to the pool for reuse (its roots must be empty)
+    fn return_guard_to_pool(&mut self, inner: Rc<GuardInner<T>>) {
         // Keep max 16 guards in pool to bound memory usage
         if self.guard_pool.len() < 16 {
-            guarded.clear();
-            self.guard_pool.push(guarded);
+            self.guard_pool.push(inner);
         }
     }
 
@@ -473,8 +655,27 @@ impl<T: Default + Reset + Traceable> Space<T> {
         // This ensures the newly allocated object won't be swept before
         // it's added to a guard's roots
         self.net_allocs += 1;
-        if self.gc_threshold > 0 && self.net_allocs >= self.gc_threshold {
-            self.collect();
+        if self.gc_threshold > 0 {
+            if self.phase != Phase::Idle {
+                self.cycle_allocs += 1;
+                if self.cycle_allocs.is_multiple_of(self.gc_threshold as usize) {
+                    self.collect_slice();
+                }
+            } else if self.net_allocs >= self.gc_threshold {
+                if self.gc_budget_micros > 0 {
+                    self.start_incremental();
+                } else {
+                    self.collect();
+                }
+            }
+        }
+
+        // A fresh slot is only needed when every existing one is live
+        if self.free_list.is_empty() && self.object_limit > 0 && !self.limit_exceeded.get() {
+            self.enforce_object_limit();
+        }
+        if self.free_list.is_empty() {
+            self.refill_released_chunk();
         }
 
         let ptr = if let Some(ptr) = self.free_list.pop() {
@@ -492,7 +693,9 @@ impl<T: Default + Reset + Traceable> Space<T> {
             };
             gc_box.data.borrow_mut().reset();
             gc_box.ref_count.set(1); // Start with ref_count = 1 for the returned Gc
+            gc_box.handles.set(gc_box.handles.get() + 1);
             gc_box.pooled.set(false);
+            gc_box.barrier.set(false);
             ptr
         } else {
             // Need to allocate new - check if current chunk has space
@@ -540,15 +743,140 @@ impl<T: Default + Reset + Traceable> Space<T> {
                 }
             };
             gc_box.ref_count.set(1); // Start with ref_count = 1 for the returned Gc
+            gc_box.handles.set(1);
             NonNull::from(gc_box)
         };
 
+        // Objects born during a collection survive it
+        if self.phase != Phase::Idle {
+            self.mark_allocated(ptr);
+        }
+
         Gc {
             ptr,
             space: self.self_weak.clone(),
         }
     }
 
+    /// At the object limit with no free slot: collect, and flag the limit as
+    /// exceeded if that did not make room
+    fn enforce_object_limit(&mut self) {
+        let total_objects: usize = self.chunks.iter().map(|c| c.len()).sum();
+        if total_objects < self.object_limit {
+            return;
+        }
+        self.collect();
+        if self.free_list.is_empty() {
+            self.limit_exceeded.set(true);
+        }
+    }
+
+    /// Bring a released chunk back into use, its slots all pooled, so the
+    /// heap reuses that index range before growing
+    fn refill_released_chunk(&mut self) {
+        let Some(chunk_idx) = self.released_chunks.pop() else {
+            return;
+        };
+        let Some(chunk) = self.chunks.get_mut(chunk_idx) else {
+            return;
+        };
+        let mut fresh = Vec::with_capacity(CHUNK_CAPACITY);
+        for index_in_chunk in 0..CHUNK_CAPACITY {
+            let gc_box = GcBox::new(chunk_idx * CHUNK_CAPACITY + index_in_chunk, T::default());
+            gc_box.pooled.set(true);
+            fresh.push(gc_box);
+        }
+        *chunk = fresh;
+        // Reversed so allocation pops the slots in index order
+        self.free_list.extend(chunk.iter().rev().map(NonNull::from));
+    }
+
+    /// Release fully empty chunks, highest first, until at most `keep`
+    /// pooled slots remain. A chunk is empty when every slot is pooled and
+    /// no `Gc` handle points into it. Objects cannot move (handles are raw
+    /// addresses), so sparse chunks are instead drained by reordering the
+    /// pool to hand out the lowest slots first.
+    fn shrink(&mut self, keep: usize) {
+        if self.phase != Phase::Idle {
+            return;
+        }
+        let mut release = Vec::new();
+        let mut pooled = self.free_list.len();
+        for (chunk_idx, chunk) in self.chunks.iter().enumerate().rev() {
+            if pooled <= keep {
+                break;
+            }
+            if !chunk.is_empty()
+                && chunk
+                    .iter()
+                    .all(|gc_box| gc_box.pooled.get() && gc_box.handles.get() == 0)
+            {
+                release.push(chunk_idx);
+                pooled -= chunk.len();
+            }
+        }
+
+        if !release.is_empty() {
+            // Guard roots may still name pooled slots; drop those before the
+            // memory behind them goes away
+            for weak in &self.active_guards {
+                if let Some(inner) = weak.upgrade() {
+                    let Ok(mut roots) = inner.roots.try_borrow_mut() else {
+                        return;
+                    };
+                    roots.retain(|ptr| !unsafe { ptr.as_ref() }.pooled.get());
+                }
+            }
+            self.free_list.retain(|ptr| {
+                let chunk_idx = unsafe { ptr.as_ref() }.index / CHUNK_CAPACITY;
+                !release.contains(&chunk_idx)
+            });
+            for &chunk_idx in &release {
+                if let Some(chunk) = self.chunks.get_mut(chunk_idx) {
+                    *chunk = Vec::new();
+                }
+            }
+            self.released_chunks.extend(release);
+
+            // Released chunks at the end can go entirely
+            while self
+                .chunks
+                .last()
+                .is_some_and(|chunk| chunk.capacity() == 0)
+            {
+                self.chunks.pop();
+                self.marked_chunks.pop();
+            }
+            let len = self.chunks.len();
+            self.released_chunks.retain(|&chunk_idx| chunk_idx < len);
+            self.chunks.shrink_to_fit();
+            self.marked_chunks.shrink_to_fit();
+        }
+
+        // Hand out low slots first so the high chunks empty out
+        self.free_list
+            .sort_unstable_by_key(|ptr| core::cmp::Reverse(unsafe { ptr.as_ref() }.index));
+    }
+
+    /// Cap the pool after a collection at the number of live objects (and
+    /// at least `MIN_RETAINED_POOL`) by releasing empty chunks
+    fn trim_pool(&mut self) {
+        let pooled = self.free_list.len();
+        let live = self.stats().live_objects;
+        let keep = live.max(MIN_RETAINED_POOL);
+        if pooled > keep {
+            self.shrink(keep);
+        }
+    }
+
+    /// Clear the limit flag once a collection has brought the heap back
+    /// under the limit
+    fn recheck_object_limit(&mut self) {
+        if self.limit_exceeded.get() && self.stats().live_objects < self.object_limit {
+            self.limit_exceeded.set(false);
+        }
+    }
+
     /// Move an object to the pool (internal helper)
     /// Note: reset() should be called BEFORE pool_object to clear references
     fn pool_object(&mut self, _object_id: usize, ptr: NonNull<GcBox<T>>) {
@@ -576,67 +904,95 @@ impl<T: Default + Reset + Traceable> Space<T> {
         for bitmask in &mut self.marked_chunks {
             bitmask.clear();
         }
+        self.mark_stack.clear();
+        self.rescan_stack.clear();
+        self.final_trace.clear();
 
-        // Take ownership of the persistent mark stack to avoid borrow issues.
-        // This preserves capacity from previous GC cycles - the key optimization.
-        let mut stack = mem::take(&mut self.mark_stack);
-        stack.clear();
-
-        // Collect roots from all active guards.
-        // Clean up dead Weak refs as we go.
-        let mut total_roots = 0;
-        let mut alive_guards = 0;
-        let mut dead_guards = 0;
-        let mut guards_with_roots: Vec<usize> = Vec::new();
+        self.push_roots();
+        self.drain_marks(None);
+    }
+
+    /// Push the roots of all active guards onto the mark stack.
+    /// Clean up dead Weak refs as we go.
+    fn push_roots(&mut self) {
+        let stack = &mut self.mark_stack;
         self.active_guards.retain(|weak| {
-            if let Some(inner) = weak.upgrade() {
-                // Guard is alive - add its roots to the mark stack
-                let roots = inner.roots.borrow();
-                alive_guards += 1;
-                guards_with_roots.push(roots.len());
-                for &ptr in roots.iter() {
-                    let gc_box = unsafe { ptr.as_ref() };
-                    if !gc_box.pooled.get() {
-                        stack.push(ptr);
-                        total_roots += 1;
-                    }
+            let Some(inner) = weak.upgrade() else {
+                return false; // Guard was dropped, remove from list
+            };
+            for &ptr in inner.roots.borrow().iter() {
+                let gc_box = unsafe { ptr.as_ref() };
+                if !gc_box.pooled.get() {
+                    stack.push(ptr);
                 }
-                true // Keep this Weak ref
-            } else {
-                dead_guards += 1;
-                false // Guard was dropped, remove from list
             }
+            true
         });
-        let _ = (total_roots, alive_guards, dead_guards, guards_with_roots); // suppress unused warnings
+    }
+
+    /// Trace queued objects until the queues are empty or `budget` runs out.
+    /// Returns true when all marking work is done.
+    fn drain_marks(&mut self, mut budget: Option<&mut SliceBudget>) -> bool {
+        let incremental = self.phase == Phase::Marking;
+
+        // Take ownership of the persistent stacks to avoid borrow issues.
+        // This preserves capacity from previous GC cycles - the key optimization.
+        let mut stack = mem::take(&mut self.mark_stack);
+        let mut rescan = mem::take(&mut self.rescan_stack);
 
         // Get raw pointer to marked_chunks for use in closure (avoids borrow issues)
         let marked_chunks_ptr = self.marked_chunks.as_mut_ptr();
         let marked_chunks_len = self.marked_chunks.len();
 
         // Iterative mark traversal using Traceable::trace()
-        while let Some(ptr) = stack.pop() {
+        let done = loop {
+            if let Some(budget) = budget.as_deref_mut()
+                && budget.spend(1)
+            {
+                break false;
+            }
+            // Rescanned objects are already marked; only their children are new
+            let (ptr, retrace) = match stack.pop() {
+                Some(ptr) => (ptr, false),
+                None => match rescan.pop() {
+                    Some(ptr) => (ptr, true),
+                    None => break true,
+                },
+            };
             let gc_box = unsafe { ptr.as_ref() };
-            let chunk_idx = gc_box.index / CHUNK_CAPACITY;
-            let index_in_chunk = gc_box.index % CHUNK_CAPACITY;
-
-            // Bounds check once, then use unchecked access
-            if chunk_idx >= marked_chunks_len {
+            if gc_box.pooled.get() {
                 continue;
             }
 
-            // Safety: chunk_idx < marked_chunks_len checked above
-            let bitmask = unsafe { &mut *marked_chunks_ptr.add(chunk_idx) };
+            if !retrace {
+                let chunk_idx = gc_box.index / CHUNK_CAPACITY;
+                let index_in_chunk = gc_box.index % CHUNK_CAPACITY;
 
-            // Already marked - skip
-            if bitmask.get(index_in_chunk) {
-                continue;
-            }
+                // Bounds check once, then use unchecked access
+                if chunk_idx >= marked_chunks_len {
+                    continue;
+                }
 
-            // Mark this object
-            bitmask.set(index_in_chunk);
+                // Safety: chunk_idx < marked_chunks_len checked above
+                let bitmask = unsafe { &mut *marked_chunks_ptr.add(chunk_idx) };
+
+                // Already marked - skip
+                if bitmask.get(index_in_chunk) {
+                    continue;
+                }
+
+                // Mark this object
+                bitmask.set(index_in_chunk);
+            }
 
             // Trace references via Traceable trait
             let data = gc_box.data.borrow();
+            if incremental {
+                gc_box.barrier.set(true);
+                if !retrace && data.needs_final_trace() {
+                    self.final_trace.push(ptr);
+                }
+            }
             data.trace(|child: GcPtr<T>| {
                 let child_box = unsafe { child.ptr.as_ref() };
                 let child_chunk_idx = child_box.index / CHUNK_CAPACITY;
@@ -651,56 +1007,154 @@ impl<T: Default + Reset + Traceable> Space<T> {
                     }
                 }
             });
-        }
+        };
 
-        // Put the stack back (empty but with capacity preserved for next GC cycle)
+        // Put the stacks back (capacity preserved for the next slice or cycle)
         self.mark_stack = stack;
+        self.rescan_stack = rescan;
+        done
     }
 
     /// Sweep phase: collect all unmarked objects
-    /// Returns number of objects collected
-    fn sweep(&mut self) -> usize {
-        let mut collected = 0;
+    fn sweep(&mut self) {
+        self.sweep_chunks(0, None);
+    }
+
+    /// Release unmarked objects chunk by chunk, starting at `first`.
+    /// Returns the chunk to continue from if `budget` ran out.
+    fn sweep_chunks(
+        &mut self,
+        first: usize,
+        mut budget: Option<&mut SliceBudget>,
+    ) -> Option<usize> {
         // Take ownership of persistent sweep buffer (preserves capacity from previous cycles)
         let mut to_pool = mem::take(&mut self.sweep_buffer);
-        to_pool.clear();
+        let mut next = None;
 
-        // First pass: reset all unmarked objects and collect their pointers
-        // With guard-based roots, if unmarked, object is unreachable regardless of ref_count
-        for (chunk, bitmask) in self.chunks.iter().zip(self.marked_chunks.iter()) {
-            for index_in_chunk in bitmask.iter_unmarked(chunk.len()) {
-                if let Some(gc_box) = chunk.get(index_in_chunk)
-                    && !gc_box.pooled.get()
-                {
-                    // Reset clears references (important for breaking cycles)
-                    gc_box.data.borrow_mut().reset();
-                    // Set ref_count to 0 to prevent stale Gc pointers from
-                    // triggering reset when they're dropped
-                    gc_box.ref_count.set(0);
-                    to_pool.push(NonNull::from(gc_box));
-                    collected += 1;
+        for chunk_idx in first..self.chunks.len() {
+            if let Some(budget) = budget.as_deref_mut()
+                && budget.spend(to_pool.len() as u32 + 1)
+            {
+                next = Some(chunk_idx);
+                break;
+            }
+            to_pool.clear();
+
+            // First pass: reset all unmarked objects and collect their pointers
+            // With guard-based roots, if unmarked, object is unreachable regardless of ref_count
+            if let (Some(chunk), Some(bitmask)) = (
+                self.chunks.get(chunk_idx),
+                self.marked_chunks.get(chunk_idx),
+            ) {
+                for index_in_chunk in bitmask.iter_unmarked(chunk.len()) {
+                    if let Some(gc_box) = chunk.get(index_in_chunk)
+                        && !gc_box.pooled.get()
+                    {
+                        // Reset clears references (important for breaking cycles)
+                        gc_box.data.borrow_mut().reset();
+                        // Set ref_count to 0 to prevent stale Gc pointers from
+                        // triggering reset when they're dropped
+                        gc_box.ref_count.set(0);
+                        to_pool.push(NonNull::from(gc_box));
+                    }
                 }
             }
-        }
 
-        // Second pass: pool all collected objects
-        for ptr in &to_pool {
-            let gc_box = unsafe { ptr.as_ref() };
-            self.pool_object(gc_box.index, *ptr);
+            // Second pass: pool all collected objects
+            for ptr in &to_pool {
+                let gc_box = unsafe { ptr.as_ref() };
+                self.pool_object(gc_box.index, *ptr);
+            }
         }
 
         // Put buffer back (empty but with capacity preserved for next GC cycle)
         to_pool.clear();
         self.sweep_buffer = to_pool;
 
-        collected
+        next
     }
 
     /// Run mark-and-sweep collection
     fn collect(&mut self) {
+        // A stop-the-world collection supersedes a running incremental one
+        self.phase = Phase::Idle;
         self.mark();
         self.sweep();
         self.net_allocs = 0;
+        self.recheck_object_limit();
+        self.trim_pool();
+    }
+
+    /// Begin an incremental collection from the current roots
+    fn start_incremental(&mut self) {
+        for bitmask in &mut self.marked_chunks {
+            bitmask.clear();
+        }
+        self.mark_stack.clear();
+        self.rescan_stack.clear();
+        self.final_trace.clear();
+        self.push_roots();
+
+        let total_objects: usize = self.chunks.iter().map(|c| c.len()).sum();
+        let live_objects = total_objects.saturating_sub(self.free_list.len());
+        self.phase = Phase::Marking;
+        self.cycle_allocs = 0;
+        self.cycle_alloc_limit = live_objects.max(self.gc_threshold as usize);
+        self.collect_slice();
+    }
+
+    /// Advance the running incremental collection by one slice
+    fn collect_slice(&mut self) {
+        let mut slice = SliceBudget::new(self.gc_budget_micros);
+        // Finish in one go if incremental mode was switched off, or if the
+        // program allocates faster than the slices reclaim
+        let unbounded = self.gc_budget_micros == 0 || self.cycle_allocs >= self.cycle_alloc_limit;
+        let mut budget = if unbounded { None } else { Some(&mut slice) };
+
+        if self.phase == Phase::Marking {
+            if !self.drain_marks(budget.as_deref_mut()) {
+                return;
+            }
+            self.finish_marking();
+        }
+        if let Phase::Sweeping { next_chunk } = self.phase {
+            match self.sweep_chunks(next_chunk, budget) {
+                Some(next_chunk) => self.phase = Phase::Sweeping { next_chunk },
+                None => {
+                    self.phase = Phase::Idle;
+                    self.net_allocs = 0;
+                    self.recheck_object_limit();
+                    self.trim_pool();
+                }
+            }
+        }
+    }
+
+    /// Final marking step: pick up roots added since the collection started
+    /// and objects whose references changed without a write barrier
+    fn finish_marking(&mut self) {
+        self.push_roots();
+        let final_trace = mem::take(&mut self.final_trace);
+        self.rescan_stack.extend(final_trace);
+        self.drain_marks(None);
+        self.final_trace.clear();
+        self.phase = Phase::Sweeping { next_chunk: 0 };
+    }
+
+    /// Queue a marked object written during marking to be traced again
+    fn record_write(&mut self, ptr: NonNull<GcBox<T>>) {
+        if self.phase == Phase::Marking {
+            self.rescan_stack.push(ptr);
+        }
+    }
+
+    /// Mark an object allocated while a collection runs
+    fn mark_allocated(&mut self, ptr: NonNull<GcBox<T>>) {
+        let gc_box = unsafe { ptr.as_ref() };
+        if let Some(bitmask) = self.marked_chunks.get_mut(gc_box.index / CHUNK_CAPACITY) {
+            bitmask.set(gc_box.index % CHUNK_CAPACITY);
+        }
+        gc_box.barrier.set(self.phase == Phase::Marking);
     }
 
     /// Force a collection (for testing or explicit cleanup)
@@ -708,14 +1162,29 @@ impl<T: Default + Reset + Traceable> Space<T> {
         self.collect();
     }
 
+    /// Collect, then release every empty chunk
+    fn shrink_heap(&mut self) {
+        self.collect();
+        self.shrink(0);
+        self.free_list.shrink_to_fit();
+        // The collector's work lists grow to the peak heap as well
+        self.mark_stack = Vec::new();
+        self.sweep_buffer = Vec::new();
+    }
+
     /// Get statistics
     fn stats(&self) -> GcStats {
         let total_objects: usize = self.chunks.iter().map(|c| c.len()).sum();
+        let live_objects = total_objects - self.free_list.len();
+        let box_size = mem::size_of::<GcBox<T>>();
+        let reserved_slots: usize = self.chunks.iter().map(|c| c.capacity()).sum();
 
         GcStats {
             total_objects,
             pooled_objects: self.free_list.len(),
-            live_objects: total_objects - self.free_list.len(),
+            live_objects,
+            reserved_bytes: reserved_slots * box_size,
+            used_bytes: live_objects * box_size,
         }
     }
 
@@ -723,6 +1192,21 @@ impl<T: Default + Reset + Traceable> Space<T> {
     fn set_gc_threshold(&mut self, threshold: usize) {
         self.gc_threshold = threshold as isize;
     }
+
+    /// Set the incremental slice budget (0 = stop-the-world collection)
+    fn set_gc_budget(&mut self, micros: u64) {
+        self.gc_budget_micros = micros;
+    }
+
+    /// Set the live object limit (0 = unlimited)
+    fn set_object_limit(&mut self, limit: usize) {
+        self.object_limit = limit;
+        if limit == 0 {
+            self.limit_exceeded.set(false);
+        } else {
+            self.recheck_object_limit();
+        }
+    }
 }
 
 impl<T: Default + Reset + Traceable> Drop for Space<T> {
@@ -748,6 +1232,8 @@ impl<T: Default + Reset + Traceable> Drop for Space<T> {
 /// This is the main entry point for using the GC.
 pub struct Heap<T: Default + Reset + Traceable> {
     inner: Rc<RefCell<Space<T>>>,
+    /// The space's object limit flag, readable without a borrow
+    limit_exceeded: Rc<Cell<bool>>,
 }
 
 impl<T: Default + Reset + Traceable> Heap<T> {
@@ -755,7 +1241,11 @@ impl<T: Default + Reset + Traceable> Heap<T> {
     pub fn new() -> Self {
         let inner = Rc::new(RefCell::new(Space::new()));
         inner.borrow_mut().set_self_weak(Rc::downgrade(&inner));
-        Self { inner }
+        let limit_exceeded = inner.borrow().limit_exceeded.clone();
+        Self {
+            inner,
+            limit_exceeded,
+        }
     }
 
     /// Create a new guard for allocating objects
@@ -773,10 +1263,36 @@ impl<T: Default + Reset + Traceable> Heap<T> {
         self.inner.borrow_mut().force_collect();
     }
 
+    /// Collect, then return every fully empty chunk of slots to the
+    /// allocator. Collections already release empty chunks once the pool
+    /// outgrows the live set; this releases them all.
+    pub fn shrink(&self) {
+        self.inner.borrow_mut().shrink_heap();
+    }
+
     /// Set the GC threshold (0 = disable automatic collection)
     pub fn set_gc_threshold(&self, threshold: usize) {
         self.inner.borrow_mut().set_gc_threshold(threshold);
     }
+
+    /// Collect incrementally in slices of at most `micros` microseconds
+    /// (0 = stop-the-world collection, the default)
+    pub fn set_gc_budget(&self, micros: u64) {
+        self.inner.borrow_mut().set_gc_budget(micros);
+    }
+
+    /// Cap the number of live objects (0 = unlimited, the default).
+    /// See the module docs for how the limit is enforced.
+    pub fn set_object_limit(&self, limit: usize) {
+        self.inner.borrow_mut().set_object_limit(limit);
+    }
+
+    /// Whether an allocation has gone past the object limit. Cheap enough to
+    /// check once per instruction.
+    #[inline]
+    pub fn limit_exceeded(&self) -> bool {
+        self.limit_exceeded.get()
+    }
 }
 
 impl<T: Default + Reset + Traceable> Default for Heap<T> {
@@ -789,6 +1305,7 @@ impl<T: Default + Reset + Traceable> Clone for Heap<T> {
     fn clone(&self) -> Self {
         Heap {
             inner: self.inner.clone(),
+            limit_exceeded: self.limit_exceeded.clone(),
         }
     }
 }
@@ -810,12 +1327,6 @@ impl<T: Default + Reset + Traceable> GuardInner<T> {
             roots: RefCell::new(Vec::new()),
         }
     }
-
-    fn with_storage(storage: Vec<NonNull<GcBox<T>>>) -> Self {
-        Self {
-            roots: RefCell::new(storage),
-        }
-    }
 }
 
 /// A root anchor that keeps GC-managed objects alive.
@@ -881,7 +1392,15 @@ impl<T: Default + Reset + Traceable> Guard<T> {
     /// Add an existing object to this guard's roots.
     /// This keeps the object alive as long as the guard exists.
     pub fn guard(&self, obj: Gc<T>) {
-        if let Some(_space) = self.space.upgrade() {
+        self.guard_ref(&obj);
+    }
+
+    /// Add an object to this guard's roots without taking a handle.
+    ///
+    /// Roots are raw pointers, so this avoids the ref_count round trip of
+    /// cloning a `Gc` just to pass it to `guard`.
+    pub(crate) fn guard_ref(&self, obj: &Gc<T>) {
+        if self.space.strong_count() > 0 {
             let gc_box = unsafe { obj.ptr.as_ref() };
             if !gc_box.pooled.get() {
                 self.inner.roots.borrow_mut().push(obj.ptr);
@@ -905,6 +1424,27 @@ impl<T: Default + Reset + Traceable> Guard<T> {
         self.inner.roots.borrow_mut().clear();
     }
 
+    /// Get handles to all guarded objects (used to copy a heap's root set)
+    pub fn roots(&self) -> Vec<Gc<T>> {
+        self.inner
+            .roots
+            .borrow()
+            .iter()
+            .filter_map(|ptr| {
+                let gc_box = unsafe { ptr.as_ref() };
+                if gc_box.pooled.get() {
+                    return None;
+                }
+                gc_box.ref_count.set(gc_box.ref_count.get() + 1);
+                gc_box.handles.set(gc_box.handles.get() + 1);
+                Some(Gc {
+                    ptr: *ptr,
+                    space: self.space.clone(),
+                })
+            })
+            .collect()
+    }
+
     /// Get the number of guarded objects
     pub fn len(&self) -> usize {
         self.inner.roots.borrow().len()
@@ -923,16 +1463,14 @@ impl<T: Default + Reset + Traceable> Guard<T> {
 
 impl<T: Default + Reset + Traceable> Drop for Guard<T> {
     fn drop(&mut self) {
-        // Return storage to pool for reuse when we have sole ownership
-        if let Some(space) = self.space.upgrade() {
-            // Try to get sole ownership of inner to reclaim storage
-            // Note: Space's Weak ref will become invalid when inner is dropped
-            if Rc::strong_count(&self.inner) == 1 {
-                let mut roots = self.inner.roots.borrow_mut();
-                let storage = mem::take(&mut *roots);
-                drop(roots);
-                space.borrow_mut().return_guard_to_pool(storage);
-            }
+        // Return the guard to the pool for reuse when we have sole ownership.
+        // Its roots are cleared, so the pooled guard roots nothing while it
+        // stays registered in `active_guards`.
+        if let Some(space) = self.space.upgrade()
+            && Rc::strong_count(&self.inner) == 1
+        {
+            self.inner.roots.borrow_mut().clear();
+            space.borrow_mut().return_guard_to_pool(self.inner.clone());
         }
     }
 }
@@ -950,6 +1488,11 @@ pub struct GcStats {
     pub pooled_objects: usize,
     /// Number of live objects
     pub live_objects: usize,
+    /// Bytes of slot storage held by the heap, pooled slots included
+    /// (memory owned by the objects themselves is not counted)
+    pub reserved_bytes: usize,
+    /// Bytes of slot storage occupied by live objects
+    pub used_bytes: usize,
 }
 
 // ============================================================================
@@ -1039,6 +1582,28 @@ mod tests {
         assert_eq!(heap.stats().total_objects, 1);
     }
 
+    #[test]
+    fn test_reused_guard_roots_nothing() {
+        let heap: Heap<TestObj> = Heap::new();
+
+        {
+            let guard = heap.create_guard();
+            let _obj = guard.alloc();
+        }
+
+        // The second guard reuses the first one, which must not keep its
+        // old object alive
+        let guard = heap.create_guard();
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, 0);
+
+        let obj = guard.alloc();
+        obj.borrow_mut().value = 7;
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, 1);
+        assert_eq!(obj.borrow().value, 7);
+    }
+
     #[test]
     fn test_ownership_keeps_alive() {
         let heap: Heap<TestObj> = Heap::new();
@@ -1174,6 +1739,28 @@ mod tests {
         assert_eq!(heap.stats().live_objects, 2);
     }
 
+    #[test]
+    fn test_guard_ref_roots_without_handle() {
+        let heap: Heap<TestObj> = Heap::new();
+        let guard1 = heap.create_guard();
+        let guard2 = heap.create_guard();
+
+        let obj = guard1.alloc();
+        let count = unsafe { obj.ptr.as_ref() }.ref_count.get();
+        guard2.guard_ref(&obj);
+        assert_eq!(unsafe { obj.ptr.as_ref() }.ref_count.get(), count);
+
+        // guard2 alone keeps the object alive
+        drop(guard1);
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, 1);
+
+        assert!(guard2.unguard(&obj));
+        drop(obj);
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, 0);
+    }
+
     #[test]
     fn test_transitive_ownership() {
         let heap: Heap<TestObj> = Heap::new();
@@ -1294,4 +1881,237 @@ mod tests {
 
         assert_eq!(heap.stats().live_objects, 0);
     }
+
+    /// Budget that allows tracing exactly one object
+    #[cfg(feature = "std")]
+    fn one_object_budget() -> SliceBudget {
+        SliceBudget {
+            deadline: std::time::Instant::now(),
+            work: BUDGET_CHECK_INTERVAL - 2,
+        }
+    }
+
+    #[test]
+    #[cfg(feature = "std")]
+    fn test_incremental_write_barrier() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        let guard = heap.create_guard();
+
+        // b -> w, with `a` traced first (the mark stack is LIFO)
+        let b = guard.alloc();
+        let a = guard.alloc();
+        {
+            let temp = heap.create_guard();
+            let w = temp.alloc();
+            w.borrow_mut().value = 7;
+            b.borrow_mut().refs.push(w);
+        }
+
+        {
+            let mut space = heap.inner.borrow_mut();
+            space.phase = Phase::Marking;
+            space.push_roots();
+            assert!(!space.drain_marks(Some(&mut one_object_budget())));
+        }
+
+        // Move w from the untraced b into the already traced a
+        let w = b.borrow().refs[0].clone();
+        a.borrow_mut().refs.push(w);
+        b.borrow_mut().refs.clear();
+
+        heap.inner.borrow_mut().collect_slice();
+        assert_eq!(heap.inner.borrow().phase, Phase::Idle);
+        assert_eq!(heap.stats().live_objects, 3);
+        assert_eq!(a.borrow().refs[0].borrow().value, 7);
+    }
+
+    #[test]
+    #[cfg(feature = "std")]
+    fn test_incremental_new_roots_and_allocations_survive() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        let guard = heap.create_guard();
+        let old = guard.alloc();
+
+        {
+            let mut space = heap.inner.borrow_mut();
+            space.phase = Phase::Marking;
+            space.push_roots();
+        }
+
+        // Allocated mid-cycle and only reachable from a guard created later
+        let late_guard = heap.create_guard();
+        let young = late_guard.alloc();
+        young.borrow_mut().value = 3;
+        old.borrow_mut().value = 1;
+
+        heap.inner.borrow_mut().collect_slice();
+        assert_eq!(heap.stats().live_objects, 2);
+        assert_eq!(young.borrow().value, 3);
+    }
+
+    #[test]
+    fn test_incremental_collection_reclaims_garbage() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(10);
+        heap.set_gc_budget(1);
+        let guard = heap.create_guard();
+        let root = guard.alloc();
+
+        for i in 0..5000 {
+            let temp = heap.create_guard();
+            let obj = temp.alloc();
+            obj.borrow_mut().value = i;
+            // Keep every 100th object reachable from the root
+            if i % 100 == 0 {
+                root.borrow_mut().refs.push(obj);
+            }
+        }
+
+        // Let any running collection finish, then collect what it floated
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, 51);
+        assert_eq!(root.borrow().refs.len(), 50);
+        assert!(
+            root.borrow()
+                .refs
+                .iter()
+                .enumerate()
+                .all(|(n, obj)| obj.borrow().value == n as i32 * 100)
+        );
+    }
+
+    #[test]
+    fn test_object_limit_collects_before_flagging() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        heap.set_object_limit(CHUNK_CAPACITY);
+
+        // Garbage at the limit is reclaimed instead of tripping it
+        for _ in 0..CHUNK_CAPACITY * 4 {
+            let temp = heap.create_guard();
+            temp.alloc();
+        }
+        assert!(!heap.limit_exceeded());
+
+        // Reachable objects past the limit trip it; allocation still works
+        let guard = heap.create_guard();
+        let kept: Vec<_> = (0..CHUNK_CAPACITY + 1).map(|_| guard.alloc()).collect();
+        assert!(heap.limit_exceeded());
+        assert_eq!(kept.len(), CHUNK_CAPACITY + 1);
+
+        // Releasing them and collecting lifts it
+        drop(kept);
+        drop(guard);
+        heap.collect();
+        assert!(!heap.limit_exceeded());
+    }
+
+    #[test]
+    fn test_shrink_releases_empty_chunks() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        let slot_bytes = CHUNK_CAPACITY * mem::size_of::<GcBox<TestObj>>();
+
+        let keep = heap.create_guard();
+        let survivor = keep.alloc();
+        survivor.borrow_mut().value = 7;
+        {
+            let temp = heap.create_guard();
+            for _ in 0..CHUNK_CAPACITY * 4 {
+                temp.alloc();
+            }
+        }
+        assert_eq!(heap.stats().reserved_bytes, 5 * slot_bytes);
+
+        heap.shrink();
+        let stats = heap.stats();
+        assert_eq!(stats.live_objects, 1);
+        assert_eq!(stats.total_objects, CHUNK_CAPACITY);
+        assert_eq!(stats.reserved_bytes, slot_bytes);
+        assert_eq!(stats.used_bytes, mem::size_of::<GcBox<TestObj>>());
+        assert_eq!(survivor.borrow().value, 7);
+
+        // The heap grows again as usual
+        let more: Vec<_> = (0..CHUNK_CAPACITY * 2).map(|_| keep.alloc()).collect();
+        assert_eq!(heap.stats().live_objects, CHUNK_CAPACITY * 2 + 1);
+        drop(more);
+    }
+
+    #[test]
+    fn test_shrink_keeps_chunks_with_stale_handles() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        let keep = heap.create_guard();
+        let _survivor = keep.alloc();
+
+        // A handle outliving its object's collection pins the chunk
+        let guard = heap.create_guard();
+        let objs: Vec<_> = (1..CHUNK_CAPACITY * 2).map(|_| guard.alloc()).collect();
+        let stale = objs.last().cloned();
+        drop(objs);
+        drop(guard);
+
+        heap.shrink();
+        assert_eq!(heap.stats().live_objects, 1);
+        assert_eq!(heap.stats().total_objects, CHUNK_CAPACITY * 2);
+
+        drop(stale);
+        heap.shrink();
+        assert_eq!(heap.stats().total_objects, CHUNK_CAPACITY);
+    }
+
+    #[test]
+    fn test_released_chunk_is_refilled_before_growing() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        let slot_bytes = CHUNK_CAPACITY * mem::size_of::<GcBox<TestObj>>();
+        let keep = heap.create_guard();
+        let temp = heap.create_guard();
+
+        // Live objects in the first and third chunk, garbage in between
+        let first = keep.alloc();
+        for _ in 1..CHUNK_CAPACITY * 2 {
+            temp.alloc();
+        }
+        let last = keep.alloc();
+        drop(temp);
+
+        heap.shrink();
+        let stats = heap.stats();
+        assert_eq!(stats.live_objects, 2);
+        assert_eq!(stats.total_objects, CHUNK_CAPACITY + 1);
+        assert_eq!(stats.reserved_bytes, 2 * slot_bytes);
+
+        // Pooled slots of the first chunk go first, then the released chunk
+        let refs: Vec<_> = (0..CHUNK_CAPACITY * 2 - 1).map(|_| keep.alloc()).collect();
+        let stats = heap.stats();
+        assert_eq!(stats.total_objects, CHUNK_CAPACITY * 2 + 1);
+        assert_eq!(stats.live_objects, CHUNK_CAPACITY * 2 + 1);
+        assert_eq!(stats.reserved_bytes, 3 * slot_bytes);
+        for (i, obj) in refs.iter().enumerate() {
+            obj.borrow_mut().value = i as i32;
+        }
+        first.borrow_mut().refs.push(last.clone());
+        heap.collect();
+        assert_eq!(heap.stats().live_objects, CHUNK_CAPACITY * 2 + 1);
+    }
+
+    #[test]
+    fn test_collection_caps_pool_size() {
+        let heap: Heap<TestObj> = Heap::new();
+        heap.set_gc_threshold(0);
+        {
+            let temp = heap.create_guard();
+            for _ in 0..CHUNK_CAPACITY * 16 {
+                temp.alloc();
+            }
+        }
+        heap.collect();
+        let stats = heap.stats();
+        assert_eq!(stats.live_objects, 0);
+        assert_eq!(stats.pooled_objects, MIN_RETAINED_POOL);
+        assert_eq!(stats.total_objects, MIN_RETAINED_POOL);
+    }
 }
@@ -5,9 +5,18 @@ use crate::gc::Gc;
 use crate::interpreter::Interpreter;
 use crate::prelude::*;
 use crate::value::{
-    CheapClone, ExoticObject, Guarded, JsObject, JsObjectRef, JsString, JsValue, PropertyKey,
+    ArrayElements, CheapClone, ExoticObject, Guarded, JsObject, JsObjectRef, JsString, JsValue,
+    PropertyKey, number_to_string,
 };
 
+/// Borrow the packed numbers of an array, if its elements are stored that way.
+fn packed_numbers(arr: &JsObjectRef) -> Option<core::cell::Ref<'_, [f64]>> {
+    core::cell::Ref::filter_map(arr.borrow(), |obj| {
+        obj.array_storage().and_then(ArrayElements::as_f64_slice)
+    })
+    .ok()
+}
+
 /// Convert a number to a length value per ECMAScript ToLength.
 /// Clamps to [0, 2^53 - 1] (MAX_SAFE_INTEGER) and truncates.
 fn to_length(n: f64) -> u32 {
@@ -67,10 +76,7 @@ fn get_array_like_element(obj: &Gc<JsObject>, index: u32) -> JsValue {
     let borrowed = obj.borrow();
     // First check if it's a real array with dense storage
     if let ExoticObject::Array { ref elements } = borrowed.exotic {
-        return elements
-            .get(index as usize)
-            .cloned()
-            .unwrap_or(JsValue::Undefined);
+        return elements.get(index as usize).unwrap_or(JsValue::Undefined);
     }
     // Otherwise, get by property index
     borrowed
@@ -229,12 +235,10 @@ pub fn array_push(
     let mut arr_ref = arr.borrow_mut();
 
     let elements = arr_ref
-        .array_elements_mut()
+        .array_storage_mut()
         .ok_or_else(|| JsError::type_error("Array.prototype.push called on non-array"))?;
 
-    for arg in args {
-        elements.push(arg.clone());
-    }
+    elements.extend(args.iter().cloned());
 
     let new_length = elements.len();
     Ok(Guarded::unguarded(JsValue::Number(new_length as f64)))
@@ -254,7 +258,7 @@ pub fn array_pop(
     let mut arr_ref = arr.borrow_mut();
 
     let elements = arr_ref
-        .array_elements_mut()
+        .array_storage_mut()
         .ok_or_else(|| JsError::type_error("Array.prototype.pop called on non-array"))?;
 
     let value = elements.pop().unwrap_or(JsValue::Undefined);
@@ -476,19 +480,24 @@ pub fn array_reduce(
     };
 
     for i in start_index..length {
-        if has_array_like_element(&arr, i) {
-            let elem = get_array_like_element(&arr, i);
+        // Read packed numbers straight from storage; the callback may change
+        // the array, so this is checked on every step
+        let packed = packed_numbers(&arr).and_then(|numbers| numbers.get(i as usize).copied());
+        let elem = match packed {
+            Some(n) => JsValue::Number(n),
+            None if has_array_like_element(&arr, i) => get_array_like_element(&arr, i),
+            None => continue,
+        };
 
-            let Guarded {
-                value: acc,
-                guard: _acc_guard,
-            } = interp.call_function(
-                callback.clone(),
-                JsValue::Undefined,
-                &[accumulator, elem, JsValue::Number(i as f64), this.clone()],
-            )?;
-            accumulator = acc;
-        }
+        let Guarded {
+            value: acc,
+            guard: _acc_guard,
+        } = interp.call_function(
+            callback.clone(),
+            JsValue::Undefined,
+            &[accumulator, elem, JsValue::Number(i as f64), this.clone()],
+        )?;
+        accumulator = acc;
     }
 
     // Accumulator is a derived value - no guard needed as it's either a primitive
@@ -616,6 +625,17 @@ pub fn array_index_of(
         from_index.min(length) as u32
     };
 
+    if let JsValue::Number(target) = search_element
+        && let Some(numbers) = packed_numbers(&arr)
+    {
+        let found = numbers
+            .iter()
+            .skip(start as usize)
+            .position(|n| *n == target)
+            .map_or(-1.0, |i| (i + start as usize) as f64);
+        return Ok(Guarded::unguarded(JsValue::Number(found)));
+    }
+
     for i in start..(length as u32) {
         if has_array_like_element(&arr, i) {
             let elem = get_array_like_element(&arr, i);
@@ -652,6 +672,16 @@ pub fn array_includes(
         from_index.min(length) as u32
     };
 
+    if let JsValue::Number(target) = search_element
+        && let Some(numbers) = packed_numbers(&arr)
+    {
+        let found = numbers
+            .iter()
+            .skip(start as usize)
+            .any(|n| *n == target || (n.is_nan() && target.is_nan()));
+        return Ok(Guarded::unguarded(JsValue::Boolean(found)));
+    }
+
     for i in start..(length as u32) {
         if has_array_like_element(&arr, i) {
             let elem = get_array_like_element(&arr, i);
@@ -701,6 +731,16 @@ pub fn array_slice(
         end_arg.min(length)
     };
 
+    let guard = interp.heap.create_guard();
+    if let Some(numbers) = packed_numbers(&arr) {
+        let range = numbers
+            .get(start as usize..end as usize)
+            .unwrap_or_default();
+        let elements = ArrayElements::Double(range.to_vec());
+        let arr = interp.create_array_with_elements(&guard, elements);
+        return Ok(Guarded::with_guard(JsValue::Object(arr), guard));
+    }
+
     let mut result = Vec::new();
     for i in start..end {
         let elem = arr
@@ -710,7 +750,6 @@ pub fn array_slice(
         result.push(elem);
     }
 
-    let guard = interp.heap.create_guard();
     let arr = interp.create_array_from(&guard, result);
     Ok(Guarded::with_guard(JsValue::Object(arr), guard))
 }
@@ -821,22 +860,34 @@ pub fn array_join(
         .ok_or_else(|| JsError::type_error("Not an array"))?;
 
     let mut parts = Vec::with_capacity(length as usize);
+    let mut total = separator.len() * (length as usize).saturating_sub(1);
     for i in 0..length {
         let elem = arr
             .borrow()
             .get_property(&PropertyKey::Index(i))
             .unwrap_or(JsValue::Undefined);
 
-        let part = match elem {
-            JsValue::Undefined | JsValue::Null => String::new(),
-            _ => interp.to_js_string(&elem).to_string(),
-        };
-        parts.push(part);
+        if let JsValue::Undefined | JsValue::Null = elem {
+            parts.push(None);
+            continue;
+        }
+        let part = interp.to_js_string(&elem);
+        total += part.len();
+        parts.push(Some(part));
+    }
+
+    // Build the result in one exactly-sized copy
+    let mut result = String::with_capacity(total);
+    for (i, part) in parts.iter().enumerate() {
+        if i > 0 {
+            result.push_str(&separator);
+        }
+        if let Some(part) = part {
+            result.push_str(part.as_str());
+        }
     }
 
-    Ok(Guarded::unguarded(JsValue::String(JsString::from(
-        parts.join(&separator),
-    ))))
+    Ok(Guarded::unguarded(JsValue::String(JsString::from(result))))
 }
 
 /// Array.prototype.toString()
@@ -963,14 +1014,17 @@ pub fn array_shift(
 
     let mut arr_ref = arr.borrow_mut();
     let elements = arr_ref
-        .array_elements_mut()
+        .array_storage_mut()
         .ok_or_else(|| JsError::type_error("Array.prototype.shift called on non-array"))?;
 
     if elements.is_empty() {
         return Ok(Guarded::unguarded(JsValue::Undefined));
     }
 
-    let first = elements.remove(0);
+    let first = match elements {
+        ArrayElements::Double(numbers) => JsValue::Number(numbers.remove(0)),
+        ArrayElements::Generic(values) => values.remove(0),
+    };
     Ok(Guarded::unguarded(first))
 }
 
@@ -1015,10 +1069,13 @@ pub fn array_reverse(
 
     let mut arr_ref = arr.borrow_mut();
     let elements = arr_ref
-        .array_elements_mut()
+        .array_storage_mut()
         .ok_or_else(|| JsError::type_error("Array.prototype.reverse called on non-array"))?;
 
-    elements.reverse();
+    match elements {
+        ArrayElements::Double(numbers) => numbers.reverse(),
+        ArrayElements::Generic(values) => values.reverse(),
+    }
 
     drop(arr_ref);
     // Array was passed in by caller, already owned - no guard needed
@@ -1047,6 +1104,28 @@ pub fn array_sort(
         .array_length()
         .ok_or_else(|| JsError::type_error("Not an array"))?;
 
+    // Packed numbers are sorted as f64s and stored back without boxing
+    let packed = packed_numbers(&arr).map(|numbers| numbers.to_vec());
+    if let Some(numbers) = packed {
+        let numbers = sort_numbers(interp, numbers, compare_fn.as_ref())?;
+        let mut arr_ref = arr.borrow_mut();
+        if let Some(stored) = arr_ref
+            .array_storage_mut()
+            .and_then(ArrayElements::as_f64_vec_mut)
+            && stored.len() == numbers.len()
+        {
+            *stored = numbers;
+        } else {
+            // The comparator changed the array's storage
+            for (i, n) in numbers.into_iter().enumerate() {
+                arr_ref.set_property(PropertyKey::Index(i as u32), JsValue::Number(n));
+            }
+        }
+        drop(arr_ref);
+        let guard = interp.guard_value(&this);
+        return Ok(Guarded { value: this, guard });
+    }
+
     let mut elements: Vec<JsValue> = {
         let arr_ref = arr.borrow();
         (0..length)
@@ -1104,6 +1183,48 @@ pub fn array_sort(
     Ok(Guarded { value: this, guard })
 }
 
+/// `array_sort` over the numbers of a packed array, with the same comparator
+/// calls as the generic path
+fn sort_numbers(
+    interp: &mut Interpreter,
+    mut numbers: Vec<f64>,
+    compare_fn: Option<&JsValue>,
+) -> Result<Vec<f64>, JsError> {
+    match compare_fn {
+        Some(cmp) if cmp.is_callable() => {
+            for i in 0..numbers.len() {
+                let limit = numbers.len().saturating_sub(1 + i);
+                for j in 0..limit {
+                    let (left, right) = match (numbers.get(j), numbers.get(j + 1)) {
+                        (Some(l), Some(r)) => (*l, *r),
+                        _ => continue,
+                    };
+                    let Guarded {
+                        value: result,
+                        guard: _result_guard,
+                    } = interp.call_function(
+                        cmp.clone(),
+                        JsValue::Undefined,
+                        &[JsValue::Number(left), JsValue::Number(right)],
+                    )?;
+                    if result.to_number() > 0.0 {
+                        numbers.swap(j, j + 1);
+                    }
+                }
+            }
+            Ok(numbers)
+        }
+        Some(_) => Ok(numbers),
+        None => {
+            // Default order compares the numbers' string forms
+            let mut keyed: Vec<(String, f64)> =
+                numbers.iter().map(|n| (number_to_string(*n), *n)).collect();
+            keyed.sort_by(|(a, _), (b, _)| a.cmp(b));
+            Ok(keyed.into_iter().map(|(_, n)| n).collect())
+        }
+    }
+}
+
 pub fn array_fill(
     _interp: &mut Interpreter,
     this: JsValue,
@@ -1119,7 +1240,7 @@ pub fn array_fill(
 
     let mut arr_ref = arr.borrow_mut();
     let elements = arr_ref
-        .array_elements_mut()
+        .array_storage_mut()
         .ok_or_else(|| JsError::type_error("Array.prototype.fill called on non-array"))?;
     let length = elements.len() as i64;
 
@@ -1147,9 +1268,16 @@ pub fn array_fill(
         })
         .unwrap_or(length) as usize;
 
-    for i in start..end {
-        if let Some(slot) = elements.get_mut(i) {
-            *slot = value.clone();
+    if let (ArrayElements::Double(numbers), JsValue::Number(n)) = (&mut *elements, &value) {
+        if let Some(range) = numbers.get_mut(start..end) {
+            range.fill(*n);
+        }
+    } else {
+        let values = elements.make_generic();
+        for i in start..end {
+            if let Some(slot) = values.get_mut(i) {
+                *slot = value.clone();
+            }
         }
     }
 
@@ -1306,11 +1434,11 @@ pub fn array_from(
     match source {
         JsValue::Object(obj) => {
             // First check if object is an array (fast path)
-            let is_array = obj.borrow().array_elements().is_some();
+            let is_array = obj.borrow().array_storage().is_some();
             if is_array {
                 let source_elements: Vec<JsValue> = obj
                     .borrow()
-                    .array_elements()
+                    .array_storage()
                     .map(|e| e.to_vec())
                     .unwrap_or_default();
                 for (i, elem) in source_elements.into_iter().enumerate() {
@@ -1613,7 +1741,7 @@ pub fn array_flat(
     fn flatten(arr: &JsObjectRef, depth: i32) -> Vec<JsValue> {
         let elements: Vec<JsValue> = {
             let arr_ref = arr.borrow();
-            if let Some(elements) = arr_ref.array_elements() {
+            if let Some(elements) = arr_ref.array_storage() {
                 elements.to_vec()
             } else {
                 return vec![];
@@ -1696,14 +1824,14 @@ pub fn array_flat_map(
 
         let is_array = if let JsValue::Object(ref inner) = mapped {
             let inner_ref = inner.borrow();
-            if let Some(elements) = inner_ref.array_elements() {
+            if let Some(elements) = inner_ref.array_storage() {
                 // Guard each element being added to result
                 for el in elements.iter() {
                     if let JsValue::Object(obj) = el {
                         guard.guard(obj.cheap_clone());
                     }
                 }
-                result.extend(elements.iter().cloned());
+                result.extend(elements.iter());
                 true
             } else {
                 false
@@ -2150,7 +2278,11 @@ fn array_iterator_next(
             _ => 0,
         }
     } else {
-        arr.borrow().array_length().unwrap_or(0)
+        let arr_ref = arr.borrow();
+        arr_ref
+            .array_length()
+            .or_else(|| arr_ref.typed_array().map(|data| data.length as u32))
+            .unwrap_or(0)
     };
 
     if index >= length {
@@ -87,7 +87,7 @@ fn format_object_for_console(
             let display_len = length.min(max_items);
 
             for elem in elements.iter().take(display_len) {
-                items.push(format_value_with_depth(elem, depth + 1, seen));
+                items.push(format_value_with_depth(&elem, depth + 1, seen));
             }
 
             if length > max_items {
@@ -174,7 +174,29 @@ fn format_object_for_console(
         ExoticObject::Enum(_) => String::from("[Enum]"),
         ExoticObject::RawJSON(s) => s.to_string(),
         ExoticObject::PendingOrder { id } => format!("[PendingOrder: {}]", id),
-        ExoticObject::Ordinary => {
+        ExoticObject::ArrayBuffer(store) => {
+            format!("ArrayBuffer {{ byteLength: {} }}", store.len())
+        }
+        ExoticObject::TypedArray(data) => {
+            let display_len = data.length.min(max_items);
+            let mut items: Vec<String> = (0..display_len)
+                .filter_map(|i| data.get(i))
+                .map(|n| format_value_with_depth(&JsValue::Number(n), depth + 1, seen))
+                .collect();
+            if data.length > max_items {
+                items.push(format!("... {} more items", data.length - max_items));
+            }
+            format!(
+                "{}({}) [{}]",
+                data.kind.name(),
+                data.length,
+                items.join(", ")
+            )
+        }
+        ExoticObject::DataView(data) => {
+            format!("DataView {{ byteLength: {} }}", data.byte_length)
+        }
+        ExoticObject::Ordinary | ExoticObject::Error(_) => {
             // Regular object - format as { key: value, ... }
             let mut items = Vec::new();
             let mut count = 0;
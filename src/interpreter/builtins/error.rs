@@ -3,8 +3,10 @@
 use crate::error::JsError;
 use crate::gc::{Gc, Guard};
 use crate::interpreter::Interpreter;
-use crate::prelude::{String, ToString, format};
-use crate::value::{Guarded, JsObject, JsString, JsValue, PropertyKey};
+use crate::prelude::{String, ToString, Vec, format};
+use crate::value::{
+    CallSite, ErrorData, ExoticObject, Guarded, JsObject, JsString, JsValue, PropertyKey,
+};
 
 /// Initialize Error and all derived error constructors and add them to globals
 pub fn init_error(interp: &mut Interpreter) {
@@ -253,21 +255,28 @@ fn initialize_error_on_this(
         other => interp.to_js_string(other),
     };
 
-    // Build a simple stack trace
-    let stack = if msg_str.is_empty() {
-        JsString::from(name)
-    } else {
-        JsString::from(format!("{}: {}", name, msg_str))
-    };
-
+    let name_str = interp.intern(name);
     let name_key = interp.property_key("name");
     let message_key = interp.property_key("message");
-    let stack_key = interp.property_key("stack");
 
     let mut obj_ref = obj.borrow_mut();
-    obj_ref.set_property(name_key, JsValue::String(JsString::from(name)));
+    obj_ref.set_property(name_key, JsValue::String(name_str));
     obj_ref.set_property(message_key, JsValue::String(msg_str.clone()));
-    obj_ref.set_property(stack_key, JsValue::String(stack));
+    match obj_ref.exotic {
+        // `stack` is formatted when read, from the sites of the first throw
+        ExoticObject::Ordinary => obj_ref.exotic = ExoticObject::Error(ErrorData::default()),
+        ExoticObject::Error(_) => {}
+        // Other objects have no state to defer it with
+        _ => {
+            let stack = if msg_str.is_empty() {
+                JsString::from(name)
+            } else {
+                JsString::from(format!("{}: {}", name, msg_str))
+            };
+            let stack_key = interp.property_key("stack");
+            obj_ref.set_property(stack_key, JsValue::String(stack));
+        }
+    }
 }
 
 /// Error constructor - sets name and message on `this`
@@ -365,11 +374,12 @@ pub fn eval_error_constructor(
     Ok(Guarded::unguarded(JsValue::Undefined))
 }
 
-/// Create an error object from a JsError
+/// Create an error object from a JsError raised at `sites`
 /// Returns the error object and a guard to keep it alive
 pub fn create_error_object(
     interp: &mut Interpreter,
     error: &JsError,
+    sites: Vec<CallSite>,
 ) -> (JsValue, Option<Guard<JsObject>>) {
     let guard = interp.heap.create_guard();
 
@@ -422,23 +432,16 @@ pub fn create_error_object(
     let error_obj = guard.alloc();
     error_obj.borrow_mut().prototype = Some(prototype);
 
-    // Set name, message, and stack properties
-    let msg_str = JsString::from(message.as_str());
-    let stack_str = if msg_str.is_empty() {
-        JsString::from(name)
-    } else {
-        JsString::from(format!("{}: {}", name, msg_str))
-    };
-
+    // Set name and message; stack is formatted from the sites when read
+    let name_str = interp.intern(name);
     let name_key = interp.property_key("name");
     let message_key = interp.property_key("message");
-    let stack_key = interp.property_key("stack");
 
     {
         let mut obj = error_obj.borrow_mut();
-        obj.set_property(name_key, JsValue::String(JsString::from(name)));
-        obj.set_property(message_key, JsValue::String(msg_str));
-        obj.set_property(stack_key, JsValue::String(stack_str));
+        obj.set_property(name_key, JsValue::String(name_str));
+        obj.set_property(message_key, JsValue::String(JsString::from(message)));
+        obj.exotic = ExoticObject::Error(ErrorData::new(sites));
     }
 
     (JsValue::Object(error_obj), Some(guard))
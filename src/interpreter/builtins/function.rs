@@ -310,7 +310,7 @@ pub fn function_apply(
     let call_args: Vec<JsValue> = match args_array {
         JsValue::Object(arr_ref) => {
             let arr = arr_ref.borrow();
-            if let Some(elements) = arr.array_elements() {
+            if let Some(elements) = arr.array_storage() {
                 elements.to_vec()
             } else {
                 vec![]
@@ -8,7 +8,8 @@ use crate::prelude::{
     String, ToString, Vec, format, index_map_with_capacity, index_set_with_capacity,
 };
 use crate::value::{
-    CheapClone, ExoticObject, Guarded, JsMapKey, JsObject, JsString, JsValue, Property, PropertyKey,
+    ByteStore, CheapClone, ExoticObject, Guarded, JsMapKey, JsObject, JsString, JsValue, Property,
+    PropertyKey,
 };
 
 /// Register global functions (parseInt, parseFloat, isNaN, isFinite, URI functions)
@@ -749,7 +750,7 @@ fn clone_object(
         // Arrays - clone elements recursively
         ExoticObject::Array { elements } => {
             // Clone elements recursively first, then release borrow
-            let elements_to_clone: Vec<JsValue> = elements.clone();
+            let elements_to_clone: Vec<JsValue> = elements.to_vec();
             drop(obj_ref); // Release borrow before recursive calls
 
             let mut cloned_elements = Vec::with_capacity(elements_to_clone.len());
@@ -870,6 +871,49 @@ fn clone_object(
             Ok(JsValue::Object(regexp_obj))
         }
 
+        // ArrayBuffers and their views - copy the bytes into a new buffer
+        ExoticObject::ArrayBuffer(store) => {
+            let copy = ByteStore::new(store.bytes().to_vec());
+            drop(obj_ref);
+            Ok(JsValue::Object(interp.create_array_buffer(guard, copy)))
+        }
+        ExoticObject::TypedArray(data) => {
+            let kind = data.kind;
+            let length = data.length;
+            let start = data.byte_offset;
+            let copy = ByteStore::new(
+                data.store
+                    .bytes()
+                    .get(start..start + data.byte_length())
+                    .unwrap_or_default()
+                    .to_vec(),
+            );
+            drop(obj_ref);
+            let buffer = interp.create_array_buffer(guard, copy.cheap_clone());
+            let array = interp.create_typed_array(guard, kind, buffer, copy, 0, length);
+            Ok(JsValue::Object(array))
+        }
+        ExoticObject::DataView(data) => {
+            let start = data.byte_offset;
+            let copy = ByteStore::new(
+                data.store
+                    .bytes()
+                    .get(start..start + data.byte_length)
+                    .unwrap_or_default()
+                    .to_vec(),
+            );
+            drop(obj_ref);
+            let byte_length = copy.len();
+            let buffer = interp.create_array_buffer(guard, copy.cheap_clone());
+            Ok(JsValue::Object(interp.create_data_view(
+                guard,
+                buffer,
+                copy,
+                0,
+                byte_length,
+            )))
+        }
+
         // Booleans - clone the boolean value
         ExoticObject::Boolean(b) => {
             let bool_val = *b;
@@ -932,18 +976,26 @@ fn clone_object(
         }
 
         // Ordinary objects - clone properties recursively
-        ExoticObject::Ordinary => {
+        ExoticObject::Ordinary | ExoticObject::Error(_) => {
             // Collect properties to clone (extract values from Property wrapper)
-            let props_to_clone: Vec<(PropertyKey, JsValue)> = obj_ref
+            let mut props_to_clone: Vec<(PropertyKey, JsValue)> = obj_ref
                 .properties
                 .iter()
                 .map(|(k, prop)| (k.clone(), prop.value.clone()))
                 .collect();
 
+            // An error's stack is formatted on demand; the clone gets it as data
+            let key_stack = interp.property_key("stack");
+            if matches!(obj_ref.exotic, ExoticObject::Error(_))
+                && !obj_ref.properties.contains_key(&key_stack)
+                && let Some(stack) = obj_ref.get_property(&key_stack)
+            {
+                props_to_clone.push((key_stack.clone(), stack));
+            }
+
             // Check if this is an Error object by looking at prototype chain
             let key_name = interp.property_key("name");
             let key_message = interp.property_key("message");
-            let key_stack = interp.property_key("stack");
             let is_error = obj_ref.properties.contains_key(&key_name)
                 && obj_ref.properties.contains_key(&key_message)
                 && obj_ref.properties.contains_key(&key_stack);
@@ -164,7 +164,7 @@ pub fn js_value_to_json(value: &JsValue) -> Result<serde_json::Value, JsError> {
 }
 
 /// Convert a JsValue to JSON, tracking visited objects for circular reference detection
-fn js_value_to_json_with_visited(
+pub(crate) fn js_value_to_json_with_visited(
     value: &JsValue,
     visited: &mut FxHashSet<usize>,
 ) -> Result<serde_json::Value, JsError> {
@@ -200,10 +200,10 @@ fn js_value_to_json_with_visited(
 
             let result = {
                 let obj_ref = obj.borrow();
-                if let Some(elements) = obj_ref.array_elements() {
+                if let Some(elements) = obj_ref.array_storage() {
                     let mut arr = Vec::with_capacity(elements.len());
                     for val in elements {
-                        arr.push(js_value_to_json_with_visited(val, visited)?);
+                        arr.push(js_value_to_json_with_visited(&val, visited)?);
                     }
                     serde_json::Value::Array(arr)
                 } else {
@@ -246,7 +246,7 @@ fn js_value_to_json_with_visited(
                             }
                             serde_json::Value::Object(map)
                         }
-                        ExoticObject::Ordinary => {
+                        ExoticObject::Ordinary | ExoticObject::Error(_) => {
                             // Ordinary objects serialize with their properties
                             let mut map = serde_json::Map::new();
                             // First collect keys to avoid borrowing issues
@@ -307,6 +307,22 @@ fn js_value_to_json_with_visited(
                             // PendingOrder markers serialize to null
                             serde_json::Value::Null
                         }
+                        ExoticObject::TypedArray(data) => {
+                            // Typed arrays serialize as objects keyed by index
+                            let mut map = serde_json::Map::new();
+                            for i in 0..data.length {
+                                let n = JsValue::Number(data.get(i).unwrap_or(0.0));
+                                map.insert(
+                                    i.to_string(),
+                                    js_value_to_json_with_visited(&n, visited)?,
+                                );
+                            }
+                            serde_json::Value::Object(map)
+                        }
+                        ExoticObject::ArrayBuffer(_) | ExoticObject::DataView(_) => {
+                            // No enumerable own properties
+                            serde_json::Value::Object(serde_json::Map::new())
+                        }
                     }
                 }
             };
@@ -0,0 +1,641 @@
+//! Incremental JSON parsing and chunked JSON serialization.
+//!
+//! `JsonStreamParser` accepts input in arbitrary byte chunks and builds
+//! `JsObject`s as tokens complete, so a host can feed a large document
+//! straight from its own buffers without first assembling one contiguous
+//! string or an intermediate `serde_json::Value` tree.
+//!
+//! `json_stringify_to` walks a value and hands its serialization to a sink
+//! in bounded chunks. The output is byte-for-byte what `js_value_to_json`
+//! followed by `serde_json::to_string` produces, including its key order.
+
+use crate::error::JsError;
+use crate::gc::{Gc, Guard};
+use crate::interpreter::Interpreter;
+use crate::prelude::{FxHashSet, String, ToString, Vec, format, math};
+use crate::value::{
+    ArrayElements, ExoticObject, Guarded, JsObject, JsString, JsValue, PropertyKey,
+};
+
+use super::json::js_value_to_json_with_visited;
+
+/// Output is buffered up to this many bytes before being passed to the sink.
+const WRITE_CHUNK_SIZE: usize = 16 * 1024;
+
+/// A container that is still being parsed.
+enum Frame {
+    /// Elements collected so far; the array is created when `]` is reached.
+    Array(Vec<JsValue>),
+    /// The object being filled and the key awaiting its value.
+    Object {
+        obj: Gc<JsObject>,
+        key: Option<JsString>,
+    },
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum Literal {
+    True,
+    False,
+    Null,
+}
+
+impl Literal {
+    fn text(self) -> &'static [u8] {
+        match self {
+            Literal::True => b"true",
+            Literal::False => b"false",
+            Literal::Null => b"null",
+        }
+    }
+
+    fn value(self) -> JsValue {
+        match self {
+            Literal::True => JsValue::Boolean(true),
+            Literal::False => JsValue::Boolean(false),
+            Literal::Null => JsValue::Null,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+enum State {
+    /// Expecting a value: at the top level, after `:`, or after `,` in an array
+    Value,
+    /// After `[`: a value or `]`
+    ArrayStart,
+    /// After `{`: a key or `}`
+    ObjectStart,
+    /// After `,` in an object: a key
+    Key,
+    /// After a key: `:`
+    Colon,
+    /// After a value inside a container: `,` or the closing bracket
+    AfterValue,
+    /// Inside a string literal (`key` marks an object key)
+    Str { key: bool },
+    /// After a backslash inside a string
+    Escape { key: bool },
+    /// Inside a `\uXXXX` escape with `digits` hex digits read
+    Unicode { key: bool, digits: u8, code: u16 },
+    /// Inside a number
+    Number,
+    /// Inside `true`, `false` or `null` with `matched` bytes read
+    Literal { word: Literal, matched: u8 },
+    /// The top-level value is complete; only whitespace may follow
+    Done,
+    /// An earlier chunk failed to parse
+    Failed,
+}
+
+/// Push-based JSON parser that builds JS values while input arrives.
+///
+/// Every object is allocated through the parser's own guard, so partially
+/// built containers survive collections triggered between chunks. Nesting
+/// is tracked on an explicit stack rather than by recursion, so document
+/// depth is bounded only by memory.
+///
+/// Once `feed` returns an error the parser stays failed; `finish` reports
+/// the failure as well.
+pub struct JsonStreamParser {
+    guard: Guard<JsObject>,
+    stack: Vec<Frame>,
+    state: State,
+    /// Bytes of the string or number currently being read
+    token: Vec<u8>,
+    /// Leading half of a surrogate pair awaiting its trailing `\uXXXX`
+    high_surrogate: Option<u16>,
+    result: Option<JsValue>,
+    /// Bytes consumed by earlier chunks, for error positions
+    offset: usize,
+}
+
+impl JsonStreamParser {
+    pub fn new(interp: &Interpreter) -> Self {
+        Self {
+            guard: interp.heap.create_guard(),
+            stack: Vec::new(),
+            state: State::Value,
+            token: Vec::new(),
+            high_surrogate: None,
+            result: None,
+            offset: 0,
+        }
+    }
+
+    /// Parse the next chunk of input. Chunks may split the document anywhere,
+    /// including inside strings, escapes, numbers and multi-byte characters.
+    pub fn feed(&mut self, interp: &mut Interpreter, chunk: &[u8]) -> Result<(), JsError> {
+        if self.state == State::Failed {
+            return Err(JsError::syntax_error(
+                "JSON parse error: parser already failed",
+                0,
+                0,
+            ));
+        }
+        let result = self.feed_chunk(interp, chunk);
+        match result {
+            Ok(()) => self.offset += chunk.len(),
+            Err(_) => self.state = State::Failed,
+        }
+        result
+    }
+
+    /// Complete parsing and return the top-level value.
+    pub fn finish(mut self) -> Result<Guarded, JsError> {
+        if self.state == State::Number && self.stack.is_empty() {
+            self.finish_number(self.offset)?;
+        }
+        match (self.state, self.result.take()) {
+            (State::Done, Some(value)) => Ok(Guarded::with_guard(value, self.guard)),
+            (State::Failed, _) => Err(JsError::syntax_error(
+                "JSON parse error: parser already failed",
+                0,
+                0,
+            )),
+            _ => Err(self.error("unexpected end of JSON input", self.offset)),
+        }
+    }
+
+    fn error(&self, message: &str, position: usize) -> JsError {
+        JsError::syntax_error(
+            format!("JSON parse error: {} at position {}", message, position),
+            0,
+            0,
+        )
+    }
+
+    fn feed_chunk(&mut self, interp: &mut Interpreter, chunk: &[u8]) -> Result<(), JsError> {
+        let mut i = 0;
+        while let Some(&b) = chunk.get(i) {
+            let pos = self.offset + i;
+            match self.state {
+                State::Str { key } => {
+                    // Copy the run of plain bytes up to the next quote, escape or
+                    // control character in one go.
+                    let rest = chunk.get(i..).unwrap_or_default();
+                    let run = rest
+                        .iter()
+                        .position(|&c| c == b'"' || c == b'\\' || c < 0x20)
+                        .unwrap_or(rest.len());
+                    if (run > 0 || b != b'\\') && self.high_surrogate.is_some() {
+                        return Err(self.error("lone leading surrogate in hex escape", pos));
+                    }
+                    if run > 0 {
+                        self.token
+                            .extend_from_slice(rest.get(..run).unwrap_or_default());
+                        i += run;
+                        continue;
+                    }
+                    i += 1;
+                    match b {
+                        b'"' => self.finish_string(interp, key, pos)?,
+                        b'\\' => self.state = State::Escape { key },
+                        _ => return Err(self.error("control character in string", pos)),
+                    }
+                    continue;
+                }
+                State::Number => {
+                    if matches!(b, b'0'..=b'9' | b'-' | b'+' | b'.' | b'e' | b'E') {
+                        self.token.push(b);
+                        i += 1;
+                    } else {
+                        // The terminating byte belongs to the enclosing state.
+                        self.finish_number(pos)?;
+                    }
+                    continue;
+                }
+                State::Escape { key } => {
+                    if self.high_surrogate.is_some() && b != b'u' {
+                        return Err(self.error("lone leading surrogate in hex escape", pos));
+                    }
+                    let decoded = match b {
+                        b'"' => b'"',
+                        b'\\' => b'\\',
+                        b'/' => b'/',
+                        b'b' => 0x08,
+                        b'f' => 0x0c,
+                        b'n' => b'\n',
+                        b'r' => b'\r',
+                        b't' => b'\t',
+                        b'u' => {
+                            self.state = State::Unicode {
+                                key,
+                                digits: 0,
+                                code: 0,
+                            };
+                            i += 1;
+                            continue;
+                        }
+                        _ => return Err(self.error("invalid escape", pos)),
+                    };
+                    self.token.push(decoded);
+                    self.state = State::Str { key };
+                }
+                State::Unicode { key, digits, code } => {
+                    let Some(digit) = (b as char).to_digit(16) else {
+                        return Err(self.error("invalid \\u escape", pos));
+                    };
+                    let code = code * 16 + digit as u16;
+                    if digits < 3 {
+                        self.state = State::Unicode {
+                            key,
+                            digits: digits + 1,
+                            code,
+                        };
+                    } else {
+                        self.push_code_unit(code, pos)?;
+                        self.state = State::Str { key };
+                    }
+                }
+                State::Literal { word, matched } => {
+                    let text = word.text();
+                    if text.get(matched as usize) != Some(&b) {
+                        return Err(self.error("invalid literal", pos));
+                    }
+                    let matched = matched + 1;
+                    if matched as usize == text.len() {
+                        self.complete_value(word.value());
+                    } else {
+                        self.state = State::Literal { word, matched };
+                    }
+                }
+                _ if matches!(b, b' ' | b'\t' | b'\n' | b'\r') => {}
+                State::Value => self.begin_value(interp, b, pos)?,
+                State::ArrayStart => {
+                    if b == b']' {
+                        self.close_array(interp);
+                    } else {
+                        self.begin_value(interp, b, pos)?;
+                    }
+                }
+                State::ObjectStart | State::Key => match b {
+                    b'"' => {
+                        self.token.clear();
+                        self.state = State::Str { key: true };
+                    }
+                    b'}' if self.state == State::ObjectStart => self.close_object(),
+                    _ => return Err(self.error("expected string key", pos)),
+                },
+                State::Colon => {
+                    if b != b':' {
+                        return Err(self.error("expected ':'", pos));
+                    }
+                    self.state = State::Value;
+                }
+                State::AfterValue => match (b, self.stack.last()) {
+                    (b',', Some(Frame::Array(_))) => self.state = State::Value,
+                    (b',', Some(Frame::Object { .. })) => self.state = State::Key,
+                    (b']', Some(Frame::Array(_))) => self.close_array(interp),
+                    (b'}', Some(Frame::Object { .. })) => self.close_object(),
+                    _ => return Err(self.error("expected ',' or closing bracket", pos)),
+                },
+                State::Done => return Err(self.error("trailing characters", pos)),
+                State::Failed => return Err(self.error("parser already failed", pos)),
+            }
+            i += 1;
+        }
+        Ok(())
+    }
+
+    fn begin_value(&mut self, interp: &mut Interpreter, b: u8, pos: usize) -> Result<(), JsError> {
+        match b {
+            b'{' => {
+                let obj = interp.create_object(&self.guard);
+                self.stack.push(Frame::Object { obj, key: None });
+                self.state = State::ObjectStart;
+            }
+            b'[' => {
+                self.stack.push(Frame::Array(Vec::new()));
+                self.state = State::ArrayStart;
+            }
+            b'"' => {
+                self.token.clear();
+                self.state = State::Str { key: false };
+            }
+            b'-' | b'0'..=b'9' => {
+                self.token.clear();
+                self.token.push(b);
+                self.state = State::Number;
+            }
+            b't' | b'f' | b'n' => {
+                let word = match b {
+                    b't' => Literal::True,
+                    b'f' => Literal::False,
+                    _ => Literal::Null,
+                };
+                self.state = State::Literal { word, matched: 1 };
+            }
+            _ => return Err(self.error("expected value", pos)),
+        }
+        Ok(())
+    }
+
+    /// Store a completed value in the enclosing container, or as the result.
+    fn complete_value(&mut self, value: JsValue) {
+        match self.stack.last_mut() {
+            None => {
+                self.result = Some(value);
+                self.state = State::Done;
+            }
+            Some(Frame::Array(elements)) => {
+                elements.push(value);
+                self.state = State::AfterValue;
+            }
+            Some(Frame::Object { obj, key }) => {
+                if let Some(key) = key.take() {
+                    obj.borrow_mut()
+                        .set_property(PropertyKey::String(key), value);
+                }
+                self.state = State::AfterValue;
+            }
+        }
+    }
+
+    fn close_array(&mut self, interp: &mut Interpreter) {
+        if let Some(Frame::Array(elements)) = self.stack.pop() {
+            let arr = interp.create_array_from(&self.guard, elements);
+            self.complete_value(JsValue::Object(arr));
+        }
+    }
+
+    fn close_object(&mut self) {
+        if let Some(Frame::Object { obj, .. }) = self.stack.pop() {
+            self.complete_value(JsValue::Object(obj));
+        }
+    }
+
+    fn finish_string(
+        &mut self,
+        interp: &mut Interpreter,
+        key: bool,
+        pos: usize,
+    ) -> Result<(), JsError> {
+        let Ok(text) = core::str::from_utf8(&self.token) else {
+            return Err(self.error("invalid UTF-8 in string", pos));
+        };
+        if key {
+            let interned = interp.intern(text);
+            if let Some(Frame::Object { key, .. }) = self.stack.last_mut() {
+                *key = Some(interned);
+            }
+            self.state = State::Colon;
+        } else {
+            let value = JsValue::String(JsString::from(text));
+            self.complete_value(value);
+        }
+        Ok(())
+    }
+
+    fn finish_number(&mut self, pos: usize) -> Result<(), JsError> {
+        let parsed = core::str::from_utf8(&self.token)
+            .ok()
+            .filter(|text| is_json_number(text.as_bytes()))
+            .and_then(|text| text.parse::<f64>().ok());
+        let Some(n) = parsed else {
+            return Err(self.error("invalid number", pos));
+        };
+        self.complete_value(JsValue::Number(n));
+        Ok(())
+    }
+
+    /// Append one UTF-16 code unit from a `\uXXXX` escape, pairing surrogates.
+    fn push_code_unit(&mut self, code: u16, pos: usize) -> Result<(), JsError> {
+        let scalar = match (self.high_surrogate.take(), code) {
+            (Some(high), 0xDC00..=0xDFFF) => {
+                0x10000 + ((u32::from(high) - 0xD800) << 10) + (u32::from(code) - 0xDC00)
+            }
+            (Some(_), _) => return Err(self.error("lone leading surrogate in hex escape", pos)),
+            (None, 0xD800..=0xDBFF) => {
+                self.high_surrogate = Some(code);
+                return Ok(());
+            }
+            (None, 0xDC00..=0xDFFF) => {
+                return Err(self.error("lone trailing surrogate in hex escape", pos));
+            }
+            (None, _) => u32::from(code),
+        };
+        let ch = char::from_u32(scalar).unwrap_or(char::REPLACEMENT_CHARACTER);
+        let mut buf = [0u8; 4];
+        self.token
+            .extend_from_slice(ch.encode_utf8(&mut buf).as_bytes());
+        Ok(())
+    }
+}
+
+/// Check `-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?`.
+fn is_json_number(bytes: &[u8]) -> bool {
+    fn digits(bytes: &[u8], mut i: usize) -> usize {
+        while matches!(bytes.get(i), Some(b'0'..=b'9')) {
+            i += 1;
+        }
+        i
+    }
+
+    let mut i = 0;
+    if bytes.get(i) == Some(&b'-') {
+        i += 1;
+    }
+    match bytes.get(i) {
+        Some(b'0') => i += 1,
+        Some(b'1'..=b'9') => i = digits(bytes, i + 1),
+        _ => return false,
+    }
+    if bytes.get(i) == Some(&b'.') {
+        let end = digits(bytes, i + 1);
+        if end == i + 1 {
+            return false;
+        }
+        i = end;
+    }
+    if matches!(bytes.get(i), Some(b'e' | b'E')) {
+        i += 1;
+        if matches!(bytes.get(i), Some(b'+' | b'-')) {
+            i += 1;
+        }
+        let end = digits(bytes, i);
+        if end == i {
+            return false;
+        }
+        i = end;
+    }
+    i == bytes.len()
+}
+
+/// Serialize `value` as JSON, passing the output to `sink` in chunks of at
+/// most `WRITE_CHUNK_SIZE` bytes (a single long string may be passed whole).
+///
+/// Output that has already reached the sink is not retracted if an error
+/// (such as a circular reference) is found later in the value.
+pub fn json_stringify_to<F>(value: &JsValue, sink: F) -> Result<(), JsError>
+where
+    F: FnMut(&str) -> Result<(), JsError>,
+{
+    let mut writer = JsonWriter {
+        buf: String::with_capacity(WRITE_CHUNK_SIZE),
+        sink,
+        visited: FxHashSet::default(),
+    };
+    writer.write_value(value)?;
+    writer.flush()
+}
+
+struct JsonWriter<F> {
+    buf: String,
+    sink: F,
+    visited: FxHashSet<usize>,
+}
+
+impl<F> JsonWriter<F>
+where
+    F: FnMut(&str) -> Result<(), JsError>,
+{
+    fn flush(&mut self) -> Result<(), JsError> {
+        if !self.buf.is_empty() {
+            (self.sink)(&self.buf)?;
+            self.buf.clear();
+        }
+        Ok(())
+    }
+
+    fn write_raw(&mut self, s: &str) -> Result<(), JsError> {
+        if self.buf.len() + s.len() > WRITE_CHUNK_SIZE {
+            self.flush()?;
+            if s.len() >= WRITE_CHUNK_SIZE {
+                return (self.sink)(s);
+            }
+        }
+        self.buf.push_str(s);
+        Ok(())
+    }
+
+    fn write_value(&mut self, value: &JsValue) -> Result<(), JsError> {
+        match value {
+            JsValue::Undefined | JsValue::Null | JsValue::Symbol(_) => self.write_raw("null"),
+            JsValue::Boolean(true) => self.write_raw("true"),
+            JsValue::Boolean(false) => self.write_raw("false"),
+            JsValue::Number(n) => self.write_number(*n),
+            JsValue::String(s) => self.write_string(s.as_str()),
+            JsValue::Object(obj) => {
+                let obj_id = obj.id();
+                if self.visited.contains(&obj_id) {
+                    return Err(JsError::type_error(
+                        "Converting circular structure to JSON".to_string(),
+                    ));
+                }
+
+                let obj_ref = obj.borrow();
+                if let Some(elements) = obj_ref.array_storage() {
+                    self.visited.insert(obj_id);
+                    self.write_raw("[")?;
+                    match elements {
+                        ArrayElements::Double(numbers) => {
+                            for (i, n) in numbers.iter().enumerate() {
+                                if i > 0 {
+                                    self.write_raw(",")?;
+                                }
+                                self.write_number(*n)?;
+                            }
+                        }
+                        ArrayElements::Generic(values) => {
+                            for (i, element) in values.iter().enumerate() {
+                                if i > 0 {
+                                    self.write_raw(",")?;
+                                }
+                                self.write_value(element)?;
+                            }
+                        }
+                    }
+                    self.write_raw("]")?;
+                    self.visited.remove(&obj_id);
+                    return Ok(());
+                }
+                if !matches!(
+                    obj_ref.exotic,
+                    ExoticObject::Ordinary | ExoticObject::Error(_)
+                ) {
+                    drop(obj_ref);
+                    // Wrappers, dates, enums and raw JSON are small; reuse the
+                    // tree conversion so their rules live in one place.
+                    let json = js_value_to_json_with_visited(value, &mut self.visited)?;
+                    let text = serde_json::to_string(&json)
+                        .map_err(|e| JsError::internal_error(e.to_string()))?;
+                    return self.write_raw(&text);
+                }
+
+                let mut props: Vec<(String, JsValue)> = obj_ref
+                    .properties
+                    .iter()
+                    .filter(|(_, prop)| prop.enumerable() && !prop.value.is_undefined())
+                    .map(|(k, p)| (k.to_string(), p.value.clone()))
+                    .collect();
+                drop(obj_ref);
+                // Match the sorted, last-wins key order of serde_json's map
+                props.sort_by(|a, b| a.0.cmp(&b.0));
+
+                self.visited.insert(obj_id);
+                self.write_raw("{")?;
+                let mut first = true;
+                let mut iter = props.iter().peekable();
+                while let Some((key, val)) = iter.next() {
+                    if iter.peek().is_some_and(|(next, _)| next == key) {
+                        continue;
+                    }
+                    if !first {
+                        self.write_raw(",")?;
+                    }
+                    first = false;
+                    self.write_string(key)?;
+                    self.write_raw(":")?;
+                    self.write_value(val)?;
+                }
+                self.write_raw("}")?;
+                self.visited.remove(&obj_id);
+                Ok(())
+            }
+        }
+    }
+
+    fn write_number(&mut self, n: f64) -> Result<(), JsError> {
+        if !n.is_finite() {
+            return self.write_raw("null");
+        }
+        let text = if math::fract(n) == 0.0 && n >= i64::MIN as f64 && n <= i64::MAX as f64 {
+            (n as i64).to_string()
+        } else {
+            serde_json::Number::from_f64(n)
+                .map(|num| num.to_string())
+                .unwrap_or_else(|| "0".to_string())
+        };
+        self.write_raw(&text)
+    }
+
+    /// Write a quoted string using serde_json's escaping rules.
+    fn write_string(&mut self, s: &str) -> Result<(), JsError> {
+        self.write_raw("\"")?;
+        let mut start = 0;
+        for (i, b) in s.bytes().enumerate() {
+            let escape = match b {
+                b'"' => "\\\"",
+                b'\\' => "\\\\",
+                b'\n' => "\\n",
+                b'\r' => "\\r",
+                b'\t' => "\\t",
+                0x08 => "\\b",
+                0x0c => "\\f",
+                0x00..=0x1f => "",
+                _ => continue,
+            };
+            // Escaped bytes are ASCII, so both slice bounds are char boundaries
+            self.write_raw(s.get(start..i).unwrap_or_default())?;
+            if escape.is_empty() {
+                self.write_raw(&format!("\\u{:04x}", b))?;
+            } else {
+                self.write_raw(escape)?;
+            }
+            start = i + 1;
+        }
+        self.write_raw(s.get(start..).unwrap_or_default())?;
+        self.write_raw("\"")
+    }
+}
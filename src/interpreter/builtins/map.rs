@@ -88,7 +88,7 @@ pub fn map_constructor(
         let pairs: Vec<(JsValue, JsValue)> = {
             let arr_ref = arr.borrow();
             let mut result = Vec::new();
-            if let Some(elements) = arr_ref.array_elements() {
+            if let Some(elements) = arr_ref.array_storage() {
                 for elem in elements {
                     if let JsValue::Object(pair_arr) = elem {
                         let pair_ref = pair_arr.borrow();
@@ -512,7 +512,7 @@ pub fn map_group_by(
     // Get array elements
     let elements: Vec<JsValue> = {
         let items_borrowed = items_ref.borrow();
-        if let Some(elems) = items_borrowed.array_elements() {
+        if let Some(elems) = items_borrowed.array_storage() {
             elems.to_vec()
         } else {
             return Err(JsError::type_error(
@@ -11,6 +11,7 @@ pub mod generator;
 pub mod global;
 pub mod internal;
 pub mod json;
+pub mod json_stream;
 pub mod map;
 pub mod math;
 pub mod number;
@@ -22,6 +23,8 @@ pub mod regexp;
 pub mod set;
 pub mod string;
 pub mod symbol;
+pub mod typed_array;
+pub mod value_codec;
 
 // Re-export public functions from enabled modules
 pub use array::*;
@@ -46,3 +49,4 @@ pub use regexp::*;
 pub use set::*;
 pub use string::*;
 pub use symbol::*;
+pub use typed_array::*;
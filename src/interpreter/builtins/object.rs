@@ -192,11 +192,10 @@ pub fn object_keys(
         // Filter for enumerable string keys only (not symbols)
         if let JsValue::Object(keys_arr) = keys_result {
             let keys_ref = keys_arr.borrow();
-            if let Some(elements) = keys_ref.array_elements() {
+            if let Some(elements) = keys_ref.array_storage() {
                 let string_keys: Vec<JsValue> = elements
                     .iter()
                     .filter(|k| matches!(k, JsValue::String(_)))
-                    .cloned()
                     .collect();
                 drop(keys_ref);
                 let guard = interp.heap.create_guard();
@@ -248,6 +247,18 @@ pub fn object_keys(
                 }
             }
             result
+        } else if let ExoticObject::TypedArray(ref data) = obj.exotic {
+            // Typed array elements are indices 0..length, then named properties
+            let mut result: Vec<JsValue> = (0..data.length)
+                .map(|i| JsValue::String(JsString::from(i.to_string())))
+                .collect();
+            result.extend(
+                obj.properties
+                    .iter()
+                    .filter(|(key, prop)| prop.enumerable() && !key.is_symbol())
+                    .map(|(key, _)| JsValue::String(JsString::from(key.to_string()))),
+            );
+            result
         } else {
             // Standard object - get from properties
             // Only include enumerable string keys, not symbols
@@ -683,6 +694,12 @@ pub fn object_has_own_property(
                 obj_ref.properties.contains_key(&key)
             }
         }
+    } else if let Some(data) = obj_ref.typed_array() {
+        // Typed array elements are indices below the length
+        match &key {
+            PropertyKey::Index(index) => (*index as usize) < data.length,
+            _ => obj_ref.properties.contains_key(&key),
+        }
     } else {
         // Standard object - check properties
         obj_ref.properties.contains_key(&key)
@@ -751,6 +768,7 @@ pub fn object_to_string(
                 ExoticObject::Array { .. } => "Array",
                 ExoticObject::Function(_) => "Function",
                 ExoticObject::Ordinary => "Object",
+                ExoticObject::Error(_) => "Error",
                 ExoticObject::Map { .. } => "Map",
                 ExoticObject::Set { .. } => "Set",
                 ExoticObject::Date { .. } => "Date",
@@ -766,6 +784,9 @@ pub fn object_to_string(
                 ExoticObject::Symbol(_) => "Symbol",
                 ExoticObject::RawJSON(_) => "Object", // RawJSON objects are ordinary objects
                 ExoticObject::PendingOrder { .. } => "Object", // PendingOrder markers are objects
+                ExoticObject::ArrayBuffer(_) => "ArrayBuffer",
+                ExoticObject::TypedArray(data) => data.kind.name(),
+                ExoticObject::DataView(_) => "DataView",
             }
         }
     };
@@ -1029,14 +1050,8 @@ pub fn object_define_property(
             };
 
             if let Some(index) = maybe_index {
-                // Extend array if needed
-                while elements.len() <= index {
-                    elements.push(JsValue::Undefined);
-                }
-                // Set the value at this index
-                if let Some(elem) = elements.get_mut(index) {
-                    *elem = value.clone();
-                }
+                // Extends the array if needed
+                elements.set(index, value.clone());
             }
         }
 
@@ -1404,7 +1419,7 @@ pub fn object_group_by(
     // Get array elements
     let elements: Vec<JsValue> = {
         let items_borrowed = items_ref.borrow();
-        if let Some(elems) = items_borrowed.array_elements() {
+        if let Some(elems) = items_borrowed.array_storage() {
             elems.to_vec()
         } else {
             return Err(JsError::type_error(
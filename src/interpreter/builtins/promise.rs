@@ -656,7 +656,7 @@ fn extract_iterable(value: &JsValue) -> Result<Vec<JsValue>, JsError> {
     };
 
     let arr_ref = arr.borrow();
-    if let Some(elements) = arr_ref.array_elements() {
+    if let Some(elements) = arr_ref.array_storage() {
         Ok(elements.to_vec())
     } else {
         Ok(vec![])
@@ -291,7 +291,7 @@ fn reflect_apply(
     // Convert arguments list to array
     let call_args = if let JsValue::Object(arr) = arguments_list {
         let arr_ref = arr.borrow();
-        if let Some(elements) = arr_ref.array_elements() {
+        if let Some(elements) = arr_ref.array_storage() {
             elements.to_vec()
         } else {
             vec![]
@@ -322,7 +322,7 @@ fn reflect_construct(
     // Convert arguments list to array
     let call_args: Vec<JsValue> = if let JsValue::Object(arr) = arguments_list {
         let arr_ref = arr.borrow();
-        if let Some(elements) = arr_ref.array_elements() {
+        if let Some(elements) = arr_ref.array_storage() {
             elements.to_vec()
         } else {
             vec![]
@@ -4,115 +4,9 @@ use crate::error::JsError;
 use crate::gc::Gc;
 use crate::interpreter::Interpreter;
 use crate::platform::CompiledRegex;
-use crate::prelude::{Rc, String, ToString, Vec, format};
+use crate::prelude::{Rc, String, ToString, Vec};
 use crate::value::{ExoticObject, Guarded, JsObject, JsString, JsValue, PropertyKey};
 
-// ═══════════════════════════════════════════════════════════════════════════════
-// Backward Compatibility: build_regex for string methods
-// ═══════════════════════════════════════════════════════════════════════════════
-//
-// The string methods (match, replace, split, search, matchAll) currently use
-// fancy_regex methods directly (captures_iter, split, etc.) which aren't abstracted
-// by the CompiledRegex trait yet. For backward compatibility, we keep build_regex
-// here which directly uses fancy_regex when the feature is enabled.
-//
-// TODO: In a future iteration, update string methods to use CompiledRegex trait
-// methods so they can benefit from custom providers (like WasmRegExpProvider).
-
-#[cfg(feature = "regex")]
-mod regex_compat {
-    use super::*;
-
-    /// Convert a JavaScript regex pattern to a Rust regex pattern.
-    /// Handles differences between JS and Rust regex syntax.
-    fn js_regex_to_rust(pattern: &str) -> String {
-        let mut result = String::with_capacity(pattern.len() + 16);
-        let chars: Vec<char> = pattern.chars().collect();
-        let len = chars.len();
-        let mut i = 0;
-        let mut in_char_class = false;
-        let mut char_class_start = false;
-
-        while i < len {
-            let Some(c) = chars.get(i).copied() else {
-                break;
-            };
-
-            if c == '\\'
-                && let Some(next) = chars.get(i + 1).copied()
-            {
-                result.push(c);
-                result.push(next);
-                i += 2;
-                char_class_start = false;
-                continue;
-            }
-
-            if !in_char_class {
-                if c == '[' {
-                    in_char_class = true;
-                    char_class_start = true;
-                    result.push(c);
-                } else {
-                    result.push(c);
-                }
-            } else if char_class_start {
-                if c == '^' {
-                    result.push(c);
-                } else if c == ']' {
-                    result.push(c);
-                    char_class_start = false;
-                } else if c == '[' {
-                    result.push('\\');
-                    result.push('[');
-                    char_class_start = false;
-                } else {
-                    result.push(c);
-                    char_class_start = false;
-                }
-            } else if c == ']' {
-                in_char_class = false;
-                result.push(c);
-            } else if c == '[' {
-                result.push('\\');
-                result.push('[');
-            } else {
-                result.push(c);
-            }
-            i += 1;
-        }
-
-        result
-    }
-
-    /// Build a fancy_regex::Regex from pattern and flags.
-    /// Used by string methods that need direct access to fancy_regex features.
-    pub fn build_regex(pattern: &str, flags: &str) -> Result<fancy_regex::Regex, JsError> {
-        let mut regex_pattern = js_regex_to_rust(pattern);
-        let mut prefix = String::new();
-
-        if flags.contains('i') {
-            prefix.push('i');
-        }
-        if flags.contains('m') {
-            prefix.push('m');
-        }
-        if flags.contains('s') {
-            prefix.push('s');
-        }
-
-        if !prefix.is_empty() {
-            regex_pattern = format!("(?{}){}", prefix, regex_pattern);
-        }
-
-        fancy_regex::Regex::new(&regex_pattern)
-            .map_err(|e| JsError::syntax_error(format!("Invalid regular expression: {}", e), 0, 0))
-    }
-}
-
-#[cfg(feature = "regex")]
-pub use regex_compat::build_regex;
-
 /// Initialize RegExp.prototype with test and exec methods
 pub fn init_regexp_prototype(interp: &mut Interpreter) {
     let proto = interp.regexp_prototype.clone();
@@ -230,11 +124,15 @@ pub fn get_compiled_regexp(
         if let Some(compiled) = compiled {
             return Ok(compiled.clone());
         }
-        // Not cached - compile now
+        // Not cached - compile now and keep it on the object
         let pattern = pattern.clone();
         let flags = flags.clone();
         drop(obj_ref);
-        interp.compile_regexp(&pattern, &flags)
+        let regex = interp.compile_regexp(&pattern, &flags)?;
+        if let ExoticObject::RegExp { compiled, .. } = &mut obj.borrow_mut().exotic {
+            *compiled = Some(regex.clone());
+        }
+        Ok(regex)
     } else {
         Err(JsError::type_error("this is not a RegExp"))
     }
@@ -81,7 +81,7 @@ pub fn set_constructor(
     // If an iterable (array) is passed, add its elements
     if let Some(JsValue::Object(arr)) = args.first() {
         let arr_ref = arr.borrow();
-        if let Some(elements) = arr_ref.array_elements() {
+        if let Some(elements) = arr_ref.array_storage() {
             let items: Vec<JsValue> = elements.to_vec();
             drop(arr_ref);
 
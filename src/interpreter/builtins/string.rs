@@ -827,6 +827,25 @@ pub fn string_replace_all(
     this: JsValue,
     args: &[JsValue],
 ) -> Result<Guarded, JsError> {
+    use crate::value::ExoticObject;
+
+    // A RegExp search must be global, and then behaves like replace()
+    if let Some(JsValue::Object(obj)) = args.first() {
+        let regexp_global = match &obj.borrow().exotic {
+            ExoticObject::RegExp { flags, .. } => Some(flags.contains('g')),
+            _ => None,
+        };
+        match regexp_global {
+            Some(true) => return string_replace(interp, this, args),
+            Some(false) => {
+                return Err(JsError::type_error(
+                    "String.prototype.replaceAll called with a non-global RegExp argument",
+                ));
+            }
+            None => {}
+        }
+    }
+
     let s = interp.to_js_string(&this);
     let search = match args.first() {
         Some(v) => interp.to_js_string(v),
@@ -906,11 +925,11 @@ pub fn string_concat(
     this: JsValue,
     args: &[JsValue],
 ) -> Result<Guarded, JsError> {
-    let mut result = interp.to_js_string(&this).to_string();
+    let mut result = interp.to_js_string(&this);
     for arg in args {
-        result.push_str(interp.to_js_string(arg).as_ref());
+        result = result.concat(&interp.to_js_string(arg));
     }
-    Ok(Guarded::unguarded(JsValue::String(JsString::from(result))))
+    Ok(Guarded::unguarded(JsValue::String(result)))
 }
 
 pub fn string_char_code_at(
@@ -1154,7 +1173,6 @@ pub fn string_match_all(
     this: JsValue,
     args: &[JsValue],
 ) -> Result<Guarded, JsError> {
-    use super::regexp::build_regex;
     use crate::value::ExoticObject;
 
     let s = interp.to_js_string(&this).to_string();
@@ -1187,27 +1205,28 @@ pub fn string_match_all(
         (interp.to_js_string(&arg).to_string(), "g".to_string())
     };
 
-    let re = build_regex(&pattern, &flags)?;
+    let re = interp.compile_regexp(&pattern, &flags)?;
+    let matches = re.find_iter(&s).map_err(JsError::type_error)?;
 
     // Collect all matches with capture groups
     // Use single guard for all match arrays
     let guard = interp.heap.create_guard();
     let mut all_matches = Vec::new();
-    for caps in re.captures_iter(&s).filter_map(|r| r.ok()) {
-        let mut match_result = Vec::new();
-        for cap in caps.iter() {
-            match cap {
-                Some(m) => match_result.push(JsValue::String(JsString::from(m.as_str()))),
-                None => match_result.push(JsValue::Undefined),
-            }
-        }
+    for m in matches {
+        let match_result: Vec<JsValue> = m
+            .captures
+            .iter()
+            .map(|cap| match cap.and_then(|(start, end)| s.get(start..end)) {
+                Some(text) => JsValue::String(JsString::from(text)),
+                None => JsValue::Undefined,
+            })
+            .collect();
         let arr = interp.create_array_from(&guard, match_result);
 
         // Add index property
         let index_key = PropertyKey::String(interp.intern("index"));
-        let match_start = caps.get(0).map(|m| m.start()).unwrap_or(0);
         arr.borrow_mut()
-            .set_property(index_key, JsValue::Number(match_start as f64));
+            .set_property(index_key, JsValue::Number(m.start as f64));
 
         // Add input property
         let input_key = PropertyKey::String(interp.intern("input"));
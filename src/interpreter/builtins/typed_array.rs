@@ -0,0 +1,1233 @@
+//! ArrayBuffer, typed array and DataView built-ins
+//!
+//! An ArrayBuffer wraps a shared [`ByteStore`]; typed arrays and DataViews
+//! keep the store next to their buffer object and read and write it directly.
+//! Element access, `length`, `byteLength`, `byteOffset` and `buffer` are
+//! answered by the objects themselves (see `JsObject::get_property`), so the
+//! prototypes only carry methods.
+//!
+//! The element-wise methods that Array.prototype implements generically over
+//! array-likes (forEach, reduce, indexOf, ...) are shared with it; the ones
+//! that create or rearrange elements are typed here.
+
+use core::cmp::Ordering;
+
+use crate::error::JsError;
+use crate::gc::{Gc, Guard};
+use crate::interpreter::Interpreter;
+use crate::prelude::{Box, Rc, String, ToString, Vec, format, math, vec};
+use crate::value::{
+    ByteStore, CheapClone, ExoticObject, Guarded, JsObject, JsString, JsSymbol, JsValue, Property,
+    PropertyKey, TypedArrayData, TypedArrayKind,
+};
+
+use super::array::{
+    array_every, array_find, array_find_index, array_foreach, array_from, array_includes,
+    array_index_of, array_reduce, array_some, array_values,
+};
+
+/// Create ArrayBuffer, the typed array constructors and DataView and register
+/// them globally
+pub fn init_typed_arrays(interp: &mut Interpreter) {
+    init_array_buffer(interp);
+
+    // %TypedArray% and its prototype: the statics and methods shared by every
+    // typed array kind. Not a global; each kind's constructor and prototype
+    // inherit from them.
+    let shared_proto = interp.root_guard.alloc();
+    shared_proto.borrow_mut().prototype = Some(interp.object_prototype.clone());
+    init_typed_array_prototype(interp, &shared_proto);
+
+    let shared_constructor =
+        interp.create_native_function("TypedArray", typed_array_abstract_constructor, 0);
+    interp.register_method(&shared_constructor, "from", typed_array_from, 1);
+    interp.register_method(&shared_constructor, "of", typed_array_of, 0);
+    interp.register_species_getter(&shared_constructor);
+    let proto_key = PropertyKey::String(interp.intern("prototype"));
+    shared_constructor
+        .borrow_mut()
+        .set_property(proto_key, JsValue::Object(shared_proto.clone()));
+    let constructor_key = PropertyKey::String(interp.intern("constructor"));
+    shared_proto
+        .borrow_mut()
+        .set_property(constructor_key, JsValue::Object(shared_constructor.clone()));
+
+    for kind in TypedArrayKind::ALL {
+        init_typed_array_kind(interp, kind, &shared_constructor, &shared_proto);
+    }
+
+    init_data_view(interp);
+}
+
+/// Set `constructor.prototype`, `prototype.constructor` and register the
+/// constructor as the global `name`
+fn install_constructor(
+    interp: &mut Interpreter,
+    name: &str,
+    constructor: Gc<JsObject>,
+    proto: &Gc<JsObject>,
+) {
+    let proto_key = PropertyKey::String(interp.intern("prototype"));
+    constructor
+        .borrow_mut()
+        .set_property(proto_key, JsValue::Object(proto.clone()));
+
+    let constructor_key = PropertyKey::String(interp.intern("constructor"));
+    proto
+        .borrow_mut()
+        .set_property(constructor_key, JsValue::Object(constructor.clone()));
+
+    let global_key = PropertyKey::String(interp.intern(name));
+    interp
+        .global
+        .borrow_mut()
+        .set_property(global_key, JsValue::Object(constructor));
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// ArrayBuffer
+// ═══════════════════════════════════════════════════════════════════════════════
+
+fn init_array_buffer(interp: &mut Interpreter) {
+    let proto = interp.array_buffer_prototype.clone();
+    interp.register_method(&proto, "slice", array_buffer_slice, 2);
+
+    let constructor = interp.create_native_function("ArrayBuffer", array_buffer_constructor, 1);
+    interp.register_method(&constructor, "isView", array_buffer_is_view, 1);
+    interp.register_species_getter(&constructor);
+    install_constructor(interp, "ArrayBuffer", constructor, &proto);
+}
+
+pub fn array_buffer_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let len = to_index(interp, args.first(), "Invalid array buffer length")?;
+    let guard = interp.heap.create_guard();
+    let buffer = interp.create_array_buffer(&guard, ByteStore::zeroed(len)?);
+    Ok(Guarded::with_guard(JsValue::Object(buffer), guard))
+}
+
+/// ArrayBuffer.isView(value)
+pub fn array_buffer_is_view(
+    _interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let is_view = match args.first() {
+        Some(JsValue::Object(obj)) => matches!(
+            obj.borrow().exotic,
+            ExoticObject::TypedArray(_) | ExoticObject::DataView(_)
+        ),
+        _ => false,
+    };
+    Ok(Guarded::unguarded(JsValue::Boolean(is_view)))
+}
+
+/// ArrayBuffer.prototype.slice(begin, end) - copy of a byte range
+pub fn array_buffer_slice(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let store = match &this {
+        JsValue::Object(obj) => match &obj.borrow().exotic {
+            ExoticObject::ArrayBuffer(store) => Some(store.cheap_clone()),
+            _ => None,
+        },
+        _ => None,
+    };
+    let Some(store) = store else {
+        return Err(JsError::type_error(
+            "ArrayBuffer.prototype.slice called on incompatible receiver",
+        ));
+    };
+
+    let len = store.len();
+    let start = relative_index(interp, args.first(), len, 0)?;
+    let end = relative_index(interp, args.get(1), len, len)?.max(start);
+    let bytes = store.bytes().get(start..end).unwrap_or_default().to_vec();
+
+    let guard = interp.heap.create_guard();
+    let buffer = interp.create_array_buffer(&guard, ByteStore::new(bytes));
+    Ok(Guarded::with_guard(JsValue::Object(buffer), guard))
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Typed arrays
+// ═══════════════════════════════════════════════════════════════════════════════
+
+fn init_typed_array_prototype(interp: &mut Interpreter, proto: &Gc<JsObject>) {
+    // Shared with Array.prototype (generic over array-likes)
+    interp.register_method(proto, "forEach", array_foreach, 1);
+    interp.register_method(proto, "reduce", array_reduce, 1);
+    interp.register_method(proto, "indexOf", array_index_of, 1);
+    interp.register_method(proto, "includes", array_includes, 1);
+    interp.register_method(proto, "some", array_some, 1);
+    interp.register_method(proto, "every", array_every, 1);
+    interp.register_method(proto, "find", array_find, 1);
+    interp.register_method(proto, "findIndex", array_find_index, 1);
+    interp.register_method(proto, "values", array_values, 0);
+
+    interp.register_method(proto, "set", typed_array_set, 1);
+    interp.register_method(proto, "subarray", typed_array_subarray, 2);
+    interp.register_method(proto, "slice", typed_array_slice, 2);
+    interp.register_method(proto, "fill", typed_array_fill, 1);
+    interp.register_method(proto, "map", typed_array_map, 1);
+    interp.register_method(proto, "filter", typed_array_filter, 1);
+    interp.register_method(proto, "reverse", typed_array_reverse, 0);
+    interp.register_method(proto, "sort", typed_array_sort, 1);
+    interp.register_method(proto, "at", typed_array_at, 1);
+    interp.register_method(proto, "join", typed_array_join, 1);
+    interp.register_method(proto, "toString", typed_array_to_string, 0);
+    interp.register_method(proto, "keys", typed_array_keys, 0);
+    interp.register_method(proto, "entries", typed_array_entries, 0);
+
+    // [Symbol.iterator] is values()
+    let well_known = interp.well_known_symbols;
+    let iterator_symbol =
+        JsSymbol::new(well_known.iterator, Some(interp.intern("Symbol.iterator")));
+    let iterator_key = PropertyKey::Symbol(Box::new(iterator_symbol));
+    let values_fn = interp.create_native_function("[Symbol.iterator]", array_values, 0);
+    proto
+        .borrow_mut()
+        .set_property(iterator_key, JsValue::Object(values_fn));
+}
+
+fn init_typed_array_kind(
+    interp: &mut Interpreter,
+    kind: TypedArrayKind,
+    shared_constructor: &Gc<JsObject>,
+    shared_proto: &Gc<JsObject>,
+) {
+    let Some(proto) = interp.typed_array_prototypes.get(kind.index()).cloned() else {
+        return;
+    };
+    proto.borrow_mut().prototype = Some(shared_proto.clone());
+
+    let constructor_fn = match kind {
+        TypedArrayKind::Int8 => int8_array_constructor,
+        TypedArrayKind::Uint8 => uint8_array_constructor,
+        TypedArrayKind::Uint8Clamped => uint8_clamped_array_constructor,
+        TypedArrayKind::Int16 => int16_array_constructor,
+        TypedArrayKind::Uint16 => uint16_array_constructor,
+        TypedArrayKind::Int32 => int32_array_constructor,
+        TypedArrayKind::Uint32 => uint32_array_constructor,
+        TypedArrayKind::Float32 => float32_array_constructor,
+        TypedArrayKind::Float64 => float64_array_constructor,
+    };
+    let constructor = interp.create_native_function(kind.name(), constructor_fn, 3);
+    // from, of and [Symbol.species] are inherited from %TypedArray%
+    constructor.borrow_mut().prototype = Some(shared_constructor.clone());
+
+    // BYTES_PER_ELEMENT: non-writable, non-enumerable, non-configurable
+    let bytes_per_element = JsValue::Number(kind.element_size() as f64);
+    for obj in [&constructor, &proto] {
+        let key = PropertyKey::String(interp.intern("BYTES_PER_ELEMENT"));
+        let prop = Property::with_attributes(bytes_per_element.clone(), false, false, false);
+        obj.borrow_mut().define_property(key, prop);
+    }
+
+    install_constructor(interp, kind.name(), constructor, &proto);
+}
+
+/// %TypedArray% itself, which only exists to be inherited from
+pub fn typed_array_abstract_constructor(
+    _interp: &mut Interpreter,
+    _this: JsValue,
+    _args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    Err(JsError::type_error(
+        "Abstract class TypedArray not directly constructable",
+    ))
+}
+
+pub fn int8_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Int8, args)
+}
+
+pub fn uint8_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Uint8, args)
+}
+
+pub fn uint8_clamped_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Uint8Clamped, args)
+}
+
+pub fn int16_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Int16, args)
+}
+
+pub fn uint16_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Uint16, args)
+}
+
+pub fn int32_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Int32, args)
+}
+
+pub fn uint32_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Uint32, args)
+}
+
+pub fn float32_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Float32, args)
+}
+
+pub fn float64_array_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    construct_typed_array(interp, TypedArrayKind::Float64, args)
+}
+
+/// `new XArray(length)`, `new XArray(arrayLike | iterable | typedArray)` or
+/// `new XArray(buffer, byteOffset?, length?)`
+fn construct_typed_array(
+    interp: &mut Interpreter,
+    kind: TypedArrayKind,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let guard = interp.heap.create_guard();
+    let source = match args.first() {
+        Some(JsValue::Object(obj)) => obj.cheap_clone(),
+        first => {
+            let length = to_index(interp, first, "Invalid typed array length")?;
+            let array = interp.create_typed_array_zeroed(&guard, kind, length)?;
+            return Ok(Guarded::with_guard(JsValue::Object(array), guard));
+        }
+    };
+
+    let buffer_store = match &source.borrow().exotic {
+        ExoticObject::ArrayBuffer(store) => Some(store.cheap_clone()),
+        _ => None,
+    };
+    let Some(store) = buffer_store else {
+        let values = collect_numbers(interp, &source)?;
+        let array = typed_array_from_values(interp, &guard, kind, &values)?;
+        return Ok(Guarded::with_guard(JsValue::Object(array), guard));
+    };
+
+    // View onto an existing buffer
+    let size = kind.element_size();
+    let byte_offset = to_index(interp, args.get(1), "Invalid typed array offset")?;
+    if byte_offset % size != 0 {
+        return Err(JsError::range_error(format!(
+            "start offset of {} should be a multiple of {}",
+            kind.name(),
+            size
+        )));
+    }
+    let length = match args.get(2) {
+        None | Some(JsValue::Undefined) => {
+            let available = store.len().checked_sub(byte_offset).ok_or_else(|| {
+                JsError::range_error(format!(
+                    "Start offset {} is outside the bounds of the buffer",
+                    byte_offset
+                ))
+            })?;
+            if available % size != 0 {
+                return Err(JsError::range_error(format!(
+                    "byte length of {} should be a multiple of {}",
+                    kind.name(),
+                    size
+                )));
+            }
+            available / size
+        }
+        length => {
+            let length = to_index(interp, length, "Invalid typed array length")?;
+            let fits = length
+                .checked_mul(size)
+                .and_then(|bytes| bytes.checked_add(byte_offset))
+                .is_some_and(|end| end <= store.len());
+            if !fits {
+                return Err(JsError::range_error(format!(
+                    "Invalid typed array length: {}",
+                    length
+                )));
+            }
+            length
+        }
+    };
+
+    let array = interp.create_typed_array(&guard, kind, source, store, byte_offset, length);
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// New typed array of `kind` holding `values`
+fn typed_array_from_values(
+    interp: &mut Interpreter,
+    guard: &Guard<JsObject>,
+    kind: TypedArrayKind,
+    values: &[f64],
+) -> Result<Gc<JsObject>, JsError> {
+    let array = interp.create_typed_array_zeroed(guard, kind, values.len())?;
+    if let Some(data) = array.borrow().typed_array() {
+        for (i, &value) in values.iter().enumerate() {
+            data.set(i, value);
+        }
+    }
+    Ok(array)
+}
+
+/// The elements of a typed array, array, iterable or array-like, as numbers
+fn collect_numbers(interp: &mut Interpreter, source: &Gc<JsObject>) -> Result<Vec<f64>, JsError> {
+    let elements: Vec<JsValue> = {
+        let source_ref = source.borrow();
+        if let Some(data) = source_ref.typed_array() {
+            return Ok((0..data.length).filter_map(|i| data.get(i)).collect());
+        }
+        match source_ref.array_storage() {
+            Some(elements) => elements.to_vec(),
+            None => Vec::new(),
+        }
+    };
+    let elements = if source.borrow().is_array() {
+        elements
+    } else {
+        let well_known = interp.well_known_symbols;
+        let iterator_key = PropertyKey::Symbol(Box::new(JsSymbol::new(
+            well_known.iterator,
+            Some(interp.intern("Symbol.iterator")),
+        )));
+        let has_iterator = source.borrow().get_property(&iterator_key).is_some();
+        if has_iterator {
+            let Guarded {
+                value: array,
+                guard: _array_guard,
+            } = array_from(
+                interp,
+                JsValue::Undefined,
+                &[JsValue::Object(source.clone())],
+            )?;
+            match array {
+                JsValue::Object(array) => array
+                    .borrow()
+                    .array_storage()
+                    .map(|e| e.to_vec())
+                    .unwrap_or_default(),
+                _ => Vec::new(),
+            }
+        } else {
+            // Array-like: length and indexed properties
+            let length_key = interp.property_key("length");
+            let length = source.borrow().get_property(&length_key);
+            let length = match length {
+                Some(value) => interp.coerce_to_number(&value)?,
+                None => 0.0,
+            };
+            let length = if length.is_nan() || length < 0.0 {
+                0
+            } else {
+                math::trunc(length.min(u32::MAX as f64)) as u32
+            };
+            let source_ref = source.borrow();
+            (0..length)
+                .map(|i| {
+                    source_ref
+                        .get_property(&PropertyKey::Index(i))
+                        .unwrap_or(JsValue::Undefined)
+                })
+                .collect()
+        }
+    };
+
+    let mut numbers = Vec::with_capacity(elements.len());
+    for element in &elements {
+        numbers.push(interp.coerce_to_number(element)?);
+    }
+    Ok(numbers)
+}
+
+/// The kind constructed by `constructor` (the `this` of `from`/`of`)
+fn constructor_kind(interp: &mut Interpreter, constructor: &JsValue) -> Option<TypedArrayKind> {
+    let JsValue::Object(constructor) = constructor else {
+        return None;
+    };
+    let proto_key = interp.property_key("prototype");
+    let Some(JsValue::Object(proto)) = constructor.borrow().get_property(&proto_key) else {
+        return None;
+    };
+    TypedArrayKind::ALL.into_iter().find(|kind| {
+        interp
+            .typed_array_prototypes
+            .get(kind.index())
+            .is_some_and(|p| p.id() == proto.id())
+    })
+}
+
+/// XArray.from(source, mapFn?)
+pub fn typed_array_from(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let Some(kind) = constructor_kind(interp, &this) else {
+        return Err(JsError::type_error(
+            "TypedArray.from: this is not a typed array constructor",
+        ));
+    };
+    let guard = interp.heap.create_guard();
+    let values = match args.first() {
+        Some(JsValue::Object(source)) if args.get(1).is_none() => collect_numbers(interp, source)?,
+        _ => {
+            // Map through Array.from, then store the results
+            let Guarded {
+                value: mapped,
+                guard: _mapped_guard,
+            } = array_from(interp, JsValue::Undefined, args)?;
+            match mapped {
+                JsValue::Object(mapped) => collect_numbers(interp, &mapped)?,
+                _ => Vec::new(),
+            }
+        }
+    };
+    let array = typed_array_from_values(interp, &guard, kind, &values)?;
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// XArray.of(...items)
+pub fn typed_array_of(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let Some(kind) = constructor_kind(interp, &this) else {
+        return Err(JsError::type_error(
+            "TypedArray.of: this is not a typed array constructor",
+        ));
+    };
+    let mut values = Vec::with_capacity(args.len());
+    for arg in args {
+        values.push(interp.coerce_to_number(arg)?);
+    }
+    let guard = interp.heap.create_guard();
+    let array = typed_array_from_values(interp, &guard, kind, &values)?;
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// The receiver's typed array state, or a TypeError naming `method`
+fn this_typed_array(
+    this: &JsValue,
+    method: &str,
+) -> Result<(Gc<JsObject>, TypedArrayData), JsError> {
+    if let JsValue::Object(obj) = this
+        && let Some(data) = obj.borrow().typed_array()
+    {
+        return Ok((obj.cheap_clone(), data.clone()));
+    }
+    Err(JsError::type_error(format!(
+        "%TypedArray%.prototype.{} called on incompatible receiver",
+        method
+    )))
+}
+
+/// The receiver's elements as numbers
+fn typed_values(data: &TypedArrayData) -> Vec<f64> {
+    (0..data.length).filter_map(|i| data.get(i)).collect()
+}
+
+/// Write `values` into `data` from index 0
+fn store_values(data: &TypedArrayData, values: &[f64]) {
+    for (i, &value) in values.iter().enumerate() {
+        data.set(i, value);
+    }
+}
+
+/// %TypedArray%.prototype.set(source, offset?)
+pub fn typed_array_set(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "set")?;
+    let offset = to_index(interp, args.get(1), "offset is out of bounds")?;
+    let values = match args.first() {
+        Some(JsValue::Object(source)) => collect_numbers(interp, source)?,
+        _ => {
+            return Err(JsError::type_error(
+                "%TypedArray%.prototype.set source must be an object",
+            ));
+        }
+    };
+    if values.len().saturating_add(offset) > data.length {
+        return Err(JsError::range_error("offset is out of bounds"));
+    }
+    for (i, &value) in values.iter().enumerate() {
+        data.set(offset + i, value);
+    }
+    Ok(Guarded::unguarded(JsValue::Undefined))
+}
+
+/// %TypedArray%.prototype.subarray(begin?, end?) - a view on the same buffer
+pub fn typed_array_subarray(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "subarray")?;
+    let start = relative_index(interp, args.first(), data.length, 0)?;
+    let end = relative_index(interp, args.get(1), data.length, data.length)?.max(start);
+    let guard = interp.heap.create_guard();
+    let array = interp.create_typed_array(
+        &guard,
+        data.kind,
+        data.buffer.cheap_clone(),
+        data.store.cheap_clone(),
+        data.byte_offset + start * data.kind.element_size(),
+        end - start,
+    );
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// %TypedArray%.prototype.slice(begin?, end?) - a copy in a new buffer
+pub fn typed_array_slice(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "slice")?;
+    let start = relative_index(interp, args.first(), data.length, 0)?;
+    let end = relative_index(interp, args.get(1), data.length, data.length)?.max(start);
+    let size = data.kind.element_size();
+    let from = data.byte_offset + start * size;
+    let bytes = data
+        .store
+        .bytes()
+        .get(from..from + (end - start) * size)
+        .unwrap_or_default()
+        .to_vec();
+
+    let guard = interp.heap.create_guard();
+    let store = ByteStore::new(bytes);
+    let buffer = interp.create_array_buffer(&guard, store.cheap_clone());
+    let array = interp.create_typed_array(&guard, data.kind, buffer, store, 0, end - start);
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// %TypedArray%.prototype.fill(value, start?, end?)
+pub fn typed_array_fill(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "fill")?;
+    let value = match args.first() {
+        Some(value) => interp.coerce_to_number(value)?,
+        None => f64::NAN,
+    };
+    let start = relative_index(interp, args.get(1), data.length, 0)?;
+    let end = relative_index(interp, args.get(2), data.length, data.length)?;
+    for i in start..end {
+        data.set(i, value);
+    }
+    Ok(Guarded::unguarded(this))
+}
+
+/// Call `callback(element, index, array)` for each element and collect the
+/// results
+fn map_elements(
+    interp: &mut Interpreter,
+    this: &JsValue,
+    args: &[JsValue],
+    method: &str,
+) -> Result<(TypedArrayData, Vec<f64>, Vec<JsValue>), JsError> {
+    let (_, data) = this_typed_array(this, method)?;
+    let callback = args.first().cloned().unwrap_or(JsValue::Undefined);
+    if !callback.is_callable() {
+        return Err(JsError::type_error(format!(
+            "%TypedArray%.prototype.{} callback is not a function",
+            method
+        )));
+    }
+    let this_arg = args.get(1).cloned().unwrap_or(JsValue::Undefined);
+    let _callback_guard = interp.guard_value(&callback);
+    let _this_arg_guard = interp.guard_value(&this_arg);
+    let _this_guard = interp.guard_value(this);
+
+    let values = typed_values(&data);
+    let mut results = Vec::with_capacity(values.len());
+    for (i, &value) in values.iter().enumerate() {
+        let Guarded {
+            value: result,
+            guard: _result_guard,
+        } = interp.call_function(
+            callback.clone(),
+            this_arg.clone(),
+            &[
+                JsValue::Number(value),
+                JsValue::Number(i as f64),
+                this.clone(),
+            ],
+        )?;
+        results.push(result);
+    }
+    Ok((data, values, results))
+}
+
+/// %TypedArray%.prototype.map(callback, thisArg?) - same kind as the receiver
+pub fn typed_array_map(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (data, _, results) = map_elements(interp, &this, args, "map")?;
+    let mut values = Vec::with_capacity(results.len());
+    for result in &results {
+        values.push(interp.coerce_to_number(result)?);
+    }
+    let guard = interp.heap.create_guard();
+    let array = typed_array_from_values(interp, &guard, data.kind, &values)?;
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// %TypedArray%.prototype.filter(callback, thisArg?)
+pub fn typed_array_filter(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (data, values, results) = map_elements(interp, &this, args, "filter")?;
+    let kept: Vec<f64> = values
+        .into_iter()
+        .zip(&results)
+        .filter(|(_, keep)| keep.to_boolean())
+        .map(|(value, _)| value)
+        .collect();
+    let guard = interp.heap.create_guard();
+    let array = typed_array_from_values(interp, &guard, data.kind, &kept)?;
+    Ok(Guarded::with_guard(JsValue::Object(array), guard))
+}
+
+/// %TypedArray%.prototype.reverse() - in place
+pub fn typed_array_reverse(
+    _interp: &mut Interpreter,
+    this: JsValue,
+    _args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "reverse")?;
+    let mut values = typed_values(&data);
+    values.reverse();
+    store_values(&data, &values);
+    Ok(Guarded::unguarded(this))
+}
+
+/// %TypedArray%.prototype.sort(compareFn?) - in place, numerically by default
+pub fn typed_array_sort(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "sort")?;
+    let mut values = typed_values(&data);
+
+    match args.first() {
+        Some(compare) if compare.is_callable() => {
+            let _compare_guard = interp.guard_value(compare);
+            // sort_by cannot fail, so the first error stops further calls
+            let mut error = None;
+            values.sort_by(|&a, &b| {
+                if error.is_some() {
+                    return Ordering::Equal;
+                }
+                let result = interp
+                    .call_function(
+                        compare.clone(),
+                        JsValue::Undefined,
+                        &[JsValue::Number(a), JsValue::Number(b)],
+                    )
+                    .and_then(|result| interp.coerce_to_number(&result.value));
+                match result {
+                    Ok(n) if n < 0.0 => Ordering::Less,
+                    Ok(n) if n > 0.0 => Ordering::Greater,
+                    Ok(_) => Ordering::Equal,
+                    Err(e) => {
+                        error = Some(e);
+                        Ordering::Equal
+                    }
+                }
+            });
+            if let Some(e) = error {
+                return Err(e);
+            }
+        }
+        Some(JsValue::Undefined) | None => {
+            // Numeric order with -0 before +0 and NaN last
+            values.sort_by(|a, b| match (a.is_nan(), b.is_nan()) {
+                (true, true) => Ordering::Equal,
+                (true, false) => Ordering::Greater,
+                (false, true) => Ordering::Less,
+                (false, false) => a.total_cmp(b),
+            });
+        }
+        Some(_) => {
+            return Err(JsError::type_error(
+                "The comparison function must be either a function or undefined",
+            ));
+        }
+    }
+
+    store_values(&data, &values);
+    Ok(Guarded::unguarded(this))
+}
+
+/// %TypedArray%.prototype.at(index)
+pub fn typed_array_at(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "at")?;
+    let index = match args.first() {
+        Some(value) => interp.coerce_to_number(value)?,
+        None => 0.0,
+    };
+    let index = if index.is_nan() {
+        0.0
+    } else {
+        math::trunc(index)
+    };
+    let index = if index < 0.0 {
+        index + data.length as f64
+    } else {
+        index
+    };
+    let value = if index < 0.0 {
+        None
+    } else {
+        data.get(index as usize)
+    };
+    Ok(Guarded::unguarded(
+        value.map_or(JsValue::Undefined, JsValue::Number),
+    ))
+}
+
+/// %TypedArray%.prototype.join(separator?)
+pub fn typed_array_join(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "join")?;
+    let separator = match args.first() {
+        None | Some(JsValue::Undefined) => String::from(","),
+        Some(separator) => interp.to_js_string(separator).to_string(),
+    };
+    let parts: Vec<String> = typed_values(&data)
+        .into_iter()
+        .map(|n| interp.to_js_string(&JsValue::Number(n)).to_string())
+        .collect();
+    Ok(Guarded::unguarded(JsValue::String(JsString::from(
+        parts.join(&separator),
+    ))))
+}
+
+/// %TypedArray%.prototype.toString()
+pub fn typed_array_to_string(
+    interp: &mut Interpreter,
+    this: JsValue,
+    _args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    typed_array_join(interp, this, &[])
+}
+
+/// %TypedArray%.prototype.keys() - an array of the indices
+pub fn typed_array_keys(
+    interp: &mut Interpreter,
+    this: JsValue,
+    _args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "keys")?;
+    let keys: Vec<JsValue> = (0..data.length)
+        .map(|i| JsValue::Number(i as f64))
+        .collect();
+    let guard = interp.heap.create_guard();
+    let arr = interp.create_array_from(&guard, keys);
+    Ok(Guarded::with_guard(JsValue::Object(arr), guard))
+}
+
+/// %TypedArray%.prototype.entries() - an array of `[index, value]` pairs
+pub fn typed_array_entries(
+    interp: &mut Interpreter,
+    this: JsValue,
+    _args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let (_, data) = this_typed_array(&this, "entries")?;
+    let guard = interp.heap.create_guard();
+    let mut entries = Vec::with_capacity(data.length);
+    for (i, value) in typed_values(&data).into_iter().enumerate() {
+        let pair = vec![JsValue::Number(i as f64), JsValue::Number(value)];
+        let entry = interp.create_array_from(&guard, pair);
+        entries.push(JsValue::Object(entry));
+    }
+    let result = interp.create_array_from(&guard, entries);
+    Ok(Guarded::with_guard(JsValue::Object(result), guard))
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// DataView
+// ═══════════════════════════════════════════════════════════════════════════════
+
+fn init_data_view(interp: &mut Interpreter) {
+    let proto = interp.data_view_prototype.clone();
+    interp.register_method(&proto, "getInt8", data_view_get_int8, 1);
+    interp.register_method(&proto, "getUint8", data_view_get_uint8, 1);
+    interp.register_method(&proto, "getInt16", data_view_get_int16, 1);
+    interp.register_method(&proto, "getUint16", data_view_get_uint16, 1);
+    interp.register_method(&proto, "getInt32", data_view_get_int32, 1);
+    interp.register_method(&proto, "getUint32", data_view_get_uint32, 1);
+    interp.register_method(&proto, "getFloat32", data_view_get_float32, 1);
+    interp.register_method(&proto, "getFloat64", data_view_get_float64, 1);
+    interp.register_method(&proto, "setInt8", data_view_set_int8, 2);
+    interp.register_method(&proto, "setUint8", data_view_set_uint8, 2);
+    interp.register_method(&proto, "setInt16", data_view_set_int16, 2);
+    interp.register_method(&proto, "setUint16", data_view_set_uint16, 2);
+    interp.register_method(&proto, "setInt32", data_view_set_int32, 2);
+    interp.register_method(&proto, "setUint32", data_view_set_uint32, 2);
+    interp.register_method(&proto, "setFloat32", data_view_set_float32, 2);
+    interp.register_method(&proto, "setFloat64", data_view_set_float64, 2);
+
+    let constructor = interp.create_native_function("DataView", data_view_constructor, 1);
+    install_constructor(interp, "DataView", constructor, &proto);
+}
+
+/// `new DataView(buffer, byteOffset?, byteLength?)`
+pub fn data_view_constructor(
+    interp: &mut Interpreter,
+    _this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    let buffer_and_store = match args.first() {
+        Some(JsValue::Object(obj)) => match &obj.borrow().exotic {
+            ExoticObject::ArrayBuffer(store) => Some((obj.cheap_clone(), store.cheap_clone())),
+            _ => None,
+        },
+        _ => None,
+    };
+    let Some((buffer, store)) = buffer_and_store else {
+        return Err(JsError::type_error(
+            "First argument to DataView constructor must be an ArrayBuffer",
+        ));
+    };
+
+    let byte_offset = to_index(
+        interp,
+        args.get(1),
+        "Start offset is outside the bounds of the buffer",
+    )?;
+    if byte_offset > store.len() {
+        return Err(JsError::range_error(format!(
+            "Start offset {} is outside the bounds of the buffer",
+            byte_offset
+        )));
+    }
+    let byte_length = match args.get(2) {
+        None | Some(JsValue::Undefined) => store.len() - byte_offset,
+        length => {
+            let length = to_index(interp, length, "Invalid DataView length")?;
+            if length > store.len() - byte_offset {
+                return Err(JsError::range_error(format!(
+                    "Invalid DataView length {}",
+                    length
+                )));
+            }
+            length
+        }
+    };
+
+    let guard = interp.heap.create_guard();
+    let view = interp.create_data_view(&guard, buffer, store, byte_offset, byte_length);
+    Ok(Guarded::with_guard(JsValue::Object(view), guard))
+}
+
+/// The receiver DataView's store and the absolute start of the `size` bytes at
+/// byteOffset `args[0]`, or a RangeError if they do not fit in the view
+fn data_view_range(
+    interp: &mut Interpreter,
+    this: &JsValue,
+    args: &[JsValue],
+    size: usize,
+) -> Result<(Rc<ByteStore>, usize), JsError> {
+    let view = match this {
+        JsValue::Object(obj) => match &obj.borrow().exotic {
+            ExoticObject::DataView(data) => Some(data.clone()),
+            _ => None,
+        },
+        _ => None,
+    };
+    let Some(view) = view else {
+        return Err(JsError::type_error(
+            "DataView method called on incompatible receiver",
+        ));
+    };
+    let offset = to_index(
+        interp,
+        args.first(),
+        "Offset is outside the bounds of the DataView",
+    )?;
+    if offset.saturating_add(size) > view.byte_length {
+        return Err(JsError::range_error(
+            "Offset is outside the bounds of the DataView",
+        ));
+    }
+    Ok((view.store, view.byte_offset + offset))
+}
+
+/// Reorder `bytes` between native order and the requested endianness
+fn to_requested_order(bytes: &mut [u8], little_endian: bool) {
+    if little_endian != cfg!(target_endian = "little") {
+        bytes.reverse();
+    }
+}
+
+/// DataView get: read `kind` at byteOffset `args[0]`, little-endian if `args[1]`
+fn data_view_get(
+    interp: &mut Interpreter,
+    this: &JsValue,
+    args: &[JsValue],
+    kind: TypedArrayKind,
+) -> Result<Guarded, JsError> {
+    let size = kind.element_size();
+    let (store, start) = data_view_range(interp, this, args, size)?;
+    let little_endian = args.get(1).is_some_and(JsValue::to_boolean);
+    let mut raw = store
+        .bytes()
+        .get(start..start + size)
+        .unwrap_or_default()
+        .to_vec();
+    to_requested_order(&mut raw, little_endian);
+    let value = kind.decode(&raw).unwrap_or(f64::NAN);
+    Ok(Guarded::unguarded(JsValue::Number(value)))
+}
+
+/// DataView set: write `args[1]` as `kind` at byteOffset `args[0]`,
+/// little-endian if `args[2]`
+fn data_view_set(
+    interp: &mut Interpreter,
+    this: &JsValue,
+    args: &[JsValue],
+    kind: TypedArrayKind,
+) -> Result<Guarded, JsError> {
+    let size = kind.element_size();
+    let value = match args.get(1) {
+        Some(value) => interp.coerce_to_number(value)?,
+        None => f64::NAN,
+    };
+    let (store, start) = data_view_range(interp, this, args, size)?;
+    let little_endian = args.get(2).is_some_and(JsValue::to_boolean);
+    let mut raw = kind.encode(value);
+    let raw = raw.get_mut(..size).unwrap_or_default();
+    to_requested_order(raw, little_endian);
+    if let Some(target) = store.bytes_mut().get_mut(start..start + size) {
+        target.copy_from_slice(raw);
+    }
+    Ok(Guarded::unguarded(JsValue::Undefined))
+}
+
+pub fn data_view_get_int8(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Int8)
+}
+
+pub fn data_view_get_uint8(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Uint8)
+}
+
+pub fn data_view_get_int16(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Int16)
+}
+
+pub fn data_view_get_uint16(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Uint16)
+}
+
+pub fn data_view_get_int32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Int32)
+}
+
+pub fn data_view_get_uint32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Uint32)
+}
+
+pub fn data_view_get_float32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Float32)
+}
+
+pub fn data_view_get_float64(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_get(interp, &this, args, TypedArrayKind::Float64)
+}
+
+pub fn data_view_set_int8(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Int8)
+}
+
+pub fn data_view_set_uint8(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Uint8)
+}
+
+pub fn data_view_set_int16(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Int16)
+}
+
+pub fn data_view_set_uint16(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Uint16)
+}
+
+pub fn data_view_set_int32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Int32)
+}
+
+pub fn data_view_set_uint32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Uint32)
+}
+
+pub fn data_view_set_float32(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Float32)
+}
+
+pub fn data_view_set_float64(
+    interp: &mut Interpreter,
+    this: JsValue,
+    args: &[JsValue],
+) -> Result<Guarded, JsError> {
+    data_view_set(interp, &this, args, TypedArrayKind::Float64)
+}
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Argument conversion
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// ToIndex: a non-negative integer length or offset (missing and undefined
+/// are 0), or a RangeError with `message`
+fn to_index(
+    interp: &mut Interpreter,
+    value: Option<&JsValue>,
+    message: &str,
+) -> Result<usize, JsError> {
+    let n = match value {
+        None | Some(JsValue::Undefined) => return Ok(0),
+        Some(value) => interp.coerce_to_number(value)?,
+    };
+    let n = if n.is_nan() { 0.0 } else { math::trunc(n) };
+    // Cap far above any buffer that can actually be allocated
+    if !(0.0..=(u32::MAX as f64)).contains(&n) {
+        return Err(JsError::range_error(message));
+    }
+    Ok(n as usize)
+}
+
+/// Relative start/end argument clamped to `0..=len`; negative values count
+/// from the end and a missing or undefined argument is `default`
+fn relative_index(
+    interp: &mut Interpreter,
+    value: Option<&JsValue>,
+    len: usize,
+    default: usize,
+) -> Result<usize, JsError> {
+    let n = match value {
+        None | Some(JsValue::Undefined) => return Ok(default),
+        Some(value) => interp.coerce_to_number(value)?,
+    };
+    let n = if n.is_nan() { 0.0 } else { math::trunc(n) };
+    let len_f = len as f64;
+    let index = if n < 0.0 {
+        (len_f + n).max(0.0)
+    } else {
+        n.min(len_f)
+    };
+    Ok(index as usize)
+}
@@ -0,0 +1,562 @@
+//! Compact binary serialization of value graphs.
+//!
+//! `encode_value` writes a value and everything reachable from it into one
+//! byte buffer, and `decode_value` rebuilds it in an interpreter. Hosts that
+//! pay per boundary crossing (WASM runtimes in particular) can move a whole
+//! payload in one call instead of one call per property.
+//!
+//! Layout: a version byte, then one value. Each value is a tag byte followed
+//! by its payload; lengths, counts and indices are LEB128 varints.
+//!
+//! | Tag | Value      | Payload                                         |
+//! |-----|------------|-------------------------------------------------|
+//! | 0   | undefined  |                                                 |
+//! | 1   | null       |                                                 |
+//! | 2   | false      |                                                 |
+//! | 3   | true       |                                                 |
+//! | 4   | integer    | zigzag varint (integral numbers within ±2^53)   |
+//! | 5   | float      | f64, little-endian                              |
+//! | 6   | string     | byte length, UTF-8 bytes                        |
+//! | 7   | string ref | index of an earlier string (tag 6) in the input |
+//! | 8   | array      | length, elements                                |
+//! | 9   | object     | count, then count × (key string or ref, value)  |
+//! | 10  | bytes      | byte length, bytes (decodes as a `Uint8Array`)  |
+//! | 11  | object ref | index of an earlier array, object or bytes      |
+//!
+//! Repeated strings (such as the keys of an array of records) are written
+//! once. Object references preserve shared sub-objects and cycles.
+//!
+//! Objects contribute their own enumerable string-keyed properties in
+//! insertion order. Functions and symbols encode as undefined and are left
+//! out of objects. ArrayBuffers, typed arrays and DataViews encode the bytes
+//! they view. Other special objects (dates, boxed primitives, maps) encode
+//! as their `js_value_to_json` form.
+
+use crate::error::JsError;
+use crate::gc::{Gc, Guard};
+use crate::interpreter::Interpreter;
+use crate::prelude::{FxHashMap, ToString, Vec, format, math, vec};
+use crate::value::{
+    ArrayElements, ByteStore, CheapClone, ExoticObject, Guarded, JsObject, JsString, JsValue,
+    PropertyKey, TypedArrayKind,
+};
+
+use super::json::js_value_to_json;
+
+/// First byte of every encoded buffer
+pub const VALUE_CODEC_VERSION: u8 = 1;
+
+const TAG_UNDEFINED: u8 = 0;
+const TAG_NULL: u8 = 1;
+const TAG_FALSE: u8 = 2;
+const TAG_TRUE: u8 = 3;
+const TAG_INT: u8 = 4;
+const TAG_FLOAT: u8 = 5;
+const TAG_STRING: u8 = 6;
+const TAG_STRING_REF: u8 = 7;
+const TAG_ARRAY: u8 = 8;
+const TAG_OBJECT: u8 = 9;
+const TAG_BYTES: u8 = 10;
+const TAG_OBJECT_REF: u8 = 11;
+
+/// Largest integer written with `TAG_INT` (2^53, the exact-integer limit of f64)
+const MAX_INT: f64 = 9_007_199_254_740_992.0;
+
+/// Serialize `value` and everything reachable from it.
+pub fn encode_value(value: &JsValue) -> Result<Vec<u8>, JsError> {
+    let mut encoder = Encoder {
+        out: Vec::with_capacity(64),
+        strings: FxHashMap::default(),
+        objects: FxHashMap::default(),
+        containers: 0,
+    };
+    encoder.out.push(VALUE_CODEC_VERSION);
+    encoder.write_value(value)?;
+    Ok(encoder.out)
+}
+
+/// Rebuild a value from `encode_value` output.
+pub fn decode_value(interp: &mut Interpreter, bytes: &[u8]) -> Result<Guarded, JsError> {
+    let guard = interp.heap.create_guard();
+    let mut decoder = Decoder {
+        bytes,
+        pos: 0,
+        strings: Vec::new(),
+        objects: Vec::new(),
+    };
+    let version = decoder.read_byte()?;
+    if version != VALUE_CODEC_VERSION {
+        return Err(JsError::type_error(format!(
+            "Unsupported value buffer version {}",
+            version
+        )));
+    }
+    let value = decoder.read_value(interp, &guard)?;
+    if decoder.pos != bytes.len() {
+        return Err(decoder.error("trailing bytes"));
+    }
+    Ok(Guarded::with_guard(value, guard))
+}
+
+struct Encoder {
+    out: Vec<u8>,
+    /// Index of each string written so far
+    strings: FxHashMap<JsString, u64>,
+    /// Index of each object written so far, by object id
+    objects: FxHashMap<usize, u64>,
+    /// Containers written so far, including converted JSON trees
+    containers: u64,
+}
+
+impl Encoder {
+    fn write_varint(&mut self, mut n: u64) {
+        while n >= 0x80 {
+            self.out.push((n as u8) | 0x80);
+            n >>= 7;
+        }
+        self.out.push(n as u8);
+    }
+
+    fn write_len(&mut self, tag: u8, len: usize) {
+        self.out.push(tag);
+        self.write_varint(len as u64);
+    }
+
+    fn write_number(&mut self, n: f64) {
+        let integral = math::fract(n) == 0.0 && n.abs() <= MAX_INT;
+        if integral && !(n == 0.0 && n.is_sign_negative()) {
+            let i = n as i64;
+            self.out.push(TAG_INT);
+            self.write_varint(((i << 1) ^ (i >> 63)) as u64);
+        } else {
+            self.out.push(TAG_FLOAT);
+            self.out.extend_from_slice(&n.to_le_bytes());
+        }
+    }
+
+    fn write_string(&mut self, s: &JsString) {
+        if let Some(&index) = self.strings.get(s) {
+            self.out.push(TAG_STRING_REF);
+            self.write_varint(index);
+            return;
+        }
+        let index = self.strings.len() as u64;
+        self.strings.insert(s.cheap_clone(), index);
+        self.write_len(TAG_STRING, s.len());
+        self.out.extend_from_slice(s.as_str().as_bytes());
+    }
+
+    /// Give the next container index to `id`, or to a converted tree (`None`)
+    fn register(&mut self, id: Option<usize>) {
+        if let Some(id) = id {
+            self.objects.insert(id, self.containers);
+        }
+        self.containers += 1;
+    }
+
+    /// Write `value` and everything below it. Pending items are kept on an
+    /// explicit stack, so nesting depth is bounded only by memory.
+    fn write_value(&mut self, value: &JsValue) -> Result<(), JsError> {
+        let mut pending = vec![Pending::Value(value.clone())];
+        while let Some(item) = pending.pop() {
+            match item {
+                Pending::Value(value) => self.write_one(&value, &mut pending)?,
+                Pending::Key(key) => self.write_string(&key),
+                Pending::Json(json) => self.write_json(json, &mut pending),
+            }
+        }
+        Ok(())
+    }
+
+    fn write_one(&mut self, value: &JsValue, pending: &mut Vec<Pending>) -> Result<(), JsError> {
+        match value {
+            JsValue::Undefined | JsValue::Symbol(_) => self.out.push(TAG_UNDEFINED),
+            JsValue::Null => self.out.push(TAG_NULL),
+            JsValue::Boolean(false) => self.out.push(TAG_FALSE),
+            JsValue::Boolean(true) => self.out.push(TAG_TRUE),
+            JsValue::Number(n) => self.write_number(*n),
+            JsValue::String(s) => self.write_string(s),
+            JsValue::Object(obj) => return self.write_object(obj, value, pending),
+        }
+        Ok(())
+    }
+
+    /// Write an object's header and queue its contents
+    fn write_object(
+        &mut self,
+        obj: &Gc<JsObject>,
+        value: &JsValue,
+        pending: &mut Vec<Pending>,
+    ) -> Result<(), JsError> {
+        if let Some(&index) = self.objects.get(&obj.id()) {
+            self.out.push(TAG_OBJECT_REF);
+            self.write_varint(index);
+            return Ok(());
+        }
+
+        let obj_ref = obj.borrow();
+        if obj_ref.is_callable() {
+            self.out.push(TAG_UNDEFINED);
+            return Ok(());
+        }
+        if let Some(elements) = obj_ref.array_storage() {
+            self.register(Some(obj.id()));
+            self.write_len(TAG_ARRAY, elements.len());
+            match elements {
+                ArrayElements::Double(numbers) => {
+                    for n in numbers.iter() {
+                        self.write_number(*n);
+                    }
+                }
+                ArrayElements::Generic(values) => {
+                    pending.extend(values.iter().rev().cloned().map(Pending::Value));
+                }
+            }
+            return Ok(());
+        }
+        let viewed = match &obj_ref.exotic {
+            ExoticObject::Ordinary | ExoticObject::Error(_) => None,
+            ExoticObject::ArrayBuffer(store) => Some((store.cheap_clone(), 0, store.len())),
+            ExoticObject::TypedArray(data) => Some((
+                data.store.cheap_clone(),
+                data.byte_offset,
+                data.length * data.kind.element_size(),
+            )),
+            ExoticObject::DataView(data) => {
+                Some((data.store.cheap_clone(), data.byte_offset, data.byte_length))
+            }
+            _ => {
+                drop(obj_ref);
+                pending.push(Pending::Json(js_value_to_json(value)?));
+                return Ok(());
+            }
+        };
+        if let Some((store, offset, len)) = viewed {
+            self.register(Some(obj.id()));
+            let bytes = store.bytes();
+            let view = bytes.get(offset..offset + len).unwrap_or_default();
+            self.write_len(TAG_BYTES, view.len());
+            self.out.extend_from_slice(view);
+            return Ok(());
+        }
+
+        let props: Vec<(JsString, JsValue)> = obj_ref
+            .properties
+            .iter()
+            .filter(|(_, prop)| prop.enumerable() && !skipped_in_objects(&prop.value))
+            .filter_map(|(key, prop)| match key {
+                PropertyKey::String(s) => Some((s.cheap_clone(), prop.value.clone())),
+                PropertyKey::Index(i) => Some((JsString::from(i.to_string()), prop.value.clone())),
+                PropertyKey::Symbol(_) => None,
+            })
+            .collect();
+        drop(obj_ref);
+
+        self.register(Some(obj.id()));
+        self.write_len(TAG_OBJECT, props.len());
+        for (key, val) in props.into_iter().rev() {
+            pending.push(Pending::Value(val));
+            pending.push(Pending::Key(key));
+        }
+        Ok(())
+    }
+
+    fn write_json(&mut self, json: serde_json::Value, pending: &mut Vec<Pending>) {
+        match json {
+            serde_json::Value::Null => self.out.push(TAG_NULL),
+            serde_json::Value::Bool(b) => self.out.push(if b { TAG_TRUE } else { TAG_FALSE }),
+            serde_json::Value::Number(n) => self.write_number(n.as_f64().unwrap_or(0.0)),
+            serde_json::Value::String(s) => self.write_string(&JsString::from(s.as_str())),
+            serde_json::Value::Array(items) => {
+                // Nothing can refer back to a converted tree, but it still
+                // takes an index so both sides number containers alike
+                self.register(None);
+                self.write_len(TAG_ARRAY, items.len());
+                pending.extend(items.into_iter().rev().map(Pending::Json));
+            }
+            serde_json::Value::Object(map) => {
+                self.register(None);
+                self.write_len(TAG_OBJECT, map.len());
+                let entries: Vec<_> = map.into_iter().collect();
+                for (key, item) in entries.into_iter().rev() {
+                    pending.push(Pending::Json(item));
+                    pending.push(Pending::Key(JsString::from(key.as_str())));
+                }
+            }
+        }
+    }
+}
+
+/// Work left for the encoder, popped in output order
+enum Pending {
+    Value(JsValue),
+    Key(JsString),
+    Json(serde_json::Value),
+}
+
+/// Property values that objects leave out, as JSON does
+fn skipped_in_objects(value: &JsValue) -> bool {
+    match value {
+        JsValue::Symbol(_) => true,
+        JsValue::Object(obj) => obj.borrow().is_callable(),
+        _ => false,
+    }
+}
+
+struct Decoder<'a> {
+    bytes: &'a [u8],
+    pos: usize,
+    strings: Vec<JsString>,
+    objects: Vec<JsValue>,
+}
+
+impl Decoder<'_> {
+    fn error(&self, message: &str) -> JsError {
+        JsError::type_error(format!(
+            "Invalid value buffer at byte {}: {}",
+            self.pos, message
+        ))
+    }
+
+    fn read_byte(&mut self) -> Result<u8, JsError> {
+        let b = self
+            .bytes
+            .get(self.pos)
+            .copied()
+            .ok_or_else(|| self.error("unexpected end"))?;
+        self.pos += 1;
+        Ok(b)
+    }
+
+    fn read_varint(&mut self) -> Result<u64, JsError> {
+        let mut n: u64 = 0;
+        for shift in (0..64).step_by(7) {
+            let b = self.read_byte()?;
+            n |= u64::from(b & 0x7f) << shift;
+            if b & 0x80 == 0 {
+                return Ok(n);
+            }
+        }
+        Err(self.error("varint too long"))
+    }
+
+    /// Read a length that must fit in the remaining input
+    fn read_len(&mut self) -> Result<usize, JsError> {
+        let len = self.read_varint()?;
+        let remaining = self.bytes.len() - self.pos;
+        match usize::try_from(len) {
+            Ok(len) if len <= remaining => Ok(len),
+            _ => Err(self.error("length exceeds input")),
+        }
+    }
+
+    fn read_slice(&mut self, len: usize) -> Result<&[u8], JsError> {
+        let start = self.pos;
+        let slice = self
+            .bytes
+            .get(start..start + len)
+            .ok_or_else(|| self.error("unexpected end"))?;
+        self.pos += len;
+        Ok(slice)
+    }
+
+    fn read_index<'t, T>(&self, table: &'t [T], index: u64) -> Result<&'t T, JsError> {
+        usize::try_from(index)
+            .ok()
+            .and_then(|i| table.get(i))
+            .ok_or_else(|| self.error("reference to an unknown entry"))
+    }
+
+    /// Read a string (tag 6 or 7); object keys are interned
+    fn read_string(
+        &mut self,
+        interp: &mut Interpreter,
+        tag: u8,
+        key: bool,
+    ) -> Result<JsString, JsError> {
+        match tag {
+            TAG_STRING => {
+                let len = self.read_len()?;
+                let Ok(text) = core::str::from_utf8(self.read_slice(len)?) else {
+                    return Err(self.error("invalid UTF-8 in string"));
+                };
+                let s = if key {
+                    interp.intern(text)
+                } else {
+                    JsString::from(text)
+                };
+                self.strings.push(s.cheap_clone());
+                Ok(s)
+            }
+            TAG_STRING_REF => {
+                let index = self.read_varint()?;
+                Ok(self.read_index(&self.strings, index)?.cheap_clone())
+            }
+            _ => Err(self.error("expected a string")),
+        }
+    }
+
+    fn read_key(&mut self, interp: &mut Interpreter) -> Result<JsString, JsError> {
+        let tag = self.read_byte()?;
+        self.read_string(interp, tag, true)
+    }
+
+    /// Read one complete value. Open containers are kept on an explicit
+    /// stack, so nesting is bounded by the input size rather than by the
+    /// native stack.
+    fn read_value(
+        &mut self,
+        interp: &mut Interpreter,
+        guard: &Guard<JsObject>,
+    ) -> Result<JsValue, JsError> {
+        let mut stack: Vec<Frame> = Vec::new();
+        loop {
+            let mut value = match self.read_item(interp, guard)? {
+                Item::Value(value) => value,
+                Item::Open(frame) => {
+                    stack.push(frame);
+                    continue;
+                }
+            };
+            // Hand the value to its container, closing every container it fills
+            loop {
+                match stack.last_mut() {
+                    None => return Ok(value),
+                    Some(Frame::Array {
+                        elements,
+                        remaining,
+                        ..
+                    }) => {
+                        elements.push(value);
+                        *remaining -= 1;
+                        if *remaining > 0 {
+                            break;
+                        }
+                    }
+                    Some(Frame::Object {
+                        obj,
+                        key,
+                        remaining,
+                    }) => {
+                        let name = JsValue::String(key.cheap_clone());
+                        let prop_key = PropertyKey::from_value(&name);
+                        obj.borrow_mut().set_property(prop_key, value);
+                        *remaining -= 1;
+                        if *remaining > 0 {
+                            *key = self.read_key(interp)?;
+                            break;
+                        }
+                    }
+                }
+                let Some(frame) = stack.pop() else {
+                    return Err(JsError::internal_error("value codec frame missing"));
+                };
+                value = frame.close();
+            }
+        }
+    }
+
+    /// Read a scalar or reference, or the header of a non-empty container
+    fn read_item(
+        &mut self,
+        interp: &mut Interpreter,
+        guard: &Guard<JsObject>,
+    ) -> Result<Item, JsError> {
+        let tag = self.read_byte()?;
+        let value = match tag {
+            TAG_UNDEFINED => JsValue::Undefined,
+            TAG_NULL => JsValue::Null,
+            TAG_FALSE => JsValue::Boolean(false),
+            TAG_TRUE => JsValue::Boolean(true),
+            TAG_INT => {
+                let zigzag = self.read_varint()?;
+                let i = ((zigzag >> 1) as i64) ^ -((zigzag & 1) as i64);
+                JsValue::Number(i as f64)
+            }
+            TAG_FLOAT => {
+                let mut raw = [0u8; 8];
+                raw.copy_from_slice(self.read_slice(8)?);
+                JsValue::Number(f64::from_le_bytes(raw))
+            }
+            TAG_STRING | TAG_STRING_REF => JsValue::String(self.read_string(interp, tag, false)?),
+            TAG_ARRAY => {
+                let len = self.read_len()?;
+                // Registered before its elements so they can refer back to it
+                let arr = interp.create_array_from(guard, Vec::new());
+                self.objects.push(JsValue::Object(arr.cheap_clone()));
+                if len > 0 {
+                    return Ok(Item::Open(Frame::Array {
+                        arr,
+                        elements: Vec::with_capacity(len),
+                        remaining: len,
+                    }));
+                }
+                JsValue::Object(arr)
+            }
+            TAG_OBJECT => {
+                let count = self.read_len()?;
+                let obj = interp.create_object_with_capacity(guard, count);
+                self.objects.push(JsValue::Object(obj.cheap_clone()));
+                if count > 0 {
+                    let key = self.read_key(interp)?;
+                    return Ok(Item::Open(Frame::Object {
+                        obj,
+                        key,
+                        remaining: count,
+                    }));
+                }
+                JsValue::Object(obj)
+            }
+            TAG_BYTES => {
+                let len = self.read_len()?;
+                let store = ByteStore::new(self.read_slice(len)?.to_vec());
+                let buffer = interp.create_array_buffer(guard, store.cheap_clone());
+                let array =
+                    interp.create_typed_array(guard, TypedArrayKind::Uint8, buffer, store, 0, len);
+                let value = JsValue::Object(array);
+                self.objects.push(value.clone());
+                value
+            }
+            TAG_OBJECT_REF => {
+                let index = self.read_varint()?;
+                self.read_index(&self.objects, index)?.clone()
+            }
+            _ => return Err(self.error("unknown tag")),
+        };
+        Ok(Item::Value(value))
+    }
+}
+
+enum Item {
+    Value(JsValue),
+    Open(Frame),
+}
+
+/// A container whose contents are still being read
+enum Frame {
+    Array {
+        arr: Gc<JsObject>,
+        elements: Vec<JsValue>,
+        remaining: usize,
+    },
+    /// Waiting for the value of `key`
+    Object {
+        obj: Gc<JsObject>,
+        key: JsString,
+        remaining: usize,
+    },
+}
+
+impl Frame {
+    fn close(self) -> JsValue {
+        match self {
+            Frame::Array { arr, elements, .. } => {
+                arr.borrow_mut().exotic = ExoticObject::Array {
+                    elements: ArrayElements::from_values(elements),
+                };
+                JsValue::Object(arr)
+            }
+            Frame::Object { obj, .. } => JsValue::Object(obj),
+        }
+    }
+}
@@ -3,16 +3,17 @@
 //! This module implements the bytecode interpreter that executes compiled bytecode.
 //! It uses a register-based design with up to 256 virtual registers per call frame.
 
-use crate::compiler::{BytecodeChunk, Constant, Op, Register};
+use crate::compiler::{BytecodeChunk, CacheIndex, Constant, JumpTarget, Op, Register};
 use crate::error::{JsError, StackFrame};
 use crate::gc::{Gc, Guard};
 use crate::prelude::{math, *};
 use crate::value::{
-    BytecodeFunction, CheapClone, ExoticObject, Guarded, JsFunction, JsObject, JsString, JsValue,
-    Property, PropertyKey,
+    Binding, BytecodeFunction, CallSite, CheapClone, ExoticObject, Guarded, JsFunction, JsObject,
+    JsString, JsValue, Property, PropertyKey, VarKey,
 };
 
-use super::Interpreter;
+use super::profiler::Profiler;
+use super::{BUDGET_CHECK_INSTRUCTIONS, Interpreter};
 
 /// Parameters for a trampoline function call
 struct CallParams {
@@ -24,6 +25,55 @@ struct CallParams {
     is_super_call: bool,
 }
 
+/// Terminal result for a script stopped by the heap's object limit; it
+/// bypasses exception handlers so scripts cannot catch it
+fn object_limit_exceeded() -> VmStepResult {
+    VmStepResult::Terminal(Box::new(VmResult::Error(JsError::range_error(
+        "Object limit exceeded",
+    ))))
+}
+
+/// Error stopping a script whose `run_budget` deadline passed in a nested
+/// run; like the object limit, exception handlers cannot catch it
+pub(crate) fn time_limit_error() -> JsError {
+    JsError::range_error("Time limit exceeded")
+}
+
+/// Whether `error` is a simple error that gets a stack trace when it
+/// propagates out of the VM (thrown values carry their own)
+fn needs_stack_trace(error: &JsError) -> bool {
+    matches!(
+        error,
+        JsError::TypeError { .. }
+            | JsError::ReferenceError { .. }
+            | JsError::RangeError { .. }
+            | JsError::SyntaxError { .. }
+            | JsError::ModuleError { .. }
+            | JsError::Internal(_)
+    )
+}
+
+/// Convert a simple error into a RuntimeError with the given backtrace
+fn into_runtime_error(error: JsError, stack: Vec<StackFrame>) -> JsError {
+    let (kind, message) = match error {
+        JsError::TypeError { message, .. } => ("TypeError".to_string(), message),
+        JsError::ReferenceError { name } => (
+            "ReferenceError".to_string(),
+            format!("{} is not defined", name),
+        ),
+        JsError::RangeError { message } => ("RangeError".to_string(), message),
+        JsError::SyntaxError { message, .. } => ("SyntaxError".to_string(), message),
+        JsError::ModuleError { message } => ("ModuleError".to_string(), message),
+        JsError::Internal(msg) => ("InternalError".to_string(), msg),
+        other => return other,
+    };
+    JsError::RuntimeError {
+        kind,
+        message,
+        stack,
+    }
+}
+
 /// Result of VM execution
 pub enum VmResult {
     /// Execution completed with a value
@@ -271,6 +321,9 @@ pub struct BytecodeVM {
     register_pool: Vec<Vec<JsValue>>,
     /// Pool of reusable argument vectors to reduce allocation overhead
     arguments_pool: Vec<Vec<JsValue>>,
+    /// Pool of binding maps taken from function environments that nothing
+    /// captured, reused for the environments of later calls
+    bindings_pool: Vec<FxHashMap<VarKey, Binding>>,
 }
 
 impl BytecodeVM {
@@ -302,6 +355,7 @@ impl BytecodeVM {
             trampoline_stack: Vec::new(),
             register_pool: Vec::new(),
             arguments_pool: Vec::new(),
+            bindings_pool: Vec::new(),
         }
     }
 
@@ -356,6 +410,7 @@ impl BytecodeVM {
             trampoline_stack: Vec::new(),
             register_pool: Vec::new(),
             arguments_pool: Vec::new(),
+            bindings_pool: Vec::new(),
         }
     }
 
@@ -409,6 +464,7 @@ impl BytecodeVM {
             trampoline_stack: Vec::new(),
             register_pool: Vec::new(),
             arguments_pool: Vec::new(),
+            bindings_pool: Vec::new(),
         }
     }
 
@@ -470,89 +526,71 @@ impl BytecodeVM {
         }
     }
 
-    /// Build a stack trace from the current VM state.
-    /// Returns a vector of StackFrame entries from innermost to outermost.
-    pub fn build_stack_trace(&self) -> Vec<StackFrame> {
-        let mut frames = Vec::new();
+    /// Acquire an empty binding map with given capacity from pool
+    #[inline]
+    fn acquire_bindings(&mut self, capacity: usize) -> FxHashMap<VarKey, Binding> {
+        match self.bindings_pool.pop() {
+            Some(mut bindings) => {
+                bindings.reserve(capacity);
+                bindings
+            }
+            None => FxHashMap::with_capacity_and_hasher(capacity, Default::default()),
+        }
+    }
 
-        // Current frame (where the error occurred)
-        let current_ip = if self.ip > 0 { self.ip - 1 } else { 0 };
-        if let Some(span) = self.chunk.get_source_location(current_ip) {
-            let function_name = self
-                .chunk
-                .function_info
-                .as_ref()
-                .and_then(|info| info.name.as_ref().map(|s| s.to_string()));
-            frames.push(StackFrame {
-                function_name,
-                file: self.chunk.source_file.clone(),
-                line: span.line,
-                column: span.column,
-            });
+    /// Take the binding map of a returning function's environment for reuse.
+    /// Only done when the environment is referenced by nothing but `env` and
+    /// its guard root, i.e. no closure, scope or suspended frame captured it.
+    fn recycle_bindings(&mut self, env: &Gc<JsObject>) {
+        if env.ref_count() != 2 || self.bindings_pool.len() >= 16 {
+            return;
         }
+        let Some(mut bindings) = env
+            .borrow_mut()
+            .as_environment_mut()
+            .map(|data| mem::take(&mut data.bindings))
+        else {
+            return;
+        };
+        // Cleared after releasing the borrow: dropping values may free objects
+        bindings.clear();
+        self.bindings_pool.push(bindings);
+    }
 
+    /// Record the call sites of the current VM state, innermost first.
+    /// Only the chunk handles are copied; frames are resolved when needed.
+    pub fn capture_call_sites(&self) -> Vec<CallSite> {
+        let mut sites = Vec::with_capacity(self.trampoline_stack.len() + 1);
+        sites.push(CallSite {
+            chunk: self.chunk.cheap_clone(),
+            ip: self.ip.saturating_sub(1),
+        });
         // Frames from the trampoline stack (outer call frames)
         for tramp_frame in self.trampoline_stack.iter().rev() {
-            let frame_ip = if tramp_frame.ip > 0 {
-                tramp_frame.ip - 1
-            } else {
-                0
-            };
-            if let Some(span) = tramp_frame.chunk.get_source_location(frame_ip) {
-                let function_name = tramp_frame
-                    .chunk
-                    .function_info
-                    .as_ref()
-                    .and_then(|info| info.name.as_ref().map(|s| s.to_string()));
-                frames.push(StackFrame {
-                    function_name,
-                    file: tramp_frame.chunk.source_file.clone(),
-                    line: span.line,
-                    column: span.column,
-                });
-            }
+            sites.push(CallSite {
+                chunk: tramp_frame.chunk.cheap_clone(),
+                ip: tramp_frame.ip.saturating_sub(1),
+            });
         }
+        sites
+    }
 
-        frames
+    /// Build a stack trace from the current VM state.
+    /// Returns a vector of StackFrame entries from innermost to outermost.
+    pub fn build_stack_trace(&self) -> Vec<StackFrame> {
+        self.capture_call_sites()
+            .iter()
+            .filter_map(CallSite::frame)
+            .collect()
     }
 
     /// Wrap a JsError with stack trace information.
     /// Converts simple errors (TypeError, ReferenceError, etc.) into RuntimeError with backtrace.
     pub fn wrap_error_with_trace(&self, error: JsError) -> JsError {
-        // Only wrap errors that don't already have a stack trace
-        match &error {
-            JsError::RuntimeError { .. } => error, // Already has stack
-            JsError::Thrown | JsError::ThrownValue { .. } => error, // User-thrown, handled separately
-            JsError::GeneratorYield { .. } => error,                // Not a real error
-            JsError::OptionalChainShortCircuit => error,            // Not a real error
-            _ => {
-                let stack = self.build_stack_trace();
-                let (kind, message) = match &error {
-                    JsError::TypeError { message, .. } => {
-                        ("TypeError".to_string(), message.clone())
-                    }
-                    JsError::ReferenceError { name } => (
-                        "ReferenceError".to_string(),
-                        format!("{} is not defined", name),
-                    ),
-                    JsError::RangeError { message } => ("RangeError".to_string(), message.clone()),
-                    JsError::SyntaxError { message, .. } => {
-                        ("SyntaxError".to_string(), message.clone())
-                    }
-                    JsError::ModuleError { message } => {
-                        ("ModuleError".to_string(), message.clone())
-                    }
-                    JsError::Internal(msg) => ("InternalError".to_string(), msg.clone()),
-                    // Already handled above
-                    _ => return error,
-                };
-                JsError::RuntimeError {
-                    kind,
-                    message,
-                    stack,
-                }
-            }
+        if !needs_stack_trace(&error) {
+            return error;
         }
+        into_runtime_error(error, self.build_stack_trace())
     }
 
     /// Get register value
@@ -577,9 +615,17 @@ impl BytecodeVM {
             && let Some(slot) = self.registers.get_mut(idx)
         {
             if let JsValue::Object(obj) = &value {
-                self.register_guard.guard(obj.clone());
+                // Rewriting a register with the object it already holds
+                // (loop variables, `this`) leaves the root set unchanged
+                if let JsValue::Object(old) = &*slot
+                    && Gc::ptr_eq(old, obj)
+                {
+                    *slot = value;
+                    return;
+                }
+                self.register_guard.guard_ref(obj);
             }
-            if let JsValue::Object(obj) = &slot {
+            if let JsValue::Object(obj) = &*slot {
                 self.register_guard.unguard(obj);
             }
             *slot = value;
@@ -694,31 +740,100 @@ impl BytecodeVM {
     #[inline]
     pub fn step(&mut self, interp: &mut Interpreter) -> VmStepResult {
         let Some(op) = self.fetch() else {
-            // End of bytecode - return last result or undefined
-            let result = self
-                .registers
-                .first()
-                .cloned()
-                .unwrap_or(JsValue::Undefined);
+            return self.finish_chunk(interp);
+        };
 
-            // Check if we have a trampoline frame to return to
-            if let Some(frame) = self.trampoline_stack.pop() {
-                // Restore state from trampoline frame
-                self.restore_from_trampoline_frame(interp, frame, result);
-                return VmStepResult::Continue;
+        match self.execute_op(interp, op) {
+            Ok(OpResult::Continue) => VmStepResult::Continue,
+            result => self.complete_op(interp, result),
+        }
+    }
+
+    /// Execute up to `budget` instructions, stopping early at a terminal state.
+    ///
+    /// This is the VM's inner run loop: instructions that complete inline only
+    /// pay for fetch and dispatch, so hosts should prefer one call with a large
+    /// budget over many `step()` calls.
+    ///
+    /// Stops with an uncatchable error once the heap's object limit has been
+    /// exceeded (see `Interpreter::set_object_limit`).
+    pub fn run_steps(&mut self, interp: &mut Interpreter, budget: usize) -> VmStepResult {
+        if interp.deadline_exceeded {
+            // A builtin swallowed the error of a nested run that hit the deadline
+            return VmStepResult::Terminal(Box::new(VmResult::Error(time_limit_error())));
+        }
+        if interp.profiler.is_some() {
+            return self.run_steps_profiled(interp, budget);
+        }
+        for _ in 0..budget {
+            if interp.heap.limit_exceeded() {
+                return object_limit_exceeded();
             }
+            if let VmStepResult::Terminal(result) = self.step(interp) {
+                return VmStepResult::Terminal(result);
+            }
+        }
+        VmStepResult::Continue
+    }
 
-            let guard = interp.heap.create_guard();
-            if let JsValue::Object(obj) = &result {
-                guard.guard(obj.cheap_clone());
+    /// `run_steps` with the running profiler counting and sampling each
+    /// instruction
+    fn run_steps_profiled(&mut self, interp: &mut Interpreter, budget: usize) -> VmStepResult {
+        for done in 0..budget {
+            if interp.heap.limit_exceeded() {
+                return object_limit_exceeded();
             }
-            return VmStepResult::Terminal(Box::new(VmResult::Complete(Guarded {
-                value: result,
-                guard: Some(guard),
-            })));
-        };
+            // A native callback may stop the profiler mid-loop
+            let Some(profiler) = interp.profiler.as_mut() else {
+                return self.run_steps(interp, budget - done);
+            };
+            if let Some(op) = self.chunk.get(self.ip) {
+                profiler.count_op(op);
+            }
+            if profiler.tick() {
+                Profiler::maybe_sample(interp, &self.chunk, &self.trampoline_stack);
+            }
+            if let VmStepResult::Terminal(result) = self.step(interp) {
+                return VmStepResult::Terminal(result);
+            }
+        }
+        VmStepResult::Continue
+    }
 
-        match self.execute_op(interp, op) {
+    /// Reached the end of the current chunk: return to the caller's trampoline
+    /// frame, or complete with the value in register 0
+    fn finish_chunk(&mut self, interp: &mut Interpreter) -> VmStepResult {
+        let result = self
+            .registers
+            .first()
+            .cloned()
+            .unwrap_or(JsValue::Undefined);
+
+        // Check if we have a trampoline frame to return to
+        if let Some(frame) = self.trampoline_stack.pop() {
+            // Restore state from trampoline frame
+            self.restore_from_trampoline_frame(interp, frame, result);
+            return VmStepResult::Continue;
+        }
+
+        let guard = interp.heap.create_guard();
+        if let JsValue::Object(obj) = &result {
+            guard.guard(obj.cheap_clone());
+        }
+        VmStepResult::Terminal(Box::new(VmResult::Complete(Guarded {
+            value: result,
+            guard: Some(guard),
+        })))
+    }
+
+    /// Handle an instruction result other than a plain `Continue`: trampoline
+    /// calls, returns, suspensions and exception unwinding
+    fn complete_op(
+        &mut self,
+        interp: &mut Interpreter,
+        result: Result<OpResult, JsError>,
+    ) -> VmStepResult {
+        match result {
             Ok(OpResult::Continue) => VmStepResult::Continue,
             Ok(OpResult::Halt(value)) => {
                 // Check if we have a trampoline frame to return to
@@ -850,10 +965,21 @@ impl BytecodeVM {
     /// This method runs until a terminal state is reached. For step-by-step control,
     /// use the `step()` method instead.
     pub fn run(&mut self, interp: &mut Interpreter) -> VmResult {
+        // Nested runs cannot hand control back to the host, so under a
+        // `run_budget` deadline they check it between slices and stop the
+        // script once it passes
+        let slice = if interp.has_run_deadline() {
+            BUDGET_CHECK_INSTRUCTIONS as usize
+        } else {
+            usize::MAX
+        };
         loop {
-            match self.step(interp) {
-                VmStepResult::Continue => continue,
-                VmStepResult::Terminal(result) => return *result,
+            if let VmStepResult::Terminal(result) = self.run_steps(interp, slice) {
+                return *result;
+            }
+            if interp.run_deadline_passed() {
+                interp.deadline_exceeded = true;
+                return VmResult::Error(time_limit_error());
             }
         }
     }
@@ -905,7 +1031,8 @@ impl BytecodeVM {
                 ExoticObject::Function(f) => f.clone(),
                 _ => return Err(JsError::type_error("Not a function")),
             }
-        };
+        }
+        .with_compiled_body(&mut interp.string_dict)?;
 
         match func {
             JsFunction::Bytecode(bc_func) => {
@@ -1098,7 +1225,8 @@ impl BytecodeVM {
                 ExoticObject::Function(f) => f.clone(),
                 _ => return Err(JsError::type_error("Not a constructor")),
             }
-        };
+        }
+        .with_compiled_body(&mut interp.string_dict)?;
 
         match func {
             JsFunction::Bytecode(bc_func) => {
@@ -1161,16 +1289,13 @@ impl BytecodeVM {
         is_async: bool,
         is_super_call: bool,
     ) -> Result<(), JsError> {
-        use crate::interpreter::{Binding, VarKey, create_environment_unrooted_with_capacity};
+        use crate::interpreter::create_environment_unrooted;
 
         // Get function info from the chunk
         let func_info = bc_func.chunk.function_info.as_ref();
 
         // Push call stack frame for stack traces
-        let func_name = func_info
-            .and_then(|info| info.name.as_ref())
-            .map(|s| s.to_string())
-            .unwrap_or_else(|| "<anonymous>".to_string());
+        let func_name = func_info.and_then(|info| info.name.cheap_clone());
 
         interp.call_stack.push(crate::interpreter::StackFrame {
             function_name: func_name,
@@ -1190,12 +1315,14 @@ impl BytecodeVM {
             })
             .unwrap_or(8);
 
-        // Create new environment for the function, with closure as parent
-        let (func_env, func_guard) = create_environment_unrooted_with_capacity(
-            &interp.heap,
-            Some(bc_func.closure.cheap_clone()),
-            env_capacity,
-        );
+        // Create new environment for the function, with closure as parent and
+        // a binding map from the pool
+        let (func_env, func_guard) =
+            create_environment_unrooted(&interp.heap, Some(bc_func.closure.cheap_clone()));
+        let bindings = self.acquire_bindings(env_capacity);
+        if let Some(data) = func_env.borrow_mut().as_environment_mut() {
+            data.bindings = bindings;
+        }
 
         // Bind `this` in the function environment
         let effective_this = if let Some(captured) = bc_func.captured_this {
@@ -1357,16 +1484,13 @@ impl BytecodeVM {
         new_target: JsValue,
         construct_new_obj: Gc<JsObject>,
     ) -> Result<(), JsError> {
-        use crate::interpreter::{Binding, VarKey, create_environment_unrooted_with_capacity};
+        use crate::interpreter::create_environment_unrooted;
 
         // Get function info from the chunk
         let func_info = bc_func.chunk.function_info.as_ref();
 
         // Push call stack frame for stack traces
-        let func_name = func_info
-            .and_then(|info| info.name.as_ref())
-            .map(|s| s.to_string())
-            .unwrap_or_else(|| "<anonymous>".to_string());
+        let func_name = func_info.and_then(|info| info.name.cheap_clone());
 
         interp.call_stack.push(crate::interpreter::StackFrame {
             function_name: func_name,
@@ -1386,12 +1510,14 @@ impl BytecodeVM {
             })
             .unwrap_or(8);
 
-        // Create new environment for the function, with closure as parent
-        let (func_env, func_guard) = create_environment_unrooted_with_capacity(
-            &interp.heap,
-            Some(bc_func.closure.cheap_clone()),
-            env_capacity,
-        );
+        // Create new environment for the function, with closure as parent and
+        // a binding map from the pool
+        let (func_env, func_guard) =
+            create_environment_unrooted(&interp.heap, Some(bc_func.closure.cheap_clone()));
+        let bindings = self.acquire_bindings(env_capacity);
+        if let Some(data) = func_env.borrow_mut().as_environment_mut() {
+            data.bindings = bindings;
+        }
 
         // Bind `this` in the function environment
         let effective_this = if let Some(captured) = bc_func.captured_this {
@@ -1569,6 +1695,7 @@ impl BytecodeVM {
         self.pending_completion = frame.pending_completion;
 
         // Restore interpreter environment
+        self.recycle_bindings(&interp.env);
         interp.pop_env_guard();
         interp.env = frame.saved_interp_env;
         interp.call_stack.pop();
@@ -1583,51 +1710,44 @@ impl BytecodeVM {
             return_value
         };
 
-        // For async calls: wrap result in a Promise
-        let final_value = if frame.is_async {
-            use crate::value::ExoticObject;
-            // Promise assimilation: if result is already a Promise, return it directly
-            if let JsValue::Object(obj) = &intermediate_value {
-                if matches!(obj.borrow().exotic, ExoticObject::Promise(_)) {
-                    intermediate_value
-                } else {
-                    // Wrap non-Promise value in a fulfilled Promise
-                    let promise = super::builtins::promise::create_fulfilled_promise(
-                        interp,
-                        &self.register_guard,
-                        intermediate_value,
-                    );
-                    JsValue::Object(promise)
-                }
-            } else {
-                // Wrap primitive value in a fulfilled Promise
-                let promise = super::builtins::promise::create_fulfilled_promise(
-                    interp,
-                    &self.register_guard,
-                    intermediate_value,
-                );
-                JsValue::Object(promise)
-            }
-        } else {
-            intermediate_value
+        // For async calls: wrap result in a Promise.
+        // Promise assimilation: if result is already a Promise, return it directly
+        let is_promise = |value: &JsValue| {
+            matches!(value, JsValue::Object(obj)
+                if matches!(obj.borrow().exotic, crate::value::ExoticObject::Promise(_)))
         };
-
-        // Store return value in the designated register
-        // Guard it with the restored frame's guard
-        if let JsValue::Object(obj) = &final_value {
-            self.register_guard.guard(obj.cheap_clone());
+        if frame.is_async && !is_promise(&intermediate_value) {
+            // The promise only needs rooting until set_reg roots it in the
+            // restored register file
+            let guard = interp.heap.create_guard();
+            let promise = super::builtins::promise::create_fulfilled_promise(
+                interp,
+                &guard,
+                intermediate_value,
+            );
+            self.set_reg(frame.return_register, JsValue::Object(promise));
+            return;
         }
-        self.set_reg(frame.return_register, final_value);
+
+        // Store return value in the designated register; set_reg roots it
+        // with the restored frame's guard
+        self.set_reg(frame.return_register, intermediate_value);
     }
 
-    /// Convert an error to a guarded JS value (takes ownership to avoid re-guarding)
-    fn error_to_guarded(&self, interp: &mut Interpreter, error: JsError) -> Guarded {
+    /// Convert an error raised at `sites` to a guarded JS value (takes
+    /// ownership to avoid re-guarding)
+    fn error_to_guarded(
+        &self,
+        interp: &mut Interpreter,
+        error: JsError,
+        sites: Vec<CallSite>,
+    ) -> Guarded {
         match error {
             JsError::ThrownValue { guarded } => guarded,
             other => {
                 // Create an error object using the proper error type
                 use crate::interpreter::builtins::error::create_error_object;
-                let (value, guard) = create_error_object(interp, &other);
+                let (value, guard) = create_error_object(interp, &other, sites);
                 Guarded { value, guard }
             }
         }
@@ -1687,14 +1807,26 @@ impl BytecodeVM {
         interp: &mut Interpreter,
         e: JsError,
     ) -> Result<(), JsError> {
-        // Capture stack trace BEFORE unwinding the trampoline stack
-        // This gives us the full call stack at the point of error
-        let wrapped_error = self.wrap_error_with_trace(e);
+        if interp.deadline_exceeded {
+            // The script is being stopped; no handler or finally block runs
+            return Err(time_limit_error());
+        }
+
+        // Record where a simple error was raised BEFORE unwinding the
+        // trampoline stack. Only chunk handles are copied here; the sites
+        // are resolved to frames if nothing catches the error, or when the
+        // caught error object's `stack` is read.
+        let mut sites = if needs_stack_trace(&e) {
+            self.capture_call_sites()
+        } else {
+            Vec::new()
+        };
+        let wrapped_error = into_runtime_error(e, Vec::new());
 
         // First check for handler in current frame
         if let Some((handler_ip, is_catch)) = self.find_exception_handler(interp) {
             self.ip = handler_ip;
-            let guarded = self.error_to_guarded(interp, wrapped_error);
+            let guarded = self.error_to_guarded(interp, wrapped_error, sites);
             if is_catch {
                 // Catch handler: store in exception_value for GetException opcode
                 self.exception_value = Some(guarded);
@@ -1725,6 +1857,13 @@ impl BytecodeVM {
                 interp.pop_scope(saved_env);
             }
 
+            // A frame without handlers that is not async only has to be torn
+            // down; switching to it would be undone by the next iteration
+            if frame.try_stack.is_empty() && !is_async_frame {
+                self.discard_frame(interp, frame);
+                continue;
+            }
+
             // Restore state from frame
             self.ip = frame.ip;
             self.chunk = frame.chunk;
@@ -1746,15 +1885,16 @@ impl BytecodeVM {
 
             // For async frames: convert error to rejected Promise instead of propagating
             if is_async_frame {
-                let error_guarded = self.error_to_guarded(interp, wrapped_error);
+                let error_guarded = self.error_to_guarded(interp, wrapped_error, sites);
+                // The promise only needs rooting until set_reg roots it
+                let guard = interp.heap.create_guard();
                 let promise = super::builtins::promise::create_rejected_promise(
                     interp,
-                    &self.register_guard,
+                    &guard,
                     error_guarded.value,
                 );
                 // error_guarded.guard keeps the reason alive until promise is created
                 drop(error_guarded.guard);
-                self.register_guard.guard(promise.cheap_clone());
                 self.set_reg(return_register, JsValue::Object(promise));
                 return Ok(());
             }
@@ -1762,7 +1902,7 @@ impl BytecodeVM {
             // Check for exception handler in this frame
             if let Some((handler_ip, is_catch)) = self.find_exception_handler(interp) {
                 self.ip = handler_ip;
-                let guarded = self.error_to_guarded(interp, wrapped_error);
+                let guarded = self.error_to_guarded(interp, wrapped_error, mem::take(&mut sites));
                 if is_catch {
                     self.exception_value = Some(guarded);
                 } else {
@@ -1773,12 +1913,42 @@ impl BytecodeVM {
         }
 
         // No handler found - return the error back to caller with stack trace
-        Err(wrapped_error)
+        let mut error = wrapped_error;
+        if let JsError::RuntimeError { stack, .. } = &mut error
+            && !sites.is_empty()
+        {
+            *stack = sites.iter().filter_map(CallSite::frame).collect();
+        }
+        Err(error)
+    }
+
+    /// Tear down a caller frame the unwinding passes through, in the order
+    /// restoring it and unwinding it again would
+    fn discard_frame(&mut self, interp: &mut Interpreter, frame: TrampolineFrame) {
+        interp.pop_env_guard();
+        interp.env = frame.saved_interp_env;
+        interp.call_stack.pop();
+
+        let mut saved_env_stack = frame.saved_env_stack;
+        while let Some(saved_env) = saved_env_stack.pop() {
+            interp.pop_scope(saved_env);
+        }
+
+        // Clear the guard before the registers, as release_registers does
+        frame.register_guard.clear();
+        let mut registers = frame.registers;
+        registers.clear();
+        if self.register_pool.len() < 16 {
+            self.register_pool.push(registers);
+        }
+        self.release_arguments(frame.arguments);
     }
 
     /// Save VM state for suspension
-    /// Creates a guard to keep all objects in registers alive during suspension
-    fn save_state(&self, interp: &Interpreter) -> SavedVmState {
+    /// Creates a guard to keep all objects in registers alive during suspension.
+    /// A suspending VM is discarded, so its registers and frames are moved
+    /// into the saved state rather than copied.
+    fn save_state(&mut self, interp: &Interpreter) -> SavedVmState {
         let guard = interp.heap.create_guard();
 
         // Guard all objects in registers
@@ -1817,57 +1987,57 @@ impl BytecodeVM {
         }
 
         // Guard all objects in trampoline stack and convert to SavedTrampolineFrame
-        let saved_trampoline_stack: Vec<SavedTrampolineFrame> = self
-            .trampoline_stack
-            .iter()
-            .map(|frame| {
-                // Guard all objects in this frame
-                for val in &frame.registers {
-                    if let JsValue::Object(obj) = val {
+        let saved_trampoline_stack: Vec<SavedTrampolineFrame> =
+            mem::take(&mut self.trampoline_stack)
+                .into_iter()
+                .map(|frame| {
+                    // Guard all objects in this frame
+                    for val in &frame.registers {
+                        if let JsValue::Object(obj) = val {
+                            guard.guard(obj.cheap_clone());
+                        }
+                    }
+                    if let JsValue::Object(obj) = &frame.this_value {
+                        guard.guard(obj.cheap_clone());
+                    }
+                    for env in &frame.saved_env_stack {
+                        guard.guard(env.cheap_clone());
+                    }
+                    guard.guard(frame.saved_interp_env.cheap_clone());
+                    if let Some(ref ctor) = frame.current_constructor {
+                        guard.guard(ctor.cheap_clone());
+                    }
+                    if let Some(ref obj) = frame.construct_new_obj {
                         guard.guard(obj.cheap_clone());
                     }
-                }
-                if let JsValue::Object(obj) = &frame.this_value {
-                    guard.guard(obj.cheap_clone());
-                }
-                for env in &frame.saved_env_stack {
-                    guard.guard(env.cheap_clone());
-                }
-                guard.guard(frame.saved_interp_env.cheap_clone());
-                if let Some(ref ctor) = frame.current_constructor {
-                    guard.guard(ctor.cheap_clone());
-                }
-                if let Some(ref obj) = frame.construct_new_obj {
-                    guard.guard(obj.cheap_clone());
-                }
 
-                SavedTrampolineFrame {
-                    ip: frame.ip,
-                    chunk: frame.chunk.clone(),
-                    registers: frame.registers.clone(),
-                    this_value: frame.this_value.clone(),
-                    vm_call_stack: frame.vm_call_stack.clone(),
-                    try_stack: frame.try_stack.clone(),
-                    saved_env_stack: frame.saved_env_stack.clone(),
-                    arguments: frame.arguments.clone(),
-                    new_target: frame.new_target.clone(),
-                    current_constructor: frame.current_constructor.clone(),
-                    return_register: frame.return_register,
-                    saved_interp_env: frame.saved_interp_env.cheap_clone(),
-                    construct_new_obj: frame.construct_new_obj.clone(),
-                    is_async: frame.is_async,
-                }
-            })
-            .collect();
+                    SavedTrampolineFrame {
+                        ip: frame.ip,
+                        chunk: frame.chunk,
+                        registers: frame.registers,
+                        this_value: frame.this_value,
+                        vm_call_stack: frame.vm_call_stack,
+                        try_stack: frame.try_stack,
+                        saved_env_stack: frame.saved_env_stack,
+                        arguments: frame.arguments,
+                        new_target: frame.new_target,
+                        current_constructor: frame.current_constructor,
+                        return_register: frame.return_register,
+                        saved_interp_env: frame.saved_interp_env,
+                        construct_new_obj: frame.construct_new_obj,
+                        is_async: frame.is_async,
+                    }
+                })
+                .collect();
 
         SavedVmState {
-            frames: self.call_stack.clone(),
+            frames: mem::take(&mut self.call_stack),
             ip: self.ip,
-            chunk: self.chunk.clone(),
-            registers: self.registers.clone(),
-            try_stack: self.try_stack.clone(),
+            chunk: self.chunk.cheap_clone(),
+            registers: mem::take(&mut self.registers),
+            try_stack: mem::take(&mut self.try_stack),
             guard: Some(guard),
-            arguments: self.arguments.clone(),
+            arguments: mem::take(&mut self.arguments),
             new_target: self.new_target.clone(),
             trampoline_stack: saved_trampoline_stack,
         }
@@ -1970,16 +2140,14 @@ impl BytecodeVM {
             trampoline_stack,
             register_pool: Vec::new(),
             arguments_pool: Vec::new(),
+            bindings_pool: Vec::new(),
         }
     }
 
     /// Set the resume value for await resumption
     /// This stores the resolved promise value in the specified register
     pub fn set_resume_value(&mut self, register: Register, value: JsValue) {
-        // Guard the value if it's an object
-        if let JsValue::Object(ref obj) = value {
-            self.register_guard.guard(obj.cheap_clone());
-        }
+        // set_reg roots the value with the register guard
         self.set_reg(register, value);
     }
 
@@ -2082,6 +2250,10 @@ impl BytecodeVM {
             Op::Add { dst, left, right } => {
                 let left_val = self.get_reg(left);
                 let right_val = self.get_reg(right);
+                if let (&JsValue::Number(a), &JsValue::Number(b)) = (left_val, right_val) {
+                    self.set_reg(dst, JsValue::Number(a + b));
+                    return Ok(OpResult::Continue);
+                }
 
                 // First convert objects to primitives with "default" hint
                 let left_prim = interp.coerce_to_primitive(left_val, "default")?;
@@ -2090,11 +2262,11 @@ impl BytecodeVM {
                 let result = match (&left_prim, &right_prim) {
                     (JsValue::String(a), _) => {
                         let right_str = interp.to_js_string(&right_prim);
-                        JsValue::String(a.cheap_clone() + right_str.as_str())
+                        JsValue::String(a.concat(&right_str))
                     }
                     (_, JsValue::String(b)) => {
                         let left_str = interp.to_js_string(&left_prim);
-                        JsValue::String(left_str + b.as_str())
+                        JsValue::String(left_str.concat(b))
                     }
                     _ => JsValue::Number(left_prim.to_number() + right_prim.to_number()),
                 };
@@ -2478,6 +2650,27 @@ impl BytecodeVM {
                 Ok(OpResult::Continue)
             }
 
+            Op::ThrowConstAssignment { name } => {
+                let name = self
+                    .get_string_constant(name)
+                    .ok_or_else(|| JsError::internal_error("Invalid variable name constant"))?;
+                Err(JsError::type_error(format!(
+                    "Assignment to constant variable '{}'",
+                    name
+                )))
+            }
+
+            Op::ThrowSyntaxError {
+                message,
+                line,
+                column,
+            } => {
+                let message = self
+                    .get_string_constant(message)
+                    .ok_or_else(|| JsError::internal_error("Invalid error message constant"))?;
+                Err(JsError::syntax_error(message.as_str(), line, column))
+            }
+
             Op::DeclareVar {
                 name,
                 init,
@@ -2555,15 +2748,21 @@ impl BytecodeVM {
                 Ok(OpResult::Continue)
             }
 
-            Op::GetPropertyConst { dst, obj, key } => {
+            Op::GetPropertyConst {
+                dst,
+                obj,
+                key,
+                cache,
+            } => {
                 let obj_val = self.get_reg(obj);
-                let key = self
-                    .get_string_constant(key)
-                    .ok_or_else(|| JsError::internal_error("Invalid property key constant"))?;
-                let key_val = JsValue::String(key);
-                let Guarded { value, .. } = self.get_property_value(interp, obj_val, &key_val)?;
-                self.set_reg(dst, value);
-                Ok(OpResult::Continue)
+                if let JsValue::Object(obj_ref) = obj_val
+                    && let Some(value) = self.chunk.inline_caches.get(cache, obj_ref)
+                {
+                    interp.inline_cache_stats.hits += 1;
+                    self.set_reg(dst, value);
+                    return Ok(OpResult::Continue);
+                }
+                self.get_property_const_miss(interp, dst, obj_val.clone(), key, cache)
             }
 
             Op::SetProperty { obj, key, value } => {
@@ -2574,15 +2773,24 @@ impl BytecodeVM {
                 Ok(OpResult::Continue)
             }
 
-            Op::SetPropertyConst { obj, key, value } => {
+            Op::SetPropertyConst {
+                obj,
+                key,
+                value,
+                cache,
+            } => {
                 let obj_val = self.get_reg(obj);
-                let key = self
-                    .get_string_constant(key)
-                    .ok_or_else(|| JsError::internal_error("Invalid property key constant"))?;
-                let val = self.get_reg(value).clone();
-                let key_val = JsValue::String(key);
-                self.set_property_value(interp, obj_val, &key_val, val)?;
-                Ok(OpResult::Continue)
+                let mut val = self.get_reg(value).clone();
+                if let JsValue::Object(obj_ref) = obj_val {
+                    match self.chunk.inline_caches.set(cache, obj_ref, val) {
+                        Ok(()) => {
+                            interp.inline_cache_stats.hits += 1;
+                            return Ok(OpResult::Continue);
+                        }
+                        Err(missed) => val = missed,
+                    }
+                }
+                self.set_property_const_miss(interp, obj_val.clone(), key, cache, val)
             }
 
             Op::DeleteProperty { dst, obj, key } => {
@@ -2776,7 +2984,7 @@ impl BytecodeVM {
                 let args_val = self.get_reg(args_start).clone();
 
                 let args: Vec<JsValue> = if let JsValue::Object(arr_ref) = &args_val {
-                    if let Some(elems) = arr_ref.borrow().array_elements() {
+                    if let Some(elems) = arr_ref.borrow().array_storage() {
                         elems.to_vec()
                     } else {
                         Vec::new()
@@ -2964,7 +3172,7 @@ impl BytecodeVM {
                 let args_val = self.get_reg(args_start);
 
                 let args: Vec<JsValue> = if let JsValue::Object(arr_ref) = &args_val {
-                    if let Some(elems) = arr_ref.borrow().array_elements() {
+                    if let Some(elems) = arr_ref.borrow().array_storage() {
                         elems.to_vec()
                     } else {
                         Vec::new()
@@ -3167,6 +3375,15 @@ impl BytecodeVM {
             // ═══════════════════════════════════════════════════════════════════════════
             Op::Throw { value } => {
                 let val = self.get_reg(value).clone();
+                // Errors keep where they were first thrown for their stack
+                if let JsValue::Object(obj) = &val
+                    && matches!(&obj.borrow().exotic, ExoticObject::Error(data) if data.sites.is_empty())
+                {
+                    let sites = self.capture_call_sites();
+                    if let ExoticObject::Error(data) = &mut obj.borrow_mut().exotic {
+                        data.record_sites(sites);
+                    }
+                }
                 let guarded = Guarded::from_value(val, &interp.heap);
                 Err(JsError::ThrownValue { guarded })
             }
@@ -3399,7 +3616,7 @@ impl BytecodeVM {
                         }
 
                         // Check if it's an array - use direct element iteration
-                        if obj_ref.borrow().array_elements().is_some() {
+                        if obj_ref.borrow().array_storage().is_some() {
                             // Create an iterator object with the array and index
                             // Use register_guard to keep it alive across loop iterations
                             let guard = interp.heap.create_guard();
@@ -3483,7 +3700,7 @@ impl BytecodeVM {
 
                             // proxy_own_keys returns an array of keys
                             if let JsValue::Object(keys_arr) = value {
-                                if let Some(elements) = keys_arr.borrow().array_elements() {
+                                if let Some(elements) = keys_arr.borrow().array_storage() {
                                     elements.to_vec()
                                 } else {
                                     Vec::new()
@@ -3496,7 +3713,7 @@ impl BytecodeVM {
                             let mut result = Vec::new();
 
                             // For arrays, first add all array indices
-                            if let Some(elements) = obj_borrowed.array_elements() {
+                            if let Some(elements) = obj_borrowed.array_storage() {
                                 for i in 0..elements.len() {
                                     result.push(JsValue::String(JsString::from(i.to_string())));
                                 }
@@ -3514,7 +3731,7 @@ impl BytecodeVM {
                                     }
                                     PropertyKey::Index(i) => {
                                         // Only add if not an array (arrays already handled above)
-                                        if obj_borrowed.array_elements().is_none() {
+                                        if obj_borrowed.array_storage().is_none() {
                                             result.push(JsValue::String(JsString::from(
                                                 i.to_string(),
                                             )));
@@ -3659,7 +3876,7 @@ impl BytecodeVM {
 
                         // Check if it's an array - use direct element iteration
                         // The Await opcode will handle awaiting each element (promise or plain value)
-                        if obj_ref.borrow().array_elements().is_some() {
+                        if obj_ref.borrow().array_storage().is_some() {
                             let guard = interp.heap.create_guard();
                             let iter = interp.create_object(&guard);
                             iter.borrow_mut().set_property(
@@ -3740,16 +3957,19 @@ impl BytecodeVM {
                             _ => 0,
                         };
 
-                        let elements = arr_ref.borrow().array_elements().map(|e| e.to_vec());
-                        let (value, done) = if let Some(elems) = elements {
-                            if index < elems.len() {
-                                let val = elems.get(index).cloned().unwrap_or(JsValue::Undefined);
-                                (val, false)
-                            } else {
-                                (JsValue::Undefined, true)
+                        let element = {
+                            let arr_borrow = arr_ref.borrow();
+                            match arr_borrow.typed_array() {
+                                Some(data) => data.get(index).map(JsValue::Number),
+                                None => arr_borrow
+                                    .array_storage()
+                                    .filter(|elems| index < elems.len())
+                                    .map(|elems| elems.get(index).unwrap_or(JsValue::Undefined)),
                             }
-                        } else {
-                            (JsValue::Undefined, true)
+                        };
+                        let (value, done) = match element {
+                            Some(val) => (val, false),
+                            None => (JsValue::Undefined, true),
                         };
 
                         // Update index
@@ -3823,7 +4043,7 @@ impl BytecodeVM {
                         _ => 0,
                     };
 
-                    let elements = keys_arr.borrow().array_elements().map(|e| e.to_vec());
+                    let elements = keys_arr.borrow().array_storage().map(|e| e.to_vec());
                     let (value, done) = if let Some(elems) = elements {
                         if index < elems.len() {
                             let val = elems.get(index).cloned().unwrap_or(JsValue::Undefined);
@@ -4345,7 +4565,7 @@ impl BytecodeVM {
                 // Extract arguments from the array
                 let args_val = self.get_reg(args_array);
                 let args: Vec<JsValue> = if let JsValue::Object(arr_ref) = args_val {
-                    if let Some(elems) = arr_ref.borrow().array_elements() {
+                    if let Some(elems) = arr_ref.borrow().array_storage() {
                         elems.to_vec()
                     } else {
                         Vec::new()
@@ -4487,7 +4707,7 @@ impl BytecodeVM {
                             {
                                 // Push callback to the array using array_elements_mut
                                 let mut arr_ref = arr.borrow_mut();
-                                if let Some(elements) = arr_ref.array_elements_mut() {
+                                if let Some(elements) = arr_ref.array_storage_mut() {
                                     elements.push(callback.clone());
                                 }
                             }
@@ -4534,7 +4754,7 @@ impl BytecodeVM {
                     let callbacks: Vec<JsValue> = {
                         let arr_ref = arr.borrow();
                         if let crate::value::ExoticObject::Array { ref elements } = arr_ref.exotic {
-                            elements.clone()
+                            elements.to_vec()
                         } else {
                             Vec::new()
                         }
@@ -5053,7 +5273,7 @@ impl BytecodeVM {
 
                 let elements_to_add: Vec<JsValue> = match &src_val {
                     JsValue::Object(obj_ref) => {
-                        if let Some(elems) = obj_ref.borrow().array_elements() {
+                        if let Some(elems) = obj_ref.borrow().array_storage() {
                             elems.to_vec()
                         } else {
                             // Try iterator protocol
@@ -5074,7 +5294,7 @@ impl BytecodeVM {
 
                 // Append elements to the destination array
                 if let JsValue::Object(dst_arr) = dst_val
-                    && let Some(existing) = dst_arr.borrow_mut().array_elements_mut()
+                    && let Some(existing) = dst_arr.borrow_mut().array_storage_mut()
                 {
                     existing.extend(elements_to_add);
                 }
@@ -5113,7 +5333,7 @@ impl BytecodeVM {
                             _ => start_index as usize,
                         };
 
-                        if let Some(elems) = arr_ref.borrow().array_elements() {
+                        if let Some(elems) = arr_ref.borrow().array_storage() {
                             for i in index..elems.len() {
                                 if let Some(val) = elems.get(i) {
                                     elements.push(val.clone());
@@ -5205,7 +5425,7 @@ impl BytecodeVM {
             // Template Literals
             // ═══════════════════════════════════════════════════════════════════════════
             Op::TemplateConcat { dst, start, count } => {
-                let mut result = String::new();
+                let mut result = JsString::from("");
                 let to_string_key = PropertyKey::String(interp.intern("toString"));
                 for i in 0..count {
                     let val = self.get_reg(start + i);
@@ -5234,9 +5454,9 @@ impl BytecodeVM {
                     } else {
                         interp.to_js_string(val)
                     };
-                    result.push_str(str_val.as_str());
+                    result = result.concat(&str_val);
                 }
-                self.set_reg(dst, JsValue::String(JsString::from(result)));
+                self.set_reg(dst, JsValue::String(result));
                 Ok(OpResult::Continue)
             }
 
@@ -5712,9 +5932,244 @@ impl BytecodeVM {
 
                 Ok(OpResult::Continue)
             }
+
+            // ═══════════════════════════════════════════════════════════════════════════
+            // Superinstructions
+            // ═══════════════════════════════════════════════════════════════════════════
+            // `ip` points at the second instruction of the fused pair on entry
+            Op::LtJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = self.get_reg(left).to_number() < self.get_reg(right).to_number();
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::LtEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = self.get_reg(left).to_number() <= self.get_reg(right).to_number();
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::GtJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = self.get_reg(left).to_number() > self.get_reg(right).to_number();
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::GtEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = self.get_reg(left).to_number() >= self.get_reg(right).to_number();
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::StrictEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = self.get_reg(left).strict_equals(self.get_reg(right));
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::StrictNotEqJumpIfFalse {
+                dst,
+                left,
+                right,
+                target,
+            } => {
+                let result = !self.get_reg(left).strict_equals(self.get_reg(right));
+                self.fused_jump_if_false(dst, result, target);
+                Ok(OpResult::Continue)
+            }
+
+            Op::LoadIntAdd {
+                dst,
+                left,
+                tmp,
+                value,
+            } => {
+                self.set_reg(tmp, JsValue::Number(value as f64));
+                self.ip += 1;
+                if let &JsValue::Number(n) = self.get_reg(left) {
+                    self.set_reg(dst, JsValue::Number(n + value as f64));
+                    return Ok(OpResult::Continue);
+                }
+                self.execute_op(
+                    interp,
+                    Op::Add {
+                        dst,
+                        left,
+                        right: tmp,
+                    },
+                )
+            }
+
+            Op::LoadIntSub {
+                dst,
+                left,
+                tmp,
+                value,
+            } => {
+                self.set_reg(tmp, JsValue::Number(value as f64));
+                self.ip += 1;
+                if let &JsValue::Number(n) = self.get_reg(left) {
+                    self.set_reg(dst, JsValue::Number(n - value as f64));
+                    return Ok(OpResult::Continue);
+                }
+                self.execute_op(
+                    interp,
+                    Op::Sub {
+                        dst,
+                        left,
+                        right: tmp,
+                    },
+                )
+            }
+
+            Op::GetPropertyConstCall {
+                dst,
+                obj,
+                key,
+                cache,
+                callee,
+                args_start,
+                argc,
+            } => {
+                // A failed lookup throws with `ip` still on the Call, so the
+                // error is attributed to the property access
+                let loaded = self.execute_op(
+                    interp,
+                    Op::GetPropertyConst {
+                        dst: callee,
+                        obj,
+                        key,
+                        cache,
+                    },
+                )?;
+                if !matches!(loaded, OpResult::Continue) {
+                    return Ok(loaded);
+                }
+                self.ip += 1;
+                self.execute_op(
+                    interp,
+                    Op::Call {
+                        dst,
+                        callee,
+                        this: obj,
+                        args_start,
+                        argc,
+                    },
+                )
+            }
         }
     }
 
+    /// Second half of a compare + `JumpIfFalse` superinstruction: store the
+    /// comparison, then skip the `JumpIfFalse` or take its jump
+    #[inline]
+    fn fused_jump_if_false(&mut self, dst: Register, result: bool, target: JumpTarget) {
+        self.set_reg(dst, JsValue::Boolean(result));
+        if result {
+            self.ip += 1;
+        } else {
+            self.ip = target as usize;
+        }
+    }
+
+    /// Generic `GetPropertyConst` after an inline cache miss; records the
+    /// lookup so the next execution of the site can hit
+    #[inline(never)]
+    fn get_property_const_miss(
+        &mut self,
+        interp: &mut Interpreter,
+        dst: Register,
+        obj_val: JsValue,
+        key: u16,
+        cache: CacheIndex,
+    ) -> Result<OpResult, JsError> {
+        interp.inline_cache_stats.misses += 1;
+
+        let key = self
+            .get_string_constant(key)
+            .ok_or_else(|| JsError::internal_error("Invalid property key constant"))?;
+        let key_val = JsValue::String(key);
+        let Guarded { value, .. } = self.get_property_value(interp, &obj_val, &key_val)?;
+        if let JsValue::Object(obj_ref) = &obj_val
+            && self.chunk.inline_caches.accepts(cache)
+        {
+            let prop_key = interp.property_key_from_value(&key_val);
+            if self
+                .chunk
+                .inline_caches
+                .record_get(cache, obj_ref, &prop_key)
+            {
+                interp.inline_cache_stats.megamorphic_sites += 1;
+            }
+        }
+        self.set_reg(dst, value);
+        Ok(OpResult::Continue)
+    }
+
+    /// Generic `SetPropertyConst` after an inline cache miss; records the
+    /// store (including any shape transition) for the site
+    #[inline(never)]
+    fn set_property_const_miss(
+        &mut self,
+        interp: &mut Interpreter,
+        obj_val: JsValue,
+        key: u16,
+        cache: CacheIndex,
+        val: JsValue,
+    ) -> Result<OpResult, JsError> {
+        interp.inline_cache_stats.misses += 1;
+
+        let key = self
+            .get_string_constant(key)
+            .ok_or_else(|| JsError::internal_error("Invalid property key constant"))?;
+        let key_val = JsValue::String(key);
+        let before = match &obj_val {
+            JsValue::Object(obj_ref) if self.chunk.inline_caches.accepts(cache) => {
+                obj_ref.borrow().properties.shape().cloned()
+            }
+            _ => None,
+        };
+        self.set_property_value(interp, &obj_val, &key_val, val)?;
+        if let JsValue::Object(obj_ref) = &obj_val
+            && self.chunk.inline_caches.accepts(cache)
+        {
+            let prop_key = interp.property_key_from_value(&key_val);
+            if self
+                .chunk
+                .inline_caches
+                .record_set(cache, obj_ref, &prop_key, before)
+            {
+                interp.inline_cache_stats.megamorphic_sites += 1;
+            }
+        }
+        Ok(OpResult::Continue)
+    }
+
     /// Get a property value from an object, invoking getters if present.
     /// Returns a Guarded to keep newly allocated objects alive (e.g., from getters or proxies).
     fn get_property_value(
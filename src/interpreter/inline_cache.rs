@@ -0,0 +1,364 @@
+//! Inline caches for constant-key property access
+//!
+//! Every `GetPropertyConst` and `SetPropertyConst` carries a cache index into
+//! its chunk's [`InlineCaches`]. A cache entry records the shape of the
+//! receiver, the shapes of the prototypes walked to reach the property, and
+//! the slot it was found in. A hit re-checks those shapes by pointer and reads
+//! the slot directly, skipping key hashing, descriptor cloning and the generic
+//! prototype walk. Method calls load their callee through `GetPropertyConst`,
+//! so prototype-chain entries are what make class method calls cheap.
+//!
+//! Each site remembers up to `MAX_POLYMORPHIC_ENTRIES` receiver shapes; a site
+//! that sees more becomes megamorphic and always takes the generic path.
+//! Only plain data properties are cached: accessors, proxies and keys answered
+//! from exotic state (array `length`, function `name`, ...) always miss.
+
+use crate::prelude::*;
+
+use crate::compiler::CacheIndex;
+use crate::value::{JsObject, JsObjectRef, JsValue, Property, PropertyKey, Shape};
+
+/// Receiver shapes remembered per site before it goes megamorphic
+const MAX_POLYMORPHIC_ENTRIES: usize = 4;
+
+/// Deepest prototype a cached property may live on (0 = own property)
+const MAX_CACHED_DEPTH: usize = 4;
+
+/// Inline cache counters for one interpreter
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct InlineCacheStats {
+    /// Property accesses answered from a cache entry
+    pub hits: u64,
+    /// Property accesses that took the generic lookup
+    pub misses: u64,
+    /// Sites that saw too many shapes and stopped caching
+    pub megamorphic_sites: u64,
+}
+
+/// Per-chunk inline cache storage, one slot per property access site
+#[derive(Default)]
+pub struct InlineCaches {
+    sites: RefCell<Vec<SiteCache>>,
+}
+
+/// State of one property access site
+enum SiteCache {
+    /// Never filled
+    Empty,
+    /// Layouts seen at this site, newest last
+    Shapes {
+        /// The site's key, needed to re-check exotic objects on a hit
+        key: PropertyKey,
+        entries: Vec<CacheEntry>,
+    },
+    /// Too many layouts; always use the generic lookup
+    Megamorphic,
+}
+
+/// Where a property was found for one receiver shape
+struct CacheEntry {
+    /// Shapes of the receiver and each prototype up to the holder
+    shapes: Box<[Rc<Shape>]>,
+    /// Slot of the property in the holder
+    slot: usize,
+    /// For stores that add the property: the receiver's shape afterwards.
+    /// `shapes` then covers the whole prototype chain, which proves no setter
+    /// or read-only property shadows the new key.
+    transition: Option<Rc<Shape>>,
+}
+
+impl InlineCaches {
+    /// Create `count` empty cache slots
+    pub fn new(count: usize) -> Self {
+        let mut sites = Vec::with_capacity(count);
+        sites.resize_with(count, || SiteCache::Empty);
+        Self {
+            sites: RefCell::new(sites),
+        }
+    }
+
+    fn len(&self) -> usize {
+        self.sites.borrow().len()
+    }
+
+    /// Read a data property through the cache. Returns None on a miss.
+    pub fn get(&self, site: CacheIndex, obj: &JsObjectRef) -> Option<JsValue> {
+        let sites = self.sites.borrow();
+        let SiteCache::Shapes { key, entries } = sites.get(site as usize)? else {
+            return None;
+        };
+        let receiver = obj.borrow();
+        let shape = receiver.properties.shape()?;
+        let entry = entries
+            .iter()
+            .rev()
+            .find(|e| e.shapes.first().is_some_and(|s| Rc::ptr_eq(s, shape)))?;
+        read_cached(&receiver, &entry.shapes, entry.slot, key)
+    }
+
+    /// Store a data property through the cache: either overwrite a writable
+    /// own property or add the key along a cached shape transition.
+    /// Returns the value back on a miss so the caller can take the generic path.
+    pub fn set(&self, site: CacheIndex, obj: &JsObjectRef, value: JsValue) -> Result<(), JsValue> {
+        let sites = self.sites.borrow();
+        let Some(SiteCache::Shapes { key, entries }) = sites.get(site as usize) else {
+            return Err(value);
+        };
+
+        // Validate with a shared borrow: the prototype walk may revisit `obj`
+        let hit = {
+            let receiver = obj.borrow();
+            match receiver.properties.shape() {
+                Some(shape) if !receiver.frozen && !receiver.exotic.intercepts_property(key) => {
+                    entries.iter().rev().find(|e| {
+                        e.shapes.first().is_some_and(|s| Rc::ptr_eq(s, shape))
+                            && match &e.transition {
+                                None => e.shapes.len() == 1,
+                                Some(_) => {
+                                    receiver.extensible
+                                        && !receiver.sealed
+                                        && chain_matches(
+                                            receiver.prototype.as_ref(),
+                                            e.shapes.get(1..).unwrap_or_default(),
+                                            key,
+                                        )
+                                }
+                            }
+                    })
+                }
+                _ => None,
+            }
+        };
+        let Some(entry) = hit else {
+            return Err(value);
+        };
+
+        let mut receiver = obj.borrow_mut();
+        match &entry.transition {
+            Some(next) => {
+                receiver
+                    .properties
+                    .push_transition(Rc::clone(next), Property::data(value));
+                Ok(())
+            }
+            None => match receiver.properties.slot_mut(entry.slot) {
+                Some(prop) if !prop.is_accessor() && prop.writable() => {
+                    prop.value = value;
+                    Ok(())
+                }
+                _ => Err(value),
+            },
+        }
+    }
+
+    /// Whether a miss at `site` should be recorded
+    pub fn accepts(&self, site: CacheIndex) -> bool {
+        matches!(
+            self.sites.borrow().get(site as usize),
+            Some(SiteCache::Empty | SiteCache::Shapes { .. })
+        )
+    }
+
+    /// Record where the generic lookup of `key` on `obj` found a data property.
+    /// Returns true if this made the site megamorphic.
+    pub fn record_get(&self, site: CacheIndex, obj: &JsObjectRef, key: &PropertyKey) -> bool {
+        if !cacheable_key(key) {
+            return false;
+        }
+        let mut shapes = Vec::new();
+        let Some(slot) = locate(&obj.borrow(), key, &mut shapes) else {
+            return false;
+        };
+        self.insert(
+            site,
+            key,
+            CacheEntry {
+                shapes: shapes.into_boxed_slice(),
+                slot,
+                transition: None,
+            },
+        )
+    }
+
+    /// Record the outcome of a generic store of `key` on `obj`, whose shape
+    /// was `before` the store. Returns true if this made the site megamorphic.
+    pub fn record_set(
+        &self,
+        site: CacheIndex,
+        obj: &JsObjectRef,
+        key: &PropertyKey,
+        before: Option<Rc<Shape>>,
+    ) -> bool {
+        if !cacheable_key(key) {
+            return false;
+        }
+        let entry = {
+            let receiver = obj.borrow();
+            let Some(shape) = receiver.properties.shape() else {
+                return false;
+            };
+            if receiver.exotic.intercepts_property(key) {
+                return false;
+            }
+            let Some(slot) = shape.lookup(key) else {
+                return false;
+            };
+            match before {
+                // The store added the key as the newest slot
+                Some(before) if !Rc::ptr_eq(&before, shape) => {
+                    if slot != before.len() || shape.len() != before.len() + 1 {
+                        return false;
+                    }
+                    let mut shapes = vec![before];
+                    if collect_chain(receiver.prototype.as_ref(), key, &mut shapes).is_none() {
+                        return false;
+                    }
+                    CacheEntry {
+                        shapes: shapes.into_boxed_slice(),
+                        slot,
+                        transition: Some(Rc::clone(shape)),
+                    }
+                }
+                _ => CacheEntry {
+                    shapes: vec![Rc::clone(shape)].into_boxed_slice(),
+                    slot,
+                    transition: None,
+                },
+            }
+        };
+        self.insert(site, key, entry)
+    }
+
+    fn insert(&self, site: CacheIndex, key: &PropertyKey, entry: CacheEntry) -> bool {
+        let mut sites = self.sites.borrow_mut();
+        let Some(cache) = sites.get_mut(site as usize) else {
+            return false;
+        };
+        match cache {
+            SiteCache::Empty => {
+                *cache = SiteCache::Shapes {
+                    key: key.clone(),
+                    entries: vec![entry],
+                };
+                false
+            }
+            SiteCache::Shapes { entries, .. } => {
+                // A stale entry for the same receiver shape (e.g. the prototype
+                // changed) is replaced rather than counted as a new layout
+                entries.retain(|e| !same_receiver(e, &entry));
+                if entries.len() < MAX_POLYMORPHIC_ENTRIES {
+                    entries.push(entry);
+                    false
+                } else {
+                    *cache = SiteCache::Megamorphic;
+                    true
+                }
+            }
+            SiteCache::Megamorphic => false,
+        }
+    }
+}
+
+impl Clone for InlineCaches {
+    /// Clones start cold; cached shapes belong to the original's call sites
+    fn clone(&self) -> Self {
+        Self::new(self.len())
+    }
+}
+
+impl fmt::Debug for InlineCaches {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("InlineCaches")
+            .field("sites", &self.len())
+            .finish()
+    }
+}
+
+/// `__proto__` is resolved by the VM before any property lookup
+fn cacheable_key(key: &PropertyKey) -> bool {
+    !matches!(key, PropertyKey::String(s) if s.as_str() == "__proto__")
+}
+
+fn same_receiver(a: &CacheEntry, b: &CacheEntry) -> bool {
+    match (a.shapes.first(), b.shapes.first()) {
+        (Some(x), Some(y)) => Rc::ptr_eq(x, y),
+        _ => false,
+    }
+}
+
+/// Follow a cache entry from `obj`, checking each object's shape on the way
+fn read_cached(
+    obj: &JsObject,
+    shapes: &[Rc<Shape>],
+    slot: usize,
+    key: &PropertyKey,
+) -> Option<JsValue> {
+    let (expected, rest) = shapes.split_first()?;
+    let shape = obj.properties.shape()?;
+    if !Rc::ptr_eq(shape, expected) || obj.exotic.intercepts_property(key) {
+        return None;
+    }
+    if rest.is_empty() {
+        return obj
+            .properties
+            .slot(slot)
+            .filter(|prop| !prop.is_accessor())
+            .map(|prop| prop.value.clone());
+    }
+    read_cached(&obj.prototype.as_ref()?.borrow(), rest, slot, key)
+}
+
+/// Find the slot of a data property, collecting the shapes walked to reach it.
+/// Returns None for anything the cache cannot represent.
+fn locate(obj: &JsObject, key: &PropertyKey, shapes: &mut Vec<Rc<Shape>>) -> Option<usize> {
+    if shapes.len() > MAX_CACHED_DEPTH || obj.exotic.intercepts_property(key) {
+        return None;
+    }
+    let shape = obj.properties.shape()?;
+    shapes.push(Rc::clone(shape));
+    match shape.lookup(key) {
+        Some(slot) => obj
+            .properties
+            .slot(slot)
+            .filter(|prop| !prop.is_accessor())
+            .map(|_| slot),
+        None => locate(&obj.prototype.as_ref()?.borrow(), key, shapes),
+    }
+}
+
+/// Collect the shapes of a whole prototype chain that lacks `key`
+fn collect_chain(
+    obj: Option<&JsObjectRef>,
+    key: &PropertyKey,
+    shapes: &mut Vec<Rc<Shape>>,
+) -> Option<()> {
+    let Some(obj) = obj else {
+        return Some(());
+    };
+    let obj = obj.borrow();
+    if shapes.len() > MAX_CACHED_DEPTH || obj.exotic.intercepts_property(key) {
+        return None;
+    }
+    let shape = obj.properties.shape()?;
+    if shape.lookup(key).is_some() {
+        return None;
+    }
+    shapes.push(Rc::clone(shape));
+    collect_chain(obj.prototype.as_ref(), key, shapes)
+}
+
+/// Check that a prototype chain still has exactly the recorded shapes
+fn chain_matches(obj: Option<&JsObjectRef>, shapes: &[Rc<Shape>], key: &PropertyKey) -> bool {
+    match (obj, shapes.split_first()) {
+        (None, None) => true,
+        (Some(obj), Some((expected, rest))) => {
+            let obj = obj.borrow();
+            obj.properties
+                .shape()
+                .is_some_and(|shape| Rc::ptr_eq(shape, expected))
+                && !obj.exotic.intercepts_property(key)
+                && chain_matches(obj.prototype.as_ref(), rest, key)
+        }
+        _ => false,
+    }
+}
@@ -8,6 +8,23 @@ pub mod builtins;
 // Bytecode virtual machine
 pub mod bytecode_vm;
 
+// Inline caches for property access sites
+pub(crate) mod inline_cache;
+
+// Sampling profiler for bytecode execution
+mod profiler;
+
+// Compiled-regex cache shared by RegExp objects
+mod regexp_cache;
+
+// Heap snapshots for fast interpreter creation
+mod snapshot;
+
+pub use inline_cache::InlineCacheStats;
+pub use profiler::{Profile, ProfileFunction, ProfileStack};
+pub use regexp_cache::{DEFAULT_REGEXP_CACHE_CAPACITY, RegExpCacheStats};
+pub use snapshot::InterpreterSnapshot;
+
 use crate::prelude::*;
 
 // Platform provider imports based on target/features
@@ -25,16 +42,16 @@ use crate::platform::NoOpRegExpProvider;
 use crate::platform::RegExpProvider;
 
 use crate::StepResult;
-use crate::ast::{ImportSpecifier, Program, Statement};
 use crate::error::JsError;
 use crate::gc::{Gc, Guard, Heap};
 use crate::parser::Parser;
 use crate::string_dict::StringDict;
 use crate::value::{
-    Binding, BytecodeFunction, BytecodeGeneratorState, CheapClone, EnvRef, EnvironmentData,
-    ExoticObject, GeneratorStatus, Guarded, ImportBinding, JsFunction, JsObject, JsString,
-    JsSymbol, JsValue, ModuleExport, NativeFn, NativeFunction, PromiseStatus, Property,
-    PropertyKey, VarKey, create_environment_unrooted, create_environment_unrooted_with_capacity,
+    ArrayElements, Binding, ByteStore, BytecodeFunction, BytecodeGeneratorState, CheapClone,
+    DataViewData, EnvRef, EnvironmentData, ExoticObject, GeneratorStatus, Guarded, ImportBinding,
+    JsFunction, JsObject, JsString, JsSymbol, JsValue, ModuleExport, NativeFn, NativeFunction,
+    PromiseStatus, Property, PropertyKey, TypedArrayData, TypedArrayKind, VarKey,
+    create_environment_unrooted,
 };
 
 use self::builtins::symbol::WellKnownSymbols;
@@ -44,8 +61,8 @@ use self::builtins::symbol::WellKnownSymbols;
 /// A stack frame for tracking call stack
 #[derive(Debug, Clone)]
 pub struct StackFrame {
-    /// Function name (or "<anonymous>" for anonymous functions)
-    pub function_name: String,
+    /// Function name (None for anonymous functions)
+    pub function_name: Option<JsString>,
     /// Source location if available
     pub location: Option<(u32, u32)>, // (line, column)
 }
@@ -210,6 +227,15 @@ pub struct Interpreter {
     /// Generator.prototype (for generator methods)
     pub generator_prototype: Gc<JsObject>,
 
+    /// ArrayBuffer.prototype
+    pub array_buffer_prototype: Gc<JsObject>,
+
+    /// DataView.prototype
+    pub data_view_prototype: Gc<JsObject>,
+
+    /// Int8Array.prototype, Uint8Array.prototype, ... in `TypedArrayKind::ALL` order
+    pub typed_array_prototypes: Vec<Gc<JsObject>>,
+
     // ═══════════════════════════════════════════════════════════════════════════
     // Error Prototypes (for creating proper error objects from JsError)
     // ═══════════════════════════════════════════════════════════════════════════
@@ -241,7 +267,8 @@ pub struct Interpreter {
     /// Counter for generating unique generator IDs
     next_generator_id: u64,
 
-    /// Counter for generating unique symbol IDs
+    /// Counter for generating unique symbol IDs (see `next_symbol_id`)
+    #[cfg(not(feature = "std"))]
     next_symbol_id: u64,
 
     /// Symbol registry for Symbol.for() / Symbol.keyFor()
@@ -282,6 +309,12 @@ pub struct Interpreter {
     /// Defaults to FancyRegexProvider when `regex` feature is enabled.
     regexp_provider: Rc<dyn RegExpProvider>,
 
+    /// Compiled regexes by (pattern, flags), in front of `regexp_provider`
+    regexp_cache: RefCell<regexp_cache::RegExpCache>,
+
+    /// Running profiling session, if any (see `start_profiler`)
+    pub(crate) profiler: Option<Box<profiler::Profiler>>,
+
     // ═══════════════════════════════════════════════════════════════════════════
     // Step-based Execution
     // ═══════════════════════════════════════════════════════════════════════════
@@ -357,11 +390,116 @@ pub struct Interpreter {
     // Program State
     // ═══════════════════════════════════════════════════════════════════════════
     /// Pending program waiting for imports to be provided
-    pub(crate) pending_program: Option<crate::ast::Program>,
+    pub(crate) pending_program: Option<crate::compiler::CompiledProgram>,
 
     /// Pending module sources waiting for their imports to be satisfied
-    /// Maps normalized path -> parsed program
-    pub(crate) pending_module_sources: FxHashMap<crate::ModulePath, crate::ast::Program>,
+    /// Maps normalized path -> compiled program
+    pub(crate) pending_module_sources:
+        FxHashMap<crate::ModulePath, crate::compiler::CompiledProgram>,
+
+    /// Hit/miss counters of the VM's property inline caches
+    pub(crate) inline_cache_stats: InlineCacheStats,
+
+    /// Whether source is parsed and compiled lazily (see `set_lazy_compilation`)
+    lazy_compilation: bool,
+
+    /// Deadline of the running `run_budget` call; nested runs check it too
+    run_deadline: Option<RunDeadline>,
+
+    /// Set when a nested run passed `run_deadline`; the script stops with an
+    /// error exception handlers cannot catch
+    pub(crate) deadline_exceeded: bool,
+}
+
+// Default platform providers - std takes priority, then no-op
+
+/// Instructions `run_budget` runs between clock reads
+pub(crate) const BUDGET_CHECK_INSTRUCTIONS: u64 = 1024;
+
+/// First id handed out by `Interpreter::next_symbol_id`; the well-known
+/// symbols take the ids below it
+const FIRST_SYMBOL_ID: u64 = 13;
+
+/// Wall-clock limit of one `run_budget` call
+struct RunDeadline {
+    #[cfg(feature = "std")]
+    at: std::time::Instant,
+    #[cfg(not(feature = "std"))]
+    timer: u64,
+    #[cfg(not(feature = "std"))]
+    millis: u64,
+}
+
+impl RunDeadline {
+    #[cfg(feature = "std")]
+    fn new(_interp: &Interpreter, timeout_ns: u64) -> Self {
+        Self {
+            at: std::time::Instant::now() + core::time::Duration::from_nanos(timeout_ns),
+        }
+    }
+
+    #[cfg(not(feature = "std"))]
+    fn new(interp: &Interpreter, timeout_ns: u64) -> Self {
+        Self {
+            timer: interp.time_provider.start_timer(),
+            millis: timeout_ns.div_ceil(1_000_000),
+        }
+    }
+
+    #[cfg(feature = "std")]
+    fn passed(&self, _interp: &Interpreter) -> bool {
+        std::time::Instant::now() >= self.at
+    }
+
+    #[cfg(not(feature = "std"))]
+    fn passed(&self, interp: &Interpreter) -> bool {
+        interp.time_provider.elapsed_millis(self.timer) >= self.millis
+    }
+}
+
+fn default_time_provider() -> Box<dyn TimeProvider> {
+    #[cfg(feature = "std")]
+    {
+        Box::new(StdTimeProvider::new())
+    }
+    #[cfg(not(feature = "std"))]
+    {
+        Box::new(NoOpTimeProvider)
+    }
+}
+
+fn default_random_provider() -> Box<dyn RandomProvider> {
+    #[cfg(feature = "std")]
+    {
+        Box::new(StdRandomProvider::new())
+    }
+    #[cfg(not(feature = "std"))]
+    {
+        Box::new(NoOpRandomProvider)
+    }
+}
+
+fn default_console_provider() -> Box<dyn ConsoleProvider> {
+    #[cfg(feature = "std")]
+    {
+        Box::new(StdConsoleProvider::new())
+    }
+    #[cfg(not(feature = "std"))]
+    {
+        Box::new(NoOpConsoleProvider)
+    }
+}
+
+// RegExp provider - regex feature takes priority, then no-op
+fn default_regexp_provider() -> Rc<dyn RegExpProvider> {
+    #[cfg(feature = "regex")]
+    {
+        Rc::new(FancyRegexProvider::new())
+    }
+    #[cfg(not(feature = "regex"))]
+    {
+        Rc::new(NoOpRegExpProvider)
+    }
 }
 
 impl Interpreter {
@@ -384,6 +522,14 @@ impl Interpreter {
         let symbol_prototype = root_guard.alloc();
         let promise_prototype = root_guard.alloc();
         let generator_prototype = root_guard.alloc();
+        let array_buffer_prototype = root_guard.alloc();
+        let data_view_prototype = root_guard.alloc();
+        // Each typed array prototype gets its parent (%TypedArray%.prototype)
+        // in init_typed_arrays
+        let typed_array_prototypes: Vec<Gc<JsObject>> = TypedArrayKind::ALL
+            .iter()
+            .map(|_| root_guard.alloc())
+            .collect();
 
         // Create error prototypes (all rooted)
         let error_prototype = root_guard.alloc();
@@ -405,6 +551,8 @@ impl Interpreter {
         symbol_prototype.borrow_mut().prototype = Some(object_prototype.clone());
         promise_prototype.borrow_mut().prototype = Some(object_prototype.clone());
         generator_prototype.borrow_mut().prototype = Some(object_prototype.clone());
+        array_buffer_prototype.borrow_mut().prototype = Some(object_prototype.clone());
+        data_view_prototype.borrow_mut().prototype = Some(object_prototype.clone());
 
         // Set up error prototype chain
         // Error.prototype inherits from Object.prototype
@@ -430,9 +578,10 @@ impl Interpreter {
         let string_dict = StringDict::new();
 
         // Initialize symbol counter and well-known symbols
-        // Well-known symbols get IDs 1-12, next_symbol_id starts at 13
+        // Well-known symbols get IDs 1-12, other symbols start at FIRST_SYMBOL_ID
         let mut symbol_counter = 1u64;
         let well_known_symbols = WellKnownSymbols::new(&mut symbol_counter);
+        debug_assert!(symbol_counter <= FIRST_SYMBOL_ID);
 
         let mut interp = Self {
             heap,
@@ -455,6 +604,9 @@ impl Interpreter {
             symbol_prototype,
             promise_prototype,
             generator_prototype,
+            array_buffer_prototype,
+            data_view_prototype,
+            typed_array_prototypes,
             error_prototype,
             type_error_prototype,
             reference_error_prototype,
@@ -463,7 +615,8 @@ impl Interpreter {
             exports: FxHashMap::default(),
             call_stack: Vec::new(),
             next_generator_id: 1,
-            next_symbol_id: symbol_counter,
+            #[cfg(not(feature = "std"))]
+            next_symbol_id: FIRST_SYMBOL_ID,
             symbol_registry: FxHashMap::default(),
             well_known_symbols,
             console_timers: FxHashMap::default(),
@@ -471,24 +624,15 @@ impl Interpreter {
             current_ffi_id: 0,
             #[cfg(feature = "c-api")]
             ffi_context: core::ptr::null_mut(),
-            // Platform providers - std takes priority, then wasm, then no-op
-            #[cfg(feature = "std")]
-            time_provider: Box::new(StdTimeProvider::new()),
-            #[cfg(not(feature = "std"))]
-            time_provider: Box::new(NoOpTimeProvider),
-            #[cfg(feature = "std")]
-            random_provider: Box::new(StdRandomProvider::new()),
-            #[cfg(not(feature = "std"))]
-            random_provider: Box::new(NoOpRandomProvider),
-            #[cfg(feature = "std")]
-            console_provider: Box::new(StdConsoleProvider::new()),
-            #[cfg(not(feature = "std"))]
-            console_provider: Box::new(NoOpConsoleProvider),
-            // RegExp provider - regex feature takes priority, then no-op
-            #[cfg(feature = "regex")]
-            regexp_provider: Rc::new(FancyRegexProvider::new()),
-            #[cfg(not(feature = "regex"))]
-            regexp_provider: Rc::new(NoOpRegExpProvider),
+            // Platform providers
+            time_provider: default_time_provider(),
+            random_provider: default_random_provider(),
+            console_provider: default_console_provider(),
+            regexp_provider: default_regexp_provider(),
+            regexp_cache: RefCell::new(regexp_cache::RegExpCache::new(
+                DEFAULT_REGEXP_CACHE_CAPACITY,
+            )),
+            profiler: None,
             // Step-based execution
             active_vm: None,
             active_module_path: None,
@@ -514,6 +658,10 @@ impl Interpreter {
             // Program state
             pending_program: None,
             pending_module_sources: FxHashMap::default(),
+            inline_cache_stats: InlineCacheStats::default(),
+            lazy_compilation: false,
+            run_deadline: None,
+            deadline_exceeded: false,
         };
 
         // Initialize built-in globals
@@ -551,8 +699,10 @@ impl Interpreter {
     ///
     /// Note: This only affects newly compiled regexes. Already-cached compiled
     /// regexes in existing RegExp objects will continue to use the old provider.
+    /// The shared compiled-regex cache is cleared.
     pub fn set_regexp_provider(&mut self, provider: Rc<dyn RegExpProvider>) {
         self.regexp_provider = provider;
+        self.regexp_cache.borrow_mut().clear();
     }
 
     /// Set the console provider at runtime.
@@ -581,15 +731,38 @@ impl Interpreter {
 
     /// Compile a regex pattern using the configured RegExp provider.
     ///
-    /// This is a convenience method that wraps the provider's compile method.
+    /// Results are shared through a per-interpreter LRU cache keyed by
+    /// `(pattern, flags)`, so the provider only sees each pattern once while
+    /// it stays cached. Compile errors are not cached.
     pub fn compile_regexp(
         &self,
         pattern: &str,
         flags: &str,
     ) -> Result<Rc<dyn crate::platform::CompiledRegex>, JsError> {
-        self.regexp_provider
+        if let Some(regex) = self.regexp_cache.borrow_mut().get(pattern, flags) {
+            return Ok(regex);
+        }
+        let regex = self
+            .regexp_provider
             .compile(pattern, flags)
-            .map_err(|e| JsError::syntax_error(e, 0, 0))
+            .map_err(|e| JsError::syntax_error(e, 0, 0))?;
+        self.regexp_cache
+            .borrow_mut()
+            .insert(pattern, flags, regex.clone());
+        Ok(regex)
+    }
+
+    /// Set how many compiled regexes the shared cache keeps (0 = no caching).
+    ///
+    /// Defaults to [`DEFAULT_REGEXP_CACHE_CAPACITY`]. Shrinking drops the
+    /// least recently used patterns.
+    pub fn set_regexp_cache_capacity(&self, capacity: usize) {
+        self.regexp_cache.borrow_mut().set_capacity(capacity);
+    }
+
+    /// Get compiled-regex cache statistics
+    pub fn regexp_cache_stats(&self) -> RegExpCacheStats {
+        self.regexp_cache.borrow().stats()
     }
 
     /// Initialize built-in global values
@@ -646,6 +819,9 @@ impl Interpreter {
         // Initialize Date constructor and prototype
         builtins::init_date(self);
 
+        // Initialize ArrayBuffer, the typed array constructors and DataView
+        builtins::init_typed_arrays(self);
+
         // Initialize Symbol constructor and prototype
         builtins::init_symbol(self);
 
@@ -713,7 +889,7 @@ impl Interpreter {
 
         // Apply custom regexp provider if specified
         if let Some(provider) = config.regexp_provider {
-            interp.regexp_provider = provider;
+            interp.set_regexp_provider(provider);
         }
 
         // Register internal modules
@@ -749,21 +925,104 @@ impl Interpreter {
         self.heap.set_gc_threshold(threshold);
     }
 
+    /// Collect incrementally, pausing at most `micros` microseconds per slice
+    /// (0 = stop-the-world collection, the default)
+    ///
+    /// A slice runs every `gc_threshold` allocations while a collection is in
+    /// progress, so large heaps no longer pause for a full mark-and-sweep.
+    pub fn set_gc_budget(&self, micros: u64) {
+        self.heap.set_gc_budget(micros);
+    }
+
+    /// Compile functions on their first call rather than up front (off by
+    /// default)
+    ///
+    /// Applies to source prepared or provided afterwards. Bodies of functions
+    /// outside other functions are only scanned for their end when parsed,
+    /// and every function body is compiled when the function is first
+    /// called, so code that is never called costs neither. In exchange,
+    /// syntax errors inside a function body other than invalid tokens are
+    /// reported when the function is first called, as a `SyntaxError`
+    /// thrown from the call. `compile_to_bytecode` compiles every body into
+    /// the blob and keeps such errors deferred the same way.
+    pub fn set_lazy_compilation(&mut self, lazy: bool) {
+        self.lazy_compilation = lazy;
+    }
+
+    /// Cap the heap at `max_objects` live GC objects (0 = unlimited, the
+    /// default)
+    ///
+    /// The limit counts objects (including arrays, functions, closures'
+    /// environments and promises), not bytes. An `ArrayBuffer`'s backing
+    /// store and the contents of strings live outside the GC heap and are
+    /// not counted, so a single large buffer or string passes it. When an
+    /// allocation cannot be satisfied under the limit even after a full
+    /// collection, the running script stops with a `RangeError: Object limit
+    /// exceeded` that `try`/`catch` cannot intercept.
+    pub fn set_object_limit(&self, max_objects: usize) {
+        self.heap.set_object_limit(max_objects);
+    }
+
+    /// Start sampling the call stack every `interval_ns` nanoseconds of
+    /// execution, replacing any running session
+    ///
+    /// The clock is read every 256 instructions; a read that finds several
+    /// intervals elapsed records the stack once per interval, so sample
+    /// counts stay proportional to time. An interval of 0 records one sample
+    /// per clock read, which counts instructions instead. With `count_opcodes`
+    /// every executed instruction is also counted by opcode, which slows
+    /// execution noticeably. See [`Profile`] for what is recorded.
+    pub fn start_profiler(&mut self, interval_ns: u64, count_opcodes: bool) {
+        let profiler = profiler::Profiler::new(self, interval_ns, count_opcodes);
+        self.profiler = Some(Box::new(profiler));
+    }
+
+    /// Stop the running profiling session and return what it recorded
+    pub fn stop_profiler(&mut self) -> Option<Profile> {
+        self.profiler.take().map(|profiler| profiler.finish())
+    }
+
     /// Force a garbage collection cycle
     pub fn collect(&self) {
         self.heap.collect();
     }
 
+    /// Collect garbage and return every fully empty chunk of GC slots to
+    /// the allocator, e.g. after a peak in memory use has passed
+    pub fn shrink_heap(&self) {
+        self.heap.shrink();
+    }
+
     /// Get GC statistics
     pub fn gc_stats(&self) -> crate::gc::GcStats {
         self.heap.stats()
     }
 
+    /// Get property inline cache statistics
+    pub fn inline_cache_stats(&self) -> InlineCacheStats {
+        self.inline_cache_stats
+    }
+
     // ═══════════════════════════════════════════════════════════════════════════
     // Symbol Management
     // ═══════════════════════════════════════════════════════════════════════════
 
     /// Generate a unique symbol ID
+    ///
+    /// Every interpreter on a thread shares one shape tree, which keys symbol
+    /// properties by id, so with `std` ids come from a process-wide counter:
+    /// separate interpreters, forks and snapshot instances never give two
+    /// different symbols the same id. Without `std` shapes are not shared
+    /// and a per-interpreter counter is enough.
+    #[cfg(feature = "std")]
+    pub fn next_symbol_id(&mut self) -> u64 {
+        static NEXT_SYMBOL_ID: core::sync::atomic::AtomicU64 =
+            core::sync::atomic::AtomicU64::new(FIRST_SYMBOL_ID);
+        NEXT_SYMBOL_ID.fetch_add(1, core::sync::atomic::Ordering::Relaxed)
+    }
+
+    /// Generate a unique symbol ID
+    #[cfg(not(feature = "std"))]
     pub fn next_symbol_id(&mut self) -> u64 {
         let id = self.next_symbol_id;
         self.next_symbol_id += 1;
@@ -886,7 +1145,6 @@ impl Interpreter {
         source: &str,
         module_path: Option<crate::ModulePath>,
     ) -> Result<StepResult, JsError> {
-        use crate::compiler::Compiler;
         use bytecode_vm::BytecodeVM;
 
         // Set main module path if this is the entry point
@@ -895,13 +1153,13 @@ impl Interpreter {
         }
         self.current_module_path = module_path.clone();
 
-        // Parse the source
-        let mut parser = Parser::new(source, &mut self.string_dict);
-        let program = parser.parse_program()?;
+        // Parse and compile the source
+        let program = self.compile_source(source, module_path.as_ref())?;
 
         // Collect all import requests with resolved paths
         // For main module, importer is None (we pass module_path for resolution but not as importer)
-        let imports = self.collect_import_requests_internal(&program, module_path.as_ref(), None);
+        let imports =
+            self.collect_import_requests_internal(&program.imports, module_path.as_ref(), None);
 
         // Filter to only missing imports and deduplicate
         let missing = self.filter_missing_imports(imports);
@@ -927,18 +1185,15 @@ impl Interpreter {
         };
 
         // All imports satisfied - set up import bindings first
-        self.setup_import_bindings(&program)?;
-
-        // Compile the program to bytecode
-        let chunk = if let Some(ref path) = module_path {
-            Compiler::compile_program_with_source(&program, path.as_str().to_string())?
-        } else {
-            Compiler::compile_program(&program)?
-        };
+        self.setup_import_bindings(&program.imports)?;
 
         // Run the bytecode VM
         let vm_guard = self.heap.create_guard();
-        let vm = BytecodeVM::with_guard(chunk, JsValue::Object(self.global.clone()), vm_guard);
+        let vm = BytecodeVM::with_guard(
+            program.chunk,
+            JsValue::Object(self.global.clone()),
+            vm_guard,
+        );
 
         let result = self.run_vm_to_completion(vm);
 
@@ -1122,6 +1377,17 @@ impl Interpreter {
     /// Call `prepare()` to set up execution before using `step()`.
     #[inline]
     pub fn step(&mut self) -> Result<StepResult, JsError> {
+        self.run_steps(1)
+    }
+
+    /// Execute up to `max_steps` bytecode instructions (at least one).
+    ///
+    /// Behaves like calling `step()` until it returns something other than
+    /// `StepResult::Continue`, but runs the instructions in the VM's inner
+    /// loop instead of re-entering the interpreter for each one. Returns
+    /// `StepResult::Continue` when the budget runs out first, so hosts can
+    /// still enforce time or step limits between calls.
+    pub fn run_steps(&mut self, max_steps: usize) -> Result<StepResult, JsError> {
         use bytecode_vm::{BytecodeVM, VmStepResult};
 
         // If there's no active VM, try to set one up from various sources
@@ -1257,7 +1523,7 @@ impl Interpreter {
             return Ok(StepResult::Done);
         };
 
-        let step_result = vm.step(self);
+        let step_result = vm.run_steps(self, max_steps.max(1));
 
         match step_result {
             VmStepResult::Continue => {
@@ -1267,7 +1533,20 @@ impl Interpreter {
             }
             VmStepResult::Terminal(vm_result) => {
                 // Terminal state - process and clear active execution state
-                let result = self.process_vm_result(*vm_result)?;
+                drop(vm);
+                // A builtin may have swallowed the deadline error of a nested
+                // run before the script finished
+                let result = if mem::take(&mut self.deadline_exceeded) {
+                    Err(bytecode_vm::time_limit_error())
+                } else {
+                    self.process_vm_result(*vm_result)
+                };
+                if self.heap.limit_exceeded() {
+                    // The stopped script's objects are unreachable now; a
+                    // collection lifts the limit unless the host holds them
+                    self.heap.collect();
+                }
+                let result = result?;
 
                 // If not suspended (i.e., actually complete), finalize
                 if matches!(result, crate::StepResult::Complete(_)) {
@@ -1279,6 +1558,70 @@ impl Interpreter {
         }
     }
 
+    /// Run until a non-`Continue` result, or until `max_instructions`
+    /// instructions have run or `timeout_ns` nanoseconds have passed
+    /// (0 = no limit for either).
+    ///
+    /// Returns `StepResult::Continue` when the budget runs out; calling again
+    /// resumes where execution stopped. The clock is read every
+    /// `BUDGET_CHECK_INSTRUCTIONS` instructions. Without `std` it comes from
+    /// the installed `TimeProvider` at millisecond resolution.
+    ///
+    /// Only instructions of the resumable top-level execution are counted.
+    /// A callback run from inside a builtin (such as an `Array.prototype.map`
+    /// callback, a getter or a `JSON.parse` reviver) and the body of an
+    /// imported module cannot be suspended, so they are checked against the
+    /// deadline alone: if the deadline passes while one runs, the script
+    /// stops with a `RangeError: Time limit exceeded` that `try`/`catch`
+    /// cannot intercept.
+    pub fn run_budget(
+        &mut self,
+        max_instructions: u64,
+        timeout_ns: u64,
+    ) -> Result<StepResult, JsError> {
+        self.run_deadline = (timeout_ns > 0).then(|| RunDeadline::new(self, timeout_ns));
+        let result = self.run_budget_slices(max_instructions);
+        self.run_deadline = None;
+        result
+    }
+
+    fn run_budget_slices(&mut self, max_instructions: u64) -> Result<StepResult, JsError> {
+        let mut remaining = if max_instructions == 0 {
+            u64::MAX
+        } else {
+            max_instructions
+        };
+
+        loop {
+            let slice = remaining.min(BUDGET_CHECK_INSTRUCTIONS);
+            match self.run_steps(slice as usize)? {
+                StepResult::Continue => {}
+                result => return Ok(result),
+            }
+            if max_instructions > 0 {
+                remaining -= slice;
+                if remaining == 0 {
+                    return Ok(StepResult::Continue);
+                }
+            }
+            if self.run_deadline_passed() {
+                return Ok(StepResult::Continue);
+            }
+        }
+    }
+
+    /// Whether a `run_budget` call with a deadline is running
+    pub(crate) fn has_run_deadline(&self) -> bool {
+        self.run_deadline.is_some()
+    }
+
+    /// Whether the running `run_budget` call's deadline has passed
+    pub(crate) fn run_deadline_passed(&self) -> bool {
+        self.run_deadline
+            .as_ref()
+            .is_some_and(|deadline| deadline.passed(self))
+    }
+
     /// Process a terminal VmResult and convert to StepResult
     fn process_vm_result(&mut self, result: bytecode_vm::VmResult) -> Result<StepResult, JsError> {
         use bytecode_vm::VmResult;
@@ -1373,7 +1716,28 @@ impl Interpreter {
         source: &str,
         module_path: Option<crate::ModulePath>,
     ) -> Result<StepResult, JsError> {
-        use crate::compiler::Compiler;
+        let program = self.compile_source(source, module_path.as_ref())?;
+        self.prepare_compiled(program, module_path)
+    }
+
+    /// Prepare serialized bytecode (from `compile_to_bytecode`) for step-based execution.
+    ///
+    /// Behaves like `prepare` but skips lexing, parsing and compilation.
+    pub fn prepare_bytecode(
+        &mut self,
+        bytes: &[u8],
+        module_path: Option<crate::ModulePath>,
+    ) -> Result<StepResult, JsError> {
+        let program = crate::compiler::CompiledProgram::from_bytes(bytes, &mut self.string_dict)?;
+        self.prepare_compiled(program, module_path)
+    }
+
+    /// Prepare an already compiled program for step-based execution.
+    pub fn prepare_compiled(
+        &mut self,
+        program: crate::compiler::CompiledProgram,
+        module_path: Option<crate::ModulePath>,
+    ) -> Result<StepResult, JsError> {
         use bytecode_vm::BytecodeVM;
 
         // Set main module path if this is the entry point
@@ -1382,12 +1746,9 @@ impl Interpreter {
         }
         self.current_module_path = module_path.clone();
 
-        // Parse the source
-        let mut parser = Parser::new(source, &mut self.string_dict);
-        let program = parser.parse_program()?;
-
         // Collect all import requests with resolved paths
-        let imports = self.collect_import_requests_internal(&program, module_path.as_ref(), None);
+        let imports =
+            self.collect_import_requests_internal(&program.imports, module_path.as_ref(), None);
 
         // Filter to only missing imports and deduplicate
         let missing = self.filter_missing_imports(imports);
@@ -1411,18 +1772,15 @@ impl Interpreter {
         };
 
         // All imports satisfied - set up import bindings first
-        self.setup_import_bindings(&program)?;
-
-        // Compile the program to bytecode
-        let chunk = if let Some(ref path) = module_path {
-            Compiler::compile_program_with_source(&program, path.as_str().to_string())?
-        } else {
-            Compiler::compile_program(&program)?
-        };
+        self.setup_import_bindings(&program.imports)?;
 
         // Create VM but don't run it
         let vm_guard = self.heap.create_guard();
-        let vm = BytecodeVM::with_guard(chunk, JsValue::Object(self.global.clone()), vm_guard);
+        let vm = BytecodeVM::with_guard(
+            program.chunk,
+            JsValue::Object(self.global.clone()),
+            vm_guard,
+        );
 
         // Store VM and state for step-based execution
         self.active_vm = Some(Box::new(vm));
@@ -1458,7 +1816,7 @@ impl Interpreter {
 
                 // Get the program to check its imports
                 if let Some(program) = self.pending_module_sources.get(module_path) {
-                    let imports = self.collect_import_requests(program, Some(module_path));
+                    let imports = self.collect_import_requests(&program.imports, Some(module_path));
                     // Check if all imports are LOADED (not just provided)
                     let missing_from_loaded = self.filter_missing_imports(imports.clone());
 
@@ -1497,15 +1855,15 @@ impl Interpreter {
     /// Set up VM from a pending program (called when imports have been provided)
     fn setup_vm_from_program(
         &mut self,
-        program: crate::ast::Program,
+        program: crate::compiler::CompiledProgram,
     ) -> Result<StepResult, JsError> {
-        use crate::compiler::Compiler;
         use bytecode_vm::BytecodeVM;
 
         let module_path = self.current_module_path.clone();
 
         // Collect all import requests with resolved paths
-        let imports = self.collect_import_requests_internal(&program, module_path.as_ref(), None);
+        let imports =
+            self.collect_import_requests_internal(&program.imports, module_path.as_ref(), None);
 
         // Check what the HOST still needs to provide (not in loaded_modules OR pending_module_sources)
         let unprovided = self.filter_unprovided_imports(imports.clone());
@@ -1548,18 +1906,15 @@ impl Interpreter {
         };
 
         // All imports satisfied - set up import bindings first
-        self.setup_import_bindings(&program)?;
-
-        // Compile the program to bytecode
-        let chunk = if let Some(ref path) = module_path {
-            Compiler::compile_program_with_source(&program, path.as_str().to_string())?
-        } else {
-            Compiler::compile_program(&program)?
-        };
+        self.setup_import_bindings(&program.imports)?;
 
         // Create VM
         let vm_guard = self.heap.create_guard();
-        let vm = BytecodeVM::with_guard(chunk, JsValue::Object(self.global.clone()), vm_guard);
+        let vm = BytecodeVM::with_guard(
+            program.chunk,
+            JsValue::Object(self.global.clone()),
+            vm_guard,
+        );
 
         // Store VM and state for step-based execution
         self.active_vm = Some(Box::new(vm));
@@ -1585,6 +1940,12 @@ impl Interpreter {
                     let obj_ref = obj.borrow();
                     let name_val = obj_ref.get_property(&name_key);
                     let message_val = obj_ref.get_property(&message_key);
+                    // Resolve the error's recorded call sites now that it
+                    // leaves the interpreter
+                    let stack = match &obj_ref.exotic {
+                        ExoticObject::Error(data) => data.frames(),
+                        _ => Vec::new(),
+                    };
                     drop(obj_ref);
 
                     let name = name_val
@@ -1596,7 +1957,7 @@ impl Interpreter {
                     JsError::RuntimeError {
                         kind: name,
                         message,
-                        stack: Vec::new(),
+                        stack,
                     }
                 } else {
                     // Non-object thrown value - convert to string
@@ -1616,71 +1977,115 @@ impl Interpreter {
     /// Provide a module source for a pending import.
     ///
     /// The `resolved_path` should be the normalized path from `ImportRequest.resolved_path`.
-    /// The module is parsed and stored, but not executed until `continue_eval` is called.
+    /// The module is compiled and stored, but not executed until `continue_eval` is called.
     /// This allows collecting all needed imports before execution.
     pub fn provide_module(
         &mut self,
         resolved_path: crate::ModulePath,
         source: &str,
     ) -> Result<(), JsError> {
-        // Parse the module
-        let mut parser = Parser::new(source, &mut self.string_dict);
-        let program = parser.parse_program()?;
+        let program = self.compile_source(source, Some(&resolved_path))?;
+        self.provide_compiled_module(resolved_path, program);
+        Ok(())
+    }
+
+    /// Provide serialized bytecode (from `compile_to_bytecode`) for a pending import.
+    pub fn provide_module_bytecode(
+        &mut self,
+        resolved_path: crate::ModulePath,
+        bytes: &[u8],
+    ) -> Result<(), JsError> {
+        let program = crate::compiler::CompiledProgram::from_bytes(bytes, &mut self.string_dict)?;
+        self.provide_compiled_module(resolved_path, program);
+        Ok(())
+    }
 
-        // Store the parsed program for later execution
+    /// Provide an already compiled program for a pending import.
+    pub fn provide_compiled_module(
+        &mut self,
+        resolved_path: crate::ModulePath,
+        program: crate::compiler::CompiledProgram,
+    ) {
         self.pending_module_sources.insert(resolved_path, program);
+    }
 
-        Ok(())
+    /// Compile source to a serialized bytecode blob.
+    ///
+    /// `module_path` is recorded as the source file for stack traces and should
+    /// match the path later passed to `prepare_bytecode` or `provide_module_bytecode`.
+    /// Blobs are only loadable by the same tsrun version.
+    pub fn compile_to_bytecode(
+        &mut self,
+        source: &str,
+        module_path: Option<&crate::ModulePath>,
+    ) -> Result<Vec<u8>, JsError> {
+        self.compile_source(source, module_path)?.to_bytes()
+    }
+
+    /// Parse and compile source, recording `module_path` as the source file
+    fn compile_source(
+        &mut self,
+        source: &str,
+        module_path: Option<&crate::ModulePath>,
+    ) -> Result<crate::compiler::CompiledProgram, JsError> {
+        let source_file = module_path.map(|path| path.as_str().to_string());
+        if self.lazy_compilation {
+            let source: Rc<str> = Rc::from(source);
+            let program = Parser::new_lazy(&source, &mut self.string_dict).parse_program()?;
+            return crate::compiler::CompiledProgram::compile_lazy(&program, source_file);
+        }
+        let mut parser = Parser::new(source, &mut self.string_dict);
+        let program = parser.parse_program()?;
+        crate::compiler::CompiledProgram::compile(&program, source_file)
     }
 
     /// Set up import bindings for a program before bytecode execution.
     /// This resolves all imports and creates bindings in the current environment
     /// so that the bytecode can reference imported values.
-    fn setup_import_bindings(&mut self, program: &Program) -> Result<(), JsError> {
-        for stmt in program.body.iter() {
-            if let Statement::Import(import) = stmt {
-                // Skip type-only imports
-                if import.type_only {
-                    continue;
-                }
+    fn setup_import_bindings(
+        &mut self,
+        imports: &[crate::compiler::ImportDecl],
+    ) -> Result<(), JsError> {
+        use crate::compiler::ImportBindingDecl;
 
-                let specifier = import.source.value.to_string();
-
-                // Resolve the module
-                let module_obj = self.resolve_module(&specifier)?;
-
-                // Set up bindings for each import specifier
-                for spec in &import.specifiers {
-                    match spec {
-                        ImportSpecifier::Named {
-                            local, imported, ..
-                        } => {
-                            // import { foo as bar } from "mod" -> bar binds to mod.foo
-                            let property_key = PropertyKey::String(imported.name.cheap_clone());
-                            self.env_define_import(
-                                local.name.cheap_clone(),
-                                module_obj.cheap_clone(),
-                                property_key,
-                            );
-                        }
-                        ImportSpecifier::Default { local, .. } => {
-                            // import foo from "mod" -> foo binds to mod.default
-                            let property_key = PropertyKey::String(self.intern("default"));
-                            self.env_define_import(
-                                local.name.cheap_clone(),
-                                module_obj.cheap_clone(),
-                                property_key,
-                            );
-                        }
-                        ImportSpecifier::Namespace { local, .. } => {
-                            // import * as foo from "mod" -> foo binds to the entire module object
-                            // For namespace imports, we define a regular binding to the module object
-                            self.env_define(
-                                local.name.cheap_clone(),
-                                JsValue::Object(module_obj.cheap_clone()),
-                                false, // immutable
-                            );
-                        }
+        for import in imports {
+            // Skip re-exports and type-only imports
+            if !import.resolve {
+                continue;
+            }
+
+            // Resolve the module
+            let module_obj = self.resolve_module(import.specifier.as_str())?;
+
+            // Set up bindings for each import specifier
+            for binding in &import.bindings {
+                match binding {
+                    ImportBindingDecl::Named { local, imported } => {
+                        // import { foo as bar } from "mod" -> bar binds to mod.foo
+                        let property_key = PropertyKey::String(imported.cheap_clone());
+                        self.env_define_import(
+                            local.cheap_clone(),
+                            module_obj.cheap_clone(),
+                            property_key,
+                        );
+                    }
+                    ImportBindingDecl::Default { local } => {
+                        // import foo from "mod" -> foo binds to mod.default
+                        let property_key = PropertyKey::String(self.intern("default"));
+                        self.env_define_import(
+                            local.cheap_clone(),
+                            module_obj.cheap_clone(),
+                            property_key,
+                        );
+                    }
+                    ImportBindingDecl::Namespace { local } => {
+                        // import * as foo from "mod" -> foo binds to the entire module object
+                        // For namespace imports, we define a regular binding to the module object
+                        self.env_define(
+                            local.cheap_clone(),
+                            JsValue::Object(module_obj.cheap_clone()),
+                            false, // immutable
+                        );
                     }
                 }
             }
@@ -1711,16 +2116,17 @@ impl Interpreter {
         self.env = module_env.cheap_clone();
 
         // Set up import bindings before bytecode execution
-        self.setup_import_bindings(&program)?;
+        self.setup_import_bindings(&program.imports)?;
 
-        // Execute module using bytecode compilation
-        let result = self.execute_program_bytecode(&program);
+        // Execute the precompiled module body
+        let result = self.run_bytecode(program.chunk).map(|_| ());
 
         // Restore state
         self.env = saved_env;
         self.current_module_path = saved_module_path;
 
-        result?;
+        // The error leaves the interpreter like the main program's do
+        result.map_err(|e| self.materialize_thrown_error(e))?;
 
         // Create module namespace object from exports
         let guard = self.heap.create_guard();
@@ -1888,10 +2294,10 @@ impl Interpreter {
     /// For main module imports, use `collect_import_requests_internal` instead.
     fn collect_import_requests(
         &self,
-        program: &Program,
+        imports: &[crate::compiler::ImportDecl],
         module_path: Option<&crate::ModulePath>,
     ) -> Vec<crate::ImportRequest> {
-        self.collect_import_requests_internal(program, module_path, module_path)
+        self.collect_import_requests_internal(imports, module_path, module_path)
     }
 
     /// Collect all import requests from a program with separate resolution base and importer.
@@ -1900,35 +2306,22 @@ impl Interpreter {
     /// - `importer`: Stored in ImportRequest.importer (None for main module)
     fn collect_import_requests_internal(
         &self,
-        program: &Program,
+        imports: &[crate::compiler::ImportDecl],
         resolve_base: Option<&crate::ModulePath>,
         importer: Option<&crate::ModulePath>,
     ) -> Vec<crate::ImportRequest> {
-        use crate::ast::Statement;
-
-        let mut imports = Vec::new();
-
-        for stmt in program.body.iter() {
-            let specifier = match stmt {
-                Statement::Import(import) => Some(import.source.value.to_string()),
-                Statement::Export(export) => {
-                    // Re-export from another module: export { foo } from "./bar"
-                    export.source.as_ref().map(|s| s.value.to_string())
-                }
-                _ => None,
-            };
-
-            if let Some(spec) = specifier {
+        imports
+            .iter()
+            .map(|import| {
+                let spec = import.specifier.to_string();
                 let resolved = crate::ModulePath::resolve(&spec, resolve_base);
-                imports.push(crate::ImportRequest {
+                crate::ImportRequest {
                     specifier: spec,
                     resolved_path: resolved,
                     importer: importer.cloned(),
-                });
-            }
-        }
-
-        imports
+                }
+            })
+            .collect()
     }
 
     /// Filter import requests to only those that are missing (not internal, not already loaded).
@@ -2137,11 +2530,16 @@ impl Interpreter {
     /// let processor = interp.get_export("processor");
     /// ```
     pub fn get_export(&self, name: &str) -> Option<JsValue> {
-        // Get the main module path
         let main_path = self.main_module_path.as_ref()?;
+        self.get_module_export(main_path, name)
+    }
 
-        // Get the module namespace object
-        let module_obj = self.loaded_modules.get(main_path)?;
+    /// Get an exported value from any loaded module by its resolved path.
+    ///
+    /// Like `get_export`, but not limited to the main module. Returns `None`
+    /// if the module has not been loaded or the export doesn't exist.
+    pub fn get_module_export(&self, path: &crate::ModulePath, name: &str) -> Option<JsValue> {
+        let module_obj = self.loaded_modules.get(path)?;
 
         // Resolve the property (handles live bindings)
         let prop_key = PropertyKey::String(JsString::from(name));
@@ -2315,6 +2713,16 @@ impl Interpreter {
         &mut self,
         guard: &Guard<JsObject>,
         elements: Vec<JsValue>,
+    ) -> Gc<JsObject> {
+        self.create_array_with_elements(guard, ArrayElements::from_values(elements))
+    }
+
+    /// Create an array object over already-built element storage.
+    /// Caller provides the guard to control object lifetime.
+    pub fn create_array_with_elements(
+        &mut self,
+        guard: &Guard<JsObject>,
+        elements: ArrayElements,
     ) -> Gc<JsObject> {
         let arr = guard.alloc();
         {
@@ -2325,6 +2733,92 @@ impl Interpreter {
         arr
     }
 
+    /// Create an ArrayBuffer object over `store`.
+    /// Caller provides the guard to control object lifetime.
+    pub fn create_array_buffer(
+        &mut self,
+        guard: &Guard<JsObject>,
+        store: Rc<ByteStore>,
+    ) -> Gc<JsObject> {
+        let buffer = guard.alloc();
+        {
+            let mut buffer_ref = buffer.borrow_mut();
+            buffer_ref.prototype = Some(self.array_buffer_prototype.cheap_clone());
+            buffer_ref.exotic = ExoticObject::ArrayBuffer(store);
+        }
+        buffer
+    }
+
+    /// Create a typed array of `length` elements viewing `store` (the bytes of
+    /// the ArrayBuffer `buffer`) from `byte_offset`. The range must lie within
+    /// the store. Caller provides the guard to control object lifetime.
+    pub fn create_typed_array(
+        &mut self,
+        guard: &Guard<JsObject>,
+        kind: TypedArrayKind,
+        buffer: Gc<JsObject>,
+        store: Rc<ByteStore>,
+        byte_offset: usize,
+        length: usize,
+    ) -> Gc<JsObject> {
+        let array = guard.alloc();
+        {
+            let mut array_ref = array.borrow_mut();
+            array_ref.prototype = self.typed_array_prototypes.get(kind.index()).cloned();
+            array_ref.exotic = ExoticObject::TypedArray(TypedArrayData {
+                kind,
+                buffer,
+                store,
+                byte_offset,
+                length,
+            });
+        }
+        array
+    }
+
+    /// Create a DataView over `byte_length` bytes of `store` (the bytes of the
+    /// ArrayBuffer `buffer`) from `byte_offset`. The range must lie within the
+    /// store. Caller provides the guard to control object lifetime.
+    pub fn create_data_view(
+        &mut self,
+        guard: &Guard<JsObject>,
+        buffer: Gc<JsObject>,
+        store: Rc<ByteStore>,
+        byte_offset: usize,
+        byte_length: usize,
+    ) -> Gc<JsObject> {
+        let view = guard.alloc();
+        {
+            let mut view_ref = view.borrow_mut();
+            view_ref.prototype = Some(self.data_view_prototype.cheap_clone());
+            view_ref.exotic = ExoticObject::DataView(DataViewData {
+                buffer,
+                store,
+                byte_offset,
+                byte_length,
+            });
+        }
+        view
+    }
+
+    /// Create a zero-filled typed array with its own new ArrayBuffer.
+    /// Caller provides the guard to control object lifetime.
+    ///
+    /// Fails with a RangeError if the buffer cannot be allocated.
+    pub fn create_typed_array_zeroed(
+        &mut self,
+        guard: &Guard<JsObject>,
+        kind: TypedArrayKind,
+        length: usize,
+    ) -> Result<Gc<JsObject>, JsError> {
+        let byte_length = length
+            .checked_mul(kind.element_size())
+            .ok_or_else(|| JsError::range_error("Array buffer allocation failed"))?;
+        let store = ByteStore::zeroed(byte_length)?;
+        let buffer = self.create_array_buffer(guard, store.cheap_clone());
+        Ok(self.create_typed_array(guard, kind, buffer, store, 0, length))
+    }
+
     /// Create a new empty array with `array_prototype`.
     /// Caller provides the guard to control object lifetime.
     pub fn create_empty_array(&mut self, guard: &Guard<JsObject>) -> Gc<JsObject> {
@@ -2597,7 +3091,7 @@ impl Interpreter {
                     ExoticObject::Array { elements } => {
                         let strings: Vec<String> = elements
                             .iter()
-                            .map(|v| match v {
+                            .map(|v| match &v {
                                 JsValue::Null | JsValue::Undefined => String::new(),
                                 JsValue::String(s) => s.to_string(),
                                 JsValue::Number(n) => crate::value::number_to_string(*n),
@@ -3302,23 +3796,6 @@ impl Interpreter {
         Ok(result.value)
     }
 
-    /// Execute a program (AST) using bytecode compilation
-    fn execute_program_bytecode(
-        &mut self,
-        program: &crate::ast::Program,
-    ) -> Result<JsValue, JsError> {
-        use crate::compiler::Compiler;
-
-        // Use current module path for source file in stack traces
-        let chunk = if let Some(ref path) = self.current_module_path {
-            Compiler::compile_program_with_source(program, path.as_str().to_string())?
-        } else {
-            Compiler::compile_program(program)?
-        };
-        let result = self.run_bytecode(chunk)?;
-        Ok(result.value)
-    }
-
     /// Execute a program (AST) for eval with proper completion value tracking
     pub fn execute_program_for_eval(
         &mut self,
@@ -3451,9 +3928,9 @@ impl Interpreter {
         _specifier: &str,
         source: &str,
     ) -> Result<Gc<JsObject>, JsError> {
-        // Parse the source
-        let mut parser = Parser::new(source, &mut self.string_dict);
-        let program = parser.parse_program()?;
+        // Parse and compile the source (current module path is used for stack traces)
+        let module_path = self.current_module_path.clone();
+        let program = self.compile_source(source, module_path.as_ref())?;
 
         // Save current environment and exports
         let saved_env = self.env.cheap_clone();
@@ -3466,10 +3943,10 @@ impl Interpreter {
         self.env = module_env.cheap_clone();
 
         // Set up import bindings before bytecode execution
-        self.setup_import_bindings(&program)?;
+        self.setup_import_bindings(&program.imports)?;
 
         // Execute the module body using bytecode
-        let result = self.execute_program_bytecode(&program);
+        let result = self.run_bytecode(program.chunk).map(|_| ());
 
         // Restore environment
         self.env = saved_env;
@@ -3819,7 +4296,8 @@ impl Interpreter {
                 ExoticObject::Function(f) => f.clone(),
                 _ => return Err(JsError::type_error("Not a function")),
             }
-        };
+        }
+        .with_compiled_body(&mut self.string_dict)?;
 
         match func {
             JsFunction::Native(native) => {
@@ -4014,10 +4492,7 @@ impl Interpreter {
         let func_info = bc_func.chunk.function_info.as_ref();
 
         // Push call stack frame for stack traces
-        let func_name = func_info
-            .and_then(|info| info.name.as_ref())
-            .map(|s| s.to_string())
-            .unwrap_or_else(|| "<anonymous>".to_string());
+        let func_name = func_info.and_then(|info| info.name.cheap_clone());
 
         self.call_stack.push(StackFrame {
             function_name: func_name,
@@ -4253,7 +4728,7 @@ impl Interpreter {
         // First check if it's a plain array - use fast path
         {
             let obj_ref = obj.borrow();
-            if let Some(elements) = obj_ref.array_elements() {
+            if let Some(elements) = obj_ref.array_storage() {
                 return Ok(Some(elements.to_vec()));
             }
         }
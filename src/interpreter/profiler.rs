@@ -0,0 +1,363 @@
+//! Sampling profiler for bytecode execution
+//!
+//! While a profiler is running, the VM's inner loop counts down instructions
+//! and reads the clock every `CLOCK_CHECK_INSTRUCTIONS` of them. When the
+//! sampling interval has passed, it records the current call stack: the
+//! trampoline frames plus the running chunk, one frame per function. A clock
+//! read that finds several intervals elapsed (a slow builtin, or an interval
+//! shorter than the check period) counts the stack once per interval, so
+//! sample counts stay proportional to time. Each
+//! chunk is mapped to a name and a source location through its
+//! `function_info`, `source_file` and `source_map`.
+//!
+//! Opcode counting is optional and adds a hash-map update per instruction.
+//! When the profiler is stopped, the VM goes back to its unprofiled loop.
+//!
+//! A callback that a builtin runs synchronously (such as an
+//! `Array.prototype.map` callback) executes in a nested VM, so its samples
+//! start at the callback rather than at the script that called the builtin.
+
+use core::mem::Discriminant;
+
+use crate::compiler::{BytecodeChunk, Op};
+use crate::prelude::*;
+
+use super::Interpreter;
+use super::bytecode_vm::TrampolineFrame;
+
+/// Instructions between clock reads while profiling
+const CLOCK_CHECK_INSTRUCTIONS: u32 = 256;
+
+/// A function that appeared in at least one sample
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ProfileFunction {
+    /// Function name; `<anonymous>` for unnamed functions and `<top-level>`
+    /// for script and module bodies
+    pub name: String,
+    /// Source file, if the chunk has one
+    pub file: Option<String>,
+    /// Line of the function's first instruction (0 if unknown)
+    pub line: u32,
+    /// Samples taken while this function was running
+    pub self_samples: u64,
+    /// Samples taken while this function was anywhere on the stack
+    pub total_samples: u64,
+}
+
+/// One distinct call stack and how often it was sampled
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ProfileStack {
+    /// Indexes into `Profile::functions`, outermost caller first
+    pub frames: Vec<usize>,
+    /// Number of samples with exactly this stack
+    pub samples: u64,
+}
+
+/// Result of a profiling session
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct Profile {
+    /// Total number of samples taken
+    pub samples: u64,
+    /// Every function seen, most self samples first
+    pub functions: Vec<ProfileFunction>,
+    /// Every distinct stack seen, most samples first
+    pub stacks: Vec<ProfileStack>,
+    /// Instructions executed per opcode, most frequent first (empty unless
+    /// opcode counting was enabled)
+    pub opcode_counts: Vec<(String, u64)>,
+}
+
+impl Profile {
+    /// The stacks in folded format, one `outer;inner;leaf count` line per
+    /// stack, as read by `flamegraph.pl` and similar tools
+    pub fn folded(&self) -> String {
+        let mut out = String::new();
+        for stack in &self.stacks {
+            for (i, &index) in stack.frames.iter().enumerate() {
+                if i > 0 {
+                    out.push(';');
+                }
+                if let Some(function) = self.functions.get(index) {
+                    push_frame_label(&mut out, function);
+                }
+            }
+            out.push_str(&format!(" {}\n", stack.samples));
+        }
+        out
+    }
+}
+
+/// `name (file:line)`, with `;` (the folded frame separator) replaced
+fn push_frame_label(out: &mut String, function: &ProfileFunction) {
+    let label = match &function.file {
+        Some(file) => format!("{} ({}:{})", function.name, file, function.line),
+        None => format!("{} (:{})", function.name, function.line),
+    };
+    out.extend(label.chars().map(|c| if c == ';' { ':' } else { c }));
+}
+
+/// Wall clock for sampling intervals
+struct SampleClock {
+    #[cfg(feature = "std")]
+    last: std::time::Instant,
+    #[cfg(not(feature = "std"))]
+    timer: u64,
+}
+
+impl SampleClock {
+    #[cfg(feature = "std")]
+    fn new(_interp: &Interpreter) -> Self {
+        Self {
+            last: std::time::Instant::now(),
+        }
+    }
+
+    #[cfg(not(feature = "std"))]
+    fn new(interp: &Interpreter) -> Self {
+        Self {
+            timer: interp.time_provider.start_timer(),
+        }
+    }
+
+    /// How many whole `interval_ns` intervals have passed since the last
+    /// sample; advances the clock past them
+    #[cfg(feature = "std")]
+    fn intervals_passed(&mut self, _interp: &Interpreter, interval_ns: u64) -> u64 {
+        let elapsed = self.last.elapsed().as_nanos();
+        let intervals = elapsed / u128::from(interval_ns);
+        if intervals == 0 {
+            return 0;
+        }
+        // Keep the partial interval so it counts towards the next sample
+        let consumed = intervals.saturating_mul(u128::from(interval_ns));
+        self.last += std::time::Duration::from_nanos(u64::try_from(consumed).unwrap_or(u64::MAX));
+        u64::try_from(intervals).unwrap_or(u64::MAX)
+    }
+
+    /// The time provider only has millisecond resolution, so the partial
+    /// interval is dropped when the timer restarts
+    #[cfg(not(feature = "std"))]
+    fn intervals_passed(&mut self, interp: &Interpreter, interval_ns: u64) -> u64 {
+        let elapsed_ns = interp
+            .time_provider
+            .elapsed_millis(self.timer)
+            .saturating_mul(1_000_000);
+        let intervals = elapsed_ns / interval_ns;
+        if intervals > 0 {
+            self.timer = interp.time_provider.start_timer();
+        }
+        intervals
+    }
+}
+
+/// A running profiling session
+pub(crate) struct Profiler {
+    interval_ns: u64,
+    clock: SampleClock,
+    /// Instructions left until the next clock read
+    countdown: u32,
+    /// Sampled chunks; kept alive so their addresses stay unique
+    chunks: Vec<Rc<BytecodeChunk>>,
+    chunk_ids: FxHashMap<usize, usize>,
+    /// Samples per stack of chunk ids, outermost first
+    stacks: FxHashMap<Vec<usize>, u64>,
+    samples: u64,
+    /// Instruction counts per opcode, with one instance of the op for naming
+    opcode_counts: Option<FxHashMap<Discriminant<Op>, (Op, u64)>>,
+    /// Scratch stack reused between samples
+    scratch: Vec<usize>,
+}
+
+impl Profiler {
+    pub fn new(interp: &Interpreter, interval_ns: u64, count_opcodes: bool) -> Self {
+        Self {
+            interval_ns,
+            clock: SampleClock::new(interp),
+            countdown: CLOCK_CHECK_INSTRUCTIONS,
+            chunks: Vec::new(),
+            chunk_ids: FxHashMap::default(),
+            stacks: FxHashMap::default(),
+            samples: 0,
+            opcode_counts: count_opcodes.then(FxHashMap::default),
+            scratch: Vec::new(),
+        }
+    }
+
+    /// Count an instruction about to execute
+    #[inline]
+    pub fn count_op(&mut self, op: &Op) {
+        if let Some(counts) = &mut self.opcode_counts {
+            counts
+                .entry(core::mem::discriminant(op))
+                .or_insert((*op, 0))
+                .1 += 1;
+        }
+    }
+
+    /// Advance the instruction countdown. Returns true when a clock read is due.
+    #[inline]
+    pub fn tick(&mut self) -> bool {
+        self.countdown -= 1;
+        if self.countdown > 0 {
+            return false;
+        }
+        self.countdown = CLOCK_CHECK_INSTRUCTIONS;
+        true
+    }
+
+    /// Read the clock and record the given VM stack once for every interval
+    /// that has passed
+    pub fn maybe_sample(
+        interp: &mut Interpreter,
+        chunk: &Rc<BytecodeChunk>,
+        trampoline_stack: &[TrampolineFrame],
+    ) {
+        let Some(mut profiler) = interp.profiler.take() else {
+            return;
+        };
+        let intervals = match profiler.interval_ns {
+            0 => 1,
+            interval_ns => profiler.clock.intervals_passed(interp, interval_ns),
+        };
+        if intervals > 0 {
+            profiler.record(chunk, trampoline_stack, intervals);
+        }
+        interp.profiler = Some(profiler);
+    }
+
+    fn record(
+        &mut self,
+        chunk: &Rc<BytecodeChunk>,
+        trampoline_stack: &[TrampolineFrame],
+        samples: u64,
+    ) {
+        let mut stack = mem::take(&mut self.scratch);
+        stack.clear();
+        for frame in trampoline_stack {
+            let id = self.chunk_id(&frame.chunk);
+            stack.push(id);
+        }
+        let id = self.chunk_id(chunk);
+        stack.push(id);
+
+        self.samples += samples;
+        if let Some(count) = self.stacks.get_mut(&stack) {
+            *count += samples;
+            self.scratch = stack;
+        } else {
+            self.stacks.insert(stack, samples);
+        }
+    }
+
+    fn chunk_id(&mut self, chunk: &Rc<BytecodeChunk>) -> usize {
+        let key = Rc::as_ptr(chunk) as usize;
+        if let Some(&id) = self.chunk_ids.get(&key) {
+            return id;
+        }
+        let id = self.chunks.len();
+        self.chunks.push(chunk.clone());
+        self.chunk_ids.insert(key, id);
+        id
+    }
+
+    /// Summarize the session
+    pub fn finish(self) -> Profile {
+        let mut functions: Vec<ProfileFunction> = self
+            .chunks
+            .iter()
+            .map(|chunk| ProfileFunction {
+                name: match &chunk.function_info {
+                    Some(info) => info
+                        .name
+                        .as_ref()
+                        .map_or_else(|| String::from("<anonymous>"), |name| name.to_string()),
+                    None => String::from("<top-level>"),
+                },
+                file: chunk.source_file.clone(),
+                line: chunk.source_map.first().map_or(0, |entry| entry.span.line),
+                self_samples: 0,
+                total_samples: 0,
+            })
+            .collect();
+
+        let mut seen = Vec::new();
+        for (stack, &samples) in &self.stacks {
+            if let Some(function) = stack.last().and_then(|&id| functions.get_mut(id)) {
+                function.self_samples += samples;
+            }
+            // Recursion counts once towards a function's total
+            seen.clear();
+            for &id in stack {
+                if seen.contains(&id) {
+                    continue;
+                }
+                seen.push(id);
+                if let Some(function) = functions.get_mut(id) {
+                    function.total_samples += samples;
+                }
+            }
+        }
+
+        // Sort functions by self samples and renumber the stacks to match
+        let mut order: Vec<usize> = (0..functions.len()).collect();
+        order.sort_by_key(|&id| {
+            let function = functions.get(id);
+            (
+                core::cmp::Reverse(function.map_or(0, |f| f.self_samples)),
+                core::cmp::Reverse(function.map_or(0, |f| f.total_samples)),
+                id,
+            )
+        });
+        let mut new_index = vec![0; functions.len()];
+        for (new, &old) in order.iter().enumerate() {
+            if let Some(slot) = new_index.get_mut(old) {
+                *slot = new;
+            }
+        }
+        let functions: Vec<ProfileFunction> = order
+            .iter()
+            .filter_map(|&old| functions.get(old).cloned())
+            .collect();
+
+        let mut stacks: Vec<ProfileStack> = self
+            .stacks
+            .into_iter()
+            .map(|(frames, samples)| ProfileStack {
+                frames: frames
+                    .iter()
+                    .map(|&old| new_index.get(old).copied().unwrap_or(0))
+                    .collect(),
+                samples,
+            })
+            .collect();
+        stacks.sort_by(|a, b| {
+            b.samples
+                .cmp(&a.samples)
+                .then_with(|| a.frames.cmp(&b.frames))
+        });
+
+        let mut opcode_counts: Vec<(String, u64)> = self
+            .opcode_counts
+            .unwrap_or_default()
+            .into_values()
+            .map(|(op, count)| (opcode_name(&op), count))
+            .collect();
+        opcode_counts.sort_by(|a, b| b.1.cmp(&a.1).then_with(|| a.0.cmp(&b.0)));
+
+        Profile {
+            samples: self.samples,
+            functions,
+            stacks,
+            opcode_counts,
+        }
+    }
+}
+
+/// Variant name of an op, e.g. `GetPropertyConst`
+fn opcode_name(op: &Op) -> String {
+    let debug = format!("{:?}", op);
+    match debug.find([' ', '{', '(']) {
+        Some(end) => String::from(debug.get(..end).unwrap_or(&debug)),
+        None => debug,
+    }
+}
@@ -0,0 +1,116 @@
+//! Compiled-regex cache shared by all RegExp objects in an interpreter
+//!
+//! Every regex compile goes through [`Interpreter::compile_regexp`], which
+//! consults this cache first. It is keyed by `(pattern, flags)` and sits in
+//! front of whichever `RegExpProvider` is installed, so regex literals in hot
+//! functions and repeated `new RegExp(pattern)` calls compile once instead of
+//! once per RegExp object. Compiled regexes hold no match state (`lastIndex`
+//! lives on the RegExp object), so one can back any number of objects.
+//!
+//! Entries are kept in recency order, most recent last. Lookups scan from the
+//! newest end, which finds the hot patterns of a loop within a few compares;
+//! at the default capacity a linear scan is cheaper than hashing both keys.
+//!
+//! [`Interpreter::compile_regexp`]: super::Interpreter::compile_regexp
+
+use crate::platform::CompiledRegex;
+use crate::prelude::*;
+
+/// Patterns kept per interpreter unless configured otherwise
+pub const DEFAULT_REGEXP_CACHE_CAPACITY: usize = 64;
+
+/// Compiled-regex cache counters for one interpreter
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct RegExpCacheStats {
+    /// Compiles answered from the cache
+    pub hits: u64,
+    /// Compiles that went to the provider
+    pub misses: u64,
+    /// Patterns currently cached
+    pub entries: usize,
+    /// Maximum number of cached patterns (0 = caching disabled)
+    pub capacity: usize,
+}
+
+struct CacheEntry {
+    pattern: String,
+    flags: String,
+    regex: Rc<dyn CompiledRegex>,
+}
+
+/// Least-recently-used cache of compiled regexes
+pub(crate) struct RegExpCache {
+    /// Oldest first, most recently used last
+    entries: Vec<CacheEntry>,
+    capacity: usize,
+    hits: u64,
+    misses: u64,
+}
+
+impl RegExpCache {
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            entries: Vec::new(),
+            capacity,
+            hits: 0,
+            misses: 0,
+        }
+    }
+
+    /// Cached regex for `(pattern, flags)`, marking it most recently used.
+    /// Counts a hit or a miss.
+    pub fn get(&mut self, pattern: &str, flags: &str) -> Option<Rc<dyn CompiledRegex>> {
+        let found = self
+            .entries
+            .iter()
+            .rposition(|e| e.pattern == pattern && e.flags == flags);
+
+        let Some(index) = found else {
+            self.misses += 1;
+            return None;
+        };
+        self.hits += 1;
+
+        let entry = self.entries.remove(index);
+        let regex = entry.regex.clone();
+        self.entries.push(entry);
+        Some(regex)
+    }
+
+    /// Cache a freshly compiled regex, evicting the least recently used one
+    /// if the cache is full
+    pub fn insert(&mut self, pattern: &str, flags: &str, regex: Rc<dyn CompiledRegex>) {
+        if self.capacity == 0 {
+            return;
+        }
+        if self.entries.len() >= self.capacity {
+            self.entries.remove(0);
+        }
+        self.entries.push(CacheEntry {
+            pattern: String::from(pattern),
+            flags: String::from(flags),
+            regex,
+        });
+    }
+
+    /// Change the capacity, dropping the oldest entries that no longer fit
+    pub fn set_capacity(&mut self, capacity: usize) {
+        self.capacity = capacity;
+        let excess = self.entries.len().saturating_sub(capacity);
+        self.entries.drain(..excess);
+    }
+
+    /// Drop all entries (counters are kept)
+    pub fn clear(&mut self) {
+        self.entries.clear();
+    }
+
+    pub fn stats(&self) -> RegExpCacheStats {
+        RegExpCacheStats {
+            hits: self.hits,
+            misses: self.misses,
+            entries: self.entries.len(),
+            capacity: self.capacity,
+        }
+    }
+}
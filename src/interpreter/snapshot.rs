@@ -0,0 +1,612 @@
+//! Heap snapshots for fast interpreter creation
+//!
+//! `Interpreter::new()` builds every builtin prototype from scratch, and hosts
+//! typically register the same internal modules and evaluate the same prelude
+//! on top of that. A snapshot captures an idle, fully initialized interpreter
+//! so further interpreters can be created by copying its heap in bulk.
+//!
+//! Copying walks the object graph once, allocating a new object for every
+//! reachable source object and remapping all `Gc` references through an
+//! id → new object table. Bytecode chunks, strings and native function
+//! pointers are immutable and shared rather than copied.
+//!
+//! Snapshots are single-threaded like the interpreter itself: strings and
+//! chunks are `Rc`-shared between the snapshot and every interpreter created
+//! from it.
+
+use crate::prelude::*;
+
+use crate::error::JsError;
+use crate::gc::{Gc, Guard, Heap};
+use crate::value::{
+    ArrayElements, Binding, BoundFunctionData, ByteStore, BytecodeFunction, CheapClone,
+    DataViewData, EnumData, EnumMember, EnvironmentData, ExoticObject, JsFunction, JsMapKey,
+    JsObject, JsValue, ModuleExport, PromiseAllSharedState, PromiseHandler, PromiseRaceSharedState,
+    PromiseState, PropertyStorage, ProxyData, TypedArrayData,
+};
+use crate::{InternalExport, InternalModule, InternalModuleKind};
+
+use super::{
+    InlineCacheStats, Interpreter, WaitGraph, default_console_provider, default_random_provider,
+    default_time_provider,
+};
+
+/// An idle interpreter captured for cheap cloning.
+///
+/// Created by [`Interpreter::snapshot`]. Each call to [`instantiate`](Self::instantiate)
+/// returns an independent interpreter with the snapshot's globals, registered
+/// internal modules and loaded modules.
+///
+/// Platform providers (time, random, console) are reset to their defaults in
+/// new interpreters; the RegExp provider is shared.
+pub struct InterpreterSnapshot {
+    interp: Interpreter,
+}
+
+impl InterpreterSnapshot {
+    /// Create a new interpreter from this snapshot
+    pub fn instantiate(&self) -> Result<Interpreter, JsError> {
+        self.interp.fork()
+    }
+}
+
+impl Interpreter {
+    /// Capture this interpreter's state for fast creation of new interpreters.
+    ///
+    /// The interpreter must be idle: no active or suspended execution, no
+    /// pending imports or orders. Later changes to this interpreter do not
+    /// affect the snapshot.
+    pub fn snapshot(&self) -> Result<InterpreterSnapshot, JsError> {
+        Ok(InterpreterSnapshot {
+            interp: self.fork()?,
+        })
+    }
+
+    /// Create an independent copy of this idle interpreter.
+    ///
+    /// See [`Interpreter::snapshot`] for the requirements.
+    pub fn fork(&self) -> Result<Interpreter, JsError> {
+        self.check_idle_for_snapshot()?;
+
+        let heap: Heap<JsObject> = Heap::new();
+        let root_guard = heap.create_guard();
+        // Keeps every copied object alive until the copy is linked to the roots
+        let copy_guard = heap.create_guard();
+        let mut copier = HeapCopier::new(&copy_guard);
+
+        let roots: Vec<Gc<JsObject>> = self
+            .root_guard
+            .roots()
+            .iter()
+            .map(|obj| copier.object(obj))
+            .collect();
+
+        let global = copier.object(&self.global);
+        let global_env = copier.object(&self.global_env);
+        let env = copier.object(&self.env);
+        let object_prototype = copier.object(&self.object_prototype);
+        let array_prototype = copier.object(&self.array_prototype);
+        let function_prototype = copier.object(&self.function_prototype);
+        let string_prototype = copier.object(&self.string_prototype);
+        let number_prototype = copier.object(&self.number_prototype);
+        let boolean_prototype = copier.object(&self.boolean_prototype);
+        let regexp_prototype = copier.object(&self.regexp_prototype);
+        let map_prototype = copier.object(&self.map_prototype);
+        let set_prototype = copier.object(&self.set_prototype);
+        let date_prototype = copier.object(&self.date_prototype);
+        let symbol_prototype = copier.object(&self.symbol_prototype);
+        let promise_prototype = copier.object(&self.promise_prototype);
+        let generator_prototype = copier.object(&self.generator_prototype);
+        let array_buffer_prototype = copier.object(&self.array_buffer_prototype);
+        let data_view_prototype = copier.object(&self.data_view_prototype);
+        let typed_array_prototypes = self
+            .typed_array_prototypes
+            .iter()
+            .map(|proto| copier.object(proto))
+            .collect();
+        let error_prototype = copier.object(&self.error_prototype);
+        let type_error_prototype = copier.object(&self.type_error_prototype);
+        let reference_error_prototype = copier.object(&self.reference_error_prototype);
+        let range_error_prototype = copier.object(&self.range_error_prototype);
+        let syntax_error_prototype = copier.object(&self.syntax_error_prototype);
+
+        let exports = self
+            .exports
+            .iter()
+            .map(|(name, export)| (name.cheap_clone(), copier.module_export(export)))
+            .collect();
+        let internal_modules = self
+            .internal_modules
+            .iter()
+            .map(|(specifier, module)| (specifier.clone(), copier.internal_module(module)))
+            .collect();
+        let internal_module_cache = self
+            .internal_module_cache
+            .iter()
+            .map(|(specifier, obj)| (specifier.clone(), copier.object(obj)))
+            .collect();
+        let loaded_modules = self
+            .loaded_modules
+            .iter()
+            .map(|(path, obj)| (path.clone(), copier.object(obj)))
+            .collect();
+        let promise_ids = self
+            .promise_ids
+            .iter()
+            .map(|(promise, id)| (copier.object(promise), *id))
+            .collect();
+
+        copier.run()?;
+
+        for root in roots {
+            root_guard.guard(root);
+        }
+
+        Ok(Interpreter {
+            heap,
+            root_guard,
+            global,
+            global_env,
+            env,
+            env_guards: Vec::new(),
+            string_dict: self.string_dict.clone(),
+            object_prototype,
+            array_prototype,
+            function_prototype,
+            string_prototype,
+            number_prototype,
+            boolean_prototype,
+            regexp_prototype,
+            map_prototype,
+            set_prototype,
+            date_prototype,
+            symbol_prototype,
+            promise_prototype,
+            generator_prototype,
+            array_buffer_prototype,
+            data_view_prototype,
+            typed_array_prototypes,
+            error_prototype,
+            type_error_prototype,
+            reference_error_prototype,
+            range_error_prototype,
+            syntax_error_prototype,
+            exports,
+            call_stack: Vec::new(),
+            next_generator_id: self.next_generator_id,
+            #[cfg(not(feature = "std"))]
+            next_symbol_id: self.next_symbol_id,
+            symbol_registry: self.symbol_registry.clone(),
+            well_known_symbols: self.well_known_symbols,
+            console_timers: self.console_timers.clone(),
+            console_counters: self.console_counters.clone(),
+            current_ffi_id: 0,
+            #[cfg(feature = "c-api")]
+            ffi_context: core::ptr::null_mut(),
+            // Platform providers
+            time_provider: default_time_provider(),
+            random_provider: default_random_provider(),
+            console_provider: default_console_provider(),
+            regexp_provider: self.regexp_provider.cheap_clone(),
+            regexp_cache: RefCell::new(super::regexp_cache::RegExpCache::new(
+                self.regexp_cache_stats().capacity,
+            )),
+            profiler: None,
+            // Step-based execution
+            active_vm: None,
+            active_module_path: None,
+            active_saved_env: None,
+            active_module_env: None,
+            // Module system
+            internal_modules,
+            internal_module_cache,
+            loaded_modules,
+            main_module_path: self.main_module_path.clone(),
+            current_module_path: self.current_module_path.clone(),
+            // Order system
+            next_order_id: self.next_order_id,
+            pending_orders: Vec::new(),
+            order_responses: FxHashMap::default(),
+            cancelled_orders: Vec::new(),
+            suspended_for_order: None,
+            // Async context management
+            wait_graph: WaitGraph::new(),
+            next_context_id: self.next_context_id,
+            next_promise_id: self.next_promise_id,
+            promise_ids,
+            // Program state
+            pending_program: None,
+            pending_module_sources: FxHashMap::default(),
+            inline_cache_stats: InlineCacheStats::default(),
+            lazy_compilation: self.lazy_compilation,
+            run_deadline: None,
+            deadline_exceeded: false,
+        })
+    }
+
+    /// Snapshots only capture the heap, not in-flight execution state
+    fn check_idle_for_snapshot(&self) -> Result<(), JsError> {
+        let busy = self.active_vm.is_some()
+            || self.suspended_for_order.is_some()
+            || self.pending_program.is_some()
+            || !self.pending_module_sources.is_empty()
+            || !self.pending_orders.is_empty()
+            || !self.order_responses.is_empty()
+            || !self.cancelled_orders.is_empty()
+            || self.wait_graph.has_waiting_contexts()
+            || !self.env_guards.is_empty();
+        if busy {
+            return Err(JsError::type_error(
+                "Cannot snapshot an interpreter with execution in progress",
+            ));
+        }
+        Ok(())
+    }
+}
+
+/// Copies an object graph into a new heap, preserving identity and sharing
+struct HeapCopier<'a> {
+    guard: &'a Guard<JsObject>,
+    /// Source object id -> copied object
+    objects: FxHashMap<usize, Gc<JsObject>>,
+    /// Allocated copies whose contents have not been filled in yet
+    pending: Vec<(Gc<JsObject>, Gc<JsObject>)>,
+    /// Shared Promise.all state, keyed by source Rc address
+    promise_all_states: FxHashMap<usize, Rc<PromiseAllSharedState>>,
+    /// Shared Promise.race state, keyed by source Rc address
+    promise_race_states: FxHashMap<usize, Rc<PromiseRaceSharedState>>,
+    /// ArrayBuffer bytes, keyed by source Rc address so views keep sharing
+    /// their buffer's copy
+    byte_stores: FxHashMap<usize, Rc<ByteStore>>,
+}
+
+impl<'a> HeapCopier<'a> {
+    fn new(guard: &'a Guard<JsObject>) -> Self {
+        Self {
+            guard,
+            objects: FxHashMap::default(),
+            pending: Vec::new(),
+            promise_all_states: FxHashMap::default(),
+            promise_race_states: FxHashMap::default(),
+            byte_stores: FxHashMap::default(),
+        }
+    }
+
+    /// Get the copy of a source object, allocating it on first sight
+    fn object(&mut self, src: &Gc<JsObject>) -> Gc<JsObject> {
+        if let Some(copy) = self.objects.get(&src.id()) {
+            return copy.cheap_clone();
+        }
+        let copy = self.guard.alloc();
+        self.objects.insert(src.id(), copy.cheap_clone());
+        self.pending.push((src.cheap_clone(), copy.cheap_clone()));
+        copy
+    }
+
+    fn value(&mut self, value: &JsValue) -> JsValue {
+        match value {
+            JsValue::Object(obj) => JsValue::Object(self.object(obj)),
+            other => other.clone(),
+        }
+    }
+
+    /// Fill in every allocated copy until the whole reachable graph is copied
+    fn run(&mut self) -> Result<(), JsError> {
+        while let Some((src, copy)) = self.pending.pop() {
+            let contents = self.copy_object(&src.borrow())?;
+            *copy.borrow_mut() = contents;
+        }
+        Ok(())
+    }
+
+    fn copy_object(&mut self, src: &JsObject) -> Result<JsObject, JsError> {
+        let mut properties = PropertyStorage::with_capacity(src.properties.len());
+        for (key, prop) in src.properties.iter() {
+            let mut prop = prop.clone();
+            prop.value = self.value(&prop.value);
+            if prop.is_accessor() {
+                let getter = prop.getter().cloned();
+                let setter = prop.setter().cloned();
+                prop.set_getter(getter.map(|g| self.object(&g)));
+                prop.set_setter(setter.map(|s| self.object(&s)));
+            }
+            properties.insert(key.clone(), prop);
+        }
+
+        let private_fields = src.private_fields.as_ref().map(|fields| {
+            fields
+                .iter()
+                .map(|(key, value)| (key.clone(), self.value(value)))
+                .collect()
+        });
+
+        Ok(JsObject {
+            prototype: src.prototype.as_ref().map(|proto| self.object(proto)),
+            extensible: src.extensible,
+            frozen: src.frozen,
+            sealed: src.sealed,
+            null_prototype: src.null_prototype,
+            properties,
+            exotic: self.exotic(&src.exotic)?,
+            private_fields,
+        })
+    }
+
+    fn exotic(&mut self, exotic: &ExoticObject) -> Result<ExoticObject, JsError> {
+        Ok(match exotic {
+            ExoticObject::Ordinary => ExoticObject::Ordinary,
+            ExoticObject::Error(data) => ExoticObject::Error(data.clone()),
+            ExoticObject::Array { elements } => ExoticObject::Array {
+                elements: match elements {
+                    ArrayElements::Double(numbers) => ArrayElements::Double(numbers.clone()),
+                    ArrayElements::Generic(values) => {
+                        ArrayElements::Generic(values.iter().map(|v| self.value(v)).collect())
+                    }
+                },
+            },
+            ExoticObject::Boolean(b) => ExoticObject::Boolean(*b),
+            ExoticObject::Number(n) => ExoticObject::Number(*n),
+            ExoticObject::StringObj(s) => ExoticObject::StringObj(s.cheap_clone()),
+            ExoticObject::Symbol(sym) => ExoticObject::Symbol(sym.clone()),
+            ExoticObject::Function(func) => ExoticObject::Function(self.function(func)),
+            ExoticObject::Map { entries } => {
+                let mut copied = index_map_with_capacity(entries.len());
+                for (key, value) in entries {
+                    copied.insert(JsMapKey(self.value(&key.0)), self.value(value));
+                }
+                ExoticObject::Map { entries: copied }
+            }
+            ExoticObject::Set { entries } => {
+                let mut copied = index_set_with_capacity(entries.len());
+                for entry in entries {
+                    copied.insert(JsMapKey(self.value(&entry.0)));
+                }
+                ExoticObject::Set { entries: copied }
+            }
+            ExoticObject::Date { timestamp } => ExoticObject::Date {
+                timestamp: *timestamp,
+            },
+            ExoticObject::RegExp {
+                pattern,
+                flags,
+                compiled,
+            } => ExoticObject::RegExp {
+                pattern: pattern.clone(),
+                flags: flags.clone(),
+                compiled: compiled.clone(),
+            },
+            ExoticObject::Generator(_) | ExoticObject::BytecodeGenerator(_) => {
+                // Suspended generator frames are VM state, not heap data
+                return Err(JsError::type_error(
+                    "Cannot snapshot an interpreter holding generator objects",
+                ));
+            }
+            ExoticObject::Promise(state) => {
+                let state = state.borrow();
+                let copied = PromiseState {
+                    status: state.status.clone(),
+                    result: state.result.as_ref().map(|v| self.value(v)),
+                    handlers: state
+                        .handlers
+                        .iter()
+                        .map(|handler| PromiseHandler {
+                            on_fulfilled: handler.on_fulfilled.as_ref().map(|v| self.value(v)),
+                            on_rejected: handler.on_rejected.as_ref().map(|v| self.value(v)),
+                            result_promise: self.object(&handler.result_promise),
+                        })
+                        .collect(),
+                    order_id: state.order_id,
+                };
+                ExoticObject::Promise(Rc::new(RefCell::new(copied)))
+            }
+            ExoticObject::Environment(env) => ExoticObject::Environment(EnvironmentData {
+                bindings: env
+                    .bindings
+                    .iter()
+                    .map(|(key, binding)| (key.clone(), self.binding(binding)))
+                    .collect(),
+                outer: env.outer.as_ref().map(|outer| self.object(outer)),
+            }),
+            ExoticObject::Enum(data) => ExoticObject::Enum(EnumData {
+                name: data.name.cheap_clone(),
+                const_: data.const_,
+                members: data
+                    .members
+                    .iter()
+                    .map(|member| EnumMember {
+                        name: member.name.cheap_clone(),
+                        value: self.value(&member.value),
+                    })
+                    .collect(),
+            }),
+            ExoticObject::Proxy(proxy) => ExoticObject::Proxy(ProxyData {
+                target: self.object(&proxy.target),
+                handler: self.object(&proxy.handler),
+                revoked: proxy.revoked,
+            }),
+            ExoticObject::RawJSON(json) => ExoticObject::RawJSON(json.cheap_clone()),
+            ExoticObject::PendingOrder { id } => ExoticObject::PendingOrder { id: *id },
+            ExoticObject::ArrayBuffer(store) => ExoticObject::ArrayBuffer(self.byte_store(store)),
+            ExoticObject::TypedArray(data) => ExoticObject::TypedArray(TypedArrayData {
+                kind: data.kind,
+                buffer: self.object(&data.buffer),
+                store: self.byte_store(&data.store),
+                byte_offset: data.byte_offset,
+                length: data.length,
+            }),
+            ExoticObject::DataView(data) => ExoticObject::DataView(DataViewData {
+                buffer: self.object(&data.buffer),
+                store: self.byte_store(&data.store),
+                byte_offset: data.byte_offset,
+                byte_length: data.byte_length,
+            }),
+        })
+    }
+
+    fn function(&mut self, func: &JsFunction) -> JsFunction {
+        match func {
+            JsFunction::Bytecode(f) => JsFunction::Bytecode(self.bytecode_function(f)),
+            JsFunction::BytecodeGenerator(f) => {
+                JsFunction::BytecodeGenerator(self.bytecode_function(f))
+            }
+            JsFunction::BytecodeAsync(f) => JsFunction::BytecodeAsync(self.bytecode_function(f)),
+            JsFunction::BytecodeAsyncGenerator(f) => {
+                JsFunction::BytecodeAsyncGenerator(self.bytecode_function(f))
+            }
+            JsFunction::Native(native) => JsFunction::Native(native.clone()),
+            JsFunction::Bound(bound) => JsFunction::Bound(Box::new(BoundFunctionData {
+                target: self.object(&bound.target),
+                this_arg: self.value(&bound.this_arg),
+                bound_args: bound.bound_args.iter().map(|v| self.value(v)).collect(),
+            })),
+            JsFunction::PromiseResolve(promise) => JsFunction::PromiseResolve(self.object(promise)),
+            JsFunction::PromiseReject(promise) => JsFunction::PromiseReject(self.object(promise)),
+            JsFunction::PromiseAllFulfill { state, index } => JsFunction::PromiseAllFulfill {
+                state: self.promise_all_state(state),
+                index: *index,
+            },
+            JsFunction::PromiseAllReject(state) => {
+                JsFunction::PromiseAllReject(self.promise_all_state(state))
+            }
+            JsFunction::PromiseRaceSettle {
+                state,
+                is_fulfill,
+                index,
+            } => JsFunction::PromiseRaceSettle {
+                state: self.promise_race_state(state),
+                is_fulfill: *is_fulfill,
+                index: *index,
+            },
+            JsFunction::AccessorGetter => JsFunction::AccessorGetter,
+            JsFunction::AccessorSetter => JsFunction::AccessorSetter,
+            JsFunction::ModuleExportGetter {
+                module_env,
+                binding_name,
+            } => JsFunction::ModuleExportGetter {
+                module_env: self.object(module_env),
+                binding_name: binding_name.cheap_clone(),
+            },
+            JsFunction::ModuleReExportGetter {
+                source_module,
+                source_key,
+            } => JsFunction::ModuleReExportGetter {
+                source_module: self.object(source_module),
+                source_key: source_key.clone(),
+            },
+            JsFunction::ProxyRevoke(proxy) => JsFunction::ProxyRevoke(self.object(proxy)),
+        }
+    }
+
+    fn bytecode_function(&mut self, func: &BytecodeFunction) -> BytecodeFunction {
+        BytecodeFunction {
+            chunk: func.chunk.cheap_clone(),
+            closure: self.object(&func.closure),
+            captured_this: func
+                .captured_this
+                .as_ref()
+                .map(|this| Box::new(self.value(this))),
+        }
+    }
+
+    fn promise_all_state(
+        &mut self,
+        state: &Rc<PromiseAllSharedState>,
+    ) -> Rc<PromiseAllSharedState> {
+        let key = Rc::as_ptr(state) as usize;
+        if let Some(copy) = self.promise_all_states.get(&key) {
+            return copy.cheap_clone();
+        }
+        let results = state
+            .results
+            .borrow()
+            .iter()
+            .map(|v| self.value(v))
+            .collect();
+        let copy = Rc::new(PromiseAllSharedState {
+            remaining: Cell::new(state.remaining.get()),
+            results: RefCell::new(results),
+            result_promise: self.object(&state.result_promise),
+            rejected: Cell::new(state.rejected.get()),
+        });
+        self.promise_all_states.insert(key, copy.cheap_clone());
+        copy
+    }
+
+    /// Owned copy of an ArrayBuffer's bytes. Host memory is copied too: a
+    /// copy must not write through to the original's buffer.
+    fn byte_store(&mut self, store: &Rc<ByteStore>) -> Rc<ByteStore> {
+        let key = Rc::as_ptr(store) as usize;
+        if let Some(copy) = self.byte_stores.get(&key) {
+            return copy.cheap_clone();
+        }
+        let copy = ByteStore::new(store.bytes().to_vec());
+        self.byte_stores.insert(key, copy.cheap_clone());
+        copy
+    }
+
+    fn promise_race_state(
+        &mut self,
+        state: &Rc<PromiseRaceSharedState>,
+    ) -> Rc<PromiseRaceSharedState> {
+        let key = Rc::as_ptr(state) as usize;
+        if let Some(copy) = self.promise_race_states.get(&key) {
+            return copy.cheap_clone();
+        }
+        let copy = Rc::new(PromiseRaceSharedState {
+            result_promise: self.object(&state.result_promise),
+            settled: Cell::new(state.settled.get()),
+            input_order_ids: state.input_order_ids.clone(),
+        });
+        self.promise_race_states.insert(key, copy.cheap_clone());
+        copy
+    }
+
+    fn binding(&mut self, binding: &Binding) -> Binding {
+        let mut copy = binding.clone();
+        copy.value = self.value(&binding.value);
+        if let Some(import) = &mut copy.import_binding {
+            import.module_obj = self.object(&import.module_obj);
+        }
+        copy
+    }
+
+    fn module_export(&mut self, export: &ModuleExport) -> ModuleExport {
+        match export {
+            ModuleExport::Direct { name, value } => ModuleExport::Direct {
+                name: name.cheap_clone(),
+                value: self.value(value),
+            },
+            ModuleExport::ReExport {
+                source_module,
+                source_key,
+            } => ModuleExport::ReExport {
+                source_module: self.object(source_module),
+                source_key: source_key.clone(),
+            },
+        }
+    }
+
+    fn internal_module(&mut self, module: &InternalModule) -> InternalModule {
+        let kind = match &module.kind {
+            InternalModuleKind::Native(exports) => InternalModuleKind::Native(
+                exports
+                    .iter()
+                    .map(|(name, export)| {
+                        let export = match export {
+                            InternalExport::Value(value) => {
+                                InternalExport::Value(self.value(value))
+                            }
+                            function => function.clone(),
+                        };
+                        (name.clone(), export)
+                    })
+                    .collect(),
+            ),
+            InternalModuleKind::Source(source) => InternalModuleKind::Source(source.clone()),
+        };
+        InternalModule {
+            specifier: module.specifier.clone(),
+            kind,
+        }
+    }
+}
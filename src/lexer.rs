@@ -286,21 +286,20 @@ impl<'a> Lexer<'a> {
         self.start_line = checkpoint.start_line;
         self.start_column = checkpoint.start_column;
         self.saw_newline = checkpoint.saw_newline;
-        // Create iterator directly from the checkpoint position (O(1) instead of O(n))
-        // The base offset tracks where in the original source we started
-        self.chars_base_offset = checkpoint.current_pos;
-        self.chars = self
-            .source
-            .get(checkpoint.current_pos..)
-            .unwrap_or("")
-            .char_indices()
-            .peekable();
+        self.resync_chars();
     }
 
     /// Reset the lexer to a specific position (from a Span) to rescan as regexp.
     /// Used when parser determines that a `/` should start a regexp literal.
     pub fn rescan_as_regexp(&mut self, span: Span) -> Token {
-        // Reset lexer position to the start of the span
+        self.seek(span);
+
+        // Now scan as regexp
+        self.scan_regexp()
+    }
+
+    /// Move the lexer to the start of `span`, so the next token begins there
+    pub fn seek(&mut self, span: Span) {
         self.current_pos = span.start;
         self.line = span.line;
         self.column = span.column;
@@ -308,17 +307,7 @@ impl<'a> Lexer<'a> {
         self.start_line = span.line;
         self.start_column = span.column;
 
-        // Create iterator directly from the span position (O(1) instead of O(n))
-        self.chars_base_offset = span.start;
-        self.chars = self
-            .source
-            .get(span.start..)
-            .unwrap_or("")
-            .char_indices()
-            .peekable();
-
-        // Now scan as regexp
-        self.scan_regexp()
+        self.resync_chars();
     }
 
     /// Get the next token from the source
@@ -433,10 +422,102 @@ impl<'a> Lexer<'a> {
         )
     }
 
+    /// Restart the char iterator at `current_pos` (O(1) instead of O(n)).
+    /// The base offset tracks where in the original source we started.
+    fn resync_chars(&mut self) {
+        self.chars_base_offset = self.current_pos;
+        self.chars = self
+            .source
+            .get(self.current_pos..)
+            .unwrap_or("")
+            .char_indices()
+            .peekable();
+    }
+
+    /// The unscanned rest of the source as bytes
+    fn rest_bytes(&self) -> &'a [u8] {
+        self.source
+            .as_bytes()
+            .get(self.current_pos..)
+            .unwrap_or(&[])
+    }
+
+    /// Step over `len` ASCII bytes that contain no line terminator.
+    fn skip_ascii(&mut self, len: usize) {
+        if len > 0 {
+            self.current_pos += len;
+            self.column += len as u32;
+            self.resync_chars();
+        }
+    }
+
+    /// Copy the leading run of ASCII bytes not matching `stop` into `value`.
+    ///
+    /// Used by string and template scanning so only escapes, line breaks and
+    /// non-ASCII characters go through the per-char path.
+    fn take_ascii_run(&mut self, value: &mut String, stop: impl Fn(u8) -> bool) {
+        let len = ascii_run_len(self.rest_bytes(), |b| b != b'\n' && !stop(b));
+        let start = self.current_pos;
+        self.skip_ascii(len);
+        if let Some(run) = self.source.get(start..self.current_pos) {
+            value.push_str(run);
+        }
+    }
+
+    /// Skip ASCII whitespace and newlines a byte at a time; returns whether
+    /// anything was skipped.
+    fn skip_ascii_whitespace(&mut self) -> bool {
+        let bytes = self.rest_bytes();
+        let mut len = 0;
+        for &b in bytes {
+            match b {
+                b' ' | b'\t' | b'\r' | 0x0B | 0x0C => self.column += 1,
+                b'\n' => {
+                    self.line += 1;
+                    self.column = 1;
+                    self.saw_newline = true;
+                }
+                _ => break,
+            }
+            len += 1;
+        }
+        if len > 0 {
+            self.current_pos += len;
+            self.resync_chars();
+        }
+        len > 0
+    }
+
+    /// Skip the ASCII part of a block comment body up to the next `*`, `/`
+    /// or non-ASCII byte, tracking line breaks.
+    fn skip_block_comment_ascii(&mut self) {
+        let bytes = self.rest_bytes();
+        let mut len = 0;
+        for &b in bytes {
+            match b {
+                b'*' | b'/' | 0x80.. => break,
+                b'\n' => {
+                    self.line += 1;
+                    self.column = 1;
+                    self.saw_newline = true;
+                }
+                _ => self.column += 1,
+            }
+            len += 1;
+        }
+        if len > 0 {
+            self.current_pos += len;
+            self.resync_chars();
+        }
+    }
+
     fn skip_whitespace_and_comments(&mut self) {
         self.saw_newline = false;
 
         loop {
+            if self.skip_ascii_whitespace() {
+                continue;
+            }
             match self.peek() {
                 // ECMAScript whitespace characters:
                 // - \u0009 (tab)
@@ -463,6 +544,8 @@ impl<'a> Lexer<'a> {
                         // Single-line comment
                         self.advance(); // /
                         self.advance(); // /
+                        let len = line_comment_ascii_len(self.rest_bytes());
+                        self.skip_ascii(len);
                         while let Some(ch) = self.peek() {
                             // ECMAScript line terminators end single-line comments
                             if ch == '\n' || ch == '\u{2028}' || ch == '\u{2029}' {
@@ -476,6 +559,7 @@ impl<'a> Lexer<'a> {
                         self.advance(); // *
                         let mut depth = 1;
                         while depth > 0 {
+                            self.skip_block_comment_ascii();
                             match self.advance() {
                                 Some((_, '*')) if self.peek() == Some('/') => {
                                     self.advance();
@@ -743,9 +827,23 @@ impl<'a> Lexer<'a> {
     }
 
     fn scan_string(&mut self, quote: char) -> TokenKind {
-        let mut value = String::new();
+        let quote_byte = quote as u8;
+        let is_special = |b: u8| b == quote_byte || b == b'\\';
+
+        // Escape-free ASCII string: intern the source slice without copying
+        let len = ascii_run_len(self.rest_bytes(), |b| b != b'\n' && !is_special(b));
+        if self.rest_bytes().get(len) == Some(&quote_byte) {
+            let source = self.source;
+            let start = self.current_pos;
+            self.skip_ascii(len);
+            let body = source.get(start..self.current_pos).unwrap_or("");
+            self.advance();
+            return TokenKind::String(self.string_dict.get_or_insert(body));
+        }
 
+        let mut value = String::new();
         loop {
+            self.take_ascii_run(&mut value, is_special);
             match self.advance() {
                 Some((_, c)) if c == quote => break,
                 Some((_, '\\')) => {
@@ -900,6 +998,7 @@ impl<'a> Lexer<'a> {
         let mut value = String::new();
 
         loop {
+            self.take_ascii_run(&mut value, is_template_special);
             match self.advance() {
                 Some((_, '`')) => {
                     // End of template
@@ -1001,6 +1100,7 @@ impl<'a> Lexer<'a> {
         let mut value = String::new();
 
         loop {
+            self.take_ascii_run(&mut value, is_template_special);
             match self.advance() {
                 Some((_, '`')) => {
                     return TokenKind::TemplateTail(self.string_dict.get_or_insert(&value));
@@ -1114,6 +1214,19 @@ impl<'a> Lexer<'a> {
     }
 
     fn scan_number(&mut self, first: char) -> TokenKind {
+        // Plain decimal integers parse straight from the source slice
+        let digits = ascii_run_len(self.rest_bytes(), |b| b.is_ascii_digit());
+        let ends_literal = !self
+            .rest_bytes()
+            .get(digits)
+            .is_some_and(|&b| b == b'.' || b >= 0x80 || is_id_continue_byte(b));
+        if ends_literal && (first != '0' || digits == 0) {
+            let source = self.source;
+            self.skip_ascii(digits);
+            let text = source.get(self.start_pos..self.current_pos).unwrap_or("");
+            return TokenKind::Number(text.parse().unwrap_or(f64::NAN));
+        }
+
         let mut num_str = String::new();
 
         if first == '0' {
@@ -1305,6 +1418,17 @@ impl<'a> Lexer<'a> {
     }
 
     fn scan_identifier(&mut self, first: char) -> TokenKind {
+        // Plain ASCII identifiers are matched in place without building a String
+        if first != '\\' {
+            let len = ascii_run_len(self.rest_bytes(), is_id_continue_byte);
+            if self.rest_bytes().get(len) != Some(&b'\\') {
+                let source = self.source;
+                self.skip_ascii(len);
+                let name = source.get(self.start_pos..self.current_pos).unwrap_or("");
+                return self.keyword_or_identifier(name);
+            }
+        }
+
         let mut name = String::new();
         let mut had_escape = false;
 
@@ -1352,28 +1476,33 @@ impl<'a> Lexer<'a> {
             return TokenKind::Identifier(self.string_dict.get_or_insert(&name));
         }
 
+        self.keyword_or_identifier(&name)
+    }
+
+    /// Classify an unescaped identifier as a keyword or intern it.
+    fn keyword_or_identifier(&mut self, name: &str) -> TokenKind {
         // Length-prefixed keyword dispatch for faster matching
         // First dispatch on length, then compare only keywords of that length
         match name.len() {
-            2 => match name.as_str() {
+            2 => match name {
                 "if" => TokenKind::If,
                 "in" => TokenKind::In,
                 "do" => TokenKind::Do,
                 "as" => TokenKind::As,
                 "of" => TokenKind::Of,
                 "is" => TokenKind::Is,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            3 => match name.as_str() {
+            3 => match name {
                 "let" => TokenKind::Let,
                 "var" => TokenKind::Var,
                 "for" => TokenKind::For,
                 "new" => TokenKind::New,
                 "try" => TokenKind::Try,
                 "any" => TokenKind::Any,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            4 => match name.as_str() {
+            4 => match name {
                 "true" => TokenKind::True,
                 "null" => TokenKind::Null,
                 "else" => TokenKind::Else,
@@ -1383,9 +1512,9 @@ impl<'a> Lexer<'a> {
                 "enum" => TokenKind::Enum,
                 "type" => TokenKind::Type,
                 "from" => TokenKind::From,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            5 => match name.as_str() {
+            5 => match name {
                 "false" => TokenKind::False,
                 "const" => TokenKind::Const,
                 "while" => TokenKind::While,
@@ -1400,9 +1529,9 @@ impl<'a> Lexer<'a> {
                 "never" => TokenKind::Never,
                 "catch" => TokenKind::Catch,
                 "keyof" => TokenKind::Keyof,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            6 => match name.as_str() {
+            6 => match name {
                 "return" => TokenKind::Return,
                 "switch" => TokenKind::Switch,
                 "static" => TokenKind::Static,
@@ -1412,9 +1541,9 @@ impl<'a> Lexer<'a> {
                 "delete" => TokenKind::Delete,
                 "public" => TokenKind::Public,
                 "module" => TokenKind::Module,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            7 => match name.as_str() {
+            7 => match name {
                 "default" => TokenKind::Default,
                 "finally" => TokenKind::Finally,
                 "extends" => TokenKind::Extends,
@@ -1422,33 +1551,75 @@ impl<'a> Lexer<'a> {
                 "private" => TokenKind::Private,
                 "unknown" => TokenKind::Unknown,
                 "asserts" => TokenKind::Asserts,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            8 => match name.as_str() {
+            8 => match name {
                 "function" => TokenKind::Function,
                 "continue" => TokenKind::Continue,
                 "debugger" => TokenKind::Debugger,
                 "readonly" => TokenKind::Readonly,
                 "accessor" => TokenKind::Accessor,
                 "abstract" => TokenKind::Abstract,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            9 => match name.as_str() {
+            9 => match name {
                 "protected" => TokenKind::Protected,
                 "namespace" => TokenKind::Namespace,
                 "interface" => TokenKind::Interface,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            10 => match name.as_str() {
+            10 => match name {
                 "instanceof" => TokenKind::Instanceof,
                 "implements" => TokenKind::Implements,
-                _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+                _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
             },
-            _ => TokenKind::Identifier(self.string_dict.get_or_insert(&name)),
+            _ => TokenKind::Identifier(self.string_dict.get_or_insert(name)),
         }
     }
 }
 
+/// Length of the leading run of ASCII bytes satisfying `pred`
+#[inline]
+fn ascii_run_len(bytes: &[u8], pred: impl Fn(u8) -> bool) -> usize {
+    bytes
+        .iter()
+        .position(|&b| b >= 0x80 || !pred(b))
+        .unwrap_or(bytes.len())
+}
+
+/// Length of the ASCII body of a `//` comment: everything up to the first
+/// `\n` or non-ASCII byte (which may be U+2028/U+2029), eight bytes at a time.
+fn line_comment_ascii_len(bytes: &[u8]) -> usize {
+    const ONES: u64 = 0x0101_0101_0101_0101;
+    const HIGH: u64 = 0x8080_8080_8080_8080;
+    const NEWLINES: u64 = ONES * b'\n' as u64;
+
+    let mut len = 0;
+    for chunk in bytes.chunks_exact(8) {
+        let Ok(word) = <[u8; 8]>::try_from(chunk).map(u64::from_le_bytes) else {
+            break;
+        };
+        // High bit set in any byte that is non-ASCII or equal to '\n'
+        let xor = word ^ NEWLINES;
+        if (word | (xor.wrapping_sub(ONES) & !xor)) & HIGH != 0 {
+            break;
+        }
+        len += 8;
+    }
+    let tail = bytes.get(len..).unwrap_or(&[]);
+    len + ascii_run_len(tail, |b| b != b'\n')
+}
+
+/// Bytes that end the plain-text part of a template literal
+fn is_template_special(b: u8) -> bool {
+    matches!(b, b'`' | b'$' | b'\\')
+}
+
+/// Byte form of `is_id_continue_char` for the ASCII fast path
+fn is_id_continue_byte(b: u8) -> bool {
+    b == b'_' || b == b'$' || b.is_ascii_alphanumeric()
+}
+
 /// Check if a character can start an identifier (including unicode escape sequence)
 fn is_id_start(ch: char) -> bool {
     ch == '_' || ch == '$' || ch == '\\' || ch.is_ascii_alphabetic()
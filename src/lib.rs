@@ -465,6 +465,8 @@ pub(crate) mod interpreter;
 pub mod lexer;
 pub mod parser;
 pub mod platform;
+#[cfg(feature = "std")]
+pub mod pool;
 pub mod string_dict;
 pub mod value;
 
@@ -481,19 +483,26 @@ use prelude::{Rc, String, Vec, format};
 
 pub use error::JsError;
 pub use gc::{Gc, GcStats, Guard, Heap, Reset};
-pub use interpreter::Interpreter;
+pub use interpreter::{
+    DEFAULT_REGEXP_CACHE_CAPACITY, InlineCacheStats, Interpreter, InterpreterSnapshot, Profile,
+    ProfileFunction, ProfileStack, RegExpCacheStats,
+};
 pub use string_dict::StringDict;
+pub use value::ByteStore;
 pub use value::CheapClone;
 pub use value::EnvRef;
 pub use value::Guarded;
 pub use value::JsObject;
 pub use value::JsString;
 pub use value::JsValue;
+pub use value::TypedArrayKind;
 
 // Re-export serde conversion functions for JsValue <-> serde_json::Value
 pub use interpreter::builtins::json::{
     js_value_to_json, json_to_js_value_with_guard, json_to_js_value_with_interp,
 };
+pub use interpreter::builtins::json_stream::{JsonStreamParser, json_stringify_to};
+pub use interpreter::builtins::value_codec::{VALUE_CODEC_VERSION, decode_value, encode_value};
 
 // Re-export internal module builder for the order system
 pub use interpreter::builtins::internal::create_eval_internal_module;
@@ -18,6 +18,12 @@ pub struct Parser<'a> {
     /// This is used in for-loop init expressions where 'in' separates
     /// the variable from the iterable (for x in obj).
     no_in: bool,
+    /// Staging stack for statement lists, shared by all nesting levels
+    statement_scratch: Vec<Statement>,
+    /// Source to record skipped function bodies against (lazy parsing only)
+    lazy_source: Option<Rc<str>>,
+    /// Number of enclosing function and class bodies
+    function_depth: u32,
 }
 
 impl<'a> Parser<'a> {
@@ -29,9 +35,35 @@ impl<'a> Parser<'a> {
             current,
             previous: Token::eof(0, 1, 1),
             no_in: false,
+            statement_scratch: Vec::new(),
+            lazy_source: None,
+            function_depth: 0,
         }
     }
 
+    /// Create a parser that skips the bodies of functions not nested in
+    /// other functions, keeping only their spans in `source`
+    ///
+    /// A skipped body is parsed with [`Parser::parse_skipped_body`] the
+    /// first time the function is called, so syntax errors other than
+    /// invalid tokens inside it surface then rather than up front.
+    pub fn new_lazy(source: &'a Rc<str>, string_dict: &'a mut StringDict) -> Self {
+        let mut parser = Self::new(source, string_dict);
+        parser.lazy_source = Some(Rc::clone(source));
+        parser
+    }
+
+    /// Parse a function body skipped by a lazy parser
+    pub fn parse_skipped_body(
+        skipped: &SkippedBody,
+        string_dict: &mut StringDict,
+    ) -> Result<BlockStatement, JsError> {
+        let mut parser = Parser::new(&skipped.source, string_dict);
+        parser.lexer.seek(skipped.span);
+        parser.current = parser.lexer.next_token();
+        parser.parse_block_statement()
+    }
+
     /// Helper to intern a string in the dictionary
     #[inline]
     fn intern(&mut self, s: &str) -> JsString {
@@ -40,18 +72,36 @@ impl<'a> Parser<'a> {
 
     /// Parse a complete program
     pub fn parse_program(&mut self) -> Result<Program, JsError> {
-        let mut body = Vec::new();
-
-        while !self.is_at_end() {
-            body.push(self.parse_statement()?);
-        }
+        let body = self.parse_statement_list(|_| false)?;
 
         Ok(Program {
-            body: body.into(),
+            body,
             source_type: SourceType::Script,
         })
     }
 
+    /// Parse statements until `done` (or end of input), into an exactly sized slice.
+    ///
+    /// Statements are staged on `statement_scratch` and moved out in one
+    /// allocation, instead of growing a Vec per block and copying it into
+    /// the `Rc<[Statement]>`.
+    fn parse_statement_list(
+        &mut self,
+        done: impl Fn(&Self) -> bool,
+    ) -> Result<Rc<[Statement]>, JsError> {
+        let mark = self.statement_scratch.len();
+        while !done(self) && !self.is_at_end() {
+            match self.parse_statement() {
+                Ok(stmt) => self.statement_scratch.push(stmt),
+                Err(e) => {
+                    self.statement_scratch.truncate(mark);
+                    return Err(e);
+                }
+            }
+        }
+        Ok(self.statement_scratch.drain(mark..).collect())
+    }
+
     // ============ DECORATORS ============
 
     /// Parse a single decorator: @expression
@@ -245,22 +295,35 @@ impl<'a> Parser<'a> {
         };
         self.advance();
 
-        let mut declarations = vec![self.parse_variable_declarator()?];
-
-        while self.match_token(&TokenKind::Comma) {
-            declarations.push(self.parse_variable_declarator()?);
-        }
+        let first = self.parse_variable_declarator()?;
+        let declarations = self.parse_more_declarators(first)?;
 
         self.expect_semicolon()?;
 
         let span = self.span_from(start);
         Ok(VariableDeclaration {
             kind,
-            declarations: declarations.into(),
+            declarations,
             span,
         })
     }
 
+    /// Collect the declarators following `first` in a comma list.
+    /// The common single-declarator case allocates the slice directly.
+    fn parse_more_declarators(
+        &mut self,
+        first: VariableDeclarator,
+    ) -> Result<Rc<[VariableDeclarator]>, JsError> {
+        if !self.match_token(&TokenKind::Comma) {
+            return Ok(Rc::from([first]));
+        }
+        let mut declarations = vec![first, self.parse_variable_declarator()?];
+        while self.match_token(&TokenKind::Comma) {
+            declarations.push(self.parse_variable_declarator()?);
+        }
+        Ok(declarations.into())
+    }
+
     fn parse_variable_declarator(&mut self) -> Result<VariableDeclarator, JsError> {
         let start = self.current.span;
         let id = self.parse_binding_pattern()?;
@@ -499,7 +562,7 @@ impl<'a> Parser<'a> {
         let type_parameters = self.parse_optional_type_parameters()?;
         let params: Rc<[_]> = self.parse_function_params()?.into();
         let return_type = self.parse_optional_return_type()?;
-        let body = Rc::new(self.parse_block_statement()?);
+        let (body, skipped_body) = self.parse_function_body()?;
 
         let span = self.span_from(start);
         Ok(FunctionDeclaration {
@@ -508,6 +571,7 @@ impl<'a> Parser<'a> {
             return_type,
             type_parameters,
             body,
+            skipped_body,
             generator,
             async_: false,
             span,
@@ -674,6 +738,10 @@ impl<'a> Parser<'a> {
     }
 
     fn parse_class_body(&mut self) -> Result<ClassBody, JsError> {
+        self.nested_function(Self::parse_class_body_inner)
+    }
+
+    fn parse_class_body_inner(&mut self) -> Result<ClassBody, JsError> {
         let start = self.current.span;
         self.require_token(&TokenKind::LBrace)?;
 
@@ -773,6 +841,7 @@ impl<'a> Parser<'a> {
                 return_type,
                 type_parameters: type_params,
                 body,
+                skipped_body: None,
                 generator: is_generator,
                 async_: is_async,
                 span: self.span_from(start),
@@ -860,23 +929,198 @@ impl<'a> Parser<'a> {
         }
     }
 
-    fn parse_block_statement(&mut self) -> Result<BlockStatement, JsError> {
+    /// Parse a function body, or skip it when lazy parsing applies
+    ///
+    /// Only bodies outside every other function are skipped: compiling a
+    /// function needs the full AST of the functions nested in it to tell
+    /// which of its bindings they capture.
+    fn parse_function_body(
+        &mut self,
+    ) -> Result<(Rc<BlockStatement>, Option<SkippedBody>), JsError> {
+        if self.function_depth == 0
+            && let Some(source) = self.lazy_source.clone()
+            && let Some(span) = self.skip_block()
+        {
+            let body = BlockStatement {
+                body: Rc::from([]),
+                span,
+            };
+            return Ok((Rc::new(body), Some(SkippedBody { source, span })));
+        }
+        let body = self.nested_function(Self::parse_block_statement)?;
+        Ok((Rc::new(body), None))
+    }
+
+    /// Run `parse` as the body of a function or class
+    fn nested_function<T>(
+        &mut self,
+        parse: impl FnOnce(&mut Self) -> Result<T, JsError>,
+    ) -> Result<T, JsError> {
+        self.function_depth += 1;
+        let result = parse(self);
+        self.function_depth -= 1;
+        result
+    }
+
+    /// Move past the block starting at the current `{` without building an
+    /// AST, returning its span
+    ///
+    /// Tracks braces, parentheses and template substitutions, and tells a
+    /// regexp from a division by the token before the `/`. When that is
+    /// ambiguous, or the lexer finds an invalid token, the parser is left at
+    /// the `{` and `None` returned, so the caller parses the block and
+    /// reports any error up front.
+    fn skip_block(&mut self) -> Option<Span> {
         let start = self.current.span;
-        self.require_token(&TokenKind::LBrace)?;
+        if self.current.kind != TokenKind::LBrace {
+            return None;
+        }
+        let checkpoint = self.lexer.checkpoint();
+        match self.scan_to_block_end() {
+            Some(end) => {
+                let span = Span::new(start.start, end.span.end, start.line, start.column);
+                self.previous = end;
+                self.current = self.lexer.next_token();
+                Some(span)
+            }
+            None => {
+                self.lexer.restore(checkpoint);
+                None
+            }
+        }
+    }
 
-        let mut body = vec![];
+    /// Lex up to the `}` closing the current block, for [`Parser::skip_block`]
+    fn scan_to_block_end(&mut self) -> Option<Token> {
+        /// What a `/` after the previous token starts
+        #[derive(Clone, Copy)]
+        enum Slash {
+            Regexp,
+            Division,
+            Unknown,
+        }
 
-        while !self.check(&TokenKind::RBrace) && !self.is_at_end() {
-            body.push(self.parse_statement()?);
+        // `true` marks a template substitution
+        let mut braces = vec![false];
+        // `true` marks the condition of an if/while/for, after which a
+        // statement starts
+        let mut parens = Vec::new();
+        let mut slash = Slash::Regexp;
+        let mut condition_next = false;
+        let mut property_next = false;
+
+        loop {
+            let token = self.lexer.next_token();
+            let condition = condition_next;
+            let property = property_next;
+            condition_next = matches!(
+                token.kind,
+                TokenKind::If | TokenKind::While | TokenKind::For
+            );
+            property_next = matches!(token.kind, TokenKind::Dot | TokenKind::QuestionDot);
+
+            slash = match &token.kind {
+                TokenKind::LBrace => {
+                    braces.push(false);
+                    Slash::Regexp
+                }
+                TokenKind::TemplateHead(_) => {
+                    braces.push(true);
+                    Slash::Regexp
+                }
+                TokenKind::RBrace => match braces.pop()? {
+                    true => match self.lexer.rescan_template_continuation(token.span) {
+                        TokenKind::TemplateMiddle(_) => {
+                            braces.push(true);
+                            Slash::Regexp
+                        }
+                        TokenKind::TemplateTail(_) => Slash::Division,
+                        _ => return None,
+                    },
+                    false if braces.is_empty() => return Some(token),
+                    // A block or an object literal
+                    false => Slash::Unknown,
+                },
+                TokenKind::LParen => {
+                    parens.push(condition);
+                    Slash::Regexp
+                }
+                TokenKind::RParen => match parens.pop()? {
+                    true => Slash::Regexp,
+                    false => Slash::Division,
+                },
+                TokenKind::Slash | TokenKind::SlashEq => match slash {
+                    Slash::Division => Slash::Regexp,
+                    Slash::Regexp => match self.lexer.rescan_as_regexp(token.span).kind {
+                        TokenKind::RegExp(..) => Slash::Division,
+                        _ => return None,
+                    },
+                    Slash::Unknown => return None,
+                },
+                TokenKind::Invalid(_) | TokenKind::Eof => return None,
+                // Any word after a dot is a property name
+                _ if property => Slash::Division,
+                TokenKind::Identifier(_)
+                | TokenKind::Number(_)
+                | TokenKind::String(_)
+                | TokenKind::BigInt(_)
+                | TokenKind::RegExp(..)
+                | TokenKind::TemplateNoSub(_)
+                | TokenKind::True
+                | TokenKind::False
+                | TokenKind::Null
+                | TokenKind::This
+                | TokenKind::Super
+                | TokenKind::RBracket
+                // Contextual keywords `parse_identifier` accepts
+                | TokenKind::Type
+                | TokenKind::From
+                | TokenKind::As
+                | TokenKind::Namespace
+                | TokenKind::Module
+                | TokenKind::Any
+                | TokenKind::Unknown
+                | TokenKind::Never
+                | TokenKind::Keyof
+                | TokenKind::Infer
+                | TokenKind::Is
+                | TokenKind::Asserts
+                | TokenKind::Readonly => Slash::Division,
+                // Postfix or prefix, and words that are keywords in some
+                // contexts and identifiers in others
+                TokenKind::PlusPlus
+                | TokenKind::MinusMinus
+                | TokenKind::Of
+                | TokenKind::Yield
+                | TokenKind::Await
+                | TokenKind::Async
+                | TokenKind::Let
+                | TokenKind::Static
+                | TokenKind::Interface
+                | TokenKind::Enum
+                | TokenKind::Declare
+                | TokenKind::Abstract
+                | TokenKind::Accessor
+                | TokenKind::Public
+                | TokenKind::Private
+                | TokenKind::Protected
+                | TokenKind::Implements => Slash::Unknown,
+                // Operators, punctuation and reserved words
+                _ => Slash::Regexp,
+            };
         }
+    }
+
+    fn parse_block_statement(&mut self) -> Result<BlockStatement, JsError> {
+        let start = self.current.span;
+        self.require_token(&TokenKind::LBrace)?;
+
+        let body = self.parse_statement_list(|p| p.check(&TokenKind::RBrace))?;
 
         self.require_token(&TokenKind::RBrace)?;
 
         let span = self.span_from(start);
-        Ok(BlockStatement {
-            body: body.into(),
-            span,
-        })
+        Ok(BlockStatement { body, span })
     }
 
     fn parse_if_statement(&mut self) -> Result<Statement, JsError> {
@@ -992,20 +1236,17 @@ impl<'a> Parser<'a> {
                 None
             };
 
-            let mut declarations = vec![VariableDeclarator {
+            let first = VariableDeclarator {
                 id,
                 type_annotation: type_ann,
                 init: init_val,
                 span: self.span_from(decl_start),
-            }];
-
-            while self.match_token(&TokenKind::Comma) {
-                declarations.push(self.parse_variable_declarator()?);
-            }
+            };
+            let declarations = self.parse_more_declarators(first)?;
 
             Some(ForInit::Variable(VariableDeclaration {
                 kind,
-                declarations: declarations.into(),
+                declarations,
                 span: self.span_from(decl_start),
             }))
         } else {
@@ -1132,19 +1373,16 @@ impl<'a> Parser<'a> {
 
             self.require_token(&TokenKind::Colon)?;
 
-            let mut consequent = vec![];
-            while !self.check(&TokenKind::Case)
-                && !self.check(&TokenKind::Default)
-                && !self.check(&TokenKind::RBrace)
-                && !self.is_at_end()
-            {
-                consequent.push(self.parse_statement()?);
-            }
+            let consequent = self.parse_statement_list(|p| {
+                p.check(&TokenKind::Case)
+                    || p.check(&TokenKind::Default)
+                    || p.check(&TokenKind::RBrace)
+            })?;
 
             let span = self.span_from(case_start);
             cases.push(SwitchCase {
                 test,
-                consequent: consequent.into(),
+                consequent,
                 span,
             });
         }
@@ -1394,19 +1632,12 @@ impl<'a> Parser<'a> {
         let id = self.parse_identifier()?;
         self.require_token(&TokenKind::LBrace)?;
 
-        let mut body = vec![];
-        while !self.check(&TokenKind::RBrace) && !self.is_at_end() {
-            body.push(self.parse_statement()?);
-        }
+        let body = self.parse_statement_list(|p| p.check(&TokenKind::RBrace))?;
 
         self.require_token(&TokenKind::RBrace)?;
 
         let span = self.span_from(start);
-        Ok(NamespaceDeclaration {
-            id,
-            body: body.into(),
-            span,
-        })
+        Ok(NamespaceDeclaration { id, body, span })
     }
 
     /// Parse ambient declarations: declare const/let/var/function/class/namespace/module/global
@@ -2910,7 +3141,7 @@ impl<'a> Parser<'a> {
             let type_params = self.parse_optional_type_parameters()?;
             let params: Rc<[_]> = self.parse_function_params()?.into();
             let return_type = self.parse_optional_return_type()?;
-            let body = Rc::new(self.parse_block_statement()?);
+            let body = Rc::new(self.nested_function(Self::parse_block_statement)?);
 
             let func_span = self.span_from(start);
             let value = Expression::Function(Box::new(FunctionExpression {
@@ -2919,6 +3150,7 @@ impl<'a> Parser<'a> {
                 return_type,
                 type_parameters: type_params,
                 body,
+                skipped_body: None,
                 generator: is_generator,
                 async_: is_async,
                 span: func_span,
@@ -3223,10 +3455,12 @@ impl<'a> Parser<'a> {
         let return_type = self.parse_optional_return_type()?;
         self.require_token(&TokenKind::Arrow)?;
 
-        let body = if self.check(&TokenKind::LBrace) {
-            ArrowFunctionBody::Block(Rc::new(self.parse_block_statement()?))
+        let (body, skipped_body) = if self.check(&TokenKind::LBrace) {
+            let (block, skipped_body) = self.parse_function_body()?;
+            (ArrowFunctionBody::Block(block), skipped_body)
         } else {
-            ArrowFunctionBody::Expression(Rc::new(self.parse_assignment_expression()?))
+            let expr = self.nested_function(Self::parse_assignment_expression)?;
+            (ArrowFunctionBody::Expression(Rc::new(expr)), None)
         };
 
         let span = self.span_from(start);
@@ -3236,6 +3470,7 @@ impl<'a> Parser<'a> {
                 return_type,
                 type_parameters: None,
                 body: Box::new(body),
+                skipped_body,
                 async_: is_async,
                 span,
             },
@@ -3349,7 +3584,7 @@ impl<'a> Parser<'a> {
         let type_parameters = self.parse_optional_type_parameters()?;
         let params: Rc<[_]> = self.parse_function_params()?.into();
         let return_type = self.parse_optional_return_type()?;
-        let body = Rc::new(self.parse_block_statement()?);
+        let (body, skipped_body) = self.parse_function_body()?;
 
         let span = self.span_from(start);
         Ok(Expression::Function(Box::new(FunctionExpression {
@@ -3358,6 +3593,7 @@ impl<'a> Parser<'a> {
             return_type,
             type_parameters,
             body,
+            skipped_body,
             generator,
             async_: is_async,
             span,
@@ -0,0 +1,441 @@
+//! Thread pool running entry-point calls across per-thread interpreters.
+//!
+//! The pool shares serialized code, not decoded chunks: each module is
+//! compiled once into a [`CompiledModule`] held behind an `Arc`, and every
+//! worker decodes those bytes into its own interpreter the first time a job
+//! needs the module. Decoded chunks cannot be shared read-only across
+//! threads in this design. Their strings are `Rc`-based and interned in
+//! each interpreter's `StringDict` (property lookups compare them by
+//! pointer), their inline caches are `Cell`s written while the code runs,
+//! and lazily compiled bodies fill a `OnceCell` on first call. So the cost
+//! of loading a module, and the memory its chunks take, is paid once per
+//! worker that runs it. Lexing, parsing and compiling happen once; decoding
+//! is the remaining per-worker step.
+//!
+//! Workers keep the loaded module afterwards, so module-level state persists
+//! between the jobs one worker runs (but is not shared with other workers).
+//!
+//! Jobs are queued per worker round-robin; an idle worker takes work from the
+//! back of the other queues before sleeping.
+//!
+//! ```
+//! use std::sync::mpsc;
+//! use tsrun::ModulePath;
+//! use tsrun::compiler::CompiledModule;
+//! use tsrun::pool::InterpreterPool;
+//!
+//! let pool = InterpreterPool::new(2).unwrap();
+//! let module = CompiledModule::compile(
+//!     "export function add(a: number, b: number) { return a + b; }",
+//!     ModulePath::new("/math.ts"),
+//! ).unwrap();
+//! pool.add_module(module).unwrap();
+//!
+//! let (tx, rx) = mpsc::channel();
+//! pool.submit("/math.ts", "add", "[1, 2]", move |result| {
+//!     tx.send(result).unwrap();
+//! }).unwrap();
+//! assert_eq!(rx.recv().unwrap(), Ok(Some("3".to_string())));
+//! ```
+
+use std::collections::VecDeque;
+use std::panic::AssertUnwindSafe;
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, PoisonError, RwLock};
+use std::thread::JoinHandle;
+
+use crate::compiler::CompiledModule;
+use crate::interpreter::builtins::json_stream::{JsonStreamParser, json_stringify_to};
+use crate::prelude::{Box, FxHashMap, FxHashSet, String, ToString, Vec, format};
+use crate::value::{ExoticObject, PromiseStatus};
+use crate::{Interpreter, JsError, JsValue, ModulePath, StepResult, api};
+
+/// Outcome of a pool job: the entry's return value as JSON (`None` for
+/// `undefined`), or an error message.
+pub type JobResult = Result<Option<String>, String>;
+
+struct Job {
+    module: String,
+    entry: String,
+    args_json: String,
+    on_done: Box<dyn FnOnce(JobResult) + Send>,
+}
+
+#[derive(Default)]
+struct PoolState {
+    /// Jobs submitted but not yet taken by a worker
+    queued: usize,
+    /// Jobs submitted whose callback has not returned yet
+    unfinished: usize,
+    shutdown: bool,
+}
+
+struct Shared {
+    queues: Vec<Mutex<VecDeque<Job>>>,
+    state: Mutex<PoolState>,
+    work_ready: Condvar,
+    idle: Condvar,
+    modules: RwLock<FxHashMap<String, Arc<CompiledModule>>>,
+    next_queue: AtomicUsize,
+}
+
+fn lock<T>(mutex: &Mutex<T>) -> MutexGuard<'_, T> {
+    mutex.lock().unwrap_or_else(PoisonError::into_inner)
+}
+
+impl Shared {
+    fn module(&self, path: &str) -> Option<Arc<CompiledModule>> {
+        self.modules
+            .read()
+            .unwrap_or_else(PoisonError::into_inner)
+            .get(path)
+            .cloned()
+    }
+
+    /// Pop from the worker's own queue, otherwise steal from the others
+    fn take_job(&self, index: usize) -> Option<Job> {
+        if let Some(job) = self.queues.get(index).and_then(|q| lock(q).pop_front()) {
+            return Some(job);
+        }
+        let count = self.queues.len();
+        (1..count).find_map(|offset| {
+            self.queues
+                .get((index + offset) % count)
+                .and_then(|q| lock(q).pop_back())
+        })
+    }
+
+    /// Block until a job is available, or return `None` once the pool is
+    /// shutting down and every queue is empty
+    fn next_job(&self, index: usize) -> Option<Job> {
+        loop {
+            if let Some(job) = self.take_job(index) {
+                lock(&self.state).queued -= 1;
+                return Some(job);
+            }
+            let mut state = lock(&self.state);
+            // `queued` is raised before the job is pushed, so a non-zero count
+            // with empty queues means a push is in flight: retry the queues
+            while state.queued == 0 {
+                if state.shutdown {
+                    return None;
+                }
+                state = self
+                    .work_ready
+                    .wait(state)
+                    .unwrap_or_else(PoisonError::into_inner);
+            }
+        }
+    }
+
+    fn job_done(&self) {
+        let mut state = lock(&self.state);
+        state.unfinished -= 1;
+        if state.unfinished == 0 {
+            self.idle.notify_all();
+        }
+    }
+}
+
+/// A fixed set of worker threads, each owning one `Interpreter`.
+pub struct InterpreterPool {
+    shared: Arc<Shared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+impl InterpreterPool {
+    /// Start `threads` workers; 0 uses the available parallelism.
+    ///
+    /// Fails if a worker thread cannot be spawned; workers already started
+    /// are stopped first.
+    pub fn new(threads: usize) -> Result<Self, JsError> {
+        let threads = match threads {
+            0 => std::thread::available_parallelism().map_or(1, |n| n.get()),
+            n => n,
+        };
+        let shared = Arc::new(Shared {
+            queues: (0..threads).map(|_| Mutex::new(VecDeque::new())).collect(),
+            state: Mutex::new(PoolState::default()),
+            work_ready: Condvar::new(),
+            idle: Condvar::new(),
+            modules: RwLock::new(FxHashMap::default()),
+            next_queue: AtomicUsize::new(0),
+        });
+        let mut pool = Self {
+            shared,
+            workers: Vec::with_capacity(threads),
+        };
+        for index in 0..threads {
+            let shared = Arc::clone(&pool.shared);
+            let worker = std::thread::Builder::new()
+                .name(format!("tsrun-pool-{}", index))
+                .spawn(move || worker_main(&shared, index))
+                .map_err(|e| {
+                    JsError::internal_error(format!("Failed to start pool thread: {}", e))
+                })?;
+            pool.workers.push(worker);
+        }
+        Ok(pool)
+    }
+
+    /// Number of worker threads
+    pub fn threads(&self) -> usize {
+        self.workers.len()
+    }
+
+    /// Make a module available to jobs, and as an import to other modules.
+    ///
+    /// Imports resolve against the registered paths; a module's dependencies
+    /// must be added before a job that loads it runs. Paths cannot be
+    /// re-registered, since workers may already have loaded the old code.
+    pub fn add_module(&self, module: CompiledModule) -> Result<(), JsError> {
+        let mut modules = self
+            .shared
+            .modules
+            .write()
+            .unwrap_or_else(PoisonError::into_inner);
+        let path = module.path().as_str().to_string();
+        if modules.contains_key(&path) {
+            return Err(JsError::type_error(format!(
+                "Module '{}' is already in the pool",
+                path
+            )));
+        }
+        modules.insert(path, Arc::new(module));
+        Ok(())
+    }
+
+    /// Queue a call to the exported function `entry` of `module`.
+    ///
+    /// `args_json` is a JSON array of arguments (an empty string passes
+    /// none). If the entry returns a promise, its settled value is the result;
+    /// a promise still pending when the call returns fails the job, since the
+    /// pool does not fulfil orders. `on_done` runs on the worker thread.
+    pub fn submit<F>(
+        &self,
+        module: &str,
+        entry: &str,
+        args_json: &str,
+        on_done: F,
+    ) -> Result<(), JsError>
+    where
+        F: FnOnce(JobResult) + Send + 'static,
+    {
+        if self.shared.module(module).is_none() {
+            return Err(JsError::type_error(format!(
+                "Module '{}' is not in the pool",
+                module
+            )));
+        }
+        let count = self.shared.queues.len();
+        let Some(queue) = self
+            .shared
+            .queues
+            .get(self.shared.next_queue.fetch_add(1, Ordering::Relaxed) % count.max(1))
+        else {
+            return Err(JsError::type_error("Pool has no worker threads"));
+        };
+        {
+            let mut state = lock(&self.shared.state);
+            state.queued += 1;
+            state.unfinished += 1;
+        }
+        lock(queue).push_back(Job {
+            module: module.to_string(),
+            entry: entry.to_string(),
+            args_json: args_json.to_string(),
+            on_done: Box::new(on_done),
+        });
+        self.shared.work_ready.notify_one();
+        Ok(())
+    }
+
+    /// Block until every submitted job has finished and its callback returned.
+    pub fn wait_idle(&self) {
+        let mut state = lock(&self.shared.state);
+        while state.unfinished > 0 {
+            state = self
+                .shared
+                .idle
+                .wait(state)
+                .unwrap_or_else(PoisonError::into_inner);
+        }
+    }
+}
+
+impl Drop for InterpreterPool {
+    /// Runs the jobs still queued, then stops and joins the workers.
+    fn drop(&mut self) {
+        lock(&self.shared.state).shutdown = true;
+        self.shared.work_ready.notify_all();
+        for worker in self.workers.drain(..) {
+            let _ = worker.join();
+        }
+    }
+}
+
+fn worker_main(shared: &Shared, index: usize) {
+    let mut worker = Worker {
+        interp: Interpreter::new(),
+        loaded: FxHashSet::default(),
+    };
+    while let Some(job) = shared.next_job(index) {
+        let _done = JobDone(shared);
+        let result = worker.run(shared, &job.module, &job.entry, &job.args_json);
+        // A panicking callback must not take the worker (and its queue) down;
+        // the panic hook has already reported it
+        let on_done = job.on_done;
+        let _ = std::panic::catch_unwind(AssertUnwindSafe(move || on_done(result)));
+    }
+}
+
+/// Marks the current job finished when dropped, even while unwinding
+struct JobDone<'a>(&'a Shared);
+
+impl Drop for JobDone<'_> {
+    fn drop(&mut self) {
+        self.0.job_done();
+    }
+}
+
+struct Worker {
+    interp: Interpreter,
+    /// Paths of the modules this worker has evaluated
+    loaded: FxHashSet<String>,
+}
+
+impl Worker {
+    fn run(&mut self, shared: &Shared, module: &str, entry: &str, args_json: &str) -> JobResult {
+        self.load(shared, module)?;
+        let func = self
+            .interp
+            .get_module_export(&ModulePath::new(module), entry)
+            .filter(JsValue::is_callable)
+            .ok_or_else(|| format!("'{}' does not export a function '{}'", module, entry))?;
+
+        let guard = self.interp.heap.create_guard();
+        let args = if args_json.trim().is_empty() {
+            Vec::new()
+        } else {
+            let mut parser = JsonStreamParser::new(&self.interp);
+            parser
+                .feed(&mut self.interp, args_json.as_bytes())
+                .map_err(|e| e.to_string())?;
+            let parsed = parser.finish().map_err(|e| e.to_string())?;
+            if !api::is_array(&parsed.value) {
+                return Err("Job arguments must be a JSON array".to_string());
+            }
+            api::guard_value(&guard, &parsed.value);
+            api::get_elements(&parsed.value).map_err(|e| e.to_string())?
+        };
+
+        let result = api::call_function(&mut self.interp, &guard, &func, None, &args)
+            .map_err(|e| e.to_string())?;
+        let result = settled(result)?;
+        if matches!(result, JsValue::Undefined) {
+            return Ok(None);
+        }
+        let mut json = String::new();
+        json_stringify_to(&result, |chunk| {
+            json.push_str(chunk);
+            Ok(())
+        })
+        .map_err(|e| e.to_string())?;
+        Ok(Some(json))
+    }
+
+    /// Load `path` into this worker's interpreter on first use
+    ///
+    /// A failed load leaves a half-evaluated program and module graph behind,
+    /// so the worker starts over with a fresh interpreter; modules it had
+    /// loaded are evaluated again by the jobs that next need them.
+    fn load(&mut self, shared: &Shared, path: &str) -> Result<(), String> {
+        if self.loaded.contains(path) {
+            return Ok(());
+        }
+        let loaded = self.evaluate(shared, path);
+        if loaded.is_err() {
+            self.interp = Interpreter::new();
+            self.loaded.clear();
+        }
+        loaded
+    }
+
+    fn evaluate(&mut self, shared: &Shared, path: &str) -> Result<(), String> {
+        let specifier = serde_json::to_string(path).map_err(|e| e.to_string())?;
+        let driver = format!("import * as namespace from {};", specifier);
+        let mut step = self
+            .interp
+            .prepare(&driver, None)
+            .map_err(|e| e.to_string())?;
+        loop {
+            step = match step {
+                StepResult::Continue => self.interp.run_steps(usize::MAX),
+                StepResult::NeedImports(requests) => {
+                    for request in requests {
+                        let module =
+                            shared
+                                .module(request.resolved_path.as_str())
+                                .ok_or_else(|| {
+                                    format!("Module '{}' is not in the pool", request.resolved_path)
+                                })?;
+                        self.interp
+                            .provide_module_bytecode(
+                                ModulePath::new(module.path().as_str()),
+                                module.as_bytes(),
+                            )
+                            .map_err(|e| e.to_string())?;
+                    }
+                    self.interp.run_steps(usize::MAX)
+                }
+                StepResult::Complete(_) => {
+                    self.loaded.insert(path.to_string());
+                    return Ok(());
+                }
+                StepResult::Suspended { .. } => {
+                    return Err(format!(
+                        "Module '{}' waits on orders, which the pool does not fulfil",
+                        path
+                    ));
+                }
+                StepResult::Done => {
+                    return Err(format!("Module '{}' did not evaluate", path));
+                }
+            }
+            .map_err(|e| e.to_string())?;
+        }
+    }
+}
+
+/// Unwrap a settled promise; other values pass through
+fn settled(value: JsValue) -> Result<JsValue, String> {
+    let JsValue::Object(obj) = &value else {
+        return Ok(value);
+    };
+    let (status, result) = match &obj.borrow().exotic {
+        ExoticObject::Promise(state) => {
+            let state = state.borrow();
+            (state.status.clone(), state.result.clone())
+        }
+        _ => return Ok(value.clone()),
+    };
+    let result = result.unwrap_or(JsValue::Undefined);
+    match status {
+        PromiseStatus::Fulfilled => Ok(result),
+        PromiseStatus::Rejected => Err(rejection_message(&result)),
+        PromiseStatus::Pending => Err("Entry returned a promise that did not settle".to_string()),
+    }
+}
+
+fn rejection_message(reason: &JsValue) -> String {
+    if let Ok(message) = api::get_property(reason, "message")
+        && let JsValue::String(message) = message
+    {
+        let name = match api::get_property(reason, "name") {
+            Ok(JsValue::String(name)) => name.to_string(),
+            _ => "Error".to_string(),
+        };
+        return format!("{}: {}", name, message);
+    }
+    format!("Uncaught {}", reason)
+}
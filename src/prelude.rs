@@ -23,6 +23,7 @@ pub use core::{
 
 #[cfg(feature = "std")]
 pub use std::{
+    borrow::Cow,
     boxed::Box,
     collections::VecDeque,
     format,
@@ -34,6 +35,7 @@ pub use std::{
 
 #[cfg(not(feature = "std"))]
 pub use alloc::{
+    borrow::Cow,
     boxed::Box,
     collections::VecDeque,
     format,
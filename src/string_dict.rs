@@ -11,6 +11,7 @@ use crate::value::{CheapClone, JsString};
 ///
 /// Strings inserted into the dictionary are stored once and subsequent
 /// requests for the same string return a cheap clone of the existing instance.
+#[derive(Clone)]
 pub struct StringDict {
     /// Map from string content to shared JsString instance.
     /// Using Box<str> as key to avoid double-indirection through Rc.
@@ -265,7 +265,7 @@ fn trim_js_whitespace(s: &str) -> &str {
 }
 
 use crate::ast::{BlockStatement, FunctionParam};
-use crate::error::JsError;
+use crate::error::{JsError, StackFrame};
 use crate::gc::{Gc, GcPtr, Guard, Heap, Reset, Traceable};
 
 /// Trait for types that have cheap (O(1), reference-counted) clones.
@@ -714,7 +714,7 @@ impl fmt::Debug for JsValue {
             JsValue::Object(obj) => {
                 let obj = obj.borrow();
                 match &obj.exotic {
-                    ExoticObject::Ordinary => {
+                    ExoticObject::Ordinary | ExoticObject::Error(_) => {
                         // Check if this is an Error object (has name and message properties)
                         let name_key = PropertyKey::String(JsString::from("name"));
                         let message_key = PropertyKey::String(JsString::from("message"));
@@ -773,6 +773,11 @@ impl fmt::Debug for JsValue {
                     },
                     ExoticObject::RawJSON(raw) => write!(f, "[RawJSON: {}]", raw),
                     ExoticObject::PendingOrder { id, .. } => write!(f, "[PendingOrder: {}]", id),
+                    ExoticObject::ArrayBuffer(store) => write!(f, "ArrayBuffer({})", store.len()),
+                    ExoticObject::TypedArray(data) => {
+                        write!(f, "{}({})", data.kind.name(), data.length)
+                    }
+                    ExoticObject::DataView(data) => write!(f, "DataView({})", data.byte_length),
                 }
             }
         }
@@ -869,8 +874,111 @@ impl JsValue {
 }
 
 /// Reference-counted string for efficient string handling
-#[derive(Clone, PartialEq, Eq, Hash)]
-pub struct JsString(Rc<str>);
+///
+/// Concatenations that produce long strings are kept as a lazy rope (see
+/// [`JsString::concat`]) so `out += line` loops stay linear. A rope is
+/// flattened into one buffer the first time its contents are read.
+#[derive(Clone)]
+pub struct JsString(StrRepr);
+
+#[derive(Clone)]
+enum StrRepr {
+    Flat(Rc<str>),
+    Rope(Rc<RopeNode>),
+    External(Rc<ExternalStr>),
+}
+
+/// Host-owned UTF-8 wrapped without copying (see [`JsString::from_external`])
+struct ExternalStr {
+    ptr: *const u8,
+    len: usize,
+    /// Runs once, when the last copy of the string is dropped
+    release: Option<Box<dyn FnOnce()>>,
+}
+
+impl ExternalStr {
+    fn as_str(&self) -> &str {
+        if self.len == 0 {
+            return "";
+        }
+        // SAFETY: `from_external` validated the bytes as UTF-8, and its
+        // contract keeps them alive and unchanged until `release` runs
+        unsafe { core::str::from_utf8_unchecked(core::slice::from_raw_parts(self.ptr, self.len)) }
+    }
+}
+
+impl Drop for ExternalStr {
+    fn drop(&mut self) {
+        if let Some(release) = self.release.take() {
+            release();
+        }
+    }
+}
+
+/// Concatenations shorter than this are copied eagerly; ropes only pay off
+/// once copying the left side costs more than allocating a node.
+const ROPE_MIN_LEN: usize = 256;
+
+/// Interior node of a rope: the concatenation of two strings.
+struct RopeNode {
+    len: usize,
+    /// The two halves, dropped once the rope has been flattened
+    parts: RefCell<Option<(JsString, JsString)>>,
+    flat: core::cell::OnceCell<Rc<str>>,
+}
+
+impl RopeNode {
+    fn as_str(&self) -> &str {
+        self.flat.get_or_init(|| {
+            let mut out = String::with_capacity(self.len);
+            // Walk right-to-left on an explicit stack: ropes built by
+            // `s += x` loops are as deep as the loop is long.
+            let mut pending: Vec<JsString> = Vec::new();
+            if let Some((left, right)) = self.parts.borrow_mut().take() {
+                pending.push(right);
+                pending.push(left);
+            }
+            while let Some(part) = pending.pop() {
+                match &part.0 {
+                    StrRepr::Flat(s) => out.push_str(s),
+                    StrRepr::External(ext) => out.push_str(ext.as_str()),
+                    StrRepr::Rope(node) => {
+                        if let Some(flat) = node.flat.get() {
+                            out.push_str(flat);
+                        } else if let Some((left, right)) = &*node.parts.borrow() {
+                            pending.push(right.cheap_clone());
+                            pending.push(left.cheap_clone());
+                        }
+                    }
+                }
+            }
+            out.into()
+        })
+    }
+}
+
+impl Drop for RopeNode {
+    fn drop(&mut self) {
+        // Unlink uniquely owned children iteratively so dropping a deep rope
+        // cannot overflow the stack.
+        let mut pending: Vec<Rc<RopeNode>> = Vec::new();
+        let detach = |parts: Option<(JsString, JsString)>, pending: &mut Vec<_>| {
+            if let Some((left, right)) = parts {
+                for part in [left, right] {
+                    if let StrRepr::Rope(node) = part.0 {
+                        pending.push(node);
+                    }
+                }
+            }
+        };
+        detach(self.parts.get_mut().take(), &mut pending);
+        while let Some(node) = pending.pop() {
+            if let Ok(mut node) = Rc::try_unwrap(node) {
+                detach(node.parts.get_mut().take(), &mut pending);
+            }
+        }
+    }
+}
 
 /// A key for variable lookups that uses pointer-based hashing.
 ///
@@ -888,15 +996,14 @@ impl Hash for VarKey {
     fn hash<H: Hasher>(&self, state: &mut H) {
         // Hash the pointer address, not the content
         // Use the data pointer from the fat pointer (Rc<str> is a fat pointer)
-        let ptr = Rc::as_ptr(&self.0.0) as *const () as usize;
-        ptr.hash(state);
+        self.0.0.ptr_addr().hash(state);
     }
 }
 
 impl PartialEq for VarKey {
     fn eq(&self, other: &Self) -> bool {
         // Compare pointer addresses, not content
-        Rc::ptr_eq(&self.0.0, &other.0.0)
+        self.0.0.ptr_addr() == other.0.0.ptr_addr()
     }
 }
 
@@ -951,69 +1058,175 @@ impl PrivateFieldKey {
 // JsString wraps Rc<str>, so clone is cheap (just reference count increment)
 impl CheapClone for JsString {}
 
+impl StrRepr {
+    /// Address identifying the allocation, for pointer-keyed lookups
+    #[inline]
+    fn ptr_addr(&self) -> usize {
+        match self {
+            StrRepr::Flat(s) => Rc::as_ptr(s) as *const () as usize,
+            StrRepr::Rope(node) => Rc::as_ptr(node) as *const () as usize,
+            StrRepr::External(ext) => Rc::as_ptr(ext) as *const () as usize,
+        }
+    }
+}
+
 impl JsString {
+    /// The string contents, flattening a rope on first access
+    #[inline]
     pub fn as_str(&self) -> &str {
-        &self.0
+        match &self.0 {
+            StrRepr::Flat(s) => s,
+            StrRepr::Rope(node) => node.as_str(),
+            StrRepr::External(ext) => ext.as_str(),
+        }
     }
 
     pub fn is_empty(&self) -> bool {
-        self.0.is_empty()
+        self.len() == 0
     }
 
+    /// Length in bytes (does not flatten a rope)
     pub fn len(&self) -> usize {
-        self.0.len()
+        match &self.0 {
+            StrRepr::Flat(s) => s.len(),
+            StrRepr::Rope(node) => node.len,
+            StrRepr::External(ext) => ext.len,
+        }
+    }
+
+    /// Whether this string is an unflattened rope
+    pub fn is_rope(&self) -> bool {
+        matches!(&self.0, StrRepr::Rope(node) if node.flat.get().is_none())
+    }
+
+    /// Wrap `len` bytes of host-owned UTF-8 at `ptr` without copying them.
+    /// `release` runs when the last copy of the string is dropped.
+    ///
+    /// The bytes are validated once here. On error nothing is taken over:
+    /// `release` is dropped without running and the memory stays the
+    /// caller's.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must stay valid and unchanged for `len` bytes until `release`
+    /// runs (forever if there is none).
+    pub unsafe fn from_external(
+        ptr: *const u8,
+        len: usize,
+        release: Option<Box<dyn FnOnce()>>,
+    ) -> Result<JsString, core::str::Utf8Error> {
+        if len > 0 {
+            // SAFETY: the caller guarantees `len` readable bytes at `ptr`
+            core::str::from_utf8(unsafe { core::slice::from_raw_parts(ptr, len) })?;
+        }
+        Ok(JsString(StrRepr::External(Rc::new(ExternalStr {
+            ptr,
+            len,
+            release,
+        }))))
+    }
+
+    /// Whether this string's bytes are host memory
+    pub fn is_external(&self) -> bool {
+        matches!(&self.0, StrRepr::External(_))
     }
 
     pub fn parse<F: core::str::FromStr>(&self) -> Result<F, F::Err> {
-        self.0.parse()
+        self.as_str().parse()
+    }
+
+    /// Concatenate two strings.
+    ///
+    /// Short results are copied into a new buffer; long ones share both
+    /// halves in a rope node, so repeated appends cost O(1) each and the
+    /// copy happens once when the result is first read.
+    pub fn concat(&self, other: &JsString) -> JsString {
+        if other.is_empty() {
+            return self.cheap_clone();
+        }
+        if self.is_empty() {
+            return other.cheap_clone();
+        }
+        let len = self.len() + other.len();
+        if len < ROPE_MIN_LEN {
+            let mut s = String::with_capacity(len);
+            s.push_str(self.as_str());
+            s.push_str(other.as_str());
+            return JsString::from(s);
+        }
+        JsString(StrRepr::Rope(Rc::new(RopeNode {
+            len,
+            parts: RefCell::new(Some((self.cheap_clone(), other.cheap_clone()))),
+            flat: core::cell::OnceCell::new(),
+        })))
+    }
+}
+
+impl PartialEq for JsString {
+    fn eq(&self, other: &Self) -> bool {
+        if let (StrRepr::Flat(a), StrRepr::Flat(b)) = (&self.0, &other.0)
+            && Rc::ptr_eq(a, b)
+        {
+            return true;
+        }
+        self.len() == other.len() && self.as_str() == other.as_str()
+    }
+}
+
+impl Eq for JsString {}
+
+impl Hash for JsString {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        // Must match `str`'s hash for `Borrow<str>` lookups
+        self.as_str().hash(state);
     }
 }
 
 impl AsRef<str> for JsString {
     fn as_ref(&self) -> &str {
-        &self.0
+        self.as_str()
     }
 }
 
 impl core::borrow::Borrow<str> for JsString {
     fn borrow(&self) -> &str {
-        &self.0
+        self.as_str()
     }
 }
 
 impl PartialEq<str> for JsString {
     fn eq(&self, other: &str) -> bool {
-        self.0.as_ref() == other
+        self.as_str() == other
     }
 }
 
 impl PartialEq<&str> for JsString {
     fn eq(&self, other: &&str) -> bool {
-        self.0.as_ref() == *other
+        self.as_str() == *other
     }
 }
 
 impl From<&str> for JsString {
     fn from(s: &str) -> Self {
-        JsString(s.into())
+        JsString(StrRepr::Flat(s.into()))
     }
 }
 
 impl From<String> for JsString {
     fn from(s: String) -> Self {
-        JsString(s.into())
+        JsString(StrRepr::Flat(s.into()))
     }
 }
 
 impl fmt::Debug for JsString {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-        write!(f, "\"{}\"", self.0)
+        write!(f, "\"{}\"", self.as_str())
     }
 }
 
 impl fmt::Display for JsString {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-        write!(f, "{}", self.0)
+        write!(f, "{}", self.as_str())
     }
 }
 
@@ -1021,7 +1234,8 @@ impl core::ops::Add<&str> for JsString {
     type Output = JsString;
 
     fn add(self, other: &str) -> JsString {
-        let mut s = String::from(&*self.0);
+        let mut s = String::with_capacity(self.len() + other.len());
+        s.push_str(self.as_str());
         s.push_str(other);
         JsString::from(s)
     }
@@ -1031,9 +1245,7 @@ impl core::ops::Add<&JsString> for JsString {
     type Output = JsString;
 
     fn add(self, other: &JsString) -> JsString {
-        let mut s = String::from(&*self.0);
-        s.push_str(&other.0);
-        JsString::from(s)
+        self.concat(other)
     }
 }
 
@@ -1297,14 +1509,17 @@ impl Traceable for JsObject {
                 }
             }
             ExoticObject::Array { elements } => {
-                // Trace all array elements that are objects
-                for elem in elements {
-                    if let JsValue::Object(obj) = elem {
-                        visitor(obj.copy_ref());
+                // Trace all array elements that are objects (packed arrays hold none)
+                if let ArrayElements::Generic(elements) = elements {
+                    for elem in elements {
+                        if let JsValue::Object(obj) = elem {
+                            visitor(obj.copy_ref());
+                        }
                     }
                 }
             }
             ExoticObject::Ordinary
+            | ExoticObject::Error(_)
             | ExoticObject::Date { .. }
             | ExoticObject::RegExp { .. }
             | ExoticObject::Enum(_)
@@ -1313,7 +1528,8 @@ impl Traceable for JsObject {
             | ExoticObject::StringObj(_)
             | ExoticObject::Symbol(_)
             | ExoticObject::RawJSON(_)
-            | ExoticObject::PendingOrder { .. } => {
+            | ExoticObject::PendingOrder { .. }
+            | ExoticObject::ArrayBuffer(_) => {
                 // These exotic types don't contain object references that need tracing
             }
             ExoticObject::Proxy(proxy_data) => {
@@ -1321,6 +1537,8 @@ impl Traceable for JsObject {
                 visitor(proxy_data.target.copy_ref());
                 visitor(proxy_data.handler.copy_ref());
             }
+            ExoticObject::TypedArray(data) => visitor(data.buffer.copy_ref()),
+            ExoticObject::DataView(data) => visitor(data.buffer.copy_ref()),
         }
 
         // Trace private fields (may contain object references)
@@ -1332,6 +1550,20 @@ impl Traceable for JsObject {
             }
         }
     }
+
+    fn needs_final_trace(&self) -> bool {
+        // These keep their references in state shared through Rc<RefCell<_>>,
+        // which is updated without borrowing the object itself
+        matches!(
+            &self.exotic,
+            ExoticObject::Promise(_)
+                | ExoticObject::Generator(_)
+                | ExoticObject::BytecodeGenerator(_)
+                | ExoticObject::Function(
+                    JsFunction::PromiseAllFulfill { .. } | JsFunction::PromiseAllReject(_)
+                )
+        )
+    }
 }
 
 /// A JavaScript object
@@ -1441,7 +1673,7 @@ impl JsObject {
         if let ExoticObject::Array { ref elements } = self.exotic {
             match key {
                 PropertyKey::Index(idx) => {
-                    return elements.get(*idx as usize).cloned();
+                    return elements.get(*idx as usize);
                 }
                 PropertyKey::String(s) if s.as_str() == "length" => {
                     return Some(JsValue::Number(elements.len() as f64));
@@ -1450,6 +1682,15 @@ impl JsObject {
             }
         }
 
+        // For binary data, handle typed array elements and byte-level accessors
+        if let Some(value) = self.binary_data_property(key) {
+            return value;
+        }
+
+        if let Some(stack) = self.error_stack(key) {
+            return Some(stack);
+        }
+
         // For functions, handle name and length properties
         if let ExoticObject::Function(ref func) = self.exotic
             && let PropertyKey::String(s) = key
@@ -1585,7 +1826,7 @@ impl JsObject {
             match key {
                 PropertyKey::Index(idx) => {
                     if let Some(val) = elements.get(*idx as usize) {
-                        return Some((Property::data(val.clone()), false));
+                        return Some((Property::data(val), false));
                     }
                     // Index out of bounds - return None (falls through to prototype)
                 }
@@ -1599,6 +1840,15 @@ impl JsObject {
             }
         }
 
+        // Typed array elements out of range are absent, not inherited
+        if let Some(value) = self.binary_data_property(key) {
+            return value.map(|v| (Property::data(v), false));
+        }
+
+        if let Some(stack) = self.error_stack(key) {
+            return Some((Property::with_attributes(stack, true, false, true), false));
+        }
+
         // For Maps, compute size from entries
         if let ExoticObject::Map { ref entries } = self.exotic
             && let PropertyKey::String(s) = key
@@ -1765,18 +2015,21 @@ impl JsObject {
             return;
         }
 
+        // Typed array elements are stored in the buffer; the byte-level
+        // accessors have no setters
+        if self.exotic.is_binary_data() && self.exotic.intercepts_property(&key) {
+            if let (ExoticObject::TypedArray(data), PropertyKey::Index(idx)) = (&self.exotic, &key)
+            {
+                data.set(*idx as usize, value.to_number());
+            }
+            return;
+        }
+
         // For arrays, handle index access via elements Vec
         if let ExoticObject::Array { ref mut elements } = self.exotic {
             if let PropertyKey::Index(idx) = key {
-                let idx = idx as usize;
-                // Extend array with undefined if needed (dense array)
-                if idx >= elements.len() {
-                    elements.resize(idx + 1, JsValue::Undefined);
-                }
-                // Safe: we just resized to ensure idx is in bounds
-                if let Some(slot) = elements.get_mut(idx) {
-                    *slot = value;
-                }
+                // Extends the array with undefined if needed (dense array)
+                elements.set(idx as usize, value);
                 return;
             }
             // Setting length truncates or extends the array
@@ -1784,8 +2037,7 @@ impl JsObject {
                 && s.as_str() == "length"
             {
                 if let JsValue::Number(n) = value {
-                    let new_len = n as usize;
-                    elements.resize(new_len, JsValue::Undefined);
+                    elements.resize(n as usize);
                 }
                 return;
             }
@@ -1834,7 +2086,67 @@ impl JsObject {
 
     /// Check if object has own property
     pub fn has_own_property(&self, key: &PropertyKey) -> bool {
-        self.properties.contains_key(key)
+        if let (ExoticObject::TypedArray(data), PropertyKey::Index(idx)) = (&self.exotic, key) {
+            return (*idx as usize) < data.length;
+        }
+        self.properties.contains_key(key) || self.error_stack(key).is_some()
+    }
+
+    /// The `stack` of an error object without an own `stack` property,
+    /// formatted from the recorded call sites
+    #[inline]
+    fn error_stack(&self, key: &PropertyKey) -> Option<JsValue> {
+        match (&self.exotic, key) {
+            (ExoticObject::Error(data), PropertyKey::String(name))
+                if name.as_str() == "stack" && !self.properties.contains_key(key) =>
+            {
+                Some(JsValue::String(data.stack(self)))
+            }
+            _ => None,
+        }
+    }
+
+    /// Properties answered by binary data state: typed array elements and the
+    /// `length`/`byteLength`/`byteOffset`/`buffer` accessors. `Some(None)` is
+    /// an out-of-range element, which is not looked up on the prototype.
+    #[inline]
+    fn binary_data_property(&self, key: &PropertyKey) -> Option<Option<JsValue>> {
+        let number = |n: usize| Some(Some(JsValue::Number(n as f64)));
+        let object = |obj: &JsObjectRef| Some(Some(JsValue::Object(obj.cheap_clone())));
+        match (&self.exotic, key) {
+            (ExoticObject::TypedArray(data), PropertyKey::Index(idx)) => {
+                Some(data.get(*idx as usize).map(JsValue::Number))
+            }
+            (ExoticObject::TypedArray(data), PropertyKey::String(name)) => match name.as_str() {
+                "length" => number(data.length),
+                "byteLength" => number(data.byte_length()),
+                "byteOffset" => number(data.byte_offset),
+                "buffer" => object(&data.buffer),
+                _ => None,
+            },
+            (ExoticObject::ArrayBuffer(store), PropertyKey::String(name))
+                if name.as_str() == "byteLength" =>
+            {
+                number(store.len())
+            }
+            (ExoticObject::DataView(data), PropertyKey::String(name)) => match name.as_str() {
+                "byteLength" => number(data.byte_length),
+                "byteOffset" => number(data.byte_offset),
+                "buffer" => object(&data.buffer),
+                _ => None,
+            },
+            _ => None,
+        }
+    }
+
+    /// Get typed array state if this is a typed array
+    #[inline]
+    pub fn typed_array(&self) -> Option<&TypedArrayData> {
+        if let ExoticObject::TypedArray(ref data) = self.exotic {
+            Some(data)
+        } else {
+            None
+        }
     }
 
     /// Get own property keys
@@ -1856,9 +2168,20 @@ impl JsObject {
         }
     }
 
-    /// Get array elements slice if this is an array
+    /// Get array elements as a slice if this is an array
+    ///
+    /// Packed arrays are copied into boxed values; code that can work on
+    /// either kind should use `array_storage` instead.
+    pub fn array_elements(&self) -> Option<Cow<'_, [JsValue]>> {
+        self.array_storage().map(|elements| match elements {
+            ArrayElements::Generic(values) => Cow::Borrowed(values.as_slice()),
+            ArrayElements::Double(_) => Cow::Owned(elements.to_vec()),
+        })
+    }
+
+    /// Get the array's element storage if this is an array
     #[inline]
-    pub fn array_elements(&self) -> Option<&[JsValue]> {
+    pub fn array_storage(&self) -> Option<&ArrayElements> {
         if let ExoticObject::Array { ref elements } = self.exotic {
             Some(elements)
         } else {
@@ -1866,9 +2189,18 @@ impl JsObject {
         }
     }
 
-    /// Get mutable array elements if this is an array
+    /// Get mutable array elements if this is an array.
+    ///
+    /// This moves a packed array to generic storage; code that can keep it
+    /// packed should use `array_storage_mut` instead.
     #[inline]
     pub fn array_elements_mut(&mut self) -> Option<&mut Vec<JsValue>> {
+        self.array_storage_mut().map(ArrayElements::make_generic)
+    }
+
+    /// Get the array's element storage, in whatever kind it currently has
+    #[inline]
+    pub fn array_storage_mut(&mut self) -> Option<&mut ArrayElements> {
         if let ExoticObject::Array { ref mut elements } = self.exotic {
             Some(elements)
         } else {
@@ -2121,28 +2453,178 @@ impl Property {
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// Property Storage - optimized for small objects
+// Property Storage - hidden-class shapes
 // ═══════════════════════════════════════════════════════════════════════════════
 
-/// Maximum number of properties stored inline before switching to a HashMap.
-/// 2 properties covers most small objects like `{ a, b }` or `{ x: 1, y: 2 }`.
-const INLINE_PROPERTY_CAPACITY: usize = 2;
+/// Shapes with at most this many keys are always searched linearly
+const SHAPE_LINEAR_SCAN_LIMIT: usize = 8;
+
+/// Lookups on a larger shape before it builds its key -> slot index. Most
+/// intermediate shapes are only passed through while an object is being
+/// built, so they never pay for an index.
+const SHAPE_INDEX_THRESHOLD: u8 = 4;
+
+/// Objects with more own properties than this switch to dictionary storage,
+/// which bounds the key lists copied into each shape.
+const MAX_SHAPED_PROPERTIES: usize = 32;
+
+/// Hidden class describing the property layout of an object.
+///
+/// Objects that receive the same keys in the same order share a `Shape`, so the
+/// slot of a key is known from the shape alone. The VM's inline caches rely on
+/// this: a cache entry records (shape, slot) and a hit is a pointer compare.
+///
+/// Shapes form a transition tree rooted at a per-thread empty shape. Children
+/// keep their parent alive while parents hold transitions weakly, so a layout
+/// and its prefixes die with the last object using them. A shape only stores
+/// the key it added; the full key list and the key -> slot index are built on
+/// first use, so the intermediate shapes an object passes through while it is
+/// being filled cost one allocation each.
+pub struct Shape {
+    /// Shape this one was derived from by adding `key`
+    parent: Option<Rc<Shape>>,
+    /// Key added by this shape, stored in slot `len - 1`
+    key: Option<PropertyKey>,
+    /// Number of keys (and slots)
+    len: usize,
+    /// Keys in slot order, collected from the parent chain on demand
+    keys: core::cell::OnceCell<Box<[PropertyKey]>>,
+    /// Key -> slot lookup for shapes too large to scan, built on demand
+    index: core::cell::OnceCell<FxHashMap<PropertyKey, u32>>,
+    /// Linear lookups so far, counted until the index is built
+    scans: Cell<u8>,
+    /// Shapes reached by adding one key to this one
+    transitions: RefCell<FxHashMap<PropertyKey, Weak<Shape>>>,
+}
+
+impl Shape {
+    /// The empty shape every new object on this thread starts from
+    #[cfg(feature = "std")]
+    pub fn root() -> Rc<Shape> {
+        std::thread_local! {
+            static ROOT: Rc<Shape> = Shape::new(None, None, 0);
+        }
+        ROOT.with(Rc::clone)
+    }
+
+    /// Without thread-locals there is no shared root; each call starts a new tree
+    #[cfg(not(feature = "std"))]
+    pub fn root() -> Rc<Shape> {
+        Shape::new(None, None, 0)
+    }
+
+    fn new(parent: Option<Rc<Shape>>, key: Option<PropertyKey>, len: usize) -> Rc<Shape> {
+        Rc::new(Shape {
+            parent,
+            key,
+            len,
+            keys: core::cell::OnceCell::new(),
+            index: core::cell::OnceCell::new(),
+            scans: Cell::new(0),
+            transitions: RefCell::new(FxHashMap::default()),
+        })
+    }
+
+    /// Number of keys (and slots) described by this shape
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Check if this is the empty shape
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Keys in slot order
+    pub fn keys(&self) -> &[PropertyKey] {
+        self.keys.get_or_init(|| {
+            let mut keys = Vec::with_capacity(self.len);
+            let mut shape = Some(self);
+            while let Some(current) = shape {
+                keys.extend(current.key.iter().cloned());
+                shape = current.parent.as_deref();
+            }
+            keys.reverse();
+            keys.into_boxed_slice()
+        })
+    }
+
+    /// Find the slot holding `key`
+    #[inline]
+    pub fn lookup(&self, key: &PropertyKey) -> Option<usize> {
+        if let Some(index) = self.index.get() {
+            return index.get(key).map(|&slot| slot as usize);
+        }
+        if self.len > SHAPE_LINEAR_SCAN_LIMIT {
+            let scans = self.scans.get();
+            if scans >= SHAPE_INDEX_THRESHOLD {
+                let index = self.index.get_or_init(|| {
+                    self.keys()
+                        .iter()
+                        .enumerate()
+                        .map(|(slot, k)| (k.clone(), slot as u32))
+                        .collect()
+                });
+                return index.get(key).map(|&slot| slot as usize);
+            }
+            self.scans.set(scans + 1);
+        }
+        if let Some(keys) = self.keys.get() {
+            return keys.iter().position(|k| k == key);
+        }
+        let mut shape = Some(self);
+        while let Some(current) = shape {
+            if current.key.as_ref() == Some(key) {
+                return Some(current.len - 1);
+            }
+            shape = current.parent.as_deref();
+        }
+        None
+    }
+
+    /// The shape reached by appending `key`, shared with every other object
+    /// that took the same transition
+    fn with_key(self: &Rc<Self>, key: &PropertyKey) -> Rc<Shape> {
+        let mut transitions = self.transitions.borrow_mut();
+        if let Some(next) = transitions.get(key).and_then(Weak::upgrade) {
+            return next;
+        }
+
+        // Forget layouts nobody uses any more before the table grows further
+        if transitions.len() >= SHAPE_LINEAR_SCAN_LIMIT && transitions.len().is_power_of_two() {
+            transitions.retain(|_, shape| shape.strong_count() > 0);
+        }
+
+        let next = Shape::new(Some(Rc::clone(self)), Some(key.clone()), self.len + 1);
+        transitions.insert(key.clone(), Rc::downgrade(&next));
+        next
+    }
+}
+
+impl fmt::Debug for Shape {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_struct("Shape").field("keys", &self.keys()).finish()
+    }
+}
 
-/// Optimized property storage that uses inline storage for small objects.
+/// Own property storage of an object.
 ///
-/// Most JavaScript objects have only a few properties. By storing up to 2 properties
-/// inline (without heap allocation), we avoid the overhead of a HashMap for common cases.
-/// When the object grows beyond 2 properties, we transparently switch to a HashMap.
+/// Ordinary objects use a shared [`Shape`] plus a slot vector, so objects built
+/// the same way (class instances, literals) share one layout and can be read
+/// through inline caches. Objects that delete properties, use integer keys or
+/// grow past `MAX_SHAPED_PROPERTIES` fall back to an insertion-ordered map.
+/// Without `std` there is no per-thread root shape, so objects always use the map.
 #[derive(Debug)]
 pub enum PropertyStorage {
-    /// Inline storage for small objects (≤2 properties).
-    /// Uses a fixed-size array with a length counter.
-    Inline {
-        len: u8,
-        entries: [(PropertyKey, Property); INLINE_PROPERTY_CAPACITY],
+    /// `slots[i]` holds the property named by `shape.keys()[i]`
+    Shaped {
+        shape: Rc<Shape>,
+        slots: Vec<Property>,
     },
-    /// HashMap storage for larger objects.
-    Map(FxHashMap<PropertyKey, Property>),
+    /// Insertion-ordered map for objects that left the shape tree
+    Dictionary(IndexMap<PropertyKey, Property>),
 }
 
 impl Default for PropertyStorage {
@@ -2152,53 +2634,49 @@ impl Default for PropertyStorage {
 }
 
 impl PropertyStorage {
-    /// Create empty inline storage.
+    /// Create empty storage.
     #[inline]
     pub fn new() -> Self {
-        PropertyStorage::Inline {
-            len: 0,
-            entries: core::array::from_fn(|_| {
-                (PropertyKey::Index(0), Property::data(JsValue::Undefined))
-            }),
+        #[cfg(feature = "std")]
+        {
+            PropertyStorage::Shaped {
+                shape: Shape::root(),
+                slots: Vec::new(),
+            }
+        }
+        #[cfg(not(feature = "std"))]
+        {
+            PropertyStorage::Dictionary(index_map_new())
         }
     }
 
     /// Create storage with pre-allocated capacity.
-    /// If capacity > INLINE_PROPERTY_CAPACITY, creates a HashMap.
     #[inline]
     pub fn with_capacity(capacity: usize) -> Self {
-        if capacity <= INLINE_PROPERTY_CAPACITY {
-            Self::new()
-        } else {
-            PropertyStorage::Map(FxHashMap::with_capacity_and_hasher(
-                capacity,
-                Default::default(),
-            ))
-        }
+        let mut storage = Self::new();
+        storage.reserve(capacity);
+        storage
     }
 
-    /// Reserve capacity. Only meaningful for Map variant.
+    /// Reserve capacity for additional properties.
     #[inline]
     pub fn reserve(&mut self, additional: usize) {
-        if let PropertyStorage::Map(map) = self {
-            map.reserve(additional);
+        match self {
+            PropertyStorage::Shaped { slots, .. } => {
+                slots.reserve(additional.min(MAX_SHAPED_PROPERTIES))
+            }
+            PropertyStorage::Dictionary(map) => map.reserve(additional),
         }
-        // For Inline, we'll convert to Map when needed during insert
     }
 
     /// Get a property by key.
     #[inline]
     pub fn get(&self, key: &PropertyKey) -> Option<&Property> {
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                for entry in entries.get(..(*len as usize)).unwrap_or_default() {
-                    if &entry.0 == key {
-                        return Some(&entry.1);
-                    }
-                }
-                None
+            PropertyStorage::Shaped { shape, slots } => {
+                shape.lookup(key).and_then(|slot| slots.get(slot))
             }
-            PropertyStorage::Map(map) => map.get(key),
+            PropertyStorage::Dictionary(map) => map.get(key),
         }
     }
 
@@ -2206,56 +2684,29 @@ impl PropertyStorage {
     #[inline]
     pub fn get_mut(&mut self, key: &PropertyKey) -> Option<&mut Property> {
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                for entry in entries.get_mut(..(*len as usize)).unwrap_or_default() {
-                    if &entry.0 == key {
-                        return Some(&mut entry.1);
-                    }
-                }
-                None
+            PropertyStorage::Shaped { shape, slots } => {
+                shape.lookup(key).and_then(|slot| slots.get_mut(slot))
             }
-            PropertyStorage::Map(map) => map.get_mut(key),
+            PropertyStorage::Dictionary(map) => map.get_mut(key),
         }
     }
 
     /// Insert or update a property. Returns the old value if the key existed.
     pub fn insert(&mut self, key: PropertyKey, value: Property) -> Option<Property> {
-        match self {
-            PropertyStorage::Inline { len, entries } => {
-                let current_len = *len as usize;
-
-                // Check if key already exists
-                for entry in entries.get_mut(..current_len).unwrap_or_default() {
-                    if entry.0 == key {
-                        let old = mem::replace(&mut entry.1, value);
-                        return Some(old);
-                    }
-                }
-
-                // Key doesn't exist - try to add inline
-                if let Some(slot) = entries.get_mut(current_len) {
-                    *slot = (key, value);
-                    *len += 1;
-                    return None;
-                }
-
-                // Need to convert to Map (current_len == INLINE_PROPERTY_CAPACITY)
-                let mut map = FxHashMap::with_capacity_and_hasher(
-                    INLINE_PROPERTY_CAPACITY + 1,
-                    Default::default(),
-                );
-                for entry in entries.iter_mut() {
-                    let (k, v) = mem::replace(
-                        entry,
-                        (PropertyKey::Index(0), Property::data(JsValue::Undefined)),
-                    );
-                    map.insert(k, v);
-                }
-                map.insert(key, value);
-                *self = PropertyStorage::Map(map);
-                None
+        if let PropertyStorage::Shaped { shape, slots } = self {
+            if let Some(slot) = shape.lookup(&key).and_then(|slot| slots.get_mut(slot)) {
+                return Some(mem::replace(slot, value));
+            }
+            if !matches!(key, PropertyKey::Index(_)) && shape.len() < MAX_SHAPED_PROPERTIES {
+                *shape = shape.with_key(&key);
+                slots.push(value);
+                return None;
             }
-            PropertyStorage::Map(map) => map.insert(key, value),
+            self.make_dictionary();
+        }
+        match self {
+            PropertyStorage::Dictionary(map) => map.insert(key, value),
+            PropertyStorage::Shaped { .. } => None,
         }
     }
 
@@ -2263,55 +2714,20 @@ impl PropertyStorage {
     #[inline]
     pub fn contains_key(&self, key: &PropertyKey) -> bool {
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                for entry in entries.get(..(*len as usize)).unwrap_or_default() {
-                    if &entry.0 == key {
-                        return true;
-                    }
-                }
-                false
-            }
-            PropertyStorage::Map(map) => map.contains_key(key),
+            PropertyStorage::Shaped { shape, .. } => shape.lookup(key).is_some(),
+            PropertyStorage::Dictionary(map) => map.contains_key(key),
         }
     }
 
     /// Remove a property by key. Returns the removed value if it existed.
     pub fn remove(&mut self, key: &PropertyKey) -> Option<Property> {
+        if let PropertyStorage::Shaped { shape, .. } = self {
+            shape.lookup(key)?;
+            self.make_dictionary();
+        }
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                let current_len = *len as usize;
-                let mut found_idx = None;
-                for (i, entry) in entries
-                    .get(..current_len)
-                    .unwrap_or_default()
-                    .iter()
-                    .enumerate()
-                {
-                    if &entry.0 == key {
-                        found_idx = Some(i);
-                        break;
-                    }
-                }
-                if let Some(i) = found_idx {
-                    // Swap with last element and decrement len
-                    let removed = if let Some(entry) = entries.get_mut(i) {
-                        mem::replace(
-                            entry,
-                            (PropertyKey::Index(0), Property::data(JsValue::Undefined)),
-                        )
-                    } else {
-                        return None;
-                    };
-                    if i < current_len - 1 {
-                        entries.swap(i, current_len - 1);
-                    }
-                    *len -= 1;
-                    Some(removed.1)
-                } else {
-                    None
-                }
-            }
-            PropertyStorage::Map(map) => map.remove(key),
+            PropertyStorage::Dictionary(map) => map.shift_remove(key),
+            PropertyStorage::Shaped { .. } => None,
         }
     }
 
@@ -2319,14 +2735,17 @@ impl PropertyStorage {
     #[inline]
     pub fn clear(&mut self) {
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                // Reset entries to avoid holding references
-                for entry in entries.get_mut(..(*len as usize)).unwrap_or_default() {
-                    *entry = (PropertyKey::Index(0), Property::data(JsValue::Undefined));
+            // clear() preserves slot capacity for pooled objects
+            PropertyStorage::Shaped { shape, slots } => {
+                if !shape.is_empty() {
+                    *shape = Shape::root();
                 }
-                *len = 0;
+                slots.clear();
             }
-            PropertyStorage::Map(map) => map.clear(),
+            #[cfg(feature = "std")]
+            PropertyStorage::Dictionary(_) => *self = Self::new(),
+            #[cfg(not(feature = "std"))]
+            PropertyStorage::Dictionary(map) => map.clear(),
         }
     }
 
@@ -2334,8 +2753,8 @@ impl PropertyStorage {
     #[inline]
     pub fn len(&self) -> usize {
         match self {
-            PropertyStorage::Inline { len, .. } => *len as usize,
-            PropertyStorage::Map(map) => map.len(),
+            PropertyStorage::Shaped { slots, .. } => slots.len(),
+            PropertyStorage::Dictionary(map) => map.len(),
         }
     }
 
@@ -2345,28 +2764,50 @@ impl PropertyStorage {
         self.len() == 0
     }
 
-    /// Iterate over all (key, value) pairs.
+    /// The shape of this object, if it still uses shaped storage
+    #[inline]
+    pub fn shape(&self) -> Option<&Rc<Shape>> {
+        match self {
+            PropertyStorage::Shaped { shape, .. } => Some(shape),
+            PropertyStorage::Dictionary(_) => None,
+        }
+    }
+
+    /// Get the property in `slot` of a shaped object
+    #[inline]
+    pub fn slot(&self, slot: usize) -> Option<&Property> {
+        match self {
+            PropertyStorage::Shaped { slots, .. } => slots.get(slot),
+            PropertyStorage::Dictionary(_) => None,
+        }
+    }
+
+    /// Get the property in `slot` of a shaped object mutably
+    #[inline]
+    pub fn slot_mut(&mut self, slot: usize) -> Option<&mut Property> {
+        match self {
+            PropertyStorage::Shaped { slots, .. } => slots.get_mut(slot),
+            PropertyStorage::Dictionary(_) => None,
+        }
+    }
+
+    /// Iterate over all (key, value) pairs in insertion order.
     pub fn iter(&self) -> PropertyStorageIter<'_> {
         match self {
-            PropertyStorage::Inline { len, entries } => PropertyStorageIter::Inline {
-                entries,
-                index: 0,
-                len: *len as usize,
-            },
-            PropertyStorage::Map(map) => PropertyStorageIter::Map(map.iter()),
+            PropertyStorage::Shaped { shape, slots } => {
+                PropertyStorageIter::Shaped(shape.keys().iter().zip(slots.iter()))
+            }
+            PropertyStorage::Dictionary(map) => PropertyStorageIter::Dictionary(map.iter()),
         }
     }
 
     /// Iterate over all (key, value) pairs mutably.
     pub fn iter_mut(&mut self) -> PropertyStorageIterMut<'_> {
         match self {
-            PropertyStorage::Inline { len, entries } => {
-                let len = *len as usize;
-                PropertyStorageIterMut::Inline {
-                    entries: entries.get_mut(..len).unwrap_or_default(),
-                }
+            PropertyStorage::Shaped { shape, slots } => {
+                PropertyStorageIterMut::Shaped(shape.keys().iter().zip(slots.iter_mut()))
             }
-            PropertyStorage::Map(map) => PropertyStorageIterMut::Map(map.iter_mut()),
+            PropertyStorage::Dictionary(map) => PropertyStorageIterMut::Dictionary(map.iter_mut()),
         }
     }
 
@@ -2379,72 +2820,61 @@ impl PropertyStorage {
     pub fn values(&self) -> impl Iterator<Item = &Property> {
         self.iter().map(|(_, v)| v)
     }
+
+    /// Append a property along a shape transition recorded by an inline cache.
+    /// `next` must be the current shape extended by exactly one key.
+    pub(crate) fn push_transition(&mut self, next: Rc<Shape>, prop: Property) {
+        if let PropertyStorage::Shaped { shape, slots } = self {
+            debug_assert_eq!(next.len(), slots.len() + 1);
+            *shape = next;
+            slots.push(prop);
+        }
+    }
+
+    /// Move shaped properties into an insertion-ordered map
+    fn make_dictionary(&mut self) {
+        if let PropertyStorage::Shaped { shape, slots } = self {
+            let mut map = index_map_with_capacity(slots.len() + 1);
+            for (key, prop) in shape.keys().iter().zip(slots.drain(..)) {
+                map.insert(key.clone(), prop);
+            }
+            *self = PropertyStorage::Dictionary(map);
+        }
+    }
 }
 
 /// Iterator over PropertyStorage entries.
 pub enum PropertyStorageIter<'a> {
-    Inline {
-        entries: &'a [(PropertyKey, Property); INLINE_PROPERTY_CAPACITY],
-        index: usize,
-        len: usize,
-    },
-    #[cfg(feature = "std")]
-    Map(std::collections::hash_map::Iter<'a, PropertyKey, Property>),
-    #[cfg(not(feature = "std"))]
-    Map(hashbrown::hash_map::Iter<'a, PropertyKey, Property>),
+    Shaped(core::iter::Zip<core::slice::Iter<'a, PropertyKey>, core::slice::Iter<'a, Property>>),
+    Dictionary(indexmap::map::Iter<'a, PropertyKey, Property>),
 }
 
 impl<'a> Iterator for PropertyStorageIter<'a> {
     type Item = (&'a PropertyKey, &'a Property);
 
+    #[inline]
     fn next(&mut self) -> Option<Self::Item> {
         match self {
-            PropertyStorageIter::Inline {
-                entries,
-                index,
-                len,
-            } => {
-                if *index < *len {
-                    let i = *index;
-                    *index += 1;
-                    entries.get(i).map(|e| (&e.0, &e.1))
-                } else {
-                    None
-                }
-            }
-            PropertyStorageIter::Map(iter) => iter.next(),
+            PropertyStorageIter::Shaped(iter) => iter.next(),
+            PropertyStorageIter::Dictionary(iter) => iter.next(),
         }
     }
 }
 
 /// Mutable iterator over PropertyStorage entries.
 pub enum PropertyStorageIterMut<'a> {
-    Inline {
-        entries: &'a mut [(PropertyKey, Property)],
-    },
-    #[cfg(feature = "std")]
-    Map(std::collections::hash_map::IterMut<'a, PropertyKey, Property>),
-    #[cfg(not(feature = "std"))]
-    Map(hashbrown::hash_map::IterMut<'a, PropertyKey, Property>),
+    Shaped(core::iter::Zip<core::slice::Iter<'a, PropertyKey>, core::slice::IterMut<'a, Property>>),
+    Dictionary(indexmap::map::IterMut<'a, PropertyKey, Property>),
 }
 
 impl<'a> Iterator for PropertyStorageIterMut<'a> {
     type Item = (&'a PropertyKey, &'a mut Property);
 
+    #[inline]
     fn next(&mut self) -> Option<Self::Item> {
         match self {
-            PropertyStorageIterMut::Inline { entries } => {
-                // Take the slice and split off the first element
-                if entries.is_empty() {
-                    None
-                } else {
-                    // Split the slice: take first element, keep the rest
-                    let (first, rest) = mem::take(entries).split_at_mut(1);
-                    *entries = rest;
-                    first.first_mut().map(|e| (&e.0, &mut e.1))
-                }
-            }
-            PropertyStorageIterMut::Map(iter) => iter.next(),
+            PropertyStorageIterMut::Shaped(iter) => iter.next(),
+            PropertyStorageIterMut::Dictionary(iter) => iter.next(),
         }
     }
 }
@@ -2563,13 +2993,218 @@ impl Hash for JsMapKey {
     }
 }
 
+/// Backing store for array elements (the array's "element kind").
+///
+/// Arrays holding only numbers are kept packed as raw `f64`s, a third of the
+/// size of `JsValue` slots, so numeric builtins and the C API can work on
+/// them without inspecting tags. The first store of a non-number, or a write
+/// that would leave a hole, moves the array to generic storage for good.
+#[derive(Debug, Clone)]
+pub enum ArrayElements {
+    /// Every element is a number
+    Double(Vec<f64>),
+    /// Elements of any type
+    Generic(Vec<JsValue>),
+}
+
+impl Default for ArrayElements {
+    fn default() -> Self {
+        ArrayElements::Double(Vec::new())
+    }
+}
+
+impl ArrayElements {
+    /// Pick the most compact kind that can hold `values`.
+    pub fn from_values(values: Vec<JsValue>) -> Self {
+        if values.iter().all(|v| matches!(v, JsValue::Number(_))) {
+            ArrayElements::Double(
+                values
+                    .into_iter()
+                    .map(|v| match v {
+                        JsValue::Number(n) => n,
+                        _ => f64::NAN,
+                    })
+                    .collect(),
+            )
+        } else {
+            ArrayElements::Generic(values)
+        }
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        match self {
+            ArrayElements::Double(v) => v.len(),
+            ArrayElements::Generic(v) => v.len(),
+        }
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Whether the elements are stored as packed `f64`s
+    #[inline]
+    pub fn is_packed(&self) -> bool {
+        matches!(self, ArrayElements::Double(_))
+    }
+
+    #[inline]
+    pub fn get(&self, index: usize) -> Option<JsValue> {
+        match self {
+            ArrayElements::Double(v) => v.get(index).map(|n| JsValue::Number(*n)),
+            ArrayElements::Generic(v) => v.get(index).cloned(),
+        }
+    }
+
+    /// Iterate over the elements by value
+    pub fn iter(&self) -> ArrayElementsIter<'_> {
+        match self {
+            ArrayElements::Double(v) => ArrayElementsIter::Double(v.iter()),
+            ArrayElements::Generic(v) => ArrayElementsIter::Generic(v.iter()),
+        }
+    }
+
+    pub fn to_vec(&self) -> Vec<JsValue> {
+        self.iter().collect()
+    }
+
+    /// The packed numbers, if the array is packed
+    #[inline]
+    pub fn as_f64_slice(&self) -> Option<&[f64]> {
+        match self {
+            ArrayElements::Double(v) => Some(v),
+            ArrayElements::Generic(_) => None,
+        }
+    }
+
+    /// Mutable access to the packed numbers, if the array is packed
+    #[inline]
+    pub fn as_f64_vec_mut(&mut self) -> Option<&mut Vec<f64>> {
+        match self {
+            ArrayElements::Double(v) => Some(v),
+            ArrayElements::Generic(_) => None,
+        }
+    }
+
+    /// Switch to generic storage and return it.
+    pub fn make_generic(&mut self) -> &mut Vec<JsValue> {
+        match self {
+            ArrayElements::Generic(values) => values,
+            ArrayElements::Double(numbers) => {
+                let values = numbers.iter().map(|n| JsValue::Number(*n)).collect();
+                *self = ArrayElements::Generic(values);
+                self.make_generic()
+            }
+        }
+    }
+
+    /// Store `value` at `index`, filling any gap with undefined.
+    pub fn set(&mut self, index: usize, value: JsValue) {
+        if let ArrayElements::Double(numbers) = self
+            && let JsValue::Number(n) = value
+        {
+            if let Some(slot) = numbers.get_mut(index) {
+                *slot = n;
+                return;
+            }
+            if index == numbers.len() {
+                numbers.push(n);
+                return;
+            }
+        }
+        let values = self.make_generic();
+        if index >= values.len() {
+            values.resize(index + 1, JsValue::Undefined);
+        }
+        if let Some(slot) = values.get_mut(index) {
+            *slot = value;
+        }
+    }
+
+    pub fn push(&mut self, value: JsValue) {
+        match (&mut *self, value) {
+            (ArrayElements::Double(numbers), JsValue::Number(n)) => numbers.push(n),
+            (_, value) => self.make_generic().push(value),
+        }
+    }
+
+    pub fn extend(&mut self, values: impl IntoIterator<Item = JsValue>) {
+        for value in values {
+            self.push(value);
+        }
+    }
+
+    pub fn pop(&mut self) -> Option<JsValue> {
+        match self {
+            ArrayElements::Double(v) => v.pop().map(JsValue::Number),
+            ArrayElements::Generic(v) => v.pop(),
+        }
+    }
+
+    /// Resize to `len`, filling new slots with undefined.
+    pub fn resize(&mut self, len: usize) {
+        match self {
+            ArrayElements::Double(v) if len <= v.len() => v.truncate(len),
+            ArrayElements::Generic(v) if len <= v.len() => v.truncate(len),
+            _ => self.make_generic().resize(len, JsValue::Undefined),
+        }
+    }
+}
+
+/// By-value iterator over `ArrayElements`
+pub enum ArrayElementsIter<'a> {
+    Double(core::slice::Iter<'a, f64>),
+    Generic(core::slice::Iter<'a, JsValue>),
+}
+
+impl Iterator for ArrayElementsIter<'_> {
+    type Item = JsValue;
+
+    #[inline]
+    fn next(&mut self) -> Option<JsValue> {
+        match self {
+            ArrayElementsIter::Double(it) => it.next().map(|n| JsValue::Number(*n)),
+            ArrayElementsIter::Generic(it) => it.next().cloned(),
+        }
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        match self {
+            ArrayElementsIter::Double(it) => it.size_hint(),
+            ArrayElementsIter::Generic(it) => it.size_hint(),
+        }
+    }
+}
+
+impl DoubleEndedIterator for ArrayElementsIter<'_> {
+    fn next_back(&mut self) -> Option<JsValue> {
+        match self {
+            ArrayElementsIter::Double(it) => it.next_back().map(|n| JsValue::Number(*n)),
+            ArrayElementsIter::Generic(it) => it.next_back().cloned(),
+        }
+    }
+}
+
+impl ExactSizeIterator for ArrayElementsIter<'_> {}
+
+impl<'a> IntoIterator for &'a ArrayElements {
+    type Item = JsValue;
+    type IntoIter = ArrayElementsIter<'a>;
+
+    fn into_iter(self) -> ArrayElementsIter<'a> {
+        self.iter()
+    }
+}
+
 /// Exotic object behavior
 #[derive(Debug)]
 pub enum ExoticObject {
     /// Ordinary object
     Ordinary,
     /// Array exotic object - stores elements directly for O(1) indexed access
-    Array { elements: Vec<JsValue> },
+    Array { elements: ArrayElements },
     /// Boolean wrapper object - stores primitive boolean value
     Boolean(bool),
     /// Number wrapper object - stores primitive number value
@@ -2615,6 +3250,138 @@ pub enum ExoticObject {
     /// The id is the OrderId that will be used to match the response from host
     /// When detected, VM suspends and waits for host to provide a value via fulfill_orders()
     PendingOrder { id: u64 },
+    /// ArrayBuffer exotic object - raw bytes, possibly host memory
+    ArrayBuffer(Rc<ByteStore>),
+    /// TypedArray exotic object - numeric elements read from an ArrayBuffer
+    TypedArray(TypedArrayData),
+    /// DataView exotic object - byte-level access to an ArrayBuffer
+    DataView(DataViewData),
+    /// Error object - stores the call sites its `stack` is formatted from
+    Error(ErrorData),
+}
+
+impl ExoticObject {
+    /// Whether this is an ArrayBuffer, TypedArray or DataView
+    #[inline]
+    pub fn is_binary_data(&self) -> bool {
+        matches!(
+            self,
+            ExoticObject::ArrayBuffer(_) | ExoticObject::TypedArray(_) | ExoticObject::DataView(_)
+        )
+    }
+
+    /// Whether property lookups of `key` are answered from exotic state
+    /// instead of the object's own property storage
+    pub fn intercepts_property(&self, key: &PropertyKey) -> bool {
+        let is_named = |name: &str| matches!(key, PropertyKey::String(s) if s.as_str() == name);
+        match self {
+            ExoticObject::Ordinary => false,
+            ExoticObject::Array { .. } => {
+                matches!(key, PropertyKey::Index(_)) || is_named("length")
+            }
+            ExoticObject::Map { .. } | ExoticObject::Set { .. } => is_named("size"),
+            ExoticObject::Function(_) => is_named("name") || is_named("length"),
+            ExoticObject::Enum(_) | ExoticObject::Proxy(_) => true,
+            ExoticObject::TypedArray(_) => {
+                matches!(key, PropertyKey::Index(_))
+                    || is_named("length")
+                    || is_named("byteLength")
+                    || is_named("byteOffset")
+                    || is_named("buffer")
+            }
+            ExoticObject::ArrayBuffer(_) => is_named("byteLength"),
+            ExoticObject::DataView(_) => {
+                is_named("byteLength") || is_named("byteOffset") || is_named("buffer")
+            }
+            ExoticObject::Error(_) => is_named("stack"),
+            _ => false,
+        }
+    }
+}
+
+/// A call site recorded for a stack trace: a chunk and the offset of the
+/// instruction executing in it
+#[derive(Debug, Clone)]
+pub struct CallSite {
+    pub chunk: Rc<crate::compiler::BytecodeChunk>,
+    pub ip: usize,
+}
+
+impl CallSite {
+    /// Resolve the site through the chunk's source map
+    pub fn frame(&self) -> Option<StackFrame> {
+        let span = self.chunk.get_source_location(self.ip)?;
+        Some(StackFrame {
+            function_name: self
+                .chunk
+                .function_info
+                .as_ref()
+                .and_then(|info| info.name.as_ref().map(|name| name.to_string())),
+            file: self.chunk.source_file.clone(),
+            line: span.line,
+            column: span.column,
+        })
+    }
+}
+
+/// Error object internal state
+///
+/// Throwing an error records where it was thrown as call sites; `stack` is
+/// only formatted from them when it is read, so errors used for control flow
+/// never build the string. An own `stack` property (assigned by the program)
+/// takes precedence.
+#[derive(Debug, Clone, Default)]
+pub struct ErrorData {
+    /// Call sites from innermost to outermost, empty until first thrown
+    pub sites: Vec<CallSite>,
+    /// `stack`, formatted on first read
+    stack: core::cell::OnceCell<JsString>,
+}
+
+impl ErrorData {
+    /// State of an error raised at `sites`
+    pub fn new(sites: Vec<CallSite>) -> Self {
+        Self {
+            sites,
+            stack: core::cell::OnceCell::new(),
+        }
+    }
+
+    /// Record the sites of the first throw; rethrowing keeps them
+    pub fn record_sites(&mut self, sites: Vec<CallSite>) {
+        if self.sites.is_empty() && self.stack.get().is_none() {
+            self.sites = sites;
+        }
+    }
+
+    /// Stack frames of the recorded call sites
+    pub fn frames(&self) -> Vec<StackFrame> {
+        self.sites.iter().filter_map(CallSite::frame).collect()
+    }
+
+    /// The `stack` string of `error`: `name: message` followed by one
+    /// line per frame
+    fn stack(&self, error: &JsObject) -> JsString {
+        self.stack
+            .get_or_init(|| {
+                let read = |name: &str| {
+                    error
+                        .get_property(&PropertyKey::String(JsString::from(name)))
+                        .map(|value| value.to_js_string())
+                };
+                let name = read("name").unwrap_or_else(|| JsString::from("Error"));
+                let mut stack = match read("message") {
+                    Some(message) if !message.is_empty() => format!("{}: {}", name, message),
+                    _ => name.to_string(),
+                };
+                for frame in self.frames() {
+                    stack.push('\n');
+                    stack.push_str(&frame.to_string());
+                }
+                JsString::from(stack)
+            })
+            .cheap_clone()
+    }
 }
 
 /// Proxy internal state
@@ -2631,6 +3398,334 @@ pub struct ProxyData {
     pub revoked: bool,
 }
 
+// ═══════════════════════════════════════════════════════════════════════════════
+// Binary Data (ArrayBuffer, TypedArray, DataView)
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/// Bytes of an ArrayBuffer, shared by the buffer object and every view on it
+///
+/// The bytes are either owned by the interpreter or host memory wrapped without
+/// copying (see [`ByteStore::external`]). Views read and write through this
+/// store directly instead of going through the buffer object.
+pub struct ByteStore {
+    bytes: RefCell<ByteStorage>,
+}
+
+enum ByteStorage {
+    Owned(Vec<u8>),
+    External(ExternalBytes),
+}
+
+/// Host memory backing an external ArrayBuffer
+struct ExternalBytes {
+    ptr: *mut u8,
+    len: usize,
+    /// Runs once, when the last reference to the store is dropped
+    release: Option<Box<dyn FnOnce()>>,
+}
+
+impl ExternalBytes {
+    fn as_slice(&self) -> &[u8] {
+        if self.len == 0 {
+            return &[];
+        }
+        // SAFETY: `ByteStore::external`'s contract keeps `ptr` valid for `len`
+        // bytes until `release` runs
+        unsafe { core::slice::from_raw_parts(self.ptr, self.len) }
+    }
+
+    fn as_mut_slice(&mut self) -> &mut [u8] {
+        if self.len == 0 {
+            return &mut [];
+        }
+        // SAFETY: as above; the RefCell around the storage makes this the
+        // only live reference
+        unsafe { core::slice::from_raw_parts_mut(self.ptr, self.len) }
+    }
+}
+
+impl Drop for ExternalBytes {
+    fn drop(&mut self) {
+        if let Some(release) = self.release.take() {
+            release();
+        }
+    }
+}
+
+impl ByteStore {
+    /// A store owning `bytes`
+    pub fn new(bytes: Vec<u8>) -> Rc<Self> {
+        Rc::new(Self {
+            bytes: RefCell::new(ByteStorage::Owned(bytes)),
+        })
+    }
+
+    /// Largest store `zeroed` allocates (2 GiB - 1). Hosts that need bigger
+    /// buffers can wrap their own memory with `external`.
+    pub const MAX_ZEROED_LEN: usize = i32::MAX as usize;
+
+    /// A store of `len` zero bytes, or a RangeError if `len` is over
+    /// `MAX_ZEROED_LEN` or the memory cannot be allocated. Lengths come from
+    /// scripts, so this must not abort the process.
+    pub fn zeroed(len: usize) -> Result<Rc<Self>, JsError> {
+        let mut bytes = Vec::new();
+        if len > Self::MAX_ZEROED_LEN || bytes.try_reserve_exact(len).is_err() {
+            return Err(JsError::range_error("Array buffer allocation failed"));
+        }
+        bytes.resize(len, 0);
+        Ok(Self::new(bytes))
+    }
+
+    /// A store wrapping `len` bytes of host memory at `ptr` without copying.
+    /// `release` runs when the store is dropped, i.e. once the buffer and all
+    /// its views have been collected.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be valid for reads and writes of `len` bytes until `release`
+    /// runs (forever if there is none), and the host must not access the
+    /// memory while the interpreter is running.
+    pub unsafe fn external(
+        ptr: *mut u8,
+        len: usize,
+        release: Option<Box<dyn FnOnce()>>,
+    ) -> Rc<Self> {
+        Rc::new(Self {
+            bytes: RefCell::new(ByteStorage::External(ExternalBytes { ptr, len, release })),
+        })
+    }
+
+    /// Length in bytes
+    pub fn len(&self) -> usize {
+        match &*self.bytes.borrow() {
+            ByteStorage::Owned(bytes) => bytes.len(),
+            ByteStorage::External(ext) => ext.len,
+        }
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Whether the bytes are host memory
+    pub fn is_external(&self) -> bool {
+        matches!(&*self.bytes.borrow(), ByteStorage::External(_))
+    }
+
+    pub fn bytes(&self) -> core::cell::Ref<'_, [u8]> {
+        core::cell::Ref::map(self.bytes.borrow(), |storage| match storage {
+            ByteStorage::Owned(bytes) => bytes.as_slice(),
+            ByteStorage::External(ext) => ext.as_slice(),
+        })
+    }
+
+    pub fn bytes_mut(&self) -> core::cell::RefMut<'_, [u8]> {
+        core::cell::RefMut::map(self.bytes.borrow_mut(), |storage| match storage {
+            ByteStorage::Owned(bytes) => bytes.as_mut_slice(),
+            ByteStorage::External(ext) => ext.as_mut_slice(),
+        })
+    }
+
+    /// Pointer to the first byte, for hosts reading the buffer in place
+    pub fn as_mut_ptr(&self) -> *mut u8 {
+        self.bytes_mut().as_mut_ptr()
+    }
+}
+
+impl fmt::Debug for ByteStore {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "ByteStore({} bytes)", self.len())
+    }
+}
+
+/// Element type of a TypedArray
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum TypedArrayKind {
+    Int8,
+    Uint8,
+    Uint8Clamped,
+    Int16,
+    Uint16,
+    Int32,
+    Uint32,
+    Float32,
+    Float64,
+}
+
+impl TypedArrayKind {
+    /// Every kind, in the order of `Interpreter::typed_array_prototypes`
+    pub const ALL: [TypedArrayKind; 9] = [
+        TypedArrayKind::Int8,
+        TypedArrayKind::Uint8,
+        TypedArrayKind::Uint8Clamped,
+        TypedArrayKind::Int16,
+        TypedArrayKind::Uint16,
+        TypedArrayKind::Int32,
+        TypedArrayKind::Uint32,
+        TypedArrayKind::Float32,
+        TypedArrayKind::Float64,
+    ];
+
+    /// Position in [`TypedArrayKind::ALL`]
+    pub fn index(self) -> usize {
+        self as usize
+    }
+
+    /// Constructor name, e.g. `Uint8Array`
+    pub fn name(self) -> &'static str {
+        match self {
+            TypedArrayKind::Int8 => "Int8Array",
+            TypedArrayKind::Uint8 => "Uint8Array",
+            TypedArrayKind::Uint8Clamped => "Uint8ClampedArray",
+            TypedArrayKind::Int16 => "Int16Array",
+            TypedArrayKind::Uint16 => "Uint16Array",
+            TypedArrayKind::Int32 => "Int32Array",
+            TypedArrayKind::Uint32 => "Uint32Array",
+            TypedArrayKind::Float32 => "Float32Array",
+            TypedArrayKind::Float64 => "Float64Array",
+        }
+    }
+
+    /// Bytes per element
+    pub fn element_size(self) -> usize {
+        match self {
+            TypedArrayKind::Int8 | TypedArrayKind::Uint8 | TypedArrayKind::Uint8Clamped => 1,
+            TypedArrayKind::Int16 | TypedArrayKind::Uint16 => 2,
+            TypedArrayKind::Int32 | TypedArrayKind::Uint32 | TypedArrayKind::Float32 => 4,
+            TypedArrayKind::Float64 => 8,
+        }
+    }
+
+    /// Decode one element from its native-endian bytes
+    pub fn decode(self, raw: &[u8]) -> Option<f64> {
+        Some(match self {
+            TypedArrayKind::Int8 => f64::from(i8::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Uint8 | TypedArrayKind::Uint8Clamped => {
+                f64::from(u8::from_ne_bytes(raw.try_into().ok()?))
+            }
+            TypedArrayKind::Int16 => f64::from(i16::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Uint16 => f64::from(u16::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Int32 => f64::from(i32::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Uint32 => f64::from(u32::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Float32 => f64::from(f32::from_ne_bytes(raw.try_into().ok()?)),
+            TypedArrayKind::Float64 => f64::from_ne_bytes(raw.try_into().ok()?),
+        })
+    }
+
+    /// Encode `value` as one element in native byte order, converting it the
+    /// way a typed array store does (modular integers, clamping, rounding to
+    /// f32). Only the first `element_size()` bytes are meaningful.
+    pub fn encode(self, value: f64) -> [u8; 8] {
+        let mut out = [0u8; 8];
+        let mut put = |bytes: &[u8]| {
+            for (slot, byte) in out.iter_mut().zip(bytes) {
+                *slot = *byte;
+            }
+        };
+        match self {
+            TypedArrayKind::Int8 => put(&(to_uint32_modular(value) as u8 as i8).to_ne_bytes()),
+            TypedArrayKind::Uint8 => put(&(to_uint32_modular(value) as u8).to_ne_bytes()),
+            TypedArrayKind::Uint8Clamped => put(&to_uint8_clamped(value).to_ne_bytes()),
+            TypedArrayKind::Int16 => put(&(to_uint32_modular(value) as u16 as i16).to_ne_bytes()),
+            TypedArrayKind::Uint16 => put(&(to_uint32_modular(value) as u16).to_ne_bytes()),
+            TypedArrayKind::Int32 => put(&(to_uint32_modular(value) as i32).to_ne_bytes()),
+            TypedArrayKind::Uint32 => put(&to_uint32_modular(value).to_ne_bytes()),
+            TypedArrayKind::Float32 => put(&(value as f32).to_ne_bytes()),
+            TypedArrayKind::Float64 => put(&value.to_ne_bytes()),
+        }
+        out
+    }
+}
+
+/// ToUint32: the number modulo 2^32 (NaN and infinities become 0)
+pub fn to_uint32_modular(value: f64) -> u32 {
+    if !value.is_finite() {
+        return 0;
+    }
+    const TWO_32: f64 = 4_294_967_296.0;
+    let wrapped = math::trunc(value) % TWO_32;
+    (if wrapped < 0.0 {
+        wrapped + TWO_32
+    } else {
+        wrapped
+    }) as u32
+}
+
+/// ToUint8Clamp: clamp to 0..=255, rounding halves to even
+fn to_uint8_clamped(value: f64) -> u8 {
+    if value.is_nan() || value <= 0.0 {
+        return 0;
+    }
+    if value >= 255.0 {
+        return 255;
+    }
+    let floor = math::floor(value);
+    let rounded = match value - floor {
+        d if d > 0.5 => floor + 1.0,
+        d if d < 0.5 => floor,
+        _ if floor % 2.0 == 0.0 => floor,
+        _ => floor + 1.0,
+    };
+    rounded as u8
+}
+
+/// TypedArray internal state: a typed window onto an ArrayBuffer
+#[derive(Debug, Clone)]
+pub struct TypedArrayData {
+    pub kind: TypedArrayKind,
+    /// The ArrayBuffer object (`.buffer`)
+    pub buffer: JsObjectRef,
+    /// The buffer's bytes, shared with the buffer object
+    pub store: Rc<ByteStore>,
+    pub byte_offset: usize,
+    /// Number of elements
+    pub length: usize,
+}
+
+impl TypedArrayData {
+    pub fn byte_length(&self) -> usize {
+        self.length * self.kind.element_size()
+    }
+
+    /// Element `index`, or None when out of range
+    #[inline]
+    pub fn get(&self, index: usize) -> Option<f64> {
+        if index >= self.length {
+            return None;
+        }
+        let size = self.kind.element_size();
+        let start = self.byte_offset + index * size;
+        let bytes = self.store.bytes();
+        self.kind.decode(bytes.get(start..start + size)?)
+    }
+
+    /// Store `value` at `index`; out-of-range writes are ignored
+    #[inline]
+    pub fn set(&self, index: usize, value: f64) {
+        if index >= self.length {
+            return;
+        }
+        let size = self.kind.element_size();
+        let start = self.byte_offset + index * size;
+        let encoded = self.kind.encode(value);
+        let mut bytes = self.store.bytes_mut();
+        if let (Some(dst), Some(src)) = (bytes.get_mut(start..start + size), encoded.get(..size)) {
+            dst.copy_from_slice(src);
+        }
+    }
+}
+
+/// DataView internal state: an untyped window onto an ArrayBuffer
+#[derive(Debug, Clone)]
+pub struct DataViewData {
+    /// The ArrayBuffer object (`.buffer`)
+    pub buffer: JsObjectRef,
+    /// The buffer's bytes, shared with the buffer object
+    pub store: Rc<ByteStore>,
+    pub byte_offset: usize,
+    pub byte_length: usize,
+}
+
 /// Enum member - stores name and value
 #[derive(Debug, Clone)]
 pub struct EnumMember {
@@ -3021,6 +4116,23 @@ impl JsFunction {
             JsFunction::ProxyRevoke(_) => Some("revoke"),
         }
     }
+
+    /// This function, with the body of a function compiled on first call
+    /// compiled (see [`crate::compiler::BytecodeChunk::compiled`])
+    pub fn with_compiled_body(
+        mut self,
+        string_dict: &mut crate::string_dict::StringDict,
+    ) -> Result<Self, JsError> {
+        if let JsFunction::Bytecode(f)
+        | JsFunction::BytecodeGenerator(f)
+        | JsFunction::BytecodeAsync(f)
+        | JsFunction::BytecodeAsyncGenerator(f) = &mut self
+            && f.chunk.lazy.is_some()
+        {
+            f.chunk = f.chunk.compiled(string_dict)?;
+        }
+        Ok(self)
+    }
 }
 
 /// Bytecode-compiled function
@@ -3329,4 +4441,51 @@ mod tests {
             PropertyKey::Symbol(_) => panic!("0.1 should not be a symbol"),
         }
     }
+
+    #[test]
+    fn test_js_string_concat_short_is_flat() {
+        let s = JsString::from("ab").concat(&JsString::from("cd"));
+        assert!(!s.is_rope());
+        assert_eq!(s.as_str(), "abcd");
+    }
+
+    #[test]
+    fn test_js_string_rope_flattens_on_read() {
+        let chunk = JsString::from("x".repeat(ROPE_MIN_LEN));
+        let s = chunk.concat(&JsString::from("tail"));
+        assert!(s.is_rope());
+        assert_eq!(s.len(), ROPE_MIN_LEN + 4);
+        assert!(s.is_rope(), "len() must not flatten");
+        assert!(s.as_str().ends_with("xtail"));
+        assert!(!s.is_rope());
+    }
+
+    #[test]
+    fn test_js_string_rope_eq_and_hash_match_flat() {
+        use core::hash::BuildHasher;
+        let chunk = "y".repeat(ROPE_MIN_LEN);
+        let rope = JsString::from(chunk.as_str()).concat(&JsString::from("z"));
+        let flat = JsString::from(format!("{chunk}z"));
+        assert_eq!(rope, flat);
+        let hasher = rustc_hash::FxBuildHasher;
+        assert_eq!(hasher.hash_one(&rope), hasher.hash_one(flat.as_str()));
+    }
+
+    #[test]
+    fn test_js_string_deep_rope_flatten_and_drop() {
+        // Deep left-leaning ropes must not recurse when read or dropped
+        let line = JsString::from("line of generated config\n");
+        let mut out = JsString::from("x".repeat(ROPE_MIN_LEN));
+        for _ in 0..200_000 {
+            out = out.concat(&line);
+        }
+        assert_eq!(out.len(), ROPE_MIN_LEN + 200_000 * line.len());
+        assert!(out.as_str().ends_with("config\n"));
+
+        let mut unread = JsString::from("x".repeat(ROPE_MIN_LEN));
+        for _ in 0..200_000 {
+            unread = unread.concat(&line);
+        }
+        drop(unread);
+    }
 }
@@ -352,7 +352,7 @@ fn test_compile_function_call() {
 
 #[test]
 fn test_compile_method_call() {
-    let chunk = compile("obj.method()");
+    let chunk = compile("obj.method(1)");
 
     // Method calls now use GetPropertyConst + Call pattern for correct evaluation order
     assert!(
@@ -365,6 +365,17 @@ fn test_compile_method_call() {
         "Expected Call, got {:?}",
         chunk.code
     );
+
+    // Without arguments the pair is adjacent and fused
+    let chunk = compile("obj.method()");
+    assert!(
+        contains_op(&chunk, |op| matches!(
+            op,
+            Op::GetPropertyConstCall { argc: 0, .. }
+        )),
+        "Expected GetPropertyConstCall, got {:?}",
+        chunk.code
+    );
 }
 
 #[test]
@@ -560,3 +571,254 @@ fn test_compile_nullish_coalescing() {
     });
     assert!(has_valid_jump, "JumpIfNotNullish has invalid target");
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Bytecode serialization
+// ═══════════════════════════════════════════════════════════════════════════
+
+#[allow(clippy::expect_used)]
+fn compile_program(source: &str, dict: &mut StringDict) -> tsrun::compiler::CompiledProgram {
+    let mut parser = Parser::new(source, dict);
+    let program = parser.parse_program().expect("parse failed");
+    tsrun::compiler::CompiledProgram::compile(&program, Some("/main.ts".to_string()))
+        .expect("compile failed")
+}
+
+#[test]
+fn test_bytecode_roundtrip() {
+    let source = r#"
+        import def, { a as b } from "./dep";
+        import * as ns from "./ns";
+        export { x } from "./reexport";
+        function* gen(first, ...rest) { yield first + rest.length; }
+        const re = /a+b/gi;
+        const tag = (s) => s.raw[0];
+        const { p, ...others } = { p: 1, q: 2.5 };
+        tag`line\n${p}`;
+    "#;
+    let mut dict = StringDict::new();
+    let compiled = compile_program(source, &mut dict);
+
+    let bytes = compiled.to_bytes().expect("serialize failed");
+    let mut fresh = StringDict::new();
+    let decoded =
+        tsrun::compiler::CompiledProgram::from_bytes(&bytes, &mut fresh).expect("decode failed");
+
+    // Chunks and imports carry no PartialEq; compare their debug output
+    assert_eq!(
+        format!("{:?}", decoded.chunk),
+        format!("{:?}", compiled.chunk)
+    );
+    assert_eq!(
+        format!("{:?}", decoded.imports),
+        format!("{:?}", compiled.imports)
+    );
+    assert_eq!(decoded.imports.len(), 3);
+
+    // Re-encoding produces identical bytes
+    assert_eq!(decoded.to_bytes().expect("serialize failed"), bytes);
+}
+
+#[test]
+fn test_bytecode_rejects_corrupt_input() {
+    let mut dict = StringDict::new();
+    let bytes = compile_program("let x = 1; x + 2", &mut dict)
+        .to_bytes()
+        .expect("serialize failed");
+
+    // Bad magic
+    let mut bad = bytes.clone();
+    bad[0] = b'X';
+    assert!(tsrun::compiler::CompiledProgram::from_bytes(&bad, &mut dict).is_err());
+
+    // Unknown format version
+    let mut bad = bytes.clone();
+    bad[4] = bad[4].wrapping_add(1);
+    assert!(tsrun::compiler::CompiledProgram::from_bytes(&bad, &mut dict).is_err());
+
+    // Every truncation is rejected rather than panicking
+    for len in 0..bytes.len() {
+        assert!(
+            tsrun::compiler::CompiledProgram::from_bytes(&bytes[..len], &mut dict).is_err(),
+            "truncated blob of {} bytes was accepted",
+            len
+        );
+    }
+}
+
+#[test]
+#[allow(clippy::expect_used)]
+fn test_bytecode_rejects_out_of_range_operands() {
+    let mut dict = StringDict::new();
+    let compiled = compile_program("let x = 1; x + 2", &mut dict);
+    let registers = compiled.chunk.register_count;
+    let constants = compiled.chunk.constants.len() as u16;
+    let code_len = compiled.chunk.code.len() as u32;
+
+    let cases = [
+        (
+            Op::Move {
+                dst: registers,
+                src: 0,
+            },
+            "register out of range",
+        ),
+        (
+            Op::CreateArray {
+                dst: 0,
+                start: registers,
+                count: 2,
+            },
+            "register out of range",
+        ),
+        (
+            Op::LoadConst {
+                dst: 0,
+                idx: constants,
+            },
+            "constant index out of range",
+        ),
+        (
+            Op::Jump {
+                target: code_len + 2,
+            },
+            "jump target out of range",
+        ),
+    ];
+    for (op, message) in cases {
+        let mut chunk = (*compiled.chunk).clone();
+        chunk.code.insert(0, op);
+        let program = tsrun::compiler::CompiledProgram {
+            chunk: std::rc::Rc::new(chunk),
+            imports: Vec::new(),
+        };
+        let bytes = program.to_bytes().expect("serialize failed");
+        let err = tsrun::compiler::CompiledProgram::from_bytes(&bytes, &mut dict)
+            .expect_err("out-of-range operand was accepted");
+        assert!(
+            err.to_string().contains(message),
+            "{:?}: unexpected error {}",
+            op,
+            err
+        );
+    }
+}
+
+#[test]
+#[allow(clippy::expect_used)]
+fn test_bytecode_rejects_deep_nesting() {
+    fn nested(depth: usize) -> Vec<u8> {
+        let mut chunk = BytecodeChunk::new();
+        for _ in 1..depth {
+            let mut outer = BytecodeChunk::new();
+            outer
+                .constants
+                .push(tsrun::compiler::Constant::Chunk(std::rc::Rc::new(chunk)));
+            chunk = outer;
+        }
+        let program = tsrun::compiler::CompiledProgram {
+            chunk: std::rc::Rc::new(chunk),
+            imports: Vec::new(),
+        };
+        program.to_bytes().expect("serialize failed")
+    }
+
+    let mut dict = StringDict::new();
+    assert!(tsrun::compiler::CompiledProgram::from_bytes(&nested(100), &mut dict).is_ok());
+    let err = tsrun::compiler::CompiledProgram::from_bytes(&nested(200), &mut dict)
+        .expect_err("deeply nested blob was accepted");
+    assert!(err.to_string().contains("nested too deeply"), "{}", err);
+}
+
+#[test]
+fn test_compile_function_locals_use_registers() {
+    use tsrun::compiler::Constant;
+
+    let chunk = compile("function f(a) { let b = a + 1; const c = b * 2; return c; }");
+    let func = chunk.constants.iter().find_map(|c| match c {
+        Constant::Chunk(func) => Some(func.clone()),
+        _ => None,
+    });
+    let Some(func) = func else {
+        panic!("Expected a nested function chunk");
+    };
+
+    // Non-captured params and locals never touch the environment
+    assert!(
+        !contains_op(&func, |op| matches!(
+            op,
+            Op::GetVar { .. } | Op::SetVar { .. } | Op::DeclareVar { .. }
+        )),
+        "Expected register-only locals, got {:?}",
+        func.code
+    );
+}
+
+/// Index of the first op matching `predicate`
+fn find_op<F: Fn(&Op) -> bool>(chunk: &BytecodeChunk, predicate: F) -> Option<usize> {
+    chunk.code.iter().position(predicate)
+}
+
+#[test]
+fn test_superinstruction_compare_jump() {
+    let chunk = compile("let n = 0; while (n < 10) { n = n + 1; }");
+
+    // The fused op takes the comparison's slot and the JumpIfFalse stays behind it
+    let fused = find_op(&chunk, |op| matches!(op, Op::LtJumpIfFalse { .. }))
+        .unwrap_or_else(|| panic!("Expected LtJumpIfFalse, got {:?}", chunk.code));
+    let (Some(Op::LtJumpIfFalse { dst, target, .. }), Some(Op::JumpIfFalse { cond, target: t })) =
+        (chunk.code.get(fused), chunk.code.get(fused + 1))
+    else {
+        panic!("Expected JumpIfFalse after fused op, got {:?}", chunk.code);
+    };
+    assert_eq!(dst, cond);
+    assert_eq!(target, t);
+    assert!(!contains_op(&chunk, |op| matches!(op, Op::Lt { .. })));
+}
+
+#[test]
+fn test_superinstruction_load_int_arithmetic() {
+    let chunk = compile("let x = 5; let y = x + 1; let z = x - 2;");
+    assert!(
+        contains_op(&chunk, |op| matches!(op, Op::LoadIntAdd { value: 1, .. })),
+        "Expected LoadIntAdd, got {:?}",
+        chunk.code
+    );
+    assert!(
+        contains_op(&chunk, |op| matches!(op, Op::LoadIntSub { value: 2, .. })),
+        "Expected LoadIntSub, got {:?}",
+        chunk.code
+    );
+
+    // An integer on the left is not fused: string concatenation is not commutative
+    let chunk = compile("let x = 'a'; let y = 1 + x;");
+    assert!(!contains_op(&chunk, |op| matches!(
+        op,
+        Op::LoadIntAdd { .. }
+    )));
+}
+
+#[test]
+fn test_superinstructions_survive_bytecode_roundtrip() {
+    let mut dict = StringDict::new();
+    let compiled = compile_program(
+        "let n = 0; while (n < 3) { n = n + 1; } [].pop()",
+        &mut dict,
+    );
+    let bytes = compiled.to_bytes().unwrap();
+    let decoded = tsrun::compiler::CompiledProgram::from_bytes(&bytes, &mut dict).unwrap();
+    let fused = |code: &[Op]| {
+        code.iter()
+            .filter(|op| {
+                matches!(
+                    op,
+                    Op::LtJumpIfFalse { .. }
+                        | Op::LoadIntAdd { .. }
+                        | Op::GetPropertyConstCall { .. }
+                )
+            })
+            .count()
+    };
+    assert_eq!(fused(&compiled.chunk.code), 3);
+    assert_eq!(fused(&decoded.chunk.code), 3);
+}
@@ -1,8 +1,8 @@
 //! Array-related tests
 
-use super::{eval, eval_result};
-use tsrun::JsValue;
+use super::{create_test_runtime, eval, eval_result, run};
 use tsrun::value::JsString;
+use tsrun::{JsValue, StepResult};
 
 #[test]
 fn test_array() {
@@ -1948,3 +1948,134 @@ fn test_array_length_coercion_negative() {
         JsValue::Number(0.0)
     );
 }
+
+// Element kinds: all-number arrays are stored packed, anything else is generic
+
+/// Run `source` and report whether the resulting array has packed storage.
+#[allow(clippy::panic)]
+fn array_is_packed(source: &str) -> bool {
+    let mut interp = create_test_runtime();
+    let Ok(StepResult::Complete(rv)) = run(&mut interp, source, None) else {
+        panic!("script did not complete");
+    };
+    let Some(obj) = rv.as_object() else {
+        panic!("result is not an object");
+    };
+    let borrowed = obj.borrow();
+    let Some(elements) = borrowed.array_storage() else {
+        panic!("result is not an array");
+    };
+    elements.is_packed()
+}
+
+#[test]
+fn test_array_kind_numeric_literal_is_packed() {
+    assert!(array_is_packed("[1, 2.5, -3]"));
+    assert!(array_is_packed("[]"));
+}
+
+#[test]
+fn test_array_kind_stays_packed_through_numeric_ops() {
+    assert!(array_is_packed(
+        r#"
+        const a: number[] = [];
+        for (let i = 0; i < 10; i++) a.push(i * 1.5);
+        a[10] = 99;
+        a.pop();
+        a.shift();
+        a.reverse();
+        a.fill(0, 2, 4);
+        a.slice(1, 5)
+        "#
+    ));
+}
+
+#[test]
+fn test_array_kind_transitions_to_generic() {
+    assert!(!array_is_packed("const a = [1, 2, 3]; a[1] = 'x'; a"));
+    assert!(!array_is_packed("const a = [1, 2, 3]; a.push(null); a"));
+    // Writing past the end leaves holes, which packed storage cannot hold
+    assert!(!array_is_packed("const a = [1, 2, 3]; a[5] = 4; a"));
+    assert!(!array_is_packed("const a = [1, 2]; a.length = 4; a"));
+}
+
+#[test]
+fn test_array_kind_transition_preserves_values() {
+    assert_eq!(
+        eval("const a = [1, 2, 3]; a[1] = 'x'; a.join(',')"),
+        JsValue::String(JsString::from("1,x,3"))
+    );
+    assert_eq!(
+        eval("const a = [1, 2]; a[3] = 4; a.join(',')"),
+        JsValue::String(JsString::from("1,2,,4"))
+    );
+}
+
+#[test]
+fn test_array_packed_search() {
+    assert_eq!(eval("[1, 2, 3, 2].indexOf(2, 2)"), JsValue::Number(3.0));
+    assert_eq!(eval("[1, 2, 3].indexOf(4)"), JsValue::Number(-1.0));
+    assert_eq!(eval("[NaN].indexOf(NaN)"), JsValue::Number(-1.0));
+    assert_eq!(eval("[NaN].includes(NaN)"), JsValue::Boolean(true));
+    assert_eq!(eval("[-0].includes(0)"), JsValue::Boolean(true));
+    assert_eq!(eval("[1, 2, 3].includes(1, 1)"), JsValue::Boolean(false));
+}
+
+#[test]
+fn test_array_packed_fill_with_non_number() {
+    assert_eq!(
+        eval("[1, 2, 3].fill('a', 1).join(',')"),
+        JsValue::String(JsString::from("1,a,a"))
+    );
+}
+
+#[test]
+fn test_array_packed_sort() {
+    assert_eq!(
+        eval("[10, 9, 1, -2, 0.5].sort().join(',')"),
+        JsValue::String(JsString::from("-2,0.5,1,10,9"))
+    );
+    assert_eq!(
+        eval("[10, 9, 1, -2, 0.5].sort((a, b) => a - b).join(',')"),
+        JsValue::String(JsString::from("-2,0.5,1,9,10"))
+    );
+    assert!(array_is_packed("[3, 1, 2].sort((a, b) => b - a)"));
+    assert!(array_is_packed("[3, 1, 2].sort()"));
+}
+
+#[test]
+fn test_array_packed_sort_with_mutating_comparator() {
+    // The comparator turns the array generic; sorted values are still stored
+    assert_eq!(
+        eval(
+            r#"
+            const a: any[] = [3, 1, 2];
+            a.sort((x, y) => { a[0] = 'x'; return x - y; });
+            a.join(',')
+            "#
+        ),
+        JsValue::String(JsString::from("1,2,3"))
+    );
+}
+
+#[test]
+fn test_array_packed_reduce() {
+    assert_eq!(
+        eval("[1, 2, 3, 4].reduce((acc, n) => acc + n)"),
+        JsValue::Number(10.0)
+    );
+    assert_eq!(
+        eval("[1, 2, 3].reduce((acc, n, i) => acc + n * i, 100)"),
+        JsValue::Number(108.0)
+    );
+    // Elements changed by the callback are read as they are at each step
+    assert_eq!(
+        eval(
+            r#"
+            const a: any[] = [1, 2, 3];
+            a.reduce((acc, n, i) => { if (i === 0) { a[1] = 'b'; a.length = 2; } return acc + n; }, '')
+            "#
+        ),
+        JsValue::String(JsString::from("1b"))
+    );
+}
@@ -3231,3 +3231,66 @@ fn test_bytecode_args_not_evaluated_when_callee_throws() {
     );
     assert_eq!(result, JsValue::Boolean(false));
 }
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Superinstructions
+// ═══════════════════════════════════════════════════════════════════════════
+
+#[test]
+fn test_bytecode_fused_compare_jumps() {
+    let result = eval_bytecode(
+        r#"
+        let hits = 0;
+        for (let i = 0; i < 5; i++) hits++;
+        for (let i = 0; i <= 5; i++) hits++;
+        for (let i = 5; i > 0; i--) hits++;
+        for (let i = 5; i >= 0; i--) hits++;
+        let s = "x";
+        if (s === "x") hits += 100;
+        if (s !== "x") hits += 1000;
+        hits
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(122.0));
+}
+
+#[test]
+fn test_bytecode_fused_int_arithmetic_slow_paths() {
+    // Non-number left operands take the generic Add/Sub paths
+    assert_eq!(
+        eval_bytecode("let s = 'a'; s + 1"),
+        JsValue::String("a1".into())
+    );
+    assert_eq!(
+        eval_bytecode("let o = { valueOf() { return 10; } }; (o - 2) + (o + 1)"),
+        JsValue::Number(19.0)
+    );
+    assert_eq!(
+        eval_bytecode("let u; Number.isNaN(u + 1) && Number.isNaN(u - 1)"),
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_bytecode_fused_method_call() {
+    let result = eval_bytecode(
+        r#"
+        const arr = [1, 2, 3];
+        const popped = arr.pop();
+        const obj = {
+            x: 4,
+            get(): number { return this.x; },
+            get viaGetter() { return () => 30; },
+        };
+        let caught = false;
+        try {
+            const nothing: any = null;
+            nothing.missing();
+        } catch (e) {
+            caught = e instanceof TypeError;
+        }
+        popped + obj.get() + obj.viaGetter() + (caught ? 100 : 0)
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(137.0));
+}
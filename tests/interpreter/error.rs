@@ -137,6 +137,68 @@ fn test_error_stack_in_function() {
     );
 }
 
+#[test]
+fn test_error_stack_lists_throw_sites() {
+    let source = r#"
+        function inner(): never { throw new Error('deep'); }
+        function outer() { inner(); }
+        let stack = '';
+        try { outer(); } catch (e) { stack = e.stack; }
+        const lines = stack.split('\n');
+        [lines[0], lines[1].includes('at inner'), lines[2].includes('at outer')].join()
+    "#;
+    assert_eq!(eval(source), JsValue::from("Error: deep,true,true"));
+}
+
+#[test]
+fn test_error_stack_of_runtime_error() {
+    let source = r#"
+        function read(o: any) { return o.missing.field; }
+        let stack = '';
+        try { read({}); } catch (e) { stack = e.stack; }
+        stack.startsWith('TypeError') && stack.includes('at read')
+    "#;
+    assert_eq!(eval(source), JsValue::Boolean(true));
+}
+
+#[test]
+fn test_error_stack_kept_on_rethrow_and_assignable() {
+    let source = r#"
+        function fail(): never { throw new RangeError('first'); }
+        function relay() { try { fail(); } catch (e) { throw e; } }
+        let rethrown = '';
+        try { relay(); } catch (e) { rethrown = e.stack.split('\n')[1]; }
+        const custom = new Error('x');
+        custom.stack = 'custom';
+        [rethrown.includes('at fail'), custom.stack, 'stack' in new Error(),
+         Object.keys(new Error('k')).includes('stack'),
+         Object.prototype.toString.call(new TypeError())].join()
+    "#;
+    assert_eq!(
+        eval(source),
+        JsValue::from("true,custom,true,false,[object Error]")
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn test_uncaught_error_carries_stack_frames() {
+    use super::eval_result;
+    use tsrun::JsError;
+
+    let err = eval_result("function boom(): never { throw new Error('out'); } boom()").unwrap_err();
+    match err {
+        JsError::RuntimeError { kind, stack, .. } => {
+            assert_eq!(kind, "Error");
+            assert_eq!(
+                stack.first().and_then(|f| f.function_name.as_deref()),
+                Some("boom")
+            );
+        }
+        other => panic!("Expected RuntimeError, got {:?}", other),
+    }
+}
+
 #[test]
 fn test_urierror() {
     assert_eq!(
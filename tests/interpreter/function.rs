@@ -1,6 +1,6 @@
 //! Function-related tests
 
-use super::{eval, run};
+use super::{eval, run, throws_error};
 use tsrun::value::JsString;
 use tsrun::{Interpreter, JsValue, StepResult};
 
@@ -1737,3 +1737,98 @@ fn test_call_bind_get_own_property_descriptor() {
         JsValue::Number(1.0)
     );
 }
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Register-resolved locals
+// ═══════════════════════════════════════════════════════════════════════════════
+
+#[test]
+fn test_local_const_assignment_throws() {
+    assert!(throws_error(
+        "function f() { const x = 1; x = 2; return x; } f()",
+        "Assignment to constant variable 'x'"
+    ));
+}
+
+#[test]
+fn test_local_block_shadowing() {
+    assert_eq!(
+        eval("function f() { let a = 1; { let a = 2; a++; } return a; } f()"),
+        JsValue::Number(1.0)
+    );
+}
+
+#[test]
+fn test_local_captured_by_closure() {
+    // Captured locals stay in the environment and see later writes
+    assert_eq!(
+        eval(
+            r#"
+            function f() {
+                let x = 1;
+                const get = () => x;
+                x = 7;
+                return get();
+            }
+            f()
+        "#
+        ),
+        JsValue::Number(7.0)
+    );
+}
+
+#[test]
+fn test_local_for_let_closures_per_iteration() {
+    assert_eq!(
+        eval(
+            r#"
+            function f() {
+                const fs = [];
+                for (let i = 0; i < 3; i++) fs.push(() => i);
+                let sum = 0;
+                for (let j = 0; j < 3; j++) sum += fs[j]();
+                return sum;
+            }
+            f()
+        "#
+        ),
+        JsValue::Number(3.0)
+    );
+}
+
+#[test]
+fn test_local_visible_to_direct_eval() {
+    assert_eq!(
+        eval("function f() { let x = 10; return eval('x + 1'); } f()"),
+        JsValue::Number(11.0)
+    );
+}
+
+#[test]
+fn test_local_survives_generator_suspension() {
+    assert_eq!(
+        eval(
+            r#"
+            function* g() { let a = 1; yield a; a += 5; yield a; }
+            [...g()].join(",")
+        "#
+        ),
+        JsValue::from("1,6")
+    );
+}
+
+#[test]
+fn test_local_catch_and_switch_scopes() {
+    assert_eq!(
+        eval(
+            r#"
+            function f(n) {
+                try { throw n; } catch (e) { let y = e + 1; n = y; }
+                switch (n) { case 2: let r = "two"; return r; default: return "other"; }
+            }
+            f(1)
+        "#
+        ),
+        JsValue::from("two")
+    );
+}
@@ -0,0 +1,237 @@
+//! Tests for hidden-class shapes and inline caches on constant-key property access
+
+use super::{eval, run, throws_error};
+use tsrun::{InlineCacheStats, Interpreter, JsValue, StepResult};
+
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn eval_with_ic_stats(source: &str) -> (JsValue, InlineCacheStats) {
+    let mut interp = Interpreter::new();
+    let result = match run(&mut interp, source, None).unwrap() {
+        StepResult::Complete(rv) => rv.value().clone(),
+        other => panic!("Expected Complete, got {:?}", other),
+    };
+    (result, interp.inline_cache_stats())
+}
+
+#[test]
+fn test_ic_stats_start_empty() {
+    let interp = Interpreter::new();
+    assert_eq!(interp.inline_cache_stats(), InlineCacheStats::default());
+}
+
+#[test]
+fn test_ic_monomorphic_field_hits() {
+    let (result, stats) = eval_with_ic_stats(
+        r#"
+        let sum = 0;
+        const point = { x: 1, y: 2 };
+        for (let i = 0; i < 100; i++) {
+            sum += point.x + point.y;
+        }
+        sum
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(300.0));
+    assert!(stats.hits >= 190, "expected cached reads, got {:?}", stats);
+    assert_eq!(stats.megamorphic_sites, 0);
+}
+
+#[test]
+fn test_ic_prototype_method_hits() {
+    let (result, stats) = eval_with_ic_stats(
+        r#"
+        class Counter {
+            count: number = 0;
+            increment(): void { this.count = this.count + 1; }
+        }
+        const c = new Counter();
+        for (let i = 0; i < 100; i++) {
+            c.increment();
+        }
+        c.count
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(100.0));
+    // Method load, field read and field write per iteration
+    assert!(
+        stats.hits >= 290,
+        "expected cached accesses, got {:?}",
+        stats
+    );
+}
+
+#[test]
+fn test_ic_shared_shape_across_instances() {
+    let (result, stats) = eval_with_ic_stats(
+        r#"
+        function make(i: number) { return { a: i, b: i * 2 }; }
+        let sum = 0;
+        for (let i = 0; i < 50; i++) {
+            const o = make(i);
+            sum += o.b;
+        }
+        sum
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(2450.0));
+    // Both the stores in `make` and the read share one layout per site
+    assert!(
+        stats.hits >= 140,
+        "expected cached accesses, got {:?}",
+        stats
+    );
+}
+
+#[test]
+fn test_ic_megamorphic_site() {
+    let (result, stats) = eval_with_ic_stats(
+        r#"
+        const objs = [{ v: 1 }, { a: 0, v: 2 }, { b: 0, v: 3 }, { c: 0, v: 4 },
+                      { d: 0, v: 5 }, { e: 0, v: 6 }];
+        let sum = 0;
+        for (let round = 0; round < 3; round++) {
+            for (const o of objs) sum += o.v;
+        }
+        sum
+    "#,
+    );
+    assert_eq!(result, JsValue::Number(63.0));
+    assert!(
+        stats.megamorphic_sites >= 1,
+        "expected a megamorphic site, got {:?}",
+        stats
+    );
+}
+
+#[test]
+fn test_ic_replaced_prototype_method() {
+    assert_eq!(
+        eval(
+            r#"
+            class A { name(): string { return "a"; } }
+            const a = new A();
+            let out = "";
+            for (let i = 0; i < 4; i++) {
+                if (i === 2) A.prototype.name = function () { return "b"; };
+                out += a.name();
+            }
+            out
+        "#
+        ),
+        JsValue::from("aabb")
+    );
+}
+
+#[test]
+fn test_ic_own_property_shadows_prototype() {
+    assert_eq!(
+        eval(
+            r#"
+            const proto = { v: 1 };
+            const o = Object.create(proto);
+            let out = 0;
+            for (let i = 0; i < 4; i++) {
+                if (i === 2) o.v = 10;
+                out += o.v;
+            }
+            out
+        "#
+        ),
+        JsValue::Number(22.0)
+    );
+}
+
+#[test]
+fn test_ic_after_delete() {
+    assert_eq!(
+        eval(
+            r#"
+            const o: any = { a: 1, b: 2 };
+            let out = 0;
+            for (let i = 0; i < 4; i++) {
+                if (i === 2) delete o.a;
+                out += o.a === undefined ? 100 : o.a;
+            }
+            out
+        "#
+        ),
+        JsValue::Number(202.0)
+    );
+}
+
+#[test]
+fn test_ic_getter_not_cached() {
+    assert_eq!(
+        eval(
+            r#"
+            let n = 0;
+            const o = { get v() { return ++n; } };
+            let out = 0;
+            for (let i = 0; i < 3; i++) out += o.v;
+            out
+        "#
+        ),
+        JsValue::Number(6.0)
+    );
+}
+
+#[test]
+fn test_ic_setter_on_prototype_intercepts_add() {
+    assert_eq!(
+        eval(
+            r#"
+            let seen = 0;
+            const proto: any = {};
+            function store(o: any, x: number) { o.v = x; }
+            // Warm the store site with the add-property transition
+            for (let i = 0; i < 3; i++) store(Object.create(proto), i);
+            Object.defineProperty(proto, "v", { set(x: number) { seen += x; } });
+            const o = Object.create(proto);
+            store(o, 5);
+            seen + (o.hasOwnProperty("v") ? 1000 : 0)
+        "#
+        ),
+        JsValue::Number(5.0)
+    );
+}
+
+#[test]
+fn test_ic_frozen_object_store() {
+    assert!(throws_error(
+        r#"
+        "use strict";
+        const o = { v: 1 };
+        for (let i = 0; i < 3; i++) {
+            if (i === 2) Object.freeze(o);
+            o.v = i;
+        }
+    "#,
+        "read only property"
+    ));
+}
+
+#[test]
+fn test_ic_array_length_not_cached() {
+    assert_eq!(
+        eval(
+            r#"
+            const arr: number[] = [];
+            let out = 0;
+            for (let i = 0; i < 4; i++) {
+                arr.push(i);
+                out += arr.length;
+            }
+            out
+        "#
+        ),
+        JsValue::Number(10.0)
+    );
+}
+
+#[test]
+fn test_shape_keys_keep_insertion_order() {
+    assert_eq!(
+        eval(r#"const o: any = { z: 1, a: 2 }; o.m = 3; Object.keys(o).join(",")"#),
+        JsValue::from("z,a,m")
+    );
+}
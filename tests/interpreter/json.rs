@@ -207,3 +207,235 @@ fn test_json_raw_json_null_prototype() {
         JsValue::Null
     );
 }
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// Streaming parse / stringify
+// ═══════════════════════════════════════════════════════════════════════════════
+
+use super::{create_test_runtime, run};
+use tsrun::{
+    Interpreter, JsError, JsonStreamParser, RuntimeValue, StepResult, js_value_to_json,
+    json_stringify_to, json_to_js_value_with_interp,
+};
+
+/// Evaluate `source` in `interp`, which must outlive the returned value
+#[allow(clippy::panic)]
+fn eval_in(interp: &mut Interpreter, source: &str) -> RuntimeValue {
+    match run(interp, source, None) {
+        Ok(StepResult::Complete(value)) => value,
+        other => panic!("Expected completion, got {:?}", other),
+    }
+}
+
+/// Collect the chunked output of json_stringify_to into one string
+fn stringify_chunked(value: &JsValue) -> Result<String, JsError> {
+    let mut out = String::new();
+    json_stringify_to(value, |chunk| {
+        out.push_str(chunk);
+        Ok(())
+    })?;
+    Ok(out)
+}
+
+/// Serialize through the serde_json tree, as tsrun_json_stringify used to
+fn stringify_tree(value: &JsValue) -> String {
+    let json = js_value_to_json(value).unwrap_or(serde_json::Value::Null);
+    serde_json::to_string(&json).unwrap_or_default()
+}
+
+/// Parse `text` by feeding it in chunks of `chunk_size` bytes
+fn parse_chunked(
+    interp: &mut Interpreter,
+    text: &str,
+    chunk_size: usize,
+) -> Result<tsrun::Guarded, JsError> {
+    let mut parser = JsonStreamParser::new(interp);
+    for chunk in text.as_bytes().chunks(chunk_size) {
+        parser.feed(interp, chunk)?;
+    }
+    parser.finish()
+}
+
+const STREAM_SAMPLE: &str = r#" {"name": "caf\u00e9 ☕", "nums": [0, -1, 2.5, 1e3, -0.125E-2, 12345678901],
+    "nested": {"deep": [[], {}, [true, false, null]], "esc": "a\"b\\c\/d\n\t\u0001"},
+    "emoji": "\ud83d\ude00 😀", "dup": 1, "dup": 2} "#;
+
+#[test]
+fn test_json_stream_parse_any_chunking() {
+    let mut interp = create_test_runtime();
+    let whole = parse_chunked(&mut interp, STREAM_SAMPLE, usize::MAX).unwrap();
+    let expected = stringify_tree(&whole.value);
+    assert!(expected.contains(r#""emoji":"😀 😀""#), "{}", expected);
+    assert!(expected.contains(r#""dup":2"#), "{}", expected);
+    // Every split point, including inside escapes and multi-byte characters
+    for chunk_size in 1..8 {
+        let parsed = parse_chunked(&mut interp, STREAM_SAMPLE, chunk_size).unwrap();
+        assert_eq!(
+            stringify_tree(&parsed.value),
+            expected,
+            "chunk size {}",
+            chunk_size
+        );
+    }
+}
+
+#[test]
+fn test_json_stream_parse_matches_json_parse() {
+    let mut interp = create_test_runtime();
+    let parsed = parse_chunked(&mut interp, STREAM_SAMPLE, 3).unwrap();
+    let via_serde: serde_json::Value = serde_json::from_str(STREAM_SAMPLE).unwrap();
+    let via_serde = json_to_js_value_with_interp(&mut interp, &via_serde).unwrap();
+    assert_eq!(stringify_tree(&parsed.value), stringify_tree(&via_serde));
+}
+
+#[test]
+fn test_json_stream_parse_primitives() {
+    let mut interp = create_test_runtime();
+    assert_eq!(
+        parse_chunked(&mut interp, "42", 1).unwrap().value,
+        JsValue::Number(42.0)
+    );
+    assert_eq!(
+        parse_chunked(&mut interp, " -1.5e2 ", 2).unwrap().value,
+        JsValue::Number(-150.0)
+    );
+    assert_eq!(
+        parse_chunked(&mut interp, "\"hi\"", 1).unwrap().value,
+        JsValue::from("hi")
+    );
+    assert_eq!(
+        parse_chunked(&mut interp, "null", 1).unwrap().value,
+        JsValue::Null
+    );
+    assert_eq!(
+        parse_chunked(&mut interp, "true", 3).unwrap().value,
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_json_stream_parse_errors() {
+    let mut interp = create_test_runtime();
+    for bad in [
+        "",
+        "{",
+        "[1,]",
+        "{\"a\" 1}",
+        "{\"a\":1,}",
+        "01",
+        "1.",
+        "-",
+        "1e",
+        "tru",
+        "nul1",
+        "\"\\x\"",
+        "\"a\nb\"",
+        "\"\\ud83d\"",
+        "\"\\ude00\"",
+        "[1] 2",
+        "{1:2}",
+        "\"\u{1}\"",
+    ] {
+        let result = parse_chunked(&mut interp, bad, 1);
+        assert!(result.is_err(), "expected error for {:?}", bad);
+    }
+    // Invalid UTF-8 inside a string
+    let mut parser = JsonStreamParser::new(&interp);
+    parser.feed(&mut interp, b"\"\xff\"").unwrap_err();
+    // The parser stays failed
+    assert!(parser.feed(&mut interp, b"").is_err());
+    assert!(parser.finish().is_err());
+}
+
+#[test]
+fn test_json_stream_parse_error_position() {
+    let mut interp = create_test_runtime();
+    let err = parse_chunked(&mut interp, "[1, 2, x]", 4).unwrap_err();
+    assert!(err.to_string().contains("position 7"), "{}", err);
+}
+
+#[test]
+fn test_json_stream_parse_deep_nesting() {
+    // Nesting is tracked on the heap, not the native stack
+    let depth = 20_000;
+    let text = format!("{}{}", "[".repeat(depth), "]".repeat(depth));
+    let mut interp = create_test_runtime();
+    interp.set_gc_threshold(100);
+    assert!(parse_chunked(&mut interp, &text, 4096).is_ok());
+}
+
+#[test]
+fn test_json_stream_parse_survives_gc_between_chunks() {
+    let mut interp = create_test_runtime();
+    let mut parser = JsonStreamParser::new(&interp);
+    parser
+        .feed(&mut interp, br#"{"a": [{"b": 1}, {"c"#)
+        .unwrap();
+    interp.heap.collect();
+    parser
+        .feed(&mut interp, br#"": [2, 3]}], "d": {"e": "f"}}"#)
+        .unwrap();
+    interp.heap.collect();
+    let parsed = parser.finish().unwrap();
+    interp.heap.collect();
+    assert_eq!(
+        stringify_tree(&parsed.value),
+        r#"{"a":[{"b":1},{"c":[2,3]}],"d":{"e":"f"}}"#
+    );
+}
+
+#[test]
+fn test_json_stringify_to_matches_tree_output() {
+    let mut interp = create_test_runtime();
+    let result = eval_in(
+        &mut interp,
+        r#"
+        enum Color { Red, Green = 5 }
+        ({
+            z: 1, a: [1.5, -0, 1e21, 1e-7, 0.1, 2 ** 53, NaN, Infinity, undefined, null],
+            s: "quote\" back\\ nl\n tab\t ctl\u0001 del\u007f é 😀",
+            date: new Date(0), wrap: [new Number(1), new Boolean(false), new String("x")],
+            color: Color, raw: JSON.rawJSON('{"k": [1, 2]}'),
+            skip: undefined, fn: () => 1, re: /x/, m: new Map(), 10: "ten", 2: "two",
+            nested: { b: { c: [] }, a: {} },
+        })
+    "#,
+    );
+    assert_eq!(stringify_chunked(&result).unwrap(), stringify_tree(&result));
+}
+
+#[test]
+fn test_json_stringify_to_chunks_large_output() {
+    let mut interp = create_test_runtime();
+    let result = eval_in(
+        &mut interp,
+        r#"
+        const items = [];
+        for (let i = 0; i < 2000; i++) items.push({ id: i, name: "item" + i });
+        items
+    "#,
+    );
+    let mut chunks = 0;
+    let mut out = String::new();
+    json_stringify_to(&result, |chunk| {
+        assert!(chunk.len() <= 16 * 1024);
+        chunks += 1;
+        out.push_str(chunk);
+        Ok(())
+    })
+    .unwrap();
+    assert!(chunks > 1);
+    assert_eq!(out, stringify_tree(&result));
+}
+
+#[test]
+fn test_json_stringify_to_circular_and_abort() {
+    let mut interp = create_test_runtime();
+    let result = eval_in(&mut interp, "const o: any = { a: 1 }; o.self = o; o");
+    let err = stringify_chunked(&result).unwrap_err();
+    assert!(err.to_string().contains("circular"), "{}", err);
+
+    let result = eval_in(&mut interp, "[1, 2, 3]");
+    let err = json_stringify_to(&result, |_| Err(JsError::internal_error("stop"))).unwrap_err();
+    assert!(err.to_string().contains("stop"), "{}", err);
+}
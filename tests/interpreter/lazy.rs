@@ -0,0 +1,175 @@
+//! Tests for lazy parsing and compilation of function bodies
+
+use super::{create_test_runtime, run};
+use tsrun::{Interpreter, JsError, JsValue, StepResult};
+
+fn lazy_runtime() -> Interpreter {
+    let mut interp = create_test_runtime();
+    interp.set_lazy_compilation(true);
+    interp
+}
+
+fn eval_lazy(source: &str) -> Result<JsValue, JsError> {
+    let mut interp = lazy_runtime();
+    match run(&mut interp, source, None)? {
+        StepResult::Complete(value) => Ok(value.value().clone()),
+        other => Err(JsError::type_error(format!("unexpected {:?}", other))),
+    }
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_functions_run_like_eager_ones() {
+    let source = r#"
+        const counter = (start: number) => { let n = start; return () => ++n; };
+        function* range(n: number) { for (let i = 0; i < n; i++) yield i; }
+        class Box {
+            #value: number;
+            constructor(value: number) { this.#value = value; }
+            get doubled() { return this.#value * 2; }
+            #secret() { return this.#value + 1; }
+            reveal() { return this.#secret(); }
+        }
+        function outer(a: number, b = a * 2) {
+            const inner = function (c: number) { return a + b + c; };
+            return inner(1);
+        }
+        const next = counter(5);
+        next();
+        [next(), [...range(3)].join(), new Box(4).doubled, new Box(4).reveal(), outer(1)].join(" ")
+    "#;
+    assert_eq!(eval_lazy(source).unwrap(), JsValue::from("7 0,1,2 8 5 4"));
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_function_name_and_length_before_first_call() {
+    assert_eq!(
+        eval_lazy("function add(a, b) { return a + b; } `${add.name}/${add.length}`").unwrap(),
+        JsValue::from("add/2")
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_async_functions() {
+    let source = r#"
+        let result = "";
+        async function load(x: number) { await null; return x * 3; }
+        load(2).then(v => { result = String(v); });
+        await Promise.resolve();
+        await Promise.resolve();
+        await Promise.resolve();
+        result
+    "#;
+    assert_eq!(eval_lazy(source).unwrap(), JsValue::from("6"));
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_skip_handles_braces_in_literals() {
+    // Braces inside strings, templates, regexps and comments must not end the
+    // skipped body early
+    let source = r#"
+        function tricky(a: number) {
+            const s = "}" + '{' + `${ { a }.a }}` + /[}]{1}/.source; // }
+            /* } */
+            const half = (a) / 2, ratio = [a][0] / 4;
+            if (a) /}/.test("}");
+            return `${s}|${half}|${ratio}|${`nested ${ `}` }`}`;
+        }
+        // Only parses if skipped, so the scan must get past all of the above
+        function uncalled(a: number) {
+            const s = "}" + '{' + `${ { a }.a }}` + /[}]{1}/.source; // }
+            if (a) /}/.test("}");
+            let x = ;
+        }
+        tricky(8)
+    "#;
+    assert_eq!(
+        eval_lazy(source).unwrap(),
+        JsValue::from("}{8}[}]{1}|4|2|nested }")
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_defers_syntax_errors_in_uncalled_functions() {
+    // Deferred until the broken function is called
+    let source = "function broken() { let x = ; } function ok() { return 1; } ok()";
+    assert_eq!(eval_lazy(source).ok(), Some(JsValue::Number(1.0)));
+
+    let err = eval_lazy("function broken() { let x = ; } broken()").unwrap_err();
+    assert!(format!("{:?}", err).contains("SyntaxError"), "{:?}", err);
+
+    // Eager mode reports it up front
+    let mut interp = create_test_runtime();
+    interp.set_lazy_compilation(false);
+    assert!(run(&mut interp, source, None).is_err());
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_reports_invalid_tokens_up_front() {
+    let err = eval_lazy("function broken() { return 1 ¤ 2; } 1").unwrap_err();
+    assert!(format!("{:?}", err).contains("SyntaxError"), "{:?}", err);
+}
+
+#[test]
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn test_lazy_program_round_trips_through_bytecode() {
+    let mut interp = lazy_runtime();
+    let bytes = interp
+        .compile_to_bytecode(
+            "function twice(f: (x: number) => number, x: number) { return f(f(x)); } twice(x => x + 3, 1)",
+            None,
+        )
+        .unwrap();
+
+    let mut fresh = create_test_runtime();
+    fresh.prepare_bytecode(&bytes, None).unwrap();
+    match super::run_to_completion(&mut fresh).unwrap() {
+        StepResult::Complete(value) => assert_eq!(*value.value(), JsValue::Number(7.0)),
+        other => panic!("Expected Complete, got {:?}", other),
+    }
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_lazy_syntax_errors_stay_deferred_through_bytecode() {
+    let mut interp = lazy_runtime();
+    let bytes = interp
+        .compile_to_bytecode(
+            "function broken() { let x = ; } \
+             function ok() { return 1; } \
+             let caught = ''; \
+             try { broken(); } catch (e) { caught = String(e); } \
+             `${ok()} ${broken.name}/${broken.length} ${caught}`",
+            None,
+        )
+        .unwrap();
+
+    let mut fresh = create_test_runtime();
+    fresh.prepare_bytecode(&bytes, None).unwrap();
+    let result = match super::run_to_completion(&mut fresh).unwrap() {
+        StepResult::Complete(value) => value.value().clone(),
+        other => JsValue::from(format!("unexpected {:?}", other).as_str()),
+    };
+    let text = result.as_str().map(str::to_string).unwrap_or_default();
+    assert!(text.starts_with("1 broken/0 SyntaxError"), "{}", text);
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_serializing_leaves_lazy_bodies_uncompiled() {
+    let source: std::rc::Rc<str> = std::rc::Rc::from("function f() { return 1; } f");
+    let mut dict = tsrun::string_dict::StringDict::new();
+    let program = tsrun::parser::Parser::new_lazy(&source, &mut dict)
+        .parse_program()
+        .unwrap();
+    let compiled = tsrun::compiler::CompiledProgram::compile_lazy(&program, None).unwrap();
+
+    compiled.to_bytes().unwrap();
+    let debug = format!("{:?}", compiled.chunk);
+    assert!(debug.contains("compiled: false"), "{}", debug);
+}
@@ -34,7 +34,9 @@ mod function;
 mod gc;
 mod generator;
 mod global;
+mod inline_cache;
 mod json;
+mod lazy;
 mod map;
 mod math;
 mod modules;
@@ -42,22 +44,27 @@ mod namespace;
 mod number;
 mod object;
 mod orders;
+mod pool;
+mod profiler;
 mod promise;
 mod proxy;
 mod regexp;
 mod set;
+mod snapshot;
 mod step;
 mod strict;
 mod string;
 mod symbol;
+mod typed_array;
 mod typescript;
+mod value_codec;
 
 use tsrun::{Interpreter, JsError, JsValue, RuntimeValue, StepResult};
 
 /// Create a new interpreter with aggressive defaults for testing:
 /// - GC_THRESHOLD=1 (GC on every allocation) to catch GC bugs
 pub fn create_test_runtime() -> Interpreter {
-    let interp = Interpreter::new();
+    let mut interp = Interpreter::new();
 
     // Default to GC_THRESHOLD=1 (most aggressive) to catch GC bugs early
     // Override via environment variable if needed:
@@ -69,6 +76,21 @@ pub fn create_test_runtime() -> Interpreter {
         .unwrap_or(1);
     interp.set_gc_threshold(gc_threshold);
 
+    // Run the suite against the incremental collector with e.g.
+    // GC_BUDGET=1 cargo test
+    if let Some(budget) = std::env::var("GC_BUDGET")
+        .ok()
+        .and_then(|s| s.parse::<u64>().ok())
+    {
+        interp.set_gc_budget(budget);
+    }
+
+    // Run the suite with functions parsed and compiled on first call with
+    // LAZY=1 cargo test
+    if std::env::var("LAZY").is_ok_and(|s| s == "1") {
+        interp.set_lazy_compilation(true);
+    }
+
     interp
 }
 
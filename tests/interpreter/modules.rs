@@ -1940,3 +1940,106 @@ fn test_live_binding_imported_value_is_readonly() {
         _ => panic!("Expected NeedImports"),
     }
 }
+
+#[test]
+fn test_prepare_bytecode_with_precompiled_module() {
+    // Compile on one interpreter, run on another
+    let mut build = Interpreter::new();
+    let main = build
+        .compile_to_bytecode(
+            r#"
+            import { add } from "./math";
+            add(2, 3) * 10;
+        "#,
+            Some(&ModulePath::new("/main.ts")),
+        )
+        .unwrap();
+    let math_path = ModulePath::new("math");
+    let math = build
+        .compile_to_bytecode(
+            "export function add(a: number, b: number): number { return a + b; }",
+            Some(&math_path),
+        )
+        .unwrap();
+
+    let mut interp = Interpreter::new();
+    interp
+        .prepare_bytecode(&main, Some(ModulePath::new("/main.ts")))
+        .unwrap();
+    let result = run_to_completion(&mut interp).unwrap();
+    let StepResult::NeedImports(imports) = result else {
+        panic!("Expected NeedImports");
+    };
+    assert_eq!(imports.len(), 1);
+    assert_eq!(imports[0].resolved_path, math_path);
+
+    interp.provide_module_bytecode(math_path, &math).unwrap();
+    match run_to_completion(&mut interp).unwrap() {
+        StepResult::Complete(value) => assert_eq!(*value, JsValue::Number(50.0)),
+        _ => panic!("Expected Complete result"),
+    }
+}
+
+#[test]
+fn test_compiled_modules_from_worker_threads() {
+    use tsrun::compiler::CompiledModule;
+
+    let mut interp = Interpreter::new();
+    interp
+        .prepare(
+            r#"
+            import { add } from "./math";
+            import { greet } from "./greet";
+            greet("tsrun") + add(2, 3);
+        "#,
+            Some(ModulePath::new("/main.ts")),
+        )
+        .unwrap();
+    let StepResult::NeedImports(imports) = run_to_completion(&mut interp).unwrap() else {
+        panic!("Expected NeedImports");
+    };
+    assert_eq!(imports.len(), 2);
+
+    // Compile the whole batch on other threads, with no interpreter involved
+    let workers: Vec<_> = imports
+        .iter()
+        .map(|import| {
+            let path = import.resolved_path.clone();
+            std::thread::spawn(move || {
+                let source = match path.as_str() {
+                    "math" => "export function add(a: number, b: number): number { return a + b; }",
+                    _ => "export const greet = (name: string): string => `hi ${name} `;",
+                };
+                // JsError is not Send; hand back its message
+                CompiledModule::compile(source, path).map_err(|e| e.to_string())
+            })
+        })
+        .collect();
+    for worker in workers {
+        let module = worker.join().unwrap().unwrap();
+        interp
+            .provide_module_bytecode(module.path().clone(), module.as_bytes())
+            .unwrap();
+    }
+
+    match run_to_completion(&mut interp).unwrap() {
+        StepResult::Complete(value) => {
+            assert_eq!(*value, JsValue::String("hi tsrun 5".into()))
+        }
+        _ => panic!("Expected Complete result"),
+    }
+}
+
+#[test]
+fn test_compiled_module_reports_syntax_errors() {
+    let err = tsrun::compiler::CompiledModule::compile("export const = ;", ModulePath::new("bad"))
+        .unwrap_err();
+    assert!(err.to_string().contains("Syntax"), "{}", err);
+}
+
+#[test]
+fn test_prepare_bytecode_rejects_garbage() {
+    let mut interp = Interpreter::new();
+    let err = interp.prepare_bytecode(b"not bytecode", None).unwrap_err();
+    assert!(err.to_string().contains("Invalid bytecode"));
+}
@@ -0,0 +1,215 @@
+//! Tests for the multi-threaded interpreter pool
+
+use std::sync::mpsc;
+use std::time::Duration;
+use tsrun::ModulePath;
+use tsrun::compiler::CompiledModule;
+use tsrun::pool::{InterpreterPool, JobResult};
+
+#[allow(clippy::unwrap_used)]
+fn pool_with(threads: usize, modules: &[(&str, &str)]) -> InterpreterPool {
+    let pool = InterpreterPool::new(threads).unwrap();
+    for (path, source) in modules {
+        pool.add_module(CompiledModule::compile(source, ModulePath::new(*path)).unwrap())
+            .unwrap();
+    }
+    pool
+}
+
+#[allow(clippy::unwrap_used)]
+fn call(pool: &InterpreterPool, module: &str, entry: &str, args: &str) -> JobResult {
+    let (tx, rx) = mpsc::channel();
+    pool.submit(module, entry, args, move |result| tx.send(result).unwrap())
+        .unwrap();
+    rx.recv_timeout(Duration::from_secs(10)).unwrap()
+}
+
+const MATH: &str = r#"
+    export function add(a: number, b: number): number { return a + b; }
+    export function pair(a: number) { return { a, square: a * a }; }
+    export function nothing() {}
+    export async function later(x: number) { return await Promise.resolve(x * 2); }
+    export async function fail() { throw new RangeError("no good"); }
+"#;
+
+#[test]
+fn test_pool_runs_exported_functions() {
+    let pool = pool_with(2, &[("/math.ts", MATH)]);
+    assert_eq!(
+        call(&pool, "/math.ts", "add", "[2, 3]"),
+        Ok(Some("5".into()))
+    );
+    assert_eq!(
+        call(&pool, "/math.ts", "pair", "[4]"),
+        Ok(Some(r#"{"a":4,"square":16}"#.into()))
+    );
+    assert_eq!(call(&pool, "/math.ts", "nothing", ""), Ok(None));
+}
+
+#[test]
+fn test_pool_settles_async_entries() {
+    let pool = pool_with(1, &[("/math.ts", MATH)]);
+    assert_eq!(
+        call(&pool, "/math.ts", "later", "[21]"),
+        Ok(Some("42".into()))
+    );
+    assert_eq!(
+        call(&pool, "/math.ts", "fail", "[]"),
+        Err("RangeError: no good".into())
+    );
+}
+
+#[test]
+fn test_pool_job_errors() {
+    let pool = pool_with(1, &[("/math.ts", MATH)]);
+    assert!(pool.submit("/missing.ts", "add", "[]", |_| {}).is_err());
+    assert!(call(&pool, "/math.ts", "subtract", "[]").is_err());
+    assert!(call(&pool, "/math.ts", "add", "{\"a\": 1}").is_err());
+    assert!(call(&pool, "/math.ts", "add", "[1,").is_err());
+    // A failed job leaves the worker usable
+    assert_eq!(
+        call(&pool, "/math.ts", "add", "[1, 1]"),
+        Ok(Some("2".into()))
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_pool_rejects_duplicate_modules() {
+    let pool = pool_with(1, &[("/math.ts", MATH)]);
+    let again = CompiledModule::compile(MATH, ModulePath::new("/math.ts")).unwrap();
+    assert!(pool.add_module(again).is_err());
+}
+
+#[test]
+fn test_pool_resolves_imports_between_modules() {
+    let pool = pool_with(
+        2,
+        &[
+            (
+                "/lib/util.ts",
+                "export const scale = (x: number) => x * 10;",
+            ),
+            (
+                "/app/main.ts",
+                r#"import { scale } from "../lib/util.ts";
+                   export function run(x: number) { return scale(x) + 1; }"#,
+            ),
+            (
+                "/app/broken.ts",
+                r#"import { nope } from "./absent.ts"; export const f = () => nope;"#,
+            ),
+        ],
+    );
+    assert_eq!(
+        call(&pool, "/app/main.ts", "run", "[4]"),
+        Ok(Some("41".into()))
+    );
+    let err = call(&pool, "/app/broken.ts", "f", "[]");
+    assert!(matches!(err, Err(ref message) if message.contains("/app/absent.ts")));
+}
+
+#[test]
+fn test_pool_keeps_module_state_per_worker() {
+    let pool = pool_with(
+        1,
+        &[(
+            "/counter.ts",
+            "let n = 0; export function next() { return ++n; }",
+        )],
+    );
+    assert_eq!(call(&pool, "/counter.ts", "next", ""), Ok(Some("1".into())));
+    assert_eq!(call(&pool, "/counter.ts", "next", ""), Ok(Some("2".into())));
+}
+
+#[test]
+fn test_pool_resets_worker_after_failed_load() {
+    let pool = pool_with(
+        1,
+        &[
+            (
+                "/counter.ts",
+                "let n = 0; export function next() { return ++n; }",
+            ),
+            (
+                "/throws.ts",
+                r#"throw new Error("load failed"); export const f = () => 1;"#,
+            ),
+        ],
+    );
+    assert_eq!(call(&pool, "/counter.ts", "next", ""), Ok(Some("1".into())));
+    let err = call(&pool, "/throws.ts", "f", "");
+    assert!(
+        matches!(err, Err(ref message) if message.contains("load failed")),
+        "{:?}",
+        err
+    );
+    // The worker's context was replaced, so the counter module starts over
+    assert_eq!(call(&pool, "/counter.ts", "next", ""), Ok(Some("1".into())));
+}
+
+#[test]
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn test_pool_survives_panicking_callback() {
+    let pool = pool_with(1, &[("/math.ts", MATH)]);
+    pool.submit("/math.ts", "add", "[1, 2]", |_| panic!("callback failed"))
+        .unwrap();
+    // The job still counts as finished and the worker keeps running
+    pool.wait_idle();
+    assert_eq!(
+        call(&pool, "/math.ts", "add", "[2, 2]"),
+        Ok(Some("4".into()))
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_pool_spreads_jobs_across_threads() {
+    let pool = pool_with(
+        4,
+        &[(
+            "/work.ts",
+            r#"export function sum(n: number) {
+                   let total = 0;
+                   for (let i = 1; i <= n; i++) total += i;
+                   return total;
+               }"#,
+        )],
+    );
+    assert_eq!(pool.threads(), 4);
+
+    let (tx, rx) = mpsc::channel();
+    for n in 0..200u64 {
+        let tx = tx.clone();
+        pool.submit("/work.ts", "sum", &format!("[{}]", n), move |result| {
+            let thread = std::thread::current().name().map(str::to_string);
+            tx.send((n, result, thread)).unwrap();
+        })
+        .unwrap();
+    }
+    pool.wait_idle();
+    drop(tx);
+
+    let results: Vec<_> = rx.iter().collect();
+    assert_eq!(results.len(), 200);
+    for (n, result, thread) in &results {
+        assert_eq!(result, &Ok(Some((n * (n + 1) / 2).to_string())));
+        assert!(thread.as_deref().unwrap().starts_with("tsrun-pool-"));
+    }
+}
+
+#[test]
+fn test_dropping_pool_finishes_queued_jobs() {
+    let (tx, rx) = mpsc::channel();
+    {
+        let pool = pool_with(2, &[("/math.ts", MATH)]);
+        for i in 0..20 {
+            let tx = tx.clone();
+            let _ = pool.submit("/math.ts", "add", &format!("[{}, 1]", i), move |result| {
+                let _ = tx.send(result);
+            });
+        }
+    }
+    drop(tx);
+    assert_eq!(rx.iter().filter(|r| r.is_ok()).count(), 20);
+}
@@ -0,0 +1,119 @@
+//! Tests for the sampling profiler
+
+use super::{create_test_runtime, run};
+use tsrun::{Interpreter, Profile, StepResult};
+
+/// Run `source` with a profiler sampling as often as it can
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn profile(source: &str, count_opcodes: bool) -> Profile {
+    let mut interp = create_test_runtime();
+    interp.set_gc_threshold(0);
+    interp.start_profiler(0, count_opcodes);
+    match run(&mut interp, source, Some("/profile.ts")).unwrap() {
+        StepResult::Complete(_) => {}
+        other => panic!("Expected Complete, got {:?}", other),
+    }
+    interp.stop_profiler().unwrap()
+}
+
+const HOT_LOOP: &str = r#"
+function hot(n: number): number {
+    let sum = 0;
+    for (let i = 0; i < n; i++) {
+        sum += i % 7;
+    }
+    return sum;
+}
+function caller(): number {
+    return hot(20000);
+}
+caller();
+"#;
+
+#[test]
+fn test_stop_without_start_returns_none() {
+    let mut interp = Interpreter::new();
+    assert!(interp.stop_profiler().is_none());
+}
+
+#[test]
+fn test_hot_function_dominates_self_samples() {
+    let profile = profile(HOT_LOOP, false);
+    assert!(profile.samples > 0);
+
+    let top = profile.functions.first().unwrap();
+    assert_eq!(top.name, "hot");
+    assert_eq!(top.file.as_deref(), Some("/profile.ts"));
+    assert!(top.total_samples >= top.self_samples);
+
+    let caller = profile
+        .functions
+        .iter()
+        .find(|f| f.name == "caller")
+        .unwrap();
+    assert!(caller.total_samples >= top.self_samples);
+    assert!(profile.opcode_counts.is_empty());
+}
+
+#[test]
+fn test_folded_stacks_are_outermost_first() {
+    let profile = profile(HOT_LOOP, false);
+    let folded = profile.folded();
+    assert!(
+        folded
+            .lines()
+            .any(|line| line.starts_with("<top-level> (/profile.ts:")
+                && line.contains(";caller (/profile.ts:")
+                && line.contains(";hot (/profile.ts:")),
+        "unexpected folded output:\n{}",
+        folded
+    );
+
+    let total: u64 = profile.stacks.iter().map(|s| s.samples).sum();
+    assert_eq!(total, profile.samples);
+}
+
+#[test]
+fn test_opcode_counts() {
+    let profile = profile(HOT_LOOP, true);
+    assert!(!profile.opcode_counts.is_empty());
+    assert!(
+        profile
+            .opcode_counts
+            .windows(2)
+            .all(|pair| matches!(pair, [a, b] if a.1 >= b.1))
+    );
+    let mod_count = profile
+        .opcode_counts
+        .iter()
+        .find(|(name, _)| name == "Mod")
+        .map(|(_, count)| *count);
+    assert!(mod_count.unwrap_or(0) >= 20000);
+}
+
+#[test]
+fn test_profiler_can_be_restarted() {
+    let mut interp = create_test_runtime();
+    interp.start_profiler(0, false);
+    let _ = run(&mut interp, HOT_LOOP, None);
+    let first = interp.stop_profiler();
+    assert!(first.is_some_and(|p| p.samples > 0));
+
+    interp.start_profiler(0, false);
+    let second = interp.stop_profiler();
+    assert!(second.is_some_and(|p| p.samples == 0 && p.functions.is_empty()));
+}
+
+#[test]
+fn test_samples_count_elapsed_intervals() {
+    // With a 1ns interval every clock read spans many intervals, so the
+    // sample count must exceed the number of clock reads
+    let mut interp = create_test_runtime();
+    interp.start_profiler(1, true);
+    let _ = run(&mut interp, HOT_LOOP, None);
+    let profile = interp.stop_profiler();
+    assert!(profile.is_some_and(|p| {
+        let instructions: u64 = p.opcode_counts.iter().map(|(_, count)| count).sum();
+        p.samples > 2 * (instructions / 256)
+    }));
+}
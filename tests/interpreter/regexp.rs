@@ -1,7 +1,10 @@
 //! RegExp-related tests
 
-use super::eval;
-use tsrun::JsValue;
+use super::{eval, run};
+use std::cell::Cell;
+use std::rc::Rc;
+use tsrun::platform::{CompiledRegex, FancyRegexProvider, RegExpProvider};
+use tsrun::{Interpreter, JsValue, RegExpCacheStats, StepResult};
 
 #[test]
 fn test_regexp_test_basic() {
@@ -224,3 +227,103 @@ fn test_regex_escape_pattern() {
     );
     assert_eq!(result, JsValue::Boolean(true));
 }
+
+// Shared compiled-regex cache
+
+/// Built-in provider that counts how often it is asked to compile
+struct CountingProvider {
+    inner: FancyRegexProvider,
+    compiles: Rc<Cell<usize>>,
+}
+
+impl RegExpProvider for CountingProvider {
+    fn compile(&self, pattern: &str, flags: &str) -> Result<Rc<dyn CompiledRegex>, String> {
+        self.compiles.set(self.compiles.get() + 1);
+        self.inner.compile(pattern, flags)
+    }
+}
+
+/// Run `source` and return its result, the provider compile count and cache stats
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn eval_counting_compiles(
+    source: &str,
+    capacity: Option<usize>,
+) -> (JsValue, usize, RegExpCacheStats) {
+    let compiles = Rc::new(Cell::new(0));
+    let mut interp = Interpreter::with_regexp_provider(Rc::new(CountingProvider {
+        inner: FancyRegexProvider::new(),
+        compiles: compiles.clone(),
+    }));
+    if let Some(capacity) = capacity {
+        interp.set_regexp_cache_capacity(capacity);
+    }
+    let result = match run(&mut interp, source, None).unwrap() {
+        StepResult::Complete(rv) => rv.value().clone(),
+        other => panic!("Expected Complete, got {:?}", other),
+    };
+    (result, compiles.get(), interp.regexp_cache_stats())
+}
+
+const LITERAL_IN_LOOP: &str = r#"
+    function isWord(s: string): boolean { return /^[a-z]+$/.test(s); }
+    let count = 0;
+    for (let i = 0; i < 50; i++) {
+        if (isWord(i % 2 === 0 ? "abc" : "a1")) count++;
+        if (new RegExp("\\d+", "g").test("x" + i)) count++;
+    }
+    count
+"#;
+
+#[test]
+fn test_regexp_cache_compiles_each_pattern_once() {
+    let (result, compiles, stats) = eval_counting_compiles(LITERAL_IN_LOOP, None);
+    assert_eq!(result, JsValue::Number(75.0));
+    assert_eq!(compiles, 2);
+    assert_eq!(stats.misses, 2);
+    assert_eq!(stats.hits, 98);
+    assert_eq!(stats.entries, 2);
+    assert_eq!(stats.capacity, tsrun::DEFAULT_REGEXP_CACHE_CAPACITY);
+}
+
+#[test]
+fn test_regexp_cache_disabled() {
+    let (result, compiles, stats) = eval_counting_compiles(LITERAL_IN_LOOP, Some(0));
+    assert_eq!(result, JsValue::Number(75.0));
+    assert_eq!(compiles, 100);
+    assert_eq!(stats.hits, 0);
+    assert_eq!(stats.entries, 0);
+}
+
+#[test]
+fn test_regexp_cache_evicts_least_recently_used() {
+    // With room for two patterns, "a" stays hot while "b" and "c" displace each other
+    let (result, compiles, stats) = eval_counting_compiles(
+        r#"
+        let hits = 0;
+        for (const p of ["a", "b", "a", "c", "a", "b"]) {
+            if (new RegExp(p).test("abc")) hits++;
+        }
+        hits
+    "#,
+        Some(2),
+    );
+    assert_eq!(result, JsValue::Number(6.0));
+    assert_eq!(compiles, 4);
+    assert_eq!(stats.hits, 2);
+    assert_eq!(stats.entries, 2);
+}
+
+#[test]
+fn test_regexp_cache_keys_on_flags() {
+    let (result, compiles, _) = eval_counting_compiles(
+        r#"
+        const a = new RegExp("x", "i").test("X");
+        const b = new RegExp("x").test("X");
+        const c = new RegExp("x", "i").test("X");
+        [a, b, c].join()
+    "#,
+        None,
+    );
+    assert_eq!(result, JsValue::String("true,false,true".into()));
+    assert_eq!(compiles, 2);
+}
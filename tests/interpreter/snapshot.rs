@@ -0,0 +1,173 @@
+//! Tests for interpreter snapshots and forking
+
+use super::{create_test_runtime, run, run_to_completion};
+use tsrun::{Guarded, InternalModule, Interpreter, JsError, JsValue, ModulePath, StepResult};
+
+#[allow(clippy::panic)]
+fn complete(interp: &mut Interpreter, source: &str) -> JsValue {
+    match run(interp, source, None) {
+        Ok(StepResult::Complete(value)) => value.value().clone(),
+        other => panic!("Expected Complete result, got {:?}", other.map(|_| ())),
+    }
+}
+
+/// Instantiate a snapshot with the same aggressive GC as the test runtime
+#[allow(clippy::expect_used)]
+fn instantiate(snapshot: &tsrun::InterpreterSnapshot) -> Interpreter {
+    let interp = snapshot.instantiate().expect("instantiate failed");
+    interp.heap.set_gc_threshold(1);
+    interp
+}
+
+#[test]
+fn test_snapshot_preserves_globals() {
+    let mut interp = create_test_runtime();
+    complete(
+        &mut interp,
+        r#"
+        globalThis.counter = 10;
+        globalThis.inc = () => ++globalThis.counter;
+        globalThis.registry = new Map([["a", { n: 1 }]]);
+    "#,
+    );
+    let snapshot = interp.snapshot().unwrap();
+
+    let mut first = instantiate(&snapshot);
+    let mut second = instantiate(&snapshot);
+
+    // Each instance mutates its own copy of the heap
+    assert_eq!(complete(&mut first, "inc(); inc()"), JsValue::Number(12.0));
+    assert_eq!(complete(&mut second, "inc()"), JsValue::Number(11.0));
+    assert_eq!(complete(&mut interp, "counter"), JsValue::Number(10.0));
+
+    // Object identity inside the copy is preserved
+    assert_eq!(
+        complete(&mut first, "registry.get('a') === registry.get('a')"),
+        JsValue::Boolean(true)
+    );
+    assert_eq!(
+        complete(&mut first, "registry.get('a').n"),
+        JsValue::Number(1.0)
+    );
+}
+
+#[test]
+fn test_forks_create_distinct_symbols() {
+    let mut parent = create_test_runtime();
+    complete(&mut parent, "globalThis.before = Symbol('shared')");
+    let mut fork = parent.fork().unwrap();
+
+    let source = |name: &str| {
+        format!(
+            "const o = {{}}; o[Symbol('{}')] = 1; o[before] = 2; \
+             Object.getOwnPropertySymbols(o).map(s => s.description).join()",
+            name
+        )
+    };
+    assert_eq!(
+        complete(&mut parent, &source("parent")),
+        JsValue::from("parent,shared")
+    );
+    assert_eq!(
+        complete(&mut fork, &source("fork")),
+        JsValue::from("fork,shared")
+    );
+}
+
+#[test]
+fn test_snapshot_builtins_work() {
+    let interp = create_test_runtime();
+    let snapshot = interp.snapshot().unwrap();
+    let mut fork = instantiate(&snapshot);
+
+    assert_eq!(
+        complete(&mut fork, "[3, 1, 2].sort().map(x => x * 2).join(',')"),
+        JsValue::String("2,4,6".into())
+    );
+    assert_eq!(
+        complete(&mut fork, "new TypeError('x') instanceof Error"),
+        JsValue::Boolean(true)
+    );
+    assert_eq!(
+        complete(
+            &mut fork,
+            "let out = 0; (async () => { out = await Promise.resolve(7); })(); out"
+        ),
+        JsValue::Number(7.0)
+    );
+}
+
+fn host_double(_: &mut Interpreter, _: JsValue, args: &[JsValue]) -> Result<Guarded, JsError> {
+    let n = args.first().and_then(|v| v.as_number()).unwrap_or(0.0);
+    Ok(Guarded::unguarded(JsValue::Number(n * 2.0)))
+}
+
+#[test]
+#[allow(clippy::panic)]
+fn test_snapshot_preserves_modules() {
+    let mut interp = create_test_runtime();
+    interp.register_internal_module(
+        InternalModule::native("host:math")
+            .with_function("double", host_double, 1)
+            .build(),
+    );
+
+    // Load a prelude module before taking the snapshot
+    interp
+        .prepare(
+            "import { scale } from './prelude'; globalThis.scale = scale;",
+            Some(ModulePath::new("/main.ts")),
+        )
+        .unwrap();
+    let StepResult::NeedImports(imports) = run_to_completion(&mut interp).unwrap() else {
+        panic!("Expected NeedImports");
+    };
+    interp
+        .provide_module(
+            imports[0].resolved_path.clone(),
+            "import { double } from 'host:math'; export const scale = (x: number) => double(x) + 1;",
+        )
+        .unwrap();
+    assert!(matches!(
+        run_to_completion(&mut interp).unwrap(),
+        StepResult::Complete(_)
+    ));
+
+    let snapshot = interp.snapshot().unwrap();
+    let mut fork = instantiate(&snapshot);
+
+    // Prelude module is already loaded, so no imports are requested
+    fork.prepare(
+        "import { scale } from './prelude'; scale(20) + globalThis.scale(1);",
+        Some(ModulePath::new("/main.ts")),
+    )
+    .unwrap();
+    match run_to_completion(&mut fork).unwrap() {
+        StepResult::Complete(value) => assert_eq!(*value, JsValue::Number(44.0)),
+        _ => panic!("Expected Complete result"),
+    }
+}
+
+#[test]
+fn test_snapshot_rejects_busy_interpreter() {
+    let mut interp = create_test_runtime();
+    interp
+        .prepare("import { x } from './missing'; x;", None)
+        .unwrap();
+    assert!(matches!(
+        run_to_completion(&mut interp).unwrap(),
+        StepResult::NeedImports(_)
+    ));
+    assert!(interp.snapshot().is_err());
+}
+
+#[test]
+fn test_snapshot_rejects_generators() {
+    let mut interp = create_test_runtime();
+    complete(
+        &mut interp,
+        "globalThis.gen = (function* () { yield 1; })();",
+    );
+    let err = interp.snapshot().err().map(|e| e.to_string());
+    assert!(err.unwrap_or_default().contains("generator"));
+}
@@ -446,3 +446,181 @@ fn test_call_depth_with_nested_user_functions() {
     // Should have reached depth 4 (level1 -> level2 -> level3 -> level4)
     assert!(max_depth >= 4, "max_depth was {}", max_depth);
 }
+
+#[test]
+fn test_run_steps_stops_at_budget() {
+    let mut interp = Interpreter::new();
+    interp.prepare("while (true) {}", None).unwrap();
+
+    // Many instructions per call, but control still returns to the host
+    for _ in 0..10 {
+        assert!(matches!(
+            interp.run_steps(1000).unwrap(),
+            StepResult::Continue
+        ));
+    }
+}
+
+#[test]
+fn test_run_steps_matches_step_loop() {
+    let source = r#"
+        function fib(n: number): number { return n <= 1 ? n : fib(n - 1) + fib(n - 2); }
+        let total = 0;
+        for (let i = 0; i < 10; i++) total += fib(i);
+        total
+    "#;
+
+    let mut stepped = Interpreter::new();
+    stepped.prepare(source, None).unwrap();
+    let mut steps = 0;
+    let expected = loop {
+        steps += 1;
+        match stepped.step().unwrap() {
+            StepResult::Continue => continue,
+            StepResult::Complete(value) => break value,
+            other => panic!("Unexpected result: {:?}", other),
+        }
+    };
+
+    let mut batched = Interpreter::new();
+    batched.prepare(source, None).unwrap();
+    let mut calls = 0;
+    let actual = loop {
+        calls += 1;
+        match batched.run_steps(usize::MAX).unwrap() {
+            StepResult::Continue => continue,
+            StepResult::Complete(value) => break value,
+            other => panic!("Unexpected result: {:?}", other),
+        }
+    };
+
+    assert_eq!(actual.as_number(), expected.as_number());
+    assert_eq!(actual.as_number(), Some(88.0));
+    assert!(calls < steps / 100, "{} calls vs {} steps", calls, steps);
+}
+
+#[test]
+fn test_run_budget_exhausts_and_resumes() {
+    let source = r#"
+        let total = 0;
+        for (let i = 0; i < 20000; i++) total += i;
+        total
+    "#;
+
+    let mut interp = Interpreter::new();
+    interp.prepare(source, None).unwrap();
+    let mut calls = 0;
+    let value = loop {
+        calls += 1;
+        match interp.run_budget(5000, 0).unwrap() {
+            StepResult::Continue => continue,
+            StepResult::Complete(value) => break value,
+            other => panic!("Unexpected result: {:?}", other),
+        }
+    };
+
+    assert_eq!(value.as_number(), Some(199_990_000.0));
+    assert!(calls > 1, "budget never ran out");
+}
+
+#[test]
+fn test_run_budget_deadline_stops_infinite_loop() {
+    let mut interp = Interpreter::new();
+    interp.prepare("while (true) {}", None).unwrap();
+
+    // 1ms of wall-clock time, no instruction limit
+    for _ in 0..3 {
+        assert!(matches!(
+            interp.run_budget(0, 1_000_000).unwrap(),
+            StepResult::Continue
+        ));
+    }
+}
+
+#[test]
+fn test_run_budget_deadline_stops_callback_loops() {
+    // Callbacks run by builtins cannot be suspended, so the deadline stops
+    // the script, and neither the script nor a swallowing builtin catches it
+    for source in [
+        "[1].map(() => { while (true) {} })",
+        "try { [3, 1, 2].sort(() => { while (true) {} }); } catch (e) {} 'caught'",
+        "new Map([[1, 2]]).forEach(() => { while (true) {} })",
+        "const o = { get x() { while (true) {} } }; o.x",
+        "new Promise(() => { while (true) {} }); 'swallowed'",
+    ] {
+        let mut interp = Interpreter::new();
+        interp.prepare(source, None).unwrap();
+        let err = loop {
+            match interp.run_budget(0, 1_000_000) {
+                Ok(StepResult::Continue) => continue,
+                Ok(other) => panic!("{}: unexpected result {:?}", source, other),
+                Err(e) => break e,
+            }
+        };
+        assert!(
+            err.to_string().contains("Time limit exceeded"),
+            "{}: unexpected error: {}",
+            source,
+            err
+        );
+
+        // The next script runs normally
+        interp
+            .prepare("[1, 2].map(x => x * 2).join()", None)
+            .unwrap();
+        match interp.run_budget(0, 1_000_000_000).unwrap() {
+            StepResult::Complete(value) => assert_eq!(value.as_str(), Some("2,4")),
+            other => panic!("Unexpected result: {:?}", other),
+        }
+    }
+}
+
+#[test]
+fn test_object_limit_stops_runaway_allocation() {
+    let mut interp = Interpreter::new();
+    interp.set_object_limit(20_000);
+
+    // The RangeError cannot be caught by the script
+    interp
+        .prepare(
+            r#"
+            function fill(): string {
+                const keep = [];
+                try {
+                    while (true) keep.push({ n: keep.length });
+                } catch (e) {
+                    return "caught";
+                }
+            }
+            fill();
+            "#,
+            None,
+        )
+        .unwrap();
+    let err = loop {
+        match interp.run_steps(usize::MAX) {
+            Ok(StepResult::Continue) => continue,
+            Ok(other) => panic!("Unexpected result: {:?}", other),
+            Err(e) => break e,
+        }
+    };
+    assert!(
+        err.to_string().contains("Object limit exceeded"),
+        "unexpected error: {}",
+        err
+    );
+
+    // Once the runaway script's objects are unreachable, the limit no longer
+    // stops new scripts
+    interp
+        .prepare("[1, 2, 3].map(x => ({ x })).length", None)
+        .unwrap();
+    let value = loop {
+        match interp.run_steps(usize::MAX).unwrap() {
+            StepResult::Continue => continue,
+            StepResult::Complete(value) => break value,
+            other => panic!("Unexpected result: {:?}", other),
+        }
+    };
+    assert_eq!(value.as_number(), Some(3.0));
+}
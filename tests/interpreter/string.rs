@@ -1,6 +1,6 @@
 //! String-related tests
 
-use super::{eval, eval_result};
+use super::{eval, eval_result, throws_error};
 use tsrun::JsValue;
 use tsrun::value::JsString;
 
@@ -270,6 +270,26 @@ fn test_string_replaceall() {
     );
 }
 
+#[test]
+fn test_string_replaceall_regexp() {
+    assert_eq!(
+        eval("'a-b-c'.replaceAll(/-/g, '+')"),
+        JsValue::String(JsString::from("a+b+c"))
+    );
+    assert_eq!(
+        eval("'x1y2'.replaceAll(/(\\d)/g, '<$1>')"),
+        JsValue::String(JsString::from("x<1>y<2>"))
+    );
+    assert_eq!(
+        eval("'ab'.replaceAll(/[ab]/g, (m) => m.toUpperCase())"),
+        JsValue::String(JsString::from("AB"))
+    );
+    assert!(throws_error(
+        "'abc'.replaceAll(/b/, 'x')",
+        "non-global RegExp"
+    ));
+}
+
 // String.prototype.match tests
 #[test]
 fn test_string_match_basic() {
@@ -1156,3 +1176,39 @@ fn test_template_invalid_unicode_brace_escape() {
 // This is slightly stricter than the spec but prevents common errors.
 // TODO: Support invalid escapes in tagged templates for full ES2018+ compliance.
 // TODO: raw values are currently the same as cooked values - should preserve escapes
+
+#[test]
+fn test_string_append_loop_builds_correct_result() {
+    // Long `+=` chains are built as ropes and flattened on read
+    assert_eq!(
+        eval(
+            r#"
+            let out = "";
+            for (let i = 0; i < 5000; i++) {
+                out += "key" + i + " = " + (i * 2) + "\n";
+            }
+            const lines = out.split("\n");
+            `${out.length} ${lines.length} ${lines[4999]} ${out.indexOf("key4000")}`
+            "#
+        ),
+        JsValue::String(JsString::from("73335 5001 key4999 = 9998 58335"))
+    );
+}
+
+#[test]
+fn test_string_rope_template_and_concat() {
+    assert_eq!(
+        eval(
+            r#"
+            let out = "";
+            for (let i = 0; i < 300; i++) {
+                out = `${out}<item id="${i}"/>`;
+                out = out.concat("\n");
+            }
+            const same = out === out.slice(0);
+            `${out.length} ${out.charAt(out.length - 2)} ${same} ${out.startsWith("<item id=\"0\"/>")}`
+            "#
+        ),
+        JsValue::String(JsString::from("4990 > true true"))
+    );
+}
@@ -515,3 +515,25 @@ fn test_destructuring_empty_pattern_calls_close() {
         JsValue::Boolean(true)
     );
 }
+
+#[test]
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn test_symbol_keys_stay_distinct_across_interpreters() {
+    // Interpreters on a thread share object shapes, which key symbol
+    // properties by id
+    fn first_symbol_description(interp: &mut tsrun::Interpreter, name: &str) -> JsValue {
+        let source = format!(
+            "const o = {{}}; o[Symbol('{}')] = 1; Object.getOwnPropertySymbols(o)[0].description",
+            name
+        );
+        match super::run(interp, &source, None).unwrap() {
+            tsrun::StepResult::Complete(value) => value.value().clone(),
+            other => panic!("Expected Complete, got {:?}", other),
+        }
+    }
+
+    let mut a = super::create_test_runtime();
+    let mut b = super::create_test_runtime();
+    assert_eq!(first_symbol_description(&mut a, "a"), JsValue::from("a"));
+    assert_eq!(first_symbol_description(&mut b, "b"), JsValue::from("b"));
+}
@@ -0,0 +1,300 @@
+//! Tests for ArrayBuffer, typed arrays, DataView and host-backed memory
+
+use super::{create_test_runtime, eval, run};
+use std::cell::Cell;
+use std::rc::Rc;
+use tsrun::value::PropertyKey;
+use tsrun::{ByteStore, Interpreter, JsString, JsValue, StepResult};
+
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn complete(interp: &mut Interpreter, source: &str) -> JsValue {
+    match run(interp, source, None).unwrap() {
+        StepResult::Complete(value) => value.value().clone(),
+        other => panic!("Expected Complete, got {:?}", other),
+    }
+}
+
+fn set_global(interp: &mut Interpreter, name: &str, value: JsValue) {
+    interp
+        .global
+        .borrow_mut()
+        .set_property(PropertyKey::String(JsString::from(name)), value);
+}
+
+#[test]
+fn test_typed_array_elements_convert_on_store() {
+    assert_eq!(
+        eval("new Uint8Array([1, 2, 300, -1]).join()"),
+        JsValue::from("1,2,44,255")
+    );
+    assert_eq!(
+        eval("new Int8Array([127, 128, 255]).join()"),
+        JsValue::from("127,-128,-1")
+    );
+    assert_eq!(
+        eval("new Uint8ClampedArray([300, -5, 1.5, 2.5]).join()"),
+        JsValue::from("255,0,2,2")
+    );
+    assert_eq!(
+        eval("const f = new Float32Array(1); f[0] = 0.1; f[0] === 0.1"),
+        JsValue::Boolean(false)
+    );
+}
+
+#[test]
+fn test_typed_array_out_of_range_access() {
+    assert_eq!(
+        eval("const a = new Int32Array(2); a[5] = 1; [a[5], a.length, 5 in a].join()"),
+        JsValue::from(",2,false")
+    );
+}
+
+#[test]
+fn test_typed_array_properties() {
+    assert_eq!(
+        eval(
+            r#"
+            const buf = new ArrayBuffer(16);
+            const a = new Float64Array(buf, 8);
+            [a.length, a.byteLength, a.byteOffset, a.buffer === buf,
+             Float64Array.BYTES_PER_ELEMENT, buf.byteLength].join()
+        "#
+        ),
+        JsValue::from("1,8,8,true,8,16")
+    );
+    assert_eq!(
+        eval("Object.prototype.toString.call(new Uint16Array(1))"),
+        JsValue::from("[object Uint16Array]")
+    );
+    assert_eq!(
+        eval("ArrayBuffer.isView(new Int8Array(1)) && !ArrayBuffer.isView(new ArrayBuffer(1))"),
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_views_share_a_buffer() {
+    assert_eq!(
+        eval(
+            r#"
+            const bytes = new Uint8Array(8);
+            const sub = bytes.subarray(2, 4);
+            sub[0] = 7;
+            const words = new Uint32Array(bytes.buffer);
+            words[1] = 0xffffffff;
+            [bytes[2], sub.byteOffset, bytes[7]].join()
+        "#
+        ),
+        JsValue::from("7,2,255")
+    );
+}
+
+#[test]
+fn test_misaligned_view_is_range_error() {
+    assert_eq!(
+        eval(
+            r#"
+            let name = "";
+            try { new Uint16Array(new ArrayBuffer(4), 1); } catch (e) { name = e.name; }
+            name
+        "#
+        ),
+        JsValue::from("RangeError")
+    );
+}
+
+#[test]
+fn test_oversized_buffers_are_range_errors() {
+    // Far past what can be allocated: thrown, not a process abort
+    assert_eq!(
+        eval(
+            r#"
+            const names: string[] = [];
+            for (const make of [
+                () => new Float64Array(4294967295),
+                () => new ArrayBuffer(4294967295),
+                () => new Uint8Array(2 ** 31),
+            ]) {
+                try { make(); } catch (e) { names.push(e.name); }
+            }
+            names.join()
+        "#
+        ),
+        JsValue::from("RangeError,RangeError,RangeError")
+    );
+}
+
+#[test]
+fn test_typed_array_methods() {
+    assert_eq!(
+        eval("Uint8Array.from([1, 2, 3], x => x * 2).map(x => x + 1).filter(x => x > 3).join()"),
+        JsValue::from("5,7")
+    );
+    assert_eq!(
+        eval("new Int16Array([3, -1, 2]).sort().join()"),
+        JsValue::from("-1,2,3")
+    );
+    assert_eq!(
+        eval("new Int16Array([3, -1, 2]).sort((a, b) => b - a).join()"),
+        JsValue::from("3,2,-1")
+    );
+    assert_eq!(
+        eval("new Float32Array([1, 2, 3]).reduce((a, b) => a + b)"),
+        JsValue::Number(6.0)
+    );
+    assert_eq!(
+        eval("const a = new Uint8Array(4); a.set([9, 8], 1); a.fill(5, 3).join()"),
+        JsValue::from("0,9,8,5")
+    );
+    assert_eq!(
+        eval(
+            "const a = Int8Array.of(1, 2, 3); const b = a.slice(1); b[0] = 0; a.join() + '|' + b.join()"
+        ),
+        JsValue::from("1,2,3|0,3")
+    );
+    assert_eq!(
+        eval("new Int8Array([1, 2, 3]).at(-1)"),
+        JsValue::Number(3.0)
+    );
+}
+
+#[test]
+fn test_typed_array_iteration() {
+    assert_eq!(
+        eval("let s = 0; for (const v of new Int32Array([5, 6, 7])) s += v; s"),
+        JsValue::Number(18.0)
+    );
+    assert_eq!(
+        eval("[...new Uint8Array([1, 2])].length"),
+        JsValue::Number(2.0)
+    );
+    assert_eq!(
+        eval("Object.keys(new Int8Array(3)).join()"),
+        JsValue::from("0,1,2")
+    );
+    assert_eq!(
+        eval("JSON.stringify(new Int8Array([1, 2]))"),
+        JsValue::from(r#"{"0":1,"1":2}"#)
+    );
+}
+
+#[test]
+fn test_data_view_endianness() {
+    assert_eq!(
+        eval(
+            r#"
+            const view = new DataView(new ArrayBuffer(8));
+            view.setUint16(0, 0x1234);
+            view.setFloat32(4, 1.5, true);
+            [view.getUint8(0), view.getUint16(0), view.getUint16(0, true),
+             view.getFloat32(4, true)].join()
+        "#
+        ),
+        JsValue::from("18,4660,13330,1.5")
+    );
+}
+
+#[test]
+fn test_structured_clone_copies_bytes() {
+    assert_eq!(
+        eval("const a = new Uint8Array([1, 2]); const b = structuredClone(a); b[0] = 9; a[0]"),
+        JsValue::Number(1.0)
+    );
+}
+
+#[test]
+fn test_external_array_buffer_reads_and_writes_host_memory() {
+    let released = Rc::new(Cell::new(false));
+    let memory: &'static mut [u8] = Box::leak(vec![1u8, 2, 3, 4].into_boxed_slice());
+    let ptr = memory.as_mut_ptr();
+
+    {
+        let mut interp = create_test_runtime();
+        let flag = released.clone();
+        let store = unsafe { ByteStore::external(ptr, 4, Some(Box::new(move || flag.set(true)))) };
+        let guard = interp.heap.create_guard();
+        let buffer = interp.create_array_buffer(&guard, store);
+        set_global(&mut interp, "hostBuffer", JsValue::Object(buffer));
+        drop(guard);
+
+        assert_eq!(
+            complete(
+                &mut interp,
+                "const v = new Uint8Array(hostBuffer); v[0] = v[1] + v[2] + v[3]; v[0]"
+            ),
+            JsValue::Number(9.0)
+        );
+        assert!(!released.get());
+    }
+
+    // The interpreter wrote straight into host memory and released it on drop
+    assert!(released.get());
+    // SAFETY: the interpreter is gone, the memory is ours again
+    let memory = unsafe { Box::from_raw(std::ptr::slice_from_raw_parts_mut(ptr, 4)) };
+    assert_eq!(&memory[..], &[9, 2, 3, 4]);
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_snapshot_copies_array_buffers() {
+    let mut interp = create_test_runtime();
+    complete(
+        &mut interp,
+        "globalThis.bytes = new Uint8Array([1, 2]); globalThis.view = bytes.subarray(1);",
+    );
+    let snapshot = interp.snapshot().unwrap();
+    let mut fork = snapshot.instantiate().unwrap();
+
+    assert_eq!(
+        complete(&mut fork, "view[0] = 7; bytes[1]"),
+        JsValue::Number(7.0)
+    );
+    assert_eq!(complete(&mut interp, "bytes[1]"), JsValue::Number(2.0));
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_external_string() {
+    let released = Rc::new(Cell::new(false));
+    let text: &'static str = "héllo";
+    let flag = released.clone();
+    let s = unsafe {
+        JsString::from_external(
+            text.as_ptr(),
+            text.len(),
+            Some(Box::new(move || flag.set(true))),
+        )
+    };
+    let s = s.unwrap();
+    assert!(s.is_external());
+
+    {
+        let mut interp = create_test_runtime();
+        set_global(&mut interp, "greeting", JsValue::String(s));
+        assert_eq!(
+            complete(&mut interp, "greeting.toUpperCase() + greeting.length"),
+            JsValue::from("HÉLLO5")
+        );
+    }
+    assert!(released.get());
+
+    let invalid = [0xffu8, 0xfe];
+    let result = unsafe { JsString::from_external(invalid.as_ptr(), invalid.len(), None) };
+    assert!(result.is_err());
+}
+
+#[test]
+fn test_typed_array_constructors_share_statics() {
+    assert_eq!(
+        eval(
+            r#"
+            const TypedArray = Object.getPrototypeOf(Int8Array);
+            [TypedArray === Object.getPrototypeOf(Float64Array),
+             Int8Array.from === TypedArray.from,
+             Object.getPrototypeOf(Int8Array.prototype) === TypedArray.prototype,
+             Float64Array.of(1.5, 2).join()].join()
+        "#
+        ),
+        JsValue::from("true,true,true,1.5,2")
+    );
+}
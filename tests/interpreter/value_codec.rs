@@ -0,0 +1,242 @@
+//! Tests for the binary value codec used for bulk host transfer
+
+use super::{create_test_runtime, run};
+use tsrun::value::PropertyKey;
+use tsrun::{
+    Interpreter, JsString, JsValue, RuntimeValue, StepResult, VALUE_CODEC_VERSION, decode_value,
+    encode_value,
+};
+
+#[allow(clippy::unwrap_used, clippy::panic)]
+fn eval_in(interp: &mut Interpreter, source: &str) -> RuntimeValue {
+    match run(interp, source, None).unwrap() {
+        StepResult::Complete(value) => value,
+        other => panic!("Expected Complete, got {:?}", other),
+    }
+}
+
+fn set_global(interp: &mut Interpreter, name: &str, value: JsValue) {
+    interp
+        .global
+        .borrow_mut()
+        .set_property(PropertyKey::String(JsString::from(name)), value);
+}
+
+/// Encode the result of `source`, decode it into a fresh interpreter as
+/// the global `v`, and evaluate `check` there
+#[allow(clippy::unwrap_used)]
+fn round_trip(source: &str, check: &str) -> JsValue {
+    let mut from = create_test_runtime();
+    let value = eval_in(&mut from, source);
+    let bytes = encode_value(value.value()).unwrap();
+
+    let mut to = create_test_runtime();
+    let decoded = decode_value(&mut to, &bytes).unwrap();
+    set_global(&mut to, "v", decoded.value.clone());
+    drop(decoded);
+    eval_in(&mut to, check).value().clone()
+}
+
+#[allow(clippy::unwrap_used)]
+fn encoded(source: &str) -> Vec<u8> {
+    let mut interp = create_test_runtime();
+    let value = eval_in(&mut interp, source);
+    encode_value(value.value()).unwrap()
+}
+
+#[test]
+fn test_value_codec_round_trips_nested_data() {
+    let source = r#"
+        ({ name: "widget", count: 3, price: 1.25, big: 2 ** 60, neg: -7,
+           tags: ["a", "b"], nested: { ok: true, none: null, missing: undefined } })
+    "#;
+    let expected = r#"({ name: "widget", count: 3, price: 1.25, big: 2 ** 60, neg: -7,
+           tags: ["a", "b"], nested: { ok: true, none: null } })"#;
+    assert_eq!(
+        round_trip(
+            source,
+            &format!("JSON.stringify(v) === JSON.stringify({})", expected)
+        ),
+        JsValue::Boolean(true)
+    );
+    // Insertion order is kept
+    assert_eq!(
+        round_trip(source, "Object.keys(v).join()"),
+        JsValue::from("name,count,price,big,neg,tags,nested")
+    );
+    assert_eq!(
+        round_trip(
+            source,
+            r#""missing" in v.nested && v.nested.missing === undefined"#
+        ),
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_value_codec_keeps_special_numbers() {
+    assert_eq!(
+        round_trip(
+            "[NaN, Infinity, -Infinity, -0, 0, 2 ** 53, -(2 ** 53), 0.1]",
+            r#"Number.isNaN(v[0]) && v[1] === Infinity && v[2] === -Infinity &&
+               Object.is(v[3], -0) && Object.is(v[4], 0) && v[5] === 2 ** 53 &&
+               v[6] === -(2 ** 53) && v[7] === 0.1"#
+        ),
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_value_codec_preserves_shared_and_cyclic_objects() {
+    let source = r#"
+        const shared = { n: 1 };
+        const root: any = { a: shared, b: shared, list: [shared] };
+        root.self = root;
+        root.list.push(root.list);
+        root
+    "#;
+    assert_eq!(
+        round_trip(
+            source,
+            "v.a === v.b && v.list[0] === v.a && v.self === v && v.list[1] === v.list && v.a.n"
+        ),
+        JsValue::Number(1.0)
+    );
+}
+
+#[test]
+fn test_value_codec_deduplicates_strings() {
+    let once = encoded(r#"["a fairly long repeated string"]"#);
+    let many = encoded(r#"Array(100).fill("a fairly long repeated string")"#);
+    // Each repeat is a two-byte reference rather than another copy
+    assert!(many.len() < once.len() + 100 * 3, "{} bytes", many.len());
+
+    // Keys share the table too
+    let keys = encoded(r#"Array.from({ length: 50 }, (_, i) => ({ identifier: i }))"#);
+    assert!(keys.len() < 50 * 6, "{} bytes", keys.len());
+}
+
+#[test]
+fn test_value_codec_transfers_binary_data() {
+    assert_eq!(
+        round_trip(
+            "new Uint8Array([1, 2, 255])",
+            "v instanceof Uint8Array && v.join()"
+        ),
+        JsValue::from("1,2,255")
+    );
+    // Other views are transferred as their bytes
+    assert_eq!(
+        round_trip(
+            "new Uint16Array([1, 256])",
+            "v instanceof Uint8Array && v.join()"
+        ),
+        JsValue::from("1,0,0,1")
+    );
+    assert_eq!(
+        round_trip(
+            "new DataView(new Uint8Array([9, 8, 7]).buffer, 1)",
+            "v.join()"
+        ),
+        JsValue::from("8,7")
+    );
+}
+
+#[test]
+fn test_value_codec_skips_functions_and_symbols() {
+    let source = r#"
+        ({ keep: 1, fn() {}, arrow: () => 2, [Symbol("s")]: 3, sym: Symbol("t") })
+    "#;
+    assert_eq!(
+        round_trip(source, "Object.keys(v).join()"),
+        JsValue::from("keep")
+    );
+    assert_eq!(
+        round_trip("[1, () => 2, 3]", "v.length === 3 && v[1] === undefined"),
+        JsValue::Boolean(true)
+    );
+}
+
+#[test]
+fn test_value_codec_encodes_other_objects_like_json() {
+    assert_eq!(
+        round_trip(
+            r#"({ when: new Date(0), map: new Map([[1, 2]]) })"#,
+            "JSON.stringify(v)"
+        ),
+        JsValue::from(r#"{"map":null,"when":"1970-01-01T00:00:00.000Z"}"#)
+    );
+}
+
+#[test]
+fn test_value_codec_matches_known_bytes() {
+    // Pins the format shared with the Go decoder
+    let expected: &[&[u8]] = &[
+        &[VALUE_CODEC_VERSION],
+        &[9, 2],       // object, 2 entries
+        &[6, 1, b'a'], // "a"
+        &[8, 3],       // array, 3 elements
+        &[4, 2],       // 1
+        &[4, 1],       // -1
+        &[7, 0],       // "a" again
+        &[6, 1, b'b'], // "b"
+        &[3],          // true
+    ];
+    assert_eq!(
+        encoded(r#"({ a: [1, -1, "a"], b: true })"#),
+        expected.concat()
+    );
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_value_codec_rejects_malformed_input() {
+    let mut interp = create_test_runtime();
+    let cases: &[&[u8]] = &[
+        &[],
+        &[99, 1],
+        &[VALUE_CODEC_VERSION],
+        &[VALUE_CODEC_VERSION, 42],
+        &[VALUE_CODEC_VERSION, 8, 200, 1],
+        &[VALUE_CODEC_VERSION, 6, 5, b'a'],
+        &[VALUE_CODEC_VERSION, 6, 2, 0xff, 0xfe],
+        &[VALUE_CODEC_VERSION, 7, 0],
+        &[VALUE_CODEC_VERSION, 11, 0],
+        &[VALUE_CODEC_VERSION, 9, 1, 3, 3],
+        &[VALUE_CODEC_VERSION, 5, 0, 0],
+        &[VALUE_CODEC_VERSION, 1, 1],
+    ];
+    for bytes in cases {
+        let err = decode_value(&mut interp, bytes).unwrap_err();
+        assert!(
+            err.to_string().contains("value buffer"),
+            "{:?}: {}",
+            bytes,
+            err
+        );
+    }
+}
+
+#[test]
+#[allow(clippy::unwrap_used)]
+fn test_value_codec_handles_deep_nesting() {
+    // Neither direction recurses, so depth is limited only by memory
+    let mut bytes = vec![VALUE_CODEC_VERSION];
+    for _ in 0..100_000 {
+        bytes.extend_from_slice(&[8, 1]);
+    }
+    bytes.push(1);
+    let mut interp = create_test_runtime();
+    interp.set_gc_threshold(0);
+    let decoded = decode_value(&mut interp, &bytes).unwrap();
+    assert_eq!(encode_value(&decoded.value).unwrap(), bytes);
+    drop(decoded);
+
+    assert_eq!(
+        round_trip(
+            "let a: any = 0; for (let i = 0; i < 5000; i++) a = { a }; a",
+            "let x = v, n = 0; while (typeof x === 'object') { x = x.a; n++; } n"
+        ),
+        JsValue::Number(5000.0)
+    );
+}
@@ -514,3 +514,73 @@ fn test_unicode_escape_id_continue_middle_dot() {
         vec![TokenKind::Identifier(JsString::from("a·"))]
     );
 }
+
+/// Lex `source` and return each token with its (line, column, start, end)
+fn lex_spans(source: &str) -> Vec<(TokenKind, u32, u32, usize, usize)> {
+    let mut dict = StringDict::new();
+    let mut lexer = Lexer::new(source, &mut dict);
+    let mut tokens = vec![];
+    loop {
+        let token = lexer.next_token();
+        if token.kind == TokenKind::Eof {
+            break;
+        }
+        let span = token.span;
+        tokens.push((token.kind, span.line, span.column, span.start, span.end));
+    }
+    tokens
+}
+
+#[test]
+fn test_ascii_fast_paths_track_positions() {
+    let source = "  \t// comment\n/* a\n b */ longIdentifier_$1 \"plain\" `tpl`\n\r\nx";
+    assert_eq!(
+        lex_spans(source),
+        vec![
+            (TokenKind::Identifier(s("longIdentifier_$1")), 3, 7, 25, 42),
+            (TokenKind::String(s("plain")), 3, 25, 43, 50),
+            (TokenKind::TemplateNoSub(s("tpl")), 3, 33, 51, 56),
+            (TokenKind::Identifier(s("x")), 5, 1, 59, 60),
+        ]
+    );
+}
+
+#[test]
+fn test_non_ascii_falls_back_to_char_path() {
+    // Columns count characters, not bytes, past non-ASCII text
+    let source = "// héllo wörld\n\"añb\" /* ü */ y";
+    assert_eq!(
+        lex_spans(source),
+        vec![
+            (TokenKind::String(s("añb")), 2, 1, 17, 23),
+            (TokenKind::Identifier(s("y")), 2, 15, 33, 34),
+        ]
+    );
+}
+
+#[test]
+fn test_line_separator_ends_line_comment() {
+    // U+2028 is a line terminator even inside a long ASCII comment
+    let tokens = lex("// a fairly long comment body\u{2028}z");
+    assert_eq!(tokens, vec![TokenKind::Identifier(s("z"))]);
+}
+
+#[test]
+fn test_fast_path_strings_with_escapes_and_keywords() {
+    assert_eq!(
+        lex(r#"'it\'s' "tab\there" return returnValue"#),
+        vec![
+            TokenKind::String(s("it's")),
+            TokenKind::String(s("tab\there")),
+            TokenKind::Return,
+            TokenKind::Identifier(s("returnValue")),
+        ]
+    );
+    // An escape after an ASCII run keeps the identifier on the slow path
+    assert_eq!(lex(r"ab\u0063d"), vec![TokenKind::Identifier(s("abcd"))]);
+    // A `$` not followed by `{` is plain template text
+    assert_eq!(
+        lex("`cost $5 ${x}").first(),
+        Some(&TokenKind::TemplateHead(s("cost $5 ")))
+    );
+}
@@ -1741,3 +1741,30 @@ fn test_object_with_multiple_contextual_keywords() {
     );
     assert_eq!(prog.body.len(), 1);
 }
+
+#[test]
+fn test_statement_lists_with_speculative_parsing() {
+    // Blocks parsed while speculating on arrow params are re-parsed after the
+    // rollback; their statements must not leak into the enclosing list.
+    let prog = parse("(a = () => { x; y; }); switch (k) { case 1: p; q; default: r; } z;");
+    assert_eq!(prog.body.len(), 3);
+    let Some(Statement::Switch(switch)) = prog.body.get(1) else {
+        panic!("expected switch statement");
+    };
+    let lens: Vec<usize> = switch.cases.iter().map(|c| c.consequent.len()).collect();
+    assert_eq!(lens, vec![2, 1]);
+}
+
+#[test]
+fn test_variable_declarator_lists() {
+    let prog = parse("let a = 1; let b = 2, c = 3, d; for (let i = 0, j = 1; i < j; i++) {}");
+    let counts: Vec<usize> = prog
+        .body
+        .iter()
+        .filter_map(|stmt| match stmt {
+            Statement::VariableDeclaration(decl) => Some(decl.declarations.len()),
+            _ => None,
+        })
+        .collect();
+    assert_eq!(counts, vec![1, 3]);
+}